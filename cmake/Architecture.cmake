@@ -74,3 +74,23 @@ endif()
 if(X86_64 AND (ENABLE_ASM_CORE OR ENABLE_ASM_SCALERS OR ENABLE_MMX))
     message(FATAL_ERROR "The options ASM_CORE, ASM_SCALERS and MMX are not supported on X86_64 yet.")
 endif()
+
+if(ENABLE_JIT AND NOT X86_64)
+    message(FATAL_ERROR "The option JIT is only supported on X86_64.")
+endif()
+
+# The ASM core writes the flags directly with setcc.
+if(ENABLE_LAZY_FLAGS AND ENABLE_ASM_CORE)
+    message(FATAL_ERROR "The option LAZY_FLAGS can't be used with ASM_CORE.")
+endif()
+
+# The ASM core addresses the CPU state as plain globals, which are now members
+# of the GbaCore.
+if(ENABLE_ASM_CORE)
+    message(FATAL_ERROR "The option ASM_CORE is not supported anymore.")
+endif()
+
+# The render workers keep their own copy of the renderer state.
+if(ENABLE_THREADED_RENDERER AND NOT ENABLE_REENTRANT_CORE)
+    message(FATAL_ERROR "The option THREADED_RENDERER requires REENTRANT_CORE.")
+endif()
@@ -63,6 +63,29 @@ option(ENABLE_ASM "Enable x86 ASM related options" OFF)
 # OFF for the time being, until it is either fixed or replaced.
 option(ENABLE_ASM_CORE "Enable x86 ASM CPU cores (EXPERIMENTAL)" OFF)
 
+# Caches decoded ARM/THUMB instructions by address, trading some memory for
+# fewer fetches and table lookups in the interpreter.
+option(ENABLE_DECODE_CACHE "Enable the GBA CPU decoded instruction cache (EXPERIMENTAL)" OFF)
+
+# Translates hot THUMB code to native code, only available on x86-64 hosts.
+option(ENABLE_JIT "Enable the GBA THUMB recompiler (EXPERIMENTAL)" OFF)
+
+# Chains the ARM/THUMB instruction handlers with tail calls instead of going
+# through a single dispatch point in the execution loop.
+option(ENABLE_THREADED_DISPATCH "Enable threaded dispatch in the GBA CPU interpreter (EXPERIMENTAL)" OFF)
+
+# Stores the last ALU result and derives the N and Z flags from it only when a
+# condition or the CPSR is read.
+option(ENABLE_LAZY_FLAGS "Enable lazy N/Z flag evaluation in the GBA CPU interpreter (EXPERIMENTAL)" OFF)
+
+# Reaches the GBA core state through a thread-local current-core pointer, so
+# that several cores can run on separate threads of the same process.
+option(ENABLE_REENTRANT_CORE "Enable one GBA core per thread (EXPERIMENTAL)" OFF)
+
+# Draws the GBA scanlines on worker threads from per-line snapshots of the
+# PPU state, while the CPU emulation goes on. Requires ENABLE_REENTRANT_CORE.
+option(ENABLE_THREADED_RENDERER "Render GBA scanlines on worker threads (EXPERIMENTAL)" OFF)
+
 set(ASM_SCALERS_DEFAULT ${ENABLE_ASM})
 set(MMX_DEFAULT ${ENABLE_ASM})
 
@@ -55,6 +55,30 @@ if(NOT ENABLE_ASM_CORE)
     add_compile_definitions(C_CORE)
 endif()
 
+if(ENABLE_DECODE_CACHE)
+    add_compile_definitions(VBAM_ENABLE_DECODE_CACHE)
+endif()
+
+if(ENABLE_JIT)
+    add_compile_definitions(VBAM_ENABLE_JIT)
+endif()
+
+if(ENABLE_THREADED_DISPATCH)
+    add_compile_definitions(VBAM_ENABLE_THREADED_DISPATCH)
+endif()
+
+if(ENABLE_LAZY_FLAGS)
+    add_compile_definitions(VBAM_ENABLE_LAZY_FLAGS)
+endif()
+
+if(ENABLE_REENTRANT_CORE)
+    add_compile_definitions(VBAM_ENABLE_REENTRANT_CORE)
+endif()
+
+if(ENABLE_THREADED_RENDERER)
+    add_compile_definitions(VBAM_ENABLE_THREADED_RENDERER)
+endif()
+
 # Set up "src" and generated directory as a global include directory.
 set(VBAM_GENERATED_DIR ${CMAKE_BINARY_DIR}/generated)
 include_directories(
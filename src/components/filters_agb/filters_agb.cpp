@@ -1,5 +1,7 @@
 #include "components/filters_agb/filters_agb.h"
 
+#include "core/base/line_writer.h"
+
 extern int systemColorDepth;
 extern int systemRedShift;
 extern int systemGreenShift;
@@ -55,6 +57,9 @@ void gbafilter_update_colors(bool lcd) {
                 gbafilter_pal32(systemColorMap32, 0x10000);
         } break;
     }
+
+    // The 8-bit table is never filtered.
+    lineWriterSetFormat(lcd && systemColorDepth != 8);
 }
 
 void gbafilter_pal(uint16_t* buf, int count)
@@ -0,0 +1,158 @@
+#include "core/apu/Blip_Buffer.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/apu/Effects_Buffer.h"
+#include "core/apu/Multi_Buffer.h"
+
+namespace {
+
+// Hashes of the output of the scalar synthesis and mixing code, which the
+// vector code has to reproduce bit for bit.
+constexpr uint64_t kStereoGolden = 13158509347509255736ull;
+constexpr uint64_t kMonoGolden = 10503781917232741061ull;
+constexpr uint64_t kEffectsGolden = 12538995234335560441ull;
+
+// Channels of the GB sound.
+const int kGbChannelTypes[4] = { Multi_Buffer::wave_type + 1, Multi_Buffer::wave_type + 2,
+                                 Multi_Buffer::wave_type + 3, Multi_Buffer::mixed_type + 1 };
+
+uint64_t Hash(const std::vector<blip_sample_t>& samples)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const blip_sample_t sample : samples) {
+        hash ^= (uint16_t)sample;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+class BlipBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        good_.volume(0.0015);
+        med_.volume(0.001);
+        best_.volume(0.002);
+        best_.treble_eq(blip_eq_t(0, 0, 44100, 16384));
+    }
+
+    // Moves the amplitude of each synth on each of `outputs` to random levels,
+    // in frames of the GB sound clock, and reads everything back from
+    // `buffer`. Loud enough to clamp now and then.
+    std::vector<blip_sample_t> Run(Multi_Buffer& buffer, const std::vector<Blip_Buffer*>& outputs)
+    {
+        std::mt19937 rng(1074);
+        std::uniform_int_distribution<int> time(0, 70223);
+        std::uniform_int_distribution<int> level(-30, 30);
+        std::uniform_int_distribution<int> output(0, (int)outputs.size() - 1);
+
+        std::vector<int> amplitudes(outputs.size() * 3);
+        std::vector<blip_sample_t> samples;
+        std::vector<blip_sample_t> frame(4096);
+        for (int i = 0; i < 120; i++) {
+            for (int j = 0; j < 300; j++) {
+                const int index = output(rng);
+                Blip_Buffer* out = outputs[index];
+                const blip_time_t t = time(rng) * 4;
+                int& amplitude = amplitudes[index * 3 + j % 3];
+                const int delta = level(rng) - amplitude;
+                amplitude += delta;
+                switch (j % 3) {
+                case 0:
+                    good_.offset(t, delta, out);
+                    break;
+                case 1:
+                    med_.offset(t, delta, out);
+                    break;
+                default:
+                    best_.offset(t, delta, out);
+                    break;
+                }
+                out->set_modified();
+            }
+            buffer.end_frame(70224 * 4);
+
+            const long count = buffer.read_samples(frame.data(), (long)frame.size());
+            samples.insert(samples.end(), frame.begin(), frame.begin() + count);
+        }
+        return samples;
+    }
+
+    Blip_Synth<blip_good_quality, 1> good_;
+    Blip_Synth<blip_med_quality, 1> med_;
+    Blip_Synth<blip_best_quality, 1> best_;
+};
+
+TEST_F(BlipBufferTest, StereoMatchesGolden)
+{
+    Stereo_Buffer buffer;
+    ASSERT_EQ(buffer.set_sample_rate(44100), nullptr);
+    buffer.clock_rate(4194304 * 4);
+
+    const std::vector<blip_sample_t> samples =
+        Run(buffer, { buffer.center(), buffer.left(), buffer.right() });
+    EXPECT_EQ(Hash(samples), kStereoGolden);
+}
+
+TEST_F(BlipBufferTest, MonoMatchesGolden)
+{
+    Stereo_Buffer buffer;
+    ASSERT_EQ(buffer.set_sample_rate(48000), nullptr);
+    buffer.clock_rate(4194304 * 4);
+
+    const std::vector<blip_sample_t> samples = Run(buffer, { buffer.center() });
+    EXPECT_EQ(Hash(samples), kMonoGolden);
+}
+
+TEST_F(BlipBufferTest, EffectsMatchGolden)
+{
+    Simple_Effects_Buffer buffer;
+    ASSERT_EQ(buffer.set_sample_rate(44100), nullptr);
+    buffer.clock_rate(4194304 * 4);
+    ASSERT_EQ(buffer.set_channel_count(4, kGbChannelTypes), nullptr);
+    buffer.config().enabled = true;
+    buffer.config().echo = 0.4f;
+    buffer.config().stereo = 0.6f;
+    buffer.config().surround = true;
+    buffer.apply_config();
+
+    std::vector<Blip_Buffer*> outputs;
+    for (int i = 0; i < 4; i++) {
+        const Multi_Buffer::channel_t channel = buffer.channel(i);
+        outputs.push_back(channel.center);
+        outputs.push_back(channel.left);
+        outputs.push_back(channel.right);
+    }
+    const std::vector<blip_sample_t> samples = Run(buffer, outputs);
+    EXPECT_EQ(Hash(samples), kEffectsGolden);
+}
+
+TEST_F(BlipBufferTest, SkipsSamples)
+{
+    Stereo_Buffer stereo;
+    ASSERT_EQ(stereo.set_sample_rate(44100), nullptr);
+    stereo.clock_rate(4194304 * 4);
+    Simple_Effects_Buffer effects;
+    ASSERT_EQ(effects.set_sample_rate(44100), nullptr);
+    effects.clock_rate(4194304 * 4);
+    ASSERT_EQ(effects.set_channel_count(4, kGbChannelTypes), nullptr);
+
+    for (Multi_Buffer* buffer : std::vector<Multi_Buffer*>{ &stereo, &effects }) {
+        for (int i = 0; i < 120; i++) {
+            buffer->end_frame(70224 * 4);
+            const long avail = buffer->samples_avail();
+            ASSERT_GT(avail, 0);
+            EXPECT_EQ(buffer->skip_samples(avail - 2), avail - 2);
+            EXPECT_EQ(buffer->samples_avail(), 2);
+            EXPECT_EQ(buffer->skip_samples(avail), 2);
+            EXPECT_EQ(buffer->samples_avail(), 0);
+        }
+    }
+}
+
+}  // namespace
@@ -201,8 +201,9 @@ void Blip_Synth_Fast_::volume_unit( double new_unit )
 
 #if !BLIP_BUFFER_FAST
 
-Blip_Synth_::Blip_Synth_( short* p, int w ) :
+Blip_Synth_::Blip_Synth_( short* p, blip_long* t, int w ) :
 	impulses( p ),
+	taps( t ),
 	width( w )
 {
 	volume_unit_ = 0.0;
@@ -288,6 +289,21 @@ void Blip_Synth_::adjust_impulse()
 	//      printf( "%5ld,", impulses [j * blip_res + i + 1] );
 }
 
+void Blip_Synth_::update_taps()
+{
+	// The first half of the impulse is read backwards from the end of the phases,
+	// the second half forwards from the phase, both a phase apart per tap
+	int const half = width / 2;
+	for ( int phase = 0; phase < blip_res; phase++ )
+	{
+		blip_long* out = taps + phase * width;
+		for ( int i = 0; i < half; i++ )
+			out [i] = impulses [blip_res - phase + blip_res * i];
+		for ( int i = half; i < width; i++ )
+			out [i] = impulses [phase + blip_res * (width - 1 - i)];
+	}
+}
+
 void Blip_Synth_::treble_eq( blip_eq_t const& eq )
 {
 	float fimpulse [blip_res / 2 * (blip_widest_impulse_ - 1) + blip_res * 2];
@@ -327,6 +343,7 @@ void Blip_Synth_::treble_eq( blip_eq_t const& eq )
 		next += fimpulse [i + blip_res];
 	}
 	adjust_impulse();
+	update_taps();
 
 	// volume might require rescaling
 	double vol = volume_unit_;
@@ -371,6 +388,7 @@ void Blip_Synth_::volume_unit( double new_unit )
 				for ( int i = impulses_size(); i--; )
 					impulses [i] = (short) (int) (((impulses [i] + offset) >> shift) - offset2);
 				adjust_impulse();
+				update_taps();
 			}
 		}
 		delta_factor = (int) floor( factor + 0.5 );
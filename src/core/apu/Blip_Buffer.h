@@ -183,6 +183,21 @@ class Blip_Buffer
 #endif
 #endif
 
+// Vector instructions for the inner loops, only where they are always available.
+// The results are the same as with the scalar code.
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) ||          \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIP_BUFFER_SSE2 1
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define BLIP_BUFFER_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BLIP_BUFFER_NEON 1
+#include <arm_neon.h>
+#endif
+
 // Internal
 typedef blip_ulong blip_resampled_time_t;
 int const blip_widest_impulse_ = 16;
@@ -212,12 +227,13 @@ class Blip_Synth_
         int delta_factor;
 
         void volume_unit(double);
-        Blip_Synth_(short *impulses, int width);
+        Blip_Synth_(short *impulses, blip_long *taps, int width);
         void treble_eq(blip_eq_t const &);
 
         private:
         double volume_unit_;
         short *const impulses;
+        blip_long *const taps;
         int const width;
         blip_long kernel_unit;
         int impulses_size() const
@@ -225,6 +241,7 @@ class Blip_Synth_
                 return blip_res / 2 * width + 1;
         }
         void adjust_impulse();
+        void update_taps();
 };
 
 // Quality level, better = slower. In general, use blip_good_quality.
@@ -296,9 +313,11 @@ template <int quality, int range> class Blip_Synth
         Blip_Synth_ impl;
         typedef short imp_t;
         imp_t impulses[blip_res * (quality / 2) + 1];
+        // The impulses rearranged for each phase, in the order they are added
+        blip_long taps[blip_res * quality];
 
         public:
-        Blip_Synth() : impl(impulses, quality)
+        Blip_Synth() : impl(impulses, taps, quality)
         {
         }
 #endif
@@ -447,6 +466,45 @@ class Blip_Reader
                         (out) = ((sample) >> 24) ^ 0x7FFF;                                         \
         }
 
+// Adds taps [i] * delta to buf [i] for i < count, a multiple of 4
+template <int count>
+inline void blip_add_taps_(blip_long *BLIP_RESTRICT buf, blip_long const *BLIP_RESTRICT taps, int delta)
+{
+        static_assert(count % 4 == 0, "count must be a multiple of 4");
+        int i = 0;
+#if BLIP_BUFFER_AVX2
+        __m256i const delta8 = _mm256_set1_epi32(delta);
+        for (; i + 8 <= count; i += 8) {
+                __m256i *const out = (__m256i *)(buf + i);
+                __m256i const product =
+                    _mm256_mullo_epi32(_mm256_loadu_si256((__m256i const *)(taps + i)), delta8);
+                _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), product));
+        }
+#endif
+#if BLIP_BUFFER_SSE2
+        __m128i const delta4 = _mm_set1_epi32(delta);
+        for (; i < count; i += 4) {
+                // No 32-bit multiply before SSE4.1: the even and odd lanes are multiplied
+                // apart. The low halves of the products are the same, signed or not.
+                __m128i const t = _mm_loadu_si128((__m128i const *)(taps + i));
+                __m128i const even = _mm_mul_epu32(t, delta4);
+                __m128i const odd = _mm_mul_epu32(_mm_srli_epi64(t, 32), delta4);
+                __m128i const product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, 0x08),
+                                                           _mm_shuffle_epi32(odd, 0x08));
+                __m128i *const out = (__m128i *)(buf + i);
+                _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), product));
+        }
+#elif BLIP_BUFFER_NEON
+        for (; i < count; i += 4) {
+                int32_t *const out = (int32_t *)(buf + i);
+                vst1q_s32(out, vmlaq_n_s32(vld1q_s32(out), vld1q_s32((int32_t const *)(taps + i)), delta));
+        }
+#else
+        for (; i < count; i++)
+                buf[i] += taps[i] * delta;
+#endif
+}
+
 struct blip_buffer_state_t {
         blip_resampled_time_t offset_;
         blip_long reader_accum_;
@@ -484,105 +542,12 @@ inline void Blip_Synth<quality, range>::offset_resampled(blip_resampled_time_t t
         buf[0] = left;
         buf[1] = right;
 #else
-
-        int const fwd = (blip_widest_impulse_ - quality) / 2;
-        int const rev = fwd + quality - 2;
-        int const mid = quality / 2 - 1;
-
-        imp_t const *BLIP_RESTRICT imp = impulses + blip_res - phase;
-
-#if defined(_M_IX86) || defined(_M_IA64) || defined(__i486__) || defined(__x86_64__) ||            \
-    defined(__ia64__) || defined(__i386__)
-
-// this straight forward version gave in better code on GCC for x86
-
-#define ADD_IMP(out, in) buf[out] += (blip_long)imp[blip_res * (in)] * delta
-
-#define BLIP_FWD(i)                                                                                \
-        {                                                                                          \
-                ADD_IMP(fwd + i, i);                                                               \
-                ADD_IMP(fwd + 1 + i, i + 1);                                                       \
-        }
-#define BLIP_REV(r)                                                                                \
-        {                                                                                          \
-                ADD_IMP(rev - r, r + 1);                                                           \
-                ADD_IMP(rev + 1 - r, r);                                                           \
-        }
-
-        BLIP_FWD(0)
-        if constexpr (quality > 8)
-                BLIP_FWD(2)
-        if constexpr (quality > 12)
-                BLIP_FWD(4)
-                {
-                        ADD_IMP(fwd + mid - 1, mid - 1);
-                        ADD_IMP(fwd + mid, mid);
-                        imp = impulses + phase;
-                }
-        if constexpr (quality > 12)
-                BLIP_REV(6)
-        if constexpr (quality > 8)
-                BLIP_REV(4)
-        BLIP_REV(2)
-
-        ADD_IMP(rev, 1);
-        ADD_IMP(rev + 1, 0);
-
-#undef ADD_IMP
-
-#else
-
-// for RISC processors, help compiler by reading ahead of writes
-
-#define BLIP_FWD(i)                                                                                \
-        {                                                                                          \
-                blip_long t0 = i0 * delta + buf[fwd + i];                                          \
-                blip_long t1 = imp[blip_res * (i + 1)] * delta + buf[fwd + 1 + i];                 \
-                i0 = imp[blip_res * (i + 2)];                                                      \
-                buf[fwd + i] = t0;                                                                 \
-                buf[fwd + 1 + i] = t1;                                                             \
-        }
-#define BLIP_REV(r)                                                                                \
-        {                                                                                          \
-                blip_long t0 = i0 * delta + buf[rev - r];                                          \
-                blip_long t1 = imp[blip_res * r] * delta + buf[rev + 1 - r];                       \
-                i0 = imp[blip_res * (r - 1)];                                                      \
-                buf[rev - r] = t0;                                                                 \
-                buf[rev + 1 - r] = t1;                                                             \
-        }
-
-        blip_long i0 = *imp;
-        BLIP_FWD(0)
-        if (quality > 8)
-                BLIP_FWD(2)
-        if (quality > 12)
-                BLIP_FWD(4)
-                {
-                        blip_long t0 = i0 * delta + buf[fwd + mid - 1];
-                        blip_long t1 = imp[blip_res * mid] * delta + buf[fwd + mid];
-                        imp = impulses + phase;
-                        i0 = imp[blip_res * mid];
-                        buf[fwd + mid - 1] = t0;
-                        buf[fwd + mid] = t1;
-                }
-        if (quality > 12)
-                BLIP_REV(6)
-        if (quality > 8)
-                BLIP_REV(4)
-        BLIP_REV(2)
-
-        blip_long t0 = i0 * delta + buf[rev];
-        blip_long t1 = *imp * delta + buf[rev + 1];
-        buf[rev] = t0;
-        buf[rev + 1] = t1;
-#endif
-
+        // The impulse is centered on the sample, within the widest one
+        blip_add_taps_<quality>(buf + (blip_widest_impulse_ - quality) / 2, taps + phase * quality,
+                                delta);
 #endif
 }
 
-#undef BLIP_FWD
-#undef BLIP_REV
-
 template <int quality, int range>
 #if BLIP_BUFFER_FAST
 inline
@@ -477,6 +477,55 @@ long Effects_Buffer::read_samples( blip_sample_t* out, long out_size )
 	return out_size;
 }
 
+long Effects_Buffer::skip_samples( long count )
+{
+	require( (count & 1) == 0 ); // must skip an even number of samples
+	count = min( count, samples_avail() );
+
+	// Leaves the echo as it is, which is only right after clear()
+	long const removed = mixer.samples_read + (count >> 1);
+	for ( buf_t& buf : bufs )
+	{
+		if ( buf.non_silent() )
+			buf.remove_samples( removed );
+		else
+			buf.remove_silence( removed );
+	}
+	mixer.samples_read = 0;
+	return count;
+}
+
+// Converts 'pair_count' pairs from fixed point and clamps them to 16 bits
+static void clamp_pairs( Effects_Buffer::fixed_t const* in, blip_sample_t* out, int pair_count )
+{
+	int const count = pair_count * Effects_Buffer::stereo;
+	int i = 0;
+
+	// saturating is what BLIP_CLAMP does
+#if BLIP_BUFFER_SSE2
+	for ( ; i + 8 <= count; i += 8 )
+	{
+		__m128i const lo = _mm_srai_epi32( _mm_loadu_si128( (__m128i const*) (in + i    ) ), fixed_shift );
+		__m128i const hi = _mm_srai_epi32( _mm_loadu_si128( (__m128i const*) (in + i + 4) ), fixed_shift );
+		_mm_storeu_si128( (__m128i*) (out + i), _mm_packs_epi32( lo, hi ) );
+	}
+#elif BLIP_BUFFER_NEON
+	for ( ; i + 8 <= count; i += 8 )
+	{
+		int32x4_t const lo = vshrq_n_s32( vld1q_s32( (int32_t const*) (in + i    ) ), fixed_shift );
+		int32x4_t const hi = vshrq_n_s32( vld1q_s32( (int32_t const*) (in + i + 4) ), fixed_shift );
+		vst1q_s16( (int16_t*) (out + i), vcombine_s16( vqmovn_s32( lo ), vqmovn_s32( hi ) ) );
+	}
+#endif
+
+	for ( ; i < count; i++ )
+	{
+		Effects_Buffer::fixed_t s = FROM_FIXED( in [i] );
+		BLIP_CLAMP( s, s );
+		out [i] = (blip_sample_t) s;
+	}
+}
+
 void Effects_Buffer::mix_effects( blip_sample_t* out_, int pair_count )
 {
 	typedef fixed_t stereo_fixed_t [stereo];
@@ -600,21 +649,8 @@ void Effects_Buffer::mix_effects( blip_sample_t* out_, int pair_count )
 		do
 		{
 			remain -= count;
-			in  += count;
+			clamp_pairs( *in, *out, count );
 			out += count;
-			int offset = -count;
-			do
-			{
-				fixed_t in_0 = FROM_FIXED( in [offset] [0] );
-				fixed_t in_1 = FROM_FIXED( in [offset] [1] );
-
-				BLIP_CLAMP( in_0, in_0 );
-				out [offset] [0] = (blip_sample_t) in_0;
-
-				BLIP_CLAMP( in_1, in_1 );
-				out [offset] [1] = (blip_sample_t) in_1;
-			}
-			while ( ++offset );
 
 			in = (stereo_fixed_t*) echo.begin();
 			count = remain;
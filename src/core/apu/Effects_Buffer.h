@@ -69,6 +69,7 @@ class Effects_Buffer : public Multi_Buffer
         channel_t channel(int);
         void end_frame(blip_time_t);
         long read_samples(blip_sample_t *, long);
+        long skip_samples(long);
         long samples_avail() const
         {
                 return (bufs[0].samples_avail() - mixer.samples_read) * 2;
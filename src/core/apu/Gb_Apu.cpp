@@ -58,6 +58,12 @@ void Gb_Apu::set_output( Blip_Buffer* center, Blip_Buffer* left, Blip_Buffer* ri
 	while ( ++i < osc );
 }
 
+void Gb_Apu::clear_amps()
+{
+	for ( int i = 0; i < osc_count; i++ )
+		oscs [i]->last_amp = 0;
+}
+
 void Gb_Apu::synth_volume( int iv )
 {
 	double v = volume_ * 0.60 / osc_count / 15 /*steps*/ / 8 /*master vol range*/ * iv;
@@ -26,6 +26,10 @@ class Gb_Apu
         void set_output(Blip_Buffer *center, Blip_Buffer *left = NULL, Blip_Buffer *right = NULL,
                         int chan = osc_count);
 
+        // Forgets the amplitudes the oscillators left in their buffers, so that they
+        // start again from silence. Call after clearing the buffers.
+        void clear_amps();
+
         // Resets hardware to initial power on state BEFORE boot ROM runs. Mode selects
         // sound hardware. Additional AGB wave features are enabled separately.
         enum mode_t {
@@ -196,6 +196,24 @@ long Stereo_Buffer::read_samples( blip_sample_t* out, long out_size )
 	return out_size;
 }
 
+long Stereo_Buffer::skip_samples( long count )
+{
+	require( (count & 1) == 0 ); // must skip an even number of samples
+	count = min( count, samples_avail() );
+
+	long const removed = mixer.samples_read + (count >> 1);
+	for ( int i = bufs_size; --i >= 0; )
+	{
+		buf_t& b = bufs [i];
+		if ( !b.non_silent() )
+			b.remove_silence( removed );
+		else
+			b.remove_samples( removed );
+	}
+	mixer.samples_read = 0;
+	return count;
+}
+
 
 // Stereo_Mixer
 
@@ -237,6 +255,111 @@ void Stereo_Mixer::mix_mono( blip_sample_t* out_, int count )
 	BLIP_READER_END( center, *bufs [2] );
 }
 
+#if BLIP_BUFFER_SSE2 || BLIP_BUFFER_NEON
+
+// The left, right and center readers advance together in the lanes of a vector,
+// four samples at a time, and the center is only read once. The samples left
+// over go through the scalar loop.
+void Stereo_Mixer::mix_stereo( blip_sample_t* out, int count )
+{
+	// read_pairs() already counted the samples
+	int const bass = BLIP_READER_BASS( *bufs [2] );
+	long const first = samples_read - count;
+	Blip_Buffer::buf_t_ const* const left   = bufs [0]->buffer_ + first;
+	Blip_Buffer::buf_t_ const* const right  = bufs [1]->buffer_ + first;
+	Blip_Buffer::buf_t_ const* const center = bufs [2]->buffer_ + first;
+
+	blip_long accum [4] = { bufs [0]->reader_accum_, bufs [1]->reader_accum_, bufs [2]->reader_accum_, 0 };
+	int i = 0;
+
+#if BLIP_BUFFER_SSE2
+	__m128i a = _mm_loadu_si128( (__m128i const*) accum );
+	__m128i const shift = _mm_cvtsi32_si128( bass );
+	__m128i const zero  = _mm_setzero_si128();
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		// left, right, center and 0 for each sample
+		__m128i const l = _mm_loadu_si128( (__m128i const*) (left   + i) );
+		__m128i const r = _mm_loadu_si128( (__m128i const*) (right  + i) );
+		__m128i const c = _mm_loadu_si128( (__m128i const*) (center + i) );
+		__m128i const lr01 = _mm_unpacklo_epi32( l, r );
+		__m128i const lr23 = _mm_unpackhi_epi32( l, r );
+		__m128i const cz01 = _mm_unpacklo_epi32( c, zero );
+		__m128i const cz23 = _mm_unpackhi_epi32( c, zero );
+		__m128i const in [4] = {
+			_mm_unpacklo_epi64( lr01, cz01 ), _mm_unpackhi_epi64( lr01, cz01 ),
+			_mm_unpacklo_epi64( lr23, cz23 ), _mm_unpackhi_epi64( lr23, cz23 )
+		};
+
+		__m128i s [4];
+		for ( int n = 0; n < 4; n++ )
+		{
+			// left + center and right + center in the low lanes
+			s [n] = _mm_srai_epi32( _mm_add_epi32( a, _mm_shuffle_epi32( a, 0xAA ) ), blip_sample_bits - 16 );
+			a = _mm_add_epi32( _mm_sub_epi32( a, _mm_sra_epi32( a, shift ) ), in [n] );
+		}
+
+		// saturating is what BLIP_CLAMP does
+		__m128i const pairs01 = _mm_unpacklo_epi64( s [0], s [1] );
+		__m128i const pairs23 = _mm_unpacklo_epi64( s [2], s [3] );
+		_mm_storeu_si128( (__m128i*) (out + i * stereo), _mm_packs_epi32( pairs01, pairs23 ) );
+	}
+	_mm_storeu_si128( (__m128i*) accum, a );
+#else
+	int32x4_t a = vld1q_s32( (int32_t const*) accum );
+	int32x4_t const shift = vdupq_n_s32( -bass );
+	int32x4_t const zero  = vdupq_n_s32( 0 );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		// left, right, center and 0 for each sample
+		int32x4x2_t const lr = vzipq_s32( vld1q_s32( (int32_t const*) (left + i) ),
+				vld1q_s32( (int32_t const*) (right + i) ) );
+		int32x4x2_t const cz = vzipq_s32( vld1q_s32( (int32_t const*) (center + i) ), zero );
+		int32x4_t const in [4] = {
+			vcombine_s32( vget_low_s32(  lr.val [0] ), vget_low_s32(  cz.val [0] ) ),
+			vcombine_s32( vget_high_s32( lr.val [0] ), vget_high_s32( cz.val [0] ) ),
+			vcombine_s32( vget_low_s32(  lr.val [1] ), vget_low_s32(  cz.val [1] ) ),
+			vcombine_s32( vget_high_s32( lr.val [1] ), vget_high_s32( cz.val [1] ) )
+		};
+
+		int32x2_t s [4];
+		for ( int n = 0; n < 4; n++ )
+		{
+			// left + center and right + center
+			s [n] = vshr_n_s32( vadd_s32( vget_low_s32( a ), vdup_n_s32( vgetq_lane_s32( a, 2 ) ) ),
+					blip_sample_bits - 16 );
+			a = vaddq_s32( vsubq_s32( a, vshlq_s32( a, shift ) ), in [n] );
+		}
+
+		// saturating is what BLIP_CLAMP does
+		int16x8_t const pairs = vcombine_s16( vqmovn_s32( vcombine_s32( s [0], s [1] ) ),
+				vqmovn_s32( vcombine_s32( s [2], s [3] ) ) );
+		vst1q_s16( (int16_t*) (out + i * stereo), pairs );
+	}
+	vst1q_s32( (int32_t*) accum, a );
+#endif
+
+	for ( ; i < count; i++ )
+	{
+		blargg_long l = (blargg_long) (accum [0] + accum [2]) >> (blip_sample_bits - 16);
+		blargg_long r = (blargg_long) (accum [1] + accum [2]) >> (blip_sample_bits - 16);
+		BLIP_CLAMP( l, l );
+		BLIP_CLAMP( r, r );
+		out [i * stereo]     = (blip_sample_t) l;
+		out [i * stereo + 1] = (blip_sample_t) r;
+
+		accum [0] += left   [i] - (accum [0] >> bass);
+		accum [1] += right  [i] - (accum [1] >> bass);
+		accum [2] += center [i] - (accum [2] >> bass);
+	}
+
+	bufs [0]->reader_accum_ = accum [0];
+	bufs [1]->reader_accum_ = accum [1];
+	bufs [2]->reader_accum_ = accum [2];
+}
+
+#else
+
 void Stereo_Mixer::mix_stereo( blip_sample_t* out_, int count )
 {
 	blip_sample_t* BLIP_RESTRICT out = out_ + count * stereo;
@@ -279,3 +402,5 @@ void Stereo_Mixer::mix_stereo( blip_sample_t* out_, int count )
 		break;
 	}
 }
+
+#endif
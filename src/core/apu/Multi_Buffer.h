@@ -62,6 +62,10 @@ class Multi_Buffer
         virtual long read_samples(blip_sample_t *, long) BLARGG_PURE({ return 0; })
         virtual long samples_avail() const BLARGG_PURE({ return 0; })
 
+        // Removes up to count samples without mixing them, and returns the number
+        // removed. Cheap if nothing was added to the buffers since clear().
+        virtual long skip_samples(long) BLARGG_PURE({ return 0; })
+
         BLARGG_DISABLE_NOTHROW
 
         void disable_immediate_removal()
@@ -134,6 +138,13 @@ class Mono_Buffer : public Multi_Buffer
         {
                 return buf.read_samples(p, s);
         }
+        long skip_samples(long s)
+        {
+                if (s > buf.samples_avail())
+                        s = buf.samples_avail();
+                buf.remove_samples(s);
+                return s;
+        }
         channel_t channel(int)
         {
                 return chan;
@@ -221,6 +232,7 @@ class Stereo_Buffer : public Multi_Buffer
                 return (bufs[0].samples_avail() - mixer.samples_read) * 2;
         }
         long read_samples(blip_sample_t *, long);
+        long skip_samples(long);
 
         private:
         enum { bufs_size = 3 };
@@ -0,0 +1,38 @@
+#include "core/base/cpu_features.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif  // defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+
+namespace {
+
+bool checkAvx2()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // The CPU supports AVX and the OS saves the YMM registers.
+    __cpuid(info, 1);
+    if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & 0x20) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+bool cpuHasAvx2()
+{
+    static const bool hasAvx2 = checkAvx2();
+    return hasAvx2;
+}
@@ -0,0 +1,11 @@
+#ifndef VBAM_CORE_BASE_CPU_FEATURES_H_
+#define VBAM_CORE_BASE_CPU_FEATURES_H_
+
+// Run time checks for the instruction sets that the vector kernels pick from
+// when they are built for several of them.
+
+// Returns true if the CPU supports AVX2 and the OS saves the YMM registers.
+// Always false on other CPUs than x86.
+bool cpuHasAvx2();
+
+#endif  // VBAM_CORE_BASE_CPU_FEATURES_H_
@@ -0,0 +1,38 @@
+#include "core/base/frame_limiter.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+// One frame at native speed, rounded down.
+constexpr auto kFrame = std::chrono::microseconds(16742);
+
+}  // namespace
+
+TEST(FrameLimiterTest, PacesAtTheThrottle) {
+    FrameLimiter limiter;
+
+    // The first frame sets the schedule.
+    limiter.wait(200);
+    const clock::time_point start = clock::now();
+    for (int i = 0; i < 6; i++)
+        limiter.wait(200);
+
+    // Twice the native speed, half a frame each. The start is a little late
+    // on the schedule, hence one period less.
+    EXPECT_GE(clock::now() - start, kFrame * 5 / 2);
+}
+
+TEST(FrameLimiterTest, DoesNotWaitWhenUnthrottled) {
+    FrameLimiter limiter;
+
+    const clock::time_point start = clock::now();
+    for (int i = 0; i < 60; i++)
+        limiter.wait(0);
+
+    EXPECT_LT(clock::now() - start, kFrame);
+}
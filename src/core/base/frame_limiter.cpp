@@ -0,0 +1,40 @@
+#include "core/base/frame_limiter.h"
+
+#include <thread>
+
+namespace {
+
+// The GBA and the GB both draw a frame every 280896 cycles of 2^24 Hz, which
+// is about 59.73 frames per second.
+constexpr double kFrameSeconds = 280896.0 / 16777216.0;
+
+// When the emulation falls more than this many frames behind, it is not sped
+// up to catch up, the schedule starts over instead. This also covers pauses.
+constexpr int kMaxLagFrames = 4;
+
+}  // namespace
+
+void FrameLimiter::wait(unsigned throttle) {
+    if (!throttle) {
+        reset();
+        return;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const clock::duration period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(kFrameSeconds * 100.0 / throttle));
+    const clock::time_point now = clock::now();
+
+    if (!m_started || now - m_next > period * kMaxLagFrames) {
+        m_next = now;
+        m_started = true;
+    }
+
+    m_next += period;
+    if (m_next > now)
+        std::this_thread::sleep_until(m_next);
+}
+
+void FrameLimiter::reset() {
+    m_started = false;
+}
@@ -0,0 +1,26 @@
+#ifndef VBAM_CORE_BASE_FRAME_LIMITER_H_
+#define VBAM_CORE_BASE_FRAME_LIMITER_H_
+
+#include <chrono>
+
+// Paces the emulation at the throttled speed.
+//
+// The sound drivers never wait for their device, they drop what does not fit
+// in their buffer. Instead, the frontends call wait() once per emulated frame,
+// which sleeps the emulator thread until the frame is due.
+class FrameLimiter {
+public:
+    // Waits until the next frame is due, at `throttle` percent of the native
+    // frame rate. A throttle of 0 does not wait.
+    void wait(unsigned throttle);
+
+    // Starts over from the current time at the next call to wait(), for
+    // when the emulation ran unthrottled.
+    void reset();
+
+private:
+    std::chrono::steady_clock::time_point m_next;
+    bool m_started = false;
+};
+
+#endif  // VBAM_CORE_BASE_FRAME_LIMITER_H_
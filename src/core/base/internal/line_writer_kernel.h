@@ -0,0 +1,49 @@
+// Vector line conversion, see line_writer.h for what it computes.
+//
+// This file has no include guard: line_writer.cpp includes it once per
+// instruction set, inside a namespace defining the vector type `V`, so that
+// every copy is compiled for its own target. `V` works on 32-bit lanes and
+// provides the operations used below. `V::store16()` and `V::store8()` write
+// the low 16 or 8 bits of every lane, which are known to fit.
+
+void convertLine(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format)
+{
+    const V::T channel = V::set1(0x1f);
+
+    if (format.depth == 8) {
+        const V::T red = V::set1(0xe0);
+        const V::T green = V::set1(0x1c);
+        const V::T blue = V::set1(0x03);
+        for (int x = 0; x < width; x += V::kLanes) {
+            const V::T color = V::load(colors + x);
+            V::T pixel = V::and_(V::sll<3>(color), red);
+            pixel = V::or_(pixel, V::and_(V::srl<5>(color), green));
+            pixel = V::or_(pixel, V::and_(V::srl<13>(color), blue));
+            V::store8(dest + x, pixel);
+        }
+        return;
+    }
+
+    for (int x = 0; x < width; x += V::kLanes) {
+        const V::T color = V::load(colors + x);
+        V::T pixel = V::shl(V::and_(color, channel), format.redShift);
+        pixel = V::or_(pixel, V::shl(V::and_(V::srl<5>(color), channel), format.greenShift));
+        pixel = V::or_(pixel, V::shl(V::and_(V::srl<10>(color), channel), format.blueShift));
+
+        switch (format.depth) {
+        case 16:
+            V::store16((uint16_t*)dest + x, pixel);
+            break;
+        case 24: {
+            uint32_t pixels[V::kLanes];
+            V::store(pixels, pixel);
+            for (int i = 0; i < V::kLanes; i++)
+                memcpy(dest + (x + i) * 3, &pixels[i], 3);
+            break;
+        }
+        default:
+            V::store((uint32_t*)dest + x, pixel);
+            break;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#include "core/base/line_writer.h"
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/base/cpu_features.h"
+#include "core/base/system.h"
+
+namespace {
+
+// Frame buffer formats used by the frontends.
+const LineFormat kFormats[] = {
+    { 8, 0, 0, 0 },
+    { 16, 11, 6, 0 },
+    { 16, 10, 5, 0 },
+    { 24, 3, 11, 19 },
+    { 32, 19, 11, 3 },
+    { 32, 3, 11, 19 },
+    { 32, 27, 19, 11 },
+};
+
+// Fills the tables like gbafilter_update_colors() does without a filter.
+void FillColorMaps(const LineFormat& format)
+{
+    systemColorDepth = format.depth;
+    systemRedShift = format.redShift;
+    systemGreenShift = format.greenShift;
+    systemBlueShift = format.blueShift;
+
+    for (int i = 0; i < 0x10000; i++) {
+        systemColorMap8[i] = (uint8_t)((((i & 0x1f) << 3) & 0xE0) | ((((i & 0x3e0) >> 5) << 0) & 0x1C) |
+                                       ((((i & 0x7c00) >> 10) >> 3) & 0x3));
+        const uint32_t color = ((i & 0x1f) << systemRedShift) | (((i & 0x3e0) >> 5) << systemGreenShift) |
+                               (((i & 0x7c00) >> 10) << systemBlueShift);
+        systemColorMap16[i] = (uint16_t)color;
+        systemColorMap32[i] = color;
+    }
+}
+
+class LineWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        // Random upper bits too, the GBA line buffer has priorities there.
+        std::mt19937 rng(240);
+        colors_.resize(240);
+        for (uint32_t& color : colors_)
+            color = rng();
+    }
+
+    void TearDown() override { lineWriterSetFormat(true); }
+
+    // Converts the line through the tables, then with the shifts.
+    void ExpectMatchesTables(LineConvertFunc kernel)
+    {
+        for (const LineFormat& format : kFormats) {
+            FillColorMaps(format);
+
+            const size_t size = 240 * 4;
+            std::vector<uint8_t> expected(size + 1, 0xAA);
+            lineWriterSetFormat(true);
+            lineWriterConvert(colors_.data(), 240, expected.data());
+
+            std::vector<uint8_t> line(size + 1, 0xAA);
+            kernel(colors_.data(), 240, line.data(), format);
+            EXPECT_EQ(line, expected) << "depth " << format.depth << " red shift " << format.redShift;
+        }
+    }
+
+    std::vector<uint32_t> colors_;
+};
+
+TEST_F(LineWriterTest, ScalarMatchesTables)
+{
+    ExpectMatchesTables(lineWriterConvertScalar);
+}
+
+TEST_F(LineWriterTest, UsesTablesWhenFiltered)
+{
+    FillColorMaps(kFormats[4]);
+    systemColorMap32[colors_[0] & 0xFFFF] = 0x12345678;
+
+    uint32_t line[240];
+    lineWriterSetFormat(true);
+    lineWriterConvert(colors_.data(), 240, (uint8_t*)line);
+    EXPECT_EQ(line[0], 0x12345678u);
+
+    lineWriterSetFormat(false);
+    lineWriterConvert(colors_.data(), 240, (uint8_t*)line);
+    EXPECT_NE(line[0], 0x12345678u);
+
+    // A depth changed behind the writer's back goes back to the tables.
+    systemColorDepth = 16;
+    uint16_t line16[240];
+    lineWriterConvert(colors_.data(), 240, (uint8_t*)line16);
+    EXPECT_EQ(line16[1], systemColorMap16[colors_[1] & 0xFFFF]);
+}
+
+TEST_F(LineWriterTest, TracksChangedLines)
+{
+    uint8_t line[240 * 4] = {};
+    uint8_t dirty[kLineWriterLines];
+    LineWriterHashes hashes = {};
+
+    lineWriterInvalidate(hashes);
+    EXPECT_TRUE(lineWriterTakeDirtyLines(hashes, dirty));
+    EXPECT_EQ(dirty[0], 1);
+    EXPECT_EQ(dirty[kLineWriterLines - 1], 1);
+    EXPECT_FALSE(lineWriterTakeDirtyLines(hashes, nullptr));
+
+    // Writing the same line twice only marks it the first time.
+    lineWriterHash(hashes, 3, line, sizeof(line));
+    EXPECT_TRUE(lineWriterTakeDirtyLines(hashes, dirty));
+    EXPECT_EQ(dirty[2], 0);
+    EXPECT_EQ(dirty[3], 1);
+    lineWriterHash(hashes, 3, line, sizeof(line));
+    EXPECT_FALSE(lineWriterTakeDirtyLines(hashes, nullptr));
+
+    line[239 * 4] = 1;
+    lineWriterHash(hashes, 3, line, sizeof(line));
+    EXPECT_TRUE(lineWriterTakeDirtyLines(hashes, nullptr));
+}
+
+#if defined(VBAM_LINE_WRITER_SSE2)
+TEST_F(LineWriterTest, Sse2MatchesTables)
+{
+    ExpectMatchesTables(lineWriterConvertSse2);
+}
+#endif
+
+#if defined(VBAM_LINE_WRITER_AVX2)
+TEST_F(LineWriterTest, Avx2MatchesTables)
+{
+    if (!cpuHasAvx2()) {
+        GTEST_SKIP() << "AVX2 is not supported by this CPU";
+    }
+    ExpectMatchesTables(lineWriterConvertAvx2);
+}
+#endif
+
+#if defined(VBAM_LINE_WRITER_NEON)
+TEST_F(LineWriterTest, NeonMatchesTables)
+{
+    ExpectMatchesTables(lineWriterConvertNeon);
+}
+#endif
+
+}  // namespace
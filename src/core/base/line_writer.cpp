@@ -0,0 +1,331 @@
+#include "core/base/line_writer.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "core/base/cpu_features.h"
+#include "core/base/system.h"
+
+#if defined(VBAM_LINE_WRITER_SSE2)
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif  // defined(VBAM_LINE_WRITER_SSE2)
+
+#if defined(VBAM_LINE_WRITER_NEON)
+#include <arm_neon.h>
+#endif  // defined(VBAM_LINE_WRITER_NEON)
+
+#if defined(VBAM_LINE_WRITER_SSE2)
+
+namespace sse2 {
+namespace {
+
+struct V {
+    typedef __m128i T;
+    static constexpr int kLanes = 4;
+
+    static inline T load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static inline void store(uint32_t* p, T a) { _mm_storeu_si128((__m128i*)p, a); }
+    // Sign-extending the low halves keeps packs from saturating them.
+    static inline void store16(uint16_t* p, T a)
+    {
+        a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+        _mm_storel_epi64((__m128i*)p, _mm_packs_epi32(a, a));
+    }
+    static inline void store8(uint8_t* p, T a)
+    {
+        a = _mm_packs_epi32(a, a);
+        const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(a, a));
+        memcpy(p, &bytes, 4);
+    }
+    static inline T set1(uint32_t v) { return _mm_set1_epi32((int)v); }
+    static inline T and_(T a, T b) { return _mm_and_si128(a, b); }
+    static inline T or_(T a, T b) { return _mm_or_si128(a, b); }
+    template <int n>
+    static inline T srl(T a) { return _mm_srli_epi32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return _mm_slli_epi32(a, n); }
+    static inline T shl(T a, int n) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+};
+
+#include "core/base/internal/line_writer_kernel.h"
+
+}  // namespace
+}  // namespace sse2
+
+void lineWriterConvertSse2(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format)
+{
+    sse2::convertLine(colors, width, dest, format);
+}
+
+#endif  // defined(VBAM_LINE_WRITER_SSE2)
+
+#if defined(VBAM_LINE_WRITER_AVX2)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+namespace {
+
+struct V {
+    typedef __m256i T;
+    static constexpr int kLanes = 8;
+
+    static inline T load(const uint32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static inline void store(uint32_t* p, T a) { _mm256_storeu_si256((__m256i*)p, a); }
+    // packs works within each 128-bit half, the halves are packed apart.
+    static inline __m128i pack16(T a)
+    {
+        a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+        return _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+    }
+    static inline void store16(uint16_t* p, T a) { _mm_storeu_si128((__m128i*)p, pack16(a)); }
+    static inline void store8(uint8_t* p, T a)
+    {
+        const __m128i words = pack16(a);
+        _mm_storel_epi64((__m128i*)p, _mm_packus_epi16(words, words));
+    }
+    static inline T set1(uint32_t v) { return _mm256_set1_epi32((int)v); }
+    static inline T and_(T a, T b) { return _mm256_and_si256(a, b); }
+    static inline T or_(T a, T b) { return _mm256_or_si256(a, b); }
+    template <int n>
+    static inline T srl(T a) { return _mm256_srli_epi32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return _mm256_slli_epi32(a, n); }
+    static inline T shl(T a, int n) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+};
+
+#include "core/base/internal/line_writer_kernel.h"
+
+}  // namespace
+}  // namespace avx2
+
+void lineWriterConvertAvx2(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format)
+{
+    avx2::convertLine(colors, width, dest, format);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif  // defined(VBAM_LINE_WRITER_AVX2)
+
+#if defined(VBAM_LINE_WRITER_NEON)
+
+namespace neon {
+namespace {
+
+struct V {
+    typedef uint32x4_t T;
+    static constexpr int kLanes = 4;
+
+    static inline T load(const uint32_t* p) { return vld1q_u32(p); }
+    static inline void store(uint32_t* p, T a) { vst1q_u32(p, a); }
+    static inline void store16(uint16_t* p, T a) { vst1_u16(p, vmovn_u32(a)); }
+    static inline void store8(uint8_t* p, T a)
+    {
+        const uint16x4_t words = vmovn_u32(a);
+        const uint8x8_t bytes = vmovn_u16(vcombine_u16(words, words));
+        vst1_lane_u32((uint32_t*)p, vreinterpret_u32_u8(bytes), 0);
+    }
+    static inline T set1(uint32_t v) { return vdupq_n_u32(v); }
+    static inline T and_(T a, T b) { return vandq_u32(a, b); }
+    static inline T or_(T a, T b) { return vorrq_u32(a, b); }
+    template <int n>
+    static inline T srl(T a) { return vshrq_n_u32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return vshlq_n_u32(a, n); }
+    static inline T shl(T a, int n) { return vshlq_u32(a, vdupq_n_s32(n)); }
+};
+
+#include "core/base/internal/line_writer_kernel.h"
+
+}  // namespace
+}  // namespace neon
+
+void lineWriterConvertNeon(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format)
+{
+    neon::convertLine(colors, width, dest, format);
+}
+
+#endif  // defined(VBAM_LINE_WRITER_NEON)
+
+LineConvertFunc lineWriterKernel()
+{
+#if defined(VBAM_LINE_WRITER_AVX2)
+    if (cpuHasAvx2())
+        return lineWriterConvertAvx2;
+#endif
+#if defined(VBAM_LINE_WRITER_SSE2)
+    return lineWriterConvertSse2;
+#elif defined(VBAM_LINE_WRITER_NEON)
+    return lineWriterConvertNeon;
+#else
+    return nullptr;
+#endif
+}
+
+void lineWriterConvertScalar(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format)
+{
+    for (int x = 0; x < width; x++) {
+        const uint32_t color = colors[x];
+        if (format.depth == 8) {
+            dest[x] = ((color << 3) & 0xe0) | ((color >> 5) & 0x1c) | ((color >> 13) & 0x03);
+            continue;
+        }
+
+        const uint32_t pixel = ((color & 0x1f) << format.redShift) |
+                               (((color >> 5) & 0x1f) << format.greenShift) |
+                               (((color >> 10) & 0x1f) << format.blueShift);
+        switch (format.depth) {
+        case 16:
+            ((uint16_t*)dest)[x] = pixel;
+            break;
+        case 24:
+            memcpy(dest + x * 3, &pixel, 3);
+            break;
+        default:
+            ((uint32_t*)dest)[x] = pixel;
+            break;
+        }
+    }
+}
+
+namespace {
+
+const LineConvertFunc lineWriterVector = lineWriterKernel();
+
+// The format the tables were last filled for, if they hold the plain shifts.
+// A depth of 0 sends everything through the tables.
+LineFormat lineWriterFormat = { 0, 0, 0, 0 };
+
+// Counts the format changes, which the frame buffers of all the cores follow.
+std::atomic<uint32_t> lineWriterFormatCount{ 0 };
+
+}  // namespace
+
+void lineWriterSetFormat(bool filtered)
+{
+    // The frame buffer is about to change format or colors.
+    lineWriterFormatCount++;
+    if (filtered) {
+        lineWriterFormat = { 0, 0, 0, 0 };
+        return;
+    }
+    lineWriterFormat = { systemColorDepth, systemRedShift, systemGreenShift, systemBlueShift };
+}
+
+void lineWriterConvert(const uint32_t* colors, int width, uint8_t* dest)
+{
+    const LineFormat format = lineWriterFormat;
+    if (format.depth == systemColorDepth) {
+        if (lineWriterVector)
+            lineWriterVector(colors, width, dest, format);
+        else
+            lineWriterConvertScalar(colors, width, dest, format);
+        return;
+    }
+
+    switch (systemColorDepth) {
+    case 8:
+        for (int x = 0; x < width; x++)
+            dest[x] = systemColorMap8[colors[x] & 0xFFFF];
+        break;
+    case 16:
+        for (int x = 0; x < width; x++)
+            ((uint16_t*)dest)[x] = systemColorMap16[colors[x] & 0xFFFF];
+        break;
+    case 24:
+        // only three bytes, the fourth one belongs to the next pixel
+        for (int x = 0; x < width; x++)
+            memcpy(dest + x * 3, &systemColorMap32[colors[x] & 0xFFFF], 3);
+        break;
+    case 32:
+        for (int x = 0; x < width; x++)
+            ((uint32_t*)dest)[x] = systemColorMap32[colors[x] & 0xFFFF];
+        break;
+    }
+}
+
+uint32_t lineWriterConvertColor(uint16_t color)
+{
+    switch (systemColorDepth) {
+    case 8:
+        return systemColorMap8[color];
+    case 16:
+        return systemColorMap16[color];
+    default:
+        return systemColorMap32[color];
+    }
+}
+
+void lineWriterStore(const uint32_t* pixels, int width, uint8_t* dest)
+{
+    switch (systemColorDepth) {
+    case 8:
+        for (int x = 0; x < width; x++)
+            dest[x] = pixels[x];
+        break;
+    case 16:
+        for (int x = 0; x < width; x++)
+            ((uint16_t*)dest)[x] = pixels[x];
+        break;
+    case 24:
+        for (int x = 0; x < width; x++)
+            memcpy(dest + x * 3, &pixels[x], 3);
+        break;
+    case 32:
+        memcpy(dest, pixels, width * sizeof(uint32_t));
+        break;
+    }
+}
+
+void lineWriterHash(LineWriterHashes& hashes, int line, const uint8_t* dest, int bytes)
+{
+    // Multiply and rotate over 8 bytes at a time, the lines are multiples of
+    // 8 bytes in every format.
+    uint64_t hash = (uint64_t)bytes;
+    for (int i = 0; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        memcpy(&word, dest + i, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+
+    if (hashes.hash[line] != hash) {
+        hashes.hash[line] = hash;
+        hashes.dirty[line] = 1;
+    }
+}
+
+void lineWriterInvalidate(LineWriterHashes& hashes)
+{
+    memset(hashes.hash, 0, sizeof(hashes.hash));
+    memset(hashes.dirty, 1, sizeof(hashes.dirty));
+}
+
+bool lineWriterTakeDirtyLines(LineWriterHashes& hashes, uint8_t* lines)
+{
+    const uint32_t format = lineWriterFormatCount;
+    if (hashes.format != format) {
+        hashes.format = format;
+        lineWriterInvalidate(hashes);
+    }
+
+    bool dirty = false;
+    for (int i = 0; i < kLineWriterLines; i++)
+        dirty |= hashes.dirty[i] != 0;
+
+    if (lines)
+        memcpy(lines, hashes.dirty, kLineWriterLines);
+    memset(hashes.dirty, 0, kLineWriterLines);
+    return dirty;
+}
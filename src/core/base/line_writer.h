@@ -0,0 +1,97 @@
+#ifndef VBAM_CORE_BASE_LINE_WRITER_H_
+#define VBAM_CORE_BASE_LINE_WRITER_H_
+
+#include <cstdint>
+
+#include "core/base/system.h"
+
+// Final conversion of the emulated screen lines to the frame buffer format.
+//
+// The GBA and GB renderers produce lines of 15-bit BGR colors. The frontends
+// request their native frame buffer format with systemColorDepth and the
+// systemRed/Green/BlueShift values, then fill the systemColorMap8/16/32
+// tables with gbafilter_update_colors(), which calls lineWriterSetFormat().
+// Unless a color filter went into the tables, they hold nothing but the
+// channel shifts, and the lines are converted with vector shifts and masks
+// instead of a table lookup per pixel. Filtered formats, and a color depth
+// changed without refilling the tables, still go through the tables.
+//
+// The 8-bit format is RGB332, whatever the shifts. The 24-bit format stores
+// the low 3 bytes of the 32-bit value of each pixel.
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VBAM_LINE_WRITER_SSE2
+#define VBAM_LINE_WRITER_AVX2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VBAM_LINE_WRITER_NEON
+#endif
+
+struct LineFormat {
+    int depth;
+    int redShift;
+    int greenShift;
+    int blueShift;
+};
+
+// Records the current format. `filtered` tells that the systemColorMap tables
+// went through a color filter and have to be used.
+void lineWriterSetFormat(bool filtered);
+
+// Converts `width` colors, whose upper 16 bits are ignored, and writes them at
+// `dest` in the systemColorDepth format. `width` is a multiple of 8.
+void lineWriterConvert(const uint32_t* colors, int width, uint8_t* dest);
+
+// Converts a single color to the systemColorDepth format.
+uint32_t lineWriterConvertColor(uint16_t color);
+
+// Writes `width` pixels, already converted to the systemColorDepth format, at
+// `dest`.
+void lineWriterStore(const uint32_t* pixels, int width, uint8_t* dest);
+
+// Change detection for the frontends. The cores hash every line they write to
+// the frame buffer with lineWriterHash(), and lines whose hash differs from
+// the previous frame are marked dirty. Lines that are not written, when
+// frames are skipped, stay clean. Anything else that changes the frame buffer
+// (resets, save states, SGB borders...) or the frontend's copy of it calls
+// lineWriterInvalidate(). A format change marks the lines of every core dirty.
+constexpr int kLineWriterLines = 256;
+
+struct LineWriterHashes {
+    uint64_t hash[kLineWriterLines];
+    // A byte per line, so that the renderer threads can mark their lines.
+    uint8_t dirty[kLineWriterLines];
+    // lineWriterSetFormat() calls seen by lineWriterTakeDirtyLines().
+    uint32_t format;
+};
+
+// Hashes the `bytes` bytes written at `dest` for frame buffer row `line`.
+void lineWriterHash(LineWriterHashes& hashes, int line, const uint8_t* dest, int bytes);
+
+// Marks every line dirty.
+void lineWriterInvalidate(LineWriterHashes& hashes);
+
+// Copies the dirty flags of the frame buffer rows to `lines`, if not null, and
+// clears them. Returns whether any row changed since the last call.
+bool lineWriterTakeDirtyLines(LineWriterHashes& hashes, uint8_t* lines);
+
+typedef void (*LineConvertFunc)(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format);
+
+// Shift conversion, the reference for the vector kernels.
+void lineWriterConvertScalar(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format);
+
+// Returns the fastest vector kernel supported by the host CPU, or null if
+// there is none.
+LineConvertFunc lineWriterKernel();
+
+#if defined(VBAM_LINE_WRITER_SSE2)
+void lineWriterConvertSse2(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format);
+#endif
+#if defined(VBAM_LINE_WRITER_AVX2)
+void lineWriterConvertAvx2(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format);
+#endif
+#if defined(VBAM_LINE_WRITER_NEON)
+void lineWriterConvertNeon(const uint32_t* colors, int width, uint8_t* dest, const LineFormat& format);
+#endif
+
+#endif  // VBAM_CORE_BASE_LINE_WRITER_H_
@@ -0,0 +1,106 @@
+#include "core/base/resampler.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// `frames` stereo frames of a 1 kHz tone at 44100 Hz, from frame `start`,
+// inverted on the right.
+std::vector<int16_t> Tone(int frames, int start)
+{
+    std::vector<int16_t> samples;
+    for (int i = start; i < start + frames; i++) {
+        const int16_t value = (int16_t)std::lround(10000 * std::sin(2 * 3.14159265358979323846 * 1000 * i / 44100));
+        samples.push_back(value);
+        samples.push_back(-value);
+    }
+    return samples;
+}
+
+TEST(ResamplerTest, PassesUnitRatioThrough)
+{
+    Resampler resampler;
+    std::vector<int16_t> out;
+    for (int i = 0; i < 10; i++) {
+        const std::vector<int16_t> in = Tone(735, i * 735);
+        resampler.process(in.data(), (int)in.size(), out);
+    }
+
+    // Everything but the frames still needed by the filter.
+    ASSERT_EQ(out.size(), (size_t)(10 * 735 - kResamplerTaps / 2) * 2);
+
+    const std::vector<int16_t> expected = Tone((int)out.size() / 2, 0);
+    for (size_t i = 0; i < out.size(); i++) {
+        ASSERT_NEAR(out[i], expected[i], 50) << "sample " << i;
+    }
+}
+
+TEST(ResamplerTest, FollowsRatio)
+{
+    for (const double ratio : { 0.995, 1.005 }) {
+        Resampler resampler;
+        resampler.setRatio(ratio);
+
+        std::vector<int16_t> out;
+        const std::vector<int16_t> in = Tone(735, 0);
+        for (int i = 0; i < 600; i++)
+            resampler.process(in.data(), (int)in.size(), out);
+
+        const double expected = 600 * 735 * ratio;
+        EXPECT_NEAR(out.size() / 2, expected, kResamplerTaps) << "ratio " << ratio;
+    }
+}
+
+TEST(ResamplerTest, ResetClearsInput)
+{
+    Resampler resampler;
+    std::vector<int16_t> out;
+    const std::vector<int16_t> in = Tone(735, 100);
+    resampler.process(in.data(), (int)in.size(), out);
+
+    resampler.reset();
+    out.clear();
+    const std::vector<int16_t> silence(2 * 735, 0);
+    resampler.process(silence.data(), (int)silence.size(), out);
+    for (const int16_t sample : out)
+        ASSERT_EQ(sample, 0);
+}
+
+#if defined(VBAM_RESAMPLER_SSE2) || defined(VBAM_RESAMPLER_NEON)
+TEST(ResamplerTest, KernelMatchesScalar)
+{
+    std::mt19937 rng(735);
+    std::uniform_real_distribution<float> sample(-32768, 32767);
+    std::uniform_int_distribution<int> phase(0, kResamplerPhases - 1);
+    std::uniform_real_distribution<float> mix(0, 1);
+
+    const ResamplerFilterFunc kernel = resamplerKernel();
+    ASSERT_NE(kernel, nullptr);
+
+    for (int i = 0; i < 10000; i++) {
+        float left[kResamplerTaps];
+        float right[kResamplerTaps];
+        for (int k = 0; k < kResamplerTaps; k++) {
+            left[k] = sample(rng);
+            right[k] = sample(rng);
+        }
+        const float* coeffs = resamplerCoefficients() + phase(rng) * kResamplerTaps;
+        const float t = mix(rng);
+
+        float expected[2];
+        resamplerFilterScalar(coeffs, t, left, right, expected);
+        float frame[2];
+        kernel(coeffs, t, left, right, frame);
+
+        // Only the order of the additions differs.
+        ASSERT_NEAR(frame[0], expected[0], 0.05f) << "frame " << i;
+        ASSERT_NEAR(frame[1], expected[1], 0.05f) << "frame " << i;
+    }
+}
+#endif
+
+}  // namespace
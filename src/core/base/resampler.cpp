@@ -0,0 +1,183 @@
+#include "core/base/resampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(VBAM_RESAMPLER_SSE2)
+#include <emmintrin.h>
+#endif  // defined(VBAM_RESAMPLER_SSE2)
+
+#if defined(VBAM_RESAMPLER_NEON)
+#include <arm_neon.h>
+#endif  // defined(VBAM_RESAMPLER_NEON)
+
+namespace {
+
+constexpr int kPhaseBits = 8;
+static_assert((1 << kPhaseBits) == kResamplerPhases, "kPhaseBits does not match kResamplerPhases");
+
+// Cutoff frequency, relative to the Nyquist frequency of the input. The ratio
+// never goes far enough below 1 to alias with this margin.
+constexpr double kCutoff = 0.9;
+
+std::vector<float> makeCoefficients()
+{
+    const double pi = 3.14159265358979323846;
+    std::vector<float> coeffs((kResamplerPhases + 1) * kResamplerTaps);
+
+    for (int phase = 0; phase <= kResamplerPhases; phase++) {
+        float* taps = &coeffs[phase * kResamplerTaps];
+        double sum = 0;
+        for (int k = 0; k < kResamplerTaps; k++) {
+            // Distance to the output frame, which lies `phase` after tap
+            // kResamplerTaps / 2 - 1.
+            const double x = k - (kResamplerTaps / 2 - 1) - (double)phase / kResamplerPhases;
+            const double sinc = x == 0 ? 1.0 : std::sin(pi * kCutoff * x) / (pi * kCutoff * x);
+            // Blackman window over [-kResamplerTaps / 2, kResamplerTaps / 2].
+            const double w = 2 * pi * x / kResamplerTaps;
+            const double window = 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2 * w);
+            taps[k] = (float)(sinc * window);
+            sum += taps[k];
+        }
+
+        // Unity gain for every phase, or the ratio changes would be heard.
+        for (int k = 0; k < kResamplerTaps; k++)
+            taps[k] = (float)(taps[k] / sum);
+    }
+
+    return coeffs;
+}
+
+int16_t toSample(float value)
+{
+    const float rounded = std::floor(value + 0.5f);
+    return (int16_t)std::min(32767.0f, std::max(-32768.0f, rounded));
+}
+
+}  // namespace
+
+#if defined(VBAM_RESAMPLER_SSE2)
+
+void resamplerFilterSse2(const float* coeffs, float t, const float* left, const float* right, float* out)
+{
+    const __m128 mix = _mm_set1_ps(t);
+    __m128 sumLeft = _mm_setzero_ps();
+    __m128 sumRight = _mm_setzero_ps();
+    for (int k = 0; k < kResamplerTaps; k += 4) {
+        const __m128 c0 = _mm_loadu_ps(coeffs + k);
+        const __m128 c1 = _mm_loadu_ps(coeffs + kResamplerTaps + k);
+        const __m128 c = _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(c1, c0), mix));
+        sumLeft = _mm_add_ps(sumLeft, _mm_mul_ps(c, _mm_loadu_ps(left + k)));
+        sumRight = _mm_add_ps(sumRight, _mm_mul_ps(c, _mm_loadu_ps(right + k)));
+    }
+
+    // Both horizontal sums at once, left in the low lane.
+    __m128 sum = _mm_add_ps(_mm_unpacklo_ps(sumLeft, sumRight), _mm_unpackhi_ps(sumLeft, sumRight));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    _mm_storel_pi((__m64*)out, sum);
+}
+
+#endif  // defined(VBAM_RESAMPLER_SSE2)
+
+#if defined(VBAM_RESAMPLER_NEON)
+
+void resamplerFilterNeon(const float* coeffs, float t, const float* left, const float* right, float* out)
+{
+    float32x4_t sumLeft = vdupq_n_f32(0);
+    float32x4_t sumRight = vdupq_n_f32(0);
+    for (int k = 0; k < kResamplerTaps; k += 4) {
+        const float32x4_t c0 = vld1q_f32(coeffs + k);
+        const float32x4_t c1 = vld1q_f32(coeffs + kResamplerTaps + k);
+        const float32x4_t c = vmlaq_n_f32(c0, vsubq_f32(c1, c0), t);
+        sumLeft = vmlaq_f32(sumLeft, c, vld1q_f32(left + k));
+        sumRight = vmlaq_f32(sumRight, c, vld1q_f32(right + k));
+    }
+
+    out[0] = vaddvq_f32(sumLeft);
+    out[1] = vaddvq_f32(sumRight);
+}
+
+#endif  // defined(VBAM_RESAMPLER_NEON)
+
+void resamplerFilterScalar(const float* coeffs, float t, const float* left, const float* right, float* out)
+{
+    float sumLeft = 0;
+    float sumRight = 0;
+    for (int k = 0; k < kResamplerTaps; k++) {
+        const float c = coeffs[k] + (coeffs[kResamplerTaps + k] - coeffs[k]) * t;
+        sumLeft += c * left[k];
+        sumRight += c * right[k];
+    }
+    out[0] = sumLeft;
+    out[1] = sumRight;
+}
+
+ResamplerFilterFunc resamplerKernel()
+{
+#if defined(VBAM_RESAMPLER_SSE2)
+    return resamplerFilterSse2;
+#elif defined(VBAM_RESAMPLER_NEON)
+    return resamplerFilterNeon;
+#else
+    return nullptr;
+#endif
+}
+
+const float* resamplerCoefficients()
+{
+    static const std::vector<float> coeffs = makeCoefficients();
+    return coeffs.data();
+}
+
+namespace {
+
+const ResamplerFilterFunc resamplerFilter = resamplerKernel() ? resamplerKernel() : resamplerFilterScalar;
+
+}  // namespace
+
+Resampler::Resampler()
+{
+    reset();
+}
+
+void Resampler::reset()
+{
+    // Silence before the first frame, so that the output starts with it.
+    m_left.assign(kResamplerTaps / 2 - 1, 0.0f);
+    m_right.assign(kResamplerTaps / 2 - 1, 0.0f);
+    m_position = 0;
+}
+
+void Resampler::setRatio(double ratio)
+{
+    m_step = (uint64_t)std::llround(4294967296.0 / ratio);
+}
+
+void Resampler::process(const int16_t* in, int count, std::vector<int16_t>& out)
+{
+    for (int i = 0; i < count; i += 2) {
+        m_left.push_back(in[i]);
+        m_right.push_back(in[i + 1]);
+    }
+
+    const float* coeffs = resamplerCoefficients();
+    const size_t frames = m_left.size();
+    while ((m_position >> 32) + kResamplerTaps <= frames) {
+        const size_t first = (size_t)(m_position >> 32);
+        const uint32_t fraction = (uint32_t)m_position;
+        const uint32_t phase = fraction >> (32 - kPhaseBits);
+        const float t = (float)(fraction & ((1u << (32 - kPhaseBits)) - 1)) * (1.0f / (1u << (32 - kPhaseBits)));
+
+        float frame[2];
+        resamplerFilter(coeffs + phase * kResamplerTaps, t, &m_left[first], &m_right[first], frame);
+        out.push_back(toSample(frame[0]));
+        out.push_back(toSample(frame[1]));
+        m_position += m_step;
+    }
+
+    // Drop the frames that are behind the next output frame.
+    const size_t used = std::min((size_t)(m_position >> 32), frames);
+    m_left.erase(m_left.begin(), m_left.begin() + used);
+    m_right.erase(m_right.begin(), m_right.begin() + used);
+    m_position -= (uint64_t)used << 32;
+}
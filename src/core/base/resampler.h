@@ -0,0 +1,73 @@
+#ifndef VBAM_CORE_BASE_RESAMPLER_H_
+#define VBAM_CORE_BASE_RESAMPLER_H_
+
+#include <cstdint>
+#include <vector>
+
+// Stereo 16-bit resampler for dynamic rate control.
+//
+// The ratio only ever moves a fraction of a percent away from 1, to keep the
+// sound driver's buffer at its target level while the emulator is paced by
+// something else than the sound, typically the vertical sync. The input goes
+// through a polyphase windowed-sinc filter of kResamplerTaps taps, with the
+// coefficients interpolated between kResamplerPhases phases.
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VBAM_RESAMPLER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VBAM_RESAMPLER_NEON
+#endif
+
+constexpr int kResamplerTaps = 16;
+constexpr int kResamplerPhases = 256;
+
+class Resampler {
+public:
+    Resampler();
+
+    // Forgets the buffered input and the position in it.
+    void reset();
+
+    // Sets the ratio of the output rate to the input rate.
+    void setRatio(double ratio);
+
+    // Resamples `count` interleaved stereo samples, `count` being even, and
+    // appends the result to `out`. The output lags kResamplerTaps / 2 frames
+    // behind the input.
+    void process(const int16_t* in, int count, std::vector<int16_t>& out);
+
+private:
+    // Input frames, one channel after the other, from the oldest one that
+    // is still needed.
+    std::vector<float> m_left;
+    std::vector<float> m_right;
+    // Position of the next output frame in the input, in 32.32 fixed point.
+    uint64_t m_position = 0;
+    uint64_t m_step = 1ull << 32;
+};
+
+// Filters a frame: the coefficients of the phases `coeffs` and `coeffs` +
+// kResamplerTaps are mixed with `t` in [0, 1), and applied to kResamplerTaps
+// frames of `left` and `right`. The results go to `out[0]` and `out[1]`.
+typedef void (*ResamplerFilterFunc)(const float* coeffs, float t, const float* left, const float* right, float* out);
+
+// Plain C++ filter, the reference for the vector kernels.
+void resamplerFilterScalar(const float* coeffs, float t, const float* left, const float* right, float* out);
+
+// Returns the vector kernel supported by the host CPU, or null if there is
+// none.
+ResamplerFilterFunc resamplerKernel();
+
+// The kResamplerPhases + 1 phases of the filter, kResamplerTaps coefficients
+// each. The last phase is the first one shifted by a frame.
+const float* resamplerCoefficients();
+
+#if defined(VBAM_RESAMPLER_SSE2)
+void resamplerFilterSse2(const float* coeffs, float t, const float* left, const float* right, float* out);
+#endif
+#if defined(VBAM_RESAMPLER_NEON)
+void resamplerFilterNeon(const float* coeffs, float t, const float* left, const float* right, float* out);
+#endif
+
+#endif  // VBAM_CORE_BASE_RESAMPLER_H_
@@ -0,0 +1,75 @@
+#include "core/base/ringbuffer.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(SpscRingBufferTest, WrapsAround)
+{
+    SpscRingBuffer<uint16_t> ring(5);
+    EXPECT_EQ(ring.size(), 5u);
+    EXPECT_EQ(ring.avail(), 5u);
+
+    const uint16_t in[] = { 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(ring.write(in, 4), 4u);
+    EXPECT_EQ(ring.used(), 4u);
+
+    uint16_t out[6] = {};
+    EXPECT_EQ(ring.read(out, 3), 3u);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[2], 3);
+
+    // Only 4 of the 6 values fit, past the end of the storage.
+    EXPECT_EQ(ring.write(in, 6), 4u);
+    EXPECT_EQ(ring.avail(), 0u);
+    EXPECT_EQ(ring.read(out, 6), 5u);
+    const uint16_t expected[] = { 4, 1, 2, 3, 4 };
+    for (int i = 0; i < 5; i++)
+        EXPECT_EQ(out[i], expected[i]) << "value " << i;
+    EXPECT_EQ(ring.used(), 0u);
+}
+
+TEST(SpscRingBufferTest, EmptyRing)
+{
+    SpscRingBuffer<uint16_t> ring;
+    uint16_t value = 1;
+    EXPECT_EQ(ring.write(&value, 1), 0u);
+    EXPECT_EQ(ring.read(&value, 1), 0u);
+    EXPECT_EQ(ring.used(), 0u);
+}
+
+TEST(SpscRingBufferTest, KeepsOrderAcrossThreads)
+{
+    SpscRingBuffer<uint32_t> ring(97);
+    const uint32_t count = 50000;
+
+    std::thread producer([&ring, count]() {
+        uint32_t next = 0;
+        while (next < count) {
+            uint32_t block[13];
+            const uint32_t n = std::min<uint32_t>(13, count - next);
+            for (uint32_t i = 0; i < n; i++)
+                block[i] = next + i;
+            next += ring.write(block, n);
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        uint32_t block[17];
+        const size_t n = ring.read(block, 17);
+        for (size_t i = 0; i < n; i++)
+            ordered &= block[i] == expected++;
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(ring.used(), 0u);
+}
+
+}  // namespace
@@ -2,6 +2,7 @@
 #define VBAM_CORE_BASE_RINGBUFFER_H_
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <cstddef>
 
@@ -92,4 +93,107 @@ template <typename T> class RingBuffer
   }
 };
 
+// Lock-free variant of RingBuffer for one producer thread and one consumer
+// thread, typically the emulator writing samples and an audio callback
+// pulling them. write() and avail() belong to the producer, read() to the
+// consumer, used() and size() can be called from either. reset() and clear()
+// must not run concurrently with anything else.
+template <typename T> class SpscRingBuffer
+{
+  public:
+  typedef T value_type;
+  typedef size_t size_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+
+  private:
+  Array<T> m_buffer;
+  size_type m_size;
+  // Write and read positions, modulo twice the size so that a full buffer
+  // can be told from an empty one. Each is only stored by its own side.
+  std::atomic<size_type> m_pos_write, m_pos_read;
+
+  size_type distance(size_type from, size_type to) const
+  {
+    return(to >= from ? to - from : to + 2 * this->m_size - from);
+  }
+
+  size_type advance(size_type pos, size_type amount) const
+  {
+    pos += amount;
+    return(pos >= 2 * this->m_size ? pos - 2 * this->m_size : pos);
+  }
+
+  size_type index(size_type pos) const
+  {
+    return(pos >= this->m_size ? pos - this->m_size : pos);
+  }
+
+  public:
+  SpscRingBuffer(size_type size = 0) : m_size(0), m_pos_write(0), m_pos_read(0)
+  {
+    this->reset(size);
+  }
+
+  void reset(size_type size)
+  {
+    this->m_size = size;
+    this->m_buffer.reset(size);
+    this->clear();
+  }
+
+  size_type size() const
+  {
+    return(this->m_size);
+  }
+
+  void clear()
+  {
+    this->m_pos_write.store(0, std::memory_order_relaxed);
+    this->m_pos_read.store(0, std::memory_order_relaxed);
+  }
+
+  size_type used() const
+  {
+    const size_type read = this->m_pos_read.load(std::memory_order_acquire);
+    return(this->distance(read, this->m_pos_write.load(std::memory_order_acquire)));
+  }
+
+  size_type avail() const
+  {
+    return(this->m_size - this->used());
+  }
+
+  // Reads up to `size` values, returns how many were read.
+  size_type read(pointer buffer, size_type size)
+  {
+    const size_type read = this->m_pos_read.load(std::memory_order_relaxed);
+    size = std::min(size, this->distance(read, this->m_pos_write.load(std::memory_order_acquire)));
+
+    const size_type pos = this->index(read);
+    const size_type amount = std::min(size, this->m_size - pos);
+    std::copy(this->m_buffer+pos, this->m_buffer+pos+amount, buffer);
+    std::copy(this->m_buffer+0, this->m_buffer+(size-amount), buffer+amount);
+
+    this->m_pos_read.store(this->advance(read, size), std::memory_order_release);
+    return(size);
+  }
+
+  // Writes up to `size` values, returns how many fit.
+  size_type write(const_pointer buffer, size_type size)
+  {
+    const size_type written = this->m_pos_write.load(std::memory_order_relaxed);
+    const size_type used = this->distance(this->m_pos_read.load(std::memory_order_acquire), written);
+    size = std::min(size, this->m_size - used);
+
+    const size_type pos = this->index(written);
+    const size_type amount = std::min(size, this->m_size - pos);
+    std::copy(buffer, buffer+amount, this->m_buffer+pos);
+    std::copy(buffer+amount, buffer+size, this->m_buffer+0);
+
+    this->m_pos_write.store(this->advance(written, size), std::memory_order_release);
+    return(size);
+  }
+};
+
 #endif  // VBAM_CORE_BASE_RINGBUFFER_H_
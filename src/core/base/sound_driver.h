@@ -20,6 +20,10 @@
 
 #include <cstdint>
 
+// Size of the buffer of the drivers that report their level. Rate control
+// keeps it half full, for a latency of about 25 ms.
+static constexpr double kSoundDriverBufferSeconds = 0.050;
+
 // Sound driver abstract interface for the core to use to output sound.
 // Subclass this to implement a new sound driver.
 class SoundDriver {
@@ -43,6 +47,12 @@ public:
     virtual void write(uint16_t* finalWave, int length) = 0;
 
     virtual void setThrottle(unsigned short throttle) = 0;
+
+    // Returns how full the output buffer is, from 0 (empty) to 1 (full), or a
+    // negative value if the driver can't tell. The drivers that can tell
+    // always get the dynamic rate control, their write() must drop what does
+    // not fit rather than wait for room.
+    virtual double bufferLevel() { return -1.0; }
 };
 
 #endif  // VBAM_CORE_BASE_SOUND_DRIVER_H_
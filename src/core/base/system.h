@@ -6,6 +6,15 @@
 
 #include "core/base/sound_driver.h"
 
+// Storage class for the emulated machine state. With ENABLE_REENTRANT_CORE
+// every thread gets its own copy of it, so an embedder can run one core per
+// thread in the same process.
+#ifdef VBAM_ENABLE_REENTRANT_CORE
+#define VBAM_THREAD_LOCAL thread_local
+#else
+#define VBAM_THREAD_LOCAL
+#endif
+
 enum IMAGE_TYPE {
     IMAGE_UNKNOWN = -1,
     IMAGE_GBA = 0, 
@@ -57,6 +66,7 @@ extern struct CoreOptions {
     bool skipBios = false;
     bool parseDebug = true;
     bool speedHack = false;
+    bool skipIdleLoops = false;
     bool speedup = false;
     bool speedup_throttle_frame_skip = false;
     bool speedup_mute = true;
@@ -9,6 +9,7 @@
 
 #include "core/base/check.h"
 #include "core/base/file_util.h"
+#include "core/base/line_writer.h"
 #include "core/base/message.h"
 #include "core/base/sizes.h"
 #include "core/base/system.h"
@@ -18,6 +19,7 @@
 #include "core/gb/gbMemory.h"
 #include "core/gb/gbSGB.h"
 #include "core/gb/gbSound.h"
+#include "core/gba/gbaCore.h"
 #include "core/gba/gbaSound.h"
 
 #if !defined(NO_LINK)
@@ -33,8 +35,6 @@
 #define _stricmp strcasecmp
 #endif
 
-extern uint8_t* g_pix;
-
 namespace {
 
 // Mapper functions.
@@ -43,6 +43,13 @@ void (*g_mapperRAM)(uint16_t, uint8_t) = nullptr;
 uint8_t (*g_mapperReadRAM)(uint16_t) = nullptr;
 void (*g_mapperUpdateClock)() = nullptr;
 
+// Memory access handlers for each 4KB page, set for the mapper by
+// gbUpdateMemoryHandlers(). Pages without one are read or written through
+// gbMemoryMap.
+uint8_t (*g_readHandlers[0x10])(uint16_t) = {};
+void (*g_writeHandlers[0x10])(uint16_t, uint8_t) = {};
+void gbUpdateMemoryHandlers();
+
 // Set to true on battery load error.
 bool g_gbBatteryError = false;
 
@@ -416,6 +423,7 @@ bool gbInitializeRom(size_t romSize) {
                           N_("Unknown cartridge type"));
             return false;
     }
+    gbUpdateMemoryHandlers();
 
     // We need to explicitly reset gbRam here as the patch application process
     // may have changed the RAM size.
@@ -1256,11 +1264,31 @@ bool gbIsGameboyRom(char* file)
 
 void gbCopyMemory(uint16_t d, uint16_t s, int count)
 {
+    // Copies the parts of the range within a source and a destination page
+    // at once. Overlapping parts are copied a byte at a time, forwards, like
+    // the DMA does.
     while (count) {
-        gbMemoryMap[d >> 12][d & 0x0fff] = gbMemoryMap[s >> 12][s & 0x0fff];
-        s++;
-        d++;
-        count--;
+        int length = count;
+        if (length > 0x1000 - (d & 0x0fff))
+            length = 0x1000 - (d & 0x0fff);
+        if (length > 0x1000 - (s & 0x0fff))
+            length = 0x1000 - (s & 0x0fff);
+
+        uint8_t* dest = &gbMemoryMap[d >> 12][d & 0x0fff];
+        const uint8_t* source = &gbMemoryMap[s >> 12][s & 0x0fff];
+        if ((d & 0xe000) == 0x8000)
+            gbTileCacheInvalidate(d, length);
+
+        if ((uintptr_t)dest > (uintptr_t)source && (uintptr_t)dest < (uintptr_t)(source + length)) {
+            for (int i = 0; i < length; i++)
+                dest[i] = source[i];
+        } else {
+            memmove(dest, source, length);
+        }
+
+        s += length;
+        d += length;
+        count -= length;
     }
 }
 
@@ -1325,53 +1353,59 @@ void gbCompareLYToLYC()
     }
 }
 
-void gbWriteMemory(uint16_t address, uint8_t value)
-{
+// Memory access handlers, one per 4KB page. See gbUpdateMemoryHandlers().
 
-    if (address < 0x8000) {
+static void gbWriteRom(uint16_t address, uint8_t value)
+{
 #ifndef FINAL_VERSION
-        if (memorydebug && (address > 0x3fff || address < 0x2000)) {
-            log("Memory register write %04x=%02x PC=%04x\n",
-                address,
-                value,
-                PC.W);
-        }
-
-#endif
-        if (g_mapper)
-            (*g_mapper)(address, value);
-        return;
+    if (memorydebug && (address > 0x3fff || address < 0x2000)) {
+        log("Memory register write %04x=%02x PC=%04x\n",
+            address,
+            value,
+            PC.W);
     }
 
-    if (address < 0xa000) {
+#endif
+    if (g_mapper)
+        (*g_mapper)(address, value);
+}
 
-        if (gbVramWriteAccessValid())
-            gbMemoryMap[address >> 12][address & 0x0fff] = value;
-        return;
+static void gbWriteVram(uint16_t address, uint8_t value)
+{
+    if (gbVramWriteAccessValid()) {
+        gbTileCacheInvalidate(address);
+        gbMemoryMap[address >> 12][address & 0x0fff] = value;
     }
+}
 
-    // Used for the mirroring of 0xC000 in 0xE000
-    if ((address >= 0xe000) && (address < 0xfe00))
-        address &= ~0x2000;
-
-    if (address < 0xc000) {
+static void gbWriteCartRam(uint16_t address, uint8_t value)
+{
 #ifndef FINAL_VERSION
-        if (memorydebug) {
-            log("Memory register write %04x=%02x PC=%04x\n",
-                address,
-                value,
-                PC.W);
-        }
+    if (memorydebug) {
+        log("Memory register write %04x=%02x PC=%04x\n",
+            address,
+            value,
+            PC.W);
+    }
 #endif
 
-        // Is that a correct fix ??? (it used to be 'if (g_mapper)')...
-        if (g_mapperRAM)
-            (*g_mapperRAM)(address, value);
-        return;
-    }
+    // Is that a correct fix ??? (it used to be 'if (g_mapper)')...
+    if (g_mapperRAM)
+        (*g_mapperRAM)(address, value);
+}
 
+// Used for the mirroring of 0xC000 in 0xE000
+static void gbWriteEcho(uint16_t address, uint8_t value)
+{
+    address &= ~0x2000;
+    gbMemoryMap[address >> 12][address & 0x0fff] = value;
+}
+
+// 0xF000 to 0xFFFF: the end of the mirror, OAM and the IO registers.
+static void gbWriteHigh(uint16_t address, uint8_t value)
+{
     if (address < 0xfe00) {
-        gbMemoryMap[address >> 12][address & 0x0fff] = value;
+        gbWriteEcho(address, value);
         return;
     }
 
@@ -1614,7 +1648,7 @@ void gbWriteMemory(uint16_t address, uint8_t value)
     case 0x3e:
     case 0x3f:
         // Sound registers handled by blargg
-        gbSoundEvent(soundTicks, address, value);
+        gbSoundEvent(gbaCore.soundTicks, address, value);
         //gbMemory[address] = value;
         return;
 
@@ -2048,6 +2082,7 @@ void gbWriteMemory(uint16_t address, uint8_t value)
             if (gbCgbPaletteAccessValid()) {
                 gbMemory[0xff69] = value;
                 gbPalette[paletteIndex] = (paletteHiLo ? ((value << 8) | (gbPalette[paletteIndex] & 0xff)) : ((gbPalette[paletteIndex] & 0xff00) | (value))) & 0x7fff;
+                gbPaletteCacheUpdate(paletteIndex);
             }
 
             if (gbMemory[0xff68] & 0x80) {
@@ -2088,6 +2123,7 @@ void gbWriteMemory(uint16_t address, uint8_t value)
             if (gbCgbPaletteAccessValid()) {
                 gbMemory[0xff6b] = value;
                 gbPalette[paletteIndex] = (paletteHiLo ? ((value << 8) | (gbPalette[paletteIndex] & 0xff)) : ((gbPalette[paletteIndex] & 0xff00) | (value))) & 0x7fff;
+                gbPaletteCacheUpdate(paletteIndex);
             }
 
             if (gbMemory[0xff6a] & 0x80) {
@@ -2146,44 +2182,45 @@ void gbWriteMemory(uint16_t address, uint8_t value)
     gbMemory[address] = value;
 }
 
-uint8_t gbReadMemory(uint16_t address)
+static uint8_t gbReadVram(uint16_t address)
 {
-    if (gbCheatMap[address])
-        return gbCheatRead(address);
-
-    if (address < 0x8000)
+    if (gbVramReadAccessValid())
         return gbMemoryMap[address >> 12][address & 0x0fff];
+    return 0xff;
+}
 
-    if (address < 0xa000) {
-        if (gbVramReadAccessValid())
-            return gbMemoryMap[address >> 12][address & 0x0fff];
-        return 0xff;
-    }
-
-    // Used for the mirroring of 0xC000 in 0xE000
-    if ((address >= 0xe000) && (address < 0xfe00))
-        address &= ~0x2000;
-
-    if (address < 0xc000) {
+static uint8_t gbReadCartRam(uint16_t address)
+{
 #ifndef FINAL_VERSION
-        if (memorydebug) {
-            log("Memory register read %04x PC=%04x\n",
-                address,
-                PC.W);
-        }
+    if (memorydebug) {
+        log("Memory register read %04x PC=%04x\n",
+            address,
+            PC.W);
+    }
 #endif
 
-        // for the 2kb ram limit (fixes crash in shawu's story
-        // but now its sram test fails, as the it expects 8kb and not 2kb...
-        // So use the 'genericflashcard' option to fix it).
-        if (address <= (0xa000 + g_gbCartData.ram_mask())) {
-            if (g_mapperReadRAM) {
-                return g_mapperReadRAM(address);
-            }
-            return gbMemoryMap[address >> 12][address & 0x0fff];
+    // for the 2kb ram limit (fixes crash in shawu's story
+    // but now its sram test fails, as the it expects 8kb and not 2kb...
+    // So use the 'genericflashcard' option to fix it).
+    if (address <= (0xa000 + g_gbCartData.ram_mask())) {
+        if (g_mapperReadRAM) {
+            return g_mapperReadRAM(address);
         }
-        return 0xff;
+        return gbMemoryMap[address >> 12][address & 0x0fff];
     }
+    return 0xff;
+}
+
+static uint8_t gbReadEcho(uint16_t address)
+{
+    address &= ~0x2000;
+    return gbMemoryMap[address >> 12][address & 0x0fff];
+}
+
+static uint8_t gbReadHigh(uint16_t address)
+{
+    if (address < 0xfe00)
+        return gbReadEcho(address);
 
     if (address >= 0xff00) {
         switch (address & 0x00ff) {
@@ -2350,7 +2387,7 @@ uint8_t gbReadMemory(uint16_t address)
         case 0x3e:
         case 0x3f:
             // Sound registers read
-            return gbSoundRead(soundTicks, address);
+            return gbSoundRead(gbaCore.soundTicks, address);
         case 0x40:
             return register_LCDC;
         case 0x41:
@@ -2432,6 +2469,70 @@ uint8_t gbReadMemory(uint16_t address)
     return gbMemoryMap[address >> 12][address & 0x0fff];
 }
 
+namespace {
+
+void gbUpdateMemoryHandlers()
+{
+    for (int page = 0x0; page < 0x8; page++) {
+        g_readHandlers[page] = nullptr;
+        g_writeHandlers[page] = gbWriteRom;
+    }
+    g_readHandlers[0x8] = g_readHandlers[0x9] = gbReadVram;
+    g_writeHandlers[0x8] = g_writeHandlers[0x9] = gbWriteVram;
+    g_readHandlers[0xa] = g_readHandlers[0xb] = gbReadCartRam;
+    g_writeHandlers[0xa] = g_writeHandlers[0xb] = gbWriteCartRam;
+    g_readHandlers[0xc] = g_readHandlers[0xd] = nullptr;
+    g_writeHandlers[0xc] = g_writeHandlers[0xd] = nullptr;
+    g_readHandlers[0xe] = gbReadEcho;
+    g_writeHandlers[0xe] = gbWriteEcho;
+    g_readHandlers[0xf] = gbReadHigh;
+    g_writeHandlers[0xf] = gbWriteHigh;
+
+#ifdef FINAL_VERSION
+    // Without the memory debug logs, the mapper handles its writes itself.
+    if (g_mapper) {
+        for (int page = 0x0; page < 0x8; page++)
+            g_writeHandlers[page] = g_mapper;
+    }
+    if (g_mapperRAM)
+        g_writeHandlers[0xa] = g_writeHandlers[0xb] = g_mapperRAM;
+#endif
+}
+
+}  // namespace
+
+void gbWriteMemory(uint16_t address, uint8_t value)
+{
+    const auto handler = g_writeHandlers[address >> 12];
+    if (handler) {
+        handler(address, value);
+        return;
+    }
+    gbMemoryMap[address >> 12][address & 0x0fff] = value;
+}
+
+uint8_t gbReadMemory(uint16_t address)
+{
+    if (gbCheatPageMap[address >> 12] && gbCheatMap[address])
+        return gbCheatRead(address);
+
+    const auto handler = g_readHandlers[address >> 12];
+    if (handler)
+        return handler(address);
+    return gbMemoryMap[address >> 12][address & 0x0fff];
+}
+
+// Opcode and operand fetch. Code runs from ROM, WRAM and HRAM, whose reads
+// have no side effect and go straight through gbMemoryMap, unless a cheat
+// patches their page. Anything else takes gbReadMemory().
+static inline uint8_t gbReadOpcode(uint16_t address)
+{
+    if (!gbCheatPageMap[address >> 12] &&
+        (address < 0x8000 || (address >= 0xc000 && address < 0xe000) || (address >= 0xff80 && address < 0xffff)))
+        return gbMemoryMap[address >> 12][address & 0x0fff];
+    return gbReadMemory(address);
+}
+
 void gbVblank_interrupt()
 {
     gbCheatWrite(false); // Emulates GS codes.
@@ -2563,7 +2664,7 @@ void gbCPUInit(const char* biosFileName, bool useBiosFile)
         int size = expectedSize;
         if (utilLoad(biosFileName,
                 CPUIsGBBios,
-                g_bios,
+                gbaCore.g_bios,
                 size)) {
             if (size == expectedSize)
                 coreOptions.useBios = true;
@@ -2766,13 +2867,16 @@ void gbReset()
         memset(gbLineBuffer, 0, kGBLineBufferSize);
     }
     // clean Pix
-    if (g_pix != nullptr) {
-        memset(g_pix, 0, kGBPixSize);
+    if (gbaCore.g_pix != nullptr) {
+        memset(gbaCore.g_pix, 0, kGBPixSize);
+        lineWriterInvalidate(gbaCore.g_lineWriterHashes);
     }
     // clean Vram
     if (gbVram != nullptr) {
         memset(gbVram, 0, kGBVRamSize);
     }
+    gbTileCacheFlush();
+    gbPaletteCacheFlush();
     // clean Wram 2
     // This kinda emulates the startup state of Wram on GBC (not very accurate,
     // but way closer to the reality than filling it with 00es or FFes).
@@ -2942,12 +3046,12 @@ void gbReset()
     }
 
     // used for the handling of the gb Boot Rom
-    if ((gbHardware & 7) && (g_bios != NULL) && coreOptions.useBios && !coreOptions.skipBios) {
+    if ((gbHardware & 7) && (gbaCore.g_bios != NULL) && coreOptions.useBios && !coreOptions.skipBios) {
         if (gbHardware & 5) {
             memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbRom), 0x1000);
-            memcpy((uint8_t*)(gbMemory), (uint8_t*)(g_bios), kGBBiosSize);
+            memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbaCore.g_bios), kGBBiosSize);
         } else {
-            memcpy((uint8_t*)(gbMemory), (uint8_t*)(g_bios), kCGBBiosSize);
+            memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbaCore.g_bios), kCGBBiosSize);
             memcpy((uint8_t*)(gbMemory + 0x100), (uint8_t*)(gbRom + 0x100), 0x100);
         }
         gbWhiteScreen = 0;
@@ -3475,9 +3579,10 @@ static bool gbReadSaveState(gzFile gzFile)
     }
 
     if (version < GBSAVE_GAME_VERSION_5) {
-        utilGzRead(gzFile, g_pix, 256 * 224 * sizeof(uint16_t));
+        utilGzRead(gzFile, gbaCore.g_pix, 256 * 224 * sizeof(uint16_t));
     }
-    memset(g_pix, 0, kGBPixSize);
+    memset(gbaCore.g_pix, 0, kGBPixSize);
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
 
     if (version < GBSAVE_GAME_VERSION_6) {
         utilGzRead(gzFile, gbPalette, 64 * sizeof(uint16_t));
@@ -3527,9 +3632,9 @@ static bool gbReadSaveState(gzFile gzFile)
         gbMemoryMap[0x00] = &gbMemory[0x0000];
         if (gbHardware & 5) {
             memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbRom), 0x1000);
-            memcpy((uint8_t*)(gbMemory), (uint8_t*)(g_bios), kGBBiosSize);
+            memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbaCore.g_bios), kGBBiosSize);
         } else if (gbHardware & 2) {
-            memcpy((uint8_t*)(gbMemory), (uint8_t*)(g_bios), kCGBBiosSize);
+            memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbaCore.g_bios), kCGBBiosSize);
             memcpy((uint8_t*)(gbMemory + 0x100), (uint8_t*)(gbRom + 0x100), 0x100);
         }
 
@@ -3604,6 +3709,9 @@ static bool gbReadSaveState(gzFile gzFile)
         gbMemoryMap[0x0d] = &gbWram[value * 0x1000];
     }
 
+    gbTileCacheFlush();
+    gbPaletteCacheFlush();
+
     gbSoundReadGame(version, gzFile);
 
     if (gbCgbMode && gbSgbMode) {
@@ -3738,15 +3846,15 @@ bool gbReadSaveState(const char* name)
 bool gbWritePNGFile(const char* fileName)
 {
     if (gbBorderOn)
-        return utilWritePNGFile(fileName, kSGBWidth, kSGBHeight, g_pix);
-    return utilWritePNGFile(fileName, kGBWidth, kGBHeight, g_pix);
+        return utilWritePNGFile(fileName, kSGBWidth, kSGBHeight, gbaCore.g_pix);
+    return utilWritePNGFile(fileName, kGBWidth, kGBHeight, gbaCore.g_pix);
 }
 
 bool gbWriteBMPFile(const char* fileName)
 {
     if (gbBorderOn)
-        return utilWriteBMPFile(fileName, kSGBWidth, kSGBHeight, g_pix);
-    return utilWriteBMPFile(fileName, kGBWidth, kGBHeight, g_pix);
+        return utilWriteBMPFile(fileName, kSGBWidth, kSGBHeight, gbaCore.g_pix);
+    return utilWriteBMPFile(fileName, kGBWidth, kGBHeight, gbaCore.g_pix);
 }
 #endif // !__LIBRETRO__
 
@@ -3762,9 +3870,9 @@ void gbCleanUp()
         gbRom = nullptr;
     }
 
-    if (g_bios != nullptr) {
-        free(g_bios);
-        g_bios = nullptr;
+    if (gbaCore.g_bios != nullptr) {
+        free(gbaCore.g_bios);
+        gbaCore.g_bios = nullptr;
     }
 
     if (gbMemory != nullptr) {
@@ -3777,9 +3885,9 @@ void gbCleanUp()
         gbLineBuffer = nullptr;
     }
 
-    if (g_pix != nullptr) {
-        free(g_pix);
-        g_pix = nullptr;
+    if (gbaCore.g_pix != nullptr) {
+        free(gbaCore.g_pix);
+        gbaCore.g_pix = nullptr;
     }
 
     gbSgbShutdown();
@@ -3804,6 +3912,7 @@ void gbCleanUp()
     g_mapperRAM = nullptr;
     g_mapperReadRAM = nullptr;
     g_mapperUpdateClock = nullptr;
+    gbUpdateMemoryHandlers();
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 
 #if !defined(__LIBRETRO__)
@@ -3826,12 +3935,12 @@ bool gbLoadRom(const char* filename) {
 
     g_gbBatteryError = false;
 
-    if (g_bios != nullptr) {
-        free(g_bios);
-        g_bios = nullptr;
+    if (gbaCore.g_bios != nullptr) {
+        free(gbaCore.g_bios);
+        gbaCore.g_bios = nullptr;
     }
-    g_bios = (uint8_t*)calloc(1, kGBBiosBufferSize);
-    if (g_bios == nullptr) {
+    gbaCore.g_bios = (uint8_t*)calloc(1, kGBBiosBufferSize);
+    if (gbaCore.g_bios == nullptr) {
         return false;
     }
 
@@ -3840,8 +3949,8 @@ bool gbLoadRom(const char* filename) {
         return false;
     }
 
-    g_pix = (uint8_t*)calloc(1, kGBPixSize);
-    if (g_pix == nullptr) {
+    gbaCore.g_pix = (uint8_t*)calloc(1, kGBPixSize);
+    if (gbaCore.g_pix == nullptr) {
         return false;
     }
 
@@ -3886,150 +3995,42 @@ int gbGetNextEvent(int _clockTicks)
 
 void gbDrawLine()
 {
-    switch (systemColorDepth) {
-    case 8: {
-#ifdef __LIBRETRO__
-        uint8_t* dest = (uint8_t*)g_pix + gbBorderLineSkip * (register_LY + gbBorderRowSkip)
-            + gbBorderColumnSkip;
-#else
-        uint8_t* dest = (uint8_t*)g_pix + (gbBorderLineSkip + 2) * (register_LY + gbBorderRowSkip + 1)
-            + gbBorderColumnSkip;
-#endif
-        for (size_t x = 0; x < kGBWidth;) {
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-            *dest++ = systemColorMap8[gbLineMix[x++]];
-        }
-        if (gbBorderOn)
-            dest += gbBorderColumnSkip;
-#ifndef __LIBRETRO__
-        *dest++ = 0; // for filters that read one pixel more
-#endif
-    } break;
-    case 16: {
-#ifdef __LIBRETRO__
-        uint16_t* dest = (uint16_t*)g_pix + gbBorderLineSkip * (register_LY + gbBorderRowSkip)
-            + gbBorderColumnSkip;
-#else
-        uint16_t* dest = (uint16_t*)g_pix + (gbBorderLineSkip + 2) * (register_LY + gbBorderRowSkip + 1)
-            + gbBorderColumnSkip;
-#endif
-        for (size_t x = 0; x < kGBWidth;) {
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-            *dest++ = systemColorMap16[gbLineMix[x++]];
-        }
-        if (gbBorderOn)
-            dest += gbBorderColumnSkip;
+    if (register_LY == 0)
+        gbPaletteCacheFlush();
+
+    // Palette pixels come from gbPaletteCache, the few others are converted
+    // from their 15-bit color.
+    uint32_t pixels[kGBWidth];
+    for (size_t x = 0; x < kGBWidth; x++) {
+        const uint16_t color = gbLineMix[x];
+        if (color & kGbLinePalette)
+            pixels[x] = gbPaletteCache[color & 0x7f];
+        else
+            pixels[x] = lineWriterConvertColor(color);
+    }
+
+    // Outside libretro the frame buffer starts with a blank line, and the
+    // lines have extra pixels for the filters that read past the screen.
+    int pitch = gbBorderLineSkip;
+    int top = register_LY + gbBorderRowSkip;
 #ifndef __LIBRETRO__
-        *dest++ = 0; // for filters that read one pixel more
+    if (systemColorDepth != 24) {
+        pitch += systemColorDepth == 32 ? 1 : 2;
+        top++;
+    }
 #endif
-    } break;
+    uint8_t* dest = gbaCore.g_pix + (pitch * top + gbBorderColumnSkip) * (systemColorDepth >> 3);
+    lineWriterStore(pixels, kGBWidth, dest);
+    lineWriterHash(gbaCore.g_lineWriterHashes, top, dest, kGBWidth * (systemColorDepth >> 3));
 
-    case 24: {
-        uint8_t* dest = (uint8_t*)g_pix + 3 * (gbBorderLineSkip * (register_LY + gbBorderRowSkip) + gbBorderColumnSkip);
-        for (size_t x = 0; x < kGBWidth;) {
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-            *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
-            dest += 3;
-        }
-    } break;
-
-    case 32: {
-#ifdef __LIBRETRO__
-        uint32_t* dest = (uint32_t*)g_pix + gbBorderLineSkip * (register_LY + gbBorderRowSkip)
-            + gbBorderColumnSkip;
-#else
-        uint32_t* dest = (uint32_t*)g_pix + (gbBorderLineSkip + 1) * (register_LY + gbBorderRowSkip + 1)
-            + gbBorderColumnSkip;
+#ifndef __LIBRETRO__
+    // for filters that read one pixel more
+    const int end = kGBWidth + (gbBorderOn ? gbBorderColumnSkip : 0);
+    if (systemColorDepth == 8)
+        dest[end] = 0;
+    else if (systemColorDepth == 16)
+        ((uint16_t*)dest)[end] = 0;
 #endif
-        for (size_t x = 0; x < kGBWidth;) {
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-            *dest++ = systemColorMap32[gbLineMix[x++]];
-        }
-    } break;
-    }
 }
 
 static void gbUpdateJoypads() {
@@ -4113,7 +4114,7 @@ void gbEmulate(int ticksToStop)
             opcode2 = 0;
             execute = true;
 
-            opcode2 = opcode1 = opcode = gbReadMemory(PC.W++);
+            opcode2 = opcode1 = opcode = gbReadOpcode(PC.W++);
 
             // If HALT state was launched while IME = 0 and (register_IF & register_IE & 0x1F),
             // PC.W is not incremented for the first byte of the next instruction.
@@ -4127,7 +4128,7 @@ void gbEmulate(int ticksToStop)
             switch (opcode) {
             case 0xCB:
                 // extended opcode
-                opcode2 = opcode = gbReadMemory(PC.W++);
+                opcode2 = opcode = gbReadOpcode(PC.W++);
                 clockTicks = gbCyclesCB[opcode];
                 break;
             }
@@ -4185,8 +4186,8 @@ void gbEmulate(int ticksToStop)
         }
 
         ticksToStop -= clockTicks;
-        soundTicks += clockTicks;
-         if (!gbSpeed) soundTicks += clockTicks;
+        gbaCore.soundTicks += clockTicks;
+         if (!gbSpeed) gbaCore.soundTicks += clockTicks;
 
         // DIV register emulation
         gbDivTicks -= clockTicks;
@@ -4396,6 +4397,7 @@ void gbEmulate(int ticksToStop)
                     bool turbo_button_pressed        = (gbJoymask[0] >> 10) & 1;
 #ifndef __LIBRETRO__
                     static uint32_t last_throttle;
+                    static bool speedup_silenced = false;
 
                     if (turbo_button_pressed) {
                         if (coreOptions.speedup_frame_skip)
@@ -4410,10 +4412,22 @@ void gbEmulate(int ticksToStop)
                             if (coreOptions.speedup_throttle_frame_skip)
                                 framesToSkip += std::ceil(double(coreOptions.speedup_throttle) / 100.0) - 1;
                         }
+
+                        if (coreOptions.speedup_mute && !speedup_silenced) {
+                            soundSetSilent(true);
+                            speedup_silenced = true;
+                        }
                     }
-                    else if (speedup_throttle_set) {
-                        soundSetThrottle(last_throttle);
-                        speedup_throttle_set = false;
+                    else {
+                        if (speedup_silenced) {
+                            soundSetSilent(false);
+                            speedup_silenced = false;
+                        }
+
+                        if (speedup_throttle_set) {
+                            soundSetThrottle(last_throttle);
+                            speedup_throttle_set = false;
+                        }
                     }
 #else
                     if (turbo_button_pressed)
@@ -4453,7 +4467,7 @@ void gbEmulate(int ticksToStop)
 
                             gbFrameCount++;
                             systemFrame();
-                            gbSoundTick(soundTicks);
+                            gbSoundTick(gbaCore.soundTicks);
 
                             if ((gbFrameCount % 10) == 0)
                                 system10Frames();
@@ -4661,7 +4675,7 @@ void gbEmulate(int ticksToStop)
                         gbFrameCount++;
 
                         systemFrame();
-                        gbSoundTick(soundTicks);
+                        gbSoundTick(gbaCore.soundTicks);
 
                         if ((gbFrameCount % 10) == 0)
                             system10Frames();
@@ -4797,10 +4811,10 @@ void gbEmulate(int ticksToStop)
         // On VBA-M (gb core running twice as fast?), each vblank is uses 35112 cycles.
         // on some cases no vblank is generated causing sound ticks to keep accumulating causing core to crash.
         // This forces core to flush sound buffers when expected sound ticks has passed and no frame is done yet.which then ends cpuloop
-        if ((soundTicks > SOUND_CLOCK_TICKS) && !frameDone) {
-            int last_st = soundTicks;
-            gbSoundTick(soundTicks);
-            soundTicks = (last_st - SOUND_CLOCK_TICKS);
+        if ((gbaCore.soundTicks > SOUND_CLOCK_TICKS) && !frameDone) {
+            int last_st = gbaCore.soundTicks;
+            gbSoundTick(gbaCore.soundTicks);
+            gbaCore.soundTicks = (last_st - SOUND_CLOCK_TICKS);
         }
 
         // timer emulation
@@ -4948,13 +4962,13 @@ bool gbLoadRomData(const char* data, size_t size) {
 
     g_gbBatteryError = false;
 
-    if (g_bios != nullptr) {
-        free(g_bios);
-        g_bios = nullptr;
+    if (gbaCore.g_bios != nullptr) {
+        free(gbaCore.g_bios);
+        gbaCore.g_bios = nullptr;
     }
 
-    g_bios = (uint8_t*)calloc(1, kGBBiosBufferSize);
-    if (g_bios == nullptr) {
+    gbaCore.g_bios = (uint8_t*)calloc(1, kGBBiosBufferSize);
+    if (gbaCore.g_bios == nullptr) {
         return false;
     }
 
@@ -4963,8 +4977,8 @@ bool gbLoadRomData(const char* data, size_t size) {
         return false;
     }
 
-    g_pix = (uint8_t*)calloc(1, kGBPixSize);
-    if (g_pix == nullptr) {
+    gbaCore.g_pix = (uint8_t*)calloc(1, kGBPixSize);
+    if (gbaCore.g_pix == nullptr) {
         return false;
     }
 
@@ -5174,9 +5188,9 @@ bool gbReadSaveState(const uint8_t* data)
         gbMemoryMap[0x00] = &gbMemory[0x0000];
         if (gbHardware & 5) {
             memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbRom), 0x1000);
-            memcpy((uint8_t*)(gbMemory), (uint8_t*)(g_bios), kGBBiosSize);
+            memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbaCore.g_bios), kGBBiosSize);
         } else if (gbHardware & 2) {
-            memcpy((uint8_t*)(gbMemory), (uint8_t*)(g_bios), kCGBBiosSize);
+            memcpy((uint8_t*)(gbMemory), (uint8_t*)(gbaCore.g_bios), kCGBBiosSize);
             memcpy((uint8_t*)(gbMemory + 0x100), (uint8_t*)(gbRom + 0x100), 0x100);
         }
 
@@ -5253,6 +5267,9 @@ bool gbReadSaveState(const uint8_t* data)
         gbMemoryMap[0x0d] = &gbWram[value * 0x1000];
     }
 
+    gbTileCacheFlush();
+    gbPaletteCacheFlush();
+
     gbSoundReadGame(data);
 
     if (gbCgbMode && gbSgbMode) {
@@ -14,6 +14,7 @@ gbCheat gbCheatList[MAX_CHEATS];
 int gbCheatNumber = 0;
 int gbNextCheat = 0;
 bool gbCheatMap[0x10000];
+bool gbCheatPageMap[0x10];
 
 #define GBCHEAT_IS_HEX(a) (((a) >= 'A' && (a) <= 'F') || ((a) >= '0' && (a) <= '9'))
 #define GBCHEAT_HEX_VALUE(a) ((a) >= 'A' ? (a) - 'A' + 10 : (a) - '0')
@@ -21,10 +22,13 @@ bool gbCheatMap[0x10000];
 void gbCheatUpdateMap()
 {
     memset(gbCheatMap, 0, 0x10000);
+    memset(gbCheatPageMap, 0, sizeof(gbCheatPageMap));
 
     for (int i = 0; i < gbCheatNumber; i++) {
-        if (gbCheatList[i].enabled)
+        if (gbCheatList[i].enabled) {
             gbCheatMap[gbCheatList[i].address] = true;
+            gbCheatPageMap[gbCheatList[i].address >> 12] = true;
+        }
     }
 }
 
@@ -343,6 +347,7 @@ bool gbAddGgCheat(const char* code, const char* desc)
     gbCheatList[i].enabled = true;
 
     gbCheatMap[gbCheatList[i].address] = true;
+    gbCheatPageMap[gbCheatList[i].address >> 12] = true;
 
     gbCheatNumber++;
 
@@ -47,5 +47,7 @@ bool gbVerifyGgCode(const char* code);
 extern int gbCheatNumber;
 extern gbCheat gbCheatList[MAX_CHEATS];
 extern bool gbCheatMap[0x10000];
+// Whether any address of each 4KB page is in gbCheatMap.
+extern bool gbCheatPageMap[0x10];
 
 #endif // VBAM_CORE_GB_GBCHEATS_H_
@@ -45,6 +45,73 @@ uint16_t gbLineMix[160];
 uint16_t gbWindowColor[160];
 extern int inUseRegister_WY;
 
+uint8_t gbTileCache[0x4000 / 16][64];
+uint32_t gbTileDirty[0x4000 / 16 / 32] = {
+    ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+    ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+};
+
+void gbTileCacheFlush()
+{
+    for (int i = 0; i < 0x4000 / 16 / 32; i++)
+        gbTileDirty[i] = ~0u;
+}
+
+uint32_t gbPaletteCache[128];
+
+void gbPaletteCacheUpdate(int index)
+{
+    const uint16_t color = gbColorOption ? gbColorFilter[gbPalette[index] & 0x7FFF] : gbPalette[index] & 0x7FFF;
+    switch (systemColorDepth) {
+    case 8:
+        gbPaletteCache[index] = systemColorMap8[color];
+        break;
+    case 16:
+        gbPaletteCache[index] = systemColorMap16[color];
+        break;
+    default:
+        gbPaletteCache[index] = systemColorMap32[color];
+        break;
+    }
+}
+
+void gbPaletteCacheFlush()
+{
+    for (int i = 0; i < 128; i++)
+        gbPaletteCacheUpdate(i);
+}
+
+static void gbTileCacheDecode(int tile)
+{
+    const uint8_t* source;
+    if (tile & 0x200)
+        source = &gbVram[0x2000 + ((tile & 0x1ff) << 4)];
+    else if (gbCgbMode)
+        source = &gbVram[tile << 4];
+    else
+        source = &gbMemory[0x8000 + (tile << 4)];
+
+    uint8_t* pixels = gbTileCache[tile];
+    for (int row = 0; row < 8; row++) {
+        const uint8_t tile_a = source[row * 2];
+        const uint8_t tile_b = source[row * 2 + 1];
+        // leftmost pixel in bit 7
+        for (int i = 0; i < 8; i++)
+            pixels[row * 8 + i] = ((tile_a >> (7 - i)) & 1) | (((tile_b >> (7 - i)) & 1) << 1);
+    }
+
+    gbTileDirty[tile >> 5] &= ~(1u << (tile & 31));
+}
+
+// Returns the 8 pixels of the tile row at `address` in VRAM `bank`.
+static inline const uint8_t* gbTileRow(int bank, int address)
+{
+    const int tile = (bank << 9) | (address >> 4);
+    if (gbTileDirty[tile >> 5] & (1u << (tile & 31)))
+        gbTileCacheDecode(tile);
+    return &gbTileCache[tile][(address & 0x0e) << 2];
+}
+
 void gbRenderLine()
 {
     memset(gbLineMix, 0, sizeof(gbLineMix));
@@ -84,7 +151,7 @@ void gbRenderLine()
     int tx = sx >> 3;
     int ty = sy >> 3;
 
-    int bx = 1 << (7 - (sx & 7));
+    int px = sx & 7;
     int by = sy & 7;
 
     int tile_map_line_y = tile_map + ty * 32;
@@ -108,29 +175,15 @@ void gbRenderLine()
         if ((register_LCDC & 0x01 || gbCgbMode) && (coreOptions.layerSettings & 0x0100)) {
             while (x < 160) {
 
-                uint8_t tile_a = 0;
-                uint8_t tile_b = 0;
-
                 if (attrs & 0x40) {
                     tile_pattern_address = tile_pattern + tile * 16 + (7 - by) * 2;
                 }
 
-                if (attrs & 0x08) {
-                    tile_a = bank1[tile_pattern_address++];
-                    tile_b = bank1[tile_pattern_address];
-                } else {
-                    tile_a = bank0[tile_pattern_address++];
-                    tile_b = bank0[tile_pattern_address];
-                }
+                const uint8_t* pixels = gbTileRow((attrs & 0x08) ? 1 : 0, tile_pattern_address);
+                const int flip = (attrs & 0x20) ? 7 : 0;
 
-                if (attrs & 0x20) {
-                    tile_a = gbInvertTab[tile_a];
-                    tile_b = gbInvertTab[tile_b];
-                }
-
-                while (bx > 0) {
-                    uint8_t c = (tile_a & bx) ? 1 : 0;
-                    c += ((tile_b & bx) ? 2 : 0);
+                while (px < 8) {
+                    uint8_t c = pixels[px ^ flip];
 
                     gbLineBuffer[x] = c; // mark the gbLineBuffer color
 
@@ -158,14 +211,14 @@ void gbRenderLine()
                             c = c + 4 * palette;
                         }
                     }
-                    gbLineMix[x] = gbColorOption ? gbColorFilter[gbPalette[c] & 0x7FFF] : gbPalette[c] & 0x7FFF;
+                    gbLineMix[x] = kGbLinePalette | c;
                     x++;
                     if (x >= 160)
                         break;
-                    bx >>= 1;
+                    px++;
                 }
 
-                bx = 128;
+                px = 0;
 
                 SpritesTicks = gbSpritesTicks[x] * (gbSpeed ? 2 : 4);
 
@@ -249,18 +302,18 @@ void gbRenderLine()
                     tx = 0;
                     ty = gbWindowLine >> 3;
 
-                    bx = 128;
+                    px = 0;
                     by = gbWindowLine & 7;
 
                     // Tries to emulate the 'window scrolling bug' when wx == 0 (ie. wx-7 == -7).
                     // Nothing close to perfect, but good enought for now...
                     if (wx == -7) {
                         swx = 7 - ((gbSCXLine[0] - 1) & 7);
-                        bx >>= ((gbSCXLine[0] + ((swx != 1) ? 1 : 0)) & 7);
+                        px = (gbSCXLine[0] + ((swx != 1) ? 1 : 0)) & 7;
                         if (swx == 1)
                             swx = 2;
 
-                        //bx >>= ((gbSCXLine[0]+(((swx>1) && (swx != 7)) ? 1 : 0)) & 7);
+                        //px = (gbSCXLine[0]+(((swx>1) && (swx != 7)) ? 1 : 0)) & 7;
 
                         if (swx == 7) {
                             //wx = 0;
@@ -268,7 +321,7 @@ void gbRenderLine()
                                 swx = 0;
                         }
                     } else if (wx < 0) {
-                        bx >>= (-wx);
+                        px = -wx;
                         wx = 0;
                     }
 
@@ -298,29 +351,15 @@ void gbRenderLine()
                             gbLineMix[i] = gbWindowColor[i];
 
                     while (x < 160) {
-                        uint8_t tile_a = 0;
-                        uint8_t tile_b = 0;
-
                         if (attrs & 0x40) {
                             tile_pattern_address = tile_pattern + tile * 16 + (7 - by) * 2;
                         }
 
-                        if (attrs & 0x08) {
-                            tile_a = bank1[tile_pattern_address++];
-                            tile_b = bank1[tile_pattern_address];
-                        } else {
-                            tile_a = bank0[tile_pattern_address++];
-                            tile_b = bank0[tile_pattern_address];
-                        }
-
-                        if (attrs & 0x20) {
-                            tile_a = gbInvertTab[tile_a];
-                            tile_b = gbInvertTab[tile_b];
-                        }
+                        const uint8_t* pixels = gbTileRow((attrs & 0x08) ? 1 : 0, tile_pattern_address);
+                        const int flip = (attrs & 0x20) ? 7 : 0;
 
-                        while (bx > 0) {
-                            uint8_t c = (tile_a & bx) != 0 ? 1 : 0;
-                            c += ((tile_b & bx) != 0 ? 2 : 0);
+                        while (px < 8) {
+                            uint8_t c = pixels[px ^ flip];
 
                             if (x >= 0) {
                                 if (attrs & 0x80)
@@ -349,17 +388,17 @@ void gbRenderLine()
                                         c = c + 4 * palette;
                                     }
                                 }
-                                gbLineMix[x] = gbColorOption ? gbColorFilter[gbPalette[c] & 0x7FFF] : gbPalette[c] & 0x7FFF;
+                                gbLineMix[x] = kGbLinePalette | c;
                             }
                             x++;
                             if (x >= 160)
                                 break;
-                            bx >>= 1;
+                            px++;
                         }
                         tx++;
                         if (tx == 32)
                             tx = 0;
-                        bx = 128;
+                        px = 0;
                         tile = bank0[tile_map_line_y + tx];
                         if (bank1)
                             attrs = bank1[tile_map_line_y + tx];
@@ -519,7 +558,7 @@ void gbDrawSpriteTile(int tile, int x, int y, int t, int flags,
             }
         }
 
-        gbLineMix[xxx] = gbColorOption ? gbColorFilter[gbPalette[c] & 0x7FFF] : gbPalette[c] & 0x7FFF;
+        gbLineMix[xxx] = kGbLinePalette | c;
     }
 }
 
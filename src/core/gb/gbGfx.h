@@ -1,6 +1,49 @@
 #ifndef VBAM_CORE_GB_GBGFX_H_
 #define VBAM_CORE_GB_GBGFX_H_
 
+#include <cstdint>
+
+#include "core/gb/gbGlobals.h"
+
+// Decoded BG and window tiles of both VRAM banks, one byte per pixel, so that
+// gbRenderLine() doesn't have to pull the colors out of the two bit planes.
+// Flipped tiles are drawn by reversing the row or the pixel index. Writes to
+// VRAM mark the written tile dirty, anything that rewrites VRAM behind the
+// CPU's back (reset, save states...) must call gbTileCacheFlush().
+extern uint8_t gbTileCache[0x4000 / 16][64];
+extern uint32_t gbTileDirty[0x4000 / 16 / 32];
+
+void gbTileCacheFlush();
+
+// Called on every write to 0x8000-0x9fff, in the VRAM bank currently mapped.
+inline void gbTileCacheInvalidate(uint16_t address)
+{
+    const int bank = gbCgbMode ? register_VBK : 0;
+    const int tile = (bank << 9) | ((address & 0x1fff) >> 4);
+    gbTileDirty[tile >> 5] |= 1u << (tile & 31);
+}
+
+// Same for `count` bytes from `address`, within a 4KB page.
+inline void gbTileCacheInvalidate(uint16_t address, int count)
+{
+    const int last = address + count - 1;
+    for (int tileAddress = address & ~0xf; tileAddress <= last; tileAddress += 0x10)
+        gbTileCacheInvalidate(tileAddress);
+}
+
+// The palette entries through gbColorFilter and systemColorMap8/16/32, in the
+// format of systemColorDepth. The renderers store the index of palette pixels
+// in gbLineMix, tagged with kGbLinePalette, and gbDrawLine() converts them
+// through this table. The other pixels are plain 15-bit colors. Writes to the
+// CGB palette registers update their entry, the whole table is rebuilt on the
+// first line of every frame to follow frontend and option changes, and
+// anything else that rewrites gbPalette must call gbPaletteCacheFlush().
+constexpr uint16_t kGbLinePalette = 0x8000;
+extern uint32_t gbPaletteCache[128];
+
+void gbPaletteCacheFlush();
+void gbPaletteCacheUpdate(int index);
+
 void gbRenderLine();
 void gbDrawSprites(bool);
 
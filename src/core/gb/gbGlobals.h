@@ -3,7 +3,7 @@
 
 #include <cstdint>
 
-extern uint8_t* g_bios;
+#include "core/base/system.h"
 
 extern uint8_t* gbRom;
 extern uint8_t* gbRam;
@@ -4,12 +4,14 @@
 #include <cstring>
 
 #include "core/base/file_util.h"
+#include "core/base/line_writer.h"
 #include "core/base/port.h"
 #include "core/base/system.h"
 #include "core/gb/gb.h"
+#include "core/gb/gbGfx.h"
 #include "core/gb/gbGlobals.h"
+#include "core/gba/gbaCore.h"
 
-extern uint8_t* g_pix;
 extern bool speedup;
 extern bool gbSgbResetFlag;
 
@@ -91,6 +93,7 @@ void gbSgbReset()
         gbPalette[i * 4 + 2] = (0x0c) | (0x0c << 5) | (0x0c << 10);
         gbPalette[i * 4 + 3] = 0;
     }
+    gbPaletteCacheFlush();
 }
 
 void gbSgbInit()
@@ -124,7 +127,7 @@ void gbSgbFillScreen(uint16_t color)
 #else
             int yLine = (y + gbBorderRowSkip + 1) * (gbBorderLineSkip + 2) + gbBorderColumnSkip;
 #endif
-            uint8_t* dest = (uint8_t*)g_pix + yLine;
+            uint8_t* dest = (uint8_t*)gbaCore.g_pix + yLine;
             for (int x = 0; x < 160; x++)
                 gbSgbDraw8Bit(dest++, color);
         }
@@ -136,7 +139,7 @@ void gbSgbFillScreen(uint16_t color)
 #else
             int yLine = (y + gbBorderRowSkip + 1) * (gbBorderLineSkip + 2) + gbBorderColumnSkip;
 #endif
-            uint16_t* dest = (uint16_t*)g_pix + yLine;
+            uint16_t* dest = (uint16_t*)gbaCore.g_pix + yLine;
             for (int x = 0; x < 160; x++)
                 gbSgbDraw16Bit(dest++, color);
         }
@@ -144,7 +147,7 @@ void gbSgbFillScreen(uint16_t color)
     case 24: {
         for (int y = 0; y < 144; y++) {
             int yLine = (y + gbBorderRowSkip) * gbBorderLineSkip + gbBorderColumnSkip;
-            uint8_t* dest = (uint8_t*)g_pix + yLine * 3;
+            uint8_t* dest = (uint8_t*)gbaCore.g_pix + yLine * 3;
             for (int x = 0; x < 160; x++) {
                 gbSgbDraw24Bit(dest, color);
                 dest += 3;
@@ -158,13 +161,14 @@ void gbSgbFillScreen(uint16_t color)
 #else
             int yLine = (y + gbBorderRowSkip + 1) * (gbBorderLineSkip + 1) + gbBorderColumnSkip;
 #endif
-            uint32_t* dest = (uint32_t*)g_pix + yLine;
+            uint32_t* dest = (uint32_t*)gbaCore.g_pix + yLine;
             for (int x = 0; x < 160; x++) {
                 gbSgbDraw32Bit(dest++, color);
             }
         }
     } break;
     }
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
 }
 
 #define getmem(x) gbMemoryMap[(x) >> 12][(x)&0xfff]
@@ -208,14 +212,14 @@ void gbSgbRenderScreenToBuffer()
 void gbSgbDrawBorderTile(int x, int y, int tile, int attr)
 {
 #ifdef __LIBRETRO__
-    uint16_t* dest = (uint16_t*)g_pix + (y * 256) + x;
-    uint32_t* dest32 = (uint32_t*)g_pix + (y * 256) + x;
+    uint16_t* dest = (uint16_t*)gbaCore.g_pix + (y * 256) + x;
+    uint32_t* dest32 = (uint32_t*)gbaCore.g_pix + (y * 256) + x;
 #else
-    uint16_t* dest = (uint16_t*)g_pix + ((y + 1) * (256 + 2)) + x;
-    uint32_t* dest32 = (uint32_t*)g_pix + ((y + 1) * (256 + 1)) + x;
+    uint16_t* dest = (uint16_t*)gbaCore.g_pix + ((y + 1) * (256 + 2)) + x;
+    uint32_t* dest32 = (uint32_t*)gbaCore.g_pix + ((y + 1) * (256 + 1)) + x;
 #endif
-    uint8_t* dest8 = (uint8_t*)g_pix + ((y * 256) + x) * 3;
-    uint8_t* dest8b = (uint8_t*)g_pix + ((y * 256) + x);
+    uint8_t* dest8 = (uint8_t*)gbaCore.g_pix + ((y * 256) + x) * 3;
+    uint8_t* dest8b = (uint8_t*)gbaCore.g_pix + ((y * 256) + x);
     uint8_t* tileAddress = &gbSgbBorderChar[tile * 32];
     uint8_t* tileAddress2 = &gbSgbBorderChar[tile * 32 + 16];
 
@@ -325,6 +329,7 @@ void gbSgbRenderBorder()
                 gbSgbDrawBorderTile(x * 8, y * 8, tile, attr);
             }
         }
+        lineWriterInvalidate(gbaCore.g_lineWriterHashes);
     }
 }
 
@@ -777,6 +782,7 @@ void gbSgbCommand()
         gbSgbMaskEnable();
         break;
     }
+    gbPaletteCacheFlush();
 }
 
 void gbSgbResetPacketState()
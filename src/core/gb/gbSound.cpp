@@ -1,6 +1,7 @@
 #include "gbSound.h"
 
 #include <cstring>
+#include <vector>
 
 #include "core/apu/Effects_Buffer.h"
 #include "core/apu/Gb_Apu.h"
@@ -8,11 +9,9 @@
 #include "core/base/file_util.h"
 #include "core/gb/gb.h"
 #include "core/gb/gbGlobals.h"
+#include "core/gba/gbaCore.h"
 #include "core/gba/gbaSound.h"
 
-
-extern long soundSampleRate; // current sound quality
-
 gb_effects_config_t gb_effects_config = { false, 0.20f, 0.15f, false };
 
 static gb_effects_config_t gb_effects_config_current;
@@ -22,6 +21,7 @@ static Gb_Apu* gb_apu;
 static float soundVolume_ = -1;
 static int prevSoundEnable = -1;
 static bool declicking = false;
+static bool soundSilent_ = false;
 
 int const chan_count = 4;
 int const ticks_to_time = 2 * GB_APU_OVERCLOCK;
@@ -61,7 +61,7 @@ static void apply_effects()
 
     for (int i = 0; i < chan_count; i++) {
         Multi_Buffer::channel_t ch = { 0, 0, 0 };
-        if (prevSoundEnable >> i & 1)
+        if (!soundSilent_ && (prevSoundEnable >> i & 1))
             ch = stereo_buffer->channel(i);
         gb_apu->set_output(ch.center, ch.left, ch.right, i);
     }
@@ -72,6 +72,16 @@ void gbSoundConfigEffects(gb_effects_config_t const& c)
     gb_effects_config = c;
 }
 
+static void apply_silence()
+{
+    soundSilent_ = soundGetSilent();
+    apply_effects();
+
+    // Nothing gets into the buffer while silent, see flush_silence()
+    stereo_buffer->clear();
+    gb_apu->clear_amps();
+}
+
 static void apply_volume()
 {
     soundVolume_ = soundGetVolume();
@@ -86,7 +96,13 @@ void gbSoundTick(int st)
         // Run sound hardware to present
         end_frame((blip_time_t)(st * ticks_to_time));
 
-        flush_samples(stereo_buffer);
+        if (soundSilent_)
+            flush_silence(stereo_buffer);
+        else
+            flush_samples(stereo_buffer);
+
+        if (soundSilent_ != soundGetSilent())
+            apply_silence();
 
         // Update effects config if it was changed
         if (memcmp(&gb_effects_config_current, &gb_effects_config,
@@ -98,7 +114,7 @@ void gbSoundTick(int st)
             apply_volume();
     }
 
-    soundTicks = 0;
+    gbaCore.soundTicks = 0;
 }
 
 static void reset_apu()
@@ -114,7 +130,7 @@ static void reset_apu()
     if (stereo_buffer)
         stereo_buffer->clear();
 
-    soundTicks = 0;
+    gbaCore.soundTicks = 0;
 }
 
 static void remake_stereo_buffer()
@@ -130,7 +146,7 @@ static void remake_stereo_buffer()
     stereo_buffer = 0;
 
     stereo_buffer = new Simple_Effects_Buffer; // TODO: handle out of memory
-    if (stereo_buffer->set_sample_rate(soundSampleRate)) {
+    if (stereo_buffer->set_sample_rate(gbaCore.soundSampleRate)) {
     } // TODO: handle out of memory
     stereo_buffer->clock_rate(gb_apu->clock_rate);
 
@@ -175,7 +191,7 @@ void gbSoundReset()
     remake_stereo_buffer();
     reset_apu();
 
-    soundPaused = 1;
+    gbaCore.soundPaused = 1;
 
     gbSoundEvent(0, 0xff10, 0x80);
     gbSoundEvent(0, 0xff11, 0xbf);
@@ -218,13 +234,13 @@ void gbSoundReset()
 
 void gbSoundSetSampleRate(long sampleRate)
 {
-    if (soundSampleRate != sampleRate) {
+    if (gbaCore.soundSampleRate != sampleRate) {
         if (systemCanChangeSoundQuality()) {
             soundShutdown();
-            soundSampleRate = sampleRate;
+            gbaCore.soundSampleRate = sampleRate;
             soundInit();
         } else {
-            soundSampleRate = sampleRate;
+            gbaCore.soundSampleRate = sampleRate;
         }
 
         remake_stereo_buffer();
@@ -398,38 +414,41 @@ static void gbSoundReadGameOld(int version, gzFile gzFile)
 #endif // ! __LIBRETRO__
 
 // New state format
-static variable_desc gb_state[] = {
-    LOAD(int, state.version), // room_for_expansion will be used by later versions
+static std::vector<variable_desc> gb_state()
+{
+    return {
+        LOAD(int, state.version), // room_for_expansion will be used by later versions
 
-    // APU
-    LOAD(uint8_t[0x40], state.apu.regs), // last values written to registers and wave RAM (both banks)
-    LOAD(int, state.apu.frame_time), // clocks until next frame sequencer action
-    LOAD(int, state.apu.frame_phase), // next step frame sequencer will run
+        // APU
+        LOAD(uint8_t[0x40], state.apu.regs), // last values written to registers and wave RAM (both banks)
+        LOAD(int, state.apu.frame_time), // clocks until next frame sequencer action
+        LOAD(int, state.apu.frame_phase), // next step frame sequencer will run
 
-    LOAD(int, state.apu.sweep_freq), // sweep's internal frequency register
-    LOAD(int, state.apu.sweep_delay), // clocks until next sweep action
-    LOAD(int, state.apu.sweep_enabled),
-    LOAD(int, state.apu.sweep_neg), // obscure internal flag
-    LOAD(int, state.apu.noise_divider),
-    LOAD(int, state.apu.wave_buf), // last read byte of wave RAM
+        LOAD(int, state.apu.sweep_freq), // sweep's internal frequency register
+        LOAD(int, state.apu.sweep_delay), // clocks until next sweep action
+        LOAD(int, state.apu.sweep_enabled),
+        LOAD(int, state.apu.sweep_neg), // obscure internal flag
+        LOAD(int, state.apu.noise_divider),
+        LOAD(int, state.apu.wave_buf), // last read byte of wave RAM
 
-    LOAD(int[4], state.apu.delay), // clocks until next channel action
-    LOAD(int[4], state.apu.length_ctr),
-    LOAD(int[4], state.apu.phase), // square/wave phase, noise LFSR
-    LOAD(int[4], state.apu.enabled), // internal enabled flag
+        LOAD(int[4], state.apu.delay), // clocks until next channel action
+        LOAD(int[4], state.apu.length_ctr),
+        LOAD(int[4], state.apu.phase), // square/wave phase, noise LFSR
+        LOAD(int[4], state.apu.enabled), // internal enabled flag
 
-    LOAD(int[3], state.apu.env_delay), // clocks until next envelope action
-    LOAD(int[3], state.apu.env_volume),
-    LOAD(int[3], state.apu.env_enabled),
+        LOAD(int[3], state.apu.env_delay), // clocks until next envelope action
+        LOAD(int[3], state.apu.env_volume),
+        LOAD(int[3], state.apu.env_enabled),
 
-    SKIP(int[13], room_for_expansion),
+        SKIP(int[13], room_for_expansion),
 
-    // Emulator
-    LOAD(int, soundTicks),
-    SKIP(int[15], room_for_expansion),
+        // Emulator
+        LOAD(int, gbaCore.soundTicks),
+        SKIP(int[15], room_for_expansion),
 
-    { NULL, 0 }
-};
+        { NULL, 0 }
+    };
+}
 
 #ifndef __LIBRETRO__
 void gbSoundSaveGame(gzFile out)
@@ -440,7 +459,7 @@ void gbSoundSaveGame(gzFile out)
     memset(dummy_state, 0, sizeof dummy_state);
 
     state.version = 1;
-    utilWriteData(out, gb_state);
+    utilWriteData(out, gb_state().data());
 }
 
 void gbSoundReadGame(int version, gzFile in)
@@ -450,7 +469,7 @@ void gbSoundReadGame(int version, gzFile in)
     gb_apu->save_state(&state.apu);
 
     if (version > 11)
-        utilReadData(in, gb_state);
+        utilReadData(in, gb_state().data());
     else
         gbSoundReadGameOld(version, in);
 
@@ -467,7 +486,7 @@ void gbSoundSaveGame(uint8_t*& out)
     memset(dummy_state, 0, sizeof dummy_state);
 
     state.version = 1;
-    utilWriteDataMem(out, gb_state);
+    utilWriteDataMem(out, gb_state().data());
 }
 
 void gbSoundReadGame(const uint8_t*& in)
@@ -476,7 +495,7 @@ void gbSoundReadGame(const uint8_t*& in)
     reset_apu();
     gb_apu->save_state(&state.apu);
 
-    utilReadDataMem(in, gb_state);
+    utilReadDataMem(in, gb_state().data());
     gb_apu->load_state(state.apu);
 }
 #endif // __LIBRETRO__
@@ -7,6 +7,8 @@
 #include <zlib.h>
 #endif
 
+#include "core/base/system.h"
+
 // GB sound emulation
 
 // See Sound.h for sound setup/options
@@ -71,7 +73,6 @@ uint8_t gbSoundRead(int st, uint16_t address);
 // Notifies emulator that SOUND_CLOCK_TICKS clocks have passed
 void gbSoundTick(int st);
 extern int SOUND_CLOCK_TICKS; // Number of 16.8 MHz clocks between calls to gbSoundTick()
-extern int soundTicks; // Number of 16.8 MHz clocks until gbSoundTick() will be called
 
 // Saves/loads emulator state
 #ifdef __LIBRETRO__
@@ -93,13 +93,13 @@ extern char *dexp_text;
 std::map<std::string, uint32_t> dexp_vars;
 
 #define readWord(addr) \
-  READ32LE((&map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]))
+  READ32LE((&gbaCore.map[(addr)>>24].address[(addr) & gbaCore.map[(addr)>>24].mask]))
 
 #define readHalfWord(addr) \
-  READ16LE((&map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]))
+  READ16LE((&gbaCore.map[(addr)>>24].address[(addr) & gbaCore.map[(addr)>>24].mask]))
 
 #define readByte(addr) \
-  map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]
+  gbaCore.map[(addr)>>24].address[(addr) & gbaCore.map[(addr)>>24].mask]
 
 
 
@@ -1247,7 +1247,7 @@ yyreduce:
 
   case 17: /* exp: TOK_REGISTER  */
 #line 80 "debugger-expr.y"
-               { (yyval.number) = reg[(yyvsp[0].number)].I; }
+               { (yyval.number) = gbaCore.reg[(yyvsp[0].number)].I; }
 #line 1253 "debugger-expr-yacc.cpp"
     break;
 
@@ -16,13 +16,13 @@ extern char *dexp_text;
 std::map<std::string, uint32_t> dexp_vars;
 
 #define readWord(addr) \
-  READ32LE((&map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]))
+  READ32LE((&gbaCore.map[(addr)>>24].address[(addr) & gbaCore.map[(addr)>>24].mask]))
 
 #define readHalfWord(addr) \
-  READ16LE((&map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]))
+  READ16LE((&gbaCore.map[(addr)>>24].address[(addr) & gbaCore.map[(addr)>>24].mask]))
 
 #define readByte(addr) \
-  map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]
+  gbaCore.map[(addr)>>24].address[(addr) & gbaCore.map[(addr)>>24].mask]
 
 
 %}
@@ -76,7 +76,7 @@ exp: TOK_NUMBER           { $$ = $1; }
 | exp TOK_AND exp { $$ = $1 & $3;}
 | exp TOK_OR exp { $$ = $1 | $3;}
 | exp TOK_XOR exp { $$ = $1 ^ $3; }
-| TOK_REGISTER { $$ = reg[$1].I; }
+| TOK_REGISTER { $$ = gbaCore.reg[$1].I; }
 | TOK_BBRACKET exp TOK_RBRACKET { $$ = readByte($2); }
 | TOK_HBRACKET exp TOK_RBRACKET { $$ = readHalfWord($2); }
 | TOK_WBRACKET exp TOK_RBRACKET { $$ = readWord($2); }
@@ -5,12 +5,14 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #ifndef _MSC_VER
 #include <strings.h>
 #endif
 
 #include "core/base/file_util.h"
+#include "core/base/line_writer.h"
 #include "core/base/message.h"
 #include "core/base/port.h"
 #include "core/base/sizes.h"
@@ -25,8 +27,15 @@
 #include "core/gba/gbaPrint.h"
 #include "core/gba/gbaSound.h"
 #include "core/gba/internal/gbaBios.h"
+#include "core/gba/internal/gbaDecodeCache.h"
 #include "core/gba/internal/gbaEreader.h"
+#include "core/gba/internal/gbaIdleLoop.h"
+#include "core/gba/internal/gbaPageTable.h"
+#include "core/gba/internal/gbaRenderThreads.h"
+#include "core/gba/internal/gbaScheduler.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
 #include "core/gba/internal/gbaSram.h"
+#include "core/gba/internal/gbaTileCache.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 #include "core/gba/gbaElf.h"
@@ -53,99 +62,13 @@
 #endif
 
 extern int emulating;
-bool debugger = false;
-
-int SWITicks = 0;
-int IRQTicks = 0;
-
-uint32_t mastercode = 0;
-int layerEnableDelay = 0;
-bool busPrefetch = false;
-bool busPrefetchEnable = false;
-uint32_t busPrefetchCount = 0;
-int cpuDmaTicksToUpdate = 0;
-int cpuDmaCount = 0;
-bool cpuDmaRunning = false;
-uint32_t cpuDmaLast = 0;
-uint32_t cpuDmaPC = 0;
-int dummyAddress = 0;
-
-bool cpuBreakLoop = false;
-int cpuNextEvent = 0;
-
-bool intState = false;
-bool stopState = false;
-bool holdState = false;
-int holdType = 0;
-bool cpuSramEnabled = true;
-bool cpuFlashEnabled = true;
-bool cpuEEPROMEnabled = true;
-bool cpuEEPROMSensorEnabled = false;
-
-uint32_t cpuPrefetch[2];
-
-int cpuTotalTicks = 0;
+
 #ifdef PROFILING
 int profilingTicks = 0;
 int profilingTicksReload = 0;
 static profile_segment* profilSegment = NULL;
 #endif
 
-#ifdef VBAM_ENABLE_DEBUGGER
-uint8_t freezeWorkRAM[SIZE_WRAM];
-uint8_t freezeInternalRAM[SIZE_IRAM];
-uint8_t freezeVRAM[0x18000];
-uint8_t freezePRAM[SIZE_PRAM];
-uint8_t freezeOAM[SIZE_OAM];
-bool debugger_last;
-#endif
-
-int lcdTicks = (coreOptions.useBios && !coreOptions.skipBios) ? 1008 : 208;
-uint8_t timerOnOffDelay = 0;
-uint16_t timer0Value = 0;
-bool timer0On = false;
-int timer0Ticks = 0;
-int timer0Reload = 0;
-int timer0ClockReload = 0;
-uint16_t timer1Value = 0;
-bool timer1On = false;
-int timer1Ticks = 0;
-int timer1Reload = 0;
-int timer1ClockReload = 0;
-uint16_t timer2Value = 0;
-bool timer2On = false;
-int timer2Ticks = 0;
-int timer2Reload = 0;
-int timer2ClockReload = 0;
-uint16_t timer3Value = 0;
-bool timer3On = false;
-int timer3Ticks = 0;
-int timer3Reload = 0;
-int timer3ClockReload = 0;
-uint32_t dma0Source = 0;
-uint32_t dma0Dest = 0;
-uint32_t dma1Source = 0;
-uint32_t dma1Dest = 0;
-uint32_t dma2Source = 0;
-uint32_t dma2Dest = 0;
-uint32_t dma3Source = 0;
-uint32_t dma3Dest = 0;
-void (*cpuSaveGameFunc)(uint32_t, uint8_t) = flashSaveDecide;
-void (*renderLine)() = mode0RenderLine;
-bool fxOn = false;
-bool windowOn = false;
-int frameCount = 0;
-char g_buffer[1024];
-uint32_t lastTime = 0;
-int g_count = 0;
-
-int capture = 0;
-int capturePrevious = 0;
-int captureNumber = 0;
-
-int armOpcodeCount = 0;
-int thumbOpcodeCount = 0;
-
 const int TIMER_TICKS[4] = {
     0,
     6,
@@ -160,11 +83,6 @@ const uint8_t gamepakWaitState0[2] = { 2, 1 };
 const uint8_t gamepakWaitState1[2] = { 4, 1 };
 const uint8_t gamepakWaitState2[2] = { 8, 1 };
 
-uint8_t memoryWait[16] = { 0, 0, 2, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4, 4, 0 };
-uint8_t memoryWait32[16] = { 0, 0, 5, 0, 0, 1, 1, 0, 7, 7, 9, 9, 13, 13, 4, 0 };
-uint8_t memoryWaitSeq[16] = { 0, 0, 2, 0, 0, 0, 0, 0, 2, 2, 4, 4, 8, 8, 4, 0 };
-uint8_t memoryWaitSeq32[16] = { 0, 0, 5, 0, 0, 1, 1, 0, 5, 5, 9, 9, 17, 17, 4, 0 };
-
 // The videoMemoryWait constants are used to add some waitstates
 // if the opcode access video memory data outside of vblank/hblank
 // It seems to happen on only one ticks for each pixel.
@@ -172,8 +90,6 @@ uint8_t memoryWaitSeq32[16] = { 0, 0, 5, 0, 0, 1, 1, 0, 5, 5, 9, 9, 17, 17, 4, 0
 //const uint8_t videoMemoryWait[16] =
 //  {0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
-uint8_t biosProtected[4];
-
 #ifdef WORDS_BIGENDIAN
 bool cpuBiosSwapped = false;
 #endif
@@ -354,138 +270,162 @@ uint32_t myROM[] = {
     0x03007FE0
 };
 
-variable_desc saveGameStruct[] = {
-    { &DISPCNT, sizeof(uint16_t) },
-    { &DISPSTAT, sizeof(uint16_t) },
-    { &VCOUNT, sizeof(uint16_t) },
-    { &BG0CNT, sizeof(uint16_t) },
-    { &BG1CNT, sizeof(uint16_t) },
-    { &BG2CNT, sizeof(uint16_t) },
-    { &BG3CNT, sizeof(uint16_t) },
-    { &BG0HOFS, sizeof(uint16_t) },
-    { &BG0VOFS, sizeof(uint16_t) },
-    { &BG1HOFS, sizeof(uint16_t) },
-    { &BG1VOFS, sizeof(uint16_t) },
-    { &BG2HOFS, sizeof(uint16_t) },
-    { &BG2VOFS, sizeof(uint16_t) },
-    { &BG3HOFS, sizeof(uint16_t) },
-    { &BG3VOFS, sizeof(uint16_t) },
-    { &BG2PA, sizeof(uint16_t) },
-    { &BG2PB, sizeof(uint16_t) },
-    { &BG2PC, sizeof(uint16_t) },
-    { &BG2PD, sizeof(uint16_t) },
-    { &BG2X_L, sizeof(uint16_t) },
-    { &BG2X_H, sizeof(uint16_t) },
-    { &BG2Y_L, sizeof(uint16_t) },
-    { &BG2Y_H, sizeof(uint16_t) },
-    { &BG3PA, sizeof(uint16_t) },
-    { &BG3PB, sizeof(uint16_t) },
-    { &BG3PC, sizeof(uint16_t) },
-    { &BG3PD, sizeof(uint16_t) },
-    { &BG3X_L, sizeof(uint16_t) },
-    { &BG3X_H, sizeof(uint16_t) },
-    { &BG3Y_L, sizeof(uint16_t) },
-    { &BG3Y_H, sizeof(uint16_t) },
-    { &WIN0H, sizeof(uint16_t) },
-    { &WIN1H, sizeof(uint16_t) },
-    { &WIN0V, sizeof(uint16_t) },
-    { &WIN1V, sizeof(uint16_t) },
-    { &WININ, sizeof(uint16_t) },
-    { &WINOUT, sizeof(uint16_t) },
-    { &MOSAIC, sizeof(uint16_t) },
-    { &BLDMOD, sizeof(uint16_t) },
-    { &COLEV, sizeof(uint16_t) },
-    { &COLY, sizeof(uint16_t) },
-    { &DM0SAD_L, sizeof(uint16_t) },
-    { &DM0SAD_H, sizeof(uint16_t) },
-    { &DM0DAD_L, sizeof(uint16_t) },
-    { &DM0DAD_H, sizeof(uint16_t) },
-    { &DM0CNT_L, sizeof(uint16_t) },
-    { &DM0CNT_H, sizeof(uint16_t) },
-    { &DM1SAD_L, sizeof(uint16_t) },
-    { &DM1SAD_H, sizeof(uint16_t) },
-    { &DM1DAD_L, sizeof(uint16_t) },
-    { &DM1DAD_H, sizeof(uint16_t) },
-    { &DM1CNT_L, sizeof(uint16_t) },
-    { &DM1CNT_H, sizeof(uint16_t) },
-    { &DM2SAD_L, sizeof(uint16_t) },
-    { &DM2SAD_H, sizeof(uint16_t) },
-    { &DM2DAD_L, sizeof(uint16_t) },
-    { &DM2DAD_H, sizeof(uint16_t) },
-    { &DM2CNT_L, sizeof(uint16_t) },
-    { &DM2CNT_H, sizeof(uint16_t) },
-    { &DM3SAD_L, sizeof(uint16_t) },
-    { &DM3SAD_H, sizeof(uint16_t) },
-    { &DM3DAD_L, sizeof(uint16_t) },
-    { &DM3DAD_H, sizeof(uint16_t) },
-    { &DM3CNT_L, sizeof(uint16_t) },
-    { &DM3CNT_H, sizeof(uint16_t) },
-    { &TM0D, sizeof(uint16_t) },
-    { &TM0CNT, sizeof(uint16_t) },
-    { &TM1D, sizeof(uint16_t) },
-    { &TM1CNT, sizeof(uint16_t) },
-    { &TM2D, sizeof(uint16_t) },
-    { &TM2CNT, sizeof(uint16_t) },
-    { &TM3D, sizeof(uint16_t) },
-    { &TM3CNT, sizeof(uint16_t) },
-    { &P1, sizeof(uint16_t) },
-    { &IE, sizeof(uint16_t) },
-    { &IF, sizeof(uint16_t) },
-    { &IME, sizeof(uint16_t) },
-    { &holdState, sizeof(bool) },
-    { &holdType, sizeof(int) },
-    { &lcdTicks, sizeof(int) },
-    { &timer0On, sizeof(bool) },
-    { &timer0Ticks, sizeof(int) },
-    { &timer0Reload, sizeof(int) },
-    { &timer0ClockReload, sizeof(int) },
-    { &timer1On, sizeof(bool) },
-    { &timer1Ticks, sizeof(int) },
-    { &timer1Reload, sizeof(int) },
-    { &timer1ClockReload, sizeof(int) },
-    { &timer2On, sizeof(bool) },
-    { &timer2Ticks, sizeof(int) },
-    { &timer2Reload, sizeof(int) },
-    { &timer2ClockReload, sizeof(int) },
-    { &timer3On, sizeof(bool) },
-    { &timer3Ticks, sizeof(int) },
-    { &timer3Reload, sizeof(int) },
-    { &timer3ClockReload, sizeof(int) },
-    { &dma0Source, sizeof(uint32_t) },
-    { &dma0Dest, sizeof(uint32_t) },
-    { &dma1Source, sizeof(uint32_t) },
-    { &dma1Dest, sizeof(uint32_t) },
-    { &dma2Source, sizeof(uint32_t) },
-    { &dma2Dest, sizeof(uint32_t) },
-    { &dma3Source, sizeof(uint32_t) },
-    { &dma3Dest, sizeof(uint32_t) },
-    { &fxOn, sizeof(bool) },
-    { &windowOn, sizeof(bool) },
-    { &N_FLAG, sizeof(bool) },
-    { &C_FLAG, sizeof(bool) },
-    { &Z_FLAG, sizeof(bool) },
-    { &V_FLAG, sizeof(bool) },
-    { &armState, sizeof(bool) },
-    { &armIrqEnable, sizeof(bool) },
-    { &armNextPC, sizeof(uint32_t) },
-    { &armMode, sizeof(int) },
-    { &coreOptions.saveType, sizeof(int) },
-    { NULL, 0 }
-};
+static std::vector<variable_desc> saveGameStruct()
+{
+    return {
+        { &gbaCore.DISPCNT, sizeof(uint16_t) },
+        { &gbaCore.DISPSTAT, sizeof(uint16_t) },
+        { &gbaCore.VCOUNT, sizeof(uint16_t) },
+        { &gbaCore.BG0CNT, sizeof(uint16_t) },
+        { &gbaCore.BG1CNT, sizeof(uint16_t) },
+        { &gbaCore.BG2CNT, sizeof(uint16_t) },
+        { &gbaCore.BG3CNT, sizeof(uint16_t) },
+        { &gbaCore.BG0HOFS, sizeof(uint16_t) },
+        { &gbaCore.BG0VOFS, sizeof(uint16_t) },
+        { &gbaCore.BG1HOFS, sizeof(uint16_t) },
+        { &gbaCore.BG1VOFS, sizeof(uint16_t) },
+        { &gbaCore.BG2HOFS, sizeof(uint16_t) },
+        { &gbaCore.BG2VOFS, sizeof(uint16_t) },
+        { &gbaCore.BG3HOFS, sizeof(uint16_t) },
+        { &gbaCore.BG3VOFS, sizeof(uint16_t) },
+        { &gbaCore.BG2PA, sizeof(uint16_t) },
+        { &gbaCore.BG2PB, sizeof(uint16_t) },
+        { &gbaCore.BG2PC, sizeof(uint16_t) },
+        { &gbaCore.BG2PD, sizeof(uint16_t) },
+        { &gbaCore.BG2X_L, sizeof(uint16_t) },
+        { &gbaCore.BG2X_H, sizeof(uint16_t) },
+        { &gbaCore.BG2Y_L, sizeof(uint16_t) },
+        { &gbaCore.BG2Y_H, sizeof(uint16_t) },
+        { &gbaCore.BG3PA, sizeof(uint16_t) },
+        { &gbaCore.BG3PB, sizeof(uint16_t) },
+        { &gbaCore.BG3PC, sizeof(uint16_t) },
+        { &gbaCore.BG3PD, sizeof(uint16_t) },
+        { &gbaCore.BG3X_L, sizeof(uint16_t) },
+        { &gbaCore.BG3X_H, sizeof(uint16_t) },
+        { &gbaCore.BG3Y_L, sizeof(uint16_t) },
+        { &gbaCore.BG3Y_H, sizeof(uint16_t) },
+        { &gbaCore.WIN0H, sizeof(uint16_t) },
+        { &gbaCore.WIN1H, sizeof(uint16_t) },
+        { &gbaCore.WIN0V, sizeof(uint16_t) },
+        { &gbaCore.WIN1V, sizeof(uint16_t) },
+        { &gbaCore.WININ, sizeof(uint16_t) },
+        { &gbaCore.WINOUT, sizeof(uint16_t) },
+        { &gbaCore.MOSAIC, sizeof(uint16_t) },
+        { &gbaCore.BLDMOD, sizeof(uint16_t) },
+        { &gbaCore.COLEV, sizeof(uint16_t) },
+        { &gbaCore.COLY, sizeof(uint16_t) },
+        { &gbaCore.DM0SAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM0SAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM0DAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM0DAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM0CNT_L, sizeof(uint16_t) },
+        { &gbaCore.DM0CNT_H, sizeof(uint16_t) },
+        { &gbaCore.DM1SAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM1SAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM1DAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM1DAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM1CNT_L, sizeof(uint16_t) },
+        { &gbaCore.DM1CNT_H, sizeof(uint16_t) },
+        { &gbaCore.DM2SAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM2SAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM2DAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM2DAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM2CNT_L, sizeof(uint16_t) },
+        { &gbaCore.DM2CNT_H, sizeof(uint16_t) },
+        { &gbaCore.DM3SAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM3SAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM3DAD_L, sizeof(uint16_t) },
+        { &gbaCore.DM3DAD_H, sizeof(uint16_t) },
+        { &gbaCore.DM3CNT_L, sizeof(uint16_t) },
+        { &gbaCore.DM3CNT_H, sizeof(uint16_t) },
+        { &gbaCore.TM0D, sizeof(uint16_t) },
+        { &gbaCore.TM0CNT, sizeof(uint16_t) },
+        { &gbaCore.TM1D, sizeof(uint16_t) },
+        { &gbaCore.TM1CNT, sizeof(uint16_t) },
+        { &gbaCore.TM2D, sizeof(uint16_t) },
+        { &gbaCore.TM2CNT, sizeof(uint16_t) },
+        { &gbaCore.TM3D, sizeof(uint16_t) },
+        { &gbaCore.TM3CNT, sizeof(uint16_t) },
+        { &gbaCore.P1, sizeof(uint16_t) },
+        { &gbaCore.IE, sizeof(uint16_t) },
+        { &gbaCore.IF, sizeof(uint16_t) },
+        { &gbaCore.IME, sizeof(uint16_t) },
+        { &gbaCore.holdState, sizeof(bool) },
+        { &gbaCore.holdType, sizeof(int) },
+        { &gbaCore.lcdTicks, sizeof(int) },
+        { &gbaCore.timer0On, sizeof(bool) },
+        { &gbaCore.timer0Ticks, sizeof(int) },
+        { &gbaCore.timer0Reload, sizeof(int) },
+        { &gbaCore.timer0ClockReload, sizeof(int) },
+        { &gbaCore.timer1On, sizeof(bool) },
+        { &gbaCore.timer1Ticks, sizeof(int) },
+        { &gbaCore.timer1Reload, sizeof(int) },
+        { &gbaCore.timer1ClockReload, sizeof(int) },
+        { &gbaCore.timer2On, sizeof(bool) },
+        { &gbaCore.timer2Ticks, sizeof(int) },
+        { &gbaCore.timer2Reload, sizeof(int) },
+        { &gbaCore.timer2ClockReload, sizeof(int) },
+        { &gbaCore.timer3On, sizeof(bool) },
+        { &gbaCore.timer3Ticks, sizeof(int) },
+        { &gbaCore.timer3Reload, sizeof(int) },
+        { &gbaCore.timer3ClockReload, sizeof(int) },
+        { &gbaCore.dma0Source, sizeof(uint32_t) },
+        { &gbaCore.dma0Dest, sizeof(uint32_t) },
+        { &gbaCore.dma1Source, sizeof(uint32_t) },
+        { &gbaCore.dma1Dest, sizeof(uint32_t) },
+        { &gbaCore.dma2Source, sizeof(uint32_t) },
+        { &gbaCore.dma2Dest, sizeof(uint32_t) },
+        { &gbaCore.dma3Source, sizeof(uint32_t) },
+        { &gbaCore.dma3Dest, sizeof(uint32_t) },
+        { &gbaCore.fxOn, sizeof(bool) },
+        { &gbaCore.windowOn, sizeof(bool) },
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+        { &gbaCore.stateNFlag, sizeof(bool) },
+        { &gbaCore.C_FLAG, sizeof(bool) },
+        { &gbaCore.stateZFlag, sizeof(bool) },
+#else
+        { &gbaCore.N_FLAG, sizeof(bool) },
+        { &gbaCore.C_FLAG, sizeof(bool) },
+        { &gbaCore.Z_FLAG, sizeof(bool) },
+#endif
+        { &gbaCore.V_FLAG, sizeof(bool) },
+        { &gbaCore.armState, sizeof(bool) },
+        { &gbaCore.armIrqEnable, sizeof(bool) },
+        { &gbaCore.armNextPC, sizeof(uint32_t) },
+        { &gbaCore.armMode, sizeof(int) },
+        { &coreOptions.saveType, sizeof(int) },
+        { NULL, 0 }
+    };
+}
 
-static int romSize = SIZE_ROM;
+static inline void CPUSaveStateFlags()
+{
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+    gbaCore.stateNFlag = gbaCore.N_FLAG;
+    gbaCore.stateZFlag = gbaCore.Z_FLAG;
+#endif
+}
+
+static inline void CPULoadStateFlags()
+{
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+    gbaCore.N_FLAG = gbaCore.stateNFlag;
+    gbaCore.Z_FLAG = gbaCore.stateZFlag;
+#endif
+}
 
 void gbaUpdateRomSize(int size)
 {
     // Only change memory block if new size is larger
-    if (size > romSize) {
-        romSize = size;
+    if (size > gbaCore.romSize) {
+        gbaCore.romSize = size;
 
-        uint8_t* tmp = (uint8_t*)realloc(g_rom, romSize);
-        g_rom = tmp;
+        uint8_t* tmp = (uint8_t*)realloc(gbaCore.g_rom, gbaCore.romSize);
+        gbaCore.g_rom = tmp;
+        cpuUpdatePageTable();
 
-        uint16_t* temp = (uint16_t*)(g_rom + ((romSize + 1) & ~1));
-        for (int i = (romSize + 1) & ~1; i < SIZE_ROM; i += 2) {
+        uint16_t* temp = (uint16_t*)(gbaCore.g_rom + ((gbaCore.romSize + 1) & ~1));
+        for (int i = (gbaCore.romSize + 1) & ~1; i < SIZE_ROM; i += 2) {
             WRITE16LE(temp, (i >> 1) & 0xFFFF);
             temp++;
         }
@@ -509,23 +449,7 @@ void cpuEnableProfiling(int hz)
 
 inline int CPUUpdateTicks()
 {
-    int cpuLoopTicks = lcdTicks;
-
-    //if (soundTicks < cpuLoopTicks)
-        //cpuLoopTicks = soundTicks;
-
-    if (timer0On && (timer0Ticks < cpuLoopTicks)) {
-        cpuLoopTicks = timer0Ticks;
-    }
-    if (timer1On && !(TM1CNT & 4) && (timer1Ticks < cpuLoopTicks)) {
-        cpuLoopTicks = timer1Ticks;
-    }
-    if (timer2On && !(TM2CNT & 4) && (timer2Ticks < cpuLoopTicks)) {
-        cpuLoopTicks = timer2Ticks;
-    }
-    if (timer3On && !(TM3CNT & 4) && (timer3Ticks < cpuLoopTicks)) {
-        cpuLoopTicks = timer3Ticks;
-    }
+    int cpuLoopTicks = gbaSchedulerNextEvent();
 #ifdef PROFILING
     if (profilingTicksReload != 0) {
         if (profilingTicks < cpuLoopTicks) {
@@ -534,56 +458,105 @@ inline int CPUUpdateTicks()
     }
 #endif
 
-    if (SWITicks) {
-        if (SWITicks < cpuLoopTicks)
-            cpuLoopTicks = SWITicks;
-    }
-
-    if (IRQTicks) {
-        if (IRQTicks < cpuLoopTicks)
-            cpuLoopTicks = IRQTicks;
+    if (gbaCore.SWITicks) {
+        if (gbaCore.SWITicks < cpuLoopTicks)
+            cpuLoopTicks = gbaCore.SWITicks;
     }
 
     return cpuLoopTicks;
 }
 
+// Copies the scheduled countdowns to the variables saved in states. Timers
+// that are not counting keep the value they had when they stopped.
+static void CPUSyncEventTicks()
+{
+    if (gbaSchedulerPending(kGbaEventLcd))
+        gbaCore.lcdTicks = gbaSchedulerTicksLeft(kGbaEventLcd);
+    if (gbaSchedulerPending(kGbaEventTimer0))
+        gbaCore.timer0Ticks = gbaSchedulerTicksLeft(kGbaEventTimer0);
+    if (gbaSchedulerPending(kGbaEventTimer1))
+        gbaCore.timer1Ticks = gbaSchedulerTicksLeft(kGbaEventTimer1);
+    if (gbaSchedulerPending(kGbaEventTimer2))
+        gbaCore.timer2Ticks = gbaSchedulerTicksLeft(kGbaEventTimer2);
+    if (gbaSchedulerPending(kGbaEventTimer3))
+        gbaCore.timer3Ticks = gbaSchedulerTicksLeft(kGbaEventTimer3);
+    gbaCore.IRQTicks = gbaSchedulerPending(kGbaEventIrq) ? gbaSchedulerTicksLeft(kGbaEventIrq) : 0;
+}
+
+static void CPUScheduleTimer(GbaEvent event, bool counting, int ticks)
+{
+    if (counting)
+        gbaSchedulerSchedule(event, ticks);
+    else
+        gbaSchedulerCancel(event);
+}
+
+// Schedules the events from the variables saved in states. Cascading timers
+// are clocked by the previous timer's overflow, not by the scheduler.
+static void CPUScheduleEvents()
+{
+    gbaSchedulerSchedule(kGbaEventLcd, gbaCore.lcdTicks);
+    CPUScheduleTimer(kGbaEventTimer0, gbaCore.timer0On, gbaCore.timer0Ticks);
+    CPUScheduleTimer(kGbaEventTimer1, gbaCore.timer1On && !(gbaCore.TM1CNT & 4), gbaCore.timer1Ticks);
+    CPUScheduleTimer(kGbaEventTimer2, gbaCore.timer2On && !(gbaCore.TM2CNT & 4), gbaCore.timer2Ticks);
+    CPUScheduleTimer(kGbaEventTimer3, gbaCore.timer3On && !(gbaCore.TM3CNT & 4), gbaCore.timer3Ticks);
+    if (gbaCore.IRQTicks > 0)
+        gbaSchedulerSchedule(kGbaEventIrq, gbaCore.IRQTicks);
+    else
+        gbaSchedulerCancel(kGbaEventIrq);
+}
+
+// The RTC is a deferred event: it is only checked at the other events, so it
+// sees the same cycle counts as when it was updated at every event.
+static void CPUUpdateRtc()
+{
+    rtcUpdateTime((int)(gbaSchedulerNow() - gbaCore.rtcLastUpdate));
+    gbaCore.rtcLastUpdate = gbaSchedulerNow();
+}
+
+static void CPUScheduleRtc()
+{
+    if (rtcIsEnabled() && !gbaSchedulerPending(kGbaEventRtc)) {
+        gbaCore.rtcLastUpdate = gbaSchedulerNow();
+        gbaSchedulerSchedule(kGbaEventRtc, rtcTicksToNextSecond());
+    } else if (!rtcIsEnabled() && gbaSchedulerPending(kGbaEventRtc)) {
+        CPUUpdateRtc();
+        gbaSchedulerCancel(kGbaEventRtc);
+    }
+}
+
 void CPUUpdateWindow0()
 {
-    int x00 = WIN0H >> 8;
-    int x01 = WIN0H & 255;
+    int x00 = gbaCore.WIN0H >> 8;
+    int x01 = gbaCore.WIN0H & 255;
 
     if (x00 <= x01) {
         for (int i = 0; i < 240; i++) {
-            gfxInWin0[i] = (i >= x00 && i < x01);
+            gbaCore.gfxInWin0[i] = (i >= x00 && i < x01);
         }
     } else {
         for (int i = 0; i < 240; i++) {
-            gfxInWin0[i] = (i >= x00 || i < x01);
+            gbaCore.gfxInWin0[i] = (i >= x00 || i < x01);
         }
     }
 }
 
 void CPUUpdateWindow1()
 {
-    int x00 = WIN1H >> 8;
-    int x01 = WIN1H & 255;
+    int x00 = gbaCore.WIN1H >> 8;
+    int x01 = gbaCore.WIN1H & 255;
 
     if (x00 <= x01) {
         for (int i = 0; i < 240; i++) {
-            gfxInWin1[i] = (i >= x00 && i < x01);
+            gbaCore.gfxInWin1[i] = (i >= x00 && i < x01);
         }
     } else {
         for (int i = 0; i < 240; i++) {
-            gfxInWin1[i] = (i >= x00 || i < x01);
+            gbaCore.gfxInWin1[i] = (i >= x00 || i < x01);
         }
     }
 }
 
-extern uint32_t g_line0[240];
-extern uint32_t g_line1[240];
-extern uint32_t g_line2[240];
-extern uint32_t g_line3[240];
-
 #define CLEAR_ARRAY(a)                  \
     {                                   \
         uint32_t* array = (a);               \
@@ -595,16 +568,16 @@ extern uint32_t g_line3[240];
 void CPUUpdateRenderBuffers(bool force)
 {
     if (!(coreOptions.layerEnable & 0x0100) || force) {
-        CLEAR_ARRAY(g_line0);
+        CLEAR_ARRAY(gbaCore.g_line0);
     }
     if (!(coreOptions.layerEnable & 0x0200) || force) {
-        CLEAR_ARRAY(g_line1);
+        CLEAR_ARRAY(gbaCore.g_line1);
     }
     if (!(coreOptions.layerEnable & 0x0400) || force) {
-        CLEAR_ARRAY(g_line2);
+        CLEAR_ARRAY(gbaCore.g_line2);
     }
     if (!(coreOptions.layerEnable & 0x0800) || force) {
-        CLEAR_ARRAY(g_line3);
+        CLEAR_ARRAY(gbaCore.g_line3);
     }
 }
 
@@ -616,22 +589,24 @@ unsigned int CPUWriteState(uint8_t* data)
     uint8_t* orig = data;
 
     utilWriteIntMem(data, SAVE_GAME_VERSION);
-    utilWriteMem(data, &g_rom[0xa0], 16);
+    utilWriteMem(data, &gbaCore.g_rom[0xa0], 16);
     utilWriteIntMem(data, coreOptions.useBios);
-    utilWriteMem(data, &reg[0], sizeof(reg));
+    utilWriteMem(data, &gbaCore.reg[0], sizeof(gbaCore.reg));
 
-    utilWriteDataMem(data, saveGameStruct);
+    CPUSyncEventTicks();
+    CPUSaveStateFlags();
+    utilWriteDataMem(data, saveGameStruct().data());
 
-    utilWriteIntMem(data, stopState);
-    utilWriteIntMem(data, IRQTicks);
+    utilWriteIntMem(data, gbaCore.stopState);
+    utilWriteIntMem(data, gbaCore.IRQTicks);
 
-    utilWriteMem(data, g_internalRAM, SIZE_IRAM);
-    utilWriteMem(data, g_paletteRAM, SIZE_PRAM);
-    utilWriteMem(data, g_workRAM, SIZE_WRAM);
-    utilWriteMem(data, g_vram, SIZE_VRAM);
-    utilWriteMem(data, g_oam, SIZE_OAM);
-    utilWriteMem(data, g_pix, SIZE_PIX);
-    utilWriteMem(data, g_ioMem, SIZE_IOMEM);
+    utilWriteMem(data, gbaCore.g_internalRAM, SIZE_IRAM);
+    utilWriteMem(data, gbaCore.g_paletteRAM, SIZE_PRAM);
+    utilWriteMem(data, gbaCore.g_workRAM, SIZE_WRAM);
+    utilWriteMem(data, gbaCore.g_vram, SIZE_VRAM);
+    utilWriteMem(data, gbaCore.g_oam, SIZE_OAM);
+    utilWriteMem(data, gbaCore.g_pix, SIZE_PIX);
+    utilWriteMem(data, gbaCore.g_ioMem, SIZE_IOMEM);
 
     eepromSaveGame(data);
     flashSaveGame(data);
@@ -650,50 +625,57 @@ bool CPUReadState(const uint8_t* data)
 
     char romname[16];
     utilReadMem(romname, data, 16);
-    if (memcmp(&g_rom[0xa0], romname, 16) != 0)
+    if (memcmp(&gbaCore.g_rom[0xa0], romname, 16) != 0)
         return false;
 
     // Don't care about use bios ...
     utilReadIntMem(data);
 
-    utilReadMem(&reg[0], data, sizeof(reg));
+    utilReadMem(&gbaCore.reg[0], data, sizeof(gbaCore.reg));
 
-    utilReadDataMem(data, saveGameStruct);
+    utilReadDataMem(data, saveGameStruct().data());
+    CPULoadStateFlags();
 
-    stopState = utilReadIntMem(data) ? true : false;
+    gbaCore.stopState = utilReadIntMem(data) ? true : false;
 
-    IRQTicks = utilReadIntMem(data);
-    if (IRQTicks > 0)
-        intState = true;
+    gbaCore.IRQTicks = utilReadIntMem(data);
+    if (gbaCore.IRQTicks > 0)
+        gbaCore.intState = true;
     else {
-        intState = false;
-        IRQTicks = 0;
-    }
-
-    utilReadMem(g_internalRAM, data, SIZE_IRAM);
-    utilReadMem(g_paletteRAM, data, SIZE_PRAM);
-    utilReadMem(g_workRAM, data, SIZE_WRAM);
-    utilReadMem(g_vram, data, SIZE_VRAM);
-    utilReadMem(g_oam, data, SIZE_OAM);
-    utilReadMem(g_pix, data, SIZE_PIX);
-    utilReadMem(g_ioMem, data, SIZE_IOMEM);
+        gbaCore.intState = false;
+        gbaCore.IRQTicks = 0;
+    }
+
+    utilReadMem(gbaCore.g_internalRAM, data, SIZE_IRAM);
+    utilReadMem(gbaCore.g_paletteRAM, data, SIZE_PRAM);
+    utilReadMem(gbaCore.g_workRAM, data, SIZE_WRAM);
+    utilReadMem(gbaCore.g_vram, data, SIZE_VRAM);
+    utilReadMem(gbaCore.g_oam, data, SIZE_OAM);
+    utilReadMem(gbaCore.g_pix, data, SIZE_PIX);
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
+    utilReadMem(gbaCore.g_ioMem, data, SIZE_IOMEM);
+    cpuDecodeCacheFlush();
+    gfxSpriteIndexFlush();
+    gfxTileCacheFlush();
 
     eepromReadGame(data);
     flashReadGame(data);
     soundReadGame(data);
     rtcReadGame(data);
 
+    CPUScheduleEvents();
+
     //// Copypasta stuff ...
     // set pointers!
-    coreOptions.layerEnable = coreOptions.layerSettings & DISPCNT;
+    coreOptions.layerEnable = coreOptions.layerSettings & gbaCore.DISPCNT;
 
     CPUUpdateRender();
 
     // CPU Update Render Buffers set to true
-    CLEAR_ARRAY(g_line0);
-    CLEAR_ARRAY(g_line1);
-    CLEAR_ARRAY(g_line2);
-    CLEAR_ARRAY(g_line3);
+    CLEAR_ARRAY(gbaCore.g_line0);
+    CLEAR_ARRAY(gbaCore.g_line1);
+    CLEAR_ARRAY(gbaCore.g_line2);
+    CLEAR_ARRAY(gbaCore.g_line3);
     // End of CPU Update Render Buffers set to true
 
     CPUUpdateWindow0();
@@ -702,7 +684,7 @@ bool CPUReadState(const uint8_t* data)
     SetSaveType(coreOptions.saveType);
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
-    if (armState) {
+    if (gbaCore.armState) {
         ARM_PREFETCH;
     } else {
         THUMB_PREFETCH;
@@ -719,26 +701,28 @@ static bool CPUWriteState(gzFile gzFile)
 {
     utilWriteInt(gzFile, SAVE_GAME_VERSION);
 
-    utilGzWrite(gzFile, &g_rom[0xa0], 16);
+    utilGzWrite(gzFile, &gbaCore.g_rom[0xa0], 16);
 
     utilWriteInt(gzFile, coreOptions.useBios);
 
-    utilGzWrite(gzFile, &reg[0], sizeof(reg));
+    utilGzWrite(gzFile, &gbaCore.reg[0], sizeof(gbaCore.reg));
 
-    utilWriteData(gzFile, saveGameStruct);
+    CPUSyncEventTicks();
+    CPUSaveStateFlags();
+    utilWriteData(gzFile, saveGameStruct().data());
 
     // new to version 0.7.1
-    utilWriteInt(gzFile, stopState);
+    utilWriteInt(gzFile, gbaCore.stopState);
     // new to version 0.8
-    utilWriteInt(gzFile, IRQTicks);
+    utilWriteInt(gzFile, gbaCore.IRQTicks);
 
-    utilGzWrite(gzFile, g_internalRAM, SIZE_IRAM);
-    utilGzWrite(gzFile, g_paletteRAM, SIZE_PRAM);
-    utilGzWrite(gzFile, g_workRAM, SIZE_WRAM);
-    utilGzWrite(gzFile, g_vram, SIZE_VRAM);
-    utilGzWrite(gzFile, g_oam, SIZE_OAM);
-    utilGzWrite(gzFile, g_pix, SIZE_PIX);
-    utilGzWrite(gzFile, g_ioMem, SIZE_IOMEM);
+    utilGzWrite(gzFile, gbaCore.g_internalRAM, SIZE_IRAM);
+    utilGzWrite(gzFile, gbaCore.g_paletteRAM, SIZE_PRAM);
+    utilGzWrite(gzFile, gbaCore.g_workRAM, SIZE_WRAM);
+    utilGzWrite(gzFile, gbaCore.g_vram, SIZE_VRAM);
+    utilGzWrite(gzFile, gbaCore.g_oam, SIZE_OAM);
+    utilGzWrite(gzFile, gbaCore.g_pix, SIZE_PIX);
+    utilGzWrite(gzFile, gbaCore.g_ioMem, SIZE_IOMEM);
 
     eepromSaveGame(gzFile);
     flashSaveGame(gzFile);
@@ -803,7 +787,7 @@ static bool CPUReadState(gzFile gzFile)
 
     utilGzRead(gzFile, romname, 16);
 
-    if (memcmp(&g_rom[0xa0], romname, 16) != 0) {
+    if (memcmp(&gbaCore.g_rom[0xa0], romname, 16) != 0) {
         romname[16] = 0;
         for (int i = 0; i < 16; i++)
             if (romname[i] < 32)
@@ -824,38 +808,43 @@ static bool CPUReadState(gzFile gzFile)
         return false;
     }
 
-    utilGzRead(gzFile, &reg[0], sizeof(reg));
+    utilGzRead(gzFile, &gbaCore.reg[0], sizeof(gbaCore.reg));
 
-    utilReadData(gzFile, saveGameStruct);
+    utilReadData(gzFile, saveGameStruct().data());
+    CPULoadStateFlags();
 
     if (version < SAVE_GAME_VERSION_3)
-        stopState = false;
+        gbaCore.stopState = false;
     else
-        stopState = utilReadInt(gzFile) ? true : false;
+        gbaCore.stopState = utilReadInt(gzFile) ? true : false;
 
     if (version < SAVE_GAME_VERSION_4) {
-        IRQTicks = 0;
-        intState = false;
+        gbaCore.IRQTicks = 0;
+        gbaCore.intState = false;
     } else {
-        IRQTicks = utilReadInt(gzFile);
-        if (IRQTicks > 0)
-            intState = true;
+        gbaCore.IRQTicks = utilReadInt(gzFile);
+        if (gbaCore.IRQTicks > 0)
+            gbaCore.intState = true;
         else {
-            intState = false;
-            IRQTicks = 0;
+            gbaCore.intState = false;
+            gbaCore.IRQTicks = 0;
         }
     }
 
-    utilGzRead(gzFile, g_internalRAM, SIZE_IRAM);
-    utilGzRead(gzFile, g_paletteRAM, SIZE_PRAM);
-    utilGzRead(gzFile, g_workRAM, SIZE_WRAM);
-    utilGzRead(gzFile, g_vram, SIZE_VRAM);
-    utilGzRead(gzFile, g_oam, SIZE_OAM);
+    utilGzRead(gzFile, gbaCore.g_internalRAM, SIZE_IRAM);
+    utilGzRead(gzFile, gbaCore.g_paletteRAM, SIZE_PRAM);
+    utilGzRead(gzFile, gbaCore.g_workRAM, SIZE_WRAM);
+    utilGzRead(gzFile, gbaCore.g_vram, SIZE_VRAM);
+    utilGzRead(gzFile, gbaCore.g_oam, SIZE_OAM);
     if (version < SAVE_GAME_VERSION_6)
-        utilGzRead(gzFile, g_pix, 4 * 240 * 160);
+        utilGzRead(gzFile, gbaCore.g_pix, 4 * 240 * 160);
     else
-        utilGzRead(gzFile, g_pix, SIZE_PIX);
-    utilGzRead(gzFile, g_ioMem, SIZE_IOMEM);
+        utilGzRead(gzFile, gbaCore.g_pix, SIZE_PIX);
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
+    utilGzRead(gzFile, gbaCore.g_ioMem, SIZE_IOMEM);
+    cpuDecodeCacheFlush();
+    gfxSpriteIndexFlush();
+    gfxTileCacheFlush();
 
     if (coreOptions.skipSaveGameBattery) {
         // skip eeprom data
@@ -888,31 +877,33 @@ static bool CPUReadState(gzFile gzFile)
     (b) = (temp) >> 16;    \
     (c) = (temp)&0xFFFF;
 
-        SWAP(dma0Source, DM0SAD_H, DM0SAD_L);
-        SWAP(dma0Dest, DM0DAD_H, DM0DAD_L);
-        SWAP(dma1Source, DM1SAD_H, DM1SAD_L);
-        SWAP(dma1Dest, DM1DAD_H, DM1DAD_L);
-        SWAP(dma2Source, DM2SAD_H, DM2SAD_L);
-        SWAP(dma2Dest, DM2DAD_H, DM2DAD_L);
-        SWAP(dma3Source, DM3SAD_H, DM3SAD_L);
-        SWAP(dma3Dest, DM3DAD_H, DM3DAD_L);
+        SWAP(gbaCore.dma0Source, gbaCore.DM0SAD_H, gbaCore.DM0SAD_L);
+        SWAP(gbaCore.dma0Dest, gbaCore.DM0DAD_H, gbaCore.DM0DAD_L);
+        SWAP(gbaCore.dma1Source, gbaCore.DM1SAD_H, gbaCore.DM1SAD_L);
+        SWAP(gbaCore.dma1Dest, gbaCore.DM1DAD_H, gbaCore.DM1DAD_L);
+        SWAP(gbaCore.dma2Source, gbaCore.DM2SAD_H, gbaCore.DM2SAD_L);
+        SWAP(gbaCore.dma2Dest, gbaCore.DM2DAD_H, gbaCore.DM2DAD_L);
+        SWAP(gbaCore.dma3Source, gbaCore.DM3SAD_H, gbaCore.DM3SAD_L);
+        SWAP(gbaCore.dma3Dest, gbaCore.DM3DAD_H, gbaCore.DM3DAD_L);
     }
 
     if (version <= SAVE_GAME_VERSION_8) {
-        timer0ClockReload = TIMER_TICKS[TM0CNT & 3];
-        timer1ClockReload = TIMER_TICKS[TM1CNT & 3];
-        timer2ClockReload = TIMER_TICKS[TM2CNT & 3];
-        timer3ClockReload = TIMER_TICKS[TM3CNT & 3];
-
-        timer0Ticks = ((0x10000 - TM0D) << timer0ClockReload) - timer0Ticks;
-        timer1Ticks = ((0x10000 - TM1D) << timer1ClockReload) - timer1Ticks;
-        timer2Ticks = ((0x10000 - TM2D) << timer2ClockReload) - timer2Ticks;
-        timer3Ticks = ((0x10000 - TM3D) << timer3ClockReload) - timer3Ticks;
+        gbaCore.timer0ClockReload = TIMER_TICKS[gbaCore.TM0CNT & 3];
+        gbaCore.timer1ClockReload = TIMER_TICKS[gbaCore.TM1CNT & 3];
+        gbaCore.timer2ClockReload = TIMER_TICKS[gbaCore.TM2CNT & 3];
+        gbaCore.timer3ClockReload = TIMER_TICKS[gbaCore.TM3CNT & 3];
+
+        gbaCore.timer0Ticks = ((0x10000 - gbaCore.TM0D) << gbaCore.timer0ClockReload) - gbaCore.timer0Ticks;
+        gbaCore.timer1Ticks = ((0x10000 - gbaCore.TM1D) << gbaCore.timer1ClockReload) - gbaCore.timer1Ticks;
+        gbaCore.timer2Ticks = ((0x10000 - gbaCore.TM2D) << gbaCore.timer2ClockReload) - gbaCore.timer2Ticks;
+        gbaCore.timer3Ticks = ((0x10000 - gbaCore.TM3D) << gbaCore.timer3ClockReload) - gbaCore.timer3Ticks;
         interp_rate();
     }
 
+    CPUScheduleEvents();
+
     // set pointers!
-    coreOptions.layerEnable = coreOptions.layerSettings & DISPCNT;
+    coreOptions.layerEnable = coreOptions.layerSettings & gbaCore.DISPCNT;
 
     CPUUpdateRender();
     CPUUpdateRenderBuffers(true);
@@ -922,7 +913,7 @@ static bool CPUReadState(gzFile gzFile)
     SetSaveType(coreOptions.saveType);
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
-    if (armState) {
+    if (gbaCore.armState) {
         ARM_PREFETCH;
     } else {
         THUMB_PREFETCH;
@@ -961,7 +952,7 @@ bool CPUReadState(const char* file)
 
 bool CPUExportEepromFile(const char* fileName)
 {
-    if (eepromInUse) {
+    if (gbaCore.eepromInUse) {
         FILE* file = utilOpenFile(fileName, "wb");
 
         if (!file) {
@@ -970,9 +961,9 @@ bool CPUExportEepromFile(const char* fileName)
             return false;
         }
 
-        for (int i = 0; i < eepromSize;) {
+        for (int i = 0; i < gbaCore.eepromSize;) {
             for (int j = 0; j < 8; j++) {
-                if (fwrite(&eepromData[i + 7 - j], 1, 1, file) != 1) {
+                if (fwrite(&gbaCore.eepromData[i + 7 - j], 1, 1, file) != 1) {
                     fclose(file);
                     return false;
                 }
@@ -996,20 +987,20 @@ bool CPUWriteBatteryFile(const char* fileName)
         }
 
         // only save if Flash/Sram in use or EEprom in use
-        if (!eepromInUse) {
+        if (!gbaCore.eepromInUse) {
             if (coreOptions.saveType == GBA_SAVE_FLASH) { // save flash type
-                if (fwrite(flashSaveMemory, 1, g_flashSize, file) != (size_t)g_flashSize) {
+                if (fwrite(gbaCore.flashSaveMemory, 1, gbaCore.g_flashSize, file) != (size_t)gbaCore.g_flashSize) {
                     fclose(file);
                     return false;
                 }
             } else if (coreOptions.saveType == GBA_SAVE_SRAM) { // save sram type
-                if (fwrite(flashSaveMemory, 1, 0x8000, file) != 0x8000) {
+                if (fwrite(gbaCore.flashSaveMemory, 1, 0x8000, file) != 0x8000) {
                     fclose(file);
                     return false;
                 }
             }
         } else { // save eeprom type
-            if (fwrite(eepromData, 1, eepromSize, file) != (size_t)eepromSize) {
+            if (fwrite(gbaCore.eepromData, 1, gbaCore.eepromSize, file) != (size_t)gbaCore.eepromSize) {
                 fclose(file);
                 return false;
             }
@@ -1053,7 +1044,7 @@ bool CPUReadGSASnapshot(const char* fileName)
     for (i = 0; i < 16; i++)
         if (buffer[i] < 32)
             buffer[i] = 32;
-    memcpy(buffer2, &g_rom[0xa0], 16);
+    memcpy(buffer2, &gbaCore.g_rom[0xa0], 16);
     buffer2[16] = 0;
     for (i = 0; i < 16; i++)
         if (buffer2[i] < 32)
@@ -1068,7 +1059,7 @@ bool CPUReadGSASnapshot(const char* fileName)
     }
     fseek(file, 12, SEEK_CUR); // skip some flags
     if (saveSize >= 65536) {
-        if (fread(flashSaveMemory, 1, saveSize, file) != (size_t)saveSize) {
+        if (fread(gbaCore.flashSaveMemory, 1, saveSize, file) != (size_t)saveSize) {
             fclose(file);
             return false;
         }
@@ -1104,7 +1095,7 @@ bool CPUReadGSASPSnapshot(const char* fileName)
     FREAD_UNCHECKED(savename, 1, namesz, file);
     savename[namesz] = 0;
 
-    memcpy(romname, &g_rom[0xa0], namesz);
+    memcpy(romname, &gbaCore.g_rom[0xa0], namesz);
     romname[namesz] = 0;
 
     if (memcmp(romname, savename, namesz)) {
@@ -1133,7 +1124,7 @@ bool CPUReadGSASPSnapshot(const char* fileName)
     }
 
     // Read up to 128k save
-    FREAD_UNCHECKED(flashSaveMemory, 1, FLASH_128K_SZ, file);
+    FREAD_UNCHECKED(gbaCore.flashSaveMemory, 1, FLASH_128K_SZ, file);
 
     fclose(file);
     CPUReset();
@@ -1170,7 +1161,7 @@ bool CPUWriteGSASnapshot(const char* fileName,
     fwrite(notes, 1, strlen(notes), file);
     int saveSize = 0x10000;
     if (coreOptions.saveType == GBA_SAVE_FLASH)
-        saveSize = g_flashSize;
+        saveSize = gbaCore.g_flashSize;
     int totalSize = saveSize + 0x1c;
 
     utilPutDword(buffer, totalSize); // length of remainder of save - CRC
@@ -1178,13 +1169,13 @@ bool CPUWriteGSASnapshot(const char* fileName,
 
     char* temp = new char[0x2001c];
     memset(temp, 0, 28);
-    memcpy(temp, &g_rom[0xa0], 16); // copy internal name
-    temp[0x10] = g_rom[0xbe]; // reserved area (old checksum)
-    temp[0x11] = g_rom[0xbf]; // reserved area (old checksum)
-    temp[0x12] = g_rom[0xbd]; // complement check
-    temp[0x13] = g_rom[0xb0]; // maker
+    memcpy(temp, &gbaCore.g_rom[0xa0], 16); // copy internal name
+    temp[0x10] = gbaCore.g_rom[0xbe]; // reserved area (old checksum)
+    temp[0x11] = gbaCore.g_rom[0xbf]; // reserved area (old checksum)
+    temp[0x12] = gbaCore.g_rom[0xbd]; // complement check
+    temp[0x13] = gbaCore.g_rom[0xb0]; // maker
     temp[0x14] = 1; // 1 save ?
-    memcpy(&temp[0x1c], flashSaveMemory, saveSize); // copy save
+    memcpy(&temp[0x1c], gbaCore.flashSaveMemory, saveSize); // copy save
     fwrite(temp, 1, totalSize, file); // write save + header
     uint32_t crc = 0;
 
@@ -1213,26 +1204,26 @@ bool CPUImportEepromFile(const char* fileName)
     long size = ftell(file);
     fseek(file, 0, SEEK_SET);
     if (size == 512 || size == 0x2000) {
-        if (fread(eepromData, 1, size, file) != (size_t)size) {
+        if (fread(gbaCore.eepromData, 1, size, file) != (size_t)size) {
             fclose(file);
             return false;
         }
         for (int i = 0; i < size;) {
-            uint8_t tmp = eepromData[i];
-            eepromData[i] = eepromData[7 - i];
-            eepromData[7 - i] = tmp;
+            uint8_t tmp = gbaCore.eepromData[i];
+            gbaCore.eepromData[i] = gbaCore.eepromData[7 - i];
+            gbaCore.eepromData[7 - i] = tmp;
             i++;
-            tmp = eepromData[i];
-            eepromData[i] = eepromData[7 - i];
-            eepromData[7 - i] = tmp;
+            tmp = gbaCore.eepromData[i];
+            gbaCore.eepromData[i] = gbaCore.eepromData[7 - i];
+            gbaCore.eepromData[7 - i] = tmp;
             i++;
-            tmp = eepromData[i];
-            eepromData[i] = eepromData[7 - i];
-            eepromData[7 - i] = tmp;
+            tmp = gbaCore.eepromData[i];
+            gbaCore.eepromData[i] = gbaCore.eepromData[7 - i];
+            gbaCore.eepromData[7 - i] = tmp;
             i++;
-            tmp = eepromData[i];
-            eepromData[i] = eepromData[7 - i];
-            eepromData[7 - i] = tmp;
+            tmp = gbaCore.eepromData[i];
+            gbaCore.eepromData[i] = gbaCore.eepromData[7 - i];
+            gbaCore.eepromData[7 - i] = tmp;
             i++;
             i += 4;
         }
@@ -1259,25 +1250,25 @@ bool CPUReadBatteryFile(const char* fileName)
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 
     if (size == 512 || size == 0x2000) {
-        if (fread(eepromData, 1, size, file) != (size_t)size) {
+        if (fread(gbaCore.eepromData, 1, size, file) != (size_t)size) {
             fclose(file);
             return false;
         }
     } else {
         if (size == 0x20000) {
-            if (fread(flashSaveMemory, 1, 0x20000, file) != 0x20000) {
+            if (fread(gbaCore.flashSaveMemory, 1, 0x20000, file) != 0x20000) {
                 fclose(file);
                 return false;
             }
             flashSetSize(0x20000);
         } else if (size == 0x10000) {
-            if (fread(flashSaveMemory, 1, 0x10000, file) != 0x10000) {
+            if (fread(gbaCore.flashSaveMemory, 1, 0x10000, file) != 0x10000) {
                 fclose(file);
                 return false;
             }
             flashSetSize(0x10000);
         } else if (size == 0x8000) {
-            if (fread(flashSaveMemory, 1, 0x8000, file) != 0x8000) {
+            if (fread(gbaCore.flashSaveMemory, 1, 0x8000, file) != 0x8000) {
                 fclose(file);
                 return false;
             }
@@ -1290,12 +1281,12 @@ bool CPUReadBatteryFile(const char* fileName)
 #ifndef __LIBRETRO__
 bool CPUWritePNGFile(const char* fileName)
 {
-    return utilWritePNGFile(fileName, 240, 160, g_pix);
+    return utilWritePNGFile(fileName, 240, 160, gbaCore.g_pix);
 }
 
 bool CPUWriteBMPFile(const char* fileName)
 {
-    return utilWriteBMPFile(fileName, 240, 160, g_pix);
+    return utilWriteBMPFile(fileName, 240, 160, gbaCore.g_pix);
 }
 #endif /* !__LIBRETRO__ */
 
@@ -1384,49 +1375,49 @@ void CPUCleanUp()
     }
 #endif
 
-    if (g_rom != NULL) {
-        free(g_rom);
-        g_rom = NULL;
+    if (gbaCore.g_rom != NULL) {
+        free(gbaCore.g_rom);
+        gbaCore.g_rom = NULL;
     }
 
-    if (g_vram != NULL) {
-        free(g_vram);
-        g_vram = NULL;
+    if (gbaCore.g_vram != NULL) {
+        free(gbaCore.g_vram);
+        gbaCore.g_vram = NULL;
     }
 
-    if (g_paletteRAM != NULL) {
-        free(g_paletteRAM);
-        g_paletteRAM = NULL;
+    if (gbaCore.g_paletteRAM != NULL) {
+        free(gbaCore.g_paletteRAM);
+        gbaCore.g_paletteRAM = NULL;
     }
 
-    if (g_internalRAM != NULL) {
-        free(g_internalRAM);
-        g_internalRAM = NULL;
+    if (gbaCore.g_internalRAM != NULL) {
+        free(gbaCore.g_internalRAM);
+        gbaCore.g_internalRAM = NULL;
     }
 
-    if (g_workRAM != NULL) {
-        free(g_workRAM);
-        g_workRAM = NULL;
+    if (gbaCore.g_workRAM != NULL) {
+        free(gbaCore.g_workRAM);
+        gbaCore.g_workRAM = NULL;
     }
 
-    if (g_bios != NULL) {
-        free(g_bios);
-        g_bios = NULL;
+    if (gbaCore.g_bios != NULL) {
+        free(gbaCore.g_bios);
+        gbaCore.g_bios = NULL;
     }
 
-    if (g_pix != NULL) {
-        free(g_pix);
-        g_pix = NULL;
+    if (gbaCore.g_pix != NULL) {
+        free(gbaCore.g_pix);
+        gbaCore.g_pix = NULL;
     }
 
-    if (g_oam != NULL) {
-        free(g_oam);
-        g_oam = NULL;
+    if (gbaCore.g_oam != NULL) {
+        free(gbaCore.g_oam);
+        gbaCore.g_oam = NULL;
     }
 
-    if (g_ioMem != NULL) {
-        free(g_ioMem);
-        g_ioMem = NULL;
+    if (gbaCore.g_ioMem != NULL) {
+        free(gbaCore.g_ioMem);
+        gbaCore.g_ioMem = NULL;
     }
 
 #if defined(VBAM_ENABLE_DEBUGGER)
@@ -1440,36 +1431,36 @@ void CPUCleanUp()
 
 void SetMapMasks()
 {
-    map[0].mask = 0x3FFF;
-    map[2].mask = 0x3FFFF;
-    map[3].mask = 0x7FFF;
-    map[4].mask = 0x3FF;
-    map[5].mask = 0x3FF;
-    map[6].mask = 0x1FFFF;
-    map[7].mask = 0x3FF;
-    map[8].mask = 0x1FFFFFF;
-    map[9].mask = 0x1FFFFFF;
-    map[10].mask = 0x1FFFFFF;
-    map[12].mask = 0x1FFFFFF;
-    map[14].mask = 0xFFFF;
+    gbaCore.map[0].mask = 0x3FFF;
+    gbaCore.map[2].mask = 0x3FFFF;
+    gbaCore.map[3].mask = 0x7FFF;
+    gbaCore.map[4].mask = 0x3FF;
+    gbaCore.map[5].mask = 0x3FF;
+    gbaCore.map[6].mask = 0x1FFFF;
+    gbaCore.map[7].mask = 0x3FF;
+    gbaCore.map[8].mask = 0x1FFFFFF;
+    gbaCore.map[9].mask = 0x1FFFFFF;
+    gbaCore.map[10].mask = 0x1FFFFFF;
+    gbaCore.map[12].mask = 0x1FFFFFF;
+    gbaCore.map[14].mask = 0xFFFF;
 
 #ifdef VBAM_ENABLE_DEBUGGER
     for (int i = 0; i < 16; i++) {
-        map[i].size = map[i].mask + 1;
-        map[i].trace = NULL;
-        map[i].breakPoints = NULL;
+        gbaCore.map[i].size = gbaCore.map[i].mask + 1;
+        gbaCore.map[i].trace = NULL;
+        gbaCore.map[i].breakPoints = NULL;
 
-        if ((map[i].size >> 1) > 0) {
-            map[i].breakPoints = (uint8_t*)calloc(map[i].size >> 1, sizeof(uint8_t));
-            if (map[i].breakPoints == NULL) {
+        if ((gbaCore.map[i].size >> 1) > 0) {
+            gbaCore.map[i].breakPoints = (uint8_t*)calloc(gbaCore.map[i].size >> 1, sizeof(uint8_t));
+            if (gbaCore.map[i].breakPoints == NULL) {
                 systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
                     "TRACE");
             }
         }
 
-        if ((map[i].size >> 3) > 0) {
-            map[i].trace = (uint8_t*)calloc(map[i].size >> 3, sizeof(uint8_t));
-            if (map[i].trace == NULL) {
+        if ((gbaCore.map[i].size >> 3) > 0) {
+            gbaCore.map[i].trace = (uint8_t*)calloc(gbaCore.map[i].size >> 3, sizeof(uint8_t));
+            if (gbaCore.map[i].trace == NULL) {
                 systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
                     "TRACE");
             }
@@ -1481,27 +1472,27 @@ void SetMapMasks()
 
 int CPULoadRom(const char* szFile)
 {
-    romSize = SIZE_ROM;
-    if (g_rom != NULL) {
+    gbaCore.romSize = SIZE_ROM;
+    if (gbaCore.g_rom != NULL) {
         CPUCleanUp();
     }
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 
-    g_rom = (uint8_t*)malloc(SIZE_ROM);
-    if (g_rom == NULL) {
+    gbaCore.g_rom = (uint8_t*)malloc(SIZE_ROM);
+    if (gbaCore.g_rom == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "ROM");
         return 0;
     }
-    g_workRAM = (uint8_t*)calloc(1, SIZE_WRAM);
-    if (g_workRAM == NULL) {
+    gbaCore.g_workRAM = (uint8_t*)calloc(1, SIZE_WRAM);
+    if (gbaCore.g_workRAM == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "WRAM");
         return 0;
     }
 
-    uint8_t* whereToLoad = coreOptions.cpuIsMultiBoot ? g_workRAM : g_rom;
+    uint8_t* whereToLoad = coreOptions.cpuIsMultiBoot ? gbaCore.g_workRAM : gbaCore.g_rom;
 
 #if defined(VBAM_ENABLE_DEBUGGER)
     if (CPUIsELF(szFile)) {
@@ -1509,18 +1500,18 @@ int CPULoadRom(const char* szFile)
         if (!f) {
             systemMessage(MSG_ERROR_OPENING_IMAGE, N_("Error opening image %s"),
                 szFile);
-            free(g_rom);
-            g_rom = NULL;
-            free(g_workRAM);
-            g_workRAM = NULL;
+            free(gbaCore.g_rom);
+            gbaCore.g_rom = NULL;
+            free(gbaCore.g_workRAM);
+            gbaCore.g_workRAM = NULL;
             return 0;
         }
-        bool res = elfRead(szFile, romSize, f);
-        if (!res || romSize == 0) {
-            free(g_rom);
-            g_rom = NULL;
-            free(g_workRAM);
-            g_workRAM = NULL;
+        bool res = elfRead(szFile, gbaCore.romSize, f);
+        if (!res || gbaCore.romSize == 0) {
+            free(gbaCore.g_rom);
+            gbaCore.g_rom = NULL;
+            free(gbaCore.g_workRAM);
+            gbaCore.g_workRAM = NULL;
             elfCleanUp();
             return 0;
         }
@@ -1530,67 +1521,67 @@ int CPULoadRom(const char* szFile)
         if (!utilLoad(szFile,
                 utilIsGBAImage,
                 whereToLoad,
-                romSize)) {
-            free(g_rom);
-            g_rom = NULL;
-            free(g_workRAM);
-            g_workRAM = NULL;
+                gbaCore.romSize)) {
+            free(gbaCore.g_rom);
+            gbaCore.g_rom = NULL;
+            free(gbaCore.g_workRAM);
+            gbaCore.g_workRAM = NULL;
             return 0;
         }
     }
 
-    uint16_t* temp = (uint16_t*)(g_rom + ((romSize + 1) & ~1));
+    uint16_t* temp = (uint16_t*)(gbaCore.g_rom + ((gbaCore.romSize + 1) & ~1));
     int i;
-    for (i = (romSize + 1) & ~1; i < SIZE_ROM; i += 2) {
+    for (i = (gbaCore.romSize + 1) & ~1; i < SIZE_ROM; i += 2) {
         WRITE16LE(temp, (i >> 1) & 0xFFFF);
         temp++;
     }
 
-    g_bios = (uint8_t*)calloc(1, SIZE_BIOS);
-    if (g_bios == NULL) {
+    gbaCore.g_bios = (uint8_t*)calloc(1, SIZE_BIOS);
+    if (gbaCore.g_bios == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "BIOS");
         CPUCleanUp();
         return 0;
     }
-    g_internalRAM = (uint8_t*)calloc(1, SIZE_IRAM);
-    if (g_internalRAM == NULL) {
+    gbaCore.g_internalRAM = (uint8_t*)calloc(1, SIZE_IRAM);
+    if (gbaCore.g_internalRAM == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "IRAM");
         CPUCleanUp();
         return 0;
     }
-    g_paletteRAM = (uint8_t*)calloc(1, SIZE_PRAM);
-    if (g_paletteRAM == NULL) {
+    gbaCore.g_paletteRAM = (uint8_t*)calloc(1, SIZE_PRAM);
+    if (gbaCore.g_paletteRAM == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "PRAM");
         CPUCleanUp();
         return 0;
     }
-    g_vram = (uint8_t*)calloc(1, SIZE_VRAM);
-    if (g_vram == NULL) {
+    gbaCore.g_vram = (uint8_t*)calloc(1, SIZE_VRAM);
+    if (gbaCore.g_vram == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "VRAM");
         CPUCleanUp();
         return 0;
     }
-    g_oam = (uint8_t*)calloc(1, SIZE_OAM);
-    if (g_oam == NULL) {
+    gbaCore.g_oam = (uint8_t*)calloc(1, SIZE_OAM);
+    if (gbaCore.g_oam == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "OAM");
         CPUCleanUp();
         return 0;
     }
 
-    g_pix = (uint8_t*)calloc(1, 4 * 241 * 162);
-    if (g_pix == NULL) {
+    gbaCore.g_pix = (uint8_t*)calloc(1, 4 * 241 * 162);
+    if (gbaCore.g_pix == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "PIX");
         CPUCleanUp();
         return 0;
     }
-    g_ioMem = (uint8_t*)calloc(1, SIZE_IOMEM);
-    if (g_ioMem == NULL) {
+    gbaCore.g_ioMem = (uint8_t*)calloc(1, SIZE_IOMEM);
+    if (gbaCore.g_ioMem == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "IO");
         CPUCleanUp();
@@ -1602,88 +1593,88 @@ int CPULoadRom(const char* szFile)
 
     CPUUpdateRenderBuffers(true);
 
-    return romSize;
+    return gbaCore.romSize;
 }
 
 int CPULoadRomData(const char* data, int size)
 {
-    romSize = SIZE_ROM;
-    if (g_rom != NULL) {
+    gbaCore.romSize = SIZE_ROM;
+    if (gbaCore.g_rom != NULL) {
         CPUCleanUp();
     }
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 
-    g_rom = (uint8_t*)malloc(SIZE_ROM);
-    if (g_rom == NULL) {
+    gbaCore.g_rom = (uint8_t*)malloc(SIZE_ROM);
+    if (gbaCore.g_rom == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "ROM");
         return 0;
     }
-    g_workRAM = (uint8_t*)calloc(1, SIZE_WRAM);
-    if (g_workRAM == NULL) {
+    gbaCore.g_workRAM = (uint8_t*)calloc(1, SIZE_WRAM);
+    if (gbaCore.g_workRAM == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "WRAM");
         return 0;
     }
 
-    uint8_t* whereToLoad = coreOptions.cpuIsMultiBoot ? g_workRAM : g_rom;
+    uint8_t* whereToLoad = coreOptions.cpuIsMultiBoot ? gbaCore.g_workRAM : gbaCore.g_rom;
 
-    romSize = size % 2 == 0 ? size : size + 1;
+    gbaCore.romSize = size % 2 == 0 ? size : size + 1;
     memcpy(whereToLoad, data, size);
 
-    uint16_t* temp = (uint16_t*)(g_rom + ((romSize + 1) & ~1));
+    uint16_t* temp = (uint16_t*)(gbaCore.g_rom + ((gbaCore.romSize + 1) & ~1));
     int i;
-    for (i = (romSize + 1) & ~1; i < SIZE_ROM; i += 2) {
+    for (i = (gbaCore.romSize + 1) & ~1; i < SIZE_ROM; i += 2) {
         WRITE16LE(temp, (i >> 1) & 0xFFFF);
         temp++;
     }
 
-    g_bios = (uint8_t*)calloc(1, SIZE_BIOS);
-    if (g_bios == NULL) {
+    gbaCore.g_bios = (uint8_t*)calloc(1, SIZE_BIOS);
+    if (gbaCore.g_bios == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "BIOS");
         CPUCleanUp();
         return 0;
     }
-    g_internalRAM = (uint8_t*)calloc(1, SIZE_IRAM);
-    if (g_internalRAM == NULL) {
+    gbaCore.g_internalRAM = (uint8_t*)calloc(1, SIZE_IRAM);
+    if (gbaCore.g_internalRAM == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "IRAM");
         CPUCleanUp();
         return 0;
     }
-    g_paletteRAM = (uint8_t*)calloc(1, SIZE_PRAM);
-    if (g_paletteRAM == NULL) {
+    gbaCore.g_paletteRAM = (uint8_t*)calloc(1, SIZE_PRAM);
+    if (gbaCore.g_paletteRAM == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "PRAM");
         CPUCleanUp();
         return 0;
     }
-    g_vram = (uint8_t*)calloc(1, SIZE_VRAM);
-    if (g_vram == NULL) {
+    gbaCore.g_vram = (uint8_t*)calloc(1, SIZE_VRAM);
+    if (gbaCore.g_vram == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "VRAM");
         CPUCleanUp();
         return 0;
     }
-    g_oam = (uint8_t*)calloc(1, SIZE_OAM);
-    if (g_oam == NULL) {
+    gbaCore.g_oam = (uint8_t*)calloc(1, SIZE_OAM);
+    if (gbaCore.g_oam == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "OAM");
         CPUCleanUp();
         return 0;
     }
 
-    g_pix = (uint8_t*)calloc(1, 4 * 240 * 160);
-    if (g_pix == NULL) {
+    gbaCore.g_pix = (uint8_t*)calloc(1, 4 * 240 * 160);
+    if (gbaCore.g_pix == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "PIX");
         CPUCleanUp();
         return 0;
     }
-    g_ioMem = (uint8_t*)calloc(1, SIZE_IOMEM);
-    if (g_ioMem == NULL) {
+    gbaCore.g_ioMem = (uint8_t*)calloc(1, SIZE_IOMEM);
+    if (gbaCore.g_ioMem == NULL) {
         systemMessage(MSG_OUT_OF_MEMORY, N_("Failed to allocate memory for %s"),
             "IO");
         CPUCleanUp();
@@ -1695,15 +1686,15 @@ int CPULoadRomData(const char* data, int size)
 
     CPUUpdateRenderBuffers(true);
 
-    return romSize;
+    return gbaCore.romSize;
 }
 
 void doMirroring(bool b)
 {
-    if (static_cast<size_t>(romSize) > k32MiB)
+    if (static_cast<size_t>(gbaCore.romSize) > k32MiB)
         return;
 
-    int romSizeRounded = romSize;
+    int romSizeRounded = gbaCore.romSize;
     romSizeRounded--;
     romSizeRounded |= romSizeRounded >> 1;
     romSizeRounded |= romSizeRounded >> 2;
@@ -1717,7 +1708,7 @@ void doMirroring(bool b)
         if (mirroredRomSize == 0)
             mirroredRomSize = 0x100000;
         while (mirroredRomAddress < 0x01000000) {
-            memcpy((uint16_t*)(g_rom + mirroredRomAddress), (uint16_t*)(g_rom), mirroredRomSize);
+            memcpy((uint16_t*)(gbaCore.g_rom + mirroredRomAddress), (uint16_t*)(gbaCore.g_rom), mirroredRomSize);
             mirroredRomAddress += mirroredRomSize;
         }
     }
@@ -1763,91 +1754,53 @@ void SetSaveDotCodeFile(const char* szFile)
 
 void CPUUpdateRender()
 {
-    switch (DISPCNT & 7) {
-    case 0:
-        if ((!fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000)) || coreOptions.cpuDisableSfx)
-            renderLine = mode0RenderLine;
-        else if (fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000))
-            renderLine = mode0RenderLineNoWindow;
-        else
-            renderLine = mode0RenderLineAll;
-        break;
-    case 1:
-        if ((!fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000)) || coreOptions.cpuDisableSfx)
-            renderLine = mode1RenderLine;
-        else if (fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000))
-            renderLine = mode1RenderLineNoWindow;
-        else
-            renderLine = mode1RenderLineAll;
-        break;
-    case 2:
-        if ((!fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000)) || coreOptions.cpuDisableSfx)
-            renderLine = mode2RenderLine;
-        else if (fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000))
-            renderLine = mode2RenderLineNoWindow;
-        else
-            renderLine = mode2RenderLineAll;
-        break;
-    case 3:
-        if ((!fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000)) || coreOptions.cpuDisableSfx)
-            renderLine = mode3RenderLine;
-        else if (fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000))
-            renderLine = mode3RenderLineNoWindow;
-        else
-            renderLine = mode3RenderLineAll;
-        break;
-    case 4:
-        if ((!fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000)) || coreOptions.cpuDisableSfx)
-            renderLine = mode4RenderLine;
-        else if (fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000))
-            renderLine = mode4RenderLineNoWindow;
-        else
-            renderLine = mode4RenderLineAll;
-        break;
-    case 5:
-        if ((!fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000)) || coreOptions.cpuDisableSfx)
-            renderLine = mode5RenderLine;
-        else if (fxOn && !windowOn && !(coreOptions.layerEnable & 0x8000))
-            renderLine = mode5RenderLineNoWindow;
-        else
-            renderLine = mode5RenderLineAll;
-    default:
-        break;
-    }
+    int mode = gbaCore.DISPCNT & 7;
+    if (mode > 5)
+        return;
+
+    bool objWindowOn = (coreOptions.layerEnable & 0x8000) ? true : false;
+
+    if ((!gbaCore.fxOn && !gbaCore.windowOn && !objWindowOn) || coreOptions.cpuDisableSfx)
+        gbaCore.renderLine = gfxGetRenderLine(mode, false, false, false);
+    else
+        gbaCore.renderLine = gfxGetRenderLine(mode, gbaCore.fxOn, gbaCore.windowOn, objWindowOn);
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+    gbaCore.skipLine = gfxGetSkipLine(mode);
+#endif
 }
 
 void CPUUpdateCPSR()
 {
-    uint32_t CPSR = reg[16].I & 0x40;
-    if (N_FLAG)
+    uint32_t CPSR = gbaCore.reg[16].I & 0x40;
+    if (gbaCore.N_FLAG)
         CPSR |= 0x80000000;
-    if (Z_FLAG)
+    if (gbaCore.Z_FLAG)
         CPSR |= 0x40000000;
-    if (C_FLAG)
+    if (gbaCore.C_FLAG)
         CPSR |= 0x20000000;
-    if (V_FLAG)
+    if (gbaCore.V_FLAG)
         CPSR |= 0x10000000;
-    if (!armState)
+    if (!gbaCore.armState)
         CPSR |= 0x00000020;
-    if (!armIrqEnable)
+    if (!gbaCore.armIrqEnable)
         CPSR |= 0x80;
-    CPSR |= (armMode & 0x1F);
-    reg[16].I = CPSR;
+    CPSR |= (gbaCore.armMode & 0x1F);
+    gbaCore.reg[16].I = CPSR;
 }
 
 void CPUUpdateFlags(bool breakLoop)
 {
-    uint32_t CPSR = reg[16].I;
-
-    N_FLAG = (CPSR & 0x80000000) ? true : false;
-    Z_FLAG = (CPSR & 0x40000000) ? true : false;
-    C_FLAG = (CPSR & 0x20000000) ? true : false;
-    V_FLAG = (CPSR & 0x10000000) ? true : false;
-    armState = (CPSR & 0x20) ? false : true;
-    armIrqEnable = (CPSR & 0x80) ? false : true;
+    uint32_t CPSR = gbaCore.reg[16].I;
+
+    gbaCore.N_FLAG = (CPSR & 0x80000000) ? true : false;
+    gbaCore.Z_FLAG = (CPSR & 0x40000000) ? true : false;
+    gbaCore.C_FLAG = (CPSR & 0x20000000) ? true : false;
+    gbaCore.V_FLAG = (CPSR & 0x10000000) ? true : false;
+    gbaCore.armState = (CPSR & 0x20) ? false : true;
+    gbaCore.armIrqEnable = (CPSR & 0x80) ? false : true;
     if (breakLoop) {
-        if (armIrqEnable && (IF & IE) && (IME & 1))
-            cpuNextEvent = cpuTotalTicks;
+        if (gbaCore.armIrqEnable && (gbaCore.IF & gbaCore.IE) && (gbaCore.IME & 1))
+            gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
     }
 }
 
@@ -1879,110 +1832,110 @@ void CPUSwitchMode(int mode, bool saveState, bool breakLoop)
 
     CPUUpdateCPSR();
 
-    switch (armMode) {
+    switch (gbaCore.armMode) {
     case 0x10:
     case 0x1F:
-        reg[R13_USR].I = reg[13].I;
-        reg[R14_USR].I = reg[14].I;
-        reg[17].I = reg[16].I;
+        gbaCore.reg[R13_USR].I = gbaCore.reg[13].I;
+        gbaCore.reg[R14_USR].I = gbaCore.reg[14].I;
+        gbaCore.reg[17].I = gbaCore.reg[16].I;
         break;
     case 0x11:
-        CPUSwap(&reg[R8_FIQ].I, &reg[8].I);
-        CPUSwap(&reg[R9_FIQ].I, &reg[9].I);
-        CPUSwap(&reg[R10_FIQ].I, &reg[10].I);
-        CPUSwap(&reg[R11_FIQ].I, &reg[11].I);
-        CPUSwap(&reg[R12_FIQ].I, &reg[12].I);
-        reg[R13_FIQ].I = reg[13].I;
-        reg[R14_FIQ].I = reg[14].I;
-        reg[SPSR_FIQ].I = reg[17].I;
+        CPUSwap(&gbaCore.reg[R8_FIQ].I, &gbaCore.reg[8].I);
+        CPUSwap(&gbaCore.reg[R9_FIQ].I, &gbaCore.reg[9].I);
+        CPUSwap(&gbaCore.reg[R10_FIQ].I, &gbaCore.reg[10].I);
+        CPUSwap(&gbaCore.reg[R11_FIQ].I, &gbaCore.reg[11].I);
+        CPUSwap(&gbaCore.reg[R12_FIQ].I, &gbaCore.reg[12].I);
+        gbaCore.reg[R13_FIQ].I = gbaCore.reg[13].I;
+        gbaCore.reg[R14_FIQ].I = gbaCore.reg[14].I;
+        gbaCore.reg[SPSR_FIQ].I = gbaCore.reg[17].I;
         break;
     case 0x12:
-        reg[R13_IRQ].I = reg[13].I;
-        reg[R14_IRQ].I = reg[14].I;
-        reg[SPSR_IRQ].I = reg[17].I;
+        gbaCore.reg[R13_IRQ].I = gbaCore.reg[13].I;
+        gbaCore.reg[R14_IRQ].I = gbaCore.reg[14].I;
+        gbaCore.reg[SPSR_IRQ].I = gbaCore.reg[17].I;
         break;
     case 0x13:
-        reg[R13_SVC].I = reg[13].I;
-        reg[R14_SVC].I = reg[14].I;
-        reg[SPSR_SVC].I = reg[17].I;
+        gbaCore.reg[R13_SVC].I = gbaCore.reg[13].I;
+        gbaCore.reg[R14_SVC].I = gbaCore.reg[14].I;
+        gbaCore.reg[SPSR_SVC].I = gbaCore.reg[17].I;
         break;
     case 0x17:
-        reg[R13_ABT].I = reg[13].I;
-        reg[R14_ABT].I = reg[14].I;
-        reg[SPSR_ABT].I = reg[17].I;
+        gbaCore.reg[R13_ABT].I = gbaCore.reg[13].I;
+        gbaCore.reg[R14_ABT].I = gbaCore.reg[14].I;
+        gbaCore.reg[SPSR_ABT].I = gbaCore.reg[17].I;
         break;
     case 0x1b:
-        reg[R13_UND].I = reg[13].I;
-        reg[R14_UND].I = reg[14].I;
-        reg[SPSR_UND].I = reg[17].I;
+        gbaCore.reg[R13_UND].I = gbaCore.reg[13].I;
+        gbaCore.reg[R14_UND].I = gbaCore.reg[14].I;
+        gbaCore.reg[SPSR_UND].I = gbaCore.reg[17].I;
         break;
     }
 
-    uint32_t CPSR = reg[16].I;
-    uint32_t SPSR = reg[17].I;
+    uint32_t CPSR = gbaCore.reg[16].I;
+    uint32_t SPSR = gbaCore.reg[17].I;
 
     switch (mode) {
     case 0x10:
     case 0x1F:
-        reg[13].I = reg[R13_USR].I;
-        reg[14].I = reg[R14_USR].I;
-        reg[16].I = SPSR;
+        gbaCore.reg[13].I = gbaCore.reg[R13_USR].I;
+        gbaCore.reg[14].I = gbaCore.reg[R14_USR].I;
+        gbaCore.reg[16].I = SPSR;
         break;
     case 0x11:
-        CPUSwap(&reg[8].I, &reg[R8_FIQ].I);
-        CPUSwap(&reg[9].I, &reg[R9_FIQ].I);
-        CPUSwap(&reg[10].I, &reg[R10_FIQ].I);
-        CPUSwap(&reg[11].I, &reg[R11_FIQ].I);
-        CPUSwap(&reg[12].I, &reg[R12_FIQ].I);
-        reg[13].I = reg[R13_FIQ].I;
-        reg[14].I = reg[R14_FIQ].I;
-        reg[16].I = SPSR;
+        CPUSwap(&gbaCore.reg[8].I, &gbaCore.reg[R8_FIQ].I);
+        CPUSwap(&gbaCore.reg[9].I, &gbaCore.reg[R9_FIQ].I);
+        CPUSwap(&gbaCore.reg[10].I, &gbaCore.reg[R10_FIQ].I);
+        CPUSwap(&gbaCore.reg[11].I, &gbaCore.reg[R11_FIQ].I);
+        CPUSwap(&gbaCore.reg[12].I, &gbaCore.reg[R12_FIQ].I);
+        gbaCore.reg[13].I = gbaCore.reg[R13_FIQ].I;
+        gbaCore.reg[14].I = gbaCore.reg[R14_FIQ].I;
+        gbaCore.reg[16].I = SPSR;
         if (saveState)
-            reg[17].I = CPSR;
+            gbaCore.reg[17].I = CPSR;
         else
-            reg[17].I = reg[SPSR_FIQ].I;
+            gbaCore.reg[17].I = gbaCore.reg[SPSR_FIQ].I;
         break;
     case 0x12:
-        reg[13].I = reg[R13_IRQ].I;
-        reg[14].I = reg[R14_IRQ].I;
-        reg[16].I = SPSR;
+        gbaCore.reg[13].I = gbaCore.reg[R13_IRQ].I;
+        gbaCore.reg[14].I = gbaCore.reg[R14_IRQ].I;
+        gbaCore.reg[16].I = SPSR;
         if (saveState)
-            reg[17].I = CPSR;
+            gbaCore.reg[17].I = CPSR;
         else
-            reg[17].I = reg[SPSR_IRQ].I;
+            gbaCore.reg[17].I = gbaCore.reg[SPSR_IRQ].I;
         break;
     case 0x13:
-        reg[13].I = reg[R13_SVC].I;
-        reg[14].I = reg[R14_SVC].I;
-        reg[16].I = SPSR;
+        gbaCore.reg[13].I = gbaCore.reg[R13_SVC].I;
+        gbaCore.reg[14].I = gbaCore.reg[R14_SVC].I;
+        gbaCore.reg[16].I = SPSR;
         if (saveState)
-            reg[17].I = CPSR;
+            gbaCore.reg[17].I = CPSR;
         else
-            reg[17].I = reg[SPSR_SVC].I;
+            gbaCore.reg[17].I = gbaCore.reg[SPSR_SVC].I;
         break;
     case 0x17:
-        reg[13].I = reg[R13_ABT].I;
-        reg[14].I = reg[R14_ABT].I;
-        reg[16].I = SPSR;
+        gbaCore.reg[13].I = gbaCore.reg[R13_ABT].I;
+        gbaCore.reg[14].I = gbaCore.reg[R14_ABT].I;
+        gbaCore.reg[16].I = SPSR;
         if (saveState)
-            reg[17].I = CPSR;
+            gbaCore.reg[17].I = CPSR;
         else
-            reg[17].I = reg[SPSR_ABT].I;
+            gbaCore.reg[17].I = gbaCore.reg[SPSR_ABT].I;
         break;
     case 0x1b:
-        reg[13].I = reg[R13_UND].I;
-        reg[14].I = reg[R14_UND].I;
-        reg[16].I = SPSR;
+        gbaCore.reg[13].I = gbaCore.reg[R13_UND].I;
+        gbaCore.reg[14].I = gbaCore.reg[R14_UND].I;
+        gbaCore.reg[16].I = SPSR;
         if (saveState)
-            reg[17].I = CPSR;
+            gbaCore.reg[17].I = CPSR;
         else
-            reg[17].I = reg[SPSR_UND].I;
+            gbaCore.reg[17].I = gbaCore.reg[SPSR_UND].I;
         break;
     default:
         systemMessage(MSG_UNSUPPORTED_ARM_MODE, N_("Unsupported ARM mode %02x"), mode);
         break;
     }
-    armMode = mode;
+    gbaCore.armMode = mode;
     CPUUpdateFlags(breakLoop);
     CPUUpdateCPSR();
 }
@@ -1994,50 +1947,49 @@ void CPUSwitchMode(int mode, bool saveState)
 
 void CPUUndefinedException()
 {
-    uint32_t PC = reg[15].I;
-    bool savedArmState = armState;
+    uint32_t PC = gbaCore.reg[15].I;
+    bool savedArmState = gbaCore.armState;
     CPUSwitchMode(0x1b, true, false);
-    reg[14].I = PC - (savedArmState ? 4 : 2);
-    reg[15].I = 0x04;
-    armState = true;
-    armIrqEnable = false;
-    armNextPC = 0x04;
+    gbaCore.reg[14].I = PC - (savedArmState ? 4 : 2);
+    gbaCore.reg[15].I = 0x04;
+    gbaCore.armState = true;
+    gbaCore.armIrqEnable = false;
+    gbaCore.armNextPC = 0x04;
     ARM_PREFETCH;
-    reg[15].I += 4;
+    gbaCore.reg[15].I += 4;
 }
 
 void CPUSoftwareInterrupt()
 {
-    uint32_t PC = reg[15].I;
-    bool savedArmState = armState;
+    uint32_t PC = gbaCore.reg[15].I;
+    bool savedArmState = gbaCore.armState;
     CPUSwitchMode(0x13, true, false);
-    reg[14].I = PC - (savedArmState ? 4 : 2);
-    reg[15].I = 0x08;
-    armState = true;
-    armIrqEnable = false;
-    armNextPC = 0x08;
+    gbaCore.reg[14].I = PC - (savedArmState ? 4 : 2);
+    gbaCore.reg[15].I = 0x08;
+    gbaCore.armState = true;
+    gbaCore.armIrqEnable = false;
+    gbaCore.armNextPC = 0x08;
     ARM_PREFETCH;
-    reg[15].I += 4;
+    gbaCore.reg[15].I += 4;
 }
 
 void CPUSoftwareInterrupt(int comment)
 {
-    static bool disableMessage = false;
-    if (armState)
+    if (gbaCore.armState)
         comment >>= 16;
 #ifdef VBAM_ENABLE_DEBUGGER
     if (comment == 0xff) {
-        dbgOutput(NULL, reg[0].I);
+        dbgOutput(NULL, gbaCore.reg[0].I);
         return;
     }
 #endif
 #ifdef PROFILING
     if (comment == 0xfe) {
-        profStartup(reg[0].I, reg[1].I);
+        profStartup(gbaCore.reg[0].I, gbaCore.reg[1].I);
         return;
     }
     if (comment == 0xfd) {
-        profControl(reg[0].I);
+        profControl(gbaCore.reg[0].I);
         return;
     }
     if (comment == 0xfc) {
@@ -2056,8 +2008,8 @@ void CPUSoftwareInterrupt(int comment)
 #ifdef SDL
     if (comment == 0xf9) {
         emulating = 0;
-        cpuNextEvent = cpuTotalTicks;
-        cpuBreakLoop = true;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
+        gbaCore.cpuBreakLoop = true;
         return;
     }
 #endif
@@ -2065,11 +2017,11 @@ void CPUSoftwareInterrupt(int comment)
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("SWI: %08x at %08x (0x%08x,0x%08x,0x%08x,VCOUNT = %2d)\n", comment,
-                armState ? armNextPC - 4 : armNextPC - 2,
-                reg[0].I,
-                reg[1].I,
-                reg[2].I,
-                VCOUNT);
+                gbaCore.armState ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2,
+                gbaCore.reg[0].I,
+                gbaCore.reg[1].I,
+                gbaCore.reg[2].I,
+                gbaCore.VCOUNT);
         }
 #endif
         if ((comment & 0xF8) != 0xE0) {
@@ -2100,32 +2052,32 @@ void CPUSoftwareInterrupt(int comment)
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("Halt: (VCOUNT = %2d)\n",
-                VCOUNT);
+                gbaCore.VCOUNT);
         }
 #endif
-        holdState = true;
-        holdType = -1;
-        cpuNextEvent = cpuTotalTicks;
+        gbaCore.holdState = true;
+        gbaCore.holdType = -1;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x03:
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("Stop: (VCOUNT = %2d)\n",
-                VCOUNT);
+                gbaCore.VCOUNT);
         }
 #endif
-        holdState = true;
-        holdType = -1;
-        stopState = true;
-        cpuNextEvent = cpuTotalTicks;
+        gbaCore.holdState = true;
+        gbaCore.holdType = -1;
+        gbaCore.stopState = true;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x04:
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("IntrWait: 0x%08x,0x%08x (VCOUNT = %2d)\n",
-                reg[0].I,
-                reg[1].I,
-                VCOUNT);
+                gbaCore.reg[0].I,
+                gbaCore.reg[1].I,
+                gbaCore.VCOUNT);
         }
 #endif
         CPUSoftwareInterrupt();
@@ -2134,7 +2086,7 @@ void CPUSoftwareInterrupt(int comment)
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("VBlankIntrWait: (VCOUNT = %2d)\n",
-                VCOUNT);
+                gbaCore.VCOUNT);
         }
 #endif
         CPUSoftwareInterrupt();
@@ -2155,30 +2107,30 @@ void CPUSoftwareInterrupt(int comment)
         BIOS_ArcTan2();
         break;
     case 0x0B: {
-        int len = (reg[2].I & 0x1FFFFF) >> 1;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + len) & 0xe000000) == 0)) {
-            if ((reg[2].I >> 24) & 1) {
-                if ((reg[2].I >> 26) & 1)
-                    SWITicks = (7 + memoryWait32[(reg[1].I >> 24) & 0xF]) * (len >> 1);
+        int len = (gbaCore.reg[2].I & 0x1FFFFF) >> 1;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + len) & 0xe000000) == 0)) {
+            if ((gbaCore.reg[2].I >> 24) & 1) {
+                if ((gbaCore.reg[2].I >> 26) & 1)
+                    gbaCore.SWITicks = (7 + gbaCore.memoryWait32[(gbaCore.reg[1].I >> 24) & 0xF]) * (len >> 1);
                 else
-                    SWITicks = (8 + memoryWait[(reg[1].I >> 24) & 0xF]) * (len);
+                    gbaCore.SWITicks = (8 + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * (len);
             } else {
-                if ((reg[2].I >> 26) & 1)
-                    SWITicks = (10 + memoryWait32[(reg[0].I >> 24) & 0xF] + memoryWait32[(reg[1].I >> 24) & 0xF]) * (len >> 1);
+                if ((gbaCore.reg[2].I >> 26) & 1)
+                    gbaCore.SWITicks = (10 + gbaCore.memoryWait32[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWait32[(gbaCore.reg[1].I >> 24) & 0xF]) * (len >> 1);
                 else
-                    SWITicks = (11 + memoryWait[(reg[0].I >> 24) & 0xF] + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+                    gbaCore.SWITicks = (11 + gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
             }
         }
     }
         BIOS_CpuSet();
         break;
     case 0x0C: {
-        int len = (reg[2].I & 0x1FFFFF) >> 5;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + len) & 0xe000000) == 0)) {
-            if ((reg[2].I >> 24) & 1)
-                SWITicks = (6 + memoryWait32[(reg[1].I >> 24) & 0xF] + 7 * (memoryWaitSeq32[(reg[1].I >> 24) & 0xF] + 1)) * len;
+        int len = (gbaCore.reg[2].I & 0x1FFFFF) >> 5;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + len) & 0xe000000) == 0)) {
+            if ((gbaCore.reg[2].I >> 24) & 1)
+                gbaCore.SWITicks = (6 + gbaCore.memoryWait32[(gbaCore.reg[1].I >> 24) & 0xF] + 7 * (gbaCore.memoryWaitSeq32[(gbaCore.reg[1].I >> 24) & 0xF] + 1)) * len;
             else
-                SWITicks = (9 + memoryWait32[(reg[0].I >> 24) & 0xF] + memoryWait32[(reg[1].I >> 24) & 0xF] + 7 * (memoryWaitSeq32[(reg[0].I >> 24) & 0xF] + memoryWaitSeq32[(reg[1].I >> 24) & 0xF] + 2)) * len;
+                gbaCore.SWITicks = (9 + gbaCore.memoryWait32[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWait32[(gbaCore.reg[1].I >> 24) & 0xF] + 7 * (gbaCore.memoryWaitSeq32[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWaitSeq32[(gbaCore.reg[1].I >> 24) & 0xF] + 2)) * len;
         }
     }
         BIOS_CpuFastSet();
@@ -2193,65 +2145,65 @@ void CPUSoftwareInterrupt(int comment)
         BIOS_ObjAffineSet();
         break;
     case 0x10: {
-        int len = CPUReadHalfWord(reg[2].I);
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + len) & 0xe000000) == 0))
-            SWITicks = (32 + memoryWait[(reg[0].I >> 24) & 0xF]) * len;
+        int len = CPUReadHalfWord(gbaCore.reg[2].I);
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + len) & 0xe000000) == 0))
+            gbaCore.SWITicks = (32 + gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF]) * len;
     }
         BIOS_BitUnPack();
         break;
     case 0x11: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 8;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (9 + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 8;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (9 + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_LZ77UnCompWram();
         break;
     case 0x12: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 8;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (19 + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 8;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (19 + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_LZ77UnCompVram();
         break;
     case 0x13: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 8;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (29 + (memoryWait[(reg[0].I >> 24) & 0xF] << 1)) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 8;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (29 + (gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] << 1)) * len;
     }
         BIOS_HuffUnComp();
         break;
     case 0x14: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 8;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (11 + memoryWait[(reg[0].I >> 24) & 0xF] + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 8;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (11 + gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_RLUnCompWram();
         break;
     case 0x15: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 9;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (34 + (memoryWait[(reg[0].I >> 24) & 0xF] << 1) + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 9;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (34 + (gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] << 1) + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_RLUnCompVram();
         break;
     case 0x16: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 8;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (13 + memoryWait[(reg[0].I >> 24) & 0xF] + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 8;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (13 + gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_Diff8bitUnFilterWram();
         break;
     case 0x17: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 9;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (39 + (memoryWait[(reg[0].I >> 24) & 0xF] << 1) + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 9;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (39 + (gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] << 1) + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_Diff8bitUnFilterVram();
         break;
     case 0x18: {
-        uint32_t len = CPUReadMemory(reg[0].I) >> 9;
-        if (!(((reg[0].I & 0xe000000) == 0) || ((reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
-            SWITicks = (13 + memoryWait[(reg[0].I >> 24) & 0xF] + memoryWait[(reg[1].I >> 24) & 0xF]) * len;
+        uint32_t len = CPUReadMemory(gbaCore.reg[0].I) >> 9;
+        if (!(((gbaCore.reg[0].I & 0xe000000) == 0) || ((gbaCore.reg[0].I + (len & 0x1fffff)) & 0xe000000) == 0))
+            gbaCore.SWITicks = (13 + gbaCore.memoryWait[(gbaCore.reg[0].I >> 24) & 0xF] + gbaCore.memoryWait[(gbaCore.reg[1].I >> 24) & 0xF]) * len;
     }
         BIOS_Diff16bitUnFilter();
         break;
@@ -2259,30 +2211,30 @@ void CPUSoftwareInterrupt(int comment)
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("SoundBiasSet: 0x%08x (VCOUNT = %2d)\n",
-                reg[0].I,
-                VCOUNT);
+                gbaCore.reg[0].I,
+                gbaCore.VCOUNT);
         }
 #endif
-        if (reg[0].I)
+        if (gbaCore.reg[0].I)
             soundPause();
         else
             soundResume();
         break;
     case 0x1A:
         BIOS_SndDriverInit();
-        SWITicks = 252000;
+        gbaCore.SWITicks = 252000;
         break;
     case 0x1B:
         BIOS_SndDriverMode();
-        SWITicks = 280000;
+        gbaCore.SWITicks = 280000;
         break;
     case 0x1C:
         BIOS_SndDriverMain();
-        SWITicks = 11050; //avg
+        gbaCore.SWITicks = 11050; //avg
         break;
     case 0x1D:
         BIOS_SndDriverVSync();
-        SWITicks = 44;
+        gbaCore.SWITicks = 44;
         break;
     case 0x1E:
         BIOS_SndChannelClear();
@@ -2315,20 +2267,20 @@ void CPUSoftwareInterrupt(int comment)
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_SWI) {
             log("SWI: %08x at %08x (0x%08x,0x%08x,0x%08x,VCOUNT = %2d)\n", comment,
-                armState ? armNextPC - 4 : armNextPC - 2,
-                reg[0].I,
-                reg[1].I,
-                reg[2].I,
-                VCOUNT);
+                gbaCore.armState ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2,
+                gbaCore.reg[0].I,
+                gbaCore.reg[1].I,
+                gbaCore.reg[2].I,
+                gbaCore.VCOUNT);
         }
 #endif
 
-        if (!disableMessage) {
+        if (!gbaCore.disableMessage) {
             systemMessage(MSG_UNSUPPORTED_BIOS_FUNCTION,
                 N_("Unsupported BIOS function %02x called from %08x. A BIOS file is needed in order to get correct behaviour."),
                 comment,
-                armMode ? armNextPC - 4 : armNextPC - 2);
-            disableMessage = true;
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
+            gbaCore.disableMessage = true;
         }
         break;
     }
@@ -2336,25 +2288,38 @@ void CPUSoftwareInterrupt(int comment)
 
 void CPUCompareVCOUNT()
 {
-    if (VCOUNT == (DISPSTAT >> 8)) {
-        DISPSTAT |= 4;
-        UPDATE_REG(0x04, DISPSTAT);
+    if (gbaCore.VCOUNT == (gbaCore.DISPSTAT >> 8)) {
+        gbaCore.DISPSTAT |= 4;
+        UPDATE_REG(0x04, gbaCore.DISPSTAT);
 
-        if (DISPSTAT & 0x20) {
-            IF |= 4;
-            UPDATE_REG(0x202, IF);
+        if (gbaCore.DISPSTAT & 0x20) {
+            gbaCore.IF |= 4;
+            UPDATE_REG(0x202, gbaCore.IF);
         }
     } else {
-        DISPSTAT &= 0xFFFB;
-        UPDATE_REG(0x4, DISPSTAT);
+        gbaCore.DISPSTAT &= 0xFFFB;
+        UPDATE_REG(0x4, gbaCore.DISPSTAT);
     }
-    if (layerEnableDelay > 0) {
-        layerEnableDelay--;
-        if (layerEnableDelay == 1)
-            coreOptions.layerEnable = coreOptions.layerSettings & DISPCNT;
+    if (gbaCore.layerEnableDelay > 0) {
+        gbaCore.layerEnableDelay--;
+        if (gbaCore.layerEnableDelay == 1)
+            coreOptions.layerEnable = coreOptions.layerSettings & gbaCore.DISPCNT;
     }
 }
 
+// Whether words written by a DMA to `d` can go to a sound FIFO as a block,
+// without going through CPUWriteMemory().
+static bool dmaToSoundFifo(uint32_t d, uint32_t di)
+{
+    if (di != 0 || ((d & ~3u) != 0x040000A0 && (d & ~3u) != 0x040000A4))
+        return false;
+#ifdef VBAM_ENABLE_DEBUGGER
+    if (gbaCore.map[4].breakPoints)
+        return false;
+#endif
+    return true;
+}
+
 void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int transfer32)
 {
     int sm = s >> 24;
@@ -2363,9 +2328,9 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
     int dw = 0;
     int sc = c;
 
-    cpuDmaRunning = true;
-    cpuDmaPC = reg[15].I;
-    cpuDmaCount = c;
+    gbaCore.cpuDmaRunning = true;
+    gbaCore.cpuDmaPC = gbaCore.reg[15].I;
+    gbaCore.cpuDmaCount = c;
     // This is done to get the correct waitstates.
     if (sm > 15)
         sm = 15;
@@ -2377,16 +2342,28 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
 
     if (transfer32) {
         s &= 0xFFFFFFFC;
-        if (s < 0x02000000 && (reg[15].I >> 24)) {
+        if (s < 0x02000000 && (gbaCore.reg[15].I >> 24)) {
             while (c != 0) {
                 CPUWriteMemory(d, 0);
                 d += di;
                 c--;
             }
+        } else if (dmaToSoundFifo(d, di)) {
+            // Sound DMA, 4 words at a time
+            uint32_t block[4];
+            while (c != 0) {
+                int n = 0;
+                for (; n < 4 && c != 0; n++, c--) {
+                    gbaCore.cpuDmaLast = CPUReadMemory(s);
+                    block[n] = gbaCore.cpuDmaLast;
+                    s += si;
+                }
+                soundWriteFifo(d & 0x3FC, block, n);
+            }
         } else {
             while (c != 0) {
-                cpuDmaLast = CPUReadMemory(s);
-                CPUWriteMemory(d, cpuDmaLast);
+                gbaCore.cpuDmaLast = CPUReadMemory(s);
+                CPUWriteMemory(d, gbaCore.cpuDmaLast);
                 d += di;
                 s += si;
                 c--;
@@ -2396,7 +2373,7 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
         s &= 0xFFFFFFFE;
         si = (int)si >> 1;
         di = (int)di >> 1;
-        if (s < 0x02000000 && (reg[15].I >> 24)) {
+        if (s < 0x02000000 && (gbaCore.reg[15].I >> 24)) {
             while (c != 0) {
                 CPUWriteHalfWord(d, 0);
                 d += di;
@@ -2404,9 +2381,9 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
             }
         } else {
             while (c != 0) {
-                cpuDmaLast = CPUReadHalfWord(s);
-                CPUWriteHalfWord(d, DowncastU16(cpuDmaLast));
-                cpuDmaLast |= (cpuDmaLast << 16);
+                gbaCore.cpuDmaLast = CPUReadHalfWord(s);
+                CPUWriteHalfWord(d, DowncastU16(gbaCore.cpuDmaLast));
+                gbaCore.cpuDmaLast |= (gbaCore.cpuDmaLast << 16);
                 d += di;
                 s += si;
                 c--;
@@ -2414,32 +2391,32 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
         }
     }
 
-    cpuDmaCount = 0;
+    gbaCore.cpuDmaCount = 0;
 
     int totalTicks = 0;
 
     if (transfer32) {
-        sw = 1 + memoryWaitSeq32[sm & 15];
-        dw = 1 + memoryWaitSeq32[dm & 15];
-        totalTicks = (sw + dw) * (sc - 1) + 6 + memoryWait32[sm & 15] + memoryWaitSeq32[dm & 15];
+        sw = 1 + gbaCore.memoryWaitSeq32[sm & 15];
+        dw = 1 + gbaCore.memoryWaitSeq32[dm & 15];
+        totalTicks = (sw + dw) * (sc - 1) + 6 + gbaCore.memoryWait32[sm & 15] + gbaCore.memoryWaitSeq32[dm & 15];
     } else {
-        sw = 1 + memoryWaitSeq[sm & 15];
-        dw = 1 + memoryWaitSeq[dm & 15];
-        totalTicks = (sw + dw) * (sc - 1) + 6 + memoryWait[sm & 15] + memoryWaitSeq[dm & 15];
+        sw = 1 + gbaCore.memoryWaitSeq[sm & 15];
+        dw = 1 + gbaCore.memoryWaitSeq[dm & 15];
+        totalTicks = (sw + dw) * (sc - 1) + 6 + gbaCore.memoryWait[sm & 15] + gbaCore.memoryWaitSeq[dm & 15];
     }
 
-    cpuDmaTicksToUpdate += totalTicks;
-    cpuDmaRunning = false;
+    gbaCore.cpuDmaTicksToUpdate += totalTicks;
+    gbaCore.cpuDmaRunning = false;
 }
 
 void CPUCheckDMA(int reason, int dmamask)
 {
     // DMA 0
-    if ((DM0CNT_H & 0x8000) && (dmamask & 1)) {
-        if (((DM0CNT_H >> 12) & 3) == reason) {
+    if ((gbaCore.DM0CNT_H & 0x8000) && (dmamask & 1)) {
+        if (((gbaCore.DM0CNT_H >> 12) & 3) == reason) {
             uint32_t sourceIncrement = 4;
             uint32_t destIncrement = 4;
-            switch ((DM0CNT_H >> 7) & 3) {
+            switch ((gbaCore.DM0CNT_H >> 7) & 3) {
             case 0:
                 break;
             case 1:
@@ -2449,7 +2426,7 @@ void CPUCheckDMA(int reason, int dmamask)
                 sourceIncrement = 0;
                 break;
             }
-            switch ((DM0CNT_H >> 5) & 3) {
+            switch ((gbaCore.DM0CNT_H >> 5) & 3) {
             case 0:
                 break;
             case 1:
@@ -2461,41 +2438,41 @@ void CPUCheckDMA(int reason, int dmamask)
             }
 #ifdef GBA_LOGGING
             if (systemVerbose & VERBOSE_DMA0) {
-                int count = (DM0CNT_L ? DM0CNT_L : 0x4000) << 1;
-                if (DM0CNT_H & 0x0400)
+                int count = (gbaCore.DM0CNT_L ? gbaCore.DM0CNT_L : 0x4000) << 1;
+                if (gbaCore.DM0CNT_H & 0x0400)
                     count <<= 1;
-                log("DMA0: s=%08x d=%08x c=%04x count=%08x\n", dma0Source, dma0Dest,
-                    DM0CNT_H,
+                log("DMA0: s=%08x d=%08x c=%04x count=%08x\n", gbaCore.dma0Source, gbaCore.dma0Dest,
+                    gbaCore.DM0CNT_H,
                     count);
             }
 #endif
-            doDMA(dma0Source, dma0Dest, sourceIncrement, destIncrement,
-                DM0CNT_L ? DM0CNT_L : 0x4000,
-                DM0CNT_H & 0x0400);
-
-            if (DM0CNT_H & 0x4000) {
-                IF |= 0x0100;
-                UPDATE_REG(0x202, IF);
-                cpuNextEvent = cpuTotalTicks;
+            doDMA(gbaCore.dma0Source, gbaCore.dma0Dest, sourceIncrement, destIncrement,
+                gbaCore.DM0CNT_L ? gbaCore.DM0CNT_L : 0x4000,
+                gbaCore.DM0CNT_H & 0x0400);
+
+            if (gbaCore.DM0CNT_H & 0x4000) {
+                gbaCore.IF |= 0x0100;
+                UPDATE_REG(0x202, gbaCore.IF);
+                gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
             }
 
-            if (((DM0CNT_H >> 5) & 3) == 3) {
-                dma0Dest = DM0DAD_L | (DM0DAD_H << 16);
+            if (((gbaCore.DM0CNT_H >> 5) & 3) == 3) {
+                gbaCore.dma0Dest = gbaCore.DM0DAD_L | (gbaCore.DM0DAD_H << 16);
             }
 
-            if (!(DM0CNT_H & 0x0200) || (reason == 0)) {
-                DM0CNT_H &= 0x7FFF;
-                UPDATE_REG(0xBA, DM0CNT_H);
+            if (!(gbaCore.DM0CNT_H & 0x0200) || (reason == 0)) {
+                gbaCore.DM0CNT_H &= 0x7FFF;
+                UPDATE_REG(0xBA, gbaCore.DM0CNT_H);
             }
         }
     }
 
     // DMA 1
-    if ((DM1CNT_H & 0x8000) && (dmamask & 2)) {
-        if (((DM1CNT_H >> 12) & 3) == reason) {
+    if ((gbaCore.DM1CNT_H & 0x8000) && (dmamask & 2)) {
+        if (((gbaCore.DM1CNT_H >> 12) & 3) == reason) {
             uint32_t sourceIncrement = 4;
             uint32_t destIncrement = 4;
-            switch ((DM1CNT_H >> 7) & 3) {
+            switch ((gbaCore.DM1CNT_H >> 7) & 3) {
             case 0:
                 break;
             case 1:
@@ -2505,7 +2482,7 @@ void CPUCheckDMA(int reason, int dmamask)
                 sourceIncrement = 0;
                 break;
             }
-            switch ((DM1CNT_H >> 5) & 3) {
+            switch ((gbaCore.DM1CNT_H >> 5) & 3) {
             case 0:
                 break;
             case 1:
@@ -2518,52 +2495,52 @@ void CPUCheckDMA(int reason, int dmamask)
             if (reason == 3) {
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_DMA1) {
-                    log("DMA1: s=%08x d=%08x c=%04x count=%08x\n", dma1Source, dma1Dest,
-                        DM1CNT_H,
+                    log("DMA1: s=%08x d=%08x c=%04x count=%08x\n", gbaCore.dma1Source, gbaCore.dma1Dest,
+                        gbaCore.DM1CNT_H,
                         16);
                 }
 #endif
-                doDMA(dma1Source, dma1Dest, sourceIncrement, 0, 4,
+                doDMA(gbaCore.dma1Source, gbaCore.dma1Dest, sourceIncrement, 0, 4,
                     0x0400);
             } else {
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_DMA1) {
-                    int count = (DM1CNT_L ? DM1CNT_L : 0x4000) << 1;
-                    if (DM1CNT_H & 0x0400)
+                    int count = (gbaCore.DM1CNT_L ? gbaCore.DM1CNT_L : 0x4000) << 1;
+                    if (gbaCore.DM1CNT_H & 0x0400)
                         count <<= 1;
-                    log("DMA1: s=%08x d=%08x c=%04x count=%08x\n", dma1Source, dma1Dest,
-                        DM1CNT_H,
+                    log("DMA1: s=%08x d=%08x c=%04x count=%08x\n", gbaCore.dma1Source, gbaCore.dma1Dest,
+                        gbaCore.DM1CNT_H,
                         count);
                 }
 #endif
-                doDMA(dma1Source, dma1Dest, sourceIncrement, destIncrement,
-                    DM1CNT_L ? DM1CNT_L : 0x4000,
-                    DM1CNT_H & 0x0400);
+                doDMA(gbaCore.dma1Source, gbaCore.dma1Dest, sourceIncrement, destIncrement,
+                    gbaCore.DM1CNT_L ? gbaCore.DM1CNT_L : 0x4000,
+                    gbaCore.DM1CNT_H & 0x0400);
             }
 
-            if (DM1CNT_H & 0x4000) {
-                IF |= 0x0200;
-                UPDATE_REG(0x202, IF);
-                cpuNextEvent = cpuTotalTicks;
+            if (gbaCore.DM1CNT_H & 0x4000) {
+                gbaCore.IF |= 0x0200;
+                UPDATE_REG(0x202, gbaCore.IF);
+                gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
             }
 
-            if (((DM1CNT_H >> 5) & 3) == 3) {
-                dma1Dest = DM1DAD_L | (DM1DAD_H << 16);
+            if (((gbaCore.DM1CNT_H >> 5) & 3) == 3) {
+                gbaCore.dma1Dest = gbaCore.DM1DAD_L | (gbaCore.DM1DAD_H << 16);
             }
 
-            if (!(DM1CNT_H & 0x0200) || (reason == 0)) {
-                DM1CNT_H &= 0x7FFF;
-                UPDATE_REG(0xC6, DM1CNT_H);
+            if (!(gbaCore.DM1CNT_H & 0x0200) || (reason == 0)) {
+                gbaCore.DM1CNT_H &= 0x7FFF;
+                UPDATE_REG(0xC6, gbaCore.DM1CNT_H);
             }
         }
     }
 
     // DMA 2
-    if ((DM2CNT_H & 0x8000) && (dmamask & 4)) {
-        if (((DM2CNT_H >> 12) & 3) == reason) {
+    if ((gbaCore.DM2CNT_H & 0x8000) && (dmamask & 4)) {
+        if (((gbaCore.DM2CNT_H >> 12) & 3) == reason) {
             uint32_t sourceIncrement = 4;
             uint32_t destIncrement = 4;
-            switch ((DM2CNT_H >> 7) & 3) {
+            switch ((gbaCore.DM2CNT_H >> 7) & 3) {
             case 0:
                 break;
             case 1:
@@ -2573,7 +2550,7 @@ void CPUCheckDMA(int reason, int dmamask)
                 sourceIncrement = 0;
                 break;
             }
-            switch ((DM2CNT_H >> 5) & 3) {
+            switch ((gbaCore.DM2CNT_H >> 5) & 3) {
             case 0:
                 break;
             case 1:
@@ -2587,52 +2564,52 @@ void CPUCheckDMA(int reason, int dmamask)
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_DMA2) {
                     int count = (4) << 2;
-                    log("DMA2: s=%08x d=%08x c=%04x count=%08x\n", dma2Source, dma2Dest,
-                        DM2CNT_H,
+                    log("DMA2: s=%08x d=%08x c=%04x count=%08x\n", gbaCore.dma2Source, gbaCore.dma2Dest,
+                        gbaCore.DM2CNT_H,
                         count);
                 }
 #endif
-                doDMA(dma2Source, dma2Dest, sourceIncrement, 0, 4,
+                doDMA(gbaCore.dma2Source, gbaCore.dma2Dest, sourceIncrement, 0, 4,
                     0x0400);
             } else {
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_DMA2) {
-                    int count = (DM2CNT_L ? DM2CNT_L : 0x4000) << 1;
-                    if (DM2CNT_H & 0x0400)
+                    int count = (gbaCore.DM2CNT_L ? gbaCore.DM2CNT_L : 0x4000) << 1;
+                    if (gbaCore.DM2CNT_H & 0x0400)
                         count <<= 1;
-                    log("DMA2: s=%08x d=%08x c=%04x count=%08x\n", dma2Source, dma2Dest,
-                        DM2CNT_H,
+                    log("DMA2: s=%08x d=%08x c=%04x count=%08x\n", gbaCore.dma2Source, gbaCore.dma2Dest,
+                        gbaCore.DM2CNT_H,
                         count);
                 }
 #endif
-                doDMA(dma2Source, dma2Dest, sourceIncrement, destIncrement,
-                    DM2CNT_L ? DM2CNT_L : 0x4000,
-                    DM2CNT_H & 0x0400);
+                doDMA(gbaCore.dma2Source, gbaCore.dma2Dest, sourceIncrement, destIncrement,
+                    gbaCore.DM2CNT_L ? gbaCore.DM2CNT_L : 0x4000,
+                    gbaCore.DM2CNT_H & 0x0400);
             }
 
-            if (DM2CNT_H & 0x4000) {
-                IF |= 0x0400;
-                UPDATE_REG(0x202, IF);
-                cpuNextEvent = cpuTotalTicks;
+            if (gbaCore.DM2CNT_H & 0x4000) {
+                gbaCore.IF |= 0x0400;
+                UPDATE_REG(0x202, gbaCore.IF);
+                gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
             }
 
-            if (((DM2CNT_H >> 5) & 3) == 3) {
-                dma2Dest = DM2DAD_L | (DM2DAD_H << 16);
+            if (((gbaCore.DM2CNT_H >> 5) & 3) == 3) {
+                gbaCore.dma2Dest = gbaCore.DM2DAD_L | (gbaCore.DM2DAD_H << 16);
             }
 
-            if (!(DM2CNT_H & 0x0200) || (reason == 0)) {
-                DM2CNT_H &= 0x7FFF;
-                UPDATE_REG(0xD2, DM2CNT_H);
+            if (!(gbaCore.DM2CNT_H & 0x0200) || (reason == 0)) {
+                gbaCore.DM2CNT_H &= 0x7FFF;
+                UPDATE_REG(0xD2, gbaCore.DM2CNT_H);
             }
         }
     }
 
     // DMA 3
-    if ((DM3CNT_H & 0x8000) && (dmamask & 8)) {
-        if (((DM3CNT_H >> 12) & 3) == reason) {
+    if ((gbaCore.DM3CNT_H & 0x8000) && (dmamask & 8)) {
+        if (((gbaCore.DM3CNT_H >> 12) & 3) == reason) {
             uint32_t sourceIncrement = 4;
             uint32_t destIncrement = 4;
-            switch ((DM3CNT_H >> 7) & 3) {
+            switch ((gbaCore.DM3CNT_H >> 7) & 3) {
             case 0:
                 break;
             case 1:
@@ -2642,7 +2619,7 @@ void CPUCheckDMA(int reason, int dmamask)
                 sourceIncrement = 0;
                 break;
             }
-            switch ((DM3CNT_H >> 5) & 3) {
+            switch ((gbaCore.DM3CNT_H >> 5) & 3) {
             case 0:
                 break;
             case 1:
@@ -2654,31 +2631,31 @@ void CPUCheckDMA(int reason, int dmamask)
             }
 #ifdef GBA_LOGGING
             if (systemVerbose & VERBOSE_DMA3) {
-                int count = (DM3CNT_L ? DM3CNT_L : 0x10000) << 1;
-                if (DM3CNT_H & 0x0400)
+                int count = (gbaCore.DM3CNT_L ? gbaCore.DM3CNT_L : 0x10000) << 1;
+                if (gbaCore.DM3CNT_H & 0x0400)
                     count <<= 1;
-                log("DMA3: s=%08x d=%08x c=%04x count=%08x\n", dma3Source, dma3Dest,
-                    DM3CNT_H,
+                log("DMA3: s=%08x d=%08x c=%04x count=%08x\n", gbaCore.dma3Source, gbaCore.dma3Dest,
+                    gbaCore.DM3CNT_H,
                     count);
             }
 #endif
-            doDMA(dma3Source, dma3Dest, sourceIncrement, destIncrement,
-                DM3CNT_L ? DM3CNT_L : 0x10000,
-                DM3CNT_H & 0x0400);
-
-            if (DM3CNT_H & 0x4000) {
-                IF |= 0x0800;
-                UPDATE_REG(0x202, IF);
-                cpuNextEvent = cpuTotalTicks;
+            doDMA(gbaCore.dma3Source, gbaCore.dma3Dest, sourceIncrement, destIncrement,
+                gbaCore.DM3CNT_L ? gbaCore.DM3CNT_L : 0x10000,
+                gbaCore.DM3CNT_H & 0x0400);
+
+            if (gbaCore.DM3CNT_H & 0x4000) {
+                gbaCore.IF |= 0x0800;
+                UPDATE_REG(0x202, gbaCore.IF);
+                gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
             }
 
-            if (((DM3CNT_H >> 5) & 3) == 3) {
-                dma3Dest = DM3DAD_L | (DM3DAD_H << 16);
+            if (((gbaCore.DM3CNT_H >> 5) & 3) == 3) {
+                gbaCore.dma3Dest = gbaCore.DM3DAD_L | (gbaCore.DM3DAD_H << 16);
             }
 
-            if (!(DM3CNT_H & 0x0200) || (reason == 0)) {
-                DM3CNT_H &= 0x7FFF;
-                UPDATE_REG(0xDE, DM3CNT_H);
+            if (!(gbaCore.DM3CNT_H & 0x0200) || (reason == 0)) {
+                gbaCore.DM3CNT_H &= 0x7FFF;
+                UPDATE_REG(0xDE, gbaCore.DM3CNT_H);
             }
         }
     }
@@ -2690,31 +2667,31 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
     case 0x00: { // we need to place the following code in { } because we declare & initialize variables in a case statement
         if ((value & 7) > 5) {
             // display modes above 0-5 are prohibited
-            DISPCNT = (value & 7);
+            gbaCore.DISPCNT = (value & 7);
         }
-        bool change = (0 != ((DISPCNT ^ value) & 0x80));
-        bool changeBG = (0 != ((DISPCNT ^ value) & 0x0F00));
-        uint16_t changeBGon = ((~DISPCNT) & value) & 0x0F00; // these layers are being activated
+        bool change = (0 != ((gbaCore.DISPCNT ^ value) & 0x80));
+        bool changeBG = (0 != ((gbaCore.DISPCNT ^ value) & 0x0F00));
+        uint16_t changeBGon = ((~gbaCore.DISPCNT) & value) & 0x0F00; // these layers are being activated
 
-        DISPCNT = (value & 0xFFF7); // bit 3 can only be accessed by the BIOS to enable GBC mode
-        UPDATE_REG(0x00, DISPCNT);
+        gbaCore.DISPCNT = (value & 0xFFF7); // bit 3 can only be accessed by the BIOS to enable GBC mode
+        UPDATE_REG(0x00, gbaCore.DISPCNT);
 
         if (changeBGon) {
-            layerEnableDelay = 4;
+            gbaCore.layerEnableDelay = 4;
             coreOptions.layerEnable = coreOptions.layerSettings & value & (~changeBGon);
         } else {
             coreOptions.layerEnable = coreOptions.layerSettings & value;
             // CPUUpdateTicks();
         }
 
-        windowOn = (coreOptions.layerEnable & 0x6000) ? true : false;
+        gbaCore.windowOn = (coreOptions.layerEnable & 0x6000) ? true : false;
         if (change && !((value & 0x80))) {
-            if (!(DISPSTAT & 1)) {
+            if (!(gbaCore.DISPSTAT & 1)) {
                 //lcdTicks = 1008;
                 //      VCOUNT = 0;
                 //      UPDATE_REG(0x06, VCOUNT);
-                DISPSTAT &= 0xFFFC;
-                UPDATE_REG(0x04, DISPSTAT);
+                gbaCore.DISPSTAT &= 0xFFFC;
+                UPDATE_REG(0x04, gbaCore.DISPSTAT);
                 CPUCompareVCOUNT();
             }
             //        (*renderLine)();
@@ -2727,175 +2704,175 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
         break;
     }
     case 0x04:
-        DISPSTAT = (value & 0xFF38) | (DISPSTAT & 7);
-        UPDATE_REG(0x04, DISPSTAT);
+        gbaCore.DISPSTAT = (value & 0xFF38) | (gbaCore.DISPSTAT & 7);
+        UPDATE_REG(0x04, gbaCore.DISPSTAT);
         break;
     case 0x06:
         // not writable
         break;
     case 0x08:
-        BG0CNT = (value & 0xDFCF);
-        UPDATE_REG(0x08, BG0CNT);
+        gbaCore.BG0CNT = (value & 0xDFCF);
+        UPDATE_REG(0x08, gbaCore.BG0CNT);
         break;
     case 0x0A:
-        BG1CNT = (value & 0xDFCF);
-        UPDATE_REG(0x0A, BG1CNT);
+        gbaCore.BG1CNT = (value & 0xDFCF);
+        UPDATE_REG(0x0A, gbaCore.BG1CNT);
         break;
     case 0x0C:
-        BG2CNT = (value & 0xFFCF);
-        UPDATE_REG(0x0C, BG2CNT);
+        gbaCore.BG2CNT = (value & 0xFFCF);
+        UPDATE_REG(0x0C, gbaCore.BG2CNT);
         break;
     case 0x0E:
-        BG3CNT = (value & 0xFFCF);
-        UPDATE_REG(0x0E, BG3CNT);
+        gbaCore.BG3CNT = (value & 0xFFCF);
+        UPDATE_REG(0x0E, gbaCore.BG3CNT);
         break;
     case 0x10:
-        BG0HOFS = value & 511;
-        UPDATE_REG(0x10, BG0HOFS);
+        gbaCore.BG0HOFS = value & 511;
+        UPDATE_REG(0x10, gbaCore.BG0HOFS);
         break;
     case 0x12:
-        BG0VOFS = value & 511;
-        UPDATE_REG(0x12, BG0VOFS);
+        gbaCore.BG0VOFS = value & 511;
+        UPDATE_REG(0x12, gbaCore.BG0VOFS);
         break;
     case 0x14:
-        BG1HOFS = value & 511;
-        UPDATE_REG(0x14, BG1HOFS);
+        gbaCore.BG1HOFS = value & 511;
+        UPDATE_REG(0x14, gbaCore.BG1HOFS);
         break;
     case 0x16:
-        BG1VOFS = value & 511;
-        UPDATE_REG(0x16, BG1VOFS);
+        gbaCore.BG1VOFS = value & 511;
+        UPDATE_REG(0x16, gbaCore.BG1VOFS);
         break;
     case 0x18:
-        BG2HOFS = value & 511;
-        UPDATE_REG(0x18, BG2HOFS);
+        gbaCore.BG2HOFS = value & 511;
+        UPDATE_REG(0x18, gbaCore.BG2HOFS);
         break;
     case 0x1A:
-        BG2VOFS = value & 511;
-        UPDATE_REG(0x1A, BG2VOFS);
+        gbaCore.BG2VOFS = value & 511;
+        UPDATE_REG(0x1A, gbaCore.BG2VOFS);
         break;
     case 0x1C:
-        BG3HOFS = value & 511;
-        UPDATE_REG(0x1C, BG3HOFS);
+        gbaCore.BG3HOFS = value & 511;
+        UPDATE_REG(0x1C, gbaCore.BG3HOFS);
         break;
     case 0x1E:
-        BG3VOFS = value & 511;
-        UPDATE_REG(0x1E, BG3VOFS);
+        gbaCore.BG3VOFS = value & 511;
+        UPDATE_REG(0x1E, gbaCore.BG3VOFS);
         break;
     case 0x20:
-        BG2PA = value;
-        UPDATE_REG(0x20, BG2PA);
+        gbaCore.BG2PA = value;
+        UPDATE_REG(0x20, gbaCore.BG2PA);
         break;
     case 0x22:
-        BG2PB = value;
-        UPDATE_REG(0x22, BG2PB);
+        gbaCore.BG2PB = value;
+        UPDATE_REG(0x22, gbaCore.BG2PB);
         break;
     case 0x24:
-        BG2PC = value;
-        UPDATE_REG(0x24, BG2PC);
+        gbaCore.BG2PC = value;
+        UPDATE_REG(0x24, gbaCore.BG2PC);
         break;
     case 0x26:
-        BG2PD = value;
-        UPDATE_REG(0x26, BG2PD);
+        gbaCore.BG2PD = value;
+        UPDATE_REG(0x26, gbaCore.BG2PD);
         break;
     case 0x28:
-        BG2X_L = value;
-        UPDATE_REG(0x28, BG2X_L);
-        gfxBG2Changed |= 1;
+        gbaCore.BG2X_L = value;
+        UPDATE_REG(0x28, gbaCore.BG2X_L);
+        gbaCore.gfxBG2Changed |= 1;
         break;
     case 0x2A:
-        BG2X_H = (value & 0xFFF);
-        UPDATE_REG(0x2A, BG2X_H);
-        gfxBG2Changed |= 1;
+        gbaCore.BG2X_H = (value & 0xFFF);
+        UPDATE_REG(0x2A, gbaCore.BG2X_H);
+        gbaCore.gfxBG2Changed |= 1;
         break;
     case 0x2C:
-        BG2Y_L = value;
-        UPDATE_REG(0x2C, BG2Y_L);
-        gfxBG2Changed |= 2;
+        gbaCore.BG2Y_L = value;
+        UPDATE_REG(0x2C, gbaCore.BG2Y_L);
+        gbaCore.gfxBG2Changed |= 2;
         break;
     case 0x2E:
-        BG2Y_H = value & 0xFFF;
-        UPDATE_REG(0x2E, BG2Y_H);
-        gfxBG2Changed |= 2;
+        gbaCore.BG2Y_H = value & 0xFFF;
+        UPDATE_REG(0x2E, gbaCore.BG2Y_H);
+        gbaCore.gfxBG2Changed |= 2;
         break;
     case 0x30:
-        BG3PA = value;
-        UPDATE_REG(0x30, BG3PA);
+        gbaCore.BG3PA = value;
+        UPDATE_REG(0x30, gbaCore.BG3PA);
         break;
     case 0x32:
-        BG3PB = value;
-        UPDATE_REG(0x32, BG3PB);
+        gbaCore.BG3PB = value;
+        UPDATE_REG(0x32, gbaCore.BG3PB);
         break;
     case 0x34:
-        BG3PC = value;
-        UPDATE_REG(0x34, BG3PC);
+        gbaCore.BG3PC = value;
+        UPDATE_REG(0x34, gbaCore.BG3PC);
         break;
     case 0x36:
-        BG3PD = value;
-        UPDATE_REG(0x36, BG3PD);
+        gbaCore.BG3PD = value;
+        UPDATE_REG(0x36, gbaCore.BG3PD);
         break;
     case 0x38:
-        BG3X_L = value;
-        UPDATE_REG(0x38, BG3X_L);
-        gfxBG3Changed |= 1;
+        gbaCore.BG3X_L = value;
+        UPDATE_REG(0x38, gbaCore.BG3X_L);
+        gbaCore.gfxBG3Changed |= 1;
         break;
     case 0x3A:
-        BG3X_H = value & 0xFFF;
-        UPDATE_REG(0x3A, BG3X_H);
-        gfxBG3Changed |= 1;
+        gbaCore.BG3X_H = value & 0xFFF;
+        UPDATE_REG(0x3A, gbaCore.BG3X_H);
+        gbaCore.gfxBG3Changed |= 1;
         break;
     case 0x3C:
-        BG3Y_L = value;
-        UPDATE_REG(0x3C, BG3Y_L);
-        gfxBG3Changed |= 2;
+        gbaCore.BG3Y_L = value;
+        UPDATE_REG(0x3C, gbaCore.BG3Y_L);
+        gbaCore.gfxBG3Changed |= 2;
         break;
     case 0x3E:
-        BG3Y_H = value & 0xFFF;
-        UPDATE_REG(0x3E, BG3Y_H);
-        gfxBG3Changed |= 2;
+        gbaCore.BG3Y_H = value & 0xFFF;
+        UPDATE_REG(0x3E, gbaCore.BG3Y_H);
+        gbaCore.gfxBG3Changed |= 2;
         break;
     case 0x40:
-        WIN0H = value;
-        UPDATE_REG(0x40, WIN0H);
+        gbaCore.WIN0H = value;
+        UPDATE_REG(0x40, gbaCore.WIN0H);
         CPUUpdateWindow0();
         break;
     case 0x42:
-        WIN1H = value;
-        UPDATE_REG(0x42, WIN1H);
+        gbaCore.WIN1H = value;
+        UPDATE_REG(0x42, gbaCore.WIN1H);
         CPUUpdateWindow1();
         break;
     case 0x44:
-        WIN0V = value;
-        UPDATE_REG(0x44, WIN0V);
+        gbaCore.WIN0V = value;
+        UPDATE_REG(0x44, gbaCore.WIN0V);
         break;
     case 0x46:
-        WIN1V = value;
-        UPDATE_REG(0x46, WIN1V);
+        gbaCore.WIN1V = value;
+        UPDATE_REG(0x46, gbaCore.WIN1V);
         break;
     case 0x48:
-        WININ = value & 0x3F3F;
-        UPDATE_REG(0x48, WININ);
+        gbaCore.WININ = value & 0x3F3F;
+        UPDATE_REG(0x48, gbaCore.WININ);
         break;
     case 0x4A:
-        WINOUT = value & 0x3F3F;
-        UPDATE_REG(0x4A, WINOUT);
+        gbaCore.WINOUT = value & 0x3F3F;
+        UPDATE_REG(0x4A, gbaCore.WINOUT);
         break;
     case 0x4C:
-        MOSAIC = value;
-        UPDATE_REG(0x4C, MOSAIC);
+        gbaCore.MOSAIC = value;
+        UPDATE_REG(0x4C, gbaCore.MOSAIC);
         break;
     case 0x50:
-        BLDMOD = value & 0x3FFF;
-        UPDATE_REG(0x50, BLDMOD);
-        fxOn = ((BLDMOD >> 6) & 3) != 0;
+        gbaCore.BLDMOD = value & 0x3FFF;
+        UPDATE_REG(0x50, gbaCore.BLDMOD);
+        gbaCore.fxOn = ((gbaCore.BLDMOD >> 6) & 3) != 0;
         CPUUpdateRender();
         break;
     case 0x52:
-        COLEV = value & 0x1F1F;
-        UPDATE_REG(0x52, COLEV);
+        gbaCore.COLEV = value & 0x1F1F;
+        UPDATE_REG(0x52, gbaCore.COLEV);
         break;
     case 0x54:
-        COLY = value & 0x1F;
-        UPDATE_REG(0x54, COLY);
+        gbaCore.COLY = value & 0x1F;
+        UPDATE_REG(0x54, gbaCore.COLY);
         break;
     case 0x60:
     case 0x62:
@@ -2929,188 +2906,188 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
         soundEvent16(address & 0xFF, value);
         break;
     case 0xB0:
-        DM0SAD_L = value;
-        UPDATE_REG(0xB0, DM0SAD_L);
+        gbaCore.DM0SAD_L = value;
+        UPDATE_REG(0xB0, gbaCore.DM0SAD_L);
         break;
     case 0xB2:
-        DM0SAD_H = value & 0x07FF;
-        UPDATE_REG(0xB2, DM0SAD_H);
+        gbaCore.DM0SAD_H = value & 0x07FF;
+        UPDATE_REG(0xB2, gbaCore.DM0SAD_H);
         break;
     case 0xB4:
-        DM0DAD_L = value;
-        UPDATE_REG(0xB4, DM0DAD_L);
+        gbaCore.DM0DAD_L = value;
+        UPDATE_REG(0xB4, gbaCore.DM0DAD_L);
         break;
     case 0xB6:
-        DM0DAD_H = value & 0x07FF;
-        UPDATE_REG(0xB6, DM0DAD_H);
+        gbaCore.DM0DAD_H = value & 0x07FF;
+        UPDATE_REG(0xB6, gbaCore.DM0DAD_H);
         break;
     case 0xB8:
-        DM0CNT_L = value & 0x3FFF;
+        gbaCore.DM0CNT_L = value & 0x3FFF;
         UPDATE_REG(0xB8, 0);
         break;
     case 0xBA: {
-        bool start = ((DM0CNT_H ^ value) & 0x8000) ? true : false;
+        bool start = ((gbaCore.DM0CNT_H ^ value) & 0x8000) ? true : false;
         value &= 0xF7E0;
 
-        DM0CNT_H = value;
-        UPDATE_REG(0xBA, DM0CNT_H);
+        gbaCore.DM0CNT_H = value;
+        UPDATE_REG(0xBA, gbaCore.DM0CNT_H);
 
         if (start && (value & 0x8000)) {
-            dma0Source = DM0SAD_L | (DM0SAD_H << 16);
-            dma0Dest = DM0DAD_L | (DM0DAD_H << 16);
+            gbaCore.dma0Source = gbaCore.DM0SAD_L | (gbaCore.DM0SAD_H << 16);
+            gbaCore.dma0Dest = gbaCore.DM0DAD_L | (gbaCore.DM0DAD_H << 16);
             CPUCheckDMA(0, 1);
         }
     } break;
     case 0xBC:
-        DM1SAD_L = value;
-        UPDATE_REG(0xBC, DM1SAD_L);
+        gbaCore.DM1SAD_L = value;
+        UPDATE_REG(0xBC, gbaCore.DM1SAD_L);
         break;
     case 0xBE:
-        DM1SAD_H = value & 0x0FFF;
-        UPDATE_REG(0xBE, DM1SAD_H);
+        gbaCore.DM1SAD_H = value & 0x0FFF;
+        UPDATE_REG(0xBE, gbaCore.DM1SAD_H);
         break;
     case 0xC0:
-        DM1DAD_L = value;
-        UPDATE_REG(0xC0, DM1DAD_L);
+        gbaCore.DM1DAD_L = value;
+        UPDATE_REG(0xC0, gbaCore.DM1DAD_L);
         break;
     case 0xC2:
-        DM1DAD_H = value & 0x07FF;
-        UPDATE_REG(0xC2, DM1DAD_H);
+        gbaCore.DM1DAD_H = value & 0x07FF;
+        UPDATE_REG(0xC2, gbaCore.DM1DAD_H);
         break;
     case 0xC4:
-        DM1CNT_L = value & 0x3FFF;
+        gbaCore.DM1CNT_L = value & 0x3FFF;
         UPDATE_REG(0xC4, 0);
         break;
     case 0xC6: {
-        bool start = ((DM1CNT_H ^ value) & 0x8000) ? true : false;
+        bool start = ((gbaCore.DM1CNT_H ^ value) & 0x8000) ? true : false;
         value &= 0xF7E0;
 
-        DM1CNT_H = value;
-        UPDATE_REG(0xC6, DM1CNT_H);
+        gbaCore.DM1CNT_H = value;
+        UPDATE_REG(0xC6, gbaCore.DM1CNT_H);
 
         if (start && (value & 0x8000)) {
-            dma1Source = DM1SAD_L | (DM1SAD_H << 16);
-            dma1Dest = DM1DAD_L | (DM1DAD_H << 16);
+            gbaCore.dma1Source = gbaCore.DM1SAD_L | (gbaCore.DM1SAD_H << 16);
+            gbaCore.dma1Dest = gbaCore.DM1DAD_L | (gbaCore.DM1DAD_H << 16);
             CPUCheckDMA(0, 2);
         }
     } break;
     case 0xC8:
-        DM2SAD_L = value;
-        UPDATE_REG(0xC8, DM2SAD_L);
+        gbaCore.DM2SAD_L = value;
+        UPDATE_REG(0xC8, gbaCore.DM2SAD_L);
         break;
     case 0xCA:
-        DM2SAD_H = value & 0x0FFF;
-        UPDATE_REG(0xCA, DM2SAD_H);
+        gbaCore.DM2SAD_H = value & 0x0FFF;
+        UPDATE_REG(0xCA, gbaCore.DM2SAD_H);
         break;
     case 0xCC:
-        DM2DAD_L = value;
-        UPDATE_REG(0xCC, DM2DAD_L);
+        gbaCore.DM2DAD_L = value;
+        UPDATE_REG(0xCC, gbaCore.DM2DAD_L);
         break;
     case 0xCE:
-        DM2DAD_H = value & 0x07FF;
-        UPDATE_REG(0xCE, DM2DAD_H);
+        gbaCore.DM2DAD_H = value & 0x07FF;
+        UPDATE_REG(0xCE, gbaCore.DM2DAD_H);
         break;
     case 0xD0:
-        DM2CNT_L = value & 0x3FFF;
+        gbaCore.DM2CNT_L = value & 0x3FFF;
         UPDATE_REG(0xD0, 0);
         break;
     case 0xD2: {
-        bool start = ((DM2CNT_H ^ value) & 0x8000) ? true : false;
+        bool start = ((gbaCore.DM2CNT_H ^ value) & 0x8000) ? true : false;
 
         value &= 0xF7E0;
 
-        DM2CNT_H = value;
-        UPDATE_REG(0xD2, DM2CNT_H);
+        gbaCore.DM2CNT_H = value;
+        UPDATE_REG(0xD2, gbaCore.DM2CNT_H);
 
         if (start && (value & 0x8000)) {
-            dma2Source = DM2SAD_L | (DM2SAD_H << 16);
-            dma2Dest = DM2DAD_L | (DM2DAD_H << 16);
+            gbaCore.dma2Source = gbaCore.DM2SAD_L | (gbaCore.DM2SAD_H << 16);
+            gbaCore.dma2Dest = gbaCore.DM2DAD_L | (gbaCore.DM2DAD_H << 16);
 
             CPUCheckDMA(0, 4);
         }
     } break;
     case 0xD4:
-        DM3SAD_L = value;
-        UPDATE_REG(0xD4, DM3SAD_L);
+        gbaCore.DM3SAD_L = value;
+        UPDATE_REG(0xD4, gbaCore.DM3SAD_L);
         break;
     case 0xD6:
-        DM3SAD_H = value & 0x0FFF;
-        UPDATE_REG(0xD6, DM3SAD_H);
+        gbaCore.DM3SAD_H = value & 0x0FFF;
+        UPDATE_REG(0xD6, gbaCore.DM3SAD_H);
         break;
     case 0xD8:
-        DM3DAD_L = value;
-        UPDATE_REG(0xD8, DM3DAD_L);
+        gbaCore.DM3DAD_L = value;
+        UPDATE_REG(0xD8, gbaCore.DM3DAD_L);
         break;
     case 0xDA:
-        DM3DAD_H = value & 0x0FFF;
-        UPDATE_REG(0xDA, DM3DAD_H);
+        gbaCore.DM3DAD_H = value & 0x0FFF;
+        UPDATE_REG(0xDA, gbaCore.DM3DAD_H);
         break;
     case 0xDC:
-        DM3CNT_L = value;
+        gbaCore.DM3CNT_L = value;
         UPDATE_REG(0xDC, 0);
         break;
     case 0xDE: {
-        bool start = ((DM3CNT_H ^ value) & 0x8000) ? true : false;
+        bool start = ((gbaCore.DM3CNT_H ^ value) & 0x8000) ? true : false;
 
         value &= 0xFFE0;
 
-        DM3CNT_H = value;
-        UPDATE_REG(0xDE, DM3CNT_H);
+        gbaCore.DM3CNT_H = value;
+        UPDATE_REG(0xDE, gbaCore.DM3CNT_H);
 
         if (start && (value & 0x8000)) {
-            dma3Source = DM3SAD_L | (DM3SAD_H << 16);
-            dma3Dest = DM3DAD_L | (DM3DAD_H << 16);
+            gbaCore.dma3Source = gbaCore.DM3SAD_L | (gbaCore.DM3SAD_H << 16);
+            gbaCore.dma3Dest = gbaCore.DM3DAD_L | (gbaCore.DM3DAD_H << 16);
             CPUCheckDMA(0, 8);
         }
     } break;
     case 0x100:
-        timer0Reload = value;
+        gbaCore.timer0Reload = value;
         interp_rate();
         break;
     case 0x102:
-        timer0Value = value;
-        timerOnOffDelay |= 1;
-        cpuNextEvent = cpuTotalTicks;
+        gbaCore.timer0Value = value;
+        gbaCore.timerOnOffDelay |= 1;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x104:
-        timer1Reload = value;
+        gbaCore.timer1Reload = value;
         interp_rate();
         break;
     case 0x106:
-        timer1Value = value;
-        timerOnOffDelay |= 2;
-        cpuNextEvent = cpuTotalTicks;
+        gbaCore.timer1Value = value;
+        gbaCore.timerOnOffDelay |= 2;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x108:
-        timer2Reload = value;
+        gbaCore.timer2Reload = value;
         break;
     case 0x10A:
-        timer2Value = value;
-        timerOnOffDelay |= 4;
-        cpuNextEvent = cpuTotalTicks;
+        gbaCore.timer2Value = value;
+        gbaCore.timerOnOffDelay |= 4;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x10C:
-        timer3Reload = value;
+        gbaCore.timer3Reload = value;
         break;
     case 0x10E:
-        timer3Value = value;
-        timerOnOffDelay |= 8;
-        cpuNextEvent = cpuTotalTicks;
+        gbaCore.timer3Value = value;
+        gbaCore.timerOnOffDelay |= 8;
+        gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
 
     case COMM_SIOCNT:
 #ifndef NO_LINK
         StartLink(value);
 #else
-        if (!g_ioMem)
+        if (!gbaCore.g_ioMem)
             return;
 
         if (value & 0x80) {
             value &= 0xff7f;
             if (value & 1 && (value & 0x4000)) {
                 UPDATE_REG(COMM_SIOCNT, 0xFF);
-                IF |= 0x80;
-                UPDATE_REG(0x202, IF);
+                gbaCore.IF |= 0x80;
+                UPDATE_REG(0x202, gbaCore.IF);
                 value &= 0x7f7f;
             }
         }
@@ -3125,8 +3102,8 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
 #endif
 
     case 0x130:
-        P1 |= (value & 0x3FF);
-        UPDATE_REG(0x130, P1);
+        gbaCore.P1 |= (value & 0x3FF);
+        UPDATE_REG(0x130, gbaCore.P1);
         break;
 
     case 0x132:
@@ -3138,7 +3115,7 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
 #ifndef NO_LINK
         StartGPLink(value);
 #else
-        if (!g_ioMem)
+        if (!gbaCore.g_ioMem)
             return;
 
         UPDATE_REG(COMM_RCNT, value);
@@ -3147,7 +3124,7 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
 
 #ifndef NO_LINK
     case COMM_JOYCNT: {
-        uint16_t cur = READ16LE(&g_ioMem[COMM_JOYCNT]);
+        uint16_t cur = READ16LE(&gbaCore.g_ioMem[COMM_JOYCNT]);
 
         if (value & JOYCNT_RESET)
             cur &= ~JOYCNT_RESET;
@@ -3170,73 +3147,73 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
 
     case COMM_JOY_TRANS_L:
         UPDATE_REG(COMM_JOY_TRANS_L, value);
-        UPDATE_REG(COMM_JOYSTAT, READ16LE(&g_ioMem[COMM_JOYSTAT]) | JOYSTAT_SEND);
+        UPDATE_REG(COMM_JOYSTAT, READ16LE(&gbaCore.g_ioMem[COMM_JOYSTAT]) | JOYSTAT_SEND);
         break;
     case COMM_JOY_TRANS_H:
         UPDATE_REG(COMM_JOY_TRANS_H, value);
-        UPDATE_REG(COMM_JOYSTAT, READ16LE(&g_ioMem[COMM_JOYSTAT]) | JOYSTAT_SEND);
+        UPDATE_REG(COMM_JOYSTAT, READ16LE(&gbaCore.g_ioMem[COMM_JOYSTAT]) | JOYSTAT_SEND);
         break;
 
     case COMM_JOYSTAT:
-        UPDATE_REG(COMM_JOYSTAT, (READ16LE(&g_ioMem[COMM_JOYSTAT]) & 0x0a) | (value & ~0x0a));
+        UPDATE_REG(COMM_JOYSTAT, (READ16LE(&gbaCore.g_ioMem[COMM_JOYSTAT]) & 0x0a) | (value & ~0x0a));
         break;
 #endif
 
     case 0x200:
-        IE = value & 0x3FFF;
-        UPDATE_REG(0x200, IE);
-        if ((IME & 1) && (IF & IE) && armIrqEnable)
-            cpuNextEvent = cpuTotalTicks;
+        gbaCore.IE = value & 0x3FFF;
+        UPDATE_REG(0x200, gbaCore.IE);
+        if ((gbaCore.IME & 1) && (gbaCore.IF & gbaCore.IE) && gbaCore.armIrqEnable)
+            gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x202:
-        IF ^= (value & IF);
-        UPDATE_REG(0x202, IF);
+        gbaCore.IF ^= (value & gbaCore.IF);
+        UPDATE_REG(0x202, gbaCore.IF);
         break;
     case 0x204: {
-        memoryWait[0x0e] = memoryWaitSeq[0x0e] = gamepakRamWaitState[value & 3];
+        gbaCore.memoryWait[0x0e] = gbaCore.memoryWaitSeq[0x0e] = gamepakRamWaitState[value & 3];
 
         if (!coreOptions.speedHack) {
-            memoryWait[0x08] = memoryWait[0x09] = gamepakWaitState[(value >> 2) & 3];
-            memoryWaitSeq[0x08] = memoryWaitSeq[0x09] = gamepakWaitState0[(value >> 4) & 1];
+            gbaCore.memoryWait[0x08] = gbaCore.memoryWait[0x09] = gamepakWaitState[(value >> 2) & 3];
+            gbaCore.memoryWaitSeq[0x08] = gbaCore.memoryWaitSeq[0x09] = gamepakWaitState0[(value >> 4) & 1];
 
-            memoryWait[0x0a] = memoryWait[0x0b] = gamepakWaitState[(value >> 5) & 3];
-            memoryWaitSeq[0x0a] = memoryWaitSeq[0x0b] = gamepakWaitState1[(value >> 7) & 1];
+            gbaCore.memoryWait[0x0a] = gbaCore.memoryWait[0x0b] = gamepakWaitState[(value >> 5) & 3];
+            gbaCore.memoryWaitSeq[0x0a] = gbaCore.memoryWaitSeq[0x0b] = gamepakWaitState1[(value >> 7) & 1];
 
-            memoryWait[0x0c] = memoryWait[0x0d] = gamepakWaitState[(value >> 8) & 3];
-            memoryWaitSeq[0x0c] = memoryWaitSeq[0x0d] = gamepakWaitState2[(value >> 10) & 1];
+            gbaCore.memoryWait[0x0c] = gbaCore.memoryWait[0x0d] = gamepakWaitState[(value >> 8) & 3];
+            gbaCore.memoryWaitSeq[0x0c] = gbaCore.memoryWaitSeq[0x0d] = gamepakWaitState2[(value >> 10) & 1];
         } else {
-            memoryWait[0x08] = memoryWait[0x09] = 3;
-            memoryWaitSeq[0x08] = memoryWaitSeq[0x09] = 1;
+            gbaCore.memoryWait[0x08] = gbaCore.memoryWait[0x09] = 3;
+            gbaCore.memoryWaitSeq[0x08] = gbaCore.memoryWaitSeq[0x09] = 1;
 
-            memoryWait[0x0a] = memoryWait[0x0b] = 3;
-            memoryWaitSeq[0x0a] = memoryWaitSeq[0x0b] = 1;
+            gbaCore.memoryWait[0x0a] = gbaCore.memoryWait[0x0b] = 3;
+            gbaCore.memoryWaitSeq[0x0a] = gbaCore.memoryWaitSeq[0x0b] = 1;
 
-            memoryWait[0x0c] = memoryWait[0x0d] = 3;
-            memoryWaitSeq[0x0c] = memoryWaitSeq[0x0d] = 1;
+            gbaCore.memoryWait[0x0c] = gbaCore.memoryWait[0x0d] = 3;
+            gbaCore.memoryWaitSeq[0x0c] = gbaCore.memoryWaitSeq[0x0d] = 1;
         }
 
         for (int i = 8; i < 15; i++) {
-            memoryWait32[i] = memoryWait[i] + memoryWaitSeq[i] + 1;
-            memoryWaitSeq32[i] = memoryWaitSeq[i] * 2 + 1;
+            gbaCore.memoryWait32[i] = gbaCore.memoryWait[i] + gbaCore.memoryWaitSeq[i] + 1;
+            gbaCore.memoryWaitSeq32[i] = gbaCore.memoryWaitSeq[i] * 2 + 1;
         }
 
         if ((value & 0x4000) == 0x4000) {
-            busPrefetchEnable = true;
-            busPrefetch = false;
-            busPrefetchCount = 0;
+            gbaCore.busPrefetchEnable = true;
+            gbaCore.busPrefetch = false;
+            gbaCore.busPrefetchCount = 0;
         } else {
-            busPrefetchEnable = false;
-            busPrefetch = false;
-            busPrefetchCount = 0;
+            gbaCore.busPrefetchEnable = false;
+            gbaCore.busPrefetch = false;
+            gbaCore.busPrefetchCount = 0;
         }
         UPDATE_REG(0x204, value & 0x7FFF);
 
     } break;
     case 0x208:
-        IME = value & 1;
-        UPDATE_REG(0x208, IME);
-        if ((IME & 1) && (IF & IE) && armIrqEnable)
-            cpuNextEvent = cpuTotalTicks;
+        gbaCore.IME = value & 1;
+        UPDATE_REG(0x208, gbaCore.IME);
+        if ((gbaCore.IME & 1) && (gbaCore.IF & gbaCore.IE) && gbaCore.armIrqEnable)
+            gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
         break;
     case 0x300:
         if (value != 0)
@@ -3251,64 +3228,63 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
 
 void applyTimer()
 {
-    if (timerOnOffDelay & 1) {
-        timer0ClockReload = TIMER_TICKS[timer0Value & 3];
-        if (!timer0On && (timer0Value & 0x80)) {
+    CPUSyncEventTicks();
+    if (gbaCore.timerOnOffDelay & 1) {
+        gbaCore.timer0ClockReload = TIMER_TICKS[gbaCore.timer0Value & 3];
+        if (!gbaCore.timer0On && (gbaCore.timer0Value & 0x80)) {
             // reload the counter
-            TM0D = DowncastU16(timer0Reload);
-            timer0Ticks = (0x10000 - TM0D) << timer0ClockReload;
-            UPDATE_REG(0x100, TM0D);
+            gbaCore.TM0D = DowncastU16(gbaCore.timer0Reload);
+            gbaCore.timer0Ticks = (0x10000 - gbaCore.TM0D) << gbaCore.timer0ClockReload;
+            UPDATE_REG(0x100, gbaCore.TM0D);
         }
-        timer0On = timer0Value & 0x80 ? true : false;
-        TM0CNT = timer0Value & 0xC7;
+        gbaCore.timer0On = gbaCore.timer0Value & 0x80 ? true : false;
+        gbaCore.TM0CNT = gbaCore.timer0Value & 0xC7;
         interp_rate();
-        UPDATE_REG(0x102, TM0CNT);
+        UPDATE_REG(0x102, gbaCore.TM0CNT);
         //    CPUUpdateTicks();
     }
-    if (timerOnOffDelay & 2) {
-        timer1ClockReload = TIMER_TICKS[timer1Value & 3];
-        if (!timer1On && (timer1Value & 0x80)) {
+    if (gbaCore.timerOnOffDelay & 2) {
+        gbaCore.timer1ClockReload = TIMER_TICKS[gbaCore.timer1Value & 3];
+        if (!gbaCore.timer1On && (gbaCore.timer1Value & 0x80)) {
             // reload the counter
-            TM1D = DowncastU16(timer1Reload);
-            timer1Ticks = (0x10000 - TM1D) << timer1ClockReload;
-            UPDATE_REG(0x104, TM1D);
+            gbaCore.TM1D = DowncastU16(gbaCore.timer1Reload);
+            gbaCore.timer1Ticks = (0x10000 - gbaCore.TM1D) << gbaCore.timer1ClockReload;
+            UPDATE_REG(0x104, gbaCore.TM1D);
         }
-        timer1On = timer1Value & 0x80 ? true : false;
-        TM1CNT = timer1Value & 0xC7;
+        gbaCore.timer1On = gbaCore.timer1Value & 0x80 ? true : false;
+        gbaCore.TM1CNT = gbaCore.timer1Value & 0xC7;
         interp_rate();
-        UPDATE_REG(0x106, TM1CNT);
+        UPDATE_REG(0x106, gbaCore.TM1CNT);
     }
-    if (timerOnOffDelay & 4) {
-        timer2ClockReload = TIMER_TICKS[timer2Value & 3];
-        if (!timer2On && (timer2Value & 0x80)) {
+    if (gbaCore.timerOnOffDelay & 4) {
+        gbaCore.timer2ClockReload = TIMER_TICKS[gbaCore.timer2Value & 3];
+        if (!gbaCore.timer2On && (gbaCore.timer2Value & 0x80)) {
             // reload the counter
-            TM2D = DowncastU16(timer2Reload);
-            timer2Ticks = (0x10000 - TM2D) << timer2ClockReload;
-            UPDATE_REG(0x108, TM2D);
+            gbaCore.TM2D = DowncastU16(gbaCore.timer2Reload);
+            gbaCore.timer2Ticks = (0x10000 - gbaCore.TM2D) << gbaCore.timer2ClockReload;
+            UPDATE_REG(0x108, gbaCore.TM2D);
         }
-        timer2On = timer2Value & 0x80 ? true : false;
-        TM2CNT = timer2Value & 0xC7;
-        UPDATE_REG(0x10A, TM2CNT);
+        gbaCore.timer2On = gbaCore.timer2Value & 0x80 ? true : false;
+        gbaCore.TM2CNT = gbaCore.timer2Value & 0xC7;
+        UPDATE_REG(0x10A, gbaCore.TM2CNT);
     }
-    if (timerOnOffDelay & 8) {
-        timer3ClockReload = TIMER_TICKS[timer3Value & 3];
-        if (!timer3On && (timer3Value & 0x80)) {
+    if (gbaCore.timerOnOffDelay & 8) {
+        gbaCore.timer3ClockReload = TIMER_TICKS[gbaCore.timer3Value & 3];
+        if (!gbaCore.timer3On && (gbaCore.timer3Value & 0x80)) {
             // reload the counter
-            TM3D = DowncastU16(timer3Reload);
-            timer3Ticks = (0x10000 - TM3D) << timer3ClockReload;
-            UPDATE_REG(0x10C, TM3D);
+            gbaCore.TM3D = DowncastU16(gbaCore.timer3Reload);
+            gbaCore.timer3Ticks = (0x10000 - gbaCore.TM3D) << gbaCore.timer3ClockReload;
+            UPDATE_REG(0x10C, gbaCore.TM3D);
         }
-        timer3On = timer3Value & 0x80 ? true : false;
-        TM3CNT = timer3Value & 0xC7;
-        UPDATE_REG(0x10E, TM3CNT);
+        gbaCore.timer3On = gbaCore.timer3Value & 0x80 ? true : false;
+        gbaCore.TM3CNT = gbaCore.timer3Value & 0xC7;
+        UPDATE_REG(0x10E, gbaCore.TM3CNT);
     }
-    cpuNextEvent = CPUUpdateTicks();
-    timerOnOffDelay = 0;
+    CPUScheduleEvents();
+    gbaCore.cpuNextEvent = CPUUpdateTicks();
+    gbaCore.timerOnOffDelay = 0;
 }
 
-uint8_t cpuBitsSet[256];
-uint8_t cpuLowestBitSet[256];
-
 void CPUInit(const char* biosFileName, bool useBiosFile)
 {
 #ifdef WORDS_BIGENDIAN
@@ -3319,14 +3295,14 @@ void CPUInit(const char* biosFileName, bool useBiosFile)
         cpuBiosSwapped = true;
     }
 #endif
-    eepromInUse = 0;
+    gbaCore.eepromInUse = 0;
     coreOptions.useBios = false;
 
     if (useBiosFile && strlen(biosFileName) > 0) {
         int size = 0x4000;
         if (utilLoad(biosFileName,
                 CPUIsGBABios,
-                g_bios,
+                gbaCore.g_bios,
                 size)) {
             if (size == 0x4000)
                 coreOptions.useBios = true;
@@ -3336,15 +3312,15 @@ void CPUInit(const char* biosFileName, bool useBiosFile)
     }
 
     if (!coreOptions.useBios) {
-        memcpy(g_bios, myROM, sizeof(myROM));
+        memcpy(gbaCore.g_bios, myROM, sizeof(myROM));
     }
 
     int i = 0;
 
-    biosProtected[0] = 0x00;
-    biosProtected[1] = 0xf0;
-    biosProtected[2] = 0x29;
-    biosProtected[3] = 0xe1;
+    gbaCore.biosProtected[0] = 0x00;
+    gbaCore.biosProtected[1] = 0xf0;
+    gbaCore.biosProtected[2] = 0x29;
+    gbaCore.biosProtected[3] = 0xe1;
 
     for (i = 0; i < 256; i++) {
         int count = 0;
@@ -3352,52 +3328,52 @@ void CPUInit(const char* biosFileName, bool useBiosFile)
         for (j = 0; j < 8; j++)
             if (i & (1 << j))
                 count++;
-        cpuBitsSet[i] = DowncastU8(count);
+        gbaCore.cpuBitsSet[i] = DowncastU8(count);
 
         for (j = 0; j < 8; j++)
             if (i & (1 << j))
                 break;
-        cpuLowestBitSet[i] = DowncastU8(j);
+        gbaCore.cpuLowestBitSet[i] = DowncastU8(j);
     }
 
     for (i = 0; i < 0x400; i++)
-        ioReadable[i] = true;
+        gbaCore.ioReadable[i] = true;
     for (i = 0x10; i < 0x48; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x4c; i < 0x50; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x54; i < 0x60; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x8c; i < 0x90; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0xa0; i < 0xb8; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0xbc; i < 0xc4; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0xc8; i < 0xd0; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0xd4; i < 0xdc; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0xe0; i < 0x100; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x110; i < 0x120; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x12c; i < 0x130; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x138; i < 0x140; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x144; i < 0x150; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x15c; i < 0x200; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x20c; i < 0x300; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
     for (i = 0x304; i < 0x400; i++)
-        ioReadable[i] = false;
+        gbaCore.ioReadable[i] = false;
 
-    if (romSize < 0x1fe2000) {
-        *((uint16_t*)&g_rom[0x1fe209c]) = 0xdffa; // SWI 0xFA
-        *((uint16_t*)&g_rom[0x1fe209e]) = 0x4770; // BX LR
+    if (gbaCore.romSize < 0x1fe2000) {
+        *((uint16_t*)&gbaCore.g_rom[0x1fe209c]) = 0xdffa; // SWI 0xFA
+        *((uint16_t*)&gbaCore.g_rom[0x1fe209e]) = 0x4770; // BX LR
     } else {
         agbPrintEnable(false);
     }
@@ -3407,43 +3383,43 @@ void SetSaveType(int st)
 {
     switch (st) {
     case GBA_SAVE_AUTO:
-        cpuSramEnabled = true;
-        cpuFlashEnabled = true;
-        cpuEEPROMEnabled = true;
-        cpuEEPROMSensorEnabled = false;
-        cpuSaveGameFunc = flashSaveDecide;
+        gbaCore.cpuSramEnabled = true;
+        gbaCore.cpuFlashEnabled = true;
+        gbaCore.cpuEEPROMEnabled = true;
+        gbaCore.cpuEEPROMSensorEnabled = false;
+        gbaCore.cpuSaveGameFunc = flashSaveDecide;
         break;
     case GBA_SAVE_EEPROM:
-        cpuSramEnabled = false;
-        cpuFlashEnabled = false;
-        cpuEEPROMEnabled = true;
-        cpuEEPROMSensorEnabled = false;
+        gbaCore.cpuSramEnabled = false;
+        gbaCore.cpuFlashEnabled = false;
+        gbaCore.cpuEEPROMEnabled = true;
+        gbaCore.cpuEEPROMSensorEnabled = false;
         break;
     case GBA_SAVE_SRAM:
-        cpuSramEnabled = true;
-        cpuFlashEnabled = false;
-        cpuEEPROMEnabled = false;
-        cpuEEPROMSensorEnabled = false;
-        cpuSaveGameFunc = sramDelayedWrite; // to insure we detect the write
+        gbaCore.cpuSramEnabled = true;
+        gbaCore.cpuFlashEnabled = false;
+        gbaCore.cpuEEPROMEnabled = false;
+        gbaCore.cpuEEPROMSensorEnabled = false;
+        gbaCore.cpuSaveGameFunc = sramDelayedWrite; // to insure we detect the write
         break;
     case GBA_SAVE_FLASH:
-        cpuSramEnabled = false;
-        cpuFlashEnabled = true;
-        cpuEEPROMEnabled = false;
-        cpuEEPROMSensorEnabled = false;
-        cpuSaveGameFunc = flashDelayedWrite; // to insure we detect the write
+        gbaCore.cpuSramEnabled = false;
+        gbaCore.cpuFlashEnabled = true;
+        gbaCore.cpuEEPROMEnabled = false;
+        gbaCore.cpuEEPROMSensorEnabled = false;
+        gbaCore.cpuSaveGameFunc = flashDelayedWrite; // to insure we detect the write
         break;
     case GBA_SAVE_EEPROM_SENSOR:
-        cpuSramEnabled = false;
-        cpuFlashEnabled = false;
-        cpuEEPROMEnabled = true;
-        cpuEEPROMSensorEnabled = true;
+        gbaCore.cpuSramEnabled = false;
+        gbaCore.cpuFlashEnabled = false;
+        gbaCore.cpuEEPROMEnabled = true;
+        gbaCore.cpuEEPROMSensorEnabled = true;
         break;
     case GBA_SAVE_NONE:
-        cpuSramEnabled = false;
-        cpuFlashEnabled = false;
-        cpuEEPROMEnabled = false;
-        cpuEEPROMSensorEnabled = false;
+        gbaCore.cpuSramEnabled = false;
+        gbaCore.cpuFlashEnabled = false;
+        gbaCore.cpuEEPROMEnabled = false;
+        gbaCore.cpuEEPROMSensorEnabled = false;
         break;
     }
 }
@@ -3462,200 +3438,211 @@ void CPUReset()
         break;
     }
     rtcReset();
+    // the ROM may have been patched or replaced
+    cpuDecodeCacheFlush();
     // clean registers
-    memset(&reg[0], 0, sizeof(reg));
+    memset(&gbaCore.reg[0], 0, sizeof(gbaCore.reg));
     // clean OAM
-    memset(g_oam, 0, SIZE_OAM);
+    memset(gbaCore.g_oam, 0, SIZE_OAM);
+    gfxSpriteIndexFlush();
     // clean palette
-    memset(g_paletteRAM, 0, SIZE_PRAM);
+    memset(gbaCore.g_paletteRAM, 0, SIZE_PRAM);
     // clean picture
-    memset(g_pix, 0, SIZE_PIX);
+    memset(gbaCore.g_pix, 0, SIZE_PIX);
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
     // clean g_vram
-    memset(g_vram, 0, SIZE_VRAM);
+    memset(gbaCore.g_vram, 0, SIZE_VRAM);
+    gfxTileCacheFlush();
     // clean io memory
-    memset(g_ioMem, 0, SIZE_IOMEM);
-
-    DISPCNT = 0x0080;
-    DISPSTAT = 0x0000;
-    VCOUNT = (coreOptions.useBios && !coreOptions.skipBios) ? 0 : 0x007E;
-    BG0CNT = 0x0000;
-    BG1CNT = 0x0000;
-    BG2CNT = 0x0000;
-    BG3CNT = 0x0000;
-    BG0HOFS = 0x0000;
-    BG0VOFS = 0x0000;
-    BG1HOFS = 0x0000;
-    BG1VOFS = 0x0000;
-    BG2HOFS = 0x0000;
-    BG2VOFS = 0x0000;
-    BG3HOFS = 0x0000;
-    BG3VOFS = 0x0000;
-    BG2PA = 0x0100;
-    BG2PB = 0x0000;
-    BG2PC = 0x0000;
-    BG2PD = 0x0100;
-    BG2X_L = 0x0000;
-    BG2X_H = 0x0000;
-    BG2Y_L = 0x0000;
-    BG2Y_H = 0x0000;
-    BG3PA = 0x0100;
-    BG3PB = 0x0000;
-    BG3PC = 0x0000;
-    BG3PD = 0x0100;
-    BG3X_L = 0x0000;
-    BG3X_H = 0x0000;
-    BG3Y_L = 0x0000;
-    BG3Y_H = 0x0000;
-    WIN0H = 0x0000;
-    WIN1H = 0x0000;
-    WIN0V = 0x0000;
-    WIN1V = 0x0000;
-    WININ = 0x0000;
-    WINOUT = 0x0000;
-    MOSAIC = 0x0000;
-    BLDMOD = 0x0000;
-    COLEV = 0x0000;
-    COLY = 0x0000;
-    DM0SAD_L = 0x0000;
-    DM0SAD_H = 0x0000;
-    DM0DAD_L = 0x0000;
-    DM0DAD_H = 0x0000;
-    DM0CNT_L = 0x0000;
-    DM0CNT_H = 0x0000;
-    DM1SAD_L = 0x0000;
-    DM1SAD_H = 0x0000;
-    DM1DAD_L = 0x0000;
-    DM1DAD_H = 0x0000;
-    DM1CNT_L = 0x0000;
-    DM1CNT_H = 0x0000;
-    DM2SAD_L = 0x0000;
-    DM2SAD_H = 0x0000;
-    DM2DAD_L = 0x0000;
-    DM2DAD_H = 0x0000;
-    DM2CNT_L = 0x0000;
-    DM2CNT_H = 0x0000;
-    DM3SAD_L = 0x0000;
-    DM3SAD_H = 0x0000;
-    DM3DAD_L = 0x0000;
-    DM3DAD_H = 0x0000;
-    DM3CNT_L = 0x0000;
-    DM3CNT_H = 0x0000;
-    TM0D = 0x0000;
-    TM0CNT = 0x0000;
-    TM1D = 0x0000;
-    TM1CNT = 0x0000;
-    TM2D = 0x0000;
-    TM2CNT = 0x0000;
-    TM3D = 0x0000;
-    TM3CNT = 0x0000;
-    P1 = 0x03FF;
-    IE = 0x0000;
-    IF = 0x0000;
-    IME = 0x0000;
-
-    armMode = 0x1F;
+    memset(gbaCore.g_ioMem, 0, SIZE_IOMEM);
+
+    gbaCore.DISPCNT = 0x0080;
+    gbaCore.DISPSTAT = 0x0000;
+    gbaCore.VCOUNT = (coreOptions.useBios && !coreOptions.skipBios) ? 0 : 0x007E;
+    gbaCore.BG0CNT = 0x0000;
+    gbaCore.BG1CNT = 0x0000;
+    gbaCore.BG2CNT = 0x0000;
+    gbaCore.BG3CNT = 0x0000;
+    gbaCore.BG0HOFS = 0x0000;
+    gbaCore.BG0VOFS = 0x0000;
+    gbaCore.BG1HOFS = 0x0000;
+    gbaCore.BG1VOFS = 0x0000;
+    gbaCore.BG2HOFS = 0x0000;
+    gbaCore.BG2VOFS = 0x0000;
+    gbaCore.BG3HOFS = 0x0000;
+    gbaCore.BG3VOFS = 0x0000;
+    gbaCore.BG2PA = 0x0100;
+    gbaCore.BG2PB = 0x0000;
+    gbaCore.BG2PC = 0x0000;
+    gbaCore.BG2PD = 0x0100;
+    gbaCore.BG2X_L = 0x0000;
+    gbaCore.BG2X_H = 0x0000;
+    gbaCore.BG2Y_L = 0x0000;
+    gbaCore.BG2Y_H = 0x0000;
+    gbaCore.BG3PA = 0x0100;
+    gbaCore.BG3PB = 0x0000;
+    gbaCore.BG3PC = 0x0000;
+    gbaCore.BG3PD = 0x0100;
+    gbaCore.BG3X_L = 0x0000;
+    gbaCore.BG3X_H = 0x0000;
+    gbaCore.BG3Y_L = 0x0000;
+    gbaCore.BG3Y_H = 0x0000;
+    gbaCore.WIN0H = 0x0000;
+    gbaCore.WIN1H = 0x0000;
+    gbaCore.WIN0V = 0x0000;
+    gbaCore.WIN1V = 0x0000;
+    gbaCore.WININ = 0x0000;
+    gbaCore.WINOUT = 0x0000;
+    gbaCore.MOSAIC = 0x0000;
+    gbaCore.BLDMOD = 0x0000;
+    gbaCore.COLEV = 0x0000;
+    gbaCore.COLY = 0x0000;
+    gbaCore.DM0SAD_L = 0x0000;
+    gbaCore.DM0SAD_H = 0x0000;
+    gbaCore.DM0DAD_L = 0x0000;
+    gbaCore.DM0DAD_H = 0x0000;
+    gbaCore.DM0CNT_L = 0x0000;
+    gbaCore.DM0CNT_H = 0x0000;
+    gbaCore.DM1SAD_L = 0x0000;
+    gbaCore.DM1SAD_H = 0x0000;
+    gbaCore.DM1DAD_L = 0x0000;
+    gbaCore.DM1DAD_H = 0x0000;
+    gbaCore.DM1CNT_L = 0x0000;
+    gbaCore.DM1CNT_H = 0x0000;
+    gbaCore.DM2SAD_L = 0x0000;
+    gbaCore.DM2SAD_H = 0x0000;
+    gbaCore.DM2DAD_L = 0x0000;
+    gbaCore.DM2DAD_H = 0x0000;
+    gbaCore.DM2CNT_L = 0x0000;
+    gbaCore.DM2CNT_H = 0x0000;
+    gbaCore.DM3SAD_L = 0x0000;
+    gbaCore.DM3SAD_H = 0x0000;
+    gbaCore.DM3DAD_L = 0x0000;
+    gbaCore.DM3DAD_H = 0x0000;
+    gbaCore.DM3CNT_L = 0x0000;
+    gbaCore.DM3CNT_H = 0x0000;
+    gbaCore.TM0D = 0x0000;
+    gbaCore.TM0CNT = 0x0000;
+    gbaCore.TM1D = 0x0000;
+    gbaCore.TM1CNT = 0x0000;
+    gbaCore.TM2D = 0x0000;
+    gbaCore.TM2CNT = 0x0000;
+    gbaCore.TM3D = 0x0000;
+    gbaCore.TM3CNT = 0x0000;
+    gbaCore.P1 = 0x03FF;
+    gbaCore.IE = 0x0000;
+    gbaCore.IF = 0x0000;
+    gbaCore.IME = 0x0000;
+
+    gbaCore.armMode = 0x1F;
 
     if (coreOptions.cpuIsMultiBoot) {
-        reg[13].I = 0x03007F00;
-        reg[15].I = 0x02000000;
-        reg[16].I = 0x00000000;
-        reg[R13_IRQ].I = 0x03007FA0;
-        reg[R13_SVC].I = 0x03007FE0;
-        armIrqEnable = true;
+        gbaCore.reg[13].I = 0x03007F00;
+        gbaCore.reg[15].I = 0x02000000;
+        gbaCore.reg[16].I = 0x00000000;
+        gbaCore.reg[R13_IRQ].I = 0x03007FA0;
+        gbaCore.reg[R13_SVC].I = 0x03007FE0;
+        gbaCore.armIrqEnable = true;
     } else {
         if (coreOptions.useBios && !coreOptions.skipBios) {
-            reg[15].I = 0x00000000;
-            armMode = 0x13;
-            armIrqEnable = false;
+            gbaCore.reg[15].I = 0x00000000;
+            gbaCore.armMode = 0x13;
+            gbaCore.armIrqEnable = false;
         } else {
-            reg[13].I = 0x03007F00;
-            reg[15].I = 0x08000000;
-            reg[16].I = 0x00000000;
-            reg[R13_IRQ].I = 0x03007FA0;
-            reg[R13_SVC].I = 0x03007FE0;
-            armIrqEnable = true;
+            gbaCore.reg[13].I = 0x03007F00;
+            gbaCore.reg[15].I = 0x08000000;
+            gbaCore.reg[16].I = 0x00000000;
+            gbaCore.reg[R13_IRQ].I = 0x03007FA0;
+            gbaCore.reg[R13_SVC].I = 0x03007FE0;
+            gbaCore.armIrqEnable = true;
         }
     }
-    armState = true;
-    C_FLAG = V_FLAG = N_FLAG = Z_FLAG = false;
-    UPDATE_REG(0x00, DISPCNT);
-    UPDATE_REG(0x06, VCOUNT);
-    UPDATE_REG(0x20, BG2PA);
-    UPDATE_REG(0x26, BG2PD);
-    UPDATE_REG(0x30, BG3PA);
-    UPDATE_REG(0x36, BG3PD);
-    UPDATE_REG(0x130, P1);
+    gbaCore.armState = true;
+    gbaCore.C_FLAG = gbaCore.V_FLAG = gbaCore.N_FLAG = gbaCore.Z_FLAG = false;
+    UPDATE_REG(0x00, gbaCore.DISPCNT);
+    UPDATE_REG(0x06, gbaCore.VCOUNT);
+    UPDATE_REG(0x20, gbaCore.BG2PA);
+    UPDATE_REG(0x26, gbaCore.BG2PD);
+    UPDATE_REG(0x30, gbaCore.BG3PA);
+    UPDATE_REG(0x36, gbaCore.BG3PD);
+    UPDATE_REG(0x130, gbaCore.P1);
     UPDATE_REG(0x88, 0x200);
 
     // disable FIQ
-    reg[16].I |= 0x40;
+    gbaCore.reg[16].I |= 0x40;
 
     CPUUpdateCPSR();
 
-    armNextPC = reg[15].I;
-    reg[15].I += 4;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 4;
 
     // reset internal state
-    holdState = false;
-    holdType = 0;
-
-    biosProtected[0] = 0x00;
-    biosProtected[1] = 0xf0;
-    biosProtected[2] = 0x29;
-    biosProtected[3] = 0xe1;
-
-    lcdTicks = (coreOptions.useBios && !coreOptions.skipBios) ? 1008 : 208;
-    timer0On = false;
-    timer0Ticks = 0;
-    timer0Reload = 0;
-    timer0ClockReload = 0;
-    timer1On = false;
-    timer1Ticks = 0;
-    timer1Reload = 0;
-    timer1ClockReload = 0;
-    timer2On = false;
-    timer2Ticks = 0;
-    timer2Reload = 0;
-    timer2ClockReload = 0;
-    timer3On = false;
-    timer3Ticks = 0;
-    timer3Reload = 0;
-    timer3ClockReload = 0;
-    dma0Source = 0;
-    dma0Dest = 0;
-    dma1Source = 0;
-    dma1Dest = 0;
-    dma2Source = 0;
-    dma2Dest = 0;
-    dma3Source = 0;
-    dma3Dest = 0;
-    renderLine = mode0RenderLine;
-    fxOn = false;
-    windowOn = false;
-    frameCount = 0;
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    gbaCore.holdState = false;
+    gbaCore.holdType = 0;
+
+    gbaCore.biosProtected[0] = 0x00;
+    gbaCore.biosProtected[1] = 0xf0;
+    gbaCore.biosProtected[2] = 0x29;
+    gbaCore.biosProtected[3] = 0xe1;
+
+    CPUSyncEventTicks();
+    gbaCore.lcdTicks = (coreOptions.useBios && !coreOptions.skipBios) ? 1008 : 208;
+    gbaCore.timer0On = false;
+    gbaCore.timer0Ticks = 0;
+    gbaCore.timer0Reload = 0;
+    gbaCore.timer0ClockReload = 0;
+    gbaCore.timer1On = false;
+    gbaCore.timer1Ticks = 0;
+    gbaCore.timer1Reload = 0;
+    gbaCore.timer1ClockReload = 0;
+    gbaCore.timer2On = false;
+    gbaCore.timer2Ticks = 0;
+    gbaCore.timer2Reload = 0;
+    gbaCore.timer2ClockReload = 0;
+    gbaCore.timer3On = false;
+    gbaCore.timer3Ticks = 0;
+    gbaCore.timer3Reload = 0;
+    gbaCore.timer3ClockReload = 0;
+    CPUScheduleEvents();
+    gbaCore.dma0Source = 0;
+    gbaCore.dma0Dest = 0;
+    gbaCore.dma1Source = 0;
+    gbaCore.dma1Dest = 0;
+    gbaCore.dma2Source = 0;
+    gbaCore.dma2Dest = 0;
+    gbaCore.dma3Source = 0;
+    gbaCore.dma3Dest = 0;
+    gbaCore.renderLine = gfxRenderLine<0, false, false, false>;
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+    gbaCore.skipLine = gfxGetSkipLine(0);
+#endif
+    gbaCore.fxOn = false;
+    gbaCore.windowOn = false;
+    gbaCore.frameCount = 0;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
 
     CPUUpdateRenderBuffers(true);
 
     for (int i = 0; i < 256; i++) {
-        map[i].address = (uint8_t*)&dummyAddress;
-        map[i].mask = 0;
-    }
-
-    map[0].address = g_bios;
-    map[2].address = g_workRAM;
-    map[3].address = g_internalRAM;
-    map[4].address = g_ioMem;
-    map[5].address = g_paletteRAM;
-    map[6].address = g_vram;
-    map[7].address = g_oam;
-    map[8].address = g_rom;
-    map[9].address = g_rom;
-    map[10].address = g_rom;
-    map[12].address = g_rom;
-    map[14].address = flashSaveMemory;
+        gbaCore.map[i].address = (uint8_t*)&gbaCore.dummyAddress;
+        gbaCore.map[i].mask = 0;
+    }
+
+    gbaCore.map[0].address = gbaCore.g_bios;
+    gbaCore.map[2].address = gbaCore.g_workRAM;
+    gbaCore.map[3].address = gbaCore.g_internalRAM;
+    gbaCore.map[4].address = gbaCore.g_ioMem;
+    gbaCore.map[5].address = gbaCore.g_paletteRAM;
+    gbaCore.map[6].address = gbaCore.g_vram;
+    gbaCore.map[7].address = gbaCore.g_oam;
+    gbaCore.map[8].address = gbaCore.g_rom;
+    gbaCore.map[9].address = gbaCore.g_rom;
+    gbaCore.map[10].address = gbaCore.g_rom;
+    gbaCore.map[12].address = gbaCore.g_rom;
+    gbaCore.map[14].address = gbaCore.flashSaveMemory;
 
     SetMapMasks();
+    cpuUpdatePageTable();
 
     soundReset();
 
@@ -3681,65 +3668,62 @@ void CPUReset()
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 
-    cpuDmaRunning = false;
+    gbaCore.cpuDmaRunning = false;
 
-    lastTime = systemGetClock();
+    gbaCore.lastTime = systemGetClock();
 
-    SWITicks = 0;
+    gbaCore.SWITicks = 0;
 }
 
 void CPUInterrupt()
 {
-    uint32_t PC = reg[15].I;
-    bool savedState = armState;
+    uint32_t PC = gbaCore.reg[15].I;
+    bool savedState = gbaCore.armState;
     CPUSwitchMode(0x12, true, false);
-    reg[14].I = PC;
+    gbaCore.reg[14].I = PC;
     if (!savedState)
-        reg[14].I += 2;
-    reg[15].I = 0x18;
-    armState = true;
-    armIrqEnable = false;
+        gbaCore.reg[14].I += 2;
+    gbaCore.reg[15].I = 0x18;
+    gbaCore.armState = true;
+    gbaCore.armIrqEnable = false;
 
-    armNextPC = reg[15].I;
-    reg[15].I += 4;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 4;
     ARM_PREFETCH;
 
     //  if(!holdState)
-    biosProtected[0] = 0x02;
-    biosProtected[1] = 0xc0;
-    biosProtected[2] = 0x5e;
-    biosProtected[3] = 0xe5;
+    gbaCore.biosProtected[0] = 0x02;
+    gbaCore.biosProtected[1] = 0xc0;
+    gbaCore.biosProtected[2] = 0x5e;
+    gbaCore.biosProtected[3] = 0xe5;
 }
 
-static uint32_t joy;
-static bool has_frames;
-
 static void gbaUpdateJoypads(void)
 {
     // update joystick information
     if (systemReadJoypads())
         // read default joystick
-        joy = systemReadJoypad(-1);
+        gbaCore.joy = systemReadJoypad(-1);
 
-    P1 = 0x03FF ^ (joy & 0x3FF);
+    gbaCore.P1 = 0x03FF ^ (gbaCore.joy & 0x3FF);
     systemUpdateMotionSensor();
-    UPDATE_REG(0x130, P1);
-    uint16_t P1CNT = READ16LE(((uint16_t*)&g_ioMem[0x132]));
+    UPDATE_REG(0x130, gbaCore.P1);
+    uint16_t P1CNT = READ16LE(((uint16_t*)&gbaCore.g_ioMem[0x132]));
 
     // this seems wrong, but there are cases where the game
     // can enter the stop state without requesting an IRQ from
     // the joypad.
-    if ((P1CNT & 0x4000) || stopState) {
-        uint16_t p1 = (0x3FF ^ P1) & 0x3FF;
+    if ((P1CNT & 0x4000) || gbaCore.stopState) {
+        uint16_t p1 = (0x3FF ^ gbaCore.P1) & 0x3FF;
         if (P1CNT & 0x8000) {
             if (p1 == (P1CNT & 0x3FF)) {
-                IF |= 0x1000;
-                UPDATE_REG(0x202, IF);
+                gbaCore.IF |= 0x1000;
+                UPDATE_REG(0x202, gbaCore.IF);
             }
         } else {
             if (p1 & P1CNT) {
-                IF |= 0x1000;
-                UPDATE_REG(0x202, IF);
+                gbaCore.IF |= 0x1000;
+                UPDATE_REG(0x202, gbaCore.IF);
             }
         }
     }
@@ -3749,8 +3733,10 @@ void CPULoop(int ticks)
 {
     int clockTicks;
     int timerOverflow = 0;
+    uint32_t dueEvents;
     // variable used by the CPU core
-    cpuTotalTicks = 0;
+    gbaCore.cpuTotalTicks = 0;
+    cpuIdleLoopReset();
 
 #ifndef NO_LINK
 // shuffle2: what's the purpose?
@@ -3758,125 +3744,133 @@ void CPULoop(int ticks)
 //cpuNextEvent = 1;
 #endif
 
-    cpuBreakLoop = false;
-    cpuNextEvent = CPUUpdateTicks();
-    if (cpuNextEvent > ticks)
-        cpuNextEvent = ticks;
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+    // the frontend may read or reallocate g_pix once we return
+    GfxThreadsScope renderThreads;
+#endif
+
+    gbaCore.cpuBreakLoop = false;
+    CPUScheduleRtc();
+    gbaCore.cpuNextEvent = CPUUpdateTicks();
+    if (gbaCore.cpuNextEvent > ticks)
+        gbaCore.cpuNextEvent = ticks;
 
     for (;;) {
-        if (!holdState && !SWITicks) {
-            if (armState) {
-                armOpcodeCount++;
+        if (!gbaCore.holdState && !gbaCore.SWITicks) {
+            if (gbaCore.armState) {
+                gbaCore.armOpcodeCount++;
                 if (!armExecute())
                     return;
-                if (debugger)
+                if (gbaCore.debugger)
                     return;
             } else {
-                thumbOpcodeCount++;
+                gbaCore.thumbOpcodeCount++;
                 if (!thumbExecute())
                     return;
-                if (debugger)
+                if (gbaCore.debugger)
                     return;
             }
             clockTicks = 0;
         } else
             clockTicks = CPUUpdateTicks();
 
-        cpuTotalTicks += clockTicks;
-
-        if (rtcIsEnabled())
-            rtcUpdateTime(cpuTotalTicks);
+        gbaCore.cpuTotalTicks += clockTicks;
 
-        if (cpuTotalTicks >= cpuNextEvent) {
-            int remainingTicks = cpuTotalTicks - cpuNextEvent;
+        if (gbaCore.cpuTotalTicks >= gbaCore.cpuNextEvent) {
+            int remainingTicks = gbaCore.cpuTotalTicks - gbaCore.cpuNextEvent;
 
-            if (SWITicks) {
-                SWITicks -= clockTicks;
-                if (SWITicks < 0)
-                    SWITicks = 0;
+            if (gbaCore.SWITicks) {
+                gbaCore.SWITicks -= clockTicks;
+                if (gbaCore.SWITicks < 0)
+                    gbaCore.SWITicks = 0;
             }
 
-            clockTicks = cpuNextEvent;
-            cpuTotalTicks = 0;
+            clockTicks = gbaCore.cpuNextEvent;
+            gbaCore.cpuTotalTicks = 0;
+            cpuIdleLoopReset();
 
         updateLoop:
 
-            if (IRQTicks) {
-                IRQTicks -= clockTicks;
-                if (IRQTicks < 0)
-                    IRQTicks = 0;
+            gbaSchedulerAdvance(clockTicks);
+
+            // timers don't count in stop state
+            if (gbaCore.stopState) {
+                for (int event = kGbaEventTimer0; event <= kGbaEventTimer3; event++) {
+                    if (gbaSchedulerPending((GbaEvent)event))
+                        gbaSchedulerReschedule((GbaEvent)event, clockTicks);
+                }
             }
 
-            lcdTicks -= clockTicks;
+            dueEvents = gbaSchedulerTakeDue();
+
+            gbaCore.soundTicks += clockTicks;
 
-            soundTicks += clockTicks;
+            if (dueEvents & gbaEventBit(kGbaEventRtc)) {
+                CPUUpdateRtc();
+                gbaSchedulerSchedule(kGbaEventRtc, rtcTicksToNextSecond());
+            }
 
-            if (lcdTicks <= 0) {
-                if (DISPSTAT & 1) { // V-BLANK
+            if (dueEvents & gbaEventBit(kGbaEventLcd)) {
+                if (gbaCore.DISPSTAT & 1) { // V-BLANK
                     // if in V-Blank mode, keep computing...
-                    if (DISPSTAT & 2) {
-                        lcdTicks += 1008;
-                        VCOUNT++;
-                        UPDATE_REG(0x06, VCOUNT);
-                        DISPSTAT &= 0xFFFD;
-                        UPDATE_REG(0x04, DISPSTAT);
+                    if (gbaCore.DISPSTAT & 2) {
+                        gbaSchedulerReschedule(kGbaEventLcd, 1008);
+                        gbaCore.VCOUNT++;
+                        UPDATE_REG(0x06, gbaCore.VCOUNT);
+                        gbaCore.DISPSTAT &= 0xFFFD;
+                        UPDATE_REG(0x04, gbaCore.DISPSTAT);
                         CPUCompareVCOUNT();
                     } else {
-                        lcdTicks += 224;
-                        DISPSTAT |= 2;
-                        UPDATE_REG(0x04, DISPSTAT);
-                        if (DISPSTAT & 16) {
-                            IF |= 2;
-                            UPDATE_REG(0x202, IF);
+                        gbaSchedulerReschedule(kGbaEventLcd, 224);
+                        gbaCore.DISPSTAT |= 2;
+                        UPDATE_REG(0x04, gbaCore.DISPSTAT);
+                        if (gbaCore.DISPSTAT & 16) {
+                            gbaCore.IF |= 2;
+                            UPDATE_REG(0x202, gbaCore.IF);
                         }
                     }
 
-                    if (VCOUNT > 227) { //Reaching last line
-                        DISPSTAT &= 0xFFFC;
-                        UPDATE_REG(0x04, DISPSTAT);
-                        VCOUNT = 0;
-                        UPDATE_REG(0x06, VCOUNT);
+                    if (gbaCore.VCOUNT > 227) { //Reaching last line
+                        gbaCore.DISPSTAT &= 0xFFFC;
+                        UPDATE_REG(0x04, gbaCore.DISPSTAT);
+                        gbaCore.VCOUNT = 0;
+                        UPDATE_REG(0x06, gbaCore.VCOUNT);
                         CPUCompareVCOUNT();
                     }
                 } else {
                     int framesToSkip = systemFrameSkip;
 
-                    static bool speedup_throttle_set = false;
-                    bool turbo_button_pressed        = (joy >> 10) & 1;
+                    bool turbo_button_pressed        = (gbaCore.joy >> 10) & 1;
 #ifndef __LIBRETRO__
-                    static uint32_t last_throttle;
-                    static bool current_volume_saved = false;
-                    static float current_volume;
 
                     if (turbo_button_pressed) {
                         if (coreOptions.speedup_frame_skip)
                             framesToSkip = coreOptions.speedup_frame_skip;
                         else {
-                            if (!speedup_throttle_set && coreOptions.throttle != coreOptions.speedup_throttle) {
-                                last_throttle = coreOptions.throttle;
+                            if (!gbaCore.speedup_throttle_set && coreOptions.throttle != coreOptions.speedup_throttle) {
+                                gbaCore.last_throttle = coreOptions.throttle;
                                 soundSetThrottle(DowncastU16(coreOptions.speedup_throttle));
-                                speedup_throttle_set = true;
+                                gbaCore.speedup_throttle_set = true;
                             }
 
                             if (coreOptions.speedup_throttle_frame_skip)
                                 framesToSkip += static_cast<int>(std::ceil(double(coreOptions.speedup_throttle) / 100.0) - 1);
                         }
 
-                        if (coreOptions.speedup_mute && !current_volume_saved) {
-                            current_volume = soundGetVolume();
-                            current_volume_saved = true;
-                            soundSetVolume(0);
+                        if (coreOptions.speedup_mute && !gbaCore.speedup_silenced) {
+                            soundSetSilent(true);
+                            gbaCore.speedup_silenced = true;
                         }
                     }
                     else {
-                        if (current_volume_saved) {
-                            soundSetVolume(current_volume);
-                            current_volume_saved = false;
+                        if (gbaCore.speedup_silenced) {
+                            soundSetSilent(false);
+                            gbaCore.speedup_silenced = false;
                         }
 
-                        if (speedup_throttle_set) {
-                            soundSetThrottle(DowncastU16(last_throttle));
-                            speedup_throttle_set = false;
+                        if (gbaCore.speedup_throttle_set) {
+                            soundSetThrottle(DowncastU16(gbaCore.last_throttle));
+                            gbaCore.speedup_throttle_set = false;
                         }
                     }
 #else
@@ -3884,222 +3878,97 @@ void CPULoop(int ticks)
                         framesToSkip = 9;
 #endif
 
-                    if (DISPSTAT & 2) {
+                    if (gbaCore.DISPSTAT & 2) {
                         // if in H-Blank, leave it and move to drawing mode
-                        VCOUNT++;
-                        UPDATE_REG(0x06, VCOUNT);
-
-                        lcdTicks += 1008;
-                        DISPSTAT &= 0xFFFD;
-                        if (VCOUNT == 160) {
-                            g_count++;
+                        gbaCore.VCOUNT++;
+                        UPDATE_REG(0x06, gbaCore.VCOUNT);
+
+                        gbaSchedulerReschedule(kGbaEventLcd, 1008);
+                        gbaCore.DISPSTAT &= 0xFFFD;
+                        if (gbaCore.VCOUNT == 160) {
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+                            gfxThreadsFinish();
+#endif
+                            gbaCore.g_count++;
                             systemFrame();
 
-                            if ((g_count % 10) == 0) {
+                            if ((gbaCore.g_count % 10) == 0) {
                                 system10Frames();
                             }
-                            if (g_count == 60) {
+                            if (gbaCore.g_count == 60) {
                                 uint32_t time = systemGetClock();
-                                if (time != lastTime) {
-                                    uint32_t t = 100000 / (time - lastTime);
+                                if (time != gbaCore.lastTime) {
+                                    uint32_t t = 100000 / (time - gbaCore.lastTime);
                                     systemShowSpeed(t);
                                 } else
                                     systemShowSpeed(0);
-                                lastTime = time;
-                                g_count = 0;
+                                gbaCore.lastTime = time;
+                                gbaCore.g_count = 0;
                             }
 
-                            uint32_t ext = (joy >> 10);
+                            uint32_t ext = (gbaCore.joy >> 10);
                             // If no (m) code is enabled, apply the cheats at each LCDline
-                            if ((coreOptions.cheatsEnabled) && (mastercode == 0))
-                                remainingTicks += cheatsCheckKeys(P1 ^ 0x3FF, ext);
+                            if ((coreOptions.cheatsEnabled) && (gbaCore.mastercode == 0))
+                                remainingTicks += cheatsCheckKeys(gbaCore.P1 ^ 0x3FF, ext);
 
                             coreOptions.speedup = false;
 
-                            if (ext & 1 && !speedup_throttle_set)
+                            if (ext & 1 && !gbaCore.speedup_throttle_set)
                                 coreOptions.speedup = true;
 
-                            capture = (ext & 2) ? true : false;
+                            gbaCore.capture = (ext & 2) ? true : false;
 
-                            if (capture && !capturePrevious) {
-                                captureNumber++;
-                                systemScreenCapture(captureNumber);
+                            if (gbaCore.capture && !gbaCore.capturePrevious) {
+                                gbaCore.captureNumber++;
+                                systemScreenCapture(gbaCore.captureNumber);
                             }
-                            capturePrevious = capture;
-
-                            DISPSTAT |= 1;
-                            DISPSTAT &= 0xFFFD;
-                            UPDATE_REG(0x04, DISPSTAT);
-                            if (DISPSTAT & 0x0008) {
-                                IF |= 1;
-                                UPDATE_REG(0x202, IF);
+                            gbaCore.capturePrevious = gbaCore.capture;
+
+                            gbaCore.DISPSTAT |= 1;
+                            gbaCore.DISPSTAT &= 0xFFFD;
+                            UPDATE_REG(0x04, gbaCore.DISPSTAT);
+                            if (gbaCore.DISPSTAT & 0x0008) {
+                                gbaCore.IF |= 1;
+                                UPDATE_REG(0x202, gbaCore.IF);
                             }
                             CPUCheckDMA(1, 0x0f);
 
                             psoundTickfn();
 
-                            if (frameCount >= framesToSkip) {
+                            if (gbaCore.frameCount >= framesToSkip) {
                                 systemDrawScreen();
-                                frameCount = 0;
+                                gbaCore.frameCount = 0;
                             } else {
-                                frameCount++;
+                                gbaCore.frameCount++;
                                 systemSendScreen();
                             }
                             if (systemPauseOnFrame())
                                 ticks = 0;
 
-                            has_frames = true;
+                            gbaCore.has_frames = true;
                         }
 
-                        UPDATE_REG(0x04, DISPSTAT);
+                        UPDATE_REG(0x04, gbaCore.DISPSTAT);
                         CPUCompareVCOUNT();
 
                     } else {
-                        if (frameCount >= framesToSkip) {
-                            (*renderLine)();
-                            switch (systemColorDepth) {
-                            case 8: {
-#ifdef __LIBRETRO__
-                                uint8_t* dest = (uint8_t*)g_pix + 240 * VCOUNT;
-#else
-                                uint8_t* dest = (uint8_t*)g_pix + 242 * (VCOUNT + 1);
-#endif
-                                for (int x = 0; x < 240;) {
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap8[g_lineMix[x++] & 0xFFFF];
-                                }
-// for filters that read past the screen
-#ifndef __LIBRETRO__
-                                *dest++ = 0;
-#endif
-                            } break;
-                            case 16: {
-#ifdef __LIBRETRO__
-                                uint16_t* dest = (uint16_t*)g_pix + 240 * VCOUNT;
-#else
-                                uint16_t* dest = (uint16_t*)g_pix + 242 * (VCOUNT + 1);
-#endif
-                                for (int x = 0; x < 240;) {
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                }
-// for filters that read past the screen
-#ifndef __LIBRETRO__
-                                *dest++ = 0;
-#endif
-                            } break;
-                            case 24: {
-                                uint8_t* dest = (uint8_t*)g_pix + 240 * VCOUNT * 3;
-                                for (int x = 0; x < 240;) {
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                }
-                            } break;
-                            case 32: {
-#ifdef __LIBRETRO__
-                                uint32_t* dest = (uint32_t*)g_pix + 240 * VCOUNT;
+                        if (gbaCore.frameCount >= framesToSkip) {
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+                            gfxThreadsQueueLine(gbaCore.renderLine, gbaCore.skipLine);
 #else
-                                uint32_t* dest = (uint32_t*)g_pix + 241 * (VCOUNT + 1);
+                            gbaCore.gfxLayerEnable = coreOptions.layerEnable;
+                            (*gbaCore.renderLine)();
+                            gfxWriteLine(gbaCore.g_pix, gbaCore.g_lineWriterHashes, gbaCore.VCOUNT);
 #endif
-                                for (int x = 0; x < 240;) {
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                }
-                            } break;
-                            }
                         }
                         // entering H-Blank
-                        DISPSTAT |= 2;
-                        UPDATE_REG(0x04, DISPSTAT);
-                        lcdTicks += 224;
+                        gbaCore.DISPSTAT |= 2;
+                        UPDATE_REG(0x04, gbaCore.DISPSTAT);
+                        gbaSchedulerReschedule(kGbaEventLcd, 224);
                         CPUCheckDMA(2, 0x0f);
-                        if (DISPSTAT & 16) {
-                            IF |= 2;
-                            UPDATE_REG(0x202, IF);
+                        if (gbaCore.DISPSTAT & 16) {
+                            gbaCore.IF |= 2;
+                            UPDATE_REG(0x202, gbaCore.IF);
                         }
                     }
                 }
@@ -4115,108 +3984,110 @@ void CPULoop(int ticks)
                 //soundTicks += SOUND_CLOCK_TICKS;
             //}
 
-            if (!stopState) {
-                if (timer0On) {
-                    timer0Ticks -= clockTicks;
-                    if (timer0Ticks <= 0) {
-                        timer0Ticks += (0x10000 - timer0Reload) << timer0ClockReload;
+            if (!gbaCore.stopState) {
+                if (gbaCore.timer0On) {
+                    if (dueEvents & gbaEventBit(kGbaEventTimer0)) {
+                        gbaSchedulerReschedule(kGbaEventTimer0, (0x10000 - gbaCore.timer0Reload) << gbaCore.timer0ClockReload);
                         timerOverflow |= 1;
                         soundTimerOverflow(0);
-                        if (TM0CNT & 0x40) {
-                            IF |= 0x08;
-                            UPDATE_REG(0x202, IF);
+                        if (gbaCore.TM0CNT & 0x40) {
+                            gbaCore.IF |= 0x08;
+                            UPDATE_REG(0x202, gbaCore.IF);
                         }
                     }
-                    TM0D = 0xFFFF - DowncastU16(timer0Ticks >> timer0ClockReload);
-                    UPDATE_REG(0x100, TM0D);
+                    gbaCore.TM0D = 0xFFFF - DowncastU16(gbaSchedulerTicksLeft(kGbaEventTimer0) >> gbaCore.timer0ClockReload);
+                    UPDATE_REG(0x100, gbaCore.TM0D);
                 }
 
-                if (timer1On) {
-                    if (TM1CNT & 4) {
+                if (gbaCore.timer1On) {
+                    if (gbaCore.TM1CNT & 4) {
                         if (timerOverflow & 1) {
-                            TM1D++;
-                            if (TM1D == 0) {
-                                TM1D += DowncastU16(timer1Reload);
+                            gbaCore.TM1D++;
+                            if (gbaCore.TM1D == 0) {
+                                gbaCore.TM1D += DowncastU16(gbaCore.timer1Reload);
                                 timerOverflow |= 2;
                                 soundTimerOverflow(1);
-                                if (TM1CNT & 0x40) {
-                                    IF |= 0x10;
-                                    UPDATE_REG(0x202, IF);
+                                if (gbaCore.TM1CNT & 0x40) {
+                                    gbaCore.IF |= 0x10;
+                                    UPDATE_REG(0x202, gbaCore.IF);
                                 }
                             }
-                            UPDATE_REG(0x104, TM1D);
+                            UPDATE_REG(0x104, gbaCore.TM1D);
                         }
                     } else {
-                        timer1Ticks -= clockTicks;
-                        if (timer1Ticks <= 0) {
-                            timer1Ticks += (0x10000 - timer1Reload) << timer1ClockReload;
+                        if (dueEvents & gbaEventBit(kGbaEventTimer1)) {
+                            gbaSchedulerReschedule(kGbaEventTimer1, (0x10000 - gbaCore.timer1Reload) << gbaCore.timer1ClockReload);
                             timerOverflow |= 2;
                             soundTimerOverflow(1);
-                            if (TM1CNT & 0x40) {
-                                IF |= 0x10;
-                                UPDATE_REG(0x202, IF);
+                            if (gbaCore.TM1CNT & 0x40) {
+                                gbaCore.IF |= 0x10;
+                                UPDATE_REG(0x202, gbaCore.IF);
                             }
                         }
-                        TM1D = 0xFFFF - DowncastU16(timer1Ticks >> timer1ClockReload);
-                        UPDATE_REG(0x104, TM1D);
+                        gbaCore.TM1D = 0xFFFF - DowncastU16(gbaSchedulerTicksLeft(kGbaEventTimer1) >> gbaCore.timer1ClockReload);
+                        UPDATE_REG(0x104, gbaCore.TM1D);
                     }
                 }
 
-                if (timer2On) {
-                    if (TM2CNT & 4) {
+                if (gbaCore.timer2On) {
+                    if (gbaCore.TM2CNT & 4) {
                         if (timerOverflow & 2) {
-                            TM2D++;
-                            if (TM2D == 0) {
-                                TM2D += DowncastU16(timer2Reload);
+                            gbaCore.TM2D++;
+                            if (gbaCore.TM2D == 0) {
+                                gbaCore.TM2D += DowncastU16(gbaCore.timer2Reload);
                                 timerOverflow |= 4;
-                                if (TM2CNT & 0x40) {
-                                    IF |= 0x20;
-                                    UPDATE_REG(0x202, IF);
+                                if (gbaCore.TM2CNT & 0x40) {
+                                    gbaCore.IF |= 0x20;
+                                    UPDATE_REG(0x202, gbaCore.IF);
                                 }
                             }
-                            UPDATE_REG(0x108, TM2D);
+                            UPDATE_REG(0x108, gbaCore.TM2D);
                         }
                     } else {
-                        timer2Ticks -= clockTicks;
-                        if (timer2Ticks <= 0) {
-                            timer2Ticks += (0x10000 - timer2Reload) << timer2ClockReload;
+                        if (dueEvents & gbaEventBit(kGbaEventTimer2)) {
+                            gbaSchedulerReschedule(kGbaEventTimer2, (0x10000 - gbaCore.timer2Reload) << gbaCore.timer2ClockReload);
                             timerOverflow |= 4;
-                            if (TM2CNT & 0x40) {
-                                IF |= 0x20;
-                                UPDATE_REG(0x202, IF);
+                            if (gbaCore.TM2CNT & 0x40) {
+                                gbaCore.IF |= 0x20;
+                                UPDATE_REG(0x202, gbaCore.IF);
                             }
                         }
-                        TM2D = 0xFFFF - DowncastU16(timer2Ticks >> timer2ClockReload);
-                        UPDATE_REG(0x108, TM2D);
+                        gbaCore.TM2D = 0xFFFF - DowncastU16(gbaSchedulerTicksLeft(kGbaEventTimer2) >> gbaCore.timer2ClockReload);
+                        UPDATE_REG(0x108, gbaCore.TM2D);
                     }
                 }
 
-                if (timer3On) {
-                    if (TM3CNT & 4) {
+                if (gbaCore.timer3On) {
+                    if (gbaCore.TM3CNT & 4) {
                         if (timerOverflow & 4) {
-                            TM3D++;
-                            if (TM3D == 0) {
-                                TM3D += DowncastU16(timer3Reload);
-                                if (TM3CNT & 0x40) {
-                                    IF |= 0x40;
-                                    UPDATE_REG(0x202, IF);
+                            gbaCore.TM3D++;
+                            if (gbaCore.TM3D == 0) {
+                                gbaCore.TM3D += DowncastU16(gbaCore.timer3Reload);
+                                if (gbaCore.TM3CNT & 0x40) {
+                                    gbaCore.IF |= 0x40;
+                                    UPDATE_REG(0x202, gbaCore.IF);
                                 }
                             }
-                            UPDATE_REG(0x10C, TM3D);
+                            UPDATE_REG(0x10C, gbaCore.TM3D);
                         }
                     } else {
-                        timer3Ticks -= clockTicks;
-                        if (timer3Ticks <= 0) {
-                            timer3Ticks += (0x10000 - timer3Reload) << timer3ClockReload;
-                            if (TM3CNT & 0x40) {
-                                IF |= 0x40;
-                                UPDATE_REG(0x202, IF);
+                        if (dueEvents & gbaEventBit(kGbaEventTimer3)) {
+                            gbaSchedulerReschedule(kGbaEventTimer3, (0x10000 - gbaCore.timer3Reload) << gbaCore.timer3ClockReload);
+                            if (gbaCore.TM3CNT & 0x40) {
+                                gbaCore.IF |= 0x40;
+                                UPDATE_REG(0x202, gbaCore.IF);
                             }
                         }
-                        TM3D = 0xFFFF - DowncastU16(timer3Ticks >> timer3ClockReload);
-                        UPDATE_REG(0x10C, TM3D);
+                        gbaCore.TM3D = 0xFFFF - DowncastU16(gbaSchedulerTicksLeft(kGbaEventTimer3) >> gbaCore.timer3ClockReload);
+                        UPDATE_REG(0x10C, gbaCore.TM3D);
                     }
                 }
+            } else {
+                // a timer that was already late stays due until the CPU wakes up
+                for (int event = kGbaEventTimer0; event <= kGbaEventTimer3; event++) {
+                    if (dueEvents & gbaEventBit((GbaEvent)event))
+                        gbaSchedulerReschedule((GbaEvent)event, 0);
+                }
             }
 
             timerOverflow = 0;
@@ -4229,7 +4100,7 @@ void CPULoop(int ticks)
                     profile_segment* seg = profilSegment;
                     do {
                         uint16_t* b = (uint16_t*)seg->sbuf;
-                        int pc = ((reg[15].I - seg->s_lowpc) * seg->s_scale) / 0x10000;
+                        int pc = ((gbaCore.reg[15].I - seg->s_lowpc) * seg->s_scale) / 0x10000;
                         if (pc >= 0 && pc < seg->ssiz) {
                             b[pc]++;
                             break;
@@ -4248,62 +4119,62 @@ void CPULoop(int ticks)
                 LinkUpdate(clockTicks);
 #endif
 
-            cpuNextEvent = CPUUpdateTicks();
+            gbaCore.cpuNextEvent = CPUUpdateTicks();
 
-            if (cpuDmaTicksToUpdate > 0) {
-                if (cpuDmaTicksToUpdate > cpuNextEvent)
-                    clockTicks = cpuNextEvent;
+            if (gbaCore.cpuDmaTicksToUpdate > 0) {
+                if (gbaCore.cpuDmaTicksToUpdate > gbaCore.cpuNextEvent)
+                    clockTicks = gbaCore.cpuNextEvent;
                 else
-                    clockTicks = cpuDmaTicksToUpdate;
-                cpuDmaTicksToUpdate -= clockTicks;
-                if (cpuDmaTicksToUpdate < 0)
-                    cpuDmaTicksToUpdate = 0;
+                    clockTicks = gbaCore.cpuDmaTicksToUpdate;
+                gbaCore.cpuDmaTicksToUpdate -= clockTicks;
+                if (gbaCore.cpuDmaTicksToUpdate < 0)
+                    gbaCore.cpuDmaTicksToUpdate = 0;
                 goto updateLoop;
             }
 
 #ifndef NO_LINK
             // shuffle2: what's the purpose?
-            if (GetLinkMode() != LINK_DISCONNECTED || gba_joybus_active)
-                cpuNextEvent = 1;
+            if (GetLinkMode() != LINK_DISCONNECTED || gbaCore.gba_joybus_active)
+                gbaCore.cpuNextEvent = 1;
 #endif
 
-            if (IF && (IME & 1) && armIrqEnable) {
-                int res = IF & IE;
-                if (stopState)
+            if (gbaCore.IF && (gbaCore.IME & 1) && gbaCore.armIrqEnable) {
+                int res = gbaCore.IF & gbaCore.IE;
+                if (gbaCore.stopState)
                     res &= 0x3080;
                 if (res) {
-                    if (intState) {
-                        if (!IRQTicks) {
+                    if (gbaCore.intState) {
+                        if (!gbaSchedulerPending(kGbaEventIrq)) {
                             CPUInterrupt();
-                            intState = false;
-                            holdState = false;
-                            stopState = false;
-                            holdType = 0;
+                            gbaCore.intState = false;
+                            gbaCore.holdState = false;
+                            gbaCore.stopState = false;
+                            gbaCore.holdType = 0;
                         }
                     } else {
-                        if (!holdState) {
-                            intState = true;
-                            IRQTicks = 7;
-                            if (cpuNextEvent > IRQTicks)
-                                cpuNextEvent = IRQTicks;
+                        if (!gbaCore.holdState) {
+                            gbaCore.intState = true;
+                            gbaSchedulerSchedule(kGbaEventIrq, 7);
+                            if (gbaCore.cpuNextEvent > 7)
+                                gbaCore.cpuNextEvent = 7;
                         } else {
                             CPUInterrupt();
-                            holdState = false;
-                            stopState = false;
-                            holdType = 0;
+                            gbaCore.holdState = false;
+                            gbaCore.stopState = false;
+                            gbaCore.holdType = 0;
                         }
                     }
 
                     // Stops the SWI Ticks emulation if an IRQ is executed
                     //(to avoid problems with nested IRQ/SWI)
-                    if (SWITicks)
-                        SWITicks = 0;
+                    if (gbaCore.SWITicks)
+                        gbaCore.SWITicks = 0;
                 }
             }
 
             if (remainingTicks > 0) {
-                if (remainingTicks > cpuNextEvent)
-                    clockTicks = cpuNextEvent;
+                if (remainingTicks > gbaCore.cpuNextEvent)
+                    clockTicks = gbaCore.cpuNextEvent;
                 else
                     clockTicks = remainingTicks;
                 remainingTicks -= clockTicks;
@@ -4312,14 +4183,14 @@ void CPULoop(int ticks)
                 goto updateLoop;
             }
 
-            if (timerOnOffDelay)
+            if (gbaCore.timerOnOffDelay)
                 applyTimer();
 
-            if (cpuNextEvent > ticks)
-                cpuNextEvent = ticks;
+            if (gbaCore.cpuNextEvent > ticks)
+                gbaCore.cpuNextEvent = ticks;
 
             // end loop when a frame is done
-            if (ticks <= 0 || cpuBreakLoop || has_frames)
+            if (ticks <= 0 || gbaCore.cpuBreakLoop || gbaCore.has_frames)
                 break;
         }
     }
@@ -4331,7 +4202,7 @@ void CPULoop(int ticks)
 
 void gbaEmulate(int ticks)
 {
-    has_frames = false;
+    gbaCore.has_frames = false;
 
     // Read and process inputs
     gbaUpdateJoypads();
@@ -4342,7 +4213,7 @@ void gbaEmulate(int ticks)
     // wrapped in loop in case frames has not been written yet
     do {
         CPULoop(ticks);
-    } while (!has_frames);
+    } while (!gbaCore.has_frames);
 }
 
 struct EmulatedSystem GBASystem = {
@@ -96,29 +96,10 @@ typedef union {
 #endif
 } reg_pair;
 
-#ifndef NO_GBA_MAP
-extern memoryMap map[256];
-#endif
-
-extern uint8_t biosProtected[4];
-
-extern void (*cpuSaveGameFunc)(uint32_t, uint8_t);
-
-extern bool cpuSramEnabled;
-extern bool cpuFlashEnabled;
-extern bool cpuEEPROMEnabled;
-extern bool cpuEEPROMSensorEnabled;
-extern bool debugger;
-
-#ifdef VBAM_ENABLE_DEBUGGER
-extern uint8_t freezeWorkRAM[0x40000];
-extern uint8_t freezeInternalRAM[0x8000];
-extern uint8_t freezeVRAM[0x18000];
-extern uint8_t freezeOAM[0x400];
-extern uint8_t freezePRAM[0x400];
-extern bool debugger_last;
-extern int oldreg[18];
-extern char oldbuffer[10];
+#if defined(__i386__) || defined(__x86_64__)
+#define INSN_REGPARM __attribute__((regparm(1)))
+#else
+#define INSN_REGPARM /*nothing*/
 #endif
 
 extern bool CPUReadGSASnapshot(const char*);
@@ -132,6 +113,8 @@ extern bool CPUWritePNGFile(const char*);
 extern bool CPUWriteBMPFile(const char*);
 extern void CPUCleanUp();
 extern void CPUUpdateRender();
+extern void CPUUpdateWindow0();
+extern void CPUUpdateWindow1();
 extern void CPUUpdateRenderBuffers(bool);
 extern bool CPUReadMemState(char*, int);
 extern bool CPUWriteMemState(char*, int);
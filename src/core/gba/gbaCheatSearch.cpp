@@ -3,13 +3,6 @@
 #include <cstdlib>
 #include <cstring>
 
-CheatSearchBlock cheatSearchBlocks[4];
-
-CheatSearchData cheatSearchData = {
-    0,
-    cheatSearchBlocks
-};
-
 static bool cheatSearchEQ(uint32_t a, uint32_t b)
 {
     return a == b;
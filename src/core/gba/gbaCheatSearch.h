@@ -3,6 +3,8 @@
 
 #include <cstdint>
 
+#include "core/base/system.h"
+
 struct CheatSearchBlock {
     int size;
     uint32_t offset;
@@ -33,8 +35,6 @@ enum { BITS_8,
 
 #define IS_BIT_SET(bits, off) (bits)[(off) >> 3] & (1 << ((off)&7))
 
-extern CheatSearchData cheatSearchData;
-
 void cheatSearchCleanup(CheatSearchData* cs);
 void cheatSearchStart(const CheatSearchData* cs);
 void cheatSearch(const CheatSearchData* cs, int compare, int size, bool isSigned);
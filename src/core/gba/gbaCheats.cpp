@@ -8,6 +8,7 @@
 #include "core/gba/gba.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaDecodeCache.h"
 
 #if __STDC_WANT_SECURE_LIB__
 #define snprintf sprintf_s
@@ -181,29 +182,6 @@
 #define CHEATS_16_BIT_WRITE 114
 #define CHEATS_32_BIT_WRITE 115
 
-CheatsData cheatsList[MAX_CHEATS];
-int cheatsNumber = 0;
-uint32_t rompatch2addr[4];
-uint16_t rompatch2val[4];
-uint16_t rompatch2oldval[4];
-
-uint8_t cheatsCBASeedBuffer[0x30];
-uint32_t cheatsCBASeed[4];
-uint32_t cheatsCBATemporaryValue = 0;
-uint16_t cheatsCBATable[256];
-bool cheatsCBATableGenerated = false;
-uint16_t super = 0;
-extern uint32_t mastercode;
-
-uint8_t cheatsCBACurrentSeed[12] = {
-    0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00
-};
-
-uint32_t seeds_v1[4];
-uint32_t seeds_v3[4];
-
 uint32_t seed_gen(uint8_t upper, uint8_t seed, uint8_t* deadtable1, uint8_t* deadtable2);
 
 //seed tables for AR v1
@@ -283,38 +261,53 @@ uint8_t v3_deadtable2[256] = {
 };
 
 #define debuggerReadMemory(addr) \
-    READ32LE((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ32LE((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define debuggerReadHalfWord(addr) \
-    READ16LE((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ16LE((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define debuggerReadByte(addr) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]
-
-#define debuggerWriteMemory(addr, value) \
-    WRITE32LE(&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask], value)
-
-#define debuggerWriteHalfWord(addr, value) \
-    WRITE16LE(&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask], value)
-
-#define debuggerWriteByte(addr, value) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask] = (value)
+    gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]
+
+#define debuggerWriteMemory(addr, value)                                             \
+    do {                                                                             \
+        cpuDecodeCacheInvalidate(addr);                                              \
+        WRITE32LE(&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask], value); \
+    } while (0)
+
+#define debuggerWriteHalfWord(addr, value)                                           \
+    do {                                                                             \
+        cpuDecodeCacheInvalidate(addr);                                              \
+        WRITE16LE(&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask], value); \
+    } while (0)
+
+#define debuggerWriteByte(addr, value)                                      \
+    do {                                                                    \
+        cpuDecodeCacheInvalidate(addr);                                     \
+        gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask] = (value); \
+    } while (0)
 
 #define CHEAT_IS_HEX(a) (((a) >= 'A' && (a) <= 'F') || ((a) >= '0' && (a) <= '9'))
 
-#define CHEAT_PATCH_ROM_16BIT(a, v) \
-    WRITE16LE(((uint16_t*)&g_rom[(a)&0x1ffffff]), v);
+#define CHEAT_PATCH_ROM_16BIT(a, v)                           \
+    do {                                                      \
+        WRITE16LE(((uint16_t*)&gbaCore.g_rom[(a)&0x1ffffff]), v);     \
+        cpuDecodeCacheFlush();                                \
+    } while (0)
 
-#define CHEAT_PATCH_ROM_32BIT(a, v) \
-    WRITE32LE(((uint32_t*)&g_rom[(a)&0x1ffffff]), v);
+#define CHEAT_PATCH_ROM_32BIT(a, v)                           \
+    do {                                                      \
+        WRITE32LE(((uint32_t*)&gbaCore.g_rom[(a)&0x1ffffff]), v);     \
+        cpuDecodeCacheFlush();                                \
+    } while (0)
 
 static bool isMultilineWithData(int i)
 {
     // we consider it a multiline code if it has more than one line of data
     // otherwise, it can still be considered a single code
     // (Only CBA codes can be true multilines !!!)
-    if (i < cheatsNumber && i >= 0)
-        switch (cheatsList[i].size) {
+    if (i < gbaCore.cheatsNumber && i >= 0)
+        switch (gbaCore.cheatsList[i].size) {
         case INT_8_BIT_WRITE:
         case INT_16_BIT_WRITE:
         case INT_32_BIT_WRITE:
@@ -439,11 +432,11 @@ static bool isMultilineWithData(int i)
 
 static int getCodeLength(int num)
 {
-    if (num >= cheatsNumber || num < 0)
+    if (num >= gbaCore.cheatsNumber || num < 0)
         return 1;
 
     // this is for all the codes that are true multiline
-    switch (cheatsList[num].size) {
+    switch (gbaCore.cheatsList[num].size) {
     case INT_8_BIT_WRITE:
     case INT_16_BIT_WRITE:
     case INT_32_BIT_WRITE:
@@ -561,7 +554,7 @@ static int getCodeLength(int num)
     case CBA_SLIDE_CODE:
         return 2;
     case CBA_SUPER:
-        return ((((cheatsList[num].value - 1) & 0xFFFF) / 3) + 1);
+        return ((((gbaCore.cheatsList[num].value - 1) & 0xFFFF) / 3) + 1);
     }
     return 1;
 }
@@ -571,44 +564,44 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
     bool onoff = true;
     int ticks = 0;
     int i;
-    mastercode = 0;
+    gbaCore.mastercode = 0;
 
     for (i = 0; i < 4; i++)
-        if (rompatch2addr[i] != 0) {
-            CHEAT_PATCH_ROM_16BIT(rompatch2addr[i], rompatch2oldval[i]);
-            rompatch2addr[i] = 0;
+        if (gbaCore.rompatch2addr[i] != 0) {
+            CHEAT_PATCH_ROM_16BIT(gbaCore.rompatch2addr[i], gbaCore.rompatch2oldval[i]);
+            gbaCore.rompatch2addr[i] = 0;
         }
 
-    for (i = 0; i < cheatsNumber; i++) {
-        if (!cheatsList[i].enabled) {
+    for (i = 0; i < gbaCore.cheatsNumber; i++) {
+        if (!gbaCore.cheatsList[i].enabled) {
             // make sure we skip other lines in this code
             i += getCodeLength(i) - 1;
             continue;
         }
-        switch (cheatsList[i].size) {
+        switch (gbaCore.cheatsList[i].size) {
         case GSA_CODES_ON:
             onoff = true;
             break;
         case GSA_SLOWDOWN:
             // check if button was pressed and released, if so toggle our state
-            if ((cheatsList[i].status & 4) && !(extended & 4))
-                cheatsList[i].status ^= 1;
+            if ((gbaCore.cheatsList[i].status & 4) && !(extended & 4))
+                gbaCore.cheatsList[i].status ^= 1;
             if (extended & 4)
-                cheatsList[i].status |= 4;
+                gbaCore.cheatsList[i].status |= 4;
             else
-                cheatsList[i].status &= ~4;
+                gbaCore.cheatsList[i].status &= ~4;
 
-            if (cheatsList[i].status & 1)
-                ticks += ((cheatsList[i].value & 0xFFFF) * 7);
+            if (gbaCore.cheatsList[i].status & 1)
+                ticks += ((gbaCore.cheatsList[i].value & 0xFFFF) * 7);
             break;
         case GSA_8_BIT_SLIDE:
             i++;
-            if (i < cheatsNumber) {
-                uint32_t addr = cheatsList[i - 1].value;
-                uint8_t value = DowncastU8(cheatsList[i].rawaddress);
-                const uint8_t vinc = DowncastU8(cheatsList[i].value >> 24);
-                uint8_t count = DowncastU8(cheatsList[i].value >> 16);
-                const uint16_t ainc = DowncastU16(cheatsList[i].value);
+            if (i < gbaCore.cheatsNumber) {
+                uint32_t addr = gbaCore.cheatsList[i - 1].value;
+                uint8_t value = DowncastU8(gbaCore.cheatsList[i].rawaddress);
+                const uint8_t vinc = DowncastU8(gbaCore.cheatsList[i].value >> 24);
+                uint8_t count = DowncastU8(gbaCore.cheatsList[i].value >> 16);
+                const uint16_t ainc = DowncastU16(gbaCore.cheatsList[i].value);
                 while (count > 0) {
                     CPUWriteByte(addr, value);
                     value += vinc;
@@ -619,12 +612,12 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
             break;
         case GSA_16_BIT_SLIDE:
             i++;
-            if (i < cheatsNumber) {
-                uint32_t addr = cheatsList[i - 1].value;
-                uint16_t value = DowncastU16(cheatsList[i].rawaddress);
-                const uint16_t vinc = DowncastU16(cheatsList[i].value >> 24);
-                uint8_t count = DowncastU8(cheatsList[i].value >> 16);
-                const uint16_t ainc = DowncastU16(cheatsList[i].value & 0xffff) * 2;
+            if (i < gbaCore.cheatsNumber) {
+                uint32_t addr = gbaCore.cheatsList[i - 1].value;
+                uint16_t value = DowncastU16(gbaCore.cheatsList[i].rawaddress);
+                const uint16_t vinc = DowncastU16(gbaCore.cheatsList[i].value >> 24);
+                uint8_t count = DowncastU8(gbaCore.cheatsList[i].value >> 16);
+                const uint16_t ainc = DowncastU16(gbaCore.cheatsList[i].value & 0xffff) * 2;
                 while (count > 0) {
                     CPUWriteHalfWord(addr, value);
                     value += vinc;
@@ -635,12 +628,12 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
             break;
         case GSA_32_BIT_SLIDE:
             i++;
-            if (i < cheatsNumber) {
-                uint32_t addr = cheatsList[i - 1].value;
-                uint32_t value = cheatsList[i].rawaddress;
-                int vinc = (cheatsList[i].value >> 24) & 255;
-                int count = (cheatsList[i].value >> 16) & 255;
-                int ainc = (cheatsList[i].value & 0xffff) * 4;
+            if (i < gbaCore.cheatsNumber) {
+                uint32_t addr = gbaCore.cheatsList[i - 1].value;
+                uint32_t value = gbaCore.cheatsList[i].rawaddress;
+                int vinc = (gbaCore.cheatsList[i].value >> 24) & 255;
+                int count = (gbaCore.cheatsList[i].value >> 16) & 255;
+                int ainc = (gbaCore.cheatsList[i].value & 0xffff) * 4;
                 while (count > 0) {
                     CPUWriteMemory(addr, value);
                     value += vinc;
@@ -651,102 +644,102 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
             break;
         case GSA_8_BIT_GS_WRITE2:
             i++;
-            if (i < cheatsNumber) {
+            if (i < gbaCore.cheatsNumber) {
                 if (extended & 4) {
-                    CPUWriteByte(cheatsList[i - 1].value, cheatsList[i].address);
+                    CPUWriteByte(gbaCore.cheatsList[i - 1].value, gbaCore.cheatsList[i].address);
                 }
             }
             break;
         case GSA_16_BIT_GS_WRITE2:
             i++;
-            if (i < cheatsNumber) {
+            if (i < gbaCore.cheatsNumber) {
                 if (extended & 4) {
-                    CPUWriteHalfWord(cheatsList[i - 1].value, cheatsList[i].address);
+                    CPUWriteHalfWord(gbaCore.cheatsList[i - 1].value, gbaCore.cheatsList[i].address);
                 }
             }
             break;
         case GSA_32_BIT_GS_WRITE2:
             i++;
-            if (i < cheatsNumber) {
+            if (i < gbaCore.cheatsNumber) {
                 if (extended & 4) {
-                    CPUWriteMemory(cheatsList[i - 1].value, cheatsList[i].address);
+                    CPUWriteMemory(gbaCore.cheatsList[i - 1].value, gbaCore.cheatsList[i].address);
                 }
             }
             break;
         case GSA_16_BIT_ROM_PATCH:
-            if ((cheatsList[i].status & 1) == 0) {
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    cheatsList[i].oldValue = CPUReadHalfWord(cheatsList[i].address);
-                    cheatsList[i].status |= 1;
-                    CHEAT_PATCH_ROM_16BIT(cheatsList[i].address, cheatsList[i].value);
+            if ((gbaCore.cheatsList[i].status & 1) == 0) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
+                    gbaCore.cheatsList[i].oldValue = CPUReadHalfWord(gbaCore.cheatsList[i].address);
+                    gbaCore.cheatsList[i].status |= 1;
+                    CHEAT_PATCH_ROM_16BIT(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 }
             }
             break;
         case GSA_16_BIT_ROM_PATCH2C:
             i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[0] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[0] = CPUReadHalfWord(rompatch2addr[0]);
-                rompatch2val[0] = cheatsList[i].rawaddress & 0xFFFF;
+            if (i < gbaCore.cheatsNumber) {
+                gbaCore.rompatch2addr[0] = ((gbaCore.cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
+                gbaCore.rompatch2oldval[0] = CPUReadHalfWord(gbaCore.rompatch2addr[0]);
+                gbaCore.rompatch2val[0] = gbaCore.cheatsList[i].rawaddress & 0xFFFF;
             }
             break;
         case GSA_16_BIT_ROM_PATCH2D:
             i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[1] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[1] = CPUReadHalfWord(rompatch2addr[1]);
-                rompatch2val[1] = cheatsList[i].rawaddress & 0xFFFF;
+            if (i < gbaCore.cheatsNumber) {
+                gbaCore.rompatch2addr[1] = ((gbaCore.cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
+                gbaCore.rompatch2oldval[1] = CPUReadHalfWord(gbaCore.rompatch2addr[1]);
+                gbaCore.rompatch2val[1] = gbaCore.cheatsList[i].rawaddress & 0xFFFF;
             }
             break;
         case GSA_16_BIT_ROM_PATCH2E:
             i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[2] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[2] = CPUReadHalfWord(rompatch2addr[2]);
-                rompatch2val[2] = cheatsList[i].rawaddress & 0xFFFF;
+            if (i < gbaCore.cheatsNumber) {
+                gbaCore.rompatch2addr[2] = ((gbaCore.cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
+                gbaCore.rompatch2oldval[2] = CPUReadHalfWord(gbaCore.rompatch2addr[2]);
+                gbaCore.rompatch2val[2] = gbaCore.cheatsList[i].rawaddress & 0xFFFF;
             }
             break;
         case GSA_16_BIT_ROM_PATCH2F:
             i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[3] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[3] = CPUReadHalfWord(rompatch2addr[3]);
-                rompatch2val[3] = cheatsList[i].rawaddress & 0xFFFF;
+            if (i < gbaCore.cheatsNumber) {
+                gbaCore.rompatch2addr[3] = ((gbaCore.cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
+                gbaCore.rompatch2oldval[3] = CPUReadHalfWord(gbaCore.rompatch2addr[3]);
+                gbaCore.rompatch2val[3] = gbaCore.cheatsList[i].rawaddress & 0xFFFF;
             }
             break;
         case MASTER_CODE:
-            mastercode = cheatsList[i].address;
+            gbaCore.mastercode = gbaCore.cheatsList[i].address;
             break;
         }
         if (onoff) {
-            switch (cheatsList[i].size) {
+            switch (gbaCore.cheatsList[i].size) {
             case INT_8_BIT_WRITE:
-                CPUWriteByte(cheatsList[i].address, cheatsList[i].value);
+                CPUWriteByte(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 break;
             case INT_16_BIT_WRITE:
-                CPUWriteHalfWord(cheatsList[i].address, cheatsList[i].value);
+                CPUWriteHalfWord(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 break;
             case INT_32_BIT_WRITE:
-                CPUWriteMemory(cheatsList[i].address, cheatsList[i].value);
+                CPUWriteMemory(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 break;
             case GSA_8_BIT_GS_WRITE:
                 if (extended & 4) {
-                    CPUWriteByte(cheatsList[i].address, cheatsList[i].value);
+                    CPUWriteByte(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 }
                 break;
             case GSA_16_BIT_GS_WRITE:
                 if (extended & 4) {
-                    CPUWriteHalfWord(cheatsList[i].address, cheatsList[i].value);
+                    CPUWriteHalfWord(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 }
                 break;
             case GSA_32_BIT_GS_WRITE:
                 if (extended & 4) {
-                    CPUWriteMemory(cheatsList[i].address, cheatsList[i].value);
+                    CPUWriteMemory(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 }
                 break;
             case CBA_IF_KEYS_PRESSED: {
-                uint16_t value = cheatsList[i].value;
-                uint32_t addr = cheatsList[i].address;
+                uint16_t value = gbaCore.cheatsList[i].value;
+                uint32_t addr = gbaCore.cheatsList[i].address;
                 if ((addr & 0xF0) == 0x20) {
                     if ((keys & value) == 0) {
                         i++;
@@ -762,18 +755,18 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
                 }
             } break;
             case CBA_IF_TRUE:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case CBA_SLIDE_CODE: {
-                uint32_t address = cheatsList[i].address;
-                uint16_t value = cheatsList[i].value;
+                uint32_t address = gbaCore.cheatsList[i].address;
+                uint16_t value = gbaCore.cheatsList[i].value;
                 i++;
-                if (i < cheatsNumber) {
-                    int count = ((cheatsList[i].address - 1) & 0xFFFF);
-                    uint16_t vinc = (cheatsList[i].address >> 16) & 0xFFFF;
-                    int inc = cheatsList[i].value;
+                if (i < gbaCore.cheatsNumber) {
+                    int count = ((gbaCore.cheatsList[i].address - 1) & 0xFFFF);
+                    uint16_t vinc = (gbaCore.cheatsList[i].address >> 16) & 0xFFFF;
+                    int inc = gbaCore.cheatsList[i].value;
                     for (int x = 0; x <= count; x++) {
                         CPUWriteHalfWord(address, value);
                         address += inc;
@@ -782,238 +775,238 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
                 }
             } break;
             case CBA_IF_FALSE:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case CBA_AND:
-                CPUWriteHalfWord(cheatsList[i].address,
-                    CPUReadHalfWord(cheatsList[i].address) & cheatsList[i].value);
+                CPUWriteHalfWord(gbaCore.cheatsList[i].address,
+                    CPUReadHalfWord(gbaCore.cheatsList[i].address) & gbaCore.cheatsList[i].value);
                 break;
             case GSA_8_BIT_IF_TRUE:
-                if (CPUReadByte(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadByte(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_TRUE:
-                if (CPUReadMemory(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadMemory(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_IF_FALSE:
-                if (CPUReadByte(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadByte(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_FALSE:
-                if (CPUReadMemory(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadMemory(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_FILL: {
-                uint32_t addr = cheatsList[i].address;
-                uint8_t v = cheatsList[i].value & 0xff;
-                uint32_t end = addr + (cheatsList[i].value >> 8);
+                uint32_t addr = gbaCore.cheatsList[i].address;
+                uint8_t v = gbaCore.cheatsList[i].value & 0xff;
+                uint32_t end = addr + (gbaCore.cheatsList[i].value >> 8);
                 do {
                     CPUWriteByte(addr, v);
                     addr++;
                 } while (addr <= end);
             } break;
             case GSA_16_BIT_FILL: {
-                uint32_t addr = cheatsList[i].address;
-                uint16_t v = cheatsList[i].value & 0xffff;
-                uint32_t end = addr + ((cheatsList[i].value >> 16) << 1);
+                uint32_t addr = gbaCore.cheatsList[i].address;
+                uint16_t v = gbaCore.cheatsList[i].value & 0xffff;
+                uint32_t end = addr + ((gbaCore.cheatsList[i].value >> 16) << 1);
                 do {
                     CPUWriteHalfWord(addr, v);
                     addr += 2;
                 } while (addr <= end);
             } break;
             case GSA_8_BIT_IF_TRUE2:
-                if (CPUReadByte(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadByte(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_TRUE2:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_TRUE2:
-                if (CPUReadMemory(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadMemory(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     i += 2;
                 }
                 break;
             case GSA_8_BIT_IF_FALSE2:
-                if (CPUReadByte(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadByte(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_FALSE2:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_FALSE2:
-                if (CPUReadMemory(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadMemory(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     i += 2;
                 }
                 break;
             case CBA_ADD:
-                if ((cheatsList[i].address & 1) == 0) {
-                    CPUWriteHalfWord(cheatsList[i].address,
-                        CPUReadHalfWord(cheatsList[i].address) + cheatsList[i].value);
+                if ((gbaCore.cheatsList[i].address & 1) == 0) {
+                    CPUWriteHalfWord(gbaCore.cheatsList[i].address,
+                        CPUReadHalfWord(gbaCore.cheatsList[i].address) + gbaCore.cheatsList[i].value);
                 } else {
-                    CPUWriteMemory(cheatsList[i].address & 0x0FFFFFFE,
-                        CPUReadMemory(cheatsList[i].address & 0x0FFFFFFE) + cheatsList[i].value);
+                    CPUWriteMemory(gbaCore.cheatsList[i].address & 0x0FFFFFFE,
+                        CPUReadMemory(gbaCore.cheatsList[i].address & 0x0FFFFFFE) + gbaCore.cheatsList[i].value);
                 }
                 break;
             case CBA_OR:
-                CPUWriteHalfWord(cheatsList[i].address,
-                    CPUReadHalfWord(cheatsList[i].address) | cheatsList[i].value);
+                CPUWriteHalfWord(gbaCore.cheatsList[i].address,
+                    CPUReadHalfWord(gbaCore.cheatsList[i].address) | gbaCore.cheatsList[i].value);
                 break;
             case CBA_GT:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > cheatsList[i].value)) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) > gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case CBA_LT:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < cheatsList[i].value)) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) < gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case CBA_SUPER: {
-                int count = 2 * ((cheatsList[i].value - 1) & 0xFFFF) + 1;
-                uint32_t address = cheatsList[i].address;
+                int count = 2 * ((gbaCore.cheatsList[i].value - 1) & 0xFFFF) + 1;
+                uint32_t address = gbaCore.cheatsList[i].address;
                 for (int x = 0; x <= count; x++) {
                     uint8_t b;
                     int res = x % 6;
                     if (res == 0)
                         i++;
                     if (res < 4)
-                        b = (cheatsList[i].address >> (24 - 8 * res)) & 0xFF;
+                        b = (gbaCore.cheatsList[i].address >> (24 - 8 * res)) & 0xFF;
                     else
-                        b = (cheatsList[i].value >> (8 - 8 * (res - 4))) & 0xFF;
+                        b = (gbaCore.cheatsList[i].value >> (8 - 8 * (res - 4))) & 0xFF;
                     CPUWriteByte(address, b);
                     address++;
                 }
             } break;
             case GSA_8_BIT_POINTER:
-                if (((CPUReadMemory(cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(cheatsList[i].address) < 0x03008000))) {
-                    CPUWriteByte(CPUReadMemory(cheatsList[i].address) + ((cheatsList[i].value & 0xFFFFFF00) >> 8),
-                        cheatsList[i].value & 0xFF);
+                if (((CPUReadMemory(gbaCore.cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(gbaCore.cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(gbaCore.cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(gbaCore.cheatsList[i].address) < 0x03008000))) {
+                    CPUWriteByte(CPUReadMemory(gbaCore.cheatsList[i].address) + ((gbaCore.cheatsList[i].value & 0xFFFFFF00) >> 8),
+                        gbaCore.cheatsList[i].value & 0xFF);
                 }
                 break;
             case GSA_16_BIT_POINTER:
-                if (((CPUReadMemory(cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(cheatsList[i].address) < 0x03008000))) {
-                    CPUWriteHalfWord(CPUReadMemory(cheatsList[i].address) + ((cheatsList[i].value & 0xFFFF0000) >> 15),
-                        cheatsList[i].value & 0xFFFF);
+                if (((CPUReadMemory(gbaCore.cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(gbaCore.cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(gbaCore.cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(gbaCore.cheatsList[i].address) < 0x03008000))) {
+                    CPUWriteHalfWord(CPUReadMemory(gbaCore.cheatsList[i].address) + ((gbaCore.cheatsList[i].value & 0xFFFF0000) >> 15),
+                        gbaCore.cheatsList[i].value & 0xFFFF);
                 }
                 break;
             case GSA_32_BIT_POINTER:
-                if (((CPUReadMemory(cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(cheatsList[i].address) < 0x03008000))) {
-                    CPUWriteMemory(CPUReadMemory(cheatsList[i].address),
-                        cheatsList[i].value);
+                if (((CPUReadMemory(gbaCore.cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(gbaCore.cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(gbaCore.cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(gbaCore.cheatsList[i].address) < 0x03008000))) {
+                    CPUWriteMemory(CPUReadMemory(gbaCore.cheatsList[i].address),
+                        gbaCore.cheatsList[i].value);
                 }
                 break;
             case GSA_8_BIT_ADD:
-                CPUWriteByte(cheatsList[i].address,
-                    ((cheatsList[i].value & 0xFF) + CPUReadMemory(cheatsList[i].address)) & 0xFF);
+                CPUWriteByte(gbaCore.cheatsList[i].address,
+                    ((gbaCore.cheatsList[i].value & 0xFF) + CPUReadMemory(gbaCore.cheatsList[i].address)) & 0xFF);
                 break;
             case GSA_16_BIT_ADD:
-                CPUWriteHalfWord(cheatsList[i].address,
-                    ((cheatsList[i].value & 0xFFFF) + CPUReadMemory(cheatsList[i].address)) & 0xFFFF);
+                CPUWriteHalfWord(gbaCore.cheatsList[i].address,
+                    ((gbaCore.cheatsList[i].value & 0xFFFF) + CPUReadMemory(gbaCore.cheatsList[i].address)) & 0xFFFF);
                 break;
             case GSA_32_BIT_ADD:
-                CPUWriteMemory(cheatsList[i].address,
-                    (cheatsList[i].value + CPUReadMemory(cheatsList[i].address)) & 0xFFFFFFFF);
+                CPUWriteMemory(gbaCore.cheatsList[i].address,
+                    (gbaCore.cheatsList[i].value + CPUReadMemory(gbaCore.cheatsList[i].address)) & 0xFFFFFFFF);
                 break;
             case GSA_8_BIT_IF_LOWER_U:
-                if (!(CPUReadByte(cheatsList[i].address) < (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) < (gbaCore.cheatsList[i].value & 0xFF))) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_IF_LOWER_U:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) < (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_LOWER_U:
-                if (!(CPUReadMemory(cheatsList[i].address) < cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) < gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_IF_HIGHER_U:
-                if (!(CPUReadByte(cheatsList[i].address) > (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) > (gbaCore.cheatsList[i].value & 0xFF))) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_U:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) > (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_HIGHER_U:
-                if (!(CPUReadMemory(cheatsList[i].address) > cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) > gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_IF_AND:
-                if (!(CPUReadByte(cheatsList[i].address) & (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) & (gbaCore.cheatsList[i].value & 0xFF))) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_IF_AND:
-                if (!(CPUReadHalfWord(cheatsList[i].address) & (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) & (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_AND:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) & gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_IF_LOWER_U2:
-                if (!(CPUReadByte(cheatsList[i].address) < (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) < (gbaCore.cheatsList[i].value & 0xFF))) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_LOWER_U2:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) < (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_LOWER_U2:
-                if (!(CPUReadMemory(cheatsList[i].address) < cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) < gbaCore.cheatsList[i].value)) {
                     i += 2;
                 }
                 break;
             case GSA_8_BIT_IF_HIGHER_U2:
-                if (!(CPUReadByte(cheatsList[i].address) > (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) > (gbaCore.cheatsList[i].value & 0xFF))) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_U2:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) > (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_HIGHER_U2:
-                if (!(CPUReadMemory(cheatsList[i].address) > cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) > gbaCore.cheatsList[i].value)) {
                     i += 2;
                 }
                 break;
             case GSA_8_BIT_IF_AND2:
-                if (!(CPUReadByte(cheatsList[i].address) & (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) & (gbaCore.cheatsList[i].value & 0xFF))) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_AND2:
-                if (!(CPUReadHalfWord(cheatsList[i].address) & (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) & (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_AND2:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) & gbaCore.cheatsList[i].value)) {
                     i += 2;
                 }
                 break;
@@ -1024,191 +1017,191 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
                 i += 2;
                 break;
             case GSA_8_BIT_IF_LOWER_S:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) < ((int8_t)cheatsList[i].value & 0xFF))) {
+                if (!((int8_t)CPUReadByte(gbaCore.cheatsList[i].address) < ((int8_t)gbaCore.cheatsList[i].value & 0xFF))) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_IF_LOWER_S:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) < ((int16_t)cheatsList[i].value & 0xFFFF))) {
+                if (!((int16_t)CPUReadHalfWord(gbaCore.cheatsList[i].address) < ((int16_t)gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_LOWER_S:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) < (int32_t)cheatsList[i].value)) {
+                if (!((int32_t)CPUReadMemory(gbaCore.cheatsList[i].address) < (int32_t)gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_IF_HIGHER_S:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) > ((int8_t)cheatsList[i].value & 0xFF))) {
+                if (!((int8_t)CPUReadByte(gbaCore.cheatsList[i].address) > ((int8_t)gbaCore.cheatsList[i].value & 0xFF))) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_S:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) > ((int16_t)cheatsList[i].value & 0xFFFF))) {
+                if (!((int16_t)CPUReadHalfWord(gbaCore.cheatsList[i].address) > ((int16_t)gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i++;
                 }
                 break;
             case GSA_32_BIT_IF_HIGHER_S:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) > (int32_t)cheatsList[i].value)) {
+                if (!((int32_t)CPUReadMemory(gbaCore.cheatsList[i].address) > (int32_t)gbaCore.cheatsList[i].value)) {
                     i++;
                 }
                 break;
             case GSA_8_BIT_IF_LOWER_S2:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) < ((int8_t)cheatsList[i].value & 0xFF))) {
+                if (!((int8_t)CPUReadByte(gbaCore.cheatsList[i].address) < ((int8_t)gbaCore.cheatsList[i].value & 0xFF))) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_LOWER_S2:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) < ((int16_t)cheatsList[i].value & 0xFFFF))) {
+                if (!((int16_t)CPUReadHalfWord(gbaCore.cheatsList[i].address) < ((int16_t)gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_LOWER_S2:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) < (int32_t)cheatsList[i].value)) {
+                if (!((int32_t)CPUReadMemory(gbaCore.cheatsList[i].address) < (int32_t)gbaCore.cheatsList[i].value)) {
                     i += 2;
                 }
                 break;
             case GSA_8_BIT_IF_HIGHER_S2:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) > ((int8_t)cheatsList[i].value & 0xFF))) {
+                if (!((int8_t)CPUReadByte(gbaCore.cheatsList[i].address) > ((int8_t)gbaCore.cheatsList[i].value & 0xFF))) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_S2:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) > ((int16_t)cheatsList[i].value & 0xFFFF))) {
+                if (!((int16_t)CPUReadHalfWord(gbaCore.cheatsList[i].address) > ((int16_t)gbaCore.cheatsList[i].value & 0xFFFF))) {
                     i += 2;
                 }
                 break;
             case GSA_32_BIT_IF_HIGHER_S2:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) > (int32_t)cheatsList[i].value)) {
+                if (!((int32_t)CPUReadMemory(gbaCore.cheatsList[i].address) > (int32_t)gbaCore.cheatsList[i].value)) {
                     i += 2;
                 }
                 break;
             case GSA_16_BIT_WRITE_IOREGS:
-                if ((cheatsList[i].address <= 0x3FF) && (cheatsList[i].address != 0x6) && (cheatsList[i].address != 0x130))
-                    g_ioMem[cheatsList[i].address & 0x3FE] = cheatsList[i].value & 0xFFFF;
+                if ((gbaCore.cheatsList[i].address <= 0x3FF) && (gbaCore.cheatsList[i].address != 0x6) && (gbaCore.cheatsList[i].address != 0x130))
+                    gbaCore.g_ioMem[gbaCore.cheatsList[i].address & 0x3FE] = gbaCore.cheatsList[i].value & 0xFFFF;
                 break;
             case GSA_32_BIT_WRITE_IOREGS:
-                if (cheatsList[i].address <= 0x3FF) {
-                    uint32_t cheat_addr = cheatsList[i].address & 0x3FC;
+                if (gbaCore.cheatsList[i].address <= 0x3FF) {
+                    uint32_t cheat_addr = gbaCore.cheatsList[i].address & 0x3FC;
                     if ((cheat_addr != 6) && (cheat_addr != 0x130))
-                        g_ioMem[cheat_addr] = (cheatsList[i].value & 0xFFFF);
+                        gbaCore.g_ioMem[cheat_addr] = (gbaCore.cheatsList[i].value & 0xFFFF);
                     if (((cheat_addr + 2) != 0x6) && (cheat_addr + 2) != 0x130)
-                        g_ioMem[cheat_addr + 2] = ((cheatsList[i].value >> 16) & 0xFFFF);
+                        gbaCore.g_ioMem[cheat_addr + 2] = ((gbaCore.cheatsList[i].value >> 16) & 0xFFFF);
                 }
                 break;
             case GSA_8_BIT_IF_TRUE3:
-                if (CPUReadByte(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadByte(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_TRUE3:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_TRUE3:
-                if (CPUReadMemory(cheatsList[i].address) != cheatsList[i].value) {
+                if (CPUReadMemory(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
                     onoff = false;
                 }
                 break;
             case GSA_8_BIT_IF_FALSE3:
-                if (CPUReadByte(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadByte(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_FALSE3:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_FALSE3:
-                if (CPUReadMemory(cheatsList[i].address) == cheatsList[i].value) {
+                if (CPUReadMemory(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
                     onoff = false;
                 }
                 break;
             case GSA_8_BIT_IF_LOWER_S3:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) < ((int8_t)cheatsList[i].value & 0xFF))) {
+                if (!((int8_t)CPUReadByte(gbaCore.cheatsList[i].address) < ((int8_t)gbaCore.cheatsList[i].value & 0xFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_LOWER_S3:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) < ((int16_t)cheatsList[i].value & 0xFFFF))) {
+                if (!((int16_t)CPUReadHalfWord(gbaCore.cheatsList[i].address) < ((int16_t)gbaCore.cheatsList[i].value & 0xFFFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_LOWER_S3:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) < (int32_t)cheatsList[i].value)) {
+                if (!((int32_t)CPUReadMemory(gbaCore.cheatsList[i].address) < (int32_t)gbaCore.cheatsList[i].value)) {
                     onoff = false;
                 }
                 break;
             case GSA_8_BIT_IF_HIGHER_S3:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) > ((int8_t)cheatsList[i].value & 0xFF))) {
+                if (!((int8_t)CPUReadByte(gbaCore.cheatsList[i].address) > ((int8_t)gbaCore.cheatsList[i].value & 0xFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_S3:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) > ((int16_t)cheatsList[i].value & 0xFFFF))) {
+                if (!((int16_t)CPUReadHalfWord(gbaCore.cheatsList[i].address) > ((int16_t)gbaCore.cheatsList[i].value & 0xFFFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_HIGHER_S3:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) > (int32_t)cheatsList[i].value)) {
+                if (!((int32_t)CPUReadMemory(gbaCore.cheatsList[i].address) > (int32_t)gbaCore.cheatsList[i].value)) {
                     onoff = false;
                 }
                 break;
             case GSA_8_BIT_IF_LOWER_U3:
-                if (!(CPUReadByte(cheatsList[i].address) < (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) < (gbaCore.cheatsList[i].value & 0xFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_LOWER_U3:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) < (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_LOWER_U3:
-                if (!(CPUReadMemory(cheatsList[i].address) < cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) < gbaCore.cheatsList[i].value)) {
                     onoff = false;
                 }
                 break;
             case GSA_8_BIT_IF_HIGHER_U3:
-                if (!(CPUReadByte(cheatsList[i].address) > (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) > (gbaCore.cheatsList[i].value & 0xFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_U3:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) > (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_HIGHER_U3:
-                if (!(CPUReadMemory(cheatsList[i].address) > cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) > gbaCore.cheatsList[i].value)) {
                     onoff = false;
                 }
                 break;
             case GSA_8_BIT_IF_AND3:
-                if (!(CPUReadByte(cheatsList[i].address) & (cheatsList[i].value & 0xFF))) {
+                if (!(CPUReadByte(gbaCore.cheatsList[i].address) & (gbaCore.cheatsList[i].value & 0xFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_16_BIT_IF_AND3:
-                if (!(CPUReadHalfWord(cheatsList[i].address) & (cheatsList[i].value & 0xFFFF))) {
+                if (!(CPUReadHalfWord(gbaCore.cheatsList[i].address) & (gbaCore.cheatsList[i].value & 0xFFFF))) {
                     onoff = false;
                 }
                 break;
             case GSA_32_BIT_IF_AND3:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) & gbaCore.cheatsList[i].value)) {
                     onoff = false;
                 }
                 break;
             case GSA_ALWAYS3:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
+                if (!(CPUReadMemory(gbaCore.cheatsList[i].address) & gbaCore.cheatsList[i].value)) {
                     onoff = false;
                 }
                 break;
             case GSA_GROUP_WRITE: {
-                int count = ((cheatsList[i].address) & 0xFFFE) + 1;
-                uint32_t value = cheatsList[i].value;
+                int count = ((gbaCore.cheatsList[i].address) & 0xFFFE) + 1;
+                uint32_t value = gbaCore.cheatsList[i].value;
                 if (count == 0)
                     i++;
                 else
@@ -1216,71 +1209,71 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
                         if ((x % 2) == 0) {
                             if (x < count)
                                 i++;
-                            CPUWriteMemory(cheatsList[i].rawaddress, value);
+                            CPUWriteMemory(gbaCore.cheatsList[i].rawaddress, value);
                         } else
-                            CPUWriteMemory(cheatsList[i].value, value);
+                            CPUWriteMemory(gbaCore.cheatsList[i].value, value);
                     }
             } break;
             case GSA_32_BIT_ADD2:
-                CPUWriteMemory(cheatsList[i].value,
-                    (CPUReadMemory(cheatsList[i].value) + cheatsList[i + 1].rawaddress) & 0xFFFFFFFF);
+                CPUWriteMemory(gbaCore.cheatsList[i].value,
+                    (CPUReadMemory(gbaCore.cheatsList[i].value) + gbaCore.cheatsList[i + 1].rawaddress) & 0xFFFFFFFF);
                 i++;
                 break;
             case GSA_32_BIT_SUB2:
-                CPUWriteMemory(cheatsList[i].value,
-                    (CPUReadMemory(cheatsList[i].value) - cheatsList[i + 1].rawaddress) & 0xFFFFFFFF);
+                CPUWriteMemory(gbaCore.cheatsList[i].value,
+                    (CPUReadMemory(gbaCore.cheatsList[i].value) - gbaCore.cheatsList[i + 1].rawaddress) & 0xFFFFFFFF);
                 i++;
                 break;
             case GSA_16_BIT_IF_LOWER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) > cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) > gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_IF_HIGHER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) < cheatsList[i].value) {
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) < gbaCore.cheatsList[i].value) {
                     i++;
                 }
                 break;
             case GSA_16_BIT_MIF_TRUE:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    i += ((cheatsList[i].rawaddress >> 0x10) & 0xFF);
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) != gbaCore.cheatsList[i].value) {
+                    i += ((gbaCore.cheatsList[i].rawaddress >> 0x10) & 0xFF);
                 }
                 break;
             case GSA_16_BIT_MIF_FALSE:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
-                    i += (cheatsList[i].rawaddress >> 0x10) & 0xFF;
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) == gbaCore.cheatsList[i].value) {
+                    i += (gbaCore.cheatsList[i].rawaddress >> 0x10) & 0xFF;
                 }
                 break;
             case GSA_16_BIT_MIF_LOWER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) > cheatsList[i].value) {
-                    i += (cheatsList[i].rawaddress >> 0x10) & 0xFF;
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) > gbaCore.cheatsList[i].value) {
+                    i += (gbaCore.cheatsList[i].rawaddress >> 0x10) & 0xFF;
                 }
                 break;
             case GSA_16_BIT_MIF_HIGHER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) < cheatsList[i].value) {
-                    i += (cheatsList[i].rawaddress >> 0x10) & 0xFF;
+                if (CPUReadHalfWord(gbaCore.cheatsList[i].address) < gbaCore.cheatsList[i].value) {
+                    i += (gbaCore.cheatsList[i].rawaddress >> 0x10) & 0xFF;
                 }
                 break;
             case CHEATS_16_BIT_WRITE:
-                if ((cheatsList[i].address >> 24) >= 0x08) {
-                    CHEAT_PATCH_ROM_16BIT(cheatsList[i].address, cheatsList[i].value);
+                if ((gbaCore.cheatsList[i].address >> 24) >= 0x08) {
+                    CHEAT_PATCH_ROM_16BIT(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 } else {
-                    CPUWriteHalfWord(cheatsList[i].address, cheatsList[i].value);
+                    CPUWriteHalfWord(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 }
                 break;
             case CHEATS_32_BIT_WRITE:
-                if ((cheatsList[i].address >> 24) >= 0x08) {
-                    CHEAT_PATCH_ROM_32BIT(cheatsList[i].address, cheatsList[i].value);
+                if ((gbaCore.cheatsList[i].address >> 24) >= 0x08) {
+                    CHEAT_PATCH_ROM_32BIT(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 } else {
-                    CPUWriteMemory(cheatsList[i].address, cheatsList[i].value);
+                    CPUWriteMemory(gbaCore.cheatsList[i].address, gbaCore.cheatsList[i].value);
                 }
                 break;
             }
         }
     }
     for (i = 0; i < 4; i++)
-        if (rompatch2addr[i] != 0)
-            CHEAT_PATCH_ROM_16BIT(rompatch2addr[i], rompatch2val[i]);
+        if (gbaCore.rompatch2addr[i] != 0)
+            CHEAT_PATCH_ROM_16BIT(gbaCore.rompatch2addr[i], gbaCore.rompatch2val[i]);
     return ticks;
 }
 
@@ -1292,137 +1285,137 @@ void cheatsAdd(const char* codeStr,
     int code,
     int size)
 {
-    if (cheatsNumber < MAX_CHEATS) {
-        int x = cheatsNumber;
-        cheatsList[x].code = code;
-        cheatsList[x].size = size;
-        cheatsList[x].rawaddress = rawaddress;
-        cheatsList[x].address = address;
-        cheatsList[x].value = value;
-        strcpy(cheatsList[x].codestring, codeStr);
-        strcpy(cheatsList[x].desc, desc);
-        cheatsList[x].enabled = true;
-        cheatsList[x].status = 0;
+    if (gbaCore.cheatsNumber < MAX_CHEATS) {
+        int x = gbaCore.cheatsNumber;
+        gbaCore.cheatsList[x].code = code;
+        gbaCore.cheatsList[x].size = size;
+        gbaCore.cheatsList[x].rawaddress = rawaddress;
+        gbaCore.cheatsList[x].address = address;
+        gbaCore.cheatsList[x].value = value;
+        strcpy(gbaCore.cheatsList[x].codestring, codeStr);
+        strcpy(gbaCore.cheatsList[x].desc, desc);
+        gbaCore.cheatsList[x].enabled = true;
+        gbaCore.cheatsList[x].status = 0;
 
         // we only store the old value for this simple codes. ROM patching
         // is taken care when it actually patches the ROM
-        switch (cheatsList[x].size) {
+        switch (gbaCore.cheatsList[x].size) {
         case INT_8_BIT_WRITE:
-            cheatsList[x].oldValue = CPUReadByte(address);
+            gbaCore.cheatsList[x].oldValue = CPUReadByte(address);
             break;
         case INT_16_BIT_WRITE:
-            cheatsList[x].oldValue = CPUReadHalfWord(address);
+            gbaCore.cheatsList[x].oldValue = CPUReadHalfWord(address);
             break;
         case INT_32_BIT_WRITE:
-            cheatsList[x].oldValue = CPUReadMemory(address);
+            gbaCore.cheatsList[x].oldValue = CPUReadMemory(address);
             break;
         case CHEATS_16_BIT_WRITE:
-            cheatsList[x].oldValue = CPUReadHalfWord(address);
+            gbaCore.cheatsList[x].oldValue = CPUReadHalfWord(address);
             break;
         case CHEATS_32_BIT_WRITE:
-            cheatsList[x].oldValue = CPUReadMemory(address);
+            gbaCore.cheatsList[x].oldValue = CPUReadMemory(address);
             break;
         }
-        cheatsNumber++;
+        gbaCore.cheatsNumber++;
     }
 }
 
 void cheatsDelete(int number, bool restore)
 {
-    if (number < cheatsNumber && number >= 0) {
+    if (number < gbaCore.cheatsNumber && number >= 0) {
         int x = number;
 
         if (restore) {
-            switch (cheatsList[x].size) {
+            switch (gbaCore.cheatsList[x].size) {
             case INT_8_BIT_WRITE:
-                CPUWriteByte(cheatsList[x].address, (uint8_t)cheatsList[x].oldValue);
+                CPUWriteByte(gbaCore.cheatsList[x].address, (uint8_t)gbaCore.cheatsList[x].oldValue);
                 break;
             case INT_16_BIT_WRITE:
-                CPUWriteHalfWord(cheatsList[x].address, (uint16_t)cheatsList[x].oldValue);
+                CPUWriteHalfWord(gbaCore.cheatsList[x].address, (uint16_t)gbaCore.cheatsList[x].oldValue);
                 break;
             case INT_32_BIT_WRITE:
-                CPUWriteMemory(cheatsList[x].address, cheatsList[x].oldValue);
+                CPUWriteMemory(gbaCore.cheatsList[x].address, gbaCore.cheatsList[x].oldValue);
                 break;
             case CHEATS_16_BIT_WRITE:
-                if ((cheatsList[x].address >> 24) >= 0x08) {
-                    CHEAT_PATCH_ROM_16BIT(cheatsList[x].address, cheatsList[x].oldValue);
+                if ((gbaCore.cheatsList[x].address >> 24) >= 0x08) {
+                    CHEAT_PATCH_ROM_16BIT(gbaCore.cheatsList[x].address, gbaCore.cheatsList[x].oldValue);
                 } else {
-                    CPUWriteHalfWord(cheatsList[x].address, cheatsList[x].oldValue);
+                    CPUWriteHalfWord(gbaCore.cheatsList[x].address, gbaCore.cheatsList[x].oldValue);
                 }
                 break;
             case CHEATS_32_BIT_WRITE:
-                if ((cheatsList[x].address >> 24) >= 0x08) {
-                    CHEAT_PATCH_ROM_32BIT(cheatsList[x].address, cheatsList[x].oldValue);
+                if ((gbaCore.cheatsList[x].address >> 24) >= 0x08) {
+                    CHEAT_PATCH_ROM_32BIT(gbaCore.cheatsList[x].address, gbaCore.cheatsList[x].oldValue);
                 } else {
-                    CPUWriteMemory(cheatsList[x].address, cheatsList[x].oldValue);
+                    CPUWriteMemory(gbaCore.cheatsList[x].address, gbaCore.cheatsList[x].oldValue);
                 }
 		/* fallthrough */
             case GSA_16_BIT_ROM_PATCH:
-                if (cheatsList[x].status & 1) {
-                    cheatsList[x].status &= ~1;
-                    CHEAT_PATCH_ROM_16BIT(cheatsList[x].address,
-                        cheatsList[x].oldValue);
+                if (gbaCore.cheatsList[x].status & 1) {
+                    gbaCore.cheatsList[x].status &= ~1;
+                    CHEAT_PATCH_ROM_16BIT(gbaCore.cheatsList[x].address,
+                        gbaCore.cheatsList[x].oldValue);
                 }
                 break;
             case GSA_16_BIT_ROM_PATCH2C:
             case GSA_16_BIT_ROM_PATCH2D:
             case GSA_16_BIT_ROM_PATCH2E:
             case GSA_16_BIT_ROM_PATCH2F:
-                if (cheatsList[x].status & 1) {
-                    cheatsList[x].status &= ~1;
+                if (gbaCore.cheatsList[x].status & 1) {
+                    gbaCore.cheatsList[x].status &= ~1;
                 }
                 break;
             case MASTER_CODE:
-                mastercode = 0;
+                gbaCore.mastercode = 0;
                 break;
             }
         }
-        if ((x + 1) < cheatsNumber) {
-            memcpy(&cheatsList[x], &cheatsList[x + 1], sizeof(CheatsData) * (cheatsNumber - x - 1));
+        if ((x + 1) < gbaCore.cheatsNumber) {
+            memcpy(&gbaCore.cheatsList[x], &gbaCore.cheatsList[x + 1], sizeof(CheatsData) * (gbaCore.cheatsNumber - x - 1));
         }
-        cheatsNumber--;
+        gbaCore.cheatsNumber--;
     }
 }
 
 void cheatsDeleteAll(bool restore)
 {
-    for (int i = cheatsNumber - 1; i >= 0; i--) {
+    for (int i = gbaCore.cheatsNumber - 1; i >= 0; i--) {
         cheatsDelete(i, restore);
     }
 }
 
 void cheatsEnable(int i)
 {
-    if (i >= 0 && i < cheatsNumber) {
-        cheatsList[i].enabled = true;
-        mastercode = 0;
+    if (i >= 0 && i < gbaCore.cheatsNumber) {
+        gbaCore.cheatsList[i].enabled = true;
+        gbaCore.mastercode = 0;
     }
 }
 
 void cheatsDisable(int i)
 {
-    if (i >= 0 && i < cheatsNumber) {
-        switch (cheatsList[i].size) {
+    if (i >= 0 && i < gbaCore.cheatsNumber) {
+        switch (gbaCore.cheatsList[i].size) {
         case GSA_16_BIT_ROM_PATCH:
-            if (cheatsList[i].status & 1) {
-                cheatsList[i].status &= ~1;
-                CHEAT_PATCH_ROM_16BIT(cheatsList[i].address,
-                    cheatsList[i].oldValue);
+            if (gbaCore.cheatsList[i].status & 1) {
+                gbaCore.cheatsList[i].status &= ~1;
+                CHEAT_PATCH_ROM_16BIT(gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].oldValue);
             }
             break;
         case GSA_16_BIT_ROM_PATCH2C:
         case GSA_16_BIT_ROM_PATCH2D:
         case GSA_16_BIT_ROM_PATCH2E:
         case GSA_16_BIT_ROM_PATCH2F:
-            if (cheatsList[i].status & 1) {
-                cheatsList[i].status &= ~1;
+            if (gbaCore.cheatsList[i].status & 1) {
+                gbaCore.cheatsList[i].status &= ~1;
             }
             break;
         case MASTER_CODE:
-            mastercode = 0;
+            gbaCore.mastercode = 0;
             break;
         }
-        cheatsList[i].enabled = false;
+        gbaCore.cheatsList[i].enabled = false;
     }
 }
 
@@ -1504,9 +1497,9 @@ void cheatsAddCheatCode(const char* code, const char* desc)
 
 uint16_t cheatsGSAGetDeadface(bool v3)
 {
-    for (int i = cheatsNumber - 1; i >= 0; i--)
-        if ((cheatsList[i].address == 0xDEADFACE) && (cheatsList[i].code == (v3 ? 257 : 256)))
-            return cheatsList[i].value & 0xFFFF;
+    for (int i = gbaCore.cheatsNumber - 1; i >= 0; i--)
+        if ((gbaCore.cheatsList[i].address == 0xDEADFACE) && (gbaCore.cheatsList[i].code == (v3 ? 257 : 256)))
+            return gbaCore.cheatsList[i].value & 0xFFFF;
     return 0;
 }
 
@@ -1519,12 +1512,12 @@ void cheatsGSAChangeEncryption(uint16_t value, bool v3)
         deadtable1 = (uint8_t*)(&v3_deadtable1);
         deadtable2 = (uint8_t*)(&v3_deadtable2);
         for (i = 0; i < 4; i++)
-            seeds_v3[i] = seed_gen(((value & 0xFF00) >> 8), (value & 0xFF) + i, deadtable1, deadtable2);
+            gbaCore.seeds_v3[i] = seed_gen(((value & 0xFF00) >> 8), (value & 0xFF) + i, deadtable1, deadtable2);
     } else {
         deadtable1 = (uint8_t*)(&v1_deadtable1);
         deadtable2 = (uint8_t*)(&v1_deadtable2);
         for (i = 0; i < 4; i++) {
-            seeds_v1[i] = seed_gen(((value & 0xFF00) >> 8), (value & 0xFF) + i, deadtable1, deadtable2);
+            gbaCore.seeds_v1[i] = seed_gen(((value & 0xFF00) >> 8), (value & 0xFF) + i, deadtable1, deadtable2);
         }
     }
 }
@@ -1543,7 +1536,7 @@ uint32_t seed_gen(uint8_t upper, uint8_t seed, uint8_t* deadtable1, uint8_t* dea
 void cheatsDecryptGSACode(uint32_t& address, uint32_t& value, bool v3)
 {
     uint32_t rollingseed = 0xC6EF3720;
-    uint32_t* seeds = v3 ? seeds_v3 : seeds_v1;
+    uint32_t* seeds = v3 ? gbaCore.seeds_v3 : gbaCore.seeds_v1;
 
     int bitsleft = 32;
     while (bitsleft > 0) {
@@ -1586,13 +1579,13 @@ void cheatsAddGSACode(const char* code, const char* desc, bool v3)
     cheatsDecryptGSACode(address, value, v3);
 
     if (value == 0x1DC0DE) {
-        uint32_t gamecode = READ32LE(((uint32_t*)&g_rom[0xac]));
+        uint32_t gamecode = READ32LE(((uint32_t*)&gbaCore.g_rom[0xac]));
         if (gamecode != address) {
             char buf[5];
             *((uint32_t*)buf) = address;
             buf[4] = 0;
             char buf2[5];
-            *((uint32_t*)buf2) = READ32LE(((uint32_t*)&g_rom[0xac]));
+            *((uint32_t*)buf2) = READ32LE(((uint32_t*)&gbaCore.g_rom[0xac]));
             buf2[4] = 0;
             systemMessage(MSG_GBA_CODE_WARNING, N_("Warning: cheats are for game %s. Current game is %s.\nCodes may not work correctly."),
                 buf, buf2);
@@ -1601,7 +1594,7 @@ void cheatsAddGSACode(const char* code, const char* desc, bool v3)
             UNKNOWN_CODE);
         return;
     }
-    if (isMultilineWithData(cheatsNumber - 1)) {
+    if (isMultilineWithData(gbaCore.cheatsNumber - 1)) {
         cheatsAdd(code, desc, address, address, value, v3 ? 257 : 256, UNKNOWN_CODE);
         return;
     }
@@ -1613,7 +1606,7 @@ void cheatsAddGSACode(const char* code, const char* desc, bool v3)
         if ((mcode & 0xFE) == 0xC4) {
             cheatsAdd(code, desc, address, (address & 0x1FFFFFF) | (0x08000000),
                 value, 257, MASTER_CODE);
-            mastercode = (address & 0x1FFFFFF) | (0x08000000);
+            gbaCore.mastercode = (address & 0x1FFFFFF) | (0x08000000);
         } else
             switch (type) {
             case 0x00:
@@ -2027,7 +2020,7 @@ void cheatsAddGSACode(const char* code, const char* desc, bool v3)
             break;
         case 0x0f:
             cheatsAdd(code, desc, address, (address & 0xFFFFFFF), value, 256, MASTER_CODE);
-            mastercode = (address & 0xFFFFFFF);
+            gbaCore.mastercode = (address & 0xFFFFFFF);
             break;
         default:
             // unsupported code
@@ -2171,13 +2164,13 @@ void cheatsCBAParseSeedCode(uint32_t address, uint32_t value, uint32_t* array)
 
 uint32_t cheatsCBAEncWorker()
 {
-    uint32_t x = (cheatsCBATemporaryValue * 0x41c64e6d) + 0x3039;
+    uint32_t x = (gbaCore.cheatsCBATemporaryValue * 0x41c64e6d) + 0x3039;
     uint32_t y = (x * 0x41c64e6d) + 0x3039;
     uint32_t z = x >> 0x10;
     x = ((y >> 0x10) & 0x7fff) << 0x0f;
     z = (z << 0x1e) | x;
     x = (y * 0x41c64e6d) + 0x3039;
-    cheatsCBATemporaryValue = x;
+    gbaCore.cheatsCBATemporaryValue = x;
     return z | ((x >> 0x10) & 0x7fff);
 }
 
@@ -2279,28 +2272,28 @@ void cheatsCBAChangeEncryption(uint32_t* seed)
 {
     int i;
 
-    cheatsCBATemporaryValue = (seed[1] ^ 0x1111);
-    cheatsCBAUpdateSeedBuffer(0x50, cheatsCBASeedBuffer, 0x30);
-    cheatsCBATemporaryValue = 0x4efad1c3;
+    gbaCore.cheatsCBATemporaryValue = (seed[1] ^ 0x1111);
+    cheatsCBAUpdateSeedBuffer(0x50, gbaCore.cheatsCBASeedBuffer, 0x30);
+    gbaCore.cheatsCBATemporaryValue = 0x4efad1c3;
 
     for (i = 0; (uint32_t)i < seed[4]; i++) {
-        cheatsCBATemporaryValue = cheatsCBAEncWorker();
+        gbaCore.cheatsCBATemporaryValue = cheatsCBAEncWorker();
     }
-    cheatsCBASeed[2] = cheatsCBAEncWorker();
-    cheatsCBASeed[3] = cheatsCBAEncWorker();
+    gbaCore.cheatsCBASeed[2] = cheatsCBAEncWorker();
+    gbaCore.cheatsCBASeed[3] = cheatsCBAEncWorker();
 
-    cheatsCBATemporaryValue = seed[3] ^ 0xf254;
+    gbaCore.cheatsCBATemporaryValue = seed[3] ^ 0xf254;
 
     for (i = 0; (uint32_t)i < seed[3]; i++) {
-        cheatsCBATemporaryValue = cheatsCBAEncWorker();
+        gbaCore.cheatsCBATemporaryValue = cheatsCBAEncWorker();
     }
 
-    cheatsCBASeed[0] = cheatsCBAEncWorker();
-    cheatsCBASeed[1] = cheatsCBAEncWorker();
+    gbaCore.cheatsCBASeed[0] = cheatsCBAEncWorker();
+    gbaCore.cheatsCBASeed[1] = cheatsCBAEncWorker();
 
-    *((uint32_t*)&cheatsCBACurrentSeed[0]) = seed[6];
-    *((uint32_t*)&cheatsCBACurrentSeed[4]) = seed[7];
-    *((uint32_t*)&cheatsCBACurrentSeed[8]) = 0;
+    *((uint32_t*)&gbaCore.cheatsCBACurrentSeed[0]) = seed[6];
+    *((uint32_t*)&gbaCore.cheatsCBACurrentSeed[4]) = seed[7];
+    *((uint32_t*)&gbaCore.cheatsCBACurrentSeed[8]) = 0;
 }
 
 uint16_t cheatsCBAGenValue(uint32_t x, uint32_t y, uint32_t z)
@@ -2330,9 +2323,9 @@ uint16_t cheatsCBAGenValue(uint32_t x, uint32_t y, uint32_t z)
 void cheatsCBAGenTable()
 {
     for (int i = 0; i < 0x100; i++) {
-        cheatsCBATable[i] = cheatsCBAGenValue(i, 0x1021, 0);
+        gbaCore.cheatsCBATable[i] = cheatsCBAGenValue(i, 0x1021, 0);
     }
-    cheatsCBATableGenerated = true;
+    gbaCore.cheatsCBATableGenerated = true;
 }
 
 uint16_t cheatsCBACalcCRC(uint8_t* rom, int count)
@@ -2345,19 +2338,19 @@ uint16_t cheatsCBACalcCRC(uint8_t* rom, int count)
         count = (count >> 2) - 1;
         if (count != -1) {
             while (count != -1) {
-                crc = (((crc << 0x08) ^ cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
+                crc = (((crc << 0x08) ^ gbaCore.cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
                                             ^ *rom++])
                           << 0x10)
                     >> 0x10;
-                crc = (((crc << 0x08) ^ cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
+                crc = (((crc << 0x08) ^ gbaCore.cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
                                             ^ *rom++])
                           << 0x10)
                     >> 0x10;
-                crc = (((crc << 0x08) ^ cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
+                crc = (((crc << 0x08) ^ gbaCore.cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
                                             ^ *rom++])
                           << 0x10)
                     >> 0x10;
-                crc = (((crc << 0x08) ^ cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
+                crc = (((crc << 0x08) ^ gbaCore.cheatsCBATable[(((uint32_t)crc << 0x10) >> 0x18)
                                             ^ *rom++])
                           << 0x10)
                     >> 0x10;
@@ -2376,15 +2369,15 @@ void cheatsCBADecrypt(uint8_t* decrypt)
     cheatsCBAReverseArray(decrypt, array);
 
     for (int count = 0x2f; count >= 0; count--) {
-        chatsCBAScramble(array, count, cheatsCBASeedBuffer[count]);
+        chatsCBAScramble(array, count, gbaCore.cheatsCBASeedBuffer[count]);
     }
     cheatsCBAArrayToValue(array, decrypt);
-    *((uint32_t*)decrypt) = cheatsCBAGetValue(decrypt) ^ cheatsCBASeed[0];
-    *((uint16_t*)(decrypt + 4)) = (cheatsCBAGetData(decrypt) ^ cheatsCBASeed[1]) & 0xffff;
+    *((uint32_t*)decrypt) = cheatsCBAGetValue(decrypt) ^ gbaCore.cheatsCBASeed[0];
+    *((uint16_t*)(decrypt + 4)) = (cheatsCBAGetData(decrypt) ^ gbaCore.cheatsCBASeed[1]) & 0xffff;
 
     cheatsCBAReverseArray(decrypt, array);
 
-    uint32_t cs = cheatsCBAGetValue(cheatsCBACurrentSeed);
+    uint32_t cs = cheatsCBAGetValue(gbaCore.cheatsCBACurrentSeed);
     for (int i = 0; i <= 4; i++) {
         array[i] = ((cs >> 8) ^ array[i + 1]) ^ array[i];
     }
@@ -2398,17 +2391,17 @@ void cheatsCBADecrypt(uint8_t* decrypt)
     cheatsCBAArrayToValue(array, decrypt);
 
     *((uint32_t*)decrypt) = cheatsCBAGetValue(decrypt)
-        ^ cheatsCBASeed[2];
+        ^ gbaCore.cheatsCBASeed[2];
     *((uint16_t*)(decrypt + 4)) = (cheatsCBAGetData(decrypt)
-                                 ^ cheatsCBASeed[3])
+                                 ^ gbaCore.cheatsCBASeed[3])
         & 0xffff;
 }
 
 int cheatsCBAGetCount()
 {
     int count = 0;
-    for (int i = 0; i < cheatsNumber; i++) {
-        if (cheatsList[i].code == 512)
+    for (int i = 0; i < gbaCore.cheatsNumber; i++) {
+        if (gbaCore.cheatsList[i].code == 512)
             count++;
     }
     return count;
@@ -2416,9 +2409,9 @@ int cheatsCBAGetCount()
 
 bool cheatsCBAShouldDecrypt()
 {
-    for (int i = 0; i < cheatsNumber; i++) {
-        if (cheatsList[i].code == 512) {
-            return (cheatsList[i].codestring[0] == '9');
+    for (int i = 0; i < gbaCore.cheatsNumber; i++) {
+        if (gbaCore.cheatsList[i].code == 512) {
+            return (gbaCore.cheatsList[i].codestring[0] == '9');
         }
     }
     return false;
@@ -2493,18 +2486,18 @@ void cheatsAddCBACode(const char* code, const char* desc)
 
         int type = (address >> 28) & 15;
 
-        if (isMultilineWithData(cheatsNumber - 1) || (super > 0)) {
+        if (isMultilineWithData(gbaCore.cheatsNumber - 1) || (gbaCore.super > 0)) {
             cheatsAdd(code, desc, address, address, value, 512, UNKNOWN_CODE);
-            if (super > 0)
-                super -= 1;
+            if (gbaCore.super > 0)
+                gbaCore.super -= 1;
             return;
         }
 
         switch (type) {
         case 0x00: {
-            if (!cheatsCBATableGenerated)
+            if (!gbaCore.cheatsCBATableGenerated)
                 cheatsCBAGenTable();
-            uint32_t crc = cheatsCBACalcCRC(g_rom, 0x10000);
+            uint32_t crc = cheatsCBACalcCRC(gbaCore.g_rom, 0x10000);
             if (crc != address) {
                 systemMessage(MSG_CBA_CODE_WARNING,
                     N_("Warning: Codes seem to be for a different game.\nCodes may not work correctly."));
@@ -2514,7 +2507,7 @@ void cheatsAddCBACode(const char* code, const char* desc)
         } break;
         case 0x01:
             cheatsAdd(code, desc, address, (address & 0x1FFFFFF) | 0x08000000, value, 512, MASTER_CODE);
-            mastercode = (address & 0x1FFFFFF) | 0x08000000;
+            gbaCore.mastercode = (address & 0x1FFFFFF) | 0x08000000;
             break;
         case 0x02:
             cheatsAdd(code, desc, address, address & 0x0FFFFFFE, value, 512,
@@ -2531,7 +2524,7 @@ void cheatsAddCBACode(const char* code, const char* desc)
         case 0x05:
             cheatsAdd(code, desc, address, address & 0x0FFFFFFE, value, 512,
                 CBA_SUPER);
-            super = getCodeLength(cheatsNumber - 1);
+            gbaCore.super = getCodeLength(gbaCore.cheatsNumber - 1);
             break;
         case 0x06:
             cheatsAdd(code, desc, address, address & 0x0FFFFFFE, value, 512,
@@ -2582,70 +2575,70 @@ void cheatsAddCBACode(const char* code, const char* desc)
 #ifndef __LIBRETRO__
 void cheatsSaveGame(gzFile file)
 {
-    utilWriteInt(file, cheatsNumber);
+    utilWriteInt(file, gbaCore.cheatsNumber);
 
-    utilGzWrite(file, cheatsList, sizeof(cheatsList));
+    utilGzWrite(file, gbaCore.cheatsList, sizeof(gbaCore.cheatsList));
 }
 
 void cheatsReadGame(gzFile file, int version)
 {
-    cheatsNumber = 0;
+    gbaCore.cheatsNumber = 0;
 
-    cheatsNumber = utilReadInt(file);
+    gbaCore.cheatsNumber = utilReadInt(file);
 
-    if (cheatsNumber > MAX_CHEATS)
-        cheatsNumber = MAX_CHEATS;
+    if (gbaCore.cheatsNumber > MAX_CHEATS)
+        gbaCore.cheatsNumber = MAX_CHEATS;
 
     if (version > 8)
-        utilGzRead(file, cheatsList, sizeof(cheatsList));
+        utilGzRead(file, gbaCore.cheatsList, sizeof(gbaCore.cheatsList));
 
     bool firstCodeBreaker = true;
 
-    for (int i = 0; i < cheatsNumber; i++) {
+    for (int i = 0; i < gbaCore.cheatsNumber; i++) {
         if (version < 9) {
-            cheatsList[i].code = utilReadInt(file);
-            cheatsList[i].size = utilReadInt(file);
-            cheatsList[i].status = utilReadInt(file);
-            cheatsList[i].enabled = utilReadInt(file) ? true : false;
-            utilGzRead(file, &cheatsList[i].address, sizeof(uint32_t));
-            cheatsList[i].rawaddress = cheatsList[i].address;
-            utilGzRead(file, &cheatsList[i].value, sizeof(uint32_t));
-            utilGzRead(file, &cheatsList[i].oldValue, sizeof(uint32_t));
-            utilGzRead(file, &cheatsList[i].codestring, 20 * sizeof(char));
-            utilGzRead(file, &cheatsList[i].desc, 32 * sizeof(char));
+            gbaCore.cheatsList[i].code = utilReadInt(file);
+            gbaCore.cheatsList[i].size = utilReadInt(file);
+            gbaCore.cheatsList[i].status = utilReadInt(file);
+            gbaCore.cheatsList[i].enabled = utilReadInt(file) ? true : false;
+            utilGzRead(file, &gbaCore.cheatsList[i].address, sizeof(uint32_t));
+            gbaCore.cheatsList[i].rawaddress = gbaCore.cheatsList[i].address;
+            utilGzRead(file, &gbaCore.cheatsList[i].value, sizeof(uint32_t));
+            utilGzRead(file, &gbaCore.cheatsList[i].oldValue, sizeof(uint32_t));
+            utilGzRead(file, &gbaCore.cheatsList[i].codestring, 20 * sizeof(char));
+            utilGzRead(file, &gbaCore.cheatsList[i].desc, 32 * sizeof(char));
         }
 
-        cheatsList[i].status = 0;
-        if (!cheatsList[i].codestring[0]) {
-            switch (cheatsList[i].size) {
+        gbaCore.cheatsList[i].status = 0;
+        if (!gbaCore.cheatsList[i].codestring[0]) {
+            switch (gbaCore.cheatsList[i].size) {
             case 0:
-                snprintf(cheatsList[i].codestring, sizeof(cheatsList[i].codestring), "%08x:%02x", cheatsList[i].address,
-                    cheatsList[i].value);
+                snprintf(gbaCore.cheatsList[i].codestring, sizeof(gbaCore.cheatsList[i].codestring), "%08x:%02x", gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].value);
                 break;
             case 1:
-                snprintf(cheatsList[i].codestring, sizeof(cheatsList[i].codestring), "%08x:%04x", cheatsList[i].address,
-                    cheatsList[i].value);
+                snprintf(gbaCore.cheatsList[i].codestring, sizeof(gbaCore.cheatsList[i].codestring), "%08x:%04x", gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].value);
                 break;
             case 2:
-                snprintf(cheatsList[i].codestring, sizeof(cheatsList[i].codestring), "%08x:%08x", cheatsList[i].address,
-                    cheatsList[i].value);
+                snprintf(gbaCore.cheatsList[i].codestring, sizeof(gbaCore.cheatsList[i].codestring), "%08x:%08x", gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].value);
                 break;
             }
         }
 
-        if (cheatsList[i].enabled) {
+        if (gbaCore.cheatsList[i].enabled) {
             cheatsEnable(i);
         }
 
-        if (cheatsList[i].code == 512 && firstCodeBreaker) {
+        if (gbaCore.cheatsList[i].code == 512 && firstCodeBreaker) {
             firstCodeBreaker = false;
             char buffer[10];
-            strncpy(buffer, cheatsList[i].codestring, 8);
+            strncpy(buffer, gbaCore.cheatsList[i].codestring, 8);
             buffer[8] = 0;
             uint32_t address;
             sscanf(buffer, "%x", &address);
             if ((address >> 28) == 9) {
-                strncpy(buffer, &cheatsList[i].codestring[9], 4);
+                strncpy(buffer, &gbaCore.cheatsList[i].codestring[9], 4);
                 buffer[4] = 0;
                 uint32_t value;
                 sscanf(buffer, "%x", &value);
@@ -2665,7 +2658,7 @@ void cheatsReadGameSkip(gzFile file, int version)
     nCheats = utilReadInt(file);
 
     if (version >= 9) {
-        utilGzSeek(file, sizeof(cheatsList), SEEK_CUR);
+        utilGzSeek(file, sizeof(gbaCore.cheatsList), SEEK_CUR);
     }
 
     for (int i = 0; i < nCheats; i++) {
@@ -2677,7 +2670,7 @@ void cheatsReadGameSkip(gzFile file, int version)
 
 void cheatsSaveCheatList(const char* file)
 {
-    if (cheatsNumber == 0)
+    if (gbaCore.cheatsNumber == 0)
         return;
     FILE* f = utilOpenFile(file, "wb");
     if (f == NULL)
@@ -2686,8 +2679,8 @@ void cheatsSaveCheatList(const char* file)
     fwrite(&version, 1, sizeof(version), f);
     int type = 1;
     fwrite(&type, 1, sizeof(type), f);
-    fwrite(&cheatsNumber, 1, sizeof(cheatsNumber), f);
-    fwrite(cheatsList, 1, sizeof(CheatsData) * cheatsNumber, f);
+    fwrite(&gbaCore.cheatsNumber, 1, sizeof(gbaCore.cheatsNumber), f);
+    fwrite(gbaCore.cheatsList, 1, sizeof(CheatsData) * gbaCore.cheatsNumber, f);
     fclose(f);
 }
 
@@ -2733,23 +2726,23 @@ bool cheatsLoadCheatList(const char* file)
         return false;
     }
     if (type == 1) {
-        if (fread(cheatsList, 1, sizeof(cheatsList), f) > sizeof(cheatsList)) {
+        if (fread(gbaCore.cheatsList, 1, sizeof(gbaCore.cheatsList), f) > sizeof(gbaCore.cheatsList)) {
             fclose(f);
             return false;
         }
     } else if (type == 0) {
         for (int i = 0; i < count; i++) {
-            FREAD_UNCHECKED(&cheatsList[i].code, 1, sizeof(int), f);
-            FREAD_UNCHECKED(&cheatsList[i].size, 1, sizeof(int), f);
-            FREAD_UNCHECKED(&cheatsList[i].status, 1, sizeof(int), f);
-            FREAD_UNCHECKED(&cheatsList[i].enabled, 1, sizeof(int), f);
-            cheatsList[i].enabled = cheatsList[i].enabled ? true : false;
-            FREAD_UNCHECKED(&cheatsList[i].address, 1, sizeof(uint32_t), f);
-            cheatsList[i].rawaddress = cheatsList[i].address;
-            FREAD_UNCHECKED(&cheatsList[i].value, 1, sizeof(uint32_t), f);
-            FREAD_UNCHECKED(&cheatsList[i].oldValue, 1, sizeof(uint32_t), f);
-            FREAD_UNCHECKED(&cheatsList[i].codestring, 1, 20 * sizeof(char), f);
-            if (fread(&cheatsList[i].desc, 1, 32 * sizeof(char), f) != 32 * sizeof(char)) {
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].code, 1, sizeof(int), f);
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].size, 1, sizeof(int), f);
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].status, 1, sizeof(int), f);
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].enabled, 1, sizeof(int), f);
+            gbaCore.cheatsList[i].enabled = gbaCore.cheatsList[i].enabled ? true : false;
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].address, 1, sizeof(uint32_t), f);
+            gbaCore.cheatsList[i].rawaddress = gbaCore.cheatsList[i].address;
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].value, 1, sizeof(uint32_t), f);
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].oldValue, 1, sizeof(uint32_t), f);
+            FREAD_UNCHECKED(&gbaCore.cheatsList[i].codestring, 1, 20 * sizeof(char), f);
+            if (fread(&gbaCore.cheatsList[i].desc, 1, 32 * sizeof(char), f) != 32 * sizeof(char)) {
                 fclose(f);
                 return false;
             }
@@ -2759,33 +2752,33 @@ bool cheatsLoadCheatList(const char* file)
     bool firstCodeBreaker = true;
 
     for (int i = 0; i < count; i++) {
-        cheatsList[i].status = 0; // remove old status as it is not used
-        if (!cheatsList[i].codestring[0]) {
-            switch (cheatsList[i].size) {
+        gbaCore.cheatsList[i].status = 0; // remove old status as it is not used
+        if (!gbaCore.cheatsList[i].codestring[0]) {
+            switch (gbaCore.cheatsList[i].size) {
             case 0:
-                snprintf(cheatsList[i].codestring, sizeof(cheatsList[i].codestring), "%08x:%02x", cheatsList[i].address,
-                    cheatsList[i].value);
+                snprintf(gbaCore.cheatsList[i].codestring, sizeof(gbaCore.cheatsList[i].codestring), "%08x:%02x", gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].value);
                 break;
             case 1:
-                snprintf(cheatsList[i].codestring, sizeof(cheatsList[i].codestring), "%08x:%04x", cheatsList[i].address,
-                    cheatsList[i].value);
+                snprintf(gbaCore.cheatsList[i].codestring, sizeof(gbaCore.cheatsList[i].codestring), "%08x:%04x", gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].value);
                 break;
             case 2:
-                snprintf(cheatsList[i].codestring, sizeof(cheatsList[i].codestring), "%08x:%08x", cheatsList[i].address,
-                    cheatsList[i].value);
+                snprintf(gbaCore.cheatsList[i].codestring, sizeof(gbaCore.cheatsList[i].codestring), "%08x:%08x", gbaCore.cheatsList[i].address,
+                    gbaCore.cheatsList[i].value);
                 break;
             }
         }
 
-        if (cheatsList[i].code == 512 && firstCodeBreaker) {
+        if (gbaCore.cheatsList[i].code == 512 && firstCodeBreaker) {
             firstCodeBreaker = false;
             char buffer[10];
-            strncpy(buffer, cheatsList[i].codestring, 8);
+            strncpy(buffer, gbaCore.cheatsList[i].codestring, 8);
             buffer[8] = 0;
             uint32_t address;
             sscanf(buffer, "%x", &address);
             if ((address >> 28) == 9) {
-                strncpy(buffer, &cheatsList[i].codestring[9], 4);
+                strncpy(buffer, &gbaCore.cheatsList[i].codestring[9], 4);
                 buffer[4] = 0;
                 uint32_t value;
                 sscanf(buffer, "%x", &value);
@@ -2796,14 +2789,12 @@ bool cheatsLoadCheatList(const char* file)
             }
         }
     }
-    cheatsNumber = count;
+    gbaCore.cheatsNumber = count;
     fclose(f);
     return true;
 }
 #endif
 
-extern int cpuNextEvent;
-
 extern void debuggerBreakOnWrite(uint32_t, uint32_t, uint32_t, int, int);
 
 #ifdef VBAM_ENABLE_DEBUGGER
@@ -2811,18 +2802,18 @@ static uint8_t cheatsGetType(uint32_t address)
 {
     switch (address >> 24) {
     case 2:
-        return freezeWorkRAM[address & 0x3FFFF];
+        return gbaCore.freezeWorkRAM[address & 0x3FFFF];
     case 3:
-        return freezeInternalRAM[address & 0x7FFF];
+        return gbaCore.freezeInternalRAM[address & 0x7FFF];
     case 5:
-        return freezePRAM[address & 0x3FC];
+        return gbaCore.freezePRAM[address & 0x3FC];
     case 6:
         if (address > 0x06010000)
-            return freezeVRAM[address & 0x17FFF];
+            return gbaCore.freezeVRAM[address & 0x17FFF];
         else
-            return freezeVRAM[address & 0x1FFFF];
+            return gbaCore.freezeVRAM[address & 0x1FFFF];
     case 7:
-        return freezeOAM[address & 0x3FC];
+        return gbaCore.freezeOAM[address & 0x3FC];
     }
     return 0;
 }
@@ -2831,12 +2822,12 @@ static uint8_t cheatsGetType(uint32_t address)
 #ifdef VBAM_ENABLE_DEBUGGER
 void cheatsWriteMemory(uint32_t address, uint32_t value)
 {
-    if (cheatsNumber == 0) {
+    if (gbaCore.cheatsNumber == 0) {
         int type = cheatsGetType(address);
         uint32_t oldValue = debuggerReadMemory(address);
         if (type == 1 || (type == 2 && oldValue != value)) {
             debuggerBreakOnWrite(address, oldValue, value, 2, type);
-            cpuNextEvent = 0;
+            gbaCore.cpuNextEvent = 0;
         }
         debuggerWriteMemory(address, value);
     }
@@ -2844,12 +2835,12 @@ void cheatsWriteMemory(uint32_t address, uint32_t value)
 
 void cheatsWriteHalfWord(uint32_t address, uint16_t value)
 {
-    if (cheatsNumber == 0) {
+    if (gbaCore.cheatsNumber == 0) {
         int type = cheatsGetType(address);
         uint16_t oldValue = debuggerReadHalfWord(address);
         if (type == 1 || (type == 2 && oldValue != value)) {
             debuggerBreakOnWrite(address, oldValue, value, 1, type);
-            cpuNextEvent = 0;
+            gbaCore.cpuNextEvent = 0;
         }
         debuggerWriteHalfWord(address, value);
     }
@@ -2857,12 +2848,12 @@ void cheatsWriteHalfWord(uint32_t address, uint16_t value)
 
 void cheatsWriteByte(uint32_t address, uint8_t value)
 {
-    if (cheatsNumber == 0) {
+    if (gbaCore.cheatsNumber == 0) {
         int type = cheatsGetType(address);
         uint8_t oldValue = debuggerReadByte(address);
         if (type == 1 || (type == 2 && oldValue != value)) {
             debuggerBreakOnWrite(address, oldValue, value, 0, type);
-            cpuNextEvent = 0;
+            gbaCore.cpuNextEvent = 0;
         }
         debuggerWriteByte(address, value);
     }
@@ -46,7 +46,4 @@ void cheatsWriteByte(uint32_t address, uint8_t value);
 #endif
 int cheatsCheckKeys(uint32_t keys, uint32_t extended);
 
-extern int cheatsNumber;
-extern CheatsData cheatsList[MAX_CHEATS];
-
 #endif // VBAM_CORE_GBA_GBACHEATS_H_
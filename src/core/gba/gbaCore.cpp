@@ -0,0 +1,24 @@
+#include "core/gba/gbaCore.h"
+
+#if defined(VBAM_ENABLE_REENTRANT_CORE)
+GbaCore gbaMainCore;
+
+GbaCore* gbaCoreCreate()
+{
+    // Value-initialized, like the main core, for the members without an
+    // initializer.
+    return new GbaCore();
+}
+
+void gbaCoreDestroy(GbaCore* core)
+{
+    GbaCore* previous = gbaCoreSwitch(core);
+#if defined(VBAM_ENABLE_JIT)
+    thumbJitRelease();
+#endif  // defined(VBAM_ENABLE_JIT)
+    gbaCoreSwitch(previous);
+    delete core;
+}
+#else
+GbaCore gbaCore;
+#endif  // defined(VBAM_ENABLE_REENTRANT_CORE)
@@ -0,0 +1,662 @@
+#ifndef VBAM_CORE_GBA_GBACORE_H_
+#define VBAM_CORE_GBA_GBACORE_H_
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+#include "core/apu/Blip_Buffer.h"
+#include "core/apu/Multi_Buffer.h"
+#include "core/base/line_writer.h"
+#include "core/base/resampler.h"
+#include "core/base/sound_driver.h"
+#include "core/base/system.h"
+#include "core/gba/gba.h"
+#include "core/gba/gbaCheatSearch.h"
+#include "core/gba/gbaCheats.h"
+#include "core/gba/gbaEeprom.h"
+#include "core/gba/gbaFlash.h"
+#include "core/gba/gbaRtc.h"
+#include "core/gba/internal/gbaSoundPcm.h"
+
+#if defined(VBAM_ENABLE_JIT)
+#include "core/gba/internal/gbaJit.h"
+#endif  // defined(VBAM_ENABLE_JIT)
+
+// State of one emulated GBA.
+//
+// Everything the GBA core keeps between two calls lives in a GbaCore, under
+// the names the globals it replaces had, and the core code reaches it through
+// `gbaCore`. Without ENABLE_REENTRANT_CORE, `gbaCore` is a plain global object
+// and its members are accessed at fixed addresses, like the globals were.
+// With it, `gbaCore` is the core the calling thread runs, reached through one
+// thread-local pointer. Every thread starts with the main core, and an
+// embedder runs more cores by creating them with gbaCoreCreate() and
+// switching the thread that runs each of them to it with gbaCoreSwitch().
+// A core must only be run by one thread at a time.
+//
+// The types below belong to the modules in internal/, whose headers use the
+// state inline and so include this one.
+
+// gbaDecodeCache.h
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+typedef INSN_REGPARM void (*insnfunc_t)(uint32_t opcode);
+
+struct DecodedInsn {
+    uint32_t address;
+    uint32_t opcode;
+    insnfunc_t handler;
+};
+
+// Number of entries for each CPU state. Must be a power of two.
+static constexpr uint32_t kDecodeCacheSize = 4096;
+#endif  // defined(VBAM_ENABLE_DECODE_CACHE)
+
+// gbaIdleLoop.h
+// No loop is being tracked.
+static constexpr uint32_t kIdleLoopNone = 0xFFFFFFFF;
+
+// gbaPageTable.h
+static constexpr uint32_t kPageShift = 14;
+static constexpr uint32_t kPageMask = (1 << kPageShift) - 1;
+static constexpr uint32_t kPageTableEnd = 0x10000000;
+static constexpr uint32_t kPageCount = kPageTableEnd >> kPageShift;
+
+struct MemoryPage {
+    // Host memory for loads, or null to take the slow path.
+    uint8_t* read;
+    // Host memory for halfword and word stores, or null.
+    uint8_t* write;
+    // Host memory for byte stores, or null.
+    uint8_t* writeByte;
+#if defined(VBAM_ENABLE_DEBUGGER)
+    // Cheat freeze flags matching `write`.
+    uint8_t* freeze;
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+};
+
+// gbaRenderThreads.h
+enum {
+    kGfxPalette,
+    kGfxVram,
+    kGfxOam,
+    kGfxRegions,
+};
+
+#if defined(VBAM_ENABLE_THREADED_RENDERER)
+struct GfxPool;
+
+struct GfxPoolDeleter {
+    void operator()(GfxPool* pool) const;
+};
+#endif  // defined(VBAM_ENABLE_THREADED_RENDERER)
+
+// gbaScheduler.h
+enum GbaEvent : uint8_t {
+    // Boundary events.
+    kGbaEventLcd,
+    kGbaEventTimer0,
+    kGbaEventTimer1,
+    kGbaEventTimer2,
+    kGbaEventTimer3,
+    kGbaEventIrq,
+
+    // Deferred events.
+    kGbaEventRtc,
+
+    kGbaEventCount,
+};
+
+static constexpr uint32_t kGbaEventBoundaryCount = kGbaEventIrq + 1;
+
+// gbaSpriteIndex.h
+static constexpr int kSpriteCount = 128;
+static constexpr int kSpriteLines = 160;
+
+struct GfxSprite {
+    // Attributes 0-2 with the prohibited OBJ mode and shape already mapped
+    // to the values the renderers use.
+    uint16_t a0;
+    uint16_t a1;
+    uint16_t a2;
+    uint8_t sizeX;
+    uint8_t sizeY;
+    // Lines covered by the entry, clipped to the visible area.
+    uint8_t top;
+    uint8_t bottom;
+};
+
+// gbaTileCache.h
+// 4bpp tiles in the 64 KiB of BG VRAM, tiles above it are never drawn.
+static constexpr uint32_t kTileCacheSize = 0x10000;
+static constexpr int kTileCacheTiles = kTileCacheSize / 32;
+
+// gbaGfx.h
+template <int mode, bool fx, bool window, bool objWindow>
+void gfxRenderLine();
+
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+// N and Z are not computed by the ALU handlers, which only store their result
+// sign extended to 64 bits. N is the sign of the stored value and Z is set
+// when its low 32 bits are zero, so both flags can still be written on their
+// own by MSR, SWI and the savestate code through these wrappers, which work on
+// the flagResult of the current core.
+struct LazyNFlag {
+    operator bool() const;
+    LazyNFlag& operator=(bool n);
+    LazyNFlag& operator=(const LazyNFlag& other) { return *this = (bool)other; }
+};
+
+struct LazyZFlag {
+    operator bool() const;
+    LazyZFlag& operator=(bool z);
+    LazyZFlag& operator=(const LazyZFlag& other) { return *this = (bool)other; }
+};
+#endif
+
+struct GbaCore {
+    GbaCore() = default;
+    // Members point at each other.
+    GbaCore(const GbaCore&) = delete;
+    GbaCore& operator=(const GbaCore&) = delete;
+
+    // CPU
+    reg_pair reg[45];
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+    int64_t flagResult = 1;
+    LazyNFlag N_FLAG;
+    LazyZFlag Z_FLAG;
+#else
+    bool N_FLAG = 0;
+    bool Z_FLAG = 0;
+#endif
+    bool C_FLAG = 0;
+    bool V_FLAG = 0;
+    bool armState = true;
+    bool armIrqEnable = true;
+    uint32_t armNextPC = 0x00000000;
+    int armMode = 0x1f;
+    uint32_t stop = 0x08000568;
+    int clockTicks;
+    int SWITicks = 0;
+    int IRQTicks = 0;
+    bool busPrefetch = false;
+    bool busPrefetchEnable = false;
+    uint32_t busPrefetchCount = 0;
+    uint32_t cpuPrefetch[2];
+    bool cpuBreakLoop = false;
+    int cpuNextEvent = 0;
+    int cpuTotalTicks = 0;
+    bool intState = false;
+    bool stopState = false;
+    bool holdState = false;
+    int holdType = 0;
+    int armOpcodeCount = 0;
+    int thumbOpcodeCount = 0;
+    uint8_t cpuBitsSet[256];
+    uint8_t cpuLowestBitSet[256];
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+    // Savestates keep N and Z as plain bools, the lazy flags are copied to and
+    // from these around the saveGameStruct() transfer.
+    bool stateNFlag = false;
+    bool stateZFlag = false;
+#endif
+
+    // Memory
+    uint8_t* g_bios = 0;
+    uint8_t* g_rom = 0;
+    uint8_t* g_internalRAM = 0;
+    uint8_t* g_workRAM = 0;
+    uint8_t* g_paletteRAM = 0;
+    uint8_t* g_vram = 0;
+    uint8_t* g_pix = 0;
+    uint8_t* g_oam = 0;
+    uint8_t* g_ioMem = 0;
+    int romSize = SIZE_ROM;
+    memoryMap map[256];
+    MemoryPage cpuPageTable[kPageCount];
+    bool ioReadable[0x400];
+    uint8_t biosProtected[4];
+    uint8_t memoryWait[16] = { 0, 0, 2, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4, 4, 0 };
+    uint8_t memoryWait32[16] = { 0, 0, 5, 0, 0, 1, 1, 0, 7, 7, 9, 9, 13, 13, 4, 0 };
+    uint8_t memoryWaitSeq[16] = { 0, 0, 2, 0, 0, 0, 0, 0, 2, 2, 4, 4, 8, 8, 4, 0 };
+    uint8_t memoryWaitSeq32[16] = { 0, 0, 5, 0, 0, 1, 1, 0, 5, 5, 9, 9, 17, 17, 4, 0 };
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+    DecodedInsn armDecodeCache[kDecodeCacheSize];
+    DecodedInsn thumbDecodeCache[kDecodeCacheSize];
+#endif  // defined(VBAM_ENABLE_DECODE_CACHE)
+
+    // I/O registers
+    uint16_t DISPCNT = 0x0080;
+    uint16_t DISPSTAT = 0x0000;
+    uint16_t VCOUNT = 0x0000;
+    uint16_t BG0CNT = 0x0000;
+    uint16_t BG1CNT = 0x0000;
+    uint16_t BG2CNT = 0x0000;
+    uint16_t BG3CNT = 0x0000;
+    uint16_t BG0HOFS = 0x0000;
+    uint16_t BG0VOFS = 0x0000;
+    uint16_t BG1HOFS = 0x0000;
+    uint16_t BG1VOFS = 0x0000;
+    uint16_t BG2HOFS = 0x0000;
+    uint16_t BG2VOFS = 0x0000;
+    uint16_t BG3HOFS = 0x0000;
+    uint16_t BG3VOFS = 0x0000;
+    uint16_t BG2PA = 0x0100;
+    uint16_t BG2PB = 0x0000;
+    uint16_t BG2PC = 0x0000;
+    uint16_t BG2PD = 0x0100;
+    uint16_t BG2X_L = 0x0000;
+    uint16_t BG2X_H = 0x0000;
+    uint16_t BG2Y_L = 0x0000;
+    uint16_t BG2Y_H = 0x0000;
+    uint16_t BG3PA = 0x0100;
+    uint16_t BG3PB = 0x0000;
+    uint16_t BG3PC = 0x0000;
+    uint16_t BG3PD = 0x0100;
+    uint16_t BG3X_L = 0x0000;
+    uint16_t BG3X_H = 0x0000;
+    uint16_t BG3Y_L = 0x0000;
+    uint16_t BG3Y_H = 0x0000;
+    uint16_t WIN0H = 0x0000;
+    uint16_t WIN1H = 0x0000;
+    uint16_t WIN0V = 0x0000;
+    uint16_t WIN1V = 0x0000;
+    uint16_t WININ = 0x0000;
+    uint16_t WINOUT = 0x0000;
+    uint16_t MOSAIC = 0x0000;
+    uint16_t BLDMOD = 0x0000;
+    uint16_t COLEV = 0x0000;
+    uint16_t COLY = 0x0000;
+    uint16_t DM0SAD_L = 0x0000;
+    uint16_t DM0SAD_H = 0x0000;
+    uint16_t DM0DAD_L = 0x0000;
+    uint16_t DM0DAD_H = 0x0000;
+    uint16_t DM0CNT_L = 0x0000;
+    uint16_t DM0CNT_H = 0x0000;
+    uint16_t DM1SAD_L = 0x0000;
+    uint16_t DM1SAD_H = 0x0000;
+    uint16_t DM1DAD_L = 0x0000;
+    uint16_t DM1DAD_H = 0x0000;
+    uint16_t DM1CNT_L = 0x0000;
+    uint16_t DM1CNT_H = 0x0000;
+    uint16_t DM2SAD_L = 0x0000;
+    uint16_t DM2SAD_H = 0x0000;
+    uint16_t DM2DAD_L = 0x0000;
+    uint16_t DM2DAD_H = 0x0000;
+    uint16_t DM2CNT_L = 0x0000;
+    uint16_t DM2CNT_H = 0x0000;
+    uint16_t DM3SAD_L = 0x0000;
+    uint16_t DM3SAD_H = 0x0000;
+    uint16_t DM3DAD_L = 0x0000;
+    uint16_t DM3DAD_H = 0x0000;
+    uint16_t DM3CNT_L = 0x0000;
+    uint16_t DM3CNT_H = 0x0000;
+    uint16_t TM0D = 0x0000;
+    uint16_t TM0CNT = 0x0000;
+    uint16_t TM1D = 0x0000;
+    uint16_t TM1CNT = 0x0000;
+    uint16_t TM2D = 0x0000;
+    uint16_t TM2CNT = 0x0000;
+    uint16_t TM3D = 0x0000;
+    uint16_t TM3CNT = 0x0000;
+    uint16_t P1 = 0xFFFF;
+    uint16_t IE = 0x0000;
+    uint16_t IF = 0x0000;
+    uint16_t IME = 0x0000;
+
+    // Timers, DMA and events
+    // lcdTicks, timerXTicks and IRQTicks are the save state copies of the
+    // scheduled events, see CPUSyncEventTicks() and CPUScheduleEvents().
+    int lcdTicks = (coreOptions.useBios && !coreOptions.skipBios) ? 1008 : 208;
+    uint8_t timerOnOffDelay = 0;
+    uint16_t timer0Value = 0;
+    bool timer0On = false;
+    int timer0Ticks = 0;
+    int timer0Reload = 0;
+    int timer0ClockReload = 0;
+    uint16_t timer1Value = 0;
+    bool timer1On = false;
+    int timer1Ticks = 0;
+    int timer1Reload = 0;
+    int timer1ClockReload = 0;
+    uint16_t timer2Value = 0;
+    bool timer2On = false;
+    int timer2Ticks = 0;
+    int timer2Reload = 0;
+    int timer2ClockReload = 0;
+    uint16_t timer3Value = 0;
+    bool timer3On = false;
+    int timer3Ticks = 0;
+    int timer3Reload = 0;
+    int timer3ClockReload = 0;
+    uint32_t dma0Source = 0;
+    uint32_t dma0Dest = 0;
+    uint32_t dma1Source = 0;
+    uint32_t dma1Dest = 0;
+    uint32_t dma2Source = 0;
+    uint32_t dma2Dest = 0;
+    uint32_t dma3Source = 0;
+    uint32_t dma3Dest = 0;
+    int cpuDmaTicksToUpdate = 0;
+    int cpuDmaCount = 0;
+    bool cpuDmaRunning = false;
+    uint32_t cpuDmaLast = 0;
+    uint32_t cpuDmaPC = 0;
+    int dummyAddress = 0;
+    uint32_t gbaSchedulerTime = 0;
+    uint32_t gbaSchedulerDeadline[kGbaEventCount];
+    uint32_t gbaSchedulerPendingMask = 0;
+    uint8_t gbaSchedulerHeap[kGbaEventBoundaryCount];
+    uint32_t gbaSchedulerHeapSize = 0;
+    // Heap slot of every boundary event, only valid while it is pending.
+    uint32_t gbaSchedulerHeapSlot[kGbaEventBoundaryCount];
+    uint32_t rtcLastUpdate = 0;
+
+    // Idle loop detection
+    // Set by memory reads whose result changes between two events.
+    bool idleLoopVolatileRead = false;
+    // Address of the branch instruction ending the loop being tracked.
+    uint32_t idleLoopBranch = kIdleLoopNone;
+    uint32_t idleLoopTarget = kIdleLoopNone;
+    uint32_t idleLoopRejectedBranch = kIdleLoopNone;
+    uint32_t idleLoopRejectedTarget = kIdleLoopNone;
+    uint32_t idleLoopRegs[15];
+    bool idleLoopFlags[4];
+
+#if defined(VBAM_ENABLE_JIT)
+    // Recompiler
+    JitBlock jitBlocks[kJitTableSize];
+    uint8_t* jitCode = nullptr;
+    size_t jitCodeUsed = 0;
+    bool jitUnavailable = false;
+#if defined(VBAM_ENABLE_LAZY_FLAGS)
+    bool jitNFlag = false;
+    bool jitZFlag = false;
+#endif  // defined(VBAM_ENABLE_LAZY_FLAGS)
+#endif  // defined(VBAM_ENABLE_JIT)
+
+    // Video
+    void (*renderLine)() = gfxRenderLine<0, false, false, false>;
+#if defined(VBAM_ENABLE_THREADED_RENDERER)
+    // Carries the renderer state over a line queued for the workers.
+    void (*skipLine)() = nullptr;
+#endif  // defined(VBAM_ENABLE_THREADED_RENDERER)
+    bool fxOn = false;
+    bool windowOn = false;
+    int layerEnableDelay = 0;
+    // this is an optional hack to change the backdrop/background color:
+    // -1: disabled
+    // 0x0000 to 0x7FFF: set custom 15 bit color
+    int customBackdropColor = -1;
+    uint32_t g_line0[240];
+    uint32_t g_line1[240];
+    uint32_t g_line2[240];
+    uint32_t g_line3[240];
+    uint32_t g_lineOBJ[240];
+    uint32_t g_lineOBJWin[240];
+    uint32_t g_lineMix[240];
+    bool gfxInWin0[240];
+    bool gfxInWin1[240];
+    int lineOBJpixleft[128];
+    int gfxBG2Changed = 0;
+    int gfxBG3Changed = 0;
+    int gfxBG2X = 0;
+    int gfxBG2Y = 0;
+    int gfxBG3X = 0;
+    int gfxBG3Y = 0;
+    int gfxLastVCOUNT = 0;
+    int gfxLayerEnable = 0xff00;
+    uint8_t gfxTileCache[kTileCacheTiles][64];
+    uint32_t gfxTileDirty[kTileCacheTiles / 32] = {
+        ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+        ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+        ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+        ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+    };
+    GfxSprite gfxSprites[kSpriteCount];
+    uint32_t gfxSpriteLines[kSpriteLines][kSpriteCount / 32];
+    uint32_t gfxSpriteDirty[kSpriteCount / 32] = { ~0u, ~0u, ~0u, ~0u };
+    bool gfxSpriteIndexDirty = true;
+    LineWriterHashes g_lineWriterHashes;
+#if defined(VBAM_ENABLE_THREADED_RENDERER)
+    // Pages of each region stored to since the last queued line.
+    uint64_t gfxThreadsDirty[kGfxRegions] = { ~uint64_t(0), ~uint64_t(0), ~uint64_t(0) };
+    // The workers are joined when the core is destroyed.
+    std::unique_ptr<GfxPool, GfxPoolDeleter> gfxPool;
+#endif  // defined(VBAM_ENABLE_THREADED_RENDERER)
+
+    // Sound
+    std::unique_ptr<SoundDriver> soundDriver;
+    uint16_t soundFinalWave[1600];
+    long soundSampleRate = 44100;
+    bool g_gbaSoundInterpolation = true;
+    bool g_soundDynamicRate = false;
+    bool soundPaused = true;
+    float soundFiltering = 0.5f;
+    int soundTicks = SOUND_CLOCK_TICKS_;
+    float soundVolume = 1.0f;
+    int soundEnableFlag = 0x3ff; // emulator channels enabled
+    float soundFiltering_ = -1.0f;
+    float soundVolume_ = -1.0f;
+    bool soundSilent = false;
+    bool soundSilent_ = false;
+    unsigned short soundThrottle = 100;
+    Resampler soundResampler;
+    double soundRateLevel = 0.5;
+    double soundRateCorrection = 0.0;
+    double soundRate = 1.0;
+    std::vector<int16_t> soundResampled;
+    Gba_Pcm_Fifo pcm[2];
+    Gb_Apu* gb_apu;
+    Stereo_Buffer* stereo_buffer;
+    Blip_Synth<blip_best_quality, 1> pcm_synth[3]; // 32 kHz, 16 kHz, 8 kHz
+    Gba_Sound_State soundState;
+    int soundDummyState[16];
+
+    // Cartridge hardware
+    void (*cpuSaveGameFunc)(uint32_t, uint8_t) = flashSaveDecide;
+    bool cpuSramEnabled = true;
+    bool cpuFlashEnabled = true;
+    bool cpuEEPROMEnabled = true;
+    bool cpuEEPROMSensorEnabled = false;
+    uint8_t flashSaveMemory[SIZE_FLASH1M];
+    int flashState = FLASH_READ_ARRAY;
+    int flashReadState = FLASH_READ_ARRAY;
+    int g_flashSize = SIZE_FLASH512;
+    int flashDeviceID = 0x1b;
+    int flashManufacturerID = 0x32;
+    int flashBank = 0;
+    int eepromMode = EEPROM_IDLE;
+    int eepromByte = 0;
+    int eepromBits = 0;
+    int eepromAddress = 0;
+    uint8_t eepromData[SIZE_EEPROM_8K];
+    uint8_t eepromBuffer[16];
+    bool eepromInUse = false;
+    int eepromSize = SIZE_EEPROM_512;
+    struct tm gba_time;
+    RTCCLOCKDATA rtcClockData;
+    bool rtcClockEnabled = true;
+    bool rtcRumbleEnabled = false;
+    uint32_t countTicks = 0;
+    bool agbPrintEnabled = false;
+    bool agbPrintProtect = false;
+    char rom_info[19];
+    unsigned char ShortDotCodeHeader[0x30] = {
+        0x00, 0x30, 0x01, 0x01,
+        0x00, 0x01, 0x05, 0x10,
+        0x00, 0x00, 0x10, 0x12, //Constant data
+
+        0x00, 0x00, //Header First 2 bytes
+
+        0x02, 0x00, //Constant data
+
+        0x00, 0x00, //Header Second 2 bytes
+
+        0x10, 0x47, 0xEF, //Global Checksum 1
+
+        0x19, 0x00, 0x00, 0x00, 0x08, 0x4E, 0x49,
+        0x4E, 0x54, 0x45, 0x4E, 0x44, 0x4F, 0x00, 0x22,
+        0x00, 0x09, //Constant data
+
+        0x00, 0x00, //Header, last 8 bytes
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00,
+        0x00, //Header Checksum
+        0x57 //Global Checksum 2
+    };
+    unsigned char LongDotCodeHeader[0x30] = {
+        0x00, 0x30, 0x01, 0x02,
+        0x00, 0x01, 0x08, 0x10,
+        0x00, 0x00, 0x10, 0x12, //Constant Data
+
+        0x00, 0x00, //Header, first 2 bytes
+
+        0x01, 0x00, //Constant data
+
+        0x00, 0x00, //Header, second 2 bytes
+        0x10, 0x9A, 0x99, //Global Checksum 1
+
+        0x19, 0x00, 0x00, 0x00, 0x08, 0x4E, 0x49,
+        0x4E, 0x54, 0x45, 0x4E, 0x44, 0x4F, 0x00, 0x22,
+        0x00, 0x09, //Constant data
+
+        0x00, 0x00, //Header, last 8 bytes
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00,
+        0x00, //Header Checksum
+        0x57 //Global Checksum 2
+    };
+    unsigned char dotcodeheader[0x48];
+    unsigned char dotcodedata[0xB38];
+    unsigned char dotcodetemp[0xB00];
+    int dotcodepointer;
+    int dotcodeinterleave;
+    int decodestate;
+    uint32_t GFpow;
+    unsigned char* DotCodeData;
+    char filebuffer[2048];
+    int dotcodesize;
+
+    // Link
+    bool gba_joybus_enabled = false;
+    bool gba_joybus_active = false;
+
+    // Cheats
+    uint32_t mastercode = 0;
+    CheatsData cheatsList[MAX_CHEATS];
+    int cheatsNumber = 0;
+    uint32_t rompatch2addr[4];
+    uint16_t rompatch2val[4];
+    uint16_t rompatch2oldval[4];
+    uint8_t cheatsCBASeedBuffer[0x30];
+    uint32_t cheatsCBASeed[4];
+    uint32_t cheatsCBATemporaryValue = 0;
+    uint16_t cheatsCBATable[256];
+    bool cheatsCBATableGenerated = false;
+    uint16_t super = 0;
+    uint8_t cheatsCBACurrentSeed[12] = {
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    };
+    uint32_t seeds_v1[4];
+    uint32_t seeds_v3[4];
+    CheatSearchBlock cheatSearchBlocks[4];
+    CheatSearchData cheatSearchData = {
+        0,
+        cheatSearchBlocks
+    };
+
+    // Debugger
+    bool debugger = false;
+#ifdef VBAM_ENABLE_DEBUGGER
+    uint8_t freezeWorkRAM[SIZE_WRAM];
+    uint8_t freezeInternalRAM[SIZE_IRAM];
+    uint8_t freezeVRAM[0x18000];
+    uint8_t freezePRAM[SIZE_PRAM];
+    uint8_t freezeOAM[SIZE_OAM];
+    bool debugger_last;
+    int oldreg[18];
+    char oldbuffer[10];
+#endif
+
+    // Frontend interface
+    int frameCount = 0;
+    char g_buffer[1024];
+    uint32_t lastTime = 0;
+    int g_count = 0;
+    int capture = 0;
+    int capturePrevious = 0;
+    int captureNumber = 0;
+    uint32_t joy;
+    bool has_frames;
+    bool disableMessage = false;
+    bool speedup_throttle_set = false;
+    uint32_t last_throttle;
+    bool speedup_silenced = false;
+};
+
+#if defined(VBAM_ENABLE_REENTRANT_CORE)
+// The core of the threads that never switched to another one.
+extern GbaCore gbaMainCore;
+
+// A single slot in the static TLS block, so that a shared library reaches it
+// without calling __tls_get_addr().
+#if defined(__GNUC__) && defined(__linux__) && !defined(__ANDROID__)
+#define VBAM_TLS_INITIAL_EXEC __attribute__((tls_model("initial-exec")))
+#else
+#define VBAM_TLS_INITIAL_EXEC
+#endif
+
+// The core the calling thread runs.
+inline thread_local GbaCore* gbaCurrentCore VBAM_TLS_INITIAL_EXEC = &gbaMainCore;
+
+#define gbaCore (*gbaCurrentCore)
+
+// Creates a core in the power-on state, with no ROM loaded.
+GbaCore* gbaCoreCreate();
+
+// Destroys a core returned by gbaCoreCreate(), which no thread may be running.
+// Its ROM and sound must have been released with emuCleanUp() and
+// soundShutdown() first.
+void gbaCoreDestroy(GbaCore* core);
+
+// Makes the calling thread run `core` and returns the core it ran before.
+inline GbaCore* gbaCoreSwitch(GbaCore* core)
+{
+    GbaCore* previous = gbaCurrentCore;
+    gbaCurrentCore = core;
+    return previous;
+}
+#else
+extern GbaCore gbaCore;
+#endif  // defined(VBAM_ENABLE_REENTRANT_CORE)
+
+#ifdef VBAM_ENABLE_LAZY_FLAGS
+inline LazyNFlag::operator bool() const
+{
+    return gbaCore.flagResult < 0;
+}
+
+inline LazyNFlag& LazyNFlag::operator=(bool n)
+{
+    gbaCore.flagResult = n ? (gbaCore.flagResult | INT64_MIN) : (gbaCore.flagResult & INT64_MAX);
+    return *this;
+}
+
+inline LazyZFlag::operator bool() const
+{
+    return (uint32_t)gbaCore.flagResult == 0;
+}
+
+inline LazyZFlag& LazyZFlag::operator=(bool z)
+{
+    gbaCore.flagResult = (gbaCore.flagResult & ~(int64_t)0xFFFFFFFF) | (z ? 0 : 1);
+    return *this;
+}
+#endif
+
+#endif  // VBAM_CORE_GBA_GBACORE_H_
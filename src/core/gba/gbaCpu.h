@@ -10,10 +10,32 @@
 extern int armExecute();
 extern int thumbExecute();
 
-#if defined(__i386__) || defined(__x86_64__)
-#define INSN_REGPARM __attribute__((regparm(1)))
+// Guarantees that a `return f(...)` statement is compiled as a jump, when the
+// compiler supports it. Otherwise it is left to the optimizer.
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::musttail)
+#define VBAM_MUSTTAIL [[clang::musttail]]
+#elif __has_cpp_attribute(gnu::musttail)
+#define VBAM_MUSTTAIL [[gnu::musttail]]
+#endif
+#endif
+#if !defined(VBAM_MUSTTAIL)
+#define VBAM_MUSTTAIL /*nothing*/
+#endif
+
+#if defined(_MSC_VER)
+#define VBAM_FORCE_INLINE __forceinline
+#elif defined(__GNUC__)
+#define VBAM_FORCE_INLINE __attribute__((always_inline)) inline
 #else
-#define INSN_REGPARM /*nothing*/
+#define VBAM_FORCE_INLINE inline
+#endif
+
+// Keeps GCC from folding functions with identical code into one.
+#if defined(__GNUC__) && !defined(__clang__)
+#define VBAM_NO_ICF __attribute__((no_icf))
+#else
+#define VBAM_NO_ICF /*nothing*/
 #endif
 
 #ifdef __GNUC__
@@ -26,40 +48,25 @@ extern int thumbExecute();
 
 #define UPDATE_REG(address, value)                 \
     {                                              \
-        WRITE16LE(((uint16_t*)&g_ioMem[address]), value); \
+        WRITE16LE(((uint16_t*)&gbaCore.g_ioMem[address]), value); \
     }
 
 #define ARM_PREFETCH                                        \
     {                                                       \
-        cpuPrefetch[0] = CPUReadMemoryQuick(armNextPC);     \
-        cpuPrefetch[1] = CPUReadMemoryQuick(armNextPC + 4); \
+        gbaCore.cpuPrefetch[0] = CPUReadMemoryQuick(gbaCore.armNextPC);     \
+        gbaCore.cpuPrefetch[1] = CPUReadMemoryQuick(gbaCore.armNextPC + 4); \
     }
 
 #define THUMB_PREFETCH                                        \
     {                                                         \
-        cpuPrefetch[0] = CPUReadHalfWordQuick(armNextPC);     \
-        cpuPrefetch[1] = CPUReadHalfWordQuick(armNextPC + 2); \
+        gbaCore.cpuPrefetch[0] = CPUReadHalfWordQuick(gbaCore.armNextPC);     \
+        gbaCore.cpuPrefetch[1] = CPUReadHalfWordQuick(gbaCore.armNextPC + 2); \
     }
 
-#define ARM_PREFETCH_NEXT cpuPrefetch[1] = CPUReadMemoryQuick(armNextPC + 4);
-
-#define THUMB_PREFETCH_NEXT cpuPrefetch[1] = CPUReadHalfWordQuick(armNextPC + 2);
-
-extern int SWITicks;
-extern uint32_t mastercode;
-extern bool busPrefetch;
-extern bool busPrefetchEnable;
-extern uint32_t busPrefetchCount;
-extern int cpuNextEvent;
-extern bool holdState;
-extern uint32_t cpuPrefetch[2];
-extern int cpuTotalTicks;
-extern uint8_t memoryWait[16];
-extern uint8_t memoryWait32[16];
-extern uint8_t memoryWaitSeq[16];
-extern uint8_t memoryWaitSeq32[16];
-extern uint8_t cpuBitsSet[256];
-extern uint8_t cpuLowestBitSet[256];
+#define ARM_PREFETCH_NEXT gbaCore.cpuPrefetch[1] = CPUReadMemoryQuick(gbaCore.armNextPC + 4);
+
+#define THUMB_PREFETCH_NEXT gbaCore.cpuPrefetch[1] = CPUReadHalfWordQuick(gbaCore.armNextPC + 2);
+
 extern void CPUSwitchMode(int mode, bool saveState, bool breakLoop);
 extern void CPUSwitchMode(int mode, bool saveState);
 extern void CPUUpdateCPSR();
@@ -73,16 +80,16 @@ extern void CPUSoftwareInterrupt(int comment);
 inline int dataTicksAccess16(uint32_t address) // DATA 8/16bits NON SEQ
 {
     int addr = (address >> 24) & 15;
-    int value = memoryWait[addr];
+    int value = gbaCore.memoryWait[addr];
 
     if ((addr >= 0x08) || (addr < 0x02)) {
-        busPrefetchCount = 0;
-        busPrefetch = false;
-    } else if (busPrefetch) {
+        gbaCore.busPrefetchCount = 0;
+        gbaCore.busPrefetch = false;
+    } else if (gbaCore.busPrefetch) {
         int waitState = value;
         if (!waitState)
             waitState = 1;
-        busPrefetchCount = ((busPrefetchCount + 1) << waitState) - 1;
+        gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount + 1) << waitState) - 1;
     }
 
     return value;
@@ -91,16 +98,16 @@ inline int dataTicksAccess16(uint32_t address) // DATA 8/16bits NON SEQ
 inline int dataTicksAccess32(uint32_t address) // DATA 32bits NON SEQ
 {
     int addr = (address >> 24) & 15;
-    int value = memoryWait32[addr];
+    int value = gbaCore.memoryWait32[addr];
 
     if ((addr >= 0x08) || (addr < 0x02)) {
-        busPrefetchCount = 0;
-        busPrefetch = false;
-    } else if (busPrefetch) {
+        gbaCore.busPrefetchCount = 0;
+        gbaCore.busPrefetch = false;
+    } else if (gbaCore.busPrefetch) {
         int waitState = value;
         if (!waitState)
             waitState = 1;
-        busPrefetchCount = ((busPrefetchCount + 1) << waitState) - 1;
+        gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount + 1) << waitState) - 1;
     }
 
     return value;
@@ -109,16 +116,16 @@ inline int dataTicksAccess32(uint32_t address) // DATA 32bits NON SEQ
 inline int dataTicksAccessSeq16(uint32_t address) // DATA 8/16bits SEQ
 {
     int addr = (address >> 24) & 15;
-    int value = memoryWaitSeq[addr];
+    int value = gbaCore.memoryWaitSeq[addr];
 
     if ((addr >= 0x08) || (addr < 0x02)) {
-        busPrefetchCount = 0;
-        busPrefetch = false;
-    } else if (busPrefetch) {
+        gbaCore.busPrefetchCount = 0;
+        gbaCore.busPrefetch = false;
+    } else if (gbaCore.busPrefetch) {
         int waitState = value;
         if (!waitState)
             waitState = 1;
-        busPrefetchCount = ((busPrefetchCount + 1) << waitState) - 1;
+        gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount + 1) << waitState) - 1;
     }
 
     return value;
@@ -127,16 +134,16 @@ inline int dataTicksAccessSeq16(uint32_t address) // DATA 8/16bits SEQ
 inline int dataTicksAccessSeq32(uint32_t address) // DATA 32bits SEQ
 {
     int addr = (address >> 24) & 15;
-    int value = memoryWaitSeq32[addr];
+    int value = gbaCore.memoryWaitSeq32[addr];
 
     if ((addr >= 0x08) || (addr < 0x02)) {
-        busPrefetchCount = 0;
-        busPrefetch = false;
-    } else if (busPrefetch) {
+        gbaCore.busPrefetchCount = 0;
+        gbaCore.busPrefetch = false;
+    } else if (gbaCore.busPrefetch) {
         int waitState = value;
         if (!waitState)
             waitState = 1;
-        busPrefetchCount = ((busPrefetchCount + 1) << waitState) - 1;
+        gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount + 1) << waitState) - 1;
     }
 
     return value;
@@ -148,20 +155,20 @@ inline int codeTicksAccess16(uint32_t address) // THUMB NON SEQ
     int addr = (address >> 24) & 15;
 
     if ((addr >= 0x08) && (addr <= 0x0D)) {
-        if (busPrefetchCount & 0x1) {
-            if (busPrefetchCount & 0x2) {
-                busPrefetchCount = ((busPrefetchCount & 0xFF) >> 2) | (busPrefetchCount & 0xFFFFFF00);
+        if (gbaCore.busPrefetchCount & 0x1) {
+            if (gbaCore.busPrefetchCount & 0x2) {
+                gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 2) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
                 return 0;
             }
-            busPrefetchCount = ((busPrefetchCount & 0xFF) >> 1) | (busPrefetchCount & 0xFFFFFF00);
-            return memoryWaitSeq[addr] - 1;
+            gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 1) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
+            return gbaCore.memoryWaitSeq[addr] - 1;
         } else {
-            busPrefetchCount = 0;
-            return memoryWait[addr];
+            gbaCore.busPrefetchCount = 0;
+            return gbaCore.memoryWait[addr];
         }
     } else {
-        busPrefetchCount = 0;
-        return memoryWait[addr];
+        gbaCore.busPrefetchCount = 0;
+        return gbaCore.memoryWait[addr];
     }
 }
 
@@ -170,20 +177,20 @@ inline int codeTicksAccess32(uint32_t address) // ARM NON SEQ
     int addr = (address >> 24) & 15;
 
     if ((addr >= 0x08) && (addr <= 0x0D)) {
-        if (busPrefetchCount & 0x1) {
-            if (busPrefetchCount & 0x2) {
-                busPrefetchCount = ((busPrefetchCount & 0xFF) >> 2) | (busPrefetchCount & 0xFFFFFF00);
+        if (gbaCore.busPrefetchCount & 0x1) {
+            if (gbaCore.busPrefetchCount & 0x2) {
+                gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 2) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
                 return 0;
             }
-            busPrefetchCount = ((busPrefetchCount & 0xFF) >> 1) | (busPrefetchCount & 0xFFFFFF00);
-            return memoryWaitSeq[addr] - 1;
+            gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 1) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
+            return gbaCore.memoryWaitSeq[addr] - 1;
         } else {
-            busPrefetchCount = 0;
-            return memoryWait32[addr];
+            gbaCore.busPrefetchCount = 0;
+            return gbaCore.memoryWait32[addr];
         }
     } else {
-        busPrefetchCount = 0;
-        return memoryWait32[addr];
+        gbaCore.busPrefetchCount = 0;
+        return gbaCore.memoryWait32[addr];
     }
 }
 
@@ -192,17 +199,17 @@ inline int codeTicksAccessSeq16(uint32_t address) // THUMB SEQ
     int addr = (address >> 24) & 15;
 
     if ((addr >= 0x08) && (addr <= 0x0D)) {
-        if (busPrefetchCount & 0x1) {
-            busPrefetchCount = ((busPrefetchCount & 0xFF) >> 1) | (busPrefetchCount & 0xFFFFFF00);
+        if (gbaCore.busPrefetchCount & 0x1) {
+            gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 1) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
             return 0;
-        } else if (busPrefetchCount > 0xFF) {
-            busPrefetchCount = 0;
-            return memoryWait[addr];
+        } else if (gbaCore.busPrefetchCount > 0xFF) {
+            gbaCore.busPrefetchCount = 0;
+            return gbaCore.memoryWait[addr];
         } else
-            return memoryWaitSeq[addr];
+            return gbaCore.memoryWaitSeq[addr];
     } else {
-        busPrefetchCount = 0;
-        return memoryWaitSeq[addr];
+        gbaCore.busPrefetchCount = 0;
+        return gbaCore.memoryWaitSeq[addr];
     }
 }
 
@@ -211,32 +218,32 @@ inline int codeTicksAccessSeq32(uint32_t address) // ARM SEQ
     int addr = (address >> 24) & 15;
 
     if ((addr >= 0x08) && (addr <= 0x0D)) {
-        if (busPrefetchCount & 0x1) {
-            if (busPrefetchCount & 0x2) {
-                busPrefetchCount = ((busPrefetchCount & 0xFF) >> 2) | (busPrefetchCount & 0xFFFFFF00);
+        if (gbaCore.busPrefetchCount & 0x1) {
+            if (gbaCore.busPrefetchCount & 0x2) {
+                gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 2) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
                 return 0;
             }
-            busPrefetchCount = ((busPrefetchCount & 0xFF) >> 1) | (busPrefetchCount & 0xFFFFFF00);
-            return memoryWaitSeq[addr];
-        } else if (busPrefetchCount > 0xFF) {
-            busPrefetchCount = 0;
-            return memoryWait32[addr];
+            gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount & 0xFF) >> 1) | (gbaCore.busPrefetchCount & 0xFFFFFF00);
+            return gbaCore.memoryWaitSeq[addr];
+        } else if (gbaCore.busPrefetchCount > 0xFF) {
+            gbaCore.busPrefetchCount = 0;
+            return gbaCore.memoryWait32[addr];
         } else
-            return memoryWaitSeq32[addr];
+            return gbaCore.memoryWaitSeq32[addr];
     } else {
-        return memoryWaitSeq32[addr];
+        return gbaCore.memoryWaitSeq32[addr];
     }
 }
 
 // Emulates the Cheat System (m) code
 inline void cpuMasterCodeCheck()
 {
-    if ((mastercode) && (mastercode == armNextPC)) {
+    if ((gbaCore.mastercode) && (gbaCore.mastercode == gbaCore.armNextPC)) {
         uint32_t joy = 0;
         if (systemReadJoypads())
             joy = systemReadJoypad(-1);
         uint32_t ext = (joy >> 10);
-        cpuTotalTicks += cheatsCheckKeys(P1 ^ 0x3FF, ext);
+        gbaCore.cpuTotalTicks += cheatsCheckKeys(gbaCore.P1 ^ 0x3FF, ext);
     }
 }
 
@@ -1,8 +1,13 @@
 #include "core/gba/gba.h"
 
+#include <array>
+#include <utility>
+
 #include "core/gba/gbaCpu.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaDecodeCache.h"
+#include "core/gba/internal/gbaIdleLoop.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 #include "core/gba/gbaRemote.h"
@@ -22,14 +27,12 @@
 
 ///////////////////////////////////////////////////////////////////////////
 
-static int clockTicks;
-
 static INSN_REGPARM void armUnknownInsn(uint32_t opcode)
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_UNDEFINED) {
         log("Undefined ARM instruction %08x at %08x\n", opcode,
-            armNextPC - 4);
+            gbaCore.armNextPC - 4);
     }
 #endif
     CPUUndefinedException();
@@ -38,10 +41,10 @@ static INSN_REGPARM void armUnknownInsn(uint32_t opcode)
 #ifdef VBAM_ENABLE_DEBUGGER
 static INSN_REGPARM void armBreakpoint(uint32_t opcode)
 {
-    reg[15].I -= 4;
-    armNextPC -= 4;
+    gbaCore.reg[15].I -= 4;
+    gbaCore.armNextPC -= 4;
     dbgSignal(5, (opcode & 0x0f) | ((opcode >> 4) & 0xfff0));
-    clockTicks = -1;
+    gbaCore.clockTicks = -1;
 }
 #endif
 
@@ -88,7 +91,7 @@ static void count(uint32_t opcode, int cond_res)
 #ifdef VBAM_ENABLE_DEBUGGER
 #define CONSOLE_OUTPUT(a, b)                                      \
     do {                                                          \
-        if ((opcode == 0xe0000000) && (reg[0].I == 0xC0DED00D)) { \
+        if ((opcode == 0xe0000000) && (gbaCore.reg[0].I == 0xC0DED00D)) { \
             dbgOutput((a), (b));                                  \
         }                                                         \
         while (0)
@@ -137,13 +140,13 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[base].I),   \
+                     : "r"(gbaCore.reg[base].I),   \
                      "r"(value));          \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define OP_RSBS                             \
     {                                       \
@@ -154,13 +157,13 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr %1\n"            \
                      : "=r"(Result),        \
                      "=r"(Flags)            \
-                     : "r"(reg[base].I),    \
+                     : "r"(gbaCore.reg[base].I),    \
                      "r"(value));           \
-        reg[dest].I = Result;               \
-        Z_FLAG = (Flags >> 29) & 1;         \
-        N_FLAG = (Flags >> 31) & 1;         \
-        C_FLAG = (Flags >> 25) & 1;         \
-        V_FLAG = (Flags >> 26) & 1;         \
+        gbaCore.reg[dest].I = Result;               \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;         \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;         \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;         \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;         \
     }
 #define OP_ADDS                            \
     {                                      \
@@ -171,13 +174,13 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[base].I),   \
+                     : "r"(gbaCore.reg[base].I),   \
                      "r"(value));          \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define OP_ADCS                            \
     {                                      \
@@ -189,14 +192,14 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr      %1\n"      \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[base].I),   \
+                     : "r"(gbaCore.reg[base].I),   \
                      "r"(value),           \
-                     "r"(C_FLAG << 29));   \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+                     "r"(gbaCore.C_FLAG << 29));   \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define OP_SBCS                             \
     {                                       \
@@ -208,14 +211,14 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr      %1\n"       \
                      : "=r"(Result),        \
                      "=r"(Flags)            \
-                     : "r"(reg[base].I),    \
+                     : "r"(gbaCore.reg[base].I),    \
                      "r"(value),            \
-                     "r"(C_FLAG << 29));    \
-        reg[dest].I = Result;               \
-        Z_FLAG = (Flags >> 29) & 1;         \
-        N_FLAG = (Flags >> 31) & 1;         \
-        C_FLAG = (Flags >> 25) & 1;         \
-        V_FLAG = (Flags >> 26) & 1;         \
+                     "r"(gbaCore.C_FLAG << 29));    \
+        gbaCore.reg[dest].I = Result;               \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;         \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;         \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;         \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;         \
     }
 #define OP_RSCS                             \
     {                                       \
@@ -227,14 +230,14 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr      %1\n"       \
                      : "=r"(Result),        \
                      "=r"(Flags)            \
-                     : "r"(reg[base].I),    \
+                     : "r"(gbaCore.reg[base].I),    \
                      "r"(value),            \
-                     "r"(C_FLAG << 29));    \
-        reg[dest].I = Result;               \
-        Z_FLAG = (Flags >> 29) & 1;         \
-        N_FLAG = (Flags >> 31) & 1;         \
-        C_FLAG = (Flags >> 25) & 1;         \
-        V_FLAG = (Flags >> 26) & 1;         \
+                     "r"(gbaCore.C_FLAG << 29));    \
+        gbaCore.reg[dest].I = Result;               \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;         \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;         \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;         \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;         \
     }
 #define OP_CMP                             \
     {                                      \
@@ -245,12 +248,12 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[base].I),   \
+                     : "r"(gbaCore.reg[base].I),   \
                      "r"(value));          \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define OP_CMN                             \
     {                                      \
@@ -261,12 +264,12 @@ static void count(uint32_t opcode, int cond_res)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[base].I),   \
+                     : "r"(gbaCore.reg[base].I),   \
                      "r"(value));          \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 
 #else // !__POWERPC__
@@ -317,8 +320,8 @@ static void count(uint32_t opcode, int cond_res)
 #define KONST(val) val
 #define VAR(var) var
 #define VARL(var) dword ptr var
-#define REGREF1(index) reg[index]
-#define REGREF2(index, scale) reg[index * scale]
+#define REGREF1(index) gbaCore.reg[index]
+#define REGREF2(index, scale) gbaCore.reg[index * scale]
 #define LABEL(n) __asm l##n:
 #define LABELREF(n, dir) l##n
 #endif
@@ -350,19 +353,19 @@ static void count(uint32_t opcode, int cond_res)
 
 // Helper macros for setting flags
 #define SETCOND_LOGICAL      \
-    EMIT1(sets, VAR(N_FLAG)) \
-    EMIT1(setz, VAR(Z_FLAG)) \
-    EMIT2(mov, bl, VAR(C_FLAG))
+    EMIT1(sets, VAR(gbaCore.N_FLAG)) \
+    EMIT1(setz, VAR(gbaCore.Z_FLAG)) \
+    EMIT2(mov, bl, VAR(gbaCore.C_FLAG))
 #define SETCOND_ADD          \
-    EMIT1(sets, VAR(N_FLAG)) \
-    EMIT1(setz, VAR(Z_FLAG)) \
-    EMIT1(seto, VAR(V_FLAG)) \
-    EMIT1(setc, VAR(C_FLAG))
+    EMIT1(sets, VAR(gbaCore.N_FLAG)) \
+    EMIT1(setz, VAR(gbaCore.Z_FLAG)) \
+    EMIT1(seto, VAR(gbaCore.V_FLAG)) \
+    EMIT1(setc, VAR(gbaCore.C_FLAG))
 #define SETCOND_SUB          \
-    EMIT1(sets, VAR(N_FLAG)) \
-    EMIT1(setz, VAR(Z_FLAG)) \
-    EMIT1(seto, VAR(V_FLAG)) \
-    EMIT1(setnc, VAR(C_FLAG))
+    EMIT1(sets, VAR(gbaCore.N_FLAG)) \
+    EMIT1(setz, VAR(gbaCore.Z_FLAG)) \
+    EMIT1(seto, VAR(gbaCore.V_FLAG)) \
+    EMIT1(setnc, VAR(gbaCore.C_FLAG))
 
 // ALU initialization
 #define ALU_INIT(LOAD_C_FLAG)     \
@@ -377,7 +380,7 @@ static void count(uint32_t opcode, int cond_res)
     EMIT2(mov, REGREF1(edx), edx) \
     EMIT2(and, KONST(0x3C), esi)
 
-#define LOAD_C_FLAG_YES EMIT2(mov, VAR(C_FLAG), bl)
+#define LOAD_C_FLAG_YES EMIT2(mov, VAR(gbaCore.C_FLAG), bl)
 #define LOAD_C_FLAG_NO /*nothing*/
 #define ALU_INIT_C ALU_INIT(LOAD_C_FLAG_YES)
 #define ALU_INIT_NC ALU_INIT(LOAD_C_FLAG_NO)
@@ -540,7 +543,7 @@ static void count(uint32_t opcode, int cond_res)
     EMIT2(ror, cl, eax)               \
     EMIT1(jmp, LABELREF(0, f))        \
     LABEL(1)                          \
-    EMIT2(bt, KONST(0), VARL(C_FLAG)) \
+    EMIT2(bt, KONST(0), VARL(gbaCore.C_FLAG)) \
     EMIT2(rcr, KONST(1), eax)         \
     LABEL(0)
 
@@ -601,18 +604,18 @@ static void count(uint32_t opcode, int cond_res)
     EMIT2(mov, edx, REGREF1(esi))
 #define OP_ADDS CHECK_PC(OP_ADD, SETCOND_ADD)
 #define OP_ADC                        \
-    EMIT2(bt, KONST(0), VARL(C_FLAG)) \
+    EMIT2(bt, KONST(0), VARL(gbaCore.C_FLAG)) \
     EMIT2(adc, eax, edx)              \
     EMIT2(mov, edx, REGREF1(esi))
 #define OP_ADCS CHECK_PC(OP_ADC, SETCOND_ADD)
 #define OP_SBC                        \
-    EMIT2(bt, KONST(0), VARL(C_FLAG)) \
+    EMIT2(bt, KONST(0), VARL(gbaCore.C_FLAG)) \
     EMIT0(cmc)                        \
     EMIT2(sbb, eax, edx)              \
     EMIT2(mov, edx, REGREF1(esi))
 #define OP_SBCS CHECK_PC(OP_SBC, SETCOND_SUB)
 #define OP_RSC                        \
-    EMIT2(bt, KONST(0), VARL(C_FLAG)) \
+    EMIT2(bt, KONST(0), VARL(gbaCore.C_FLAG)) \
     EMIT0(cmc)                        \
     EMIT2(sbb, edx, eax)              \
     EMIT2(mov, eax, REGREF1(esi))
@@ -665,7 +668,7 @@ static void count(uint32_t opcode, int cond_res)
         : "0"(offset), "c"(shift));
 
 #define RRX_OFFSET                                     \
-    asm(EMIT2(btl, KONST(0), VAR(C_FLAG)) "rcr $1, %0" \
+    asm(EMIT2(btl, KONST(0), VAR(gbaCore.C_FLAG)) "rcr $1, %0" \
         : "=r"(offset)                                 \
         : "0"(offset));
 
@@ -685,7 +688,7 @@ static void count(uint32_t opcode, int cond_res)
 
 #define RRX_OFFSET                                                                                              \
     __asm {                             \
-        __asm bt dword ptr C_FLAG, 0    \
+        __asm bt dword ptr gbaCore.C_FLAG, 0    \
         __asm rcr offset, 1             \
     }
 
@@ -697,26 +700,23 @@ static void count(uint32_t opcode, int cond_res)
 // C core
 
 #define C_SETCOND_LOGICAL                       \
-    N_FLAG = ((int32_t)res < 0) ? true : false; \
-    Z_FLAG = (res == 0) ? true : false;         \
-    C_FLAG = C_OUT;
+    SETCOND_NZ(res);                            \
+    gbaCore.C_FLAG = C_OUT;
 #define C_SETCOND_ADD                                                                               \
-    N_FLAG = ((int32_t)res < 0) ? true : false;                                                     \
-    Z_FLAG = (res == 0) ? true : false;                                                             \
-    V_FLAG = ((NEG(lhs) & NEG(rhs) & POS(res)) | (POS(lhs) & POS(rhs) & NEG(res))) ? true : false;  \
-    C_FLAG = ((NEG(lhs) & NEG(rhs)) | (NEG(lhs) & POS(res)) | (NEG(rhs) & POS(res))) ? true : false;
+    SETCOND_NZ(res);                                                                                \
+    gbaCore.V_FLAG = ((NEG(lhs) & NEG(rhs) & POS(res)) | (POS(lhs) & POS(rhs) & NEG(res))) ? true : false;  \
+    gbaCore.C_FLAG = ((NEG(lhs) & NEG(rhs)) | (NEG(lhs) & POS(res)) | (NEG(rhs) & POS(res))) ? true : false;
 #define C_SETCOND_SUB                                                                               \
-    N_FLAG = ((int32_t)res < 0) ? true : false;                                                     \
-    Z_FLAG = (res == 0) ? true : false;                                                             \
-    V_FLAG = ((NEG(lhs) & POS(rhs) & POS(res)) | (POS(lhs) & NEG(rhs) & NEG(res))) ? true : false;  \
-    C_FLAG = ((NEG(lhs) & POS(rhs)) | (NEG(lhs) & POS(res)) | (POS(rhs) & POS(res))) ? true : false;
+    SETCOND_NZ(res);                                                                                \
+    gbaCore.V_FLAG = ((NEG(lhs) & POS(rhs) & POS(res)) | (POS(lhs) & NEG(rhs) & NEG(res))) ? true : false;  \
+    gbaCore.C_FLAG = ((NEG(lhs) & POS(rhs)) | (NEG(lhs) & POS(res)) | (POS(rhs) & POS(res))) ? true : false;
 
 #define maybe_unused(var) (void) var
 
 #ifndef ALU_INIT_C
 #define ALU_INIT_C                                      \
     int dest = (opcode >> 12) & 15; maybe_unused(dest); \
-    bool C_OUT = C_FLAG; maybe_unused(C_OUT);           \
+    bool C_OUT = gbaCore.C_FLAG; maybe_unused(C_OUT);           \
     uint32_t value; maybe_unused(value);
 #endif
 // OP Rd,Rb,Rm LSL #
@@ -724,9 +724,9 @@ static void count(uint32_t opcode, int cond_res)
 #define VALUE_LSL_IMM_C                                 \
     unsigned int shift = (opcode >> 7) & 0x1F;          \
     if (LIKELY(!shift)) { /* LSL #0 most common? */     \
-        value = reg[opcode & 0x0F].I;                   \
+        value = gbaCore.reg[opcode & 0x0F].I;                   \
     } else {                                            \
-        uint32_t v = reg[opcode & 0x0F].I;              \
+        uint32_t v = gbaCore.reg[opcode & 0x0F].I;              \
         C_OUT = (v >> (32 - shift)) & 1 ? true : false; \
         value = v << shift;                             \
     }
@@ -734,8 +734,8 @@ static void count(uint32_t opcode, int cond_res)
 // OP Rd,Rb,Rm LSL Rs
 #ifndef VALUE_LSL_REG_C
 #define VALUE_LSL_REG_C                                     \
-    uint32_t shift = reg[(opcode >> 8) & 15].B.B0;          \
-    uint32_t rm = reg[opcode & 0x0F].I;                     \
+    uint32_t shift = gbaCore.reg[(opcode >> 8) & 15].B.B0;          \
+    uint32_t rm = gbaCore.reg[opcode & 0x0F].I;                     \
     if ((opcode & 0x0F) == 15) {                            \
         rm += 4;                                            \
     }                                                       \
@@ -760,19 +760,19 @@ static void count(uint32_t opcode, int cond_res)
 #define VALUE_LSR_IMM_C                                             \
     uint32_t shift = (opcode >> 7) & 0x1F;                          \
     if (LIKELY(shift)) {                                            \
-        uint32_t v = reg[opcode & 0x0F].I;                          \
+        uint32_t v = gbaCore.reg[opcode & 0x0F].I;                          \
         C_OUT = (v >> (shift - 1)) & 1 ? true : false;              \
         value = v >> shift;                                         \
     } else {                                                        \
         value = 0;                                                  \
-        C_OUT = (reg[opcode & 0x0F].I & 0x80000000) ? true : false; \
+        C_OUT = (gbaCore.reg[opcode & 0x0F].I & 0x80000000) ? true : false; \
     }
 #endif
 // OP Rd,Rb,Rm LSR Rs
 #ifndef VALUE_LSR_REG_C
 #define VALUE_LSR_REG_C                                    \
-    unsigned int shift = reg[(opcode >> 8) & 15].B.B0;     \
-    uint32_t rm = reg[opcode & 0x0F].I;                    \
+    unsigned int shift = gbaCore.reg[(opcode >> 8) & 15].B.B0;     \
+    uint32_t rm = gbaCore.reg[opcode & 0x0F].I;                    \
     if ((opcode & 0x0F) == 15) {                           \
         rm += 4;                                           \
     }                                                      \
@@ -798,11 +798,11 @@ static void count(uint32_t opcode, int cond_res)
     unsigned int shift = (opcode >> 7) & 0x1F;                \
     if (LIKELY(shift)) {                                      \
         /* VC++ BUG: uint32_t v; (int32_t)v>>n is optimized to shr! */ \
-        int32_t v = reg[opcode & 0x0F].I;                     \
+        int32_t v = gbaCore.reg[opcode & 0x0F].I;                     \
         C_OUT = (v >> (int)(shift - 1)) & 1 ? true : false;   \
         value = v >> (int)shift;                              \
     } else {                                                  \
-        if (reg[opcode & 0x0F].I & 0x80000000) {              \
+        if (gbaCore.reg[opcode & 0x0F].I & 0x80000000) {              \
             value = 0xFFFFFFFF;                               \
             C_OUT = true;                                     \
         } else {                                              \
@@ -814,8 +814,8 @@ static void count(uint32_t opcode, int cond_res)
 // OP Rd,Rb,Rm ASR Rs
 #ifndef VALUE_ASR_REG_C
 #define VALUE_ASR_REG_C                                         \
-    unsigned int shift = reg[(opcode >> 8) & 15].B.B0;          \
-    uint32_t rm = reg[opcode & 0x0F].I;                         \
+    unsigned int shift = gbaCore.reg[(opcode >> 8) & 15].B.B0;          \
+    uint32_t rm = gbaCore.reg[opcode & 0x0F].I;                         \
     if ((opcode & 0x0F) == 15) {                                \
         rm += 4;                                                \
     }                                                           \
@@ -828,7 +828,7 @@ static void count(uint32_t opcode, int cond_res)
             value = rm;                                         \
         }                                                       \
     } else {                                                    \
-        if (reg[opcode & 0x0F].I & 0x80000000) {                \
+        if (gbaCore.reg[opcode & 0x0F].I & 0x80000000) {                \
             value = 0xFFFFFFFF;                                 \
             C_OUT = true;                                       \
         } else {                                                \
@@ -842,20 +842,20 @@ static void count(uint32_t opcode, int cond_res)
 #define VALUE_ROR_IMM_C                                \
     unsigned int shift = (opcode >> 7) & 0x1F;         \
     if (LIKELY(shift)) {                               \
-        uint32_t v = reg[opcode & 0x0F].I;             \
+        uint32_t v = gbaCore.reg[opcode & 0x0F].I;             \
         C_OUT = (v >> (shift - 1)) & 1 ? true : false; \
         value = ((v << (32 - shift)) | (v >> shift));  \
     } else {                                           \
-        uint32_t v = reg[opcode & 0x0F].I;             \
+        uint32_t v = gbaCore.reg[opcode & 0x0F].I;             \
         C_OUT = (v & 1) ? true : false;                \
-        value = ((v >> 1) | (C_FLAG << 31));           \
+        value = ((v >> 1) | (gbaCore.C_FLAG << 31));           \
     }
 #endif
 // OP Rd,Rb,Rm ROR Rs
 #ifndef VALUE_ROR_REG_C
 #define VALUE_ROR_REG_C                                  \
-    unsigned int shift = reg[(opcode >> 8) & 15].B.B0;   \
-    uint32_t rm = reg[opcode & 0x0F].I;                  \
+    unsigned int shift = gbaCore.reg[(opcode >> 8) & 15].B.B0;   \
+    uint32_t rm = gbaCore.reg[opcode & 0x0F].I;                  \
     if ((opcode & 0x0F) == 15) {                         \
         rm += 4;                                         \
     }                                                    \
@@ -921,26 +921,26 @@ static void count(uint32_t opcode, int cond_res)
     }
 #ifndef OP_AND
 #define OP_AND                                         \
-    uint32_t res = reg[(opcode >> 16) & 15].I & value; \
-    reg[dest].I = res;
+    uint32_t res = gbaCore.reg[(opcode >> 16) & 15].I & value; \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_ANDS
 #define OP_ANDS OP_AND C_CHECK_PC(C_SETCOND_LOGICAL)
 #endif
 #ifndef OP_EOR
 #define OP_EOR                                         \
-    uint32_t res = reg[(opcode >> 16) & 15].I ^ value; \
-    reg[dest].I = res;
+    uint32_t res = gbaCore.reg[(opcode >> 16) & 15].I ^ value; \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_EORS
 #define OP_EORS OP_EOR C_CHECK_PC(C_SETCOND_LOGICAL)
 #endif
 #ifndef OP_SUB
 #define OP_SUB                                 \
-    uint32_t lhs = reg[(opcode >> 16) & 15].I; \
+    uint32_t lhs = gbaCore.reg[(opcode >> 16) & 15].I; \
     uint32_t rhs = value;                      \
     uint32_t res = lhs - rhs;                  \
-    reg[dest].I = res;
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_SUBS
 #define OP_SUBS OP_SUB C_CHECK_PC(C_SETCOND_SUB)
@@ -948,39 +948,39 @@ static void count(uint32_t opcode, int cond_res)
 #ifndef OP_RSB
 #define OP_RSB                                 \
     uint32_t lhs = value;                      \
-    uint32_t rhs = reg[(opcode >> 16) & 15].I; \
+    uint32_t rhs = gbaCore.reg[(opcode >> 16) & 15].I; \
     uint32_t res = lhs - rhs;                  \
-    reg[dest].I = res;
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_RSBS
 #define OP_RSBS OP_RSB C_CHECK_PC(C_SETCOND_SUB)
 #endif
 #ifndef OP_ADD
 #define OP_ADD                                 \
-    uint32_t lhs = reg[(opcode >> 16) & 15].I; \
+    uint32_t lhs = gbaCore.reg[(opcode >> 16) & 15].I; \
     uint32_t rhs = value;                      \
     uint32_t res = lhs + rhs;                  \
-    reg[dest].I = res;
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_ADDS
 #define OP_ADDS OP_ADD C_CHECK_PC(C_SETCOND_ADD)
 #endif
 #ifndef OP_ADC
 #define OP_ADC                                   \
-    uint32_t lhs = reg[(opcode >> 16) & 15].I;   \
+    uint32_t lhs = gbaCore.reg[(opcode >> 16) & 15].I;   \
     uint32_t rhs = value;                        \
-    uint32_t res = lhs + rhs + (uint32_t)C_FLAG; \
-    reg[dest].I = res;
+    uint32_t res = lhs + rhs + (uint32_t)gbaCore.C_FLAG; \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_ADCS
 #define OP_ADCS OP_ADC C_CHECK_PC(C_SETCOND_ADD)
 #endif
 #ifndef OP_SBC
 #define OP_SBC                                      \
-    uint32_t lhs = reg[(opcode >> 16) & 15].I;      \
+    uint32_t lhs = gbaCore.reg[(opcode >> 16) & 15].I;      \
     uint32_t rhs = value;                           \
-    uint32_t res = lhs - rhs - !((uint32_t)C_FLAG); \
-    reg[dest].I = res;
+    uint32_t res = lhs - rhs - !((uint32_t)gbaCore.C_FLAG); \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_SBCS
 #define OP_SBCS OP_SBC C_CHECK_PC(C_SETCOND_SUB)
@@ -988,41 +988,41 @@ static void count(uint32_t opcode, int cond_res)
 #ifndef OP_RSC
 #define OP_RSC                                      \
     uint32_t lhs = value;                           \
-    uint32_t rhs = reg[(opcode >> 16) & 15].I;      \
-    uint32_t res = lhs - rhs - !((uint32_t)C_FLAG); \
-    reg[dest].I = res;
+    uint32_t rhs = gbaCore.reg[(opcode >> 16) & 15].I;      \
+    uint32_t res = lhs - rhs - !((uint32_t)gbaCore.C_FLAG); \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_RSCS
 #define OP_RSCS OP_RSC C_CHECK_PC(C_SETCOND_SUB)
 #endif
 #ifndef OP_TST
 #define OP_TST                                           \
-    uint32_t res = reg[(opcode >> 16) & 0x0F].I & value; \
+    uint32_t res = gbaCore.reg[(opcode >> 16) & 0x0F].I & value; \
     C_SETCOND_LOGICAL;
 #endif
 #ifndef OP_TEQ
 #define OP_TEQ                                           \
-    uint32_t res = reg[(opcode >> 16) & 0x0F].I ^ value; \
+    uint32_t res = gbaCore.reg[(opcode >> 16) & 0x0F].I ^ value; \
     C_SETCOND_LOGICAL;
 #endif
 #ifndef OP_CMP
 #define OP_CMP                                 \
-    uint32_t lhs = reg[(opcode >> 16) & 15].I; \
+    uint32_t lhs = gbaCore.reg[(opcode >> 16) & 15].I; \
     uint32_t rhs = value;                      \
     uint32_t res = lhs - rhs;                  \
     C_SETCOND_SUB;
 #endif
 #ifndef OP_CMN
 #define OP_CMN                                 \
-    uint32_t lhs = reg[(opcode >> 16) & 15].I; \
+    uint32_t lhs = gbaCore.reg[(opcode >> 16) & 15].I; \
     uint32_t rhs = value;                      \
     uint32_t res = lhs + rhs;                  \
     C_SETCOND_ADD;
 #endif
 #ifndef OP_ORR
 #define OP_ORR                                           \
-    uint32_t res = reg[(opcode >> 16) & 0x0F].I | value; \
-    reg[dest].I = res;
+    uint32_t res = gbaCore.reg[(opcode >> 16) & 0x0F].I | value; \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_ORRS
 #define OP_ORRS OP_ORR C_CHECK_PC(C_SETCOND_LOGICAL)
@@ -1030,15 +1030,15 @@ static void count(uint32_t opcode, int cond_res)
 #ifndef OP_MOV
 #define OP_MOV            \
     uint32_t res = value; \
-    reg[dest].I = res;
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_MOVS
 #define OP_MOVS OP_MOV C_CHECK_PC(C_SETCOND_LOGICAL)
 #endif
 #ifndef OP_BIC
 #define OP_BIC                                              \
-    uint32_t res = reg[(opcode >> 16) & 0x0F].I & (~value); \
-    reg[dest].I = res;
+    uint32_t res = gbaCore.reg[(opcode >> 16) & 0x0F].I & (~value); \
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_BICS
 #define OP_BICS OP_BIC C_CHECK_PC(C_SETCOND_LOGICAL)
@@ -1046,7 +1046,7 @@ static void count(uint32_t opcode, int cond_res)
 #ifndef OP_MVN
 #define OP_MVN             \
     uint32_t res = ~value; \
-    reg[dest].I = res;
+    gbaCore.reg[dest].I = res;
 #endif
 #ifndef OP_MVNS
 #define OP_MVNS OP_MVN C_CHECK_PC(C_SETCOND_LOGICAL)
@@ -1056,14 +1056,12 @@ static void count(uint32_t opcode, int cond_res)
 #define SETCOND_NONE /*nothing*/
 #endif
 #ifndef SETCOND_MUL
-#define SETCOND_MUL                                     \
-    N_FLAG = ((int32_t)reg[dest].I < 0) ? true : false; \
-    Z_FLAG = reg[dest].I ? false : true;
+#define SETCOND_MUL SETCOND_NZ(gbaCore.reg[dest].I);
 #endif
 #ifndef SETCOND_MULL
 #define SETCOND_MULL                                    \
-    N_FLAG = (reg[dest].I & 0x80000000) ? true : false; \
-    Z_FLAG = reg[dest].I || reg[acc].I ? false : true;
+    gbaCore.N_FLAG = (gbaCore.reg[dest].I & 0x80000000) ? true : false; \
+    gbaCore.Z_FLAG = gbaCore.reg[dest].I || gbaCore.reg[acc].I ? false : true;
 #endif
 
 #ifndef ALU_FINISH
@@ -1081,7 +1079,7 @@ static void count(uint32_t opcode, int cond_res)
 #endif
 #ifndef RRX_OFFSET
 #define RRX_OFFSET \
-    offset = ((offset >> 1) | ((int)C_FLAG << 31));
+    offset = ((offset >> 1) | ((int)gbaCore.C_FLAG << 31));
 #endif
 
 // ALU ops (except multiply) //////////////////////////////////////////////
@@ -1095,29 +1093,29 @@ static void count(uint32_t opcode, int cond_res)
 #define ALU_INSN(ALU_INIT, GETVALUE, OP, MODECHANGE, ISREGSHIFT) \
     ALU_INIT GETVALUE OP ALU_FINISH;                             \
     if (LIKELY((opcode & 0x0000F000) != 0x0000F000)) {           \
-        clockTicks = 1 + ISREGSHIFT                              \
-            + codeTicksAccessSeq32(armNextPC);                   \
+        gbaCore.clockTicks = 1 + ISREGSHIFT                              \
+            + codeTicksAccessSeq32(gbaCore.armNextPC);                   \
     } else {                                                     \
         MODECHANGE;                                              \
-        if (armState) {                                          \
-            reg[15].I &= 0xFFFFFFFC;                             \
-            armNextPC = reg[15].I;                               \
-            reg[15].I += 4;                                      \
+        if (gbaCore.armState) {                                          \
+            gbaCore.reg[15].I &= 0xFFFFFFFC;                             \
+            gbaCore.armNextPC = gbaCore.reg[15].I;                               \
+            gbaCore.reg[15].I += 4;                                      \
             ARM_PREFETCH;                                        \
         } else {                                                 \
-            reg[15].I &= 0xFFFFFFFE;                             \
-            armNextPC = reg[15].I;                               \
-            reg[15].I += 2;                                      \
+            gbaCore.reg[15].I &= 0xFFFFFFFE;                             \
+            gbaCore.armNextPC = gbaCore.reg[15].I;                               \
+            gbaCore.reg[15].I += 2;                                      \
             THUMB_PREFETCH;                                      \
         }                                                        \
-        clockTicks = 3 + ISREGSHIFT                              \
-            + codeTicksAccess32(armNextPC)                       \
-            + codeTicksAccessSeq32(armNextPC)                    \
-            + codeTicksAccessSeq32(armNextPC);                   \
+        gbaCore.clockTicks = 3 + ISREGSHIFT                              \
+            + codeTicksAccess32(gbaCore.armNextPC)                       \
+            + codeTicksAccessSeq32(gbaCore.armNextPC)                    \
+            + codeTicksAccessSeq32(gbaCore.armNextPC);                   \
     }
 
 #define MODECHANGE_NO /*nothing*/
-#define MODECHANGE_YES CPUSwitchMode(reg[17].I & 0x1f, false);
+#define MODECHANGE_YES CPUSwitchMode(gbaCore.reg[17].I & 0x1f, false);
 
 #define DEFINE_ALU_INSN_C(CODE1, CODE2, OP, MODECHANGE)                                                                                     \
     static INSN_REGPARM void arm##CODE1##0(uint32_t opcode) { ALU_INSN(ALU_INIT_C, VALUE_LSL_IMM_C, OP_##OP, MODECHANGE_##MODECHANGE, 0); } \
@@ -1219,7 +1217,7 @@ DEFINE_ALU_INSN_C(1F, 3F, MVNS, YES)
 // CYCLES: base cycle count (1, 2, or 3)
 #define MUL_INSN(OP, SETCOND, CYCLES)                                  \
     int mult = (opcode & 0x0F);                                        \
-    uint32_t rs = reg[(opcode >> 8) & 0x0F].I;                         \
+    uint32_t rs = gbaCore.reg[(opcode >> 8) & 0x0F].I;                         \
     int acc = (opcode >> 12) & 0x0F; /* or destLo */                   \
     maybe_unused(acc);                                                 \
     int dest = (opcode >> 16) & 0x0F; /* or destHi */                  \
@@ -1228,43 +1226,43 @@ DEFINE_ALU_INSN_C(1F, 3F, MVNS, YES)
     if ((int32_t)rs < 0)                                               \
         rs = ~rs;                                                      \
     if ((rs & 0xFFFFFF00) == 0)                                        \
-        clockTicks += 0;                                               \
+        gbaCore.clockTicks += 0;                                               \
     else if ((rs & 0xFFFF0000) == 0)                                   \
-        clockTicks += 1;                                               \
+        gbaCore.clockTicks += 1;                                               \
     else if ((rs & 0xFF000000) == 0)                                   \
-        clockTicks += 2;                                               \
+        gbaCore.clockTicks += 2;                                               \
     else                                                               \
-        clockTicks += 3;                                               \
-    if (busPrefetchCount == 0)                                         \
-        busPrefetchCount = ((busPrefetchCount + 1) << clockTicks) - 1; \
-    clockTicks += CYCLES + 1 + codeTicksAccess32(armNextPC);
+        gbaCore.clockTicks += 3;                                               \
+    if (gbaCore.busPrefetchCount == 0)                                         \
+        gbaCore.busPrefetchCount = ((gbaCore.busPrefetchCount + 1) << gbaCore.clockTicks) - 1; \
+    gbaCore.clockTicks += CYCLES + 1 + codeTicksAccess32(gbaCore.armNextPC);
 
 #define OP_MUL \
-    reg[dest].I = reg[mult].I * rs;
+    gbaCore.reg[dest].I = gbaCore.reg[mult].I * rs;
 #define OP_MLA \
-    reg[dest].I = reg[mult].I * rs + reg[acc].I;
+    gbaCore.reg[dest].I = gbaCore.reg[mult].I * rs + gbaCore.reg[acc].I;
 #define OP_UMULL                                              \
-    uint64_t res = (uint64_t)(uint32_t)reg[mult].I            \
+    uint64_t res = (uint64_t)(uint32_t)gbaCore.reg[mult].I            \
         * (uint64_t)(uint32_t)rs;                             \
-    reg[acc].I = (uint32_t)res;                               \
-    reg[dest].I = (uint32_t)(res >> 32);
+    gbaCore.reg[acc].I = (uint32_t)res;                               \
+    gbaCore.reg[dest].I = (uint32_t)(res >> 32);
 #define OP_SMULL                                              \
-    int64_t res = (int64_t)(int32_t)reg[mult].I               \
+    int64_t res = (int64_t)(int32_t)gbaCore.reg[mult].I               \
         * (int64_t)(int32_t)rs;                               \
-    reg[acc].I = (uint32_t)res;                               \
-    reg[dest].I = (uint32_t)(res >> 32);
+    gbaCore.reg[acc].I = (uint32_t)res;                               \
+    gbaCore.reg[dest].I = (uint32_t)(res >> 32);
 #define OP_UMLAL                                              \
-    uint64_t res = ((uint64_t)reg[dest].I << 32 | reg[acc].I) \
-        + ((uint64_t)(uint32_t)reg[mult].I                    \
+    uint64_t res = ((uint64_t)gbaCore.reg[dest].I << 32 | gbaCore.reg[acc].I) \
+        + ((uint64_t)(uint32_t)gbaCore.reg[mult].I                    \
         * (uint64_t)(uint32_t)rs);                            \
-    reg[acc].I = (uint32_t)res;                               \
-    reg[dest].I = (uint32_t)(res >> 32);
+    gbaCore.reg[acc].I = (uint32_t)res;                               \
+    gbaCore.reg[dest].I = (uint32_t)(res >> 32);
 #define OP_SMLAL                                              \
-    int64_t res = ((int64_t)reg[dest].I << 32 | reg[acc].I)   \
-        + ((int64_t)(int32_t)reg[mult].I                      \
+    int64_t res = ((int64_t)gbaCore.reg[dest].I << 32 | gbaCore.reg[acc].I)   \
+        + ((int64_t)(int32_t)gbaCore.reg[mult].I                      \
         * (int64_t)(int32_t)rs);                              \
-    reg[acc].I = (uint32_t)res;                               \
-    reg[dest].I = (uint32_t)(res >> 32);
+    gbaCore.reg[acc].I = (uint32_t)res;                               \
+    gbaCore.reg[dest].I = (uint32_t)(res >> 32);
 
 // MUL Rd, Rm, Rs
 static INSN_REGPARM void arm009(uint32_t opcode) { MUL_INSN(OP_MUL, SETCOND_NONE, 1); }
@@ -1301,23 +1299,23 @@ static INSN_REGPARM void arm0F9(uint32_t opcode) { MUL_INSN(OP_SMLAL, SETCOND_MU
 // SWP Rd, Rm, [Rn]
 static INSN_REGPARM void arm109(uint32_t opcode)
 {
-    uint32_t address = reg[(opcode >> 16) & 15].I;
+    uint32_t address = gbaCore.reg[(opcode >> 16) & 15].I;
     uint32_t temp = CPUReadMemory(address);
-    CPUWriteMemory(address, reg[opcode & 15].I);
-    reg[(opcode >> 12) & 15].I = temp;
-    clockTicks = 4 + dataTicksAccess32(address) + dataTicksAccess32(address)
-        + codeTicksAccess32(armNextPC);
+    CPUWriteMemory(address, gbaCore.reg[opcode & 15].I);
+    gbaCore.reg[(opcode >> 12) & 15].I = temp;
+    gbaCore.clockTicks = 4 + dataTicksAccess32(address) + dataTicksAccess32(address)
+        + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // SWPB Rd, Rm, [Rn]
 static INSN_REGPARM void arm149(uint32_t opcode)
 {
-    uint32_t address = reg[(opcode >> 16) & 15].I;
+    uint32_t address = gbaCore.reg[(opcode >> 16) & 15].I;
     uint32_t temp = CPUReadByte(address);
-    CPUWriteByte(address, reg[opcode & 15].B.B0);
-    reg[(opcode >> 12) & 15].I = temp;
-    clockTicks = 4 + dataTicksAccess32(address) + dataTicksAccess32(address)
-        + codeTicksAccess32(armNextPC);
+    CPUWriteByte(address, gbaCore.reg[opcode & 15].B.B0);
+    gbaCore.reg[(opcode >> 12) & 15].I = temp;
+    gbaCore.clockTicks = 4 + dataTicksAccess32(address) + dataTicksAccess32(address)
+        + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // MRS Rd, CPSR
@@ -1325,7 +1323,7 @@ static INSN_REGPARM void arm100(uint32_t opcode)
 {
     if (LIKELY((opcode & 0x0FFF0FFF) == 0x010F0000)) {
         CPUUpdateCPSR();
-        reg[(opcode >> 12) & 0x0F].I = reg[16].I;
+        gbaCore.reg[(opcode >> 12) & 0x0F].I = gbaCore.reg[16].I;
     } else {
         armUnknownInsn(opcode);
     }
@@ -1335,7 +1333,7 @@ static INSN_REGPARM void arm100(uint32_t opcode)
 static INSN_REGPARM void arm140(uint32_t opcode)
 {
     if (LIKELY((opcode & 0x0FFF0FFF) == 0x014F0000)) {
-        reg[(opcode >> 12) & 0x0F].I = reg[17].I;
+        gbaCore.reg[(opcode >> 12) & 0x0F].I = gbaCore.reg[17].I;
     } else {
         armUnknownInsn(opcode);
     }
@@ -1346,9 +1344,9 @@ static INSN_REGPARM void arm120(uint32_t opcode)
 {
     if (LIKELY((opcode & 0x0FF0FFF0) == 0x0120F000)) {
         CPUUpdateCPSR();
-        uint32_t value = reg[opcode & 15].I;
-        uint32_t newValue = reg[16].I;
-        if (armMode > 0x10) {
+        uint32_t value = gbaCore.reg[opcode & 15].I;
+        uint32_t newValue = gbaCore.reg[16].I;
+        if (gbaCore.armMode > 0x10) {
             if (opcode & 0x00010000)
                 newValue = (newValue & 0xFFFFFF00) | (value & 0x000000FF);
             if (opcode & 0x00020000)
@@ -1360,11 +1358,11 @@ static INSN_REGPARM void arm120(uint32_t opcode)
             newValue = (newValue & 0x00FFFFFF) | (value & 0xFF000000);
         newValue |= 0x10;
         CPUSwitchMode(newValue & 0x1F, false);
-        reg[16].I = newValue;
+        gbaCore.reg[16].I = newValue;
         CPUUpdateFlags();
-        if (!armState) { // this should not be allowed, but it seems to work
+        if (!gbaCore.armState) { // this should not be allowed, but it seems to work
             THUMB_PREFETCH;
-            reg[15].I = armNextPC + 2;
+            gbaCore.reg[15].I = gbaCore.armNextPC + 2;
         }
     } else {
         armUnknownInsn(opcode);
@@ -1375,16 +1373,16 @@ static INSN_REGPARM void arm120(uint32_t opcode)
 static INSN_REGPARM void arm160(uint32_t opcode)
 {
     if (LIKELY((opcode & 0x0FF0FFF0) == 0x0160F000)) {
-        uint32_t value = reg[opcode & 15].I;
-        if (armMode > 0x10 && armMode < 0x1F) {
+        uint32_t value = gbaCore.reg[opcode & 15].I;
+        if (gbaCore.armMode > 0x10 && gbaCore.armMode < 0x1F) {
             if (opcode & 0x00010000)
-                reg[17].I = (reg[17].I & 0xFFFFFF00) | (value & 0x000000FF);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0xFFFFFF00) | (value & 0x000000FF);
             if (opcode & 0x00020000)
-                reg[17].I = (reg[17].I & 0xFFFF00FF) | (value & 0x0000FF00);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0xFFFF00FF) | (value & 0x0000FF00);
             if (opcode & 0x00040000)
-                reg[17].I = (reg[17].I & 0xFF00FFFF) | (value & 0x00FF0000);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0xFF00FFFF) | (value & 0x00FF0000);
             if (opcode & 0x00080000)
-                reg[17].I = (reg[17].I & 0x00FFFFFF) | (value & 0xFF000000);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0x00FFFFFF) | (value & 0xFF000000);
         }
     } else {
         armUnknownInsn(opcode);
@@ -1401,8 +1399,8 @@ static INSN_REGPARM void arm320(uint32_t opcode)
         if (shift) {
             ROR_IMM_MSR;
         }
-        uint32_t newValue = reg[16].I;
-        if (armMode > 0x10) {
+        uint32_t newValue = gbaCore.reg[16].I;
+        if (gbaCore.armMode > 0x10) {
             if (opcode & 0x00010000)
                 newValue = (newValue & 0xFFFFFF00) | (value & 0x000000FF);
             if (opcode & 0x00020000)
@@ -1416,11 +1414,11 @@ static INSN_REGPARM void arm320(uint32_t opcode)
         newValue |= 0x10;
 
         CPUSwitchMode(newValue & 0x1F, false);
-        reg[16].I = newValue;
+        gbaCore.reg[16].I = newValue;
         CPUUpdateFlags();
-        if (!armState) { // this should not be allowed, but it seems to work
+        if (!gbaCore.armState) { // this should not be allowed, but it seems to work
             THUMB_PREFETCH;
-            reg[15].I = armNextPC + 2;
+            gbaCore.reg[15].I = gbaCore.armNextPC + 2;
         }
     } else {
         armUnknownInsn(opcode);
@@ -1431,20 +1429,20 @@ static INSN_REGPARM void arm320(uint32_t opcode)
 static INSN_REGPARM void arm360(uint32_t opcode)
 {
     if (LIKELY((opcode & 0x0FF0F000) == 0x0360F000)) {
-        if (armMode > 0x10 && armMode < 0x1F) {
+        if (gbaCore.armMode > 0x10 && gbaCore.armMode < 0x1F) {
             uint32_t value = opcode & 0xFF;
             int shift = (opcode & 0xF00) >> 7;
             if (shift) {
                 ROR_IMM_MSR;
             }
             if (opcode & 0x00010000)
-                reg[17].I = (reg[17].I & 0xFFFFFF00) | (value & 0x000000FF);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0xFFFFFF00) | (value & 0x000000FF);
             if (opcode & 0x00020000)
-                reg[17].I = (reg[17].I & 0xFFFF00FF) | (value & 0x0000FF00);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0xFFFF00FF) | (value & 0x0000FF00);
             if (opcode & 0x00040000)
-                reg[17].I = (reg[17].I & 0xFF00FFFF) | (value & 0x00FF0000);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0xFF00FFFF) | (value & 0x00FF0000);
             if (opcode & 0x00080000)
-                reg[17].I = (reg[17].I & 0x00FFFFFF) | (value & 0xFF000000);
+                gbaCore.reg[17].I = (gbaCore.reg[17].I & 0x00FFFFFF) | (value & 0xFF000000);
         }
     } else {
         armUnknownInsn(opcode);
@@ -1456,24 +1454,24 @@ static INSN_REGPARM void arm121(uint32_t opcode)
 {
     if (LIKELY((opcode & 0x0FFFFFF0) == 0x012FFF10)) {
         int base = opcode & 0x0F;
-        busPrefetchCount = 0;
-        armState = reg[base].I & 1 ? false : true;
-        if (armState) {
-            reg[15].I = reg[base].I & 0xFFFFFFFC;
-            armNextPC = reg[15].I;
-            reg[15].I += 4;
+        gbaCore.busPrefetchCount = 0;
+        gbaCore.armState = gbaCore.reg[base].I & 1 ? false : true;
+        if (gbaCore.armState) {
+            gbaCore.reg[15].I = gbaCore.reg[base].I & 0xFFFFFFFC;
+            gbaCore.armNextPC = gbaCore.reg[15].I;
+            gbaCore.reg[15].I += 4;
             ARM_PREFETCH;
-            clockTicks = 3 + codeTicksAccessSeq32(armNextPC)
-                + codeTicksAccessSeq32(armNextPC)
-                + codeTicksAccess32(armNextPC);
+            gbaCore.clockTicks = 3 + codeTicksAccessSeq32(gbaCore.armNextPC)
+                + codeTicksAccessSeq32(gbaCore.armNextPC)
+                + codeTicksAccess32(gbaCore.armNextPC);
         } else {
-            reg[15].I = reg[base].I & 0xFFFFFFFE;
-            armNextPC = reg[15].I;
-            reg[15].I += 2;
+            gbaCore.reg[15].I = gbaCore.reg[base].I & 0xFFFFFFFE;
+            gbaCore.armNextPC = gbaCore.reg[15].I;
+            gbaCore.reg[15].I += 2;
             THUMB_PREFETCH;
-            clockTicks = 3 + codeTicksAccessSeq16(armNextPC)
-                + codeTicksAccessSeq16(armNextPC)
-                + codeTicksAccess16(armNextPC);
+            gbaCore.clockTicks = 3 + codeTicksAccessSeq16(gbaCore.armNextPC)
+                + codeTicksAccessSeq16(gbaCore.armNextPC)
+                + codeTicksAccess16(gbaCore.armNextPC);
         }
     } else {
         armUnknownInsn(opcode);
@@ -1487,51 +1485,51 @@ static INSN_REGPARM void arm121(uint32_t opcode)
 #define OFFSET_IMM8 \
     int offset = ((opcode & 0x0F) | ((opcode >> 4) & 0xF0));
 #define OFFSET_REG \
-    int offset = reg[opcode & 15].I;
+    int offset = gbaCore.reg[opcode & 15].I;
 #define OFFSET_LSL \
-    int offset = reg[opcode & 15].I << ((opcode >> 7) & 31);
+    int offset = gbaCore.reg[opcode & 15].I << ((opcode >> 7) & 31);
 #define OFFSET_LSR                  \
     int shift = (opcode >> 7) & 31; \
-    int offset = shift ? reg[opcode & 15].I >> shift : 0;
+    int offset = shift ? gbaCore.reg[opcode & 15].I >> shift : 0;
 #define OFFSET_ASR                                            \
     int shift = (opcode >> 7) & 31;                           \
     int offset;                                               \
     if (shift)                                                \
-        offset = (int)((int32_t)reg[opcode & 15].I >> shift); \
-    else if (reg[opcode & 15].I & 0x80000000)                 \
+        offset = (int)((int32_t)gbaCore.reg[opcode & 15].I >> shift); \
+    else if (gbaCore.reg[opcode & 15].I & 0x80000000)                 \
         offset = 0xFFFFFFFF;                                  \
     else                                                      \
         offset = 0;
 #define OFFSET_ROR                        \
     int shift = (opcode >> 7) & 31;       \
-    uint32_t offset = reg[opcode & 15].I; \
+    uint32_t offset = gbaCore.reg[opcode & 15].I; \
     if (shift) {                          \
         ROR_OFFSET;                       \
     } else {                              \
         RRX_OFFSET;                       \
     }
 
-#define ADDRESS_POST (reg[base].I)
-#define ADDRESS_PREDEC (reg[base].I - offset)
-#define ADDRESS_PREINC (reg[base].I + offset)
+#define ADDRESS_POST (gbaCore.reg[base].I)
+#define ADDRESS_PREDEC (gbaCore.reg[base].I - offset)
+#define ADDRESS_PREINC (gbaCore.reg[base].I + offset)
 
-#define OP_STR CPUWriteMemory(address, reg[dest].I + (dest == 15 ? 4 : 0))
-#define OP_STRH CPUWriteHalfWord(address, reg[dest].W.W0)
-#define OP_STRB CPUWriteByte(address, reg[dest].B.B0)
-#define OP_LDR reg[dest].I = CPUReadMemory(address)
-#define OP_LDRH reg[dest].I = CPUReadHalfWord(address)
-#define OP_LDRB reg[dest].I = CPUReadByte(address)
-#define OP_LDRSH reg[dest].I = (uint32_t)CPUReadHalfWordSigned(address)
-#define OP_LDRSB reg[dest].I = (int8_t)CPUReadByte(address)
+#define OP_STR CPUWriteMemory(address, gbaCore.reg[dest].I + (dest == 15 ? 4 : 0))
+#define OP_STRH CPUWriteHalfWord(address, gbaCore.reg[dest].W.W0)
+#define OP_STRB CPUWriteByte(address, gbaCore.reg[dest].B.B0)
+#define OP_LDR gbaCore.reg[dest].I = CPUReadMemory(address)
+#define OP_LDRH gbaCore.reg[dest].I = CPUReadHalfWord(address)
+#define OP_LDRB gbaCore.reg[dest].I = CPUReadByte(address)
+#define OP_LDRSH gbaCore.reg[dest].I = (uint32_t)CPUReadHalfWordSigned(address)
+#define OP_LDRSB gbaCore.reg[dest].I = (int8_t)CPUReadByte(address)
 
 #define WRITEBACK_NONE /*nothing*/
-#define WRITEBACK_PRE reg[base].I = address
-#define WRITEBACK_POSTDEC reg[base].I = address - offset
-#define WRITEBACK_POSTINC reg[base].I = address + offset
+#define WRITEBACK_PRE gbaCore.reg[base].I = address
+#define WRITEBACK_POSTDEC gbaCore.reg[base].I = address - offset
+#define WRITEBACK_POSTINC gbaCore.reg[base].I = address + offset
 
 #define LDRSTR_INIT(CALC_OFFSET, CALC_ADDRESS) \
-    if (busPrefetchCount == 0)                 \
-        busPrefetch = busPrefetchEnable;       \
+    if (gbaCore.busPrefetchCount == 0)                 \
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;       \
     int dest = (opcode >> 12) & 15;            \
     int base = (opcode >> 16) & 15;            \
     CALC_OFFSET;                               \
@@ -1542,25 +1540,25 @@ static INSN_REGPARM void arm121(uint32_t opcode)
     WRITEBACK1;                                                                  \
     STORE_DATA;                                                                  \
     WRITEBACK2;                                                                  \
-    clockTicks = 2 + dataTicksAccess##SIZE(address)                              \
-        + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks = 2 + dataTicksAccess##SIZE(address)                              \
+        + codeTicksAccess32(gbaCore.armNextPC);
 #define LDR(CALC_OFFSET, CALC_ADDRESS, LOAD_DATA, WRITEBACK, SIZE) \
     LDRSTR_INIT(CALC_OFFSET, CALC_ADDRESS);                        \
     LOAD_DATA;                                                     \
     if (dest != base) {                                            \
         WRITEBACK;                                                 \
     }                                                              \
-    clockTicks = 0;                                                \
+    gbaCore.clockTicks = 0;                                                \
     if (dest == 15) {                                              \
-        reg[15].I &= 0xFFFFFFFC;                                   \
-        armNextPC = reg[15].I;                                     \
-        reg[15].I += 4;                                            \
+        gbaCore.reg[15].I &= 0xFFFFFFFC;                                   \
+        gbaCore.armNextPC = gbaCore.reg[15].I;                                     \
+        gbaCore.reg[15].I += 4;                                            \
         ARM_PREFETCH;                                              \
-        clockTicks += 2 + dataTicksAccessSeq32(address)            \
+        gbaCore.clockTicks += 2 + dataTicksAccessSeq32(address)            \
             + dataTicksAccessSeq32(address);                       \
     }                                                              \
-    clockTicks += 3 + dataTicksAccess##SIZE(address)               \
-        + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 3 + dataTicksAccess##SIZE(address)               \
+        + codeTicksAccess32(gbaCore.armNextPC);
 #define STR_POSTDEC(CALC_OFFSET, STORE_DATA, SIZE) \
     STR(CALC_OFFSET, ADDRESS_POST, STORE_DATA, WRITEBACK_NONE, WRITEBACK_POSTDEC, SIZE)
 #define STR_POSTINC(CALC_OFFSET, STORE_DATA, SIZE) \
@@ -1933,34 +1931,34 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
 
 #define STM_REG(bit, num)                                    \
     if (opcode & (1U << (bit))) {                            \
-        CPUWriteMemory(address, reg[(num)].I);               \
+        CPUWriteMemory(address, gbaCore.reg[(num)].I);               \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
         address += 4;                                        \
     }
 #define STMW_REG(bit, num)                                   \
     if (opcode & (1U << (bit))) {                            \
-        CPUWriteMemory(address, reg[(num)].I);               \
+        CPUWriteMemory(address, gbaCore.reg[(num)].I);               \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
-        reg[base].I = temp;                                  \
+        gbaCore.reg[base].I = temp;                                  \
         count++;                                             \
         address += 4;                                        \
     }
 #define LDM_REG(bit, num)                                    \
     if (opcode & (1U << (bit))) {                            \
-        reg[(num)].I = CPUReadMemory(address);               \
+        gbaCore.reg[(num)].I = CPUReadMemory(address);               \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
         address += 4;                                        \
@@ -1983,7 +1981,7 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
     STORE_REG(13, 13);      \
     STORE_REG(14, 14);
 #define STM_HIGH_2(STORE_REG)                 \
-    if (armMode == 0x11) {                    \
+    if (gbaCore.armMode == 0x11) {                    \
         STORE_REG(8, R8_FIQ);                 \
         STORE_REG(9, R9_FIQ);                 \
         STORE_REG(10, R10_FIQ);               \
@@ -1996,7 +1994,7 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
         STORE_REG(11, 11);                    \
         STORE_REG(12, 12);                    \
     }                                         \
-    if (armMode != 0x10 && armMode != 0x1F) { \
+    if (gbaCore.armMode != 0x10 && gbaCore.armMode != 0x1F) { \
         STORE_REG(13, R13_USR);               \
         STORE_REG(14, R14_USR);               \
     } else {                                  \
@@ -2005,23 +2003,23 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
     }
 #define STM_PC                                               \
     if (opcode & (1U << 15)) {                               \
-        CPUWriteMemory(address, reg[15].I + 4);              \
+        CPUWriteMemory(address, gbaCore.reg[15].I + 4);              \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
     }
 #define STMW_PC                                              \
     if (opcode & (1U << 15)) {                               \
-        CPUWriteMemory(address, reg[15].I + 4);              \
+        CPUWriteMemory(address, gbaCore.reg[15].I + 4);              \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
-        reg[base].I = temp;                                  \
+        gbaCore.reg[base].I = temp;                                  \
         count++;                                             \
     }
 #define LDM_LOW    \
@@ -2042,7 +2040,7 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
     LDM_REG(13, 13); \
     LDM_REG(14, 14);
 #define LDM_HIGH_2                            \
-    if (armMode == 0x11) {                    \
+    if (gbaCore.armMode == 0x11) {                    \
         LDM_REG(8, R8_FIQ);                   \
         LDM_REG(9, R9_FIQ);                   \
         LDM_REG(10, R10_FIQ);                 \
@@ -2055,7 +2053,7 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
         LDM_REG(11, 11);                      \
         LDM_REG(12, 12);                      \
     }                                         \
-    if (armMode != 0x10 && armMode != 0x1F) { \
+    if (gbaCore.armMode != 0x10 && gbaCore.armMode != 0x1F) { \
         LDM_REG(13, R13_USR);                 \
         LDM_REG(14, R14_USR);                 \
     } else {                                  \
@@ -2074,19 +2072,19 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
     LDM_LOW;                                                 \
     LDM_HIGH;                                                \
     if (opcode & (1U << 15)) {                               \
-        reg[15].I = CPUReadMemory(address);                  \
+        gbaCore.reg[15].I = CPUReadMemory(address);                  \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
     }                                                        \
     if (opcode & (1U << 15)) {                               \
-        armNextPC = reg[15].I;                               \
-        reg[15].I += 4;                                      \
+        gbaCore.armNextPC = gbaCore.reg[15].I;                               \
+        gbaCore.reg[15].I += 4;                                      \
         ARM_PREFETCH;                                        \
-        clockTicks += 1 + codeTicksAccessSeq32(armNextPC);   \
+        gbaCore.clockTicks += 1 + codeTicksAccessSeq32(gbaCore.armNextPC);   \
     }
 #define STM_ALL_2        \
     STM_LOW(STM_REG);    \
@@ -2100,11 +2098,11 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
     LDM_LOW;                                                 \
     if (opcode & (1U << 15)) {                               \
         LDM_HIGH;                                            \
-        reg[15].I = CPUReadMemory(address);                  \
+        gbaCore.reg[15].I = CPUReadMemory(address);                  \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
     } else {                                                 \
@@ -2112,449 +2110,449 @@ static INSN_REGPARM void arm7F6(uint32_t opcode) { LDR_PREINC_WB(OFFSET_ROR, OP_
     }
 #define LDM_ALL_2B                                         \
     if (opcode & (1U << 15)) {                             \
-        CPUSwitchMode(reg[17].I & 0x1F, false);            \
-        if (armState) {                                    \
-            armNextPC = reg[15].I & 0xFFFFFFFC;            \
-            reg[15].I = armNextPC + 4;                     \
+        CPUSwitchMode(gbaCore.reg[17].I & 0x1F, false);            \
+        if (gbaCore.armState) {                                    \
+            gbaCore.armNextPC = gbaCore.reg[15].I & 0xFFFFFFFC;            \
+            gbaCore.reg[15].I = gbaCore.armNextPC + 4;                     \
             ARM_PREFETCH;                                  \
         } else {                                           \
-            armNextPC = reg[15].I & 0xFFFFFFFE;            \
-            reg[15].I = armNextPC + 2;                     \
+            gbaCore.armNextPC = gbaCore.reg[15].I & 0xFFFFFFFE;            \
+            gbaCore.reg[15].I = gbaCore.armNextPC + 2;                     \
             THUMB_PREFETCH;                                \
         }                                                  \
-        clockTicks += 1 + codeTicksAccessSeq32(armNextPC); \
+        gbaCore.clockTicks += 1 + codeTicksAccessSeq32(gbaCore.armNextPC); \
     }
 
 // STMDA Rn, {Rlist}
 static INSN_REGPARM void arm800(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     STM_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDA Rn, {Rlist}
 static INSN_REGPARM void arm810(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMDA Rn!, {Rlist}
 static INSN_REGPARM void arm820(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     STMW_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDA Rn!, {Rlist}
 static INSN_REGPARM void arm830(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
 }
 
 // STMDA Rn, {Rlist}^
 static INSN_REGPARM void arm840(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     STM_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDA Rn, {Rlist}^
 static INSN_REGPARM void arm850(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMDA Rn!, {Rlist}^
 static INSN_REGPARM void arm860(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     STMW_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDA Rn!, {Rlist}^
 static INSN_REGPARM void arm870(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = (temp + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMIA Rn, {Rlist}
 static INSN_REGPARM void arm880(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
     STM_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIA Rn, {Rlist}
 static INSN_REGPARM void arm890(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMIA Rn!, {Rlist}
 static INSN_REGPARM void arm8A0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 0xFF] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 0xFF] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     STMW_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIA Rn!, {Rlist}
 static INSN_REGPARM void arm8B0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
 }
 
 // STMIA Rn, {Rlist}^
 static INSN_REGPARM void arm8C0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
     STM_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIA Rn, {Rlist}^
 static INSN_REGPARM void arm8D0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMIA Rn!, {Rlist}^
 static INSN_REGPARM void arm8E0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 0xFF] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 0xFF] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     STMW_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIA Rn!, {Rlist}^
 static INSN_REGPARM void arm8F0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
-    uint32_t address = reg[base].I & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t address = gbaCore.reg[base].I & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMDB Rn, {Rlist}
 static INSN_REGPARM void arm900(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     STM_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDB Rn, {Rlist}
 static INSN_REGPARM void arm910(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMDB Rn!, {Rlist}
 static INSN_REGPARM void arm920(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     STMW_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDB Rn!, {Rlist}
 static INSN_REGPARM void arm930(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
 }
 
 // STMDB Rn, {Rlist}^
 static INSN_REGPARM void arm940(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     STM_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDB Rn, {Rlist}^
 static INSN_REGPARM void arm950(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMDB Rn!, {Rlist}^
 static INSN_REGPARM void arm960(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     STMW_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMDB Rn!, {Rlist}^
 static INSN_REGPARM void arm970(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I - 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I - 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     uint32_t address = temp & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMIB Rn, {Rlist}
 static INSN_REGPARM void arm980(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
     STM_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIB Rn, {Rlist}
 static INSN_REGPARM void arm990(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMIB Rn!, {Rlist}
 static INSN_REGPARM void arm9A0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 0xFF] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 0xFF] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     STMW_ALL;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIB Rn!, {Rlist}
 static INSN_REGPARM void arm9B0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
 }
 
 // STMIB Rn, {Rlist}^
 static INSN_REGPARM void arm9C0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
     STM_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIB Rn, {Rlist}^
 static INSN_REGPARM void arm9D0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // STMIB Rn!, {Rlist}^
 static INSN_REGPARM void arm9E0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 0xFF] + cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 0xFF] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
     STMW_ALL_2;
-    clockTicks += 1 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // LDMIB Rn!, {Rlist}^
 static INSN_REGPARM void arm9F0(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int base = (opcode & 0x000F0000) >> 16;
-    uint32_t temp = reg[base].I + 4 * (cpuBitsSet[opcode & 255] + cpuBitsSet[(opcode >> 8) & 255]);
-    uint32_t address = (reg[base].I + 4) & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[base].I + 4 * (gbaCore.cpuBitsSet[opcode & 255] + gbaCore.cpuBitsSet[(opcode >> 8) & 255]);
+    uint32_t address = (gbaCore.reg[base].I + 4) & 0xFFFFFFFC;
     int count = 0;
     LDM_ALL_2;
     if (!(opcode & (1U << base)))
-        reg[base].I = temp;
+        gbaCore.reg[base].I = temp;
     LDM_ALL_2B;
-    clockTicks += 2 + codeTicksAccess32(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess32(gbaCore.armNextPC);
 }
 
 // B/BL/SWI and (unimplemented) coproc support ////////////////////////////
@@ -2563,25 +2561,27 @@ static INSN_REGPARM void arm9F0(uint32_t opcode)
 static INSN_REGPARM void armA00(uint32_t opcode)
 {
     int32_t offset = ((int32_t)(opcode & 0x00FFFFFF) << 8) >> 6;
-    reg[15].I += offset;
-    armNextPC = reg[15].I;
-    reg[15].I += 4;
+    gbaCore.reg[15].I += offset;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 4;
     ARM_PREFETCH;
-    clockTicks = (codeTicksAccessSeq32(armNextPC) * 2) + codeTicksAccess32(armNextPC) + 3;
-    busPrefetchCount = 0;
+    gbaCore.clockTicks = (codeTicksAccessSeq32(gbaCore.armNextPC) * 2) + codeTicksAccess32(gbaCore.armNextPC) + 3;
+    gbaCore.busPrefetchCount = 0;
+    if (offset < 0)
+        cpuIdleLoopTaken(gbaCore.armNextPC - offset - 8, gbaCore.armNextPC);
 }
 
 // BL <offset>
 static INSN_REGPARM void armB00(uint32_t opcode)
 {
     int32_t offset = ((int32_t)(opcode & 0x00FFFFFF) << 8) >> 6;
-    reg[14].I = reg[15].I - 4;
-    reg[15].I += offset;
-    armNextPC = reg[15].I;
-    reg[15].I += 4;
+    gbaCore.reg[14].I = gbaCore.reg[15].I - 4;
+    gbaCore.reg[15].I += offset;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 4;
     ARM_PREFETCH;
-    clockTicks = (codeTicksAccessSeq32(armNextPC) * 2) + codeTicksAccess32(armNextPC) + 3;
-    busPrefetchCount = 0;
+    gbaCore.clockTicks = (codeTicksAccessSeq32(gbaCore.armNextPC) * 2) + codeTicksAccess32(gbaCore.armNextPC) + 3;
+    gbaCore.busPrefetchCount = 0;
 }
 
 #ifdef GP_SUPPORT
@@ -2596,8 +2596,8 @@ static INSN_REGPARM void armE01(uint32_t opcode)
 // SWI <comment>
 static INSN_REGPARM void armF00(uint32_t opcode)
 {
-    clockTicks = (codeTicksAccessSeq32(armNextPC) * 2) + codeTicksAccess32(armNextPC) + 3;
-    busPrefetchCount = 0;
+    gbaCore.clockTicks = (codeTicksAccessSeq32(gbaCore.armNextPC) * 2) + codeTicksAccess32(gbaCore.armNextPC) + 3;
+    gbaCore.busPrefetchCount = 0;
     CPUSoftwareInterrupt(opcode & 0x00FFFFFF);
 }
 
@@ -2619,7 +2619,7 @@ typedef INSN_REGPARM void (*insnfunc_t)(uint32_t opcode);
 #else
 #define arm_BP armUnknownInsn
 #endif
-static insnfunc_t armInsnTable[4096] = {
+static constexpr insnfunc_t armInsnTable[4096] = {
     arm000, arm001, arm002, arm003, arm004, arm005, arm006, arm007, // 000
     arm000, arm009, arm002, arm00B, arm004, arm_UI, arm006, arm_UI, // 008
     arm010, arm011, arm012, arm013, arm014, arm015, arm016, arm017, // 010
@@ -2799,6 +2799,39 @@ static insnfunc_t armInsnTable[4096] = {
 
 // Wrapper routine (execution loop) ///////////////////////////////////////
 
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+static inline insnfunc_t armDecode(uint32_t opcode)
+{
+    return armInsnTable[((opcode >> 16) & 0xFF0) | ((opcode >> 4) & 0x0F)];
+}
+
+// Prefetches the opcode at `address`, decoding it into the cache on a miss.
+static inline uint32_t armDecodeCacheFetch(uint32_t address)
+{
+    DecodedInsn& insn = armDecodeCacheEntry(address);
+    if (insn.address == address)
+        return insn.opcode;
+
+    uint32_t opcode = CPUReadMemoryQuick(address);
+    if (cpuDecodeCacheable(address)) {
+        insn.address = address;
+        insn.opcode = opcode;
+        insn.handler = armDecode(opcode);
+    }
+    return opcode;
+}
+
+// The pipeline may also be refilled by ARM_PREFETCH, bypassing the cache,
+// so the cached handler is only used if the opcode matches.
+static inline insnfunc_t armDecodeCacheHandler(uint32_t address, uint32_t opcode)
+{
+    const DecodedInsn& insn = armDecodeCacheEntry(address);
+    if (insn.address == address && insn.opcode == opcode)
+        return insn.handler;
+    return armDecode(opcode);
+}
+#endif  // defined(VBAM_ENABLE_DECODE_CACHE)
+
 #if 0
 #include <time.h>
 static void tester(void) {
@@ -2806,161 +2839,274 @@ static void tester(void) {
   FILE*f=fopen("p:\\timing.txt","w");if(!f)return;
   for (int op=/*0*/9; op</*0xF00*/10;op++){if(armInsnTable[op]==arm_UI)continue;
     int i;for(i=0;i<op;i++)if(armInsnTable[op]==armInsnTable[i])break;if(i<op)continue;
-    for(i=0;i<16;i++)reg[i].I=0x3100000;
+    for(i=0;i<16;i++)gbaCore.reg[i].I=0x3100000;
     clock_t s=clock();for(i=0;i<10000000;i++)armInsnTable[op](0);clock_t e=clock();
     fprintf(f,"arm%03X %6ld\n",op,e-s);fflush(f);
   }fclose(f);
 }
 #endif
 
-int armExecute()
+// Moves the pipeline to the next instruction and returns its opcode.
+// Returns false if a debugger breakpoint stops the execution first.
+static VBAM_FORCE_INLINE bool armFetch(uint32_t& opcode, uint32_t& oldArmNextPC)
 {
-    do {
-        if (coreOptions.cheatsEnabled) {
-            cpuMasterCodeCheck();
-        }
+    if ((gbaCore.armNextPC & 0x0803FFFF) == 0x08020000)
+        gbaCore.busPrefetchCount = 0x100;
 
-        if ((armNextPC & 0x0803FFFF) == 0x08020000)
-            busPrefetchCount = 0x100;
+    opcode = gbaCore.cpuPrefetch[0];
+    gbaCore.cpuPrefetch[0] = gbaCore.cpuPrefetch[1];
 
-        uint32_t opcode = cpuPrefetch[0];
-        cpuPrefetch[0] = cpuPrefetch[1];
+    gbaCore.busPrefetch = false;
+    if (gbaCore.busPrefetchCount & 0xFFFFFE00)
+        gbaCore.busPrefetchCount = 0x100 | (gbaCore.busPrefetchCount & 0xFF);
 
-        busPrefetch = false;
-        if (busPrefetchCount & 0xFFFFFE00)
-            busPrefetchCount = 0x100 | (busPrefetchCount & 0xFF);
-
-        clockTicks = 0;
-        int oldArmNextPC = armNextPC;
+    gbaCore.clockTicks = 0;
+    oldArmNextPC = gbaCore.armNextPC;
 
 #ifndef FINAL_VERSION
-        if (armNextPC == stop) {
-            armNextPC++;
-        }
+    if (gbaCore.armNextPC == gbaCore.stop) {
+        gbaCore.armNextPC++;
+    }
 #endif
 
-        armNextPC = reg[15].I;
-        reg[15].I += 4;
-        ARM_PREFETCH_NEXT;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 4;
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+    gbaCore.cpuPrefetch[1] = armDecodeCacheFetch(gbaCore.armNextPC + 4);
+#else
+    ARM_PREFETCH_NEXT;
+#endif
 
 #ifdef VBAM_ENABLE_DEBUGGER
-        uint32_t memAddr = armNextPC;
-        memoryMap* m = &map[memAddr >> 24];
-        if (m->breakPoints && BreakARMCheck(m->breakPoints, memAddr & m->mask)) {
-            if (debuggerBreakOnExecution(memAddr, armState)) {
-                // Revert tickcount?
-                debugger = true;
-                return 0;
-            }
+    uint32_t memAddr = gbaCore.armNextPC;
+    memoryMap* m = &gbaCore.map[memAddr >> 24];
+    if (m->breakPoints && BreakARMCheck(m->breakPoints, memAddr & m->mask)) {
+        if (debuggerBreakOnExecution(memAddr, gbaCore.armState)) {
+            // Revert tickcount?
+            gbaCore.debugger = true;
+            return false;
         }
+    }
 #endif
+    return true;
+}
 
-        int cond = opcode >> 28;
-        bool cond_res = true;
-        if (UNLIKELY(cond != 0x0E)) { // most opcodes are AL (always)
-            switch (cond) {
-            case 0x00: // EQ
-                cond_res = Z_FLAG;
-                break;
-            case 0x01: // NE
-                cond_res = !Z_FLAG;
-                break;
-            case 0x02: // CS
-                cond_res = C_FLAG;
-                break;
-            case 0x03: // CC
-                cond_res = !C_FLAG;
-                break;
-            case 0x04: // MI
-                cond_res = N_FLAG;
-                break;
-            case 0x05: // PL
-                cond_res = !N_FLAG;
-                break;
-            case 0x06: // VS
-                cond_res = V_FLAG;
-                break;
-            case 0x07: // VC
-                cond_res = !V_FLAG;
-                break;
-            case 0x08: // HI
-                cond_res = C_FLAG && !Z_FLAG;
-                break;
-            case 0x09: // LS
-                cond_res = !C_FLAG || Z_FLAG;
-                break;
-            case 0x0A: // GE
-                cond_res = N_FLAG == V_FLAG;
-                break;
-            case 0x0B: // LT
-                cond_res = N_FLAG != V_FLAG;
-                break;
-            case 0x0C: // GT
-                cond_res = !Z_FLAG && (N_FLAG == V_FLAG);
-                break;
-            case 0x0D: // LE
-                cond_res = Z_FLAG || (N_FLAG != V_FLAG);
-                break;
-            case 0x0E: // AL (impossible, checked above)
-                cond_res = true;
-                break;
-            case 0x0F:
-            default:
-                // ???
-                cond_res = false;
-                break;
-            }
+// Returns true if the condition field of `opcode` passes.
+static VBAM_FORCE_INLINE bool armCondition(uint32_t opcode)
+{
+    int cond = opcode >> 28;
+    bool cond_res = true;
+    if (UNLIKELY(cond != 0x0E)) { // most opcodes are AL (always)
+        switch (cond) {
+        case 0x00: // EQ
+            cond_res = gbaCore.Z_FLAG;
+            break;
+        case 0x01: // NE
+            cond_res = !gbaCore.Z_FLAG;
+            break;
+        case 0x02: // CS
+            cond_res = gbaCore.C_FLAG;
+            break;
+        case 0x03: // CC
+            cond_res = !gbaCore.C_FLAG;
+            break;
+        case 0x04: // MI
+            cond_res = gbaCore.N_FLAG;
+            break;
+        case 0x05: // PL
+            cond_res = !gbaCore.N_FLAG;
+            break;
+        case 0x06: // VS
+            cond_res = gbaCore.V_FLAG;
+            break;
+        case 0x07: // VC
+            cond_res = !gbaCore.V_FLAG;
+            break;
+        case 0x08: // HI
+            cond_res = gbaCore.C_FLAG && !gbaCore.Z_FLAG;
+            break;
+        case 0x09: // LS
+            cond_res = !gbaCore.C_FLAG || gbaCore.Z_FLAG;
+            break;
+        case 0x0A: // GE
+            cond_res = gbaCore.N_FLAG == gbaCore.V_FLAG;
+            break;
+        case 0x0B: // LT
+            cond_res = gbaCore.N_FLAG != gbaCore.V_FLAG;
+            break;
+        case 0x0C: // GT
+            cond_res = !gbaCore.Z_FLAG && (gbaCore.N_FLAG == gbaCore.V_FLAG);
+            break;
+        case 0x0D: // LE
+            cond_res = gbaCore.Z_FLAG || (gbaCore.N_FLAG != gbaCore.V_FLAG);
+            break;
+        case 0x0E: // AL (impossible, checked above)
+            cond_res = true;
+            break;
+        case 0x0F:
+        default:
+            // ???
+            cond_res = false;
+            break;
         }
+    }
+    return cond_res;
+}
 
-        if (cond_res)
-            (*armInsnTable[((opcode >> 16) & 0xFF0) | ((opcode >> 4) & 0x0F)])(opcode);
+// Handles an instruction whose condition failed.
+static inline void armSkipped(uint32_t opcode)
+{
+    if ((opcode & 0x0F000000) == 0x0A000000)
+        cpuIdleLoopNotTaken(gbaCore.armNextPC - 4);
 #ifdef INSN_COUNTER
-        count(opcode, cond_res);
+    count(opcode, false);
 #endif
+}
 
+// Accounts for the cycles of the instruction that just ran.
+// Returns false if the execution must stop.
+static VBAM_FORCE_INLINE bool armRetire(uint32_t oldArmNextPC)
+{
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (enableRegBreak) {
-            if (lowRegBreakCounter[0])
-                breakReg_check(0);
-            if (lowRegBreakCounter[1])
-                breakReg_check(1);
-            if (lowRegBreakCounter[2])
-                breakReg_check(2);
-            if (lowRegBreakCounter[3])
-                breakReg_check(3);
-            if (medRegBreakCounter[0])
-                breakReg_check(4);
-            if (medRegBreakCounter[1])
-                breakReg_check(5);
-            if (medRegBreakCounter[2])
-                breakReg_check(6);
-            if (medRegBreakCounter[3])
-                breakReg_check(7);
-            if (highRegBreakCounter[0])
-                breakReg_check(8);
-            if (highRegBreakCounter[1])
-                breakReg_check(9);
-            if (highRegBreakCounter[2])
-                breakReg_check(10);
-            if (highRegBreakCounter[3])
-                breakReg_check(11);
-            if (statusRegBreakCounter[0])
-                breakReg_check(12);
-            if (statusRegBreakCounter[1])
-                breakReg_check(13);
-            if (statusRegBreakCounter[2])
-                breakReg_check(14);
-            if (statusRegBreakCounter[3])
-                breakReg_check(15);
-        }
+    if (enableRegBreak) {
+        if (lowRegBreakCounter[0])
+            breakReg_check(0);
+        if (lowRegBreakCounter[1])
+            breakReg_check(1);
+        if (lowRegBreakCounter[2])
+            breakReg_check(2);
+        if (lowRegBreakCounter[3])
+            breakReg_check(3);
+        if (medRegBreakCounter[0])
+            breakReg_check(4);
+        if (medRegBreakCounter[1])
+            breakReg_check(5);
+        if (medRegBreakCounter[2])
+            breakReg_check(6);
+        if (medRegBreakCounter[3])
+            breakReg_check(7);
+        if (highRegBreakCounter[0])
+            breakReg_check(8);
+        if (highRegBreakCounter[1])
+            breakReg_check(9);
+        if (highRegBreakCounter[2])
+            breakReg_check(10);
+        if (highRegBreakCounter[3])
+            breakReg_check(11);
+        if (statusRegBreakCounter[0])
+            breakReg_check(12);
+        if (statusRegBreakCounter[1])
+            breakReg_check(13);
+        if (statusRegBreakCounter[2])
+            breakReg_check(14);
+        if (statusRegBreakCounter[3])
+            breakReg_check(15);
+    }
 #endif
-        if (clockTicks < 0)
+    if (gbaCore.clockTicks < 0)
+        return false;
+    if (gbaCore.clockTicks == 0)
+        gbaCore.clockTicks = 1 + codeTicksAccessSeq32(oldArmNextPC);
+    gbaCore.cpuTotalTicks += gbaCore.clockTicks;
+    return true;
+}
+
+static inline bool armKeepRunning()
+{
+    return gbaCore.cpuTotalTicks < gbaCore.cpuNextEvent && gbaCore.armState && !gbaCore.holdState && !gbaCore.SWITicks && !gbaCore.debugger;
+}
+
+#if defined(VBAM_ENABLE_THREADED_DISPATCH)
+// See thumbExecute() for how the threaded dispatch works.
+
+typedef int (*threadedfunc_t)(uint32_t opcode, uint32_t oldArmNextPC);
+
+static VBAM_FORCE_INLINE int armThreadedDispatch(uint32_t, uint32_t);
+
+template <insnfunc_t handler>
+VBAM_NO_ICF static int armThreaded(uint32_t opcode, uint32_t oldArmNextPC)
+{
+    handler(opcode);
+#ifdef INSN_COUNTER
+    count(opcode, true);
+#endif
+    if (!armRetire(oldArmNextPC))
+        return 0;
+    if (!armKeepRunning())
+        return 1;
+    VBAM_MUSTTAIL return armThreadedDispatch(opcode, oldArmNextPC);
+}
+
+template <size_t... index>
+static constexpr std::array<threadedfunc_t, sizeof...(index)> armThreadedTableFor(std::index_sequence<index...>)
+{
+    return {{ &armThreaded<armInsnTable[index]>... }};
+}
+
+static constexpr std::array<threadedfunc_t, 4096> armThreadedTable =
+    armThreadedTableFor(std::make_index_sequence<4096>());
+
+static VBAM_FORCE_INLINE int armThreadedDispatch(uint32_t, uint32_t)
+{
+    for (;;) {
+        if (coreOptions.cheatsEnabled) {
+            cpuMasterCodeCheck();
+        }
+
+        uint32_t opcode;
+        uint32_t oldArmNextPC;
+        if (!armFetch(opcode, oldArmNextPC))
             return 0;
-        if (clockTicks == 0)
-            clockTicks = 1 + codeTicksAccessSeq32(oldArmNextPC);
-        cpuTotalTicks += clockTicks;
 
-    } while (cpuTotalTicks < cpuNextEvent && armState && !holdState && !SWITicks && !debugger);
+        if (armCondition(opcode)) {
+            VBAM_MUSTTAIL return armThreadedTable[((opcode >> 16) & 0xFF0) | ((opcode >> 4) & 0x0F)](opcode, oldArmNextPC);
+        }
+
+        armSkipped(opcode);
+        if (!armRetire(oldArmNextPC))
+            return 0;
+        if (!armKeepRunning())
+            return 1;
+    }
+}
+
+int armExecute()
+{
+    return armThreadedDispatch(0, 0);
+}
+
+#else  // !defined(VBAM_ENABLE_THREADED_DISPATCH)
+
+int armExecute()
+{
+    do {
+        if (coreOptions.cheatsEnabled) {
+            cpuMasterCodeCheck();
+        }
+
+        uint32_t opcode;
+        uint32_t oldArmNextPC;
+        if (!armFetch(opcode, oldArmNextPC))
+            return 0;
+
+        if (armCondition(opcode)) {
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+            (*armDecodeCacheHandler(gbaCore.armNextPC, opcode))(opcode);
+#else
+            (*armInsnTable[((opcode >> 16) & 0xFF0) | ((opcode >> 4) & 0x0F)])(opcode);
+#endif
+#ifdef INSN_COUNTER
+            count(opcode, true);
+#endif
+        } else {
+            armSkipped(opcode);
+        }
+
+        if (!armRetire(oldArmNextPC))
+            return 0;
+    } while (armKeepRunning());
 
     return 1;
 }
+
+#endif  // defined(VBAM_ENABLE_THREADED_DISPATCH)
@@ -7,6 +7,7 @@
 
 #include "core/base/port.h"
 #include "core/gba/gba.h"
+#include "core/gba/gbaCore.h"
 #include "core/gba/gbaElf.h"
 
 struct Opcodes {
@@ -16,13 +17,13 @@ struct Opcodes {
 };
 
 #define debuggerReadMemory(addr) \
-    READ32LE(((uint32_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ32LE(((uint32_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define debuggerReadHalfWord(addr) \
-    READ16LE(((uint16_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ16LE(((uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define debuggerReadByte(addr) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]
+    gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]
 
 const char hdig[] = "0123456789abcdef";
 
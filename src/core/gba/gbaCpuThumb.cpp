@@ -1,6 +1,8 @@
+#include <array>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 
 #ifndef _MSC_VER
 #include <strings.h>
@@ -10,11 +12,17 @@
 #include "core/gba/gbaCpu.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaDecodeCache.h"
+#include "core/gba/internal/gbaIdleLoop.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 #include "core/gba/gbaRemote.h"
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
+#if defined(VBAM_ENABLE_JIT)
+#include "core/gba/internal/gbaJit.h"
+#endif  // defined(VBAM_ENABLE_JIT)
+
 #ifdef PROFILING
 #include "prof/prof.h"
 #endif
@@ -25,13 +33,11 @@
 
 ///////////////////////////////////////////////////////////////////////////
 
-static int clockTicks;
-
 static INSN_REGPARM void thumbUnknownInsn(uint32_t opcode)
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_UNDEFINED)
-        log("Undefined THUMB instruction %04x at %08x\n", opcode, armNextPC - 2);
+        log("Undefined THUMB instruction %04x at %08x\n", opcode, gbaCore.armNextPC - 2);
 #endif
     CPUUndefinedException();
 }
@@ -39,10 +45,10 @@ static INSN_REGPARM void thumbUnknownInsn(uint32_t opcode)
 #ifdef VBAM_ENABLE_DEBUGGER
 static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 {
-    reg[15].I -= 2;
-    armNextPC -= 2;
+    gbaCore.reg[15].I -= 2;
+    gbaCore.armNextPC -= 2;
     dbgSignal(5, opcode & 255);
-    clockTicks = -1;
+    gbaCore.clockTicks = -1;
 }
 #endif
 
@@ -51,18 +57,18 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifdef VBAM_ENABLE_DEBUGGER
 #define THUMB_CONSOLE_OUTPUT(a, b)                            \
     do {                                                      \
-        if ((opcode == 0x4000) && (reg[0].I == 0xC0DED00D)) { \
+        if ((opcode == 0x4000) && (gbaCore.reg[0].I == 0xC0DED00D)) { \
             dbgOutput((a), (b));                              \
         }                                                     \
     } while (0)
 #define UPDATE_OLDREG                                      \
     do {                                                   \
-        if (debugger_last) {                               \
-            snprintf(oldbuffer, sizeof(oldbuffer), "%08X", \
-                armState ? reg[15].I - 4 : reg[15].I - 2); \
+        if (gbaCore.debugger_last) {                               \
+            snprintf(gbaCore.oldbuffer, sizeof(gbaCore.oldbuffer), "%08X", \
+                gbaCore.armState ? gbaCore.reg[15].I - 4 : gbaCore.reg[15].I - 2); \
             int i;                                         \
             for (i = 0; i < 18; i++) {                     \
-                oldreg[i] = reg[i].I;                      \
+                gbaCore.oldreg[i] = gbaCore.reg[i].I;                      \
             }                                              \
         }                                                  \
     } while (0)
@@ -86,13 +92,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[source].I), \
-                     "r"(reg[N].I));       \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+                     : "r"(gbaCore.reg[source].I), \
+                     "r"(gbaCore.reg[N].I));       \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define ADD_RD_RS_O3(N)                    \
     {                                      \
@@ -103,13 +109,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[source].I), \
+                     : "r"(gbaCore.reg[source].I), \
                      "r"(N));              \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define ADD_RD_RS_O3_0 ADD_RD_RS_O3
 #define ADD_RN_O8(d)                       \
@@ -121,13 +127,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[(d)].I),    \
+                     : "r"(gbaCore.reg[(d)].I),    \
                      "r"(opcode & 255));   \
-        reg[(d)].I = Result;               \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.reg[(d)].I = Result;               \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define CMN_RD_RS                          \
     {                                      \
@@ -138,12 +144,12 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[dest].I),   \
+                     : "r"(gbaCore.reg[dest].I),   \
                      "r"(value));          \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define ADC_RD_RS            \
     {                        \
@@ -155,15 +161,15 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                              "mfcr	%1\n"			\
                              : "=r" (Result),		\
                                "=r" (Flags)			\
-                             : "r" (reg[dest].I),	\
+                             : "r" (gbaCore.reg[dest].I),	\
                                "r" (value),			\
-                               "r" (C_FLAG << 29)	\
+                               "r" (gbaCore.C_FLAG << 29)	\
                              );
-                             reg[dest].I = Result;
-                             Z_FLAG = (Flags >> 29) & 1;
-                             N_FLAG = (Flags >> 31) & 1;
-                             C_FLAG = (Flags >> 25) & 1;
-                             V_FLAG = (Flags >> 26) & 1;
+                             gbaCore.reg[dest].I = Result;
+                             gbaCore.Z_FLAG = (Flags >> 29) & 1;
+                             gbaCore.N_FLAG = (Flags >> 31) & 1;
+                             gbaCore.C_FLAG = (Flags >> 25) & 1;
+                             gbaCore.V_FLAG = (Flags >> 26) & 1;
                              }
 #define SUB_RD_RS_RN(N)                    \
     {                                      \
@@ -174,13 +180,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[source].I), \
-                     "r"(reg[N].I));       \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+                     : "r"(gbaCore.reg[source].I), \
+                     "r"(gbaCore.reg[N].I));       \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define SUB_RD_RS_O3(N)                    \
     {                                      \
@@ -191,13 +197,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[source].I), \
+                     : "r"(gbaCore.reg[source].I), \
                      "r"(N));              \
-        reg[dest].I = Result;              \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.reg[dest].I = Result;              \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define SUB_RD_RS_O3_0 SUB_RD_RS_O3
 #define SUB_RN_O8(d)                       \
@@ -209,13 +215,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[(d)].I),    \
+                     : "r"(gbaCore.reg[(d)].I),    \
                      "r"(opcode & 255));   \
-        reg[(d)].I = Result;               \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.reg[(d)].I = Result;               \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define CMP_RN_O8(d)                       \
     {                                      \
@@ -226,12 +232,12 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[(d)].I),    \
+                     : "r"(gbaCore.reg[(d)].I),    \
                      "r"(opcode & 255));   \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #define SBC_RD_RS            \
     {                        \
@@ -243,15 +249,15 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                              "mfcr	%1\n"			\
                              : "=r" (Result),		\
                                "=r" (Flags)			\
-                             : "r" (reg[dest].I),	\
+                             : "r" (gbaCore.reg[dest].I),	\
                                "r" (value),			\
-                               "r" (C_FLAG << 29) 	\
+                               "r" (gbaCore.C_FLAG << 29) 	\
                              );
-                             reg[dest].I = Result;
-                             Z_FLAG = (Flags >> 29) & 1;
-                             N_FLAG = (Flags >> 31) & 1;
-                             C_FLAG = (Flags >> 25) & 1;
-                             V_FLAG = (Flags >> 26) & 1;
+                             gbaCore.reg[dest].I = Result;
+                             gbaCore.Z_FLAG = (Flags >> 29) & 1;
+                             gbaCore.N_FLAG = (Flags >> 31) & 1;
+                             gbaCore.C_FLAG = (Flags >> 25) & 1;
+                             gbaCore.V_FLAG = (Flags >> 26) & 1;
                              }
 #define NEG_RD_RS                           \
     {                                       \
@@ -262,13 +268,13 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"            \
                      : "=r"(Result),        \
                      "=r"(Flags)            \
-                     : "r"(reg[source].I),  \
+                     : "r"(gbaCore.reg[source].I),  \
                      "r"(0));               \
-        reg[dest].I = Result;               \
-        Z_FLAG = (Flags >> 29) & 1;         \
-        N_FLAG = (Flags >> 31) & 1;         \
-        C_FLAG = (Flags >> 25) & 1;         \
-        V_FLAG = (Flags >> 26) & 1;         \
+        gbaCore.reg[dest].I = Result;               \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;         \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;         \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;         \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;         \
     }
 #define CMP_RD_RS                          \
     {                                      \
@@ -279,12 +285,12 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                      "mfcr %1\n"           \
                      : "=r"(Result),       \
                      "=r"(Flags)           \
-                     : "r"(reg[dest].I),   \
+                     : "r"(gbaCore.reg[dest].I),   \
                      "r"(value));          \
-        Z_FLAG = (Flags >> 29) & 1;        \
-        N_FLAG = (Flags >> 31) & 1;        \
-        C_FLAG = (Flags >> 25) & 1;        \
-        V_FLAG = (Flags >> 26) & 1;        \
+        gbaCore.Z_FLAG = (Flags >> 29) & 1;        \
+        gbaCore.N_FLAG = (Flags >> 31) & 1;        \
+        gbaCore.C_FLAG = (Flags >> 25) & 1;        \
+        gbaCore.V_FLAG = (Flags >> 26) & 1;        \
     }
 #else
 #define EMIT1(op, arg) #op " " arg "; "
@@ -302,83 +308,83 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #define edx "%%edx"
 #define ADD_RN_O8(d)                                \
     asm("andl $0xFF, %%eax;"                        \
-        "addl %%eax, %0;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))               \
-                EMIT1(setcb, VAR(C_FLAG))           \
-                    EMIT1(setob, VAR(V_FLAG))       \
-        : "=m"(reg[(d)].I));
+        "addl %%eax, %0;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))               \
+                EMIT1(setcb, VAR(gbaCore.C_FLAG))           \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))       \
+        : "=m"(gbaCore.reg[(d)].I));
 #define CMN_RD_RS                               \
-    asm("add %0, %1;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))           \
-                EMIT1(setcb, VAR(C_FLAG))       \
-                    EMIT1(setob, VAR(V_FLAG))   \
+    asm("add %0, %1;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))           \
+                EMIT1(setcb, VAR(gbaCore.C_FLAG))       \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))   \
         :                                       \
-        : "r"(value), "r"(reg[dest].I)          \
+        : "r"(value), "r"(gbaCore.reg[dest].I)          \
         : "1");
 #define ADC_RD_RS                                                                   \
-    asm(EMIT2(bt, KONST(0), VAR(C_FLAG)) "adc %1, %%ebx;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))                                               \
-                EMIT1(setcb, VAR(C_FLAG))                                           \
-                    EMIT1(setob, VAR(V_FLAG))                                       \
-        : "=b"(reg[dest].I)                                                         \
-        : "r"(value), "b"(reg[dest].I));
+    asm(EMIT2(bt, KONST(0), VAR(gbaCore.C_FLAG)) "adc %1, %%ebx;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))                                               \
+                EMIT1(setcb, VAR(gbaCore.C_FLAG))                                           \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))                                       \
+        : "=b"(gbaCore.reg[dest].I)                                                         \
+        : "r"(value), "b"(gbaCore.reg[dest].I));
 #define SUB_RN_O8(d)                                \
     asm("andl $0xFF, %%eax;"                        \
-        "subl %%eax, %0;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))               \
-                EMIT1(setncb, VAR(C_FLAG))          \
-                    EMIT1(setob, VAR(V_FLAG))       \
-        : "=m"(reg[(d)].I));
+        "subl %%eax, %0;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))               \
+                EMIT1(setncb, VAR(gbaCore.C_FLAG))          \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))       \
+        : "=m"(gbaCore.reg[(d)].I));
 #define MOV_RN_O8(d)                                                                                        \
-    asm("andl $0xFF, %%eax;" EMIT2(movb, KONST(0), VAR(N_FLAG)) "movl %%eax, %0;" EMIT1(setzb, VAR(Z_FLAG)) \
-        : "=m"(reg[(d)].I));
+    asm("andl $0xFF, %%eax;" EMIT2(movb, KONST(0), VAR(gbaCore.N_FLAG)) "movl %%eax, %0;" EMIT1(setzb, VAR(gbaCore.Z_FLAG)) \
+        : "=m"(gbaCore.reg[(d)].I));
 #define CMP_RN_O8(d)                                \
     asm("andl $0xFF, %%eax;"                        \
-        "cmpl %%eax, %0;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))               \
-                EMIT1(setncb, VAR(C_FLAG))          \
-                    EMIT1(setob, VAR(V_FLAG))       \
+        "cmpl %%eax, %0;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))               \
+                EMIT1(setncb, VAR(gbaCore.C_FLAG))          \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))       \
         :                                           \
-        : "m"(reg[(d)].I));
+        : "m"(gbaCore.reg[(d)].I));
 #define SBC_RD_RS                                                                            \
-    asm volatile(EMIT2(bt, KONST(0), VAR(C_FLAG)) "cmc;"                                     \
-                                                  "sbb %1, %%ebx;" EMIT1(setsb, VAR(N_FLAG)) \
-                                                      EMIT1(setzb, VAR(Z_FLAG))              \
-                                                          EMIT1(setncb, VAR(C_FLAG))         \
-                                                              EMIT1(setob, VAR(V_FLAG))      \
-                 : "=b"(reg[dest].I)                                                         \
-                 : "r"(value), "b"(reg[dest].I)                                              \
+    asm volatile(EMIT2(bt, KONST(0), VAR(gbaCore.C_FLAG)) "cmc;"                                     \
+                                                  "sbb %1, %%ebx;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+                                                      EMIT1(setzb, VAR(gbaCore.Z_FLAG))              \
+                                                          EMIT1(setncb, VAR(gbaCore.C_FLAG))         \
+                                                              EMIT1(setob, VAR(gbaCore.V_FLAG))      \
+                 : "=b"(gbaCore.reg[dest].I)                                                         \
+                 : "r"(value), "b"(gbaCore.reg[dest].I)                                              \
                  : "cc", "memory");
 #define LSL_RD_RS                                    \
-    asm("shl %%cl, %%eax;" EMIT1(setcb, VAR(C_FLAG)) \
+    asm("shl %%cl, %%eax;" EMIT1(setcb, VAR(gbaCore.C_FLAG)) \
         : "=a"(value)                                \
-        : "a"(reg[dest].I), "c"(value));
+        : "a"(gbaCore.reg[dest].I), "c"(value));
 #define LSR_RD_RS                                    \
-    asm("shr %%cl, %%eax;" EMIT1(setcb, VAR(C_FLAG)) \
+    asm("shr %%cl, %%eax;" EMIT1(setcb, VAR(gbaCore.C_FLAG)) \
         : "=a"(value)                                \
-        : "a"(reg[dest].I), "c"(value));
+        : "a"(gbaCore.reg[dest].I), "c"(value));
 #define ASR_RD_RS                                    \
-    asm("sar %%cl, %%eax;" EMIT1(setcb, VAR(C_FLAG)) \
+    asm("sar %%cl, %%eax;" EMIT1(setcb, VAR(gbaCore.C_FLAG)) \
         : "=a"(value)                                \
-        : "a"(reg[dest].I), "c"(value));
+        : "a"(gbaCore.reg[dest].I), "c"(value));
 #define ROR_RD_RS                                    \
-    asm("ror %%cl, %%eax;" EMIT1(setcb, VAR(C_FLAG)) \
+    asm("ror %%cl, %%eax;" EMIT1(setcb, VAR(gbaCore.C_FLAG)) \
         : "=a"(value)                                \
-        : "a"(reg[dest].I), "c"(value));
+        : "a"(gbaCore.reg[dest].I), "c"(value));
 #define NEG_RD_RS                              \
-    asm("neg %%ebx;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))          \
-                EMIT1(setncb, VAR(C_FLAG))     \
-                    EMIT1(setob, VAR(V_FLAG))  \
-        : "=b"(reg[dest].I)                    \
-        : "b"(reg[source].I));
+    asm("neg %%ebx;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))          \
+                EMIT1(setncb, VAR(gbaCore.C_FLAG))     \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))  \
+        : "=b"(gbaCore.reg[dest].I)                    \
+        : "b"(gbaCore.reg[source].I));
 #define CMP_RD_RS                               \
-    asm("sub %0, %1;" EMIT1(setsb, VAR(N_FLAG)) \
-            EMIT1(setzb, VAR(Z_FLAG))           \
-                EMIT1(setncb, VAR(C_FLAG))      \
-                    EMIT1(setob, VAR(V_FLAG))   \
+    asm("sub %0, %1;" EMIT1(setsb, VAR(gbaCore.N_FLAG)) \
+            EMIT1(setzb, VAR(gbaCore.Z_FLAG))           \
+                EMIT1(setncb, VAR(gbaCore.C_FLAG))      \
+                    EMIT1(setob, VAR(gbaCore.V_FLAG))   \
         :                                       \
-        : "r"(value), "r"(reg[dest].I)          \
+        : "r"(value), "r"(gbaCore.reg[dest].I)          \
         : "1");
 #define IMM5_INSN(OP, N)                                   \
     asm("movl %%eax,%%ecx;"                                \
@@ -386,8 +392,8 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
         "andl $7,%%ecx;"                                   \
         "andl $0x1C,%%eax;" EMIT2(movl, REGREF1(eax), edx) \
             OP                                             \
-                EMIT1(setsb, VAR(N_FLAG))                  \
-                    EMIT1(setzb, VAR(Z_FLAG))              \
+                EMIT1(setsb, VAR(gbaCore.N_FLAG))                  \
+                    EMIT1(setzb, VAR(gbaCore.Z_FLAG))              \
                         EMIT2(movl, edx, REGREF2(ecx, 4))  \
         :                                                  \
         : "i"(N))
@@ -397,143 +403,143 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
         "andl $7,%%ecx;"                                   \
         "andl $0x1C,%%eax;" EMIT2(movl, REGREF1(eax), edx) \
             OP                                             \
-                EMIT1(setsb, VAR(N_FLAG))                  \
-                    EMIT1(setzb, VAR(Z_FLAG))              \
+                EMIT1(setsb, VAR(gbaCore.N_FLAG))                  \
+                    EMIT1(setzb, VAR(gbaCore.Z_FLAG))              \
                         EMIT2(movl, edx, REGREF2(ecx, 4))  \
         :                                                  \
         :)
 #define IMM5_LSL \
-    "shll %0,%%edx;" EMIT1(setcb, VAR(C_FLAG))
+    "shll %0,%%edx;" EMIT1(setcb, VAR(gbaCore.C_FLAG))
 #define IMM5_LSL_0 \
     "testl %%edx,%%edx;"
 #define IMM5_LSR \
-    "shrl %0,%%edx;" EMIT1(setcb, VAR(C_FLAG))
+    "shrl %0,%%edx;" EMIT1(setcb, VAR(gbaCore.C_FLAG))
 #define IMM5_LSR_0 \
-    "testl %%edx,%%edx;" EMIT1(setsb, VAR(C_FLAG)) "xorl %%edx,%%edx;"
+    "testl %%edx,%%edx;" EMIT1(setsb, VAR(gbaCore.C_FLAG)) "xorl %%edx,%%edx;"
 #define IMM5_ASR \
-    "sarl %0,%%edx;" EMIT1(setcb, VAR(C_FLAG))
+    "sarl %0,%%edx;" EMIT1(setcb, VAR(gbaCore.C_FLAG))
 #define IMM5_ASR_0 \
-    "sarl $31,%%edx;" EMIT1(setsb, VAR(C_FLAG))
+    "sarl $31,%%edx;" EMIT1(setsb, VAR(gbaCore.C_FLAG))
 #define THREEARG_INSN(OP, N)                              \
     asm("movl %%eax,%%edx;"                               \
         "shrl $1,%%edx;"                                  \
         "andl $0x1C,%%edx;"                               \
         "andl $7,%%eax;" EMIT2(movl, REGREF1(edx), ecx)   \
             OP(N)                                         \
-                EMIT1(setsb, VAR(N_FLAG))                 \
-                    EMIT1(setzb, VAR(Z_FLAG))             \
+                EMIT1(setsb, VAR(gbaCore.N_FLAG))                 \
+                    EMIT1(setzb, VAR(gbaCore.Z_FLAG))             \
                         EMIT2(movl, ecx, REGREF2(eax, 4)) \
         :                                                 \
         :)
 #define ADD_RD_RS_RN(N)                   \
-    EMIT2(add, VAR(reg) "+" #N "*4", ecx) \
-    EMIT1(setcb, VAR(C_FLAG))             \
-    EMIT1(setob, VAR(V_FLAG))
+    EMIT2(add, VAR(gbaCore.reg) "+" #N "*4", ecx) \
+    EMIT1(setcb, VAR(gbaCore.C_FLAG))             \
+    EMIT1(setob, VAR(gbaCore.V_FLAG))
 #define ADD_RD_RS_O3(N)                            \
-    "add $" #N ",%%ecx;" EMIT1(setcb, VAR(C_FLAG)) \
-        EMIT1(setob, VAR(V_FLAG))
+    "add $" #N ",%%ecx;" EMIT1(setcb, VAR(gbaCore.C_FLAG)) \
+        EMIT1(setob, VAR(gbaCore.V_FLAG))
 #define ADD_RD_RS_O3_0(N)              \
-    EMIT2(movb, KONST(0), VAR(C_FLAG)) \
-    "add $0,%%ecx;" EMIT2(movb, KONST(0), VAR(V_FLAG))
+    EMIT2(movb, KONST(0), VAR(gbaCore.C_FLAG)) \
+    "add $0,%%ecx;" EMIT2(movb, KONST(0), VAR(gbaCore.V_FLAG))
 #define SUB_RD_RS_RN(N)                   \
-    EMIT2(sub, VAR(reg) "+" #N "*4", ecx) \
-    EMIT1(setncb, VAR(C_FLAG))            \
-    EMIT1(setob, VAR(V_FLAG))
+    EMIT2(sub, VAR(gbaCore.reg) "+" #N "*4", ecx) \
+    EMIT1(setncb, VAR(gbaCore.C_FLAG))            \
+    EMIT1(setob, VAR(gbaCore.V_FLAG))
 #define SUB_RD_RS_O3(N)                             \
-    "sub $" #N ",%%ecx;" EMIT1(setncb, VAR(C_FLAG)) \
-        EMIT1(setob, VAR(V_FLAG))
+    "sub $" #N ",%%ecx;" EMIT1(setncb, VAR(gbaCore.C_FLAG)) \
+        EMIT1(setob, VAR(gbaCore.V_FLAG))
 #define SUB_RD_RS_O3_0(N)              \
-    EMIT2(movb, KONST(1), VAR(C_FLAG)) \
-    "sub $0,%%ecx;" EMIT2(movb, KONST(0), VAR(V_FLAG))
+    EMIT2(movb, KONST(1), VAR(gbaCore.C_FLAG)) \
+    "sub $0,%%ecx;" EMIT2(movb, KONST(0), VAR(gbaCore.V_FLAG))
 #endif
 #else // !__GNUC__
 #define ADD_RD_RS_RN(N)                                                                                                                                                                                                                                                                                  \
     {                                                                                                                                                                                                                                                                                                    \
-        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm add ebx, dword ptr[OFFSET reg + 4 * N] __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm add ebx, dword ptr[OFFSET gbaCore.reg + 4 * N] __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define ADD_RD_RS_O3(N)                                                                                                                                                                                                                                                      \
     {                                                                                                                                                                                                                                                                        \
-        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm add ebx, N __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm add ebx, N __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define ADD_RD_RS_O3_0                                                                                                                                                                                                                                                           \
     {                                                                                                                                                                                                                                                                            \
-        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm add ebx, 0 __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm mov byte ptr C_FLAG, 0 __asm mov byte ptr V_FLAG, 0 \
+        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm add ebx, 0 __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm mov byte ptr gbaCore.C_FLAG, 0 __asm mov byte ptr gbaCore.V_FLAG, 0 \
     }
 #define ADD_RN_O8(d)                                                                                                                                                                                        \
     {                                                                                                                                                                                                       \
-        __asm mov ebx, opcode __asm and ebx, 255 __asm add dword ptr[OFFSET reg + 4 * (d)], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov ebx, opcode __asm and ebx, 255 __asm add dword ptr[OFFSET gbaCore.reg + 4 * (d)], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define CMN_RD_RS                                                                                                                                                                                           \
     {                                                                                                                                                                                                       \
-        __asm mov eax, dest __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm add ebx, value __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, dest __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm add ebx, value __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define ADC_RD_RS                                                                                                                                                                                                                                                                                          \
     {                                                                                                                                                                                                                                                                                                      \
-        __asm mov ebx, dest __asm mov ebx, dword ptr[OFFSET reg + 4 * ebx] __asm bt word ptr C_FLAG, 0 __asm adc ebx, value __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov ebx, dest __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * ebx] __asm bt word ptr gbaCore.C_FLAG, 0 __asm adc ebx, value __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define SUB_RD_RS_RN(N)                                                                                                                                                                                                                                                                                   \
     {                                                                                                                                                                                                                                                                                                     \
-        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm sub ebx, dword ptr[OFFSET reg + 4 * N] __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm sub ebx, dword ptr[OFFSET gbaCore.reg + 4 * N] __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define SUB_RD_RS_O3(N)                                                                                                                                                                                                                                                       \
     {                                                                                                                                                                                                                                                                         \
-        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm sub ebx, N __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm sub ebx, N __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define SUB_RD_RS_O3_0                                                                                                                                                                                                                                                           \
     {                                                                                                                                                                                                                                                                            \
-        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm sub ebx, 0 __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm mov byte ptr C_FLAG, 1 __asm mov byte ptr V_FLAG, 0 \
+        __asm mov eax, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm sub ebx, 0 __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm mov byte ptr gbaCore.C_FLAG, 1 __asm mov byte ptr gbaCore.V_FLAG, 0 \
     }
 #define SUB_RN_O8(d)                                                                                                                                                                                         \
     {                                                                                                                                                                                                        \
-        __asm mov ebx, opcode __asm and ebx, 255 __asm sub dword ptr[OFFSET reg + 4 * (d)], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov ebx, opcode __asm and ebx, 255 __asm sub dword ptr[OFFSET gbaCore.reg + 4 * (d)], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define MOV_RN_O8(d)                                                                                                                                  \
     {                                                                                                                                                 \
-        __asm mov eax, opcode __asm and eax, 255 __asm mov dword ptr[OFFSET reg + 4 * (d)], eax __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG \
+        __asm mov eax, opcode __asm and eax, 255 __asm mov dword ptr[OFFSET gbaCore.reg + 4 * (d)], eax __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG \
     }
 #define CMP_RN_O8(d)                                                                                                                                                                                                            \
     {                                                                                                                                                                                                                           \
-        __asm mov eax, dword ptr[OFFSET reg + 4 * (d)] __asm mov ebx, opcode __asm and ebx, 255 __asm sub eax, ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * (d)] __asm mov ebx, opcode __asm and ebx, 255 __asm sub eax, ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define SBC_RD_RS                                                                                                                                                                                                                                                                                                                        \
     {                                                                                                                                                                                                                                                                                                                                    \
-        __asm mov ebx, dest __asm mov ebx, dword ptr[OFFSET reg + 4 * ebx] __asm mov eax, value __asm bt word ptr C_FLAG, 0 __asm cmc __asm sbb ebx, eax __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov ebx, dest __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * ebx] __asm mov eax, value __asm bt word ptr gbaCore.C_FLAG, 0 __asm cmc __asm sbb ebx, eax __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define LSL_RD_RM_I5                                                                                                                                                        \
     {                                                                                                                                                                       \
-        __asm mov eax, source __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr shift __asm shl eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, source __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr shift __asm shl eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define LSL_RD_RS                                                                                                                                                         \
     {                                                                                                                                                                     \
-        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr value __asm shl eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr value __asm shl eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define LSR_RD_RM_I5                                                                                                                                                        \
     {                                                                                                                                                                       \
-        __asm mov eax, source __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr shift __asm shr eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, source __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr shift __asm shr eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define LSR_RD_RS                                                                                                                                                         \
     {                                                                                                                                                                     \
-        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr value __asm shr eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr value __asm shr eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define ASR_RD_RM_I5                                                                                                                                                        \
     {                                                                                                                                                                       \
-        __asm mov eax, source __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr shift __asm sar eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, source __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr shift __asm sar eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define ASR_RD_RS                                                                                                                                                         \
     {                                                                                                                                                                     \
-        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr value __asm sar eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr value __asm sar eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define ROR_RD_RS                                                                                                                                                         \
     {                                                                                                                                                                     \
-        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET reg + 4 * eax] __asm mov cl, byte ptr value __asm ror eax, cl __asm mov value, eax __asm setc byte ptr C_FLAG \
+        __asm mov eax, dest __asm mov eax, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm mov cl, byte ptr value __asm ror eax, cl __asm mov value, eax __asm setc byte ptr gbaCore.C_FLAG \
     }
 #define NEG_RD_RS                                                                                                                                                                                                                                                          \
     {                                                                                                                                                                                                                                                                      \
-        __asm mov ebx, source __asm mov ebx, dword ptr[OFFSET reg + 4 * ebx] __asm neg ebx __asm mov eax, dest __asm mov dword ptr[OFFSET reg + 4 * eax], ebx __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov ebx, source __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * ebx] __asm neg ebx __asm mov eax, dest __asm mov dword ptr[OFFSET gbaCore.reg + 4 * eax], ebx __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #define CMP_RD_RS                                                                                                                                                                                            \
     {                                                                                                                                                                                                        \
-        __asm mov eax, dest __asm mov ebx, dword ptr[OFFSET reg + 4 * eax] __asm sub ebx, value __asm sets byte ptr N_FLAG __asm setz byte ptr Z_FLAG __asm setnc byte ptr C_FLAG __asm seto byte ptr V_FLAG \
+        __asm mov eax, dest __asm mov ebx, dword ptr[OFFSET gbaCore.reg + 4 * eax] __asm sub ebx, value __asm sets byte ptr gbaCore.N_FLAG __asm setz byte ptr gbaCore.Z_FLAG __asm setnc byte ptr gbaCore.C_FLAG __asm seto byte ptr gbaCore.V_FLAG \
     }
 #endif
 #endif
@@ -541,29 +547,28 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
                              // C core
 #ifndef ADDCARRY
 #define ADDCARRY(a, b, c) \
-    C_FLAG = ((NEG(a) & NEG(b)) | (NEG(a) & POS(c)) | (NEG(b) & POS(c))) ? true : false;
+    gbaCore.C_FLAG = ((NEG(a) & NEG(b)) | (NEG(a) & POS(c)) | (NEG(b) & POS(c))) ? true : false;
 #endif
 #ifndef ADDOVERFLOW
 #define ADDOVERFLOW(a, b, c) \
-    V_FLAG = ((NEG(a) & NEG(b) & POS(c)) | (POS(a) & POS(b) & NEG(c))) ? true : false;
+    gbaCore.V_FLAG = ((NEG(a) & NEG(b) & POS(c)) | (POS(a) & POS(b) & NEG(c))) ? true : false;
 #endif
 #ifndef SUBCARRY
 #define SUBCARRY(a, b, c) \
-    C_FLAG = ((NEG(a) & POS(b)) | (NEG(a) & POS(c)) | (POS(b) & POS(c))) ? true : false;
+    gbaCore.C_FLAG = ((NEG(a) & POS(b)) | (NEG(a) & POS(c)) | (POS(b) & POS(c))) ? true : false;
 #endif
 #ifndef SUBOVERFLOW
 #define SUBOVERFLOW(a, b, c) \
-    V_FLAG = ((NEG(a) & POS(b) & POS(c)) | (POS(a) & NEG(b) & NEG(c))) ? true : false;
+    gbaCore.V_FLAG = ((NEG(a) & POS(b) & POS(c)) | (POS(a) & NEG(b) & NEG(c))) ? true : false;
 #endif
 #ifndef ADD_RD_RS_RN
 #define ADD_RD_RS_RN(N)                     \
     {                                       \
-        uint32_t lhs = reg[source].I;       \
-        uint32_t rhs = reg[N].I;            \
+        uint32_t lhs = gbaCore.reg[source].I;       \
+        uint32_t rhs = gbaCore.reg[N].I;            \
         uint32_t res = lhs + rhs;           \
-        reg[dest].I = res;                  \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[dest].I = res;                  \
+        SETCOND_NZ(res);                    \
         ADDCARRY(lhs, rhs, res);            \
         ADDOVERFLOW(lhs, rhs, res);         \
     }
@@ -571,12 +576,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef ADD_RD_RS_O3
 #define ADD_RD_RS_O3(N)                     \
     {                                       \
-        uint32_t lhs = reg[source].I;       \
+        uint32_t lhs = gbaCore.reg[source].I;       \
         uint32_t rhs = N;                   \
         uint32_t res = lhs + rhs;           \
-        reg[dest].I = res;                  \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[dest].I = res;                  \
+        SETCOND_NZ(res);                    \
         ADDCARRY(lhs, rhs, res);            \
         ADDOVERFLOW(lhs, rhs, res);         \
     }
@@ -587,12 +591,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef ADD_RN_O8
 #define ADD_RN_O8(d)                        \
     {                                       \
-        uint32_t lhs = reg[(d)].I;          \
+        uint32_t lhs = gbaCore.reg[(d)].I;          \
         uint32_t rhs = (opcode & 255);      \
         uint32_t res = lhs + rhs;           \
-        reg[(d)].I = res;                   \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[(d)].I = res;                   \
+        SETCOND_NZ(res);                    \
         ADDCARRY(lhs, rhs, res);            \
         ADDOVERFLOW(lhs, rhs, res);         \
     }
@@ -600,11 +603,10 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef CMN_RD_RS
 #define CMN_RD_RS                           \
     {                                       \
-        uint32_t lhs = reg[dest].I;         \
+        uint32_t lhs = gbaCore.reg[dest].I;         \
         uint32_t rhs = value;               \
         uint32_t res = lhs + rhs;           \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        SETCOND_NZ(res);                    \
         ADDCARRY(lhs, rhs, res);            \
         ADDOVERFLOW(lhs, rhs, res);         \
     }
@@ -612,12 +614,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef ADC_RD_RS
 #define ADC_RD_RS                                    \
     {                                                \
-        uint32_t lhs = reg[dest].I;                  \
+        uint32_t lhs = gbaCore.reg[dest].I;                  \
         uint32_t rhs = value;                        \
-        uint32_t res = lhs + rhs + (uint32_t)C_FLAG; \
-        reg[dest].I = res;                           \
-        Z_FLAG = (res == 0) ? true : false;          \
-        N_FLAG = NEG(res) ? true : false;            \
+        uint32_t res = lhs + rhs + (uint32_t)gbaCore.C_FLAG; \
+        gbaCore.reg[dest].I = res;                           \
+        SETCOND_NZ(res);                             \
         ADDCARRY(lhs, rhs, res);                     \
         ADDOVERFLOW(lhs, rhs, res);                  \
     }
@@ -625,12 +626,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef SUB_RD_RS_RN
 #define SUB_RD_RS_RN(N)                     \
     {                                       \
-        uint32_t lhs = reg[source].I;       \
-        uint32_t rhs = reg[N].I;            \
+        uint32_t lhs = gbaCore.reg[source].I;       \
+        uint32_t rhs = gbaCore.reg[N].I;            \
         uint32_t res = lhs - rhs;           \
-        reg[dest].I = res;                  \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[dest].I = res;                  \
+        SETCOND_NZ(res);                    \
         SUBCARRY(lhs, rhs, res);            \
         SUBOVERFLOW(lhs, rhs, res);         \
     }
@@ -638,12 +638,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef SUB_RD_RS_O3
 #define SUB_RD_RS_O3(N)                     \
     {                                       \
-        uint32_t lhs = reg[source].I;       \
+        uint32_t lhs = gbaCore.reg[source].I;       \
         uint32_t rhs = N;                   \
         uint32_t res = lhs - rhs;           \
-        reg[dest].I = res;                  \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[dest].I = res;                  \
+        SETCOND_NZ(res);                    \
         SUBCARRY(lhs, rhs, res);            \
         SUBOVERFLOW(lhs, rhs, res);         \
     }
@@ -654,12 +653,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef SUB_RN_O8
 #define SUB_RN_O8(d)                        \
     {                                       \
-        uint32_t lhs = reg[(d)].I;          \
+        uint32_t lhs = gbaCore.reg[(d)].I;          \
         uint32_t rhs = (opcode & 255);      \
         uint32_t res = lhs - rhs;           \
-        reg[(d)].I = res;                   \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[(d)].I = res;                   \
+        SETCOND_NZ(res);                    \
         SUBCARRY(lhs, rhs, res);            \
         SUBOVERFLOW(lhs, rhs, res);         \
     }
@@ -667,19 +665,17 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef MOV_RN_O8
 #define MOV_RN_O8(d)                        \
     {                                       \
-        reg[d].I = opcode & 255;            \
-        N_FLAG = false;                     \
-        Z_FLAG = (reg[d].I ? false : true); \
+        gbaCore.reg[d].I = opcode & 255;            \
+        SETCOND_NZ(gbaCore.reg[d].I);               \
     }
 #endif
 #ifndef CMP_RN_O8
 #define CMP_RN_O8(d)                        \
     {                                       \
-        uint32_t lhs = reg[(d)].I;          \
+        uint32_t lhs = gbaCore.reg[(d)].I;          \
         uint32_t rhs = (opcode & 255);      \
         uint32_t res = lhs - rhs;           \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        SETCOND_NZ(res);                    \
         SUBCARRY(lhs, rhs, res);            \
         SUBOVERFLOW(lhs, rhs, res);         \
     }
@@ -687,12 +683,11 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef SBC_RD_RS
 #define SBC_RD_RS                                       \
     {                                                   \
-        uint32_t lhs = reg[dest].I;                     \
+        uint32_t lhs = gbaCore.reg[dest].I;                     \
         uint32_t rhs = value;                           \
-        uint32_t res = lhs - rhs - !((uint32_t)C_FLAG); \
-        reg[dest].I = res;                              \
-        Z_FLAG = (res == 0) ? true : false;             \
-        N_FLAG = NEG(res) ? true : false;               \
+        uint32_t res = lhs - rhs - !((uint32_t)gbaCore.C_FLAG); \
+        gbaCore.reg[dest].I = res;                              \
+        SETCOND_NZ(res);                                \
         SUBCARRY(lhs, rhs, res);                        \
         SUBOVERFLOW(lhs, rhs, res);                     \
     }
@@ -700,61 +695,60 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef LSL_RD_RM_I5
 #define LSL_RD_RM_I5                                                 \
     {                                                                \
-        C_FLAG = (reg[source].I >> (32 - shift)) & 1 ? true : false; \
-        value = reg[source].I << shift;                              \
+        gbaCore.C_FLAG = (gbaCore.reg[source].I >> (32 - shift)) & 1 ? true : false; \
+        value = gbaCore.reg[source].I << shift;                              \
     }
 #endif
 #ifndef LSL_RD_RS
 #define LSL_RD_RS                                                  \
     {                                                              \
-        C_FLAG = (reg[dest].I >> (32 - value)) & 1 ? true : false; \
-        value = reg[dest].I << value;                              \
+        gbaCore.C_FLAG = (gbaCore.reg[dest].I >> (32 - value)) & 1 ? true : false; \
+        value = gbaCore.reg[dest].I << value;                              \
     }
 #endif
 #ifndef LSR_RD_RM_I5
 #define LSR_RD_RM_I5                                                \
     {                                                               \
-        C_FLAG = (reg[source].I >> (shift - 1)) & 1 ? true : false; \
-        value = reg[source].I >> shift;                             \
+        gbaCore.C_FLAG = (gbaCore.reg[source].I >> (shift - 1)) & 1 ? true : false; \
+        value = gbaCore.reg[source].I >> shift;                             \
     }
 #endif
 #ifndef LSR_RD_RS
 #define LSR_RD_RS                                                 \
     {                                                             \
-        C_FLAG = (reg[dest].I >> (value - 1)) & 1 ? true : false; \
-        value = reg[dest].I >> value;                             \
+        gbaCore.C_FLAG = (gbaCore.reg[dest].I >> (value - 1)) & 1 ? true : false; \
+        value = gbaCore.reg[dest].I >> value;                             \
     }
 #endif
 #ifndef ASR_RD_RM_I5
 #define ASR_RD_RM_I5                                                              \
     {                                                                             \
-        C_FLAG = ((int32_t)reg[source].I >> (int)(shift - 1)) & 1 ? true : false; \
-        value = (int32_t)reg[source].I >> (int)shift;                             \
+        gbaCore.C_FLAG = ((int32_t)gbaCore.reg[source].I >> (int)(shift - 1)) & 1 ? true : false; \
+        value = (int32_t)gbaCore.reg[source].I >> (int)shift;                             \
     }
 #endif
 #ifndef ASR_RD_RS
 #define ASR_RD_RS                                                               \
     {                                                                           \
-        C_FLAG = ((int32_t)reg[dest].I >> (int)(value - 1)) & 1 ? true : false; \
-        value = (int32_t)reg[dest].I >> (int)value;                             \
+        gbaCore.C_FLAG = ((int32_t)gbaCore.reg[dest].I >> (int)(value - 1)) & 1 ? true : false; \
+        value = (int32_t)gbaCore.reg[dest].I >> (int)value;                             \
     }
 #endif
 #ifndef ROR_RD_RS
 #define ROR_RD_RS                                                         \
     {                                                                     \
-        C_FLAG = (reg[dest].I >> (value - 1)) & 1 ? true : false;         \
-        value = ((reg[dest].I << (32 - value)) | (reg[dest].I >> value)); \
+        gbaCore.C_FLAG = (gbaCore.reg[dest].I >> (value - 1)) & 1 ? true : false;         \
+        value = ((gbaCore.reg[dest].I << (32 - value)) | (gbaCore.reg[dest].I >> value)); \
     }
 #endif
 #ifndef NEG_RD_RS
 #define NEG_RD_RS                           \
     {                                       \
-        uint32_t lhs = reg[source].I;       \
+        uint32_t lhs = gbaCore.reg[source].I;       \
         uint32_t rhs = 0;                   \
         uint32_t res = rhs - lhs;           \
-        reg[dest].I = res;                  \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        gbaCore.reg[dest].I = res;                  \
+        SETCOND_NZ(res);                    \
         SUBCARRY(rhs, lhs, res);            \
         SUBOVERFLOW(rhs, lhs, res);         \
     }
@@ -762,11 +756,10 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
 #ifndef CMP_RD_RS
 #define CMP_RD_RS                           \
     {                                       \
-        uint32_t lhs = reg[dest].I;         \
+        uint32_t lhs = gbaCore.reg[dest].I;         \
         uint32_t rhs = value;               \
         uint32_t res = lhs - rhs;           \
-        Z_FLAG = (res == 0) ? true : false; \
-        N_FLAG = NEG(res) ? true : false;   \
+        SETCOND_NZ(res);                    \
         SUBCARRY(lhs, rhs, res);            \
         SUBOVERFLOW(lhs, rhs, res);         \
     }
@@ -777,38 +770,36 @@ static INSN_REGPARM void thumbBreakpoint(uint32_t opcode)
     int source = (opcode >> 3) & 0x07;            \
     uint32_t value;                               \
     OP(N);                                        \
-    reg[dest].I = value;                          \
-    N_FLAG = (value & 0x80000000 ? true : false); \
-    Z_FLAG = (value ? false : true);
+    gbaCore.reg[dest].I = value;                          \
+    SETCOND_NZ(value);
 #define IMM5_INSN_0(OP)                           \
     int dest = opcode & 0x07;                     \
     int source = (opcode >> 3) & 0x07;            \
     uint32_t value;                               \
     OP;                                           \
-    reg[dest].I = value;                          \
-    N_FLAG = (value & 0x80000000 ? true : false); \
-    Z_FLAG = (value ? false : true);
+    gbaCore.reg[dest].I = value;                          \
+    SETCOND_NZ(value);
 #define IMM5_LSL(N) \
     int shift = N;  \
     LSL_RD_RM_I5;
 #define IMM5_LSL_0 \
-    value = reg[source].I;
+    value = gbaCore.reg[source].I;
 #define IMM5_LSR(N) \
     int shift = N;  \
     LSR_RD_RM_I5;
 #define IMM5_LSR_0                                      \
-    C_FLAG = reg[source].I & 0x80000000 ? true : false; \
+    gbaCore.C_FLAG = gbaCore.reg[source].I & 0x80000000 ? true : false; \
     value = 0;
 #define IMM5_ASR(N) \
     int shift = N;  \
     ASR_RD_RM_I5;
 #define IMM5_ASR_0                    \
-    if (reg[source].I & 0x80000000) { \
+    if (gbaCore.reg[source].I & 0x80000000) { \
         value = 0xFFFFFFFF;           \
-        C_FLAG = true;                \
+        gbaCore.C_FLAG = true;                \
     } else {                          \
         value = 0;                    \
-        C_FLAG = false;               \
+        gbaCore.C_FLAG = false;               \
     }
 #endif
 #ifndef THREEARG_INSN
@@ -968,94 +959,89 @@ static INSN_REGPARM void thumb3F(uint32_t opcode) { SUB_RN_O8(7); }
 static INSN_REGPARM void thumb40_0(uint32_t opcode)
 {
     int dest = opcode & 7;
-    reg[dest].I &= reg[(opcode >> 3) & 7].I;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
-    Z_FLAG = reg[dest].I ? false : true;
-    THUMB_CONSOLE_OUTPUT(NULL, reg[2].I);
+    gbaCore.reg[dest].I &= gbaCore.reg[(opcode >> 3) & 7].I;
+    SETCOND_NZ(gbaCore.reg[dest].I);
+    THUMB_CONSOLE_OUTPUT(NULL, gbaCore.reg[2].I);
 }
 
 // EOR Rd, Rs
 static INSN_REGPARM void thumb40_1(uint32_t opcode)
 {
     int dest = opcode & 7;
-    reg[dest].I ^= reg[(opcode >> 3) & 7].I;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
-    Z_FLAG = reg[dest].I ? false : true;
+    gbaCore.reg[dest].I ^= gbaCore.reg[(opcode >> 3) & 7].I;
+    SETCOND_NZ(gbaCore.reg[dest].I);
 }
 
 // LSL Rd, Rs
 static INSN_REGPARM void thumb40_2(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[(opcode >> 3) & 7].B.B0;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].B.B0;
     if (value) {
         if (value == 32) {
             value = 0;
-            C_FLAG = (reg[dest].I & 1 ? true : false);
+            gbaCore.C_FLAG = (gbaCore.reg[dest].I & 1 ? true : false);
         } else if (value < 32) {
             LSL_RD_RS;
         } else {
             value = 0;
-            C_FLAG = false;
+            gbaCore.C_FLAG = false;
         }
-        reg[dest].I = value;
+        gbaCore.reg[dest].I = value;
     }
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
-    Z_FLAG = reg[dest].I ? false : true;
-    clockTicks = codeTicksAccess16(armNextPC) + 2;
+    SETCOND_NZ(gbaCore.reg[dest].I);
+    gbaCore.clockTicks = codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // LSR Rd, Rs
 static INSN_REGPARM void thumb40_3(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[(opcode >> 3) & 7].B.B0;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].B.B0;
     if (value) {
         if (value == 32) {
             value = 0;
-            C_FLAG = (reg[dest].I & 0x80000000 ? true : false);
+            gbaCore.C_FLAG = (gbaCore.reg[dest].I & 0x80000000 ? true : false);
         } else if (value < 32) {
             LSR_RD_RS;
         } else {
             value = 0;
-            C_FLAG = false;
+            gbaCore.C_FLAG = false;
         }
-        reg[dest].I = value;
+        gbaCore.reg[dest].I = value;
     }
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
-    Z_FLAG = reg[dest].I ? false : true;
-    clockTicks = codeTicksAccess16(armNextPC) + 2;
+    SETCOND_NZ(gbaCore.reg[dest].I);
+    gbaCore.clockTicks = codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // ASR Rd, Rs
 static INSN_REGPARM void thumb41_0(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[(opcode >> 3) & 7].B.B0;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].B.B0;
     if (value) {
         if (value < 32) {
             ASR_RD_RS;
-            reg[dest].I = value;
+            gbaCore.reg[dest].I = value;
         } else {
-            if (reg[dest].I & 0x80000000) {
-                reg[dest].I = 0xFFFFFFFF;
-                C_FLAG = true;
+            if (gbaCore.reg[dest].I & 0x80000000) {
+                gbaCore.reg[dest].I = 0xFFFFFFFF;
+                gbaCore.C_FLAG = true;
             } else {
-                reg[dest].I = 0x00000000;
-                C_FLAG = false;
+                gbaCore.reg[dest].I = 0x00000000;
+                gbaCore.C_FLAG = false;
             }
         }
     }
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
-    Z_FLAG = reg[dest].I ? false : true;
-    clockTicks = codeTicksAccess16(armNextPC) + 2;
+    SETCOND_NZ(gbaCore.reg[dest].I);
+    gbaCore.clockTicks = codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // ADC Rd, Rs
 static INSN_REGPARM void thumb41_1(uint32_t opcode)
 {
     int dest = opcode & 0x07;
-    uint32_t value = reg[(opcode >> 3) & 7].I;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].I;
     ADC_RD_RS;
 }
 
@@ -1063,7 +1049,7 @@ static INSN_REGPARM void thumb41_1(uint32_t opcode)
 static INSN_REGPARM void thumb41_2(uint32_t opcode)
 {
     int dest = opcode & 0x07;
-    uint32_t value = reg[(opcode >> 3) & 7].I;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].I;
     SBC_RD_RS;
 }
 
@@ -1071,27 +1057,25 @@ static INSN_REGPARM void thumb41_2(uint32_t opcode)
 static INSN_REGPARM void thumb41_3(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[(opcode >> 3) & 7].B.B0;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].B.B0;
     if (value) {
         value = value & 0x1f;
         if (value == 0) {
-            C_FLAG = (reg[dest].I & 0x80000000 ? true : false);
+            gbaCore.C_FLAG = (gbaCore.reg[dest].I & 0x80000000 ? true : false);
         } else {
             ROR_RD_RS;
-            reg[dest].I = value;
+            gbaCore.reg[dest].I = value;
         }
     }
-    clockTicks = codeTicksAccess16(armNextPC) + 2;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
-    Z_FLAG = reg[dest].I ? false : true;
+    gbaCore.clockTicks = codeTicksAccess16(gbaCore.armNextPC) + 2;
+    SETCOND_NZ(gbaCore.reg[dest].I);
 }
 
 // TST Rd, Rs
 static INSN_REGPARM void thumb42_0(uint32_t opcode)
 {
-    uint32_t value = reg[opcode & 7].I & reg[(opcode >> 3) & 7].I;
-    N_FLAG = value & 0x80000000 ? true : false;
-    Z_FLAG = value ? false : true;
+    uint32_t value = gbaCore.reg[opcode & 7].I & gbaCore.reg[(opcode >> 3) & 7].I;
+    SETCOND_NZ(value);
 }
 
 // NEG Rd, Rs
@@ -1106,7 +1090,7 @@ static INSN_REGPARM void thumb42_1(uint32_t opcode)
 static INSN_REGPARM void thumb42_2(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[(opcode >> 3) & 7].I;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].I;
     CMP_RD_RS;
 }
 
@@ -1114,7 +1098,7 @@ static INSN_REGPARM void thumb42_2(uint32_t opcode)
 static INSN_REGPARM void thumb42_3(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[(opcode >> 3) & 7].I;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].I;
     CMN_RD_RS;
 }
 
@@ -1122,50 +1106,46 @@ static INSN_REGPARM void thumb42_3(uint32_t opcode)
 static INSN_REGPARM void thumb43_0(uint32_t opcode)
 {
     int dest = opcode & 7;
-    reg[dest].I |= reg[(opcode >> 3) & 7].I;
-    Z_FLAG = reg[dest].I ? false : true;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
+    gbaCore.reg[dest].I |= gbaCore.reg[(opcode >> 3) & 7].I;
+    SETCOND_NZ(gbaCore.reg[dest].I);
 }
 
 // MUL Rd, Rs
 static INSN_REGPARM void thumb43_1(uint32_t opcode)
 {
-    clockTicks = 1;
+    gbaCore.clockTicks = 1;
     int dest = opcode & 7;
-    uint32_t rm = reg[dest].I;
-    reg[dest].I = reg[(opcode >> 3) & 7].I * rm;
+    uint32_t rm = gbaCore.reg[dest].I;
+    gbaCore.reg[dest].I = gbaCore.reg[(opcode >> 3) & 7].I * rm;
     if (((int32_t)rm) < 0)
         rm = ~rm;
     if ((rm & 0xFFFFFF00) == 0) {
         // clockTicks += 0;
     } else if ((rm & 0xFFFF0000) == 0)
-        clockTicks += 1;
+        gbaCore.clockTicks += 1;
     else if ((rm & 0xFF000000) == 0)
-        clockTicks += 2;
+        gbaCore.clockTicks += 2;
     else
-        clockTicks += 3;
-    busPrefetchCount = (busPrefetchCount << clockTicks) | (0xFF >> (8 - clockTicks));
-    clockTicks += codeTicksAccess16(armNextPC) + 1;
-    Z_FLAG = reg[dest].I ? false : true;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
+        gbaCore.clockTicks += 3;
+    gbaCore.busPrefetchCount = (gbaCore.busPrefetchCount << gbaCore.clockTicks) | (0xFF >> (8 - gbaCore.clockTicks));
+    gbaCore.clockTicks += codeTicksAccess16(gbaCore.armNextPC) + 1;
+    SETCOND_NZ(gbaCore.reg[dest].I);
 }
 
 // BIC Rd, Rs
 static INSN_REGPARM void thumb43_2(uint32_t opcode)
 {
     int dest = opcode & 7;
-    reg[dest].I &= (~reg[(opcode >> 3) & 7].I);
-    Z_FLAG = reg[dest].I ? false : true;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
+    gbaCore.reg[dest].I &= (~gbaCore.reg[(opcode >> 3) & 7].I);
+    SETCOND_NZ(gbaCore.reg[dest].I);
 }
 
 // MVN Rd, Rs
 static INSN_REGPARM void thumb43_3(uint32_t opcode)
 {
     int dest = opcode & 7;
-    reg[dest].I = ~reg[(opcode >> 3) & 7].I;
-    Z_FLAG = reg[dest].I ? false : true;
-    N_FLAG = reg[dest].I & 0x80000000 ? true : false;
+    gbaCore.reg[dest].I = ~gbaCore.reg[(opcode >> 3) & 7].I;
+    SETCOND_NZ(gbaCore.reg[dest].I);
 }
 
 // High-register instructions and BX //////////////////////////////////////
@@ -1173,34 +1153,34 @@ static INSN_REGPARM void thumb43_3(uint32_t opcode)
 // ADD Rd, Hs
 static INSN_REGPARM void thumb44_1(uint32_t opcode)
 {
-    reg[opcode & 7].I += reg[((opcode >> 3) & 7) + 8].I;
+    gbaCore.reg[opcode & 7].I += gbaCore.reg[((opcode >> 3) & 7) + 8].I;
 }
 
 // ADD Hd, Rs
 static INSN_REGPARM void thumb44_2(uint32_t opcode)
 {
-    reg[(opcode & 7) + 8].I += reg[(opcode >> 3) & 7].I;
+    gbaCore.reg[(opcode & 7) + 8].I += gbaCore.reg[(opcode >> 3) & 7].I;
     if ((opcode & 7) == 7) {
-        reg[15].I &= 0xFFFFFFFE;
-        armNextPC = reg[15].I;
-        reg[15].I += 2;
+        gbaCore.reg[15].I &= 0xFFFFFFFE;
+        gbaCore.armNextPC = gbaCore.reg[15].I;
+        gbaCore.reg[15].I += 2;
         THUMB_PREFETCH;
-        clockTicks = codeTicksAccessSeq16(armNextPC) * 2
-                     + codeTicksAccess16(armNextPC) + 3;
+        gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2
+                     + codeTicksAccess16(gbaCore.armNextPC) + 3;
     }
 }
 
 // ADD Hd, Hs
 static INSN_REGPARM void thumb44_3(uint32_t opcode)
 {
-    reg[(opcode & 7) + 8].I += reg[((opcode >> 3) & 7) + 8].I;
+    gbaCore.reg[(opcode & 7) + 8].I += gbaCore.reg[((opcode >> 3) & 7) + 8].I;
     if ((opcode & 7) == 7) {
-        reg[15].I &= 0xFFFFFFFE;
-        armNextPC = reg[15].I;
-        reg[15].I += 2;
+        gbaCore.reg[15].I &= 0xFFFFFFFE;
+        gbaCore.armNextPC = gbaCore.reg[15].I;
+        gbaCore.reg[15].I += 2;
         THUMB_PREFETCH;
-        clockTicks = codeTicksAccessSeq16(armNextPC) * 2
-                     + codeTicksAccess16(armNextPC) + 3;
+        gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2
+                     + codeTicksAccess16(gbaCore.armNextPC) + 3;
     }
 }
 
@@ -1208,7 +1188,7 @@ static INSN_REGPARM void thumb44_3(uint32_t opcode)
 static INSN_REGPARM void thumb45_0(uint32_t opcode)
 {
     int dest = ((opcode >> 3) & 7);
-    uint32_t value = reg[(opcode & 7)].I;
+    uint32_t value = gbaCore.reg[(opcode & 7)].I;
     CMP_RD_RS;
 }
 
@@ -1216,7 +1196,7 @@ static INSN_REGPARM void thumb45_0(uint32_t opcode)
 static INSN_REGPARM void thumb45_1(uint32_t opcode)
 {
     int dest = opcode & 7;
-    uint32_t value = reg[((opcode >> 3) & 7) + 8].I;
+    uint32_t value = gbaCore.reg[((opcode >> 3) & 7) + 8].I;
     CMP_RD_RS;
 }
 
@@ -1224,7 +1204,7 @@ static INSN_REGPARM void thumb45_1(uint32_t opcode)
 static INSN_REGPARM void thumb45_2(uint32_t opcode)
 {
     int dest = (opcode & 7) + 8;
-    uint32_t value = reg[(opcode >> 3) & 7].I;
+    uint32_t value = gbaCore.reg[(opcode >> 3) & 7].I;
     CMP_RD_RS;
 }
 
@@ -1232,51 +1212,51 @@ static INSN_REGPARM void thumb45_2(uint32_t opcode)
 static INSN_REGPARM void thumb45_3(uint32_t opcode)
 {
     int dest = (opcode & 7) + 8;
-    uint32_t value = reg[((opcode >> 3) & 7) + 8].I;
+    uint32_t value = gbaCore.reg[((opcode >> 3) & 7) + 8].I;
     CMP_RD_RS;
 }
 
 // MOV Rd, Rs
 static INSN_REGPARM void thumb46_0(uint32_t opcode)
 {
-    reg[opcode & 7].I = reg[((opcode >> 3) & 7)].I;
-    clockTicks = codeTicksAccessSeq16(armNextPC) + 1;
+    gbaCore.reg[opcode & 7].I = gbaCore.reg[((opcode >> 3) & 7)].I;
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) + 1;
 }
 
 // MOV Rd, Hs
 static INSN_REGPARM void thumb46_1(uint32_t opcode)
 {
-    reg[opcode & 7].I = reg[((opcode >> 3) & 7) + 8].I;
-    clockTicks = codeTicksAccessSeq16(armNextPC) + 1;
+    gbaCore.reg[opcode & 7].I = gbaCore.reg[((opcode >> 3) & 7) + 8].I;
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) + 1;
 }
 
 // MOV Hd, Rs
 static INSN_REGPARM void thumb46_2(uint32_t opcode)
 {
-    reg[(opcode & 7) + 8].I = reg[(opcode >> 3) & 7].I;
+    gbaCore.reg[(opcode & 7) + 8].I = gbaCore.reg[(opcode >> 3) & 7].I;
     if ((opcode & 7) == 7) {
         UPDATE_OLDREG;
-        reg[15].I &= 0xFFFFFFFE;
-        armNextPC = reg[15].I;
-        reg[15].I += 2;
+        gbaCore.reg[15].I &= 0xFFFFFFFE;
+        gbaCore.armNextPC = gbaCore.reg[15].I;
+        gbaCore.reg[15].I += 2;
         THUMB_PREFETCH;
-        clockTicks = codeTicksAccessSeq16(armNextPC) * 2
-                     + codeTicksAccess16(armNextPC) + 3;
+        gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2
+                     + codeTicksAccess16(gbaCore.armNextPC) + 3;
     }
 }
 
 // MOV Hd, Hs
 static INSN_REGPARM void thumb46_3(uint32_t opcode)
 {
-    reg[(opcode & 7) + 8].I = reg[((opcode >> 3) & 7) + 8].I;
+    gbaCore.reg[(opcode & 7) + 8].I = gbaCore.reg[((opcode >> 3) & 7) + 8].I;
     if ((opcode & 7) == 7) {
         UPDATE_OLDREG;
-        reg[15].I &= 0xFFFFFFFE;
-        armNextPC = reg[15].I;
-        reg[15].I += 2;
+        gbaCore.reg[15].I &= 0xFFFFFFFE;
+        gbaCore.armNextPC = gbaCore.reg[15].I;
+        gbaCore.reg[15].I += 2;
         THUMB_PREFETCH;
-        clockTicks = codeTicksAccessSeq16(armNextPC) * 2
-                     + codeTicksAccess16(armNextPC) + 3;
+        gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2
+                     + codeTicksAccess16(gbaCore.armNextPC) + 3;
     }
 }
 
@@ -1284,23 +1264,23 @@ static INSN_REGPARM void thumb46_3(uint32_t opcode)
 static INSN_REGPARM void thumb47(uint32_t opcode)
 {
     int base = (opcode >> 3) & 15;
-    busPrefetchCount = 0;
+    gbaCore.busPrefetchCount = 0;
     UPDATE_OLDREG;
-    reg[15].I = reg[base].I;
-    if (reg[base].I & 1) {
-        armState = false;
-        reg[15].I &= 0xFFFFFFFE;
-        armNextPC = reg[15].I;
-        reg[15].I += 2;
+    gbaCore.reg[15].I = gbaCore.reg[base].I;
+    if (gbaCore.reg[base].I & 1) {
+        gbaCore.armState = false;
+        gbaCore.reg[15].I &= 0xFFFFFFFE;
+        gbaCore.armNextPC = gbaCore.reg[15].I;
+        gbaCore.reg[15].I += 2;
         THUMB_PREFETCH;
-        clockTicks = codeTicksAccessSeq16(armNextPC) * 2 + codeTicksAccess16(armNextPC) + 3;
+        gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2 + codeTicksAccess16(gbaCore.armNextPC) + 3;
     } else {
-        armState = true;
-        reg[15].I &= 0xFFFFFFFC;
-        armNextPC = reg[15].I;
-        reg[15].I += 4;
+        gbaCore.armState = true;
+        gbaCore.reg[15].I &= 0xFFFFFFFC;
+        gbaCore.armNextPC = gbaCore.reg[15].I;
+        gbaCore.reg[15].I += 4;
         ARM_PREFETCH;
-        clockTicks = codeTicksAccessSeq32(armNextPC) * 2 + codeTicksAccess32(armNextPC) + 3;
+        gbaCore.clockTicks = codeTicksAccessSeq32(gbaCore.armNextPC) * 2 + codeTicksAccess32(gbaCore.armNextPC) + 3;
     }
 }
 
@@ -1310,174 +1290,174 @@ static INSN_REGPARM void thumb47(uint32_t opcode)
 static INSN_REGPARM void thumb48(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = (reg[15].I & 0xFFFFFFFC) + ((opcode & 0xFF) << 2);
-    reg[regist].I = CPUReadMemoryQuick(address);
-    busPrefetchCount = 0;
-    clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = (gbaCore.reg[15].I & 0xFFFFFFFC) + ((opcode & 0xFF) << 2);
+    gbaCore.reg[regist].I = CPUReadMemoryQuick(address);
+    gbaCore.busPrefetchCount = 0;
+    gbaCore.clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // STR Rd, [Rs, Rn]
 static INSN_REGPARM void thumb50(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    CPUWriteMemory(address, reg[opcode & 7].I);
-    clockTicks = dataTicksAccess32(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    CPUWriteMemory(address, gbaCore.reg[opcode & 7].I);
+    gbaCore.clockTicks = dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // STRH Rd, [Rs, Rn]
 static INSN_REGPARM void thumb52(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    CPUWriteHalfWord(address, reg[opcode & 7].W.W0);
-    clockTicks = dataTicksAccess16(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    CPUWriteHalfWord(address, gbaCore.reg[opcode & 7].W.W0);
+    gbaCore.clockTicks = dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // STRB Rd, [Rs, Rn]
 static INSN_REGPARM void thumb54(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    CPUWriteByte(address, reg[opcode & 7].B.B0);
-    clockTicks = dataTicksAccess16(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    CPUWriteByte(address, gbaCore.reg[opcode & 7].B.B0);
+    gbaCore.clockTicks = dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // LDSB Rd, [Rs, Rn]
 static INSN_REGPARM void thumb56(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    reg[opcode & 7].I = (int8_t)CPUReadByte(address);
-    clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    gbaCore.reg[opcode & 7].I = (int8_t)CPUReadByte(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // LDR Rd, [Rs, Rn]
 static INSN_REGPARM void thumb58(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    reg[opcode & 7].I = CPUReadMemory(address);
-    clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    gbaCore.reg[opcode & 7].I = CPUReadMemory(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // LDRH Rd, [Rs, Rn]
 static INSN_REGPARM void thumb5A(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    reg[opcode & 7].I = CPUReadHalfWord(address);
-    clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    gbaCore.reg[opcode & 7].I = CPUReadHalfWord(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // LDRB Rd, [Rs, Rn]
 static INSN_REGPARM void thumb5C(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    reg[opcode & 7].I = CPUReadByte(address);
-    clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    gbaCore.reg[opcode & 7].I = CPUReadByte(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // LDSH Rd, [Rs, Rn]
 static INSN_REGPARM void thumb5E(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + reg[(opcode >> 6) & 7].I;
-    reg[opcode & 7].I = (uint32_t)CPUReadHalfWordSigned(address);
-    clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + gbaCore.reg[(opcode >> 6) & 7].I;
+    gbaCore.reg[opcode & 7].I = (uint32_t)CPUReadHalfWordSigned(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // STR Rd, [Rs, #Imm]
 static INSN_REGPARM void thumb60(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 2);
-    CPUWriteMemory(address, reg[opcode & 7].I);
-    clockTicks = dataTicksAccess32(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 2);
+    CPUWriteMemory(address, gbaCore.reg[opcode & 7].I);
+    gbaCore.clockTicks = dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // LDR Rd, [Rs, #Imm]
 static INSN_REGPARM void thumb68(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 2);
-    reg[opcode & 7].I = CPUReadMemory(address);
-    clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 2);
+    gbaCore.reg[opcode & 7].I = CPUReadMemory(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // STRB Rd, [Rs, #Imm]
 static INSN_REGPARM void thumb70(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31));
-    CPUWriteByte(address, reg[opcode & 7].B.B0);
-    clockTicks = dataTicksAccess16(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31));
+    CPUWriteByte(address, gbaCore.reg[opcode & 7].B.B0);
+    gbaCore.clockTicks = dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // LDRB Rd, [Rs, #Imm]
 static INSN_REGPARM void thumb78(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31));
-    reg[opcode & 7].I = CPUReadByte(address);
-    clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31));
+    gbaCore.reg[opcode & 7].I = CPUReadByte(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // STRH Rd, [Rs, #Imm]
 static INSN_REGPARM void thumb80(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 1);
-    CPUWriteHalfWord(address, reg[opcode & 7].W.W0);
-    clockTicks = dataTicksAccess16(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 1);
+    CPUWriteHalfWord(address, gbaCore.reg[opcode & 7].W.W0);
+    gbaCore.clockTicks = dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // LDRH Rd, [Rs, #Imm]
 static INSN_REGPARM void thumb88(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 1);
-    reg[opcode & 7].I = CPUReadHalfWord(address);
-    clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[(opcode >> 3) & 7].I + (((opcode >> 6) & 31) << 1);
+    gbaCore.reg[opcode & 7].I = CPUReadHalfWord(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess16(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // STR R0~R7, [SP, #Imm]
 static INSN_REGPARM void thumb90(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[13].I + ((opcode & 255) << 2);
-    CPUWriteMemory(address, reg[regist].I);
-    clockTicks = dataTicksAccess32(address) + codeTicksAccess16(armNextPC) + 2;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[13].I + ((opcode & 255) << 2);
+    CPUWriteMemory(address, gbaCore.reg[regist].I);
+    gbaCore.clockTicks = dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC) + 2;
 }
 
 // LDR R0~R7, [SP, #Imm]
 static INSN_REGPARM void thumb98(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[13].I + ((opcode & 255) << 2);
-    reg[regist].I = CPUReadMemoryQuick(address);
-    clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(armNextPC);
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[13].I + ((opcode & 255) << 2);
+    gbaCore.reg[regist].I = CPUReadMemoryQuick(address);
+    gbaCore.clockTicks = 3 + dataTicksAccess32(address) + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // PC/stack-related ///////////////////////////////////////////////////////
@@ -1486,16 +1466,16 @@ static INSN_REGPARM void thumb98(uint32_t opcode)
 static INSN_REGPARM void thumbA0(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    reg[regist].I = (reg[15].I & 0xFFFFFFFC) + ((opcode & 255) << 2);
-    clockTicks = 1 + codeTicksAccess16(armNextPC);
+    gbaCore.reg[regist].I = (gbaCore.reg[15].I & 0xFFFFFFFC) + ((opcode & 255) << 2);
+    gbaCore.clockTicks = 1 + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // ADD R0~R7, SP, Imm
 static INSN_REGPARM void thumbA8(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    reg[regist].I = reg[13].I + ((opcode & 255) << 2);
-    clockTicks = 1 + codeTicksAccess16(armNextPC);
+    gbaCore.reg[regist].I = gbaCore.reg[13].I + ((opcode & 255) << 2);
+    gbaCore.clockTicks = 1 + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // ADD SP, Imm
@@ -1504,19 +1484,19 @@ static INSN_REGPARM void thumbB0(uint32_t opcode)
     int offset = (opcode & 127) << 2;
     if (opcode & 0x80)
         offset = -offset;
-    reg[13].I += offset;
-    clockTicks = 1 + codeTicksAccess16(armNextPC);
+    gbaCore.reg[13].I += offset;
+    gbaCore.clockTicks = 1 + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // Push and pop ///////////////////////////////////////////////////////////
 
 #define PUSH_REG(val, r)                                     \
     if (opcode & (val)) {                                    \
-        CPUWriteMemory(address, reg[(r)].I);                 \
+        CPUWriteMemory(address, gbaCore.reg[(r)].I);                 \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
         address += 4;                                        \
@@ -1524,11 +1504,11 @@ static INSN_REGPARM void thumbB0(uint32_t opcode)
 
 #define POP_REG(val, r)                                      \
     if (opcode & (val)) {                                    \
-        reg[(r)].I = CPUReadMemory(address);                 \
+        gbaCore.reg[(r)].I = CPUReadMemory(address);                 \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
         address += 4;                                        \
@@ -1537,10 +1517,10 @@ static INSN_REGPARM void thumbB0(uint32_t opcode)
 // PUSH {Rlist}
 static INSN_REGPARM void thumbB4(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int count = 0;
-    uint32_t temp = reg[13].I - 4 * cpuBitsSet[opcode & 0xff];
+    uint32_t temp = gbaCore.reg[13].I - 4 * gbaCore.cpuBitsSet[opcode & 0xff];
     uint32_t address = temp & 0xFFFFFFFC;
     PUSH_REG(1, 0);
     PUSH_REG(2, 1);
@@ -1550,17 +1530,17 @@ static INSN_REGPARM void thumbB4(uint32_t opcode)
     PUSH_REG(32, 5);
     PUSH_REG(64, 6);
     PUSH_REG(128, 7);
-    clockTicks += 1 + codeTicksAccess16(armNextPC);
-    reg[13].I = temp;
+    gbaCore.clockTicks += 1 + codeTicksAccess16(gbaCore.armNextPC);
+    gbaCore.reg[13].I = temp;
 }
 
 // PUSH {Rlist, LR}
 static INSN_REGPARM void thumbB5(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int count = 0;
-    uint32_t temp = reg[13].I - 4 - 4 * cpuBitsSet[opcode & 0xff];
+    uint32_t temp = gbaCore.reg[13].I - 4 - 4 * gbaCore.cpuBitsSet[opcode & 0xff];
     uint32_t address = temp & 0xFFFFFFFC;
     PUSH_REG(1, 0);
     PUSH_REG(2, 1);
@@ -1571,18 +1551,18 @@ static INSN_REGPARM void thumbB5(uint32_t opcode)
     PUSH_REG(64, 6);
     PUSH_REG(128, 7);
     PUSH_REG(256, 14);
-    clockTicks += 1 + codeTicksAccess16(armNextPC);
-    reg[13].I = temp;
+    gbaCore.clockTicks += 1 + codeTicksAccess16(gbaCore.armNextPC);
+    gbaCore.reg[13].I = temp;
 }
 
 // POP {Rlist}
 static INSN_REGPARM void thumbBC(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int count = 0;
-    uint32_t address = reg[13].I & 0xFFFFFFFC;
-    uint32_t temp = reg[13].I + 4 * cpuBitsSet[opcode & 0xFF];
+    uint32_t address = gbaCore.reg[13].I & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[13].I + 4 * gbaCore.cpuBitsSet[opcode & 0xFF];
     POP_REG(1, 0);
     POP_REG(2, 1);
     POP_REG(4, 2);
@@ -1591,18 +1571,18 @@ static INSN_REGPARM void thumbBC(uint32_t opcode)
     POP_REG(32, 5);
     POP_REG(64, 6);
     POP_REG(128, 7);
-    reg[13].I = temp;
-    clockTicks += 2 + codeTicksAccess16(armNextPC);
+    gbaCore.reg[13].I = temp;
+    gbaCore.clockTicks += 2 + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // POP {Rlist, PC}
 static INSN_REGPARM void thumbBD(uint32_t opcode)
 {
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
     int count = 0;
-    uint32_t address = reg[13].I & 0xFFFFFFFC;
-    uint32_t temp = reg[13].I + 4 + 4 * cpuBitsSet[opcode & 0xFF];
+    uint32_t address = gbaCore.reg[13].I & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[13].I + 4 + 4 * gbaCore.cpuBitsSet[opcode & 0xFF];
     POP_REG(1, 0);
     POP_REG(2, 1);
     POP_REG(4, 2);
@@ -1611,31 +1591,31 @@ static INSN_REGPARM void thumbBD(uint32_t opcode)
     POP_REG(32, 5);
     POP_REG(64, 6);
     POP_REG(128, 7);
-    reg[15].I = (CPUReadMemory(address) & 0xFFFFFFFE);
+    gbaCore.reg[15].I = (CPUReadMemory(address) & 0xFFFFFFFE);
     if (!count) {
-        clockTicks += 1 + dataTicksAccess32(address);
+        gbaCore.clockTicks += 1 + dataTicksAccess32(address);
     } else {
-        clockTicks += 1 + dataTicksAccessSeq32(address);
+        gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address);
     }
     count++;
-    armNextPC = reg[15].I;
-    reg[15].I += 2;
-    reg[13].I = temp;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 2;
+    gbaCore.reg[13].I = temp;
     THUMB_PREFETCH;
-    busPrefetchCount = 0;
-    clockTicks += 3 + (codeTicksAccess16(armNextPC) * 2);
+    gbaCore.busPrefetchCount = 0;
+    gbaCore.clockTicks += 3 + (codeTicksAccess16(gbaCore.armNextPC) * 2);
 }
 
 // Load/store multiple ////////////////////////////////////////////////////
 
 #define THUMB_STM_REG(val, r, b)                             \
     if (opcode & (val)) {                                    \
-        CPUWriteMemory(address, reg[(r)].I);                 \
-        reg[(b)].I = temp;                                   \
+        CPUWriteMemory(address, gbaCore.reg[(r)].I);                 \
+        gbaCore.reg[(b)].I = temp;                                   \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
         address += 4;                                        \
@@ -1643,11 +1623,11 @@ static INSN_REGPARM void thumbBD(uint32_t opcode)
 
 #define THUMB_LDM_REG(val, r)                                \
     if (opcode & (val)) {                                    \
-        reg[(r)].I = CPUReadMemory(address);                 \
+        gbaCore.reg[(r)].I = CPUReadMemory(address);                 \
         if (!count) {                                        \
-            clockTicks += 1 + dataTicksAccess32(address);    \
+            gbaCore.clockTicks += 1 + dataTicksAccess32(address);    \
         } else {                                             \
-            clockTicks += 1 + dataTicksAccessSeq32(address); \
+            gbaCore.clockTicks += 1 + dataTicksAccessSeq32(address); \
         }                                                    \
         count++;                                             \
         address += 4;                                        \
@@ -1657,10 +1637,10 @@ static INSN_REGPARM void thumbBD(uint32_t opcode)
 static INSN_REGPARM void thumbC0(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[regist].I & 0xFFFFFFFC;
-    uint32_t temp = reg[regist].I + 4 * cpuBitsSet[opcode & 0xff];
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[regist].I & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[regist].I + 4 * gbaCore.cpuBitsSet[opcode & 0xff];
     int count = 0;
     // store
     THUMB_STM_REG(1, 0, regist);
@@ -1671,17 +1651,17 @@ static INSN_REGPARM void thumbC0(uint32_t opcode)
     THUMB_STM_REG(32, 5, regist);
     THUMB_STM_REG(64, 6, regist);
     THUMB_STM_REG(128, 7, regist);
-    clockTicks += 1 + codeTicksAccess16(armNextPC);
+    gbaCore.clockTicks += 1 + codeTicksAccess16(gbaCore.armNextPC);
 }
 
 // LDM R0~R7!, {Rlist}
 static INSN_REGPARM void thumbC8(uint32_t opcode)
 {
     uint8_t regist = (opcode >> 8) & 7;
-    if (busPrefetchCount == 0)
-        busPrefetch = busPrefetchEnable;
-    uint32_t address = reg[regist].I & 0xFFFFFFFC;
-    uint32_t temp = reg[regist].I + 4 * cpuBitsSet[opcode & 0xFF];
+    if (gbaCore.busPrefetchCount == 0)
+        gbaCore.busPrefetch = gbaCore.busPrefetchEnable;
+    uint32_t address = gbaCore.reg[regist].I & 0xFFFFFFFC;
+    uint32_t temp = gbaCore.reg[regist].I + 4 * gbaCore.cpuBitsSet[opcode & 0xFF];
     int count = 0;
     // load
     THUMB_LDM_REG(1, 0);
@@ -1692,108 +1672,111 @@ static INSN_REGPARM void thumbC8(uint32_t opcode)
     THUMB_LDM_REG(32, 5);
     THUMB_LDM_REG(64, 6);
     THUMB_LDM_REG(128, 7);
-    clockTicks += 2 + codeTicksAccess16(armNextPC);
+    gbaCore.clockTicks += 2 + codeTicksAccess16(gbaCore.armNextPC);
     if (!(opcode & (1 << regist)))
-        reg[regist].I = temp;
+        gbaCore.reg[regist].I = temp;
 }
 
 // Conditional branches ///////////////////////////////////////////////////
 #define THUMB_CONDITIONAL_BRANCH(COND)                                  \
     UPDATE_OLDREG;                                                      \
-    clockTicks = codeTicksAccessSeq16(armNextPC) + 1;                   \
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) + 1;                   \
     if ((bool)COND) {                                                         \
         uint32_t offset = (uint32_t)((int8_t)(opcode & 0xFF)) << 1;     \
-        reg[15].I += offset;                                            \
-        armNextPC = reg[15].I;                                          \
-        reg[15].I += 2;                                                 \
+        gbaCore.reg[15].I += offset;                                            \
+        gbaCore.armNextPC = gbaCore.reg[15].I;                                          \
+        gbaCore.reg[15].I += 2;                                                 \
         THUMB_PREFETCH;                                                 \
-        clockTicks += codeTicksAccessSeq16(armNextPC)                   \
-            + codeTicksAccess16(armNextPC) + 2;                         \
-        busPrefetchCount = 0;                                           \
-    }
+        gbaCore.clockTicks += codeTicksAccessSeq16(gbaCore.armNextPC)                   \
+            + codeTicksAccess16(gbaCore.armNextPC) + 2;                         \
+        gbaCore.busPrefetchCount = 0;                                           \
+        if (opcode & 0x80)                                              \
+            cpuIdleLoopTaken(gbaCore.armNextPC - offset - 4, gbaCore.armNextPC);        \
+    } else                                                              \
+        cpuIdleLoopNotTaken(gbaCore.armNextPC - 2);
 
 // BEQ offset
 static INSN_REGPARM void thumbD0(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(Z_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.Z_FLAG);
 }
 
 // BNE offset
 static INSN_REGPARM void thumbD1(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(!Z_FLAG);
+    THUMB_CONDITIONAL_BRANCH(!gbaCore.Z_FLAG);
 }
 
 // BCS offset
 static INSN_REGPARM void thumbD2(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(C_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.C_FLAG);
 }
 
 // BCC offset
 static INSN_REGPARM void thumbD3(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(!C_FLAG);
+    THUMB_CONDITIONAL_BRANCH(!gbaCore.C_FLAG);
 }
 
 // BMI offset
 static INSN_REGPARM void thumbD4(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(N_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.N_FLAG);
 }
 
 // BPL offset
 static INSN_REGPARM void thumbD5(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(!N_FLAG);
+    THUMB_CONDITIONAL_BRANCH(!gbaCore.N_FLAG);
 }
 
 // BVS offset
 static INSN_REGPARM void thumbD6(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(V_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.V_FLAG);
 }
 
 // BVC offset
 static INSN_REGPARM void thumbD7(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(!V_FLAG);
+    THUMB_CONDITIONAL_BRANCH(!gbaCore.V_FLAG);
 }
 
 // BHI offset
 static INSN_REGPARM void thumbD8(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(C_FLAG && !Z_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.C_FLAG && !gbaCore.Z_FLAG);
 }
 
 // BLS offset
 static INSN_REGPARM void thumbD9(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(!C_FLAG || Z_FLAG);
+    THUMB_CONDITIONAL_BRANCH(!gbaCore.C_FLAG || gbaCore.Z_FLAG);
 }
 
 // BGE offset
 static INSN_REGPARM void thumbDA(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(N_FLAG == V_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.N_FLAG == gbaCore.V_FLAG);
 }
 
 // BLT offset
 static INSN_REGPARM void thumbDB(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(N_FLAG != V_FLAG);
+    THUMB_CONDITIONAL_BRANCH(gbaCore.N_FLAG != gbaCore.V_FLAG);
 }
 
 // BGT offset
 static INSN_REGPARM void thumbDC(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(!Z_FLAG && (N_FLAG == V_FLAG));
+    THUMB_CONDITIONAL_BRANCH(!gbaCore.Z_FLAG && (gbaCore.N_FLAG == gbaCore.V_FLAG));
 }
 
 // BLE offset
 static INSN_REGPARM void thumbDD(uint32_t opcode)
 {
-    THUMB_CONDITIONAL_BRANCH(Z_FLAG || (N_FLAG != V_FLAG));
+    THUMB_CONDITIONAL_BRANCH(gbaCore.Z_FLAG || (gbaCore.N_FLAG != gbaCore.V_FLAG));
 }
 
 // SWI, B, BL /////////////////////////////////////////////////////////////
@@ -1803,8 +1786,8 @@ static INSN_REGPARM void thumbDF(uint32_t opcode)
 {
     //uint32_t address = 0;
     //clockTicks = codeTicksAccessSeq16(address)*2 + codeTicksAccess16(address)+3;
-    clockTicks = 3;
-    busPrefetchCount = 0;
+    gbaCore.clockTicks = 3;
+    gbaCore.busPrefetchCount = 0;
     CPUSoftwareInterrupt(opcode & 0xFF);
 }
 
@@ -1814,12 +1797,14 @@ static INSN_REGPARM void thumbE0(uint32_t opcode)
     int offset = (opcode & 0x3FF) << 1;
     if (opcode & 0x0400)
         offset |= 0xFFFFF800;
-    reg[15].I += offset;
-    armNextPC = reg[15].I;
-    reg[15].I += 2;
+    gbaCore.reg[15].I += offset;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 2;
     THUMB_PREFETCH;
-    clockTicks = codeTicksAccessSeq16(armNextPC) * 2 + codeTicksAccess16(armNextPC) + 3;
-    busPrefetchCount = 0;
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2 + codeTicksAccess16(gbaCore.armNextPC) + 3;
+    gbaCore.busPrefetchCount = 0;
+    if (offset < 0)
+        cpuIdleLoopTaken(gbaCore.armNextPC - offset - 4, gbaCore.armNextPC);
 }
 
 static INSN_REGPARM void thumbE8(uint32_t opcode)
@@ -1828,7 +1813,7 @@ static INSN_REGPARM void thumbE8(uint32_t opcode)
     // TODO: This is (erroneously) used by some Wii U VC ROMs. We should have a configuration
     // toggle to enable the correct hardware behavior, which would be to call CPUUndefinedException.
     if (systemVerbose & VERBOSE_UNDEFINED)
-        log("Undefined Wii U THUMB instruction %04x at %08x (ignored)\n", opcode, armNextPC - 2);
+        log("Undefined Wii U THUMB instruction %04x at %08x (ignored)\n", opcode, gbaCore.armNextPC - 2);
 #endif
 }
 
@@ -1836,30 +1821,30 @@ static INSN_REGPARM void thumbE8(uint32_t opcode)
 static INSN_REGPARM void thumbF0(uint32_t opcode)
 {
     int offset = (opcode & 0x7FF);
-    reg[14].I = reg[15].I + (offset << 12);
-    clockTicks = codeTicksAccessSeq16(armNextPC) + 1;
+    gbaCore.reg[14].I = gbaCore.reg[15].I + (offset << 12);
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) + 1;
 }
 
 // BLL #offset (backward)
 static INSN_REGPARM void thumbF4(uint32_t opcode)
 {
     int offset = (opcode & 0x7FF);
-    reg[14].I = reg[15].I + ((offset << 12) | 0xFF800000);
-    clockTicks = codeTicksAccessSeq16(armNextPC) + 1;
+    gbaCore.reg[14].I = gbaCore.reg[15].I + ((offset << 12) | 0xFF800000);
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) + 1;
 }
 
 // BLH #offset
 static INSN_REGPARM void thumbF8(uint32_t opcode)
 {
     int offset = (opcode & 0x7FF);
-    uint32_t temp = reg[15].I - 2;
-    reg[15].I = (reg[14].I + (offset << 1)) & 0xFFFFFFFE;
-    armNextPC = reg[15].I;
-    reg[15].I += 2;
-    reg[14].I = temp | 1;
+    uint32_t temp = gbaCore.reg[15].I - 2;
+    gbaCore.reg[15].I = (gbaCore.reg[14].I + (offset << 1)) & 0xFFFFFFFE;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 2;
+    gbaCore.reg[14].I = temp | 1;
     THUMB_PREFETCH;
-    clockTicks = codeTicksAccessSeq16(armNextPC) * 2 + codeTicksAccess16(armNextPC) + 3;
-    busPrefetchCount = 0;
+    gbaCore.clockTicks = codeTicksAccessSeq16(gbaCore.armNextPC) * 2 + codeTicksAccess16(gbaCore.armNextPC) + 3;
+    gbaCore.busPrefetchCount = 0;
 }
 
 // Instruction table //////////////////////////////////////////////////////
@@ -1872,7 +1857,7 @@ typedef INSN_REGPARM void (*insnfunc_t)(uint32_t opcode);
 #define thumbBP thumbUnknownInsn
 #endif
 
-static insnfunc_t thumbInsnTable[1024] = {
+static constexpr insnfunc_t thumbInsnTable[1024] = {
     thumb00_00, thumb00_01, thumb00_02, thumb00_03, thumb00_04, thumb00_05, thumb00_06, thumb00_07, // 00
     thumb00_08, thumb00_09, thumb00_0A, thumb00_0B, thumb00_0C, thumb00_0D, thumb00_0E, thumb00_0F,
     thumb00_10, thumb00_11, thumb00_12, thumb00_13, thumb00_14, thumb00_15, thumb00_16, thumb00_17,
@@ -2005,92 +1990,228 @@ static insnfunc_t thumbInsnTable[1024] = {
 
 // Wrapper routine (execution loop) ///////////////////////////////////////
 
-int thumbExecute()
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+static inline insnfunc_t thumbDecode(uint32_t opcode)
 {
-    do {
-        if (coreOptions.cheatsEnabled) {
-            cpuMasterCodeCheck();
-        }
+    return thumbInsnTable[opcode >> 6];
+}
 
-        //if ((armNextPC & 0x0803FFFF) == 0x08020000)
-        //    busPrefetchCount=0x100;
+// Prefetches the opcode at `address`, decoding it into the cache on a miss.
+static inline uint32_t thumbDecodeCacheFetch(uint32_t address)
+{
+    DecodedInsn& insn = thumbDecodeCacheEntry(address);
+    if (insn.address == address)
+        return insn.opcode;
 
-        uint32_t opcode = cpuPrefetch[0];
-        cpuPrefetch[0] = cpuPrefetch[1];
+    uint32_t opcode = CPUReadHalfWordQuick(address);
+    if (cpuDecodeCacheable(address)) {
+        insn.address = address;
+        insn.opcode = opcode;
+        insn.handler = thumbDecode(opcode);
+    }
+    return opcode;
+}
 
-        busPrefetch = false;
-        if (busPrefetchCount & 0xFFFFFF00)
-            busPrefetchCount = 0x100 | (busPrefetchCount & 0xFF);
-        clockTicks = 0;
-        uint32_t oldArmNextPC = armNextPC;
+// The pipeline may also be refilled by THUMB_PREFETCH, bypassing the cache,
+// so the cached handler is only used if the opcode matches.
+static inline insnfunc_t thumbDecodeCacheHandler(uint32_t address, uint32_t opcode)
+{
+    const DecodedInsn& insn = thumbDecodeCacheEntry(address);
+    if (insn.address == address && insn.opcode == opcode)
+        return insn.handler;
+    return thumbDecode(opcode);
+}
+#endif  // defined(VBAM_ENABLE_DECODE_CACHE)
+
+// Moves the pipeline to the next instruction and returns its opcode.
+// Returns false if a debugger breakpoint stops the execution first.
+static VBAM_FORCE_INLINE bool thumbFetch(uint32_t& opcode, uint32_t& oldArmNextPC)
+{
+    //if ((armNextPC & 0x0803FFFF) == 0x08020000)
+    //    busPrefetchCount=0x100;
+
+    opcode = gbaCore.cpuPrefetch[0];
+    gbaCore.cpuPrefetch[0] = gbaCore.cpuPrefetch[1];
+
+    gbaCore.busPrefetch = false;
+    if (gbaCore.busPrefetchCount & 0xFFFFFF00)
+        gbaCore.busPrefetchCount = 0x100 | (gbaCore.busPrefetchCount & 0xFF);
+    gbaCore.clockTicks = 0;
+    oldArmNextPC = gbaCore.armNextPC;
 
 #ifndef FINAL_VERSION
-        if (armNextPC == stop) {
-            armNextPC++;
-        }
+    if (gbaCore.armNextPC == gbaCore.stop) {
+        gbaCore.armNextPC++;
+    }
 #endif
 
-        armNextPC = reg[15].I;
-        reg[15].I += 2;
-        THUMB_PREFETCH_NEXT;
+    gbaCore.armNextPC = gbaCore.reg[15].I;
+    gbaCore.reg[15].I += 2;
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+    gbaCore.cpuPrefetch[1] = thumbDecodeCacheFetch(gbaCore.armNextPC + 2);
+#else
+    THUMB_PREFETCH_NEXT;
+#endif
 
 #ifdef VBAM_ENABLE_DEBUGGER
-        uint32_t memAddr = armNextPC;
-        memoryMap* m = &map[memAddr >> 24];
-        if (m->breakPoints && BreakThumbCheck(m->breakPoints, memAddr & m->mask)) {
-            if (debuggerBreakOnExecution(memAddr, armState)) {
-                // Revert tickcount?
-                debugger = true;
-                return 0;
-            }
+    uint32_t memAddr = gbaCore.armNextPC;
+    memoryMap* m = &gbaCore.map[memAddr >> 24];
+    if (m->breakPoints && BreakThumbCheck(m->breakPoints, memAddr & m->mask)) {
+        if (debuggerBreakOnExecution(memAddr, gbaCore.armState)) {
+            // Revert tickcount?
+            gbaCore.debugger = true;
+            return false;
         }
+    }
 #endif
+    return true;
+}
 
-        (*thumbInsnTable[opcode >> 6])(opcode);
-
+// Accounts for the cycles of the instruction that just ran.
+// Returns false if the execution must stop.
+static VBAM_FORCE_INLINE bool thumbRetire(uint32_t oldArmNextPC)
+{
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (enableRegBreak) {
-            if (lowRegBreakCounter[0])
-                breakReg_check(0);
-            if (lowRegBreakCounter[1])
-                breakReg_check(1);
-            if (lowRegBreakCounter[2])
-                breakReg_check(2);
-            if (lowRegBreakCounter[3])
-                breakReg_check(3);
-            if (medRegBreakCounter[0])
-                breakReg_check(4);
-            if (medRegBreakCounter[1])
-                breakReg_check(5);
-            if (medRegBreakCounter[2])
-                breakReg_check(6);
-            if (medRegBreakCounter[3])
-                breakReg_check(7);
-            if (highRegBreakCounter[0])
-                breakReg_check(8);
-            if (highRegBreakCounter[1])
-                breakReg_check(9);
-            if (highRegBreakCounter[2])
-                breakReg_check(10);
-            if (highRegBreakCounter[3])
-                breakReg_check(11);
-            if (statusRegBreakCounter[0])
-                breakReg_check(12);
-            if (statusRegBreakCounter[1])
-                breakReg_check(13);
-            if (statusRegBreakCounter[2])
-                breakReg_check(14);
-            if (statusRegBreakCounter[3])
-                breakReg_check(15);
+    if (enableRegBreak) {
+        if (lowRegBreakCounter[0])
+            breakReg_check(0);
+        if (lowRegBreakCounter[1])
+            breakReg_check(1);
+        if (lowRegBreakCounter[2])
+            breakReg_check(2);
+        if (lowRegBreakCounter[3])
+            breakReg_check(3);
+        if (medRegBreakCounter[0])
+            breakReg_check(4);
+        if (medRegBreakCounter[1])
+            breakReg_check(5);
+        if (medRegBreakCounter[2])
+            breakReg_check(6);
+        if (medRegBreakCounter[3])
+            breakReg_check(7);
+        if (highRegBreakCounter[0])
+            breakReg_check(8);
+        if (highRegBreakCounter[1])
+            breakReg_check(9);
+        if (highRegBreakCounter[2])
+            breakReg_check(10);
+        if (highRegBreakCounter[3])
+            breakReg_check(11);
+        if (statusRegBreakCounter[0])
+            breakReg_check(12);
+        if (statusRegBreakCounter[1])
+            breakReg_check(13);
+        if (statusRegBreakCounter[2])
+            breakReg_check(14);
+        if (statusRegBreakCounter[3])
+            breakReg_check(15);
+    }
+#endif
+
+    if (gbaCore.clockTicks < 0)
+        return false;
+    if (gbaCore.clockTicks == 0)
+        gbaCore.clockTicks = codeTicksAccessSeq16(oldArmNextPC) + 1;
+    gbaCore.cpuTotalTicks += gbaCore.clockTicks;
+    return true;
+}
+
+static inline bool thumbKeepRunning()
+{
+    return gbaCore.cpuTotalTicks < gbaCore.cpuNextEvent && !gbaCore.armState && !gbaCore.holdState && !gbaCore.SWITicks && !gbaCore.debugger;
+}
+
+#if defined(VBAM_ENABLE_THREADED_DISPATCH)
+// Threaded dispatch: every handler is wrapped in a function that retires the
+// instruction and jumps to the wrapper of the next one, so that each
+// instruction has its own indirect branch for the host predictor to learn
+// from. The chain unwinds back to CPULoop once the next event is reached.
+
+typedef int (*threadedfunc_t)(uint32_t opcode, uint32_t oldArmNextPC);
+
+static VBAM_FORCE_INLINE int thumbThreadedDispatch(uint32_t, uint32_t);
+
+template <insnfunc_t handler>
+VBAM_NO_ICF static int thumbThreaded(uint32_t opcode, uint32_t oldArmNextPC)
+{
+    handler(opcode);
+    if (!thumbRetire(oldArmNextPC))
+        return 0;
+    if (!thumbKeepRunning())
+        return 1;
+    VBAM_MUSTTAIL return thumbThreadedDispatch(opcode, oldArmNextPC);
+}
+
+template <size_t... index>
+static constexpr std::array<threadedfunc_t, sizeof...(index)> thumbThreadedTableFor(std::index_sequence<index...>)
+{
+    return {{ &thumbThreaded<thumbInsnTable[index]>... }};
+}
+
+static constexpr std::array<threadedfunc_t, 1024> thumbThreadedTable =
+    thumbThreadedTableFor(std::make_index_sequence<1024>());
+
+// Inlined in every wrapper, so each one ends with its own indirect jump. The
+// unused arguments give every function in the chain the same signature, which
+// guaranteed tail calls require.
+static VBAM_FORCE_INLINE int thumbThreadedDispatch(uint32_t, uint32_t)
+{
+    for (;;) {
+        if (coreOptions.cheatsEnabled) {
+            cpuMasterCodeCheck();
+        }
+
+#if defined(VBAM_ENABLE_JIT)
+        if (thumbJitExecute()) {
+            if (thumbKeepRunning())
+                continue;
+            return 1;
+        }
+#endif
+
+        uint32_t opcode;
+        uint32_t oldArmNextPC;
+        if (!thumbFetch(opcode, oldArmNextPC))
+            return 0;
+
+        VBAM_MUSTTAIL return thumbThreadedTable[opcode >> 6](opcode, oldArmNextPC);
+    }
+}
+
+int thumbExecute()
+{
+    return thumbThreadedDispatch(0, 0);
+}
+
+#else  // !defined(VBAM_ENABLE_THREADED_DISPATCH)
+
+int thumbExecute()
+{
+    do {
+        if (coreOptions.cheatsEnabled) {
+            cpuMasterCodeCheck();
         }
+
+#if defined(VBAM_ENABLE_JIT)
+        if (thumbJitExecute())
+            continue;
 #endif
 
-        if (clockTicks < 0)
+        uint32_t opcode;
+        uint32_t oldArmNextPC;
+        if (!thumbFetch(opcode, oldArmNextPC))
             return 0;
-        if (clockTicks == 0)
-            clockTicks = codeTicksAccessSeq16(oldArmNextPC) + 1;
-        cpuTotalTicks += clockTicks;
 
-    } while (cpuTotalTicks < cpuNextEvent && !armState && !holdState && !SWITicks && !debugger);
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+        (*thumbDecodeCacheHandler(gbaCore.armNextPC, opcode))(opcode);
+#else
+        (*thumbInsnTable[opcode >> 6])(opcode);
+#endif
+
+        if (!thumbRetire(oldArmNextPC))
+            return 0;
+    } while (thumbKeepRunning());
     return 1;
 }
+
+#endif  // defined(VBAM_ENABLE_THREADED_DISPATCH)
@@ -1,89 +1,81 @@
 #include "core/gba/gbaEeprom.h"
 
 #include <cstring>
+#include <vector>
 
 #include "core/base/file_util.h"
 #include "core/gba/gba.h"
+#include "core/gba/gbaCore.h"
 
-extern int cpuDmaCount;
-
-int eepromMode = EEPROM_IDLE;
-int eepromByte = 0;
-int eepromBits = 0;
-int eepromAddress = 0;
-
-uint8_t eepromData[SIZE_EEPROM_8K];
-
-uint8_t eepromBuffer[16];
-bool eepromInUse = false;
-int eepromSize = SIZE_EEPROM_512;
-
-variable_desc eepromSaveData[] = {
-    { &eepromMode, sizeof(int) },
-    { &eepromByte, sizeof(int) },
-    { &eepromBits, sizeof(int) },
-    { &eepromAddress, sizeof(int) },
-    { &eepromInUse, sizeof(bool) },
-    { &eepromData[0], SIZE_EEPROM_512 },
-    { &eepromBuffer[0], 16 },
-    { NULL, 0 }
-};
+static std::vector<variable_desc> eepromSaveData()
+{
+    return {
+        { &gbaCore.eepromMode, sizeof(int) },
+        { &gbaCore.eepromByte, sizeof(int) },
+        { &gbaCore.eepromBits, sizeof(int) },
+        { &gbaCore.eepromAddress, sizeof(int) },
+        { &gbaCore.eepromInUse, sizeof(bool) },
+        { &gbaCore.eepromData[0], SIZE_EEPROM_512 },
+        { &gbaCore.eepromBuffer[0], 16 },
+        { NULL, 0 }
+    };
+}
 
 void eepromInit()
 {
-    eepromInUse = false;
-    eepromSize = SIZE_EEPROM_512;
-    memset(eepromData, 255, sizeof(eepromData));
+    gbaCore.eepromInUse = false;
+    gbaCore.eepromSize = SIZE_EEPROM_512;
+    memset(gbaCore.eepromData, 255, sizeof(gbaCore.eepromData));
 }
 
 void eepromReset()
 {
-    eepromMode = EEPROM_IDLE;
-    eepromByte = 0;
-    eepromBits = 0;
-    eepromAddress = 0;
+    gbaCore.eepromMode = EEPROM_IDLE;
+    gbaCore.eepromByte = 0;
+    gbaCore.eepromBits = 0;
+    gbaCore.eepromAddress = 0;
 }
 
 #ifdef __LIBRETRO__
 void eepromSaveGame(uint8_t*& data)
 {
-    utilWriteDataMem(data, eepromSaveData);
-    utilWriteIntMem(data, eepromSize);
-    utilWriteMem(data, eepromData, SIZE_EEPROM_8K);
+    utilWriteDataMem(data, eepromSaveData().data());
+    utilWriteIntMem(data, gbaCore.eepromSize);
+    utilWriteMem(data, gbaCore.eepromData, SIZE_EEPROM_8K);
 }
 
 void eepromReadGame(const uint8_t*& data)
 {
-    utilReadDataMem(data, eepromSaveData);
-    eepromSize = utilReadIntMem(data);
-    utilReadMem(eepromData, data, SIZE_EEPROM_8K);
+    utilReadDataMem(data, eepromSaveData().data());
+    gbaCore.eepromSize = utilReadIntMem(data);
+    utilReadMem(gbaCore.eepromData, data, SIZE_EEPROM_8K);
 }
 
 #else // !__LIBRETRO__
 
 void eepromSaveGame(gzFile gzFile)
 {
-    utilWriteData(gzFile, eepromSaveData);
-    utilWriteInt(gzFile, eepromSize);
-    utilGzWrite(gzFile, eepromData, SIZE_EEPROM_8K);
+    utilWriteData(gzFile, eepromSaveData().data());
+    utilWriteInt(gzFile, gbaCore.eepromSize);
+    utilGzWrite(gzFile, gbaCore.eepromData, SIZE_EEPROM_8K);
 }
 
 void eepromReadGame(gzFile gzFile, int version)
 {
-    utilReadData(gzFile, eepromSaveData);
+    utilReadData(gzFile, eepromSaveData().data());
     if (version >= SAVE_GAME_VERSION_3) {
-        eepromSize = utilReadInt(gzFile);
-        utilGzRead(gzFile, eepromData, SIZE_EEPROM_8K);
+        gbaCore.eepromSize = utilReadInt(gzFile);
+        utilGzRead(gzFile, gbaCore.eepromData, SIZE_EEPROM_8K);
     } else {
         // prior to 0.7.1, only 4K EEPROM was supported
-        eepromSize = SIZE_EEPROM_512;
+        gbaCore.eepromSize = SIZE_EEPROM_512;
     }
 }
 
 void eepromReadGameSkip(gzFile gzFile, int version)
 {
     // skip the eeprom data in a save game
-    utilReadDataSkip(gzFile, eepromSaveData);
+    utilReadDataSkip(gzFile, eepromSaveData().data());
     if (version >= SAVE_GAME_VERSION_3) {
         utilGzSeek(gzFile, sizeof(int), SEEK_CUR);
         utilGzSeek(gzFile, SIZE_EEPROM_8K, SEEK_CUR);
@@ -93,29 +85,29 @@ void eepromReadGameSkip(gzFile gzFile, int version)
 
 int eepromRead(uint32_t /* address */)
 {
-    switch (eepromMode) {
+    switch (gbaCore.eepromMode) {
     case EEPROM_IDLE:
     case EEPROM_READADDRESS:
     case EEPROM_WRITEDATA:
         return 1;
     case EEPROM_READDATA: {
-        eepromBits++;
-        if (eepromBits == 4) {
-            eepromMode = EEPROM_READDATA2;
-            eepromBits = 0;
-            eepromByte = 0;
+        gbaCore.eepromBits++;
+        if (gbaCore.eepromBits == 4) {
+            gbaCore.eepromMode = EEPROM_READDATA2;
+            gbaCore.eepromBits = 0;
+            gbaCore.eepromByte = 0;
         }
         return 0;
     }
     case EEPROM_READDATA2: {
-        int address = eepromAddress << 3;
-        int mask = 1 << (7 - (eepromBits & 7));
-        int data = (eepromData[address + eepromByte] & mask) ? 1 : 0;
-        eepromBits++;
-        if ((eepromBits & 7) == 0)
-            eepromByte++;
-        if (eepromBits == 0x40)
-            eepromMode = EEPROM_IDLE;
+        int address = gbaCore.eepromAddress << 3;
+        int mask = 1 << (7 - (gbaCore.eepromBits & 7));
+        int data = (gbaCore.eepromData[address + gbaCore.eepromByte] & mask) ? 1 : 0;
+        gbaCore.eepromBits++;
+        if ((gbaCore.eepromBits & 7) == 0)
+            gbaCore.eepromByte++;
+        if (gbaCore.eepromBits == 0x40)
+            gbaCore.eepromMode = EEPROM_IDLE;
         return data;
     }
     default:
@@ -126,52 +118,52 @@ int eepromRead(uint32_t /* address */)
 
 void eepromWrite(uint32_t /* address */, uint8_t value)
 {
-    if (cpuDmaCount == 0)
+    if (gbaCore.cpuDmaCount == 0)
         return;
     int bit = value & 1;
-    switch (eepromMode) {
+    switch (gbaCore.eepromMode) {
     case EEPROM_IDLE:
-        eepromByte = 0;
-        eepromBits = 1;
-        eepromBuffer[eepromByte] = bit;
-        eepromMode = EEPROM_READADDRESS;
+        gbaCore.eepromByte = 0;
+        gbaCore.eepromBits = 1;
+        gbaCore.eepromBuffer[gbaCore.eepromByte] = bit;
+        gbaCore.eepromMode = EEPROM_READADDRESS;
         break;
     case EEPROM_READADDRESS:
-        eepromBuffer[eepromByte] <<= 1;
-        eepromBuffer[eepromByte] |= bit;
-        eepromBits++;
-        if ((eepromBits & 7) == 0) {
-            eepromByte++;
+        gbaCore.eepromBuffer[gbaCore.eepromByte] <<= 1;
+        gbaCore.eepromBuffer[gbaCore.eepromByte] |= bit;
+        gbaCore.eepromBits++;
+        if ((gbaCore.eepromBits & 7) == 0) {
+            gbaCore.eepromByte++;
         }
-        if (cpuDmaCount == 0x11 || cpuDmaCount == 0x51) {
-            if (eepromBits == 0x11) {
-                eepromInUse = true;
-                eepromSize = SIZE_EEPROM_8K;
-                eepromAddress = ((eepromBuffer[0] & 0x3F) << 8) | ((eepromBuffer[1] & 0xFF));
-                if (!(eepromBuffer[0] & 0x40)) {
-                    eepromBuffer[0] = bit;
-                    eepromBits = 1;
-                    eepromByte = 0;
-                    eepromMode = EEPROM_WRITEDATA;
+        if (gbaCore.cpuDmaCount == 0x11 || gbaCore.cpuDmaCount == 0x51) {
+            if (gbaCore.eepromBits == 0x11) {
+                gbaCore.eepromInUse = true;
+                gbaCore.eepromSize = SIZE_EEPROM_8K;
+                gbaCore.eepromAddress = ((gbaCore.eepromBuffer[0] & 0x3F) << 8) | ((gbaCore.eepromBuffer[1] & 0xFF));
+                if (!(gbaCore.eepromBuffer[0] & 0x40)) {
+                    gbaCore.eepromBuffer[0] = bit;
+                    gbaCore.eepromBits = 1;
+                    gbaCore.eepromByte = 0;
+                    gbaCore.eepromMode = EEPROM_WRITEDATA;
                 } else {
-                    eepromMode = EEPROM_READDATA;
-                    eepromByte = 0;
-                    eepromBits = 0;
+                    gbaCore.eepromMode = EEPROM_READDATA;
+                    gbaCore.eepromByte = 0;
+                    gbaCore.eepromBits = 0;
                 }
             }
         } else {
-            if (eepromBits == 9) {
-                eepromInUse = true;
-                eepromAddress = (eepromBuffer[0] & 0x3F);
-                if (!(eepromBuffer[0] & 0x40)) {
-                    eepromBuffer[0] = bit;
-                    eepromBits = 1;
-                    eepromByte = 0;
-                    eepromMode = EEPROM_WRITEDATA;
+            if (gbaCore.eepromBits == 9) {
+                gbaCore.eepromInUse = true;
+                gbaCore.eepromAddress = (gbaCore.eepromBuffer[0] & 0x3F);
+                if (!(gbaCore.eepromBuffer[0] & 0x40)) {
+                    gbaCore.eepromBuffer[0] = bit;
+                    gbaCore.eepromBits = 1;
+                    gbaCore.eepromByte = 0;
+                    gbaCore.eepromMode = EEPROM_WRITEDATA;
                 } else {
-                    eepromMode = EEPROM_READDATA;
-                    eepromByte = 0;
-                    eepromBits = 0;
+                    gbaCore.eepromMode = EEPROM_READDATA;
+                    gbaCore.eepromByte = 0;
+                    gbaCore.eepromBits = 0;
                 }
             }
         }
@@ -179,26 +171,26 @@ void eepromWrite(uint32_t /* address */, uint8_t value)
     case EEPROM_READDATA:
     case EEPROM_READDATA2:
         // should we reset here?
-        eepromMode = EEPROM_IDLE;
+        gbaCore.eepromMode = EEPROM_IDLE;
         break;
     case EEPROM_WRITEDATA:
-        eepromBuffer[eepromByte] <<= 1;
-        eepromBuffer[eepromByte] |= bit;
-        eepromBits++;
-        if ((eepromBits & 7) == 0) {
-            eepromByte++;
+        gbaCore.eepromBuffer[gbaCore.eepromByte] <<= 1;
+        gbaCore.eepromBuffer[gbaCore.eepromByte] |= bit;
+        gbaCore.eepromBits++;
+        if ((gbaCore.eepromBits & 7) == 0) {
+            gbaCore.eepromByte++;
         }
-        if (eepromBits == 0x40) {
-            eepromInUse = true;
+        if (gbaCore.eepromBits == 0x40) {
+            gbaCore.eepromInUse = true;
             // write data;
             for (int i = 0; i < 8; i++) {
-                eepromData[(eepromAddress << 3) + i] = eepromBuffer[i];
+                gbaCore.eepromData[(gbaCore.eepromAddress << 3) + i] = gbaCore.eepromBuffer[i];
             }
             systemSaveUpdateCounter = SYSTEM_SAVE_UPDATED;
-        } else if (eepromBits == 0x41) {
-            eepromMode = EEPROM_IDLE;
-            eepromByte = 0;
-            eepromBits = 0;
+        } else if (gbaCore.eepromBits == 0x41) {
+            gbaCore.eepromMode = EEPROM_IDLE;
+            gbaCore.eepromByte = 0;
+            gbaCore.eepromBits = 0;
         }
         break;
     }
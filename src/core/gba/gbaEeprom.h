@@ -7,6 +7,8 @@
 #include <zlib.h>
 #endif  // defined(__LIBRETRO__)
 
+#include "core/base/system.h"
+
 #if defined(__LIBRETRO__)
 extern void eepromSaveGame(uint8_t*& data);
 extern void eepromReadGame(const uint8_t*& data);
@@ -15,13 +17,10 @@ extern void eepromSaveGame(gzFile _gzFile);
 extern void eepromReadGame(gzFile _gzFile, int version);
 extern void eepromReadGameSkip(gzFile _gzFile, int version);
 #endif  // defined(__LIBRETRO__)
-extern uint8_t eepromData[0x2000];
 extern int eepromRead(uint32_t address);
 extern void eepromWrite(uint32_t address, uint8_t value);
 extern void eepromInit();
 extern void eepromReset();
-extern bool eepromInUse;
-extern int eepromSize;
 
 #define EEPROM_IDLE 0
 #define EEPROM_READADDRESS 1
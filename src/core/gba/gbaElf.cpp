@@ -10,7 +10,7 @@
 #include "core/gba/gbaGlobals.h"
 
 #define elfReadMemory(addr) \
-    READ32LE((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ32LE((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define DW_TAG_array_type 0x01
 #define DW_TAG_enumeration_type 0x04
@@ -628,7 +628,7 @@ void elfPrintCallChain(uint32_t address)
     reg_pair regs[15];
     reg_pair newRegs[15];
 
-    memcpy(&regs[0], &reg[0], sizeof(reg_pair) * 15);
+    memcpy(&regs[0], &gbaCore.reg[0], sizeof(reg_pair) * 15);
 
     while (count < 20) {
         const char* addr = elfGetAddressSymbol(address);
@@ -714,7 +714,7 @@ uint32_t elfDecodeLocation(Function* f, ELFBlock* o, LocationType* type, uint32_
         case DW_OP_reg13:
         case DW_OP_reg14:
         case DW_OP_reg15:
-            framebase = reg[*b->data - 0x50].I;
+            framebase = gbaCore.reg[*b->data - 0x50].I;
             break;
         default:
             fprintf(stderr, "Unknown frameBase %02x\n", *b->data);
@@ -2576,14 +2576,14 @@ bool elfReadProgram(ELFHeader* eh, uint8_t* data, unsigned long data_size, int&
             unsigned effective_address = address - 0x2000000;
 
             if (effective_address + section_size < SIZE_WRAM) {
-                memcpy(&g_workRAM[effective_address], source, section_size);
+                memcpy(&gbaCore.g_workRAM[effective_address], source, section_size);
                 size += section_size;
             }
         } else {
             unsigned effective_address = address - 0x8000000;
 
             if (effective_address + section_size < SIZE_ROM) {
-                memcpy(&g_rom[effective_address], source, section_size);
+                memcpy(&gbaCore.g_rom[effective_address], source, section_size);
                 size += section_size;
             }
         }
@@ -2625,13 +2625,13 @@ bool elfReadProgram(ELFHeader* eh, uint8_t* data, unsigned long data_size, int&
         if (READ32LE(&sh[i]->flags) & 2) { // load section
             if (coreOptions.cpuIsMultiBoot) {
                 if (READ32LE(&sh[i]->addr) >= 0x2000000 && READ32LE(&sh[i]->addr) <= 0x203ffff) {
-                    memcpy(&g_workRAM[READ32LE(&sh[i]->addr) & 0x3ffff], data + READ32LE(&sh[i]->offset),
+                    memcpy(&gbaCore.g_workRAM[READ32LE(&sh[i]->addr) & 0x3ffff], data + READ32LE(&sh[i]->offset),
                         READ32LE(&sh[i]->size));
                     size += READ32LE(&sh[i]->size);
                 }
             } else {
                 if (READ32LE(&sh[i]->addr) >= 0x8000000 && READ32LE(&sh[i]->addr) <= 0x9ffffff) {
-                    memcpy(&g_rom[READ32LE(&sh[i]->addr) & 0x1ffffff],
+                    memcpy(&gbaCore.g_rom[READ32LE(&sh[i]->addr) & 0x1ffffff],
                         data + READ32LE(&sh[i]->offset),
                         READ32LE(&sh[i]->size));
                     size += READ32LE(&sh[i]->size);
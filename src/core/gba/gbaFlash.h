@@ -7,8 +7,21 @@
 #include <zlib.h>
 #endif  // defined(__LIBRETRO__)
 
+#include "core/base/system.h"
+
 #define FLASH_128K_SZ 0x20000
 
+#define FLASH_READ_ARRAY 0
+#define FLASH_CMD_1 1
+#define FLASH_CMD_2 2
+#define FLASH_AUTOSELECT 3
+#define FLASH_CMD_3 4
+#define FLASH_CMD_4 5
+#define FLASH_CMD_5 6
+#define FLASH_ERASE_COMPLETE 7
+#define FLASH_PROGRAM 8
+#define FLASH_SETBANK 9
+
 void flashDetectSaveType(const int size);
 
 #if defined(__LIBRETRO__)
@@ -19,7 +32,6 @@ extern void flashSaveGame(gzFile _gzFile);
 extern void flashReadGame(gzFile _gzFile, int version);
 extern void flashReadGameSkip(gzFile _gzFile, int version);
 #endif  // defined(__LIBRETRO__)
-extern uint8_t flashSaveMemory[FLASH_128K_SZ];
 extern uint8_t flashRead(uint32_t address);
 extern void flashWrite(uint32_t address, uint8_t byte);
 extern void flashDelayedWrite(uint32_t address, uint8_t byte);
@@ -28,6 +40,4 @@ extern void flashReset();
 extern void flashSetSize(int size);
 extern void flashInit();
 
-extern int g_flashSize;
-
 #endif // VBAM_CORE_GBA_GBAFLASH_H_
@@ -9,26 +9,6 @@ int g_coeff[32] = {
     16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16
 };
 
-uint32_t g_line0[240];
-uint32_t g_line1[240];
-uint32_t g_line2[240];
-uint32_t g_line3[240];
-uint32_t g_lineOBJ[240];
-uint32_t g_lineOBJWin[240];
-uint32_t g_lineMix[240];
-bool gfxInWin0[240];
-bool gfxInWin1[240];
-int lineOBJpixleft[128];
-
-int gfxBG2Changed = 0;
-int gfxBG3Changed = 0;
-
-int gfxBG2X = 0;
-int gfxBG2Y = 0;
-int gfxBG3X = 0;
-int gfxBG3Y = 0;
-int gfxLastVCOUNT = 0;
-
 #ifdef TILED_RENDERING
 #ifdef _MSC_VER
 union uint8_th
@@ -179,9 +159,9 @@ template <TileReader readTile>
 static void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t vofs,
     uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
-    uint8_t* charBase = &g_vram[((control >> 2) & 0x03) * 0x4000];
-    uint16_t* screenBase = (uint16_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+    uint16_t* palette = (uint16_t*)gbaCore.g_paletteRAM;
+    uint8_t* charBase = &gbaCore.g_vram[((control >> 2) & 0x03) * 0x4000];
+    uint16_t* screenBase = (uint16_t*)&gbaCore.g_vram[((control >> 8) & 0x1f) * 0x800];
     uint32_t prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 256;
     int sizeY = 256;
@@ -206,13 +186,13 @@ static void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t vofs,
     bool mosaicOn = (control & 0x40) ? true : false;
 
     int xxx = hofs & maskX;
-    int yyy = (vofs + VCOUNT) & maskY;
-    int mosaicX = (MOSAIC & 0x000F) + 1;
-    int mosaicY = ((MOSAIC & 0x00F0) >> 4) + 1;
+    int yyy = (vofs + gbaCore.VCOUNT) & maskY;
+    int mosaicX = (gbaCore.MOSAIC & 0x000F) + 1;
+    int mosaicY = ((gbaCore.MOSAIC & 0x00F0) >> 4) + 1;
 
     if (mosaicOn) {
-        if ((VCOUNT % mosaicY) != 0) {
-            mosaicY = VCOUNT - (VCOUNT % mosaicY);
+        if ((gbaCore.VCOUNT % mosaicY) != 0) {
+            mosaicY = gbaCore.VCOUNT - (gbaCore.VCOUNT % mosaicY);
             yyy = (vofs + mosaicY) & maskY;
         }
     }
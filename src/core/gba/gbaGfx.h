@@ -4,8 +4,12 @@
 #include <cstdint>
 #include <cstddef>
 
+#include "core/base/line_writer.h"
 #include "core/base/port.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaAffine.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
+#include "core/gba/internal/gbaTileCache.h"
 
 //#define SPRITE_DEBUG
 
@@ -14,62 +18,34 @@ extern void gfxDrawTextScreen(uint16_t, uint16_t, uint16_t, uint32_t*);
 #else
 static void gfxDrawTextScreen(uint16_t, uint16_t, uint16_t, uint32_t*);
 #endif
-static void gfxDrawRotScreen(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int&, int&, int, uint32_t*);
-static void gfxDrawRotScreen16Bit(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int&, int&, int,
+static void gfxDrawRotScreen(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int, int, uint32_t*);
+static void gfxDrawRotScreen16Bit(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int, int,
     uint32_t*);
-static void gfxDrawRotScreen256(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int&, int&, int,
+static void gfxDrawRotScreen256(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int, int,
     uint32_t*);
-static void gfxDrawRotScreen16Bit160(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int&, int&, int,
+static void gfxDrawRotScreen16Bit160(uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, int, int,
     uint32_t*);
 static void gfxDrawSprites(uint32_t*);
 static void gfxIncreaseBrightness(uint32_t* line, int coeff);
 static void gfxDecreaseBrightness(uint32_t* line, int coeff);
 static void gfxAlphaBlend(uint32_t* ta, uint32_t* tb, int ca, int cb);
 
-void mode0RenderLine();
-void mode0RenderLineNoWindow();
-void mode0RenderLineAll();
-
-void mode1RenderLine();
-void mode1RenderLineNoWindow();
-void mode1RenderLineAll();
-
-void mode2RenderLine();
-void mode2RenderLineNoWindow();
-void mode2RenderLineAll();
-
-void mode3RenderLine();
-void mode3RenderLineNoWindow();
-void mode3RenderLineAll();
-
-void mode4RenderLine();
-void mode4RenderLineNoWindow();
-void mode4RenderLineAll();
-
-void mode5RenderLine();
-void mode5RenderLineNoWindow();
-void mode5RenderLineAll();
+// Scanline renderers, specialised for the display mode and for whether colour
+// special effects, WIN0/WIN1 and the OBJ window are in use.
+template <int mode, bool fx, bool window, bool objWindow>
+void gfxRenderLine();
+void (*gfxGetRenderLine(int mode, bool fx, bool window, bool objWindow))();
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+// Only carries the state of gfxRenderLine<mode>() over to the next line.
+void (*gfxGetSkipLine(int mode))();
+#endif
+// Stores g_lineMix as `line` of the frame buffer `pix`, and updates its hash
+// in `hashes`.
+void gfxWriteLine(uint8_t* pix, LineWriterHashes& hashes, int line);
 
 extern int g_coeff[32];
-extern uint32_t g_line0[240];
-extern uint32_t g_line1[240];
-extern uint32_t g_line2[240];
-extern uint32_t g_line3[240];
-extern uint32_t g_lineOBJ[240];
-extern uint32_t g_lineOBJWin[240];
-extern uint32_t g_lineMix[240];
-extern bool gfxInWin0[240];
-extern bool gfxInWin1[240];
-extern int lineOBJpixleft[128];
-
-extern int gfxBG2Changed;
-extern int gfxBG3Changed;
-
-extern int gfxBG2X;
-extern int gfxBG2Y;
-extern int gfxBG3X;
-extern int gfxBG3Y;
-extern int gfxLastVCOUNT;
+
+// coreOptions.layerEnable for the line being drawn.
 
 static inline void gfxClearArray(uint32_t* array)
 {
@@ -81,9 +57,9 @@ static inline void gfxClearArray(uint32_t* array)
 #ifndef TILED_RENDERING
 static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t vofs, uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gbaCore.g_paletteRAM;
     const size_t charBankBaseOffset = ((control >> 2) & 0x03) * 0x4000;
-    uint16_t* screenBase = (uint16_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+    uint16_t* screenBase = (uint16_t*)&gbaCore.g_vram[((control >> 8) & 0x1f) * 0x800];
     uint32_t prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 256;
     int sizeY = 256;
@@ -108,13 +84,13 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
     bool mosaicOn = (control & 0x40) ? true : false;
 
     int xxx = hofs & maskX;
-    int yyy = (vofs + VCOUNT) & maskY;
-    int mosaicX = (MOSAIC & 0x000F) + 1;
-    int mosaicY = ((MOSAIC & 0x00F0) >> 4) + 1;
+    int yyy = (vofs + gbaCore.VCOUNT) & maskY;
+    int mosaicX = (gbaCore.MOSAIC & 0x000F) + 1;
+    int mosaicY = ((gbaCore.MOSAIC & 0x00F0) >> 4) + 1;
 
     if (mosaicOn) {
-        if ((VCOUNT % mosaicY) != 0) {
-            mosaicY = VCOUNT - (VCOUNT % mosaicY);
+        if ((gbaCore.VCOUNT % mosaicY) != 0) {
+            mosaicY = gbaCore.VCOUNT - (gbaCore.VCOUNT % mosaicY);
             yyy = (vofs + mosaicY) & maskY;
         }
     }
@@ -127,101 +103,61 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
     }
 
     int yshift = ((yyy >> 3) << 5);
-    if ((control)&0x80) {
-        uint16_t* screenSource = screenBase + 0x400 * (xxx >> 8) + ((xxx & 255) >> 3) + yshift;
-        for (int x = 0; x < 240; x++) {
-            uint16_t data = READ16LE(screenSource);
-
-            int tile = data & 0x3FF;
-            int tileX = (xxx & 7);
-            int tileY = yyy & 7;
-
-            if (tileX == 7)
-                screenSource++;
-
-            if (data & 0x0400)
-                tileX = 7 - tileX;
-            if (data & 0x0800)
-                tileY = 7 - tileY;
-
-            const size_t charBankOffset = tile * 64 + tileY * 8 + tileX;
-            const size_t charBankTotalOffset = charBankOffset + charBankBaseOffset;
-            uint8_t color;
-            if (charBankTotalOffset >= 0x10000) {
-                // Adapted from https://github.com/mgba-emu/mgba/commit/4ce9b83362ad66b1421afea7372adfc753bce97c
-                // Real hardware PPU uses the most recently read from background
-                // VRAM. This can't be easily emulated in vba-m, so we simply
-                // use 0 here.
-                color = 0;
-            } else {
-                color = g_vram[charBankTotalOffset];
-            }
-
-            line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
+    int tileY = yyy & 7;
+    uint16_t* screenSource = screenBase + 0x400 * (xxx >> 8) + ((xxx & 255) >> 3) + yshift;
+    // Drawn one tile row at a time, the first and last ones may be partial.
+    for (int x = 0; x < 240;) {
+        uint16_t data = READ16LE(screenSource++);
+
+        int tile = data & 0x3FF;
+        int tileX = (xxx & 7);
+        int count = 8 - tileX;
+        if (count > 240 - x)
+            count = 240 - x;
+
+        int flipX = (data & 0x0400) ? 7 : 0;
+        int row = (data & 0x0800) ? 7 - tileY : tileY;
+
+        uint32_t* dest = &line[x];
+        const uint8_t* pixels = nullptr;
+        int pal = 0;
+        if ((control)&0x80) {
+            const size_t charBankTotalOffset = tile * 64 + charBankBaseOffset;
+            if (charBankTotalOffset < 0x10000)
+                pixels = &gbaCore.g_vram[charBankTotalOffset + (row << 3)];
+        } else {
+            const size_t charBankTotalOffset = (tile << 5) + charBankBaseOffset;
+            if (charBankTotalOffset < 0x10000)
+                pixels = gfxTileRow4(charBankTotalOffset, row);
+            pal = (data >> 8) & 0xF0;
+        }
 
-            xxx++;
-            if (xxx == 256) {
-                if (sizeX > 256)
-                    screenSource = screenBase + 0x400 + yshift;
-                else {
-                    screenSource = screenBase + yshift;
-                    xxx = 0;
-                }
-            } else if (xxx >= sizeX) {
-                xxx = 0;
-                screenSource = screenBase + yshift;
+        if (pixels) {
+            for (int i = 0; i < count; i++) {
+                uint8_t color = pixels[(tileX + i) ^ flipX];
+                dest[i] = color ? (READ16LE(&palette[pal + color]) | prio) : 0x80000000;
             }
+        } else {
+            // Adapted from https://github.com/mgba-emu/mgba/commit/4ce9b83362ad66b1421afea7372adfc753bce97c
+            // Real hardware PPU uses the most recently read from background
+            // VRAM. This can't be easily emulated in vba-m, so we simply
+            // use 0 here.
+            for (int i = 0; i < count; i++)
+                dest[i] = 0x80000000;
         }
-    } else {
-        uint16_t* screenSource = screenBase + 0x400 * (xxx >> 8) + ((xxx & 255) >> 3) + yshift;
-        for (int x = 0; x < 240; x++) {
-            uint16_t data = READ16LE(screenSource);
-
-            int tile = data & 0x3FF;
-            int tileX = (xxx & 7);
-            int tileY = yyy & 7;
-
-            if (tileX == 7)
-                screenSource++;
-
-            if (data & 0x0400)
-                tileX = 7 - tileX;
-            if (data & 0x0800)
-                tileY = 7 - tileY;
-
-            const size_t charBankOffset = (tile << 5) + (tileY << 2) + (tileX >> 1);
-            const size_t charBankTotalOffset = charBankOffset + charBankBaseOffset;
-            uint8_t color;
-            if (charBankTotalOffset >= 0x10000) {
-                // Adapted from https://github.com/mgba-emu/mgba/commit/4ce9b83362ad66b1421afea7372adfc753bce97c
-                // Real hardware PPU uses the most recently read from background
-                // VRAM. This can't be easily emulated in vba-m, so we simply
-                // use 0 here.
-                color = 0;
-            } else {
-                color = g_vram[charBankTotalOffset];
-                if (tileX & 1) {
-                    color = (color >> 4);
-                } else {
-                    color &= 0x0F;
-                }
-            }
 
-            int pal = (data >> 8) & 0xF0;
-            line[x] = color ? (READ16LE(&palette[pal + color]) | prio) : 0x80000000;
-
-            xxx++;
-            if (xxx == 256) {
-                if (sizeX > 256)
-                    screenSource = screenBase + 0x400 + yshift;
-                else {
-                    screenSource = screenBase + yshift;
-                    xxx = 0;
-                }
-            } else if (xxx >= sizeX) {
-                xxx = 0;
+        x += count;
+        xxx += count;
+        if (xxx == 256) {
+            if (sizeX > 256)
+                screenSource = screenBase + 0x400 + yshift;
+            else {
                 screenSource = screenBase + yshift;
+                xxx = 0;
             }
+        } else if (xxx >= sizeX) {
+            xxx = 0;
+            screenSource = screenBase + yshift;
         }
     }
     if (mosaicOn) {
@@ -240,13 +176,44 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
 }
 #endif // !__TILED_RENDERING
 
-static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h, uint16_t y_l, uint16_t y_h, uint16_t pa, uint16_t pb,
-    uint16_t pc, uint16_t pd, int& currentX, int& currentY, int changed,
-    uint32_t* line)
+// Moves the reference point of an affine BG to the current line. It is
+// reloaded from BGxX (bit 0 of `changed`) and BGxY (bit 1) after they were
+// written and at the top of the frame, and stepped by PB/PD otherwise.
+static inline void gfxUpdateRotReference(uint16_t x_l, uint16_t x_h, uint16_t y_l, uint16_t y_h, uint16_t pb, uint16_t pd,
+    int changed, int& currentX, int& currentY)
+{
+    int dmx = pb & 0x7FFF;
+    if (pb & 0x8000)
+        dmx |= 0xFFFF8000;
+    int dmy = pd & 0x7FFF;
+    if (pd & 0x8000)
+        dmy |= 0xFFFF8000;
+
+    if (gbaCore.VCOUNT == 0)
+        changed = 3;
+
+    if (changed & 1) {
+        currentX = (x_l) | ((x_h & 0x07FF) << 16);
+        if (x_h & 0x0800)
+            currentX |= 0xF8000000;
+    } else {
+        currentX += dmx;
+    }
+
+    if (changed & 2) {
+        currentY = (y_l) | ((y_h & 0x07FF) << 16);
+        if (y_h & 0x0800)
+            currentY |= 0xF8000000;
+    } else {
+        currentY += dmy;
+    }
+}
+
+static inline void gfxDrawRotScreen(uint16_t control, uint16_t pa, uint16_t pb, uint16_t pc, uint16_t pd,
+    int currentX, int currentY, uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
-    uint8_t* charBase = &g_vram[((control >> 2) & 0x03) * 0x4000];
-    uint8_t* screenBase = (uint8_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+    uint8_t* charBase = &gbaCore.g_vram[((control >> 2) & 0x03) * 0x4000];
+    uint8_t* screenBase = (uint8_t*)&gbaCore.g_vram[((control >> 8) & 0x1f) * 0x800];
     int prio = ((control & 3) << 25) + 0x1000000;
 
     int sizeX = 128;
@@ -265,9 +232,6 @@ static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h
         break;
     }
 
-    int maskX = sizeX - 1;
-    int maskY = sizeY - 1;
-
     int yshift = ((control >> 14) & 3) + 4;
 
     int dx = pa & 0x7FFF;
@@ -283,76 +247,34 @@ static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
-        changed = 3;
-
-    if (changed & 1) {
-        currentX = (x_l) | ((x_h & 0x07FF) << 16);
-        if (x_h & 0x0800)
-            currentX |= 0xF8000000;
-    } else {
-        currentX += dmx;
-    }
-
-    if (changed & 2) {
-        currentY = (y_l) | ((y_h & 0x07FF) << 16);
-        if (y_h & 0x0800)
-            currentY |= 0xF8000000;
-    } else {
-        currentY += dmy;
-    }
-
     int realX = currentX;
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = (VCOUNT % mosaicY);
+        int mosaicY = ((gbaCore.MOSAIC & 0xF0) >> 4) + 1;
+        int y = (gbaCore.VCOUNT % mosaicY);
         realX -= y * dmx;
         realY -= y * dmy;
     }
 
-    if (control & 0x2000) {
-        for (int x = 0; x < 240; x++) {
-            int xxx = (realX >> 8) & maskX;
-            int yyy = (realY >> 8) & maskY;
-
-            int tile = screenBase[(xxx >> 3) + ((yyy >> 3) << yshift)];
-
-            int tileX = (xxx & 7);
-            int tileY = yyy & 7;
-
-            uint8_t color = charBase[(tile << 6) + (tileY << 3) + tileX];
-
-            line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
-
-            realX += dx;
-            realY += dy;
-        }
-    } else {
-        for (int x = 0; x < 240; x++) {
-            int xxx = (realX >> 8);
-            int yyy = (realY >> 8);
-
-            if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-                line[x] = 0x80000000;
-            } else {
-                int tile = screenBase[(xxx >> 3) + ((yyy >> 3) << yshift)];
-
-                int tileX = (xxx & 7);
-                int tileY = yyy & 7;
-
-                uint8_t color = charBase[(tile << 6) + (tileY << 3) + tileX];
-
-                line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
-            }
-            realX += dx;
-            realY += dy;
-        }
-    }
+    GfxAffineState state;
+    state.format = kGfxAffineTiled;
+    state.x = realX;
+    state.y = realY;
+    state.dx = dx;
+    state.dy = dy;
+    state.width = sizeX;
+    state.height = sizeY;
+    state.wrap = (control & 0x2000) != 0;
+    state.mapShift = yshift;
+    state.screenBase = screenBase;
+    state.charBase = charBase;
+    state.palette = gbaCore.g_paletteRAM;
+    state.prio = prio;
+    gfxDrawAffineLine(state, line);
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gbaCore.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -368,10 +290,10 @@ static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h
 }
 
 static inline void gfxDrawRotScreen16Bit(uint16_t control, uint16_t x_l, uint16_t x_h, uint16_t y_l, uint16_t y_h, uint16_t pa,
-    uint16_t pb, uint16_t pc, uint16_t pd, int& currentX, int& currentY,
-    int changed, uint32_t* line)
+    uint16_t pb, uint16_t pc, uint16_t pd, int currentX, int currentY,
+    uint32_t* line)
 {
-    uint16_t* screenBase = (uint16_t*)&g_vram[0];
+    uint8_t* screenBase = &gbaCore.g_vram[0];
     int prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 240;
     int sizeY = 160;
@@ -396,52 +318,34 @@ static inline void gfxDrawRotScreen16Bit(uint16_t control, uint16_t x_l, uint16_
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
-        changed = 3;
-
-    if (changed & 1) {
-        currentX = (x_l) | ((x_h & 0x07FF) << 16);
-        if (x_h & 0x0800)
-            currentX |= 0xF8000000;
-    } else
-        currentX += dmx;
-
-    if (changed & 2) {
-        currentY = (y_l) | ((y_h & 0x07FF) << 16);
-        if (y_h & 0x0800)
-            currentY |= 0xF8000000;
-    } else {
-        currentY += dmy;
-    }
-
     int realX = currentX;
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = (VCOUNT % mosaicY);
+        int mosaicY = ((gbaCore.MOSAIC & 0xF0) >> 4) + 1;
+        int y = (gbaCore.VCOUNT % mosaicY);
         realX -= y * dmx;
         realY -= y * dmy;
     }
 
-    int xxx = (realX >> 8);
-    int yyy = (realY >> 8);
-
-    for (int x = 0; x < 240; x++) {
-        if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-            line[x] = 0x80000000;
-        } else {
-            line[x] = (READ16LE(&screenBase[yyy * sizeX + xxx]) | prio);
-        }
-        realX += dx;
-        realY += dy;
-
-        xxx = (realX >> 8);
-        yyy = (realY >> 8);
-    }
+    GfxAffineState state;
+    state.format = kGfxAffineBitmap16;
+    state.x = realX;
+    state.y = realY;
+    state.dx = dx;
+    state.dy = dy;
+    state.width = sizeX;
+    state.height = sizeY;
+    state.wrap = false;
+    state.mapShift = 0;
+    state.screenBase = screenBase;
+    state.charBase = nullptr;
+    state.palette = nullptr;
+    state.prio = prio;
+    gfxDrawAffineLine(state, line);
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gbaCore.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -457,11 +361,10 @@ static inline void gfxDrawRotScreen16Bit(uint16_t control, uint16_t x_l, uint16_
 }
 
 static inline void gfxDrawRotScreen256(uint16_t control, uint16_t x_l, uint16_t x_h, uint16_t y_l, uint16_t y_h, uint16_t pa,
-    uint16_t pb, uint16_t pc, uint16_t pd, int& currentX, int& currentY,
-    int changed, uint32_t* line)
+    uint16_t pb, uint16_t pc, uint16_t pd, int currentX, int currentY,
+    uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
-    uint8_t* screenBase = (DISPCNT & 0x0010) ? &g_vram[0xA000] : &g_vram[0x0000];
+    uint8_t* screenBase = (gbaCore.DISPCNT & 0x0010) ? &gbaCore.g_vram[0xA000] : &gbaCore.g_vram[0x0000];
     int prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 240;
     int sizeY = 160;
@@ -486,55 +389,34 @@ static inline void gfxDrawRotScreen256(uint16_t control, uint16_t x_l, uint16_t
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
-        changed = 3;
-
-    if (changed & 1) {
-        currentX = (x_l) | ((x_h & 0x07FF) << 16);
-        if (x_h & 0x0800)
-            currentX |= 0xF8000000;
-    } else {
-        currentX += dmx;
-    }
-
-    if (changed & 2) {
-        currentY = (y_l) | ((y_h & 0x07FF) << 16);
-        if (y_h & 0x0800)
-            currentY |= 0xF8000000;
-    } else {
-        currentY += dmy;
-    }
-
     int realX = currentX;
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = VCOUNT - (VCOUNT % mosaicY);
+        int mosaicY = ((gbaCore.MOSAIC & 0xF0) >> 4) + 1;
+        int y = gbaCore.VCOUNT - (gbaCore.VCOUNT % mosaicY);
         realX = startX + y * dmx;
         realY = startY + y * dmy;
     }
 
-    int xxx = (realX >> 8);
-    int yyy = (realY >> 8);
-
-    for (int x = 0; x < 240; x++) {
-        if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-            line[x] = 0x80000000;
-        } else {
-            uint8_t color = screenBase[yyy * 240 + xxx];
-
-            line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
-        }
-        realX += dx;
-        realY += dy;
-
-        xxx = (realX >> 8);
-        yyy = (realY >> 8);
-    }
+    GfxAffineState state;
+    state.format = kGfxAffineBitmap8;
+    state.x = realX;
+    state.y = realY;
+    state.dx = dx;
+    state.dy = dy;
+    state.width = sizeX;
+    state.height = sizeY;
+    state.wrap = false;
+    state.mapShift = 0;
+    state.screenBase = screenBase;
+    state.charBase = nullptr;
+    state.palette = gbaCore.g_paletteRAM;
+    state.prio = prio;
+    gfxDrawAffineLine(state, line);
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gbaCore.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -550,10 +432,10 @@ static inline void gfxDrawRotScreen256(uint16_t control, uint16_t x_l, uint16_t
 }
 
 static inline void gfxDrawRotScreen16Bit160(uint16_t control, uint16_t x_l, uint16_t x_h, uint16_t y_l, uint16_t y_h, uint16_t pa,
-    uint16_t pb, uint16_t pc, uint16_t pd, int& currentX, int& currentY,
-    int changed, uint32_t* line)
+    uint16_t pb, uint16_t pc, uint16_t pd, int currentX, int currentY,
+    uint32_t* line)
 {
-    uint16_t* screenBase = (DISPCNT & 0x0010) ? (uint16_t*)&g_vram[0xa000] : (uint16_t*)&g_vram[0];
+    uint8_t* screenBase = (gbaCore.DISPCNT & 0x0010) ? &gbaCore.g_vram[0xa000] : &gbaCore.g_vram[0];
     int prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 160;
     int sizeY = 128;
@@ -578,53 +460,34 @@ static inline void gfxDrawRotScreen16Bit160(uint16_t control, uint16_t x_l, uint
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
-        changed = 3;
-
-    if (changed & 1) {
-        currentX = (x_l) | ((x_h & 0x07FF) << 16);
-        if (x_h & 0x0800)
-            currentX |= 0xF8000000;
-    } else {
-        currentX += dmx;
-    }
-
-    if (changed & 2) {
-        currentY = (y_l) | ((y_h & 0x07FF) << 16);
-        if (y_h & 0x0800)
-            currentY |= 0xF8000000;
-    } else {
-        currentY += dmy;
-    }
-
     int realX = currentX;
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = VCOUNT - (VCOUNT % mosaicY);
+        int mosaicY = ((gbaCore.MOSAIC & 0xF0) >> 4) + 1;
+        int y = gbaCore.VCOUNT - (gbaCore.VCOUNT % mosaicY);
         realX = startX + y * dmx;
         realY = startY + y * dmy;
     }
 
-    int xxx = (realX >> 8);
-    int yyy = (realY >> 8);
-
-    for (int x = 0; x < 240; x++) {
-        if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-            line[x] = 0x80000000;
-        } else {
-            line[x] = (READ16LE(&screenBase[yyy * sizeX + xxx]) | prio);
-        }
-        realX += dx;
-        realY += dy;
-
-        xxx = (realX >> 8);
-        yyy = (realY >> 8);
-    }
+    GfxAffineState state;
+    state.format = kGfxAffineBitmap16;
+    state.x = realX;
+    state.y = realY;
+    state.dx = dx;
+    state.dy = dy;
+    state.width = sizeX;
+    state.height = sizeY;
+    state.wrap = false;
+    state.mapShift = 0;
+    state.screenBase = screenBase;
+    state.charBase = nullptr;
+    state.palette = nullptr;
+    state.prio = prio;
+    gfxDrawAffineLine(state, line);
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gbaCore.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -644,48 +507,33 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
     // lineOBJpix is used to keep track of the drawn OBJs
     // and to stop drawing them if the 'maximum number of OBJ per line'
     // has been reached.
-    int lineOBJpix = (DISPCNT & 0x20) ? 954 : 1226;
+    int lineOBJpix = (gbaCore.DISPCNT & 0x20) ? 954 : 1226;
     int m = 0;
     gfxClearArray(lineOBJ);
-    if (coreOptions.layerEnable & 0x1000) {
-        uint16_t* sprites = (uint16_t*)g_oam;
-        uint16_t* spritePalette = &((uint16_t*)g_paletteRAM)[256];
-        int mosaicY = ((MOSAIC & 0xF000) >> 12) + 1;
-        int mosaicX = ((MOSAIC & 0xF00) >> 8) + 1;
-        for (int x = 0; x < 128; x++) {
-            uint16_t a0 = READ16LE(sprites++);
-            uint16_t a1 = READ16LE(sprites++);
-            uint16_t a2 = READ16LE(sprites++);
-            sprites++;
-
-            lineOBJpixleft[x] = lineOBJpix;
+    if (gbaCore.gfxLayerEnable & 0x1000) {
+        uint16_t* spritePalette = &((uint16_t*)gbaCore.g_paletteRAM)[256];
+        int mosaicY = ((gbaCore.MOSAIC & 0xF000) >> 12) + 1;
+        int mosaicX = ((gbaCore.MOSAIC & 0xF00) >> 8) + 1;
+        const uint32_t* spriteLine = gfxSpriteLine(gbaCore.VCOUNT);
+        // entries skipped by the index still use up 2 cycles each
+        int next = 0;
+        for (int x = gfxSpriteFind(spriteLine, 0); x < kSpriteCount; x = gfxSpriteFind(spriteLine, x + 1)) {
+            const GfxSprite& sprite = gbaCore.gfxSprites[x];
+            uint16_t a0 = sprite.a0;
+            uint16_t a1 = sprite.a1;
+            uint16_t a2 = sprite.a2;
+
+            lineOBJpix -= 2 * (x - next);
+            next = x + 1;
+
+            gbaCore.lineOBJpixleft[x] = lineOBJpix;
 
             lineOBJpix -= 2;
             if (lineOBJpix <= 0)
                 continue;
 
-            if ((a0 & 0x0c00) == 0x0c00)
-                a0 &= 0xF3FF;
-
-            if ((a0 >> 14) == 3) {
-                a0 &= 0x3FFF;
-                a1 &= 0x3FFF;
-            }
-
-            int sizeX = 8 << (a1 >> 14);
-            int sizeY = sizeX;
-
-            if ((a0 >> 14) & 1) {
-                if (sizeX < 32)
-                    sizeX <<= 1;
-                if (sizeY > 8)
-                    sizeY >>= 1;
-            } else if ((a0 >> 14) & 2) {
-                if (sizeX > 8)
-                    sizeX >>= 1;
-                if (sizeY < 32)
-                    sizeY <<= 1;
-            }
+            int sizeX = sprite.sizeX;
+            int sizeY = sprite.sizeY;
 
 #ifdef SPRITE_DEBUG
             int maskX = sizeX - 1;
@@ -696,7 +544,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
             int sx = (a1 & 0x1FF);
 
             // computes ticks used by OBJ-WIN if OBJWIN is enabled
-            if (((a0 & 0x0c00) == 0x0800) && (coreOptions.layerEnable & 0x8000)) {
+            if (((a0 & 0x0c00) == 0x0800) && (gbaCore.gfxLayerEnable & 0x8000)) {
                 if ((a0 & 0x0300) == 0x0300) {
                     sizeX <<= 1;
                     sizeY <<= 1;
@@ -710,7 +558,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                     sx = 0;
                 } else if ((sx + sizeX) > 240)
                     sizeX = 240 - sx;
-                if ((VCOUNT >= sy) && (VCOUNT < sy + sizeY) && (sx < 240)) {
+                if ((gbaCore.VCOUNT >= sy) && (gbaCore.VCOUNT < sy + sizeY) && (sx < 240)) {
                     if (a0 & 0x0100)
                         lineOBJpix -= 8 + 2 * sizeX;
                     else
@@ -734,7 +582,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                 }
                 if ((sy + fieldY) > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gbaCore.VCOUNT - sy;
                 if ((t >= 0) && (t < fieldY)) {
                     int startpix = 0;
                     if ((sx + fieldX) > 512) {
@@ -745,7 +593,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                             lineOBJpix -= 8;
                             // int t2 = t - (fieldY >> 1);
                             int rot = (a1 >> 9) & 0x1F;
-                            uint16_t* OAM = (uint16_t*)g_oam;
+                            uint16_t* OAM = (uint16_t*)gbaCore.g_oam;
                             int dx = READ16LE(&OAM[3 + (rot << 4)]);
                             if (dx & 0x8000)
                                 dx |= 0xFFFF8000;
@@ -770,10 +618,10 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
 
                             if (a0 & 0x2000) {
                                 int c = (a2 & 0x3FF);
-                                if ((DISPCNT & 7) > 2 && (c < 512))
+                                if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                     continue;
                                 int inc = 32;
-                                if (DISPCNT & 0x40)
+                                if (gbaCore.DISPCNT & 0x40)
                                     inc = sizeX >> 2;
                                 else
                                     c &= 0x3FE;
@@ -788,7 +636,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240)
                                         ;
                                     else {
-                                        uint32_t color = g_vram
+                                        uint32_t color = gbaCore.g_vram
                                             [0x10000 + ((((c + (yyy >> 3) * inc)
                                                              << 5)
                                                             + ((yyy & 7)
@@ -839,11 +687,11 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                 }
                             } else {
                                 int c = (a2 & 0x3FF);
-                                if ((DISPCNT & 7) > 2 && (c < 512))
+                                if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                     continue;
 
                                 int inc = 32;
-                                if (DISPCNT & 0x40)
+                                if (gbaCore.DISPCNT & 0x40)
                                     inc = sizeX >> 3;
                                 int palette = (a2 >> 8) & 0xF0;
                                 for (int y = 0; y < fieldX; y++) {
@@ -856,7 +704,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240)
                                         ;
                                     else {
-                                        uint32_t color = g_vram
+                                        uint32_t color = gbaCore.g_vram
                                             [0x10000 + ((((c + (yyy >> 3) * inc)
                                                              << 5)
                                                             + ((yyy & 7)
@@ -916,7 +764,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
             } else {
                 if (sy + sizeY > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gbaCore.VCOUNT - sy;
                 if ((t >= 0) && (t < sizeY)) {
                     int startpix = 0;
                     if ((sx + sizeX) > 512) {
@@ -928,11 +776,11 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gbaCore.DISPCNT & 0x40) {
                                 inc = sizeX >> 2;
                             } else {
                                 c &= 0x3FE;
@@ -957,7 +805,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                 if (lineOBJpix < 0)
                                     continue;
                                 if (sx < 240) {
-                                    uint8_t color = g_vram[address];
+                                    uint8_t color = gbaCore.g_vram[address];
                                     if ((color == 0) && (((prio >> 25) & 3) < ((lineOBJ[sx] >> 25) & 3))) {
                                         lineOBJ[sx] = (lineOBJ[sx] & 0xF9FFFFFF) | prio;
                                         if ((a0 & 0x1000) && m)
@@ -1014,11 +862,11 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gbaCore.DISPCNT & 0x40) {
                                 inc = sizeX >> 3;
                             }
                             int xxx = 0;
@@ -1041,7 +889,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gbaCore.g_vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
@@ -1100,7 +948,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gbaCore.g_vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
@@ -1164,15 +1012,16 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
 static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
 {
     gfxClearArray(lineOBJWin);
-    if ((coreOptions.layerEnable & 0x9000) == 0x9000) {
-        uint16_t* sprites = (uint16_t*)g_oam;
+    if ((gbaCore.gfxLayerEnable & 0x9000) == 0x9000) {
         // uint16_t *spritePalette = &((uint16_t *)g_paletteRAM)[256];
-        for (int x = 0; x < 128; x++) {
-            int lineOBJpix = lineOBJpixleft[x];
-            uint16_t a0 = READ16LE(sprites++);
-            uint16_t a1 = READ16LE(sprites++);
-            uint16_t a2 = READ16LE(sprites++);
-            sprites++;
+        // lineOBJpixleft was filled by gfxDrawSprites() for the same entries
+        const uint32_t* spriteLine = gfxSpriteLine(gbaCore.VCOUNT);
+        for (int x = gfxSpriteFind(spriteLine, 0); x < kSpriteCount; x = gfxSpriteFind(spriteLine, x + 1)) {
+            int lineOBJpix = gbaCore.lineOBJpixleft[x];
+            const GfxSprite& sprite = gbaCore.gfxSprites[x];
+            uint16_t a0 = sprite.a0;
+            uint16_t a1 = sprite.a1;
+            uint16_t a2 = sprite.a2;
 
             if (lineOBJpix <= 0)
                 continue;
@@ -1181,28 +1030,8 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
             if (((a0 & 0x0c00) != 0x0800) || ((a0 & 0x0300) == 0x0200))
                 continue;
 
-            if ((a0 & 0x0c00) == 0x0c00)
-                a0 &= 0xF3FF;
-
-            if ((a0 >> 14) == 3) {
-                a0 &= 0x3FFF;
-                a1 &= 0x3FFF;
-            }
-
-            int sizeX = 8 << (a1 >> 14);
-            int sizeY = sizeX;
-
-            if ((a0 >> 14) & 1) {
-                if (sizeX < 32)
-                    sizeX <<= 1;
-                if (sizeY > 8)
-                    sizeY >>= 1;
-            } else if ((a0 >> 14) & 2) {
-                if (sizeX > 8)
-                    sizeX >>= 1;
-                if (sizeY < 32)
-                    sizeY <<= 1;
-            }
+            int sizeX = sprite.sizeX;
+            int sizeY = sprite.sizeY;
 
             int sy = (a0 & 255);
 
@@ -1215,7 +1044,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                 }
                 if ((sy + fieldY) > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gbaCore.VCOUNT - sy;
                 if ((t >= 0) && (t < fieldY)) {
                     int sx = (a1 & 0x1FF);
                     int startpix = 0;
@@ -1226,7 +1055,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                         lineOBJpix -= 8;
                         // int t2 = t - (fieldY >> 1);
                         int rot = (a1 >> 9) & 0x1F;
-                        uint16_t* OAM = (uint16_t*)g_oam;
+                        uint16_t* OAM = (uint16_t*)gbaCore.g_oam;
                         int dx = READ16LE(&OAM[3 + (rot << 4)]);
                         if (dx & 0x8000)
                             dx |= 0xFFFF8000;
@@ -1248,10 +1077,10 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
 
                         if (a0 & 0x2000) {
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
                             int inc = 32;
-                            if (DISPCNT & 0x40)
+                            if (gbaCore.DISPCNT & 0x40)
                                 inc = sizeX >> 2;
                             else
                                 c &= 0x3FE;
@@ -1265,7 +1094,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
 
                                 if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240) {
                                 } else {
-                                    uint32_t color = g_vram
+                                    uint32_t color = gbaCore.g_vram
                                         [0x10000 + ((((c + (yyy >> 3) * inc)
                                                          << 5)
                                                         + ((yyy & 7) << 3) + ((xxx >> 3) << 6) + (xxx & 7))
@@ -1280,11 +1109,11 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                             }
                         } else {
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40)
+                            if (gbaCore.DISPCNT & 0x40)
                                 inc = sizeX >> 3;
                             // int palette = (a2 >> 8) & 0xF0;
                             for (int y = 0; y < fieldX; y++) {
@@ -1304,7 +1133,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                 //              } else {
                                 if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240) {
                                 } else {
-                                    uint32_t color = g_vram
+                                    uint32_t color = gbaCore.g_vram
                                         [0x10000 + ((((c + (yyy >> 3) * inc)
                                                          << 5)
                                                         + ((yyy & 7) << 2) + ((xxx >> 3) << 5) + ((xxx & 7) >> 1))
@@ -1329,7 +1158,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
             } else {
                 if ((sy + sizeY) > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gbaCore.VCOUNT - sy;
                 if ((t >= 0) && (t < sizeY)) {
                     int sx = (a1 & 0x1FF);
                     int startpix = 0;
@@ -1342,11 +1171,11 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gbaCore.DISPCNT & 0x40) {
                                 inc = sizeX >> 2;
                             } else {
                                 c &= 0x3FE;
@@ -1365,7 +1194,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                 if (lineOBJpix < 0)
                                     continue;
                                 if (sx < 240) {
-                                    uint8_t color = g_vram[address];
+                                    uint8_t color = gbaCore.g_vram[address];
                                     if (color) {
                                         lineOBJWin[sx] = 1;
                                     }
@@ -1396,11 +1225,11 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gbaCore.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gbaCore.DISPCNT & 0x40) {
                                 inc = sizeX >> 3;
                             }
                             int xxx = 0;
@@ -1419,7 +1248,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gbaCore.g_vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
@@ -1449,7 +1278,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gbaCore.g_vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
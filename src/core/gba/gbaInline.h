@@ -12,6 +12,13 @@
 #include "core/gba/gbaPrint.h"
 #include "core/gba/gbaRtc.h"
 #include "core/gba/gbaSound.h"
+#include "core/gba/internal/gbaDecodeCache.h"
+#include "core/gba/internal/gbaIdleLoop.h"
+#include "core/gba/internal/gbaPageTable.h"
+#include "core/gba/internal/gbaRenderThreads.h"
+#include "core/gba/internal/gbaScheduler.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
+#include "core/gba/internal/gbaTileCache.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 #include "core/gba/gbaRemote.h"
@@ -19,38 +26,13 @@
 
 extern const uint32_t objTilesAddress[3];
 
-extern bool stopState;
-extern bool holdState;
-extern int holdType;
-extern int cpuNextEvent;
-extern bool cpuSramEnabled;
-extern bool cpuFlashEnabled;
-extern bool cpuEEPROMEnabled;
-extern bool cpuEEPROMSensorEnabled;
-extern bool cpuDmaRunning;
-extern uint32_t cpuDmaLast;
-extern uint32_t cpuDmaPC;
-extern bool timer0On;
-extern int timer0Ticks;
-extern int timer0ClockReload;
-extern bool timer1On;
-extern int timer1Ticks;
-extern int timer1ClockReload;
-extern bool timer2On;
-extern int timer2Ticks;
-extern int timer2ClockReload;
-extern bool timer3On;
-extern int timer3Ticks;
-extern int timer3ClockReload;
-extern int cpuTotalTicks;
-
-#define CPUReadByteQuick(addr) map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]
+#define CPUReadByteQuick(addr) gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]
 
 #define CPUReadHalfWordQuick(addr) \
-    READ16LE(((uint16_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ16LE(((uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define CPUReadMemoryQuick(addr) \
-    READ32LE(((uint32_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ32LE(((uint32_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 static inline uint16_t DowncastU16(uint32_t value) {
     return static_cast<uint16_t>(value);
@@ -76,10 +58,18 @@ static inline int8_t Downcast8(T value) {
 
 extern uint32_t myROM[];
 
+// The serial registers change with the link state between events, so a loop
+// polling them must not be skipped.
+static inline bool CPUIsSerialRegister(uint32_t address)
+{
+    const uint32_t reg = address & 0x3fe;
+    return (reg >= COMM_SIODATA32_L && reg <= COMM_SIODATA8) || (reg >= COMM_RCNT && reg <= COMM_JOYSTAT);
+}
+
 static inline uint32_t CPUReadMemory(uint32_t address)
 {
 #ifdef VBAM_ENABLE_DEBUGGER
-    memoryMap* m = &map[address >> 24];
+    memoryMap* m = &gbaCore.map[address >> 24];
     if (m->breakPoints && BreakReadCheck(m->breakPoints, address & m->mask)) {
         if (debuggerBreakOnRead(address, 2)) {
             // CPU_BREAK_LOOP_2;
@@ -88,75 +78,85 @@ static inline uint32_t CPUReadMemory(uint32_t address)
 #endif
     uint32_t value = 0;
 
+    if (const uint8_t* page = cpuReadPage(address)) {
+        value = READ32LE(((const uint32_t*)&page[address & (kPageMask & ~3)]));
+        goto rotate;
+    }
+
     switch (address >> 24) {
     case 0:
-        if (reg[15].I >> 24) {
+        if (gbaCore.reg[15].I >> 24) {
             if (address < 0x4000) {
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_ILLEGAL_READ) {
                     log("Illegal word read from bios: %08x at %08x\n",
                         address,
-                        armMode ? armNextPC - 4 : armNextPC - 2);
+                        gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
                 }
 #endif
 
-                value = READ32LE(((uint32_t*)&biosProtected));
+                value = READ32LE(((uint32_t*)&gbaCore.biosProtected));
             } else
                 goto unreadable;
         } else
-            value = READ32LE(((uint32_t*)&g_bios[address & 0x3FFC]));
+            value = READ32LE(((uint32_t*)&gbaCore.g_bios[address & 0x3FFC]));
         break;
     case 2:
-        value = READ32LE(((uint32_t*)&g_workRAM[address & 0x3FFFC]));
+        value = READ32LE(((uint32_t*)&gbaCore.g_workRAM[address & 0x3FFFC]));
         break;
     case 3:
-        value = READ32LE(((uint32_t*)&g_internalRAM[address & 0x7ffC]));
+        value = READ32LE(((uint32_t*)&gbaCore.g_internalRAM[address & 0x7ffC]));
         break;
     case 4:
-        if ((address < 0x4000400) && ioReadable[address & 0x3fc]) {
-            if (ioReadable[(address & 0x3fc) + 2]) {
-                value = READ32LE(((uint32_t*)&g_ioMem[address & 0x3fC]));
+        if ((address < 0x4000400) && gbaCore.ioReadable[address & 0x3fc]) {
+            if (gbaCore.ioReadable[(address & 0x3fc) + 2]) {
+                value = READ32LE(((uint32_t*)&gbaCore.g_ioMem[address & 0x3fC]));
                 if ((address & 0x3fc) == COMM_JOY_RECV_L)
                     UPDATE_REG(COMM_JOYSTAT,
-                        READ16LE(&g_ioMem[COMM_JOYSTAT]) & ~JOYSTAT_RECV);
+                        READ16LE(&gbaCore.g_ioMem[COMM_JOYSTAT]) & ~JOYSTAT_RECV);
             } else {
-                value = READ16LE(((uint16_t*)&g_ioMem[address & 0x3fc]));
+                value = READ16LE(((uint16_t*)&gbaCore.g_ioMem[address & 0x3fc]));
             }
+            if (CPUIsSerialRegister(address))
+                gbaCore.idleLoopVolatileRead = true;
         } else
             goto unreadable;
         break;
     case 5:
-        value = READ32LE(((uint32_t*)&g_paletteRAM[address & 0x3fC]));
+        value = READ32LE(((uint32_t*)&gbaCore.g_paletteRAM[address & 0x3fC]));
         break;
     case 6: {
         unsigned addr = (address & 0x1fffc);
-        if (((DISPCNT & 7) > 2) && ((addr & 0x1C000) == 0x18000)) {
+        if (((gbaCore.DISPCNT & 7) > 2) && ((addr & 0x1C000) == 0x18000)) {
             value = 0;
             break;
         }
         if ((addr & 0x18000) == 0x18000)
             addr &= 0x17fff;
-        value = READ32LE(((uint32_t*)&g_vram[addr]));
+        value = READ32LE(((uint32_t*)&gbaCore.g_vram[addr]));
         break;
     }
     case 7:
-        value = READ32LE(((uint32_t*)&g_oam[address & 0x3FC]));
+        value = READ32LE(((uint32_t*)&gbaCore.g_oam[address & 0x3FC]));
         break;
     case 8:
     case 9:
     case 10:
     case 11:
     case 12:
-        value = READ32LE(((uint32_t*)&g_rom[address & 0x1FFFFFC]));
+        value = READ32LE(((uint32_t*)&gbaCore.g_rom[address & 0x1FFFFFC]));
         break;
     case 13:
-        if (cpuEEPROMEnabled)
+        if (gbaCore.cpuEEPROMEnabled) {
+            gbaCore.idleLoopVolatileRead = true;
             // no need to swap this
             return eepromRead(address);
+        }
         goto unreadable;
     case 14:
     case 15:
-        if (cpuFlashEnabled | cpuSramEnabled) { // no need to swap this
+        if (gbaCore.cpuFlashEnabled | gbaCore.cpuSramEnabled) { // no need to swap this
+            gbaCore.idleLoopVolatileRead = true;
             value = flashRead(address) * 0x01010101;
             break;
         }
@@ -167,21 +167,22 @@ static inline uint32_t CPUReadMemory(uint32_t address)
         if (systemVerbose & VERBOSE_ILLEGAL_READ) {
             log("Illegal word read: %08x at %08x\n",
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
 #endif
-        if (cpuDmaRunning || ((reg[15].I - cpuDmaPC) == (armState ? 4u : 2u))) {
-            value = cpuDmaLast;
+        if (gbaCore.cpuDmaRunning || ((gbaCore.reg[15].I - gbaCore.cpuDmaPC) == (gbaCore.armState ? 4u : 2u))) {
+            value = gbaCore.cpuDmaLast;
         } else {
-            if (armState) {
-                value = CPUReadMemoryQuick(reg[15].I);
+            if (gbaCore.armState) {
+                value = CPUReadMemoryQuick(gbaCore.reg[15].I);
             } else {
-                value = CPUReadHalfWordQuick(reg[15].I) | CPUReadHalfWordQuick(reg[15].I) << 16;
+                value = CPUReadHalfWordQuick(gbaCore.reg[15].I) | CPUReadHalfWordQuick(gbaCore.reg[15].I) << 16;
             }
         }
         break;
     }
 
+rotate:
     if (address & 3) {
 #ifdef C_CORE
         int shift = (address & 3) << 3;
@@ -209,7 +210,7 @@ static inline uint32_t CPUReadMemory(uint32_t address)
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
             log("Unaligned word read from: %08x at %08x (%08x)\n",
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2,
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2,
                 value);
         }
     }
@@ -220,7 +221,7 @@ static inline uint32_t CPUReadMemory(uint32_t address)
 static inline uint32_t CPUReadHalfWord(uint32_t address)
 {
 #ifdef VBAM_ENABLE_DEBUGGER
-    memoryMap* m = &map[address >> 24];
+    memoryMap* m = &gbaCore.map[address >> 24];
     if (m->breakPoints && BreakReadCheck(m->breakPoints, address & m->mask)) {
         if (debuggerBreakOnRead(address, 1)) {
             // CPU_BREAK_LOOP_2;
@@ -230,82 +231,94 @@ static inline uint32_t CPUReadHalfWord(uint32_t address)
 
     uint32_t value = 0;
 
+    if (const uint8_t* page = cpuReadPage(address)) {
+        value = READ16LE(((const uint16_t*)&page[address & (kPageMask & ~1)]));
+        goto rotate;
+    }
+
     switch (address >> 24) {
     case 0:
-        if (reg[15].I >> 24) {
+        if (gbaCore.reg[15].I >> 24) {
             if (address < 0x4000) {
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_ILLEGAL_READ) {
                     log("Illegal halfword read from bios: %08x at %08x\n",
                         address,
-                        armMode ? armNextPC - 4 : armNextPC - 2);
+                        gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
                 }
 #endif
-                value = READ16LE(((uint16_t*)&biosProtected[address & 2]));
+                value = READ16LE(((uint16_t*)&gbaCore.biosProtected[address & 2]));
             } else
                 goto unreadable;
         } else
-            value = READ16LE(((uint16_t*)&g_bios[address & 0x3FFE]));
+            value = READ16LE(((uint16_t*)&gbaCore.g_bios[address & 0x3FFE]));
         break;
     case 2:
-        value = READ16LE(((uint16_t*)&g_workRAM[address & 0x3FFFE]));
+        value = READ16LE(((uint16_t*)&gbaCore.g_workRAM[address & 0x3FFFE]));
         break;
     case 3:
-        value = READ16LE(((uint16_t*)&g_internalRAM[address & 0x7ffe]));
+        value = READ16LE(((uint16_t*)&gbaCore.g_internalRAM[address & 0x7ffe]));
         break;
     case 4:
-        if ((address < 0x4000400) && ioReadable[address & 0x3fe]) {
-            value = READ16LE(((uint16_t*)&g_ioMem[address & 0x3fe]));
+        if ((address < 0x4000400) && gbaCore.ioReadable[address & 0x3fe]) {
+            value = READ16LE(((uint16_t*)&gbaCore.g_ioMem[address & 0x3fe]));
+            if (CPUIsSerialRegister(address))
+                gbaCore.idleLoopVolatileRead = true;
             if (((address & 0x3fe) > 0xFF) && ((address & 0x3fe) < 0x10E)) {
-                if (((address & 0x3fe) == 0x100) && timer0On)
-                    value = 0xFFFF - ((timer0Ticks - cpuTotalTicks) >> timer0ClockReload);
-                else if (((address & 0x3fe) == 0x104) && timer1On && !(TM1CNT & 4))
-                    value = 0xFFFF - ((timer1Ticks - cpuTotalTicks) >> timer1ClockReload);
-                else if (((address & 0x3fe) == 0x108) && timer2On && !(TM2CNT & 4))
-                    value = 0xFFFF - ((timer2Ticks - cpuTotalTicks) >> timer2ClockReload);
-                else if (((address & 0x3fe) == 0x10C) && timer3On && !(TM3CNT & 4))
-                    value = 0xFFFF - ((timer3Ticks - cpuTotalTicks) >> timer3ClockReload);
+                gbaCore.idleLoopVolatileRead = true;
+                if (((address & 0x3fe) == 0x100) && gbaCore.timer0On)
+                    value = 0xFFFF - ((gbaSchedulerTicksLeft(kGbaEventTimer0) - gbaCore.cpuTotalTicks) >> gbaCore.timer0ClockReload);
+                else if (((address & 0x3fe) == 0x104) && gbaCore.timer1On && !(gbaCore.TM1CNT & 4))
+                    value = 0xFFFF - ((gbaSchedulerTicksLeft(kGbaEventTimer1) - gbaCore.cpuTotalTicks) >> gbaCore.timer1ClockReload);
+                else if (((address & 0x3fe) == 0x108) && gbaCore.timer2On && !(gbaCore.TM2CNT & 4))
+                    value = 0xFFFF - ((gbaSchedulerTicksLeft(kGbaEventTimer2) - gbaCore.cpuTotalTicks) >> gbaCore.timer2ClockReload);
+                else if (((address & 0x3fe) == 0x10C) && gbaCore.timer3On && !(gbaCore.TM3CNT & 4))
+                    value = 0xFFFF - ((gbaSchedulerTicksLeft(kGbaEventTimer3) - gbaCore.cpuTotalTicks) >> gbaCore.timer3ClockReload);
             }
-        } else if ((address < 0x4000400) && ioReadable[address & 0x3fc]) {
+        } else if ((address < 0x4000400) && gbaCore.ioReadable[address & 0x3fc]) {
             value = 0;
         } else
             goto unreadable;
         break;
     case 5:
-        value = READ16LE(((uint16_t*)&g_paletteRAM[address & 0x3fe]));
+        value = READ16LE(((uint16_t*)&gbaCore.g_paletteRAM[address & 0x3fe]));
         break;
     case 6: {
         unsigned addr = (address & 0x1fffe);
-        if (((DISPCNT & 7) > 2) && ((addr & 0x1C000) == 0x18000)) {
+        if (((gbaCore.DISPCNT & 7) > 2) && ((addr & 0x1C000) == 0x18000)) {
             value = 0;
             break;
         }
         if ((addr & 0x18000) == 0x18000)
             addr &= 0x17fff;
-        value = READ16LE(((uint16_t*)&g_vram[addr]));
+        value = READ16LE(((uint16_t*)&gbaCore.g_vram[addr]));
         break;
     }
     case 7:
-        value = READ16LE(((uint16_t*)&g_oam[address & 0x3fe]));
+        value = READ16LE(((uint16_t*)&gbaCore.g_oam[address & 0x3fe]));
         break;
     case 8:
     case 9:
     case 10:
     case 11:
     case 12:
-        if (address == 0x80000c4 || address == 0x80000c6 || address == 0x80000c8)
+        if (address == 0x80000c4 || address == 0x80000c6 || address == 0x80000c8) {
+            gbaCore.idleLoopVolatileRead = true;
             value = rtcRead(address);
-        else
-            value = READ16LE(((uint16_t*)&g_rom[address & 0x1FFFFFE]));
+        } else
+            value = READ16LE(((uint16_t*)&gbaCore.g_rom[address & 0x1FFFFFE]));
         break;
     case 13:
-        if (cpuEEPROMEnabled)
+        if (gbaCore.cpuEEPROMEnabled) {
+            gbaCore.idleLoopVolatileRead = true;
             // no need to swap this
             return eepromRead(address);
+        }
         goto unreadable;
     case 14:
     case 15:
-        if (cpuFlashEnabled | cpuSramEnabled) {
+        if (gbaCore.cpuFlashEnabled | gbaCore.cpuSramEnabled) {
+            gbaCore.idleLoopVolatileRead = true;
             // no need to swap this
             value = flashRead(address) * 0x0101;
             break;
@@ -313,11 +326,11 @@ static inline uint32_t CPUReadHalfWord(uint32_t address)
 	/* fallthrough */
     default:
     unreadable:
-        if (cpuDmaRunning|| ((reg[15].I - cpuDmaPC) == (armState ? 4u : 2u))) {
-            value = cpuDmaLast & 0xFFFF;
+        if (gbaCore.cpuDmaRunning|| ((gbaCore.reg[15].I - gbaCore.cpuDmaPC) == (gbaCore.armState ? 4u : 2u))) {
+            value = gbaCore.cpuDmaLast & 0xFFFF;
         } else {
-            int param = reg[15].I;
-            if (armState)
+            int param = gbaCore.reg[15].I;
+            if (gbaCore.armState)
                 param += (address & 2);
             value = CPUReadHalfWordQuick(param);
         }
@@ -325,20 +338,21 @@ static inline uint32_t CPUReadHalfWord(uint32_t address)
         if (systemVerbose & VERBOSE_ILLEGAL_READ) {
             log("Illegal halfword read: %08x at %08x (%08x)\n",
                 address,
-                reg[15].I,
+                gbaCore.reg[15].I,
                 value);
         }
 #endif
         break;
     }
 
+rotate:
     if (address & 1) {
         value = (value >> 8) | (value << 24);
 #ifdef GBA_LOGGING
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
             log("Unaligned halfword read from: %08x at %08x (%08x)\n",
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2,
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2,
                 value);
         }
 #endif
@@ -355,7 +369,7 @@ static inline int16_t CPUReadHalfWordSigned(uint32_t address)
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
             log("Unaligned signed halfword read from: %08x at %08x (%08x)\n",
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2,
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2,
                 value);
         }
 #endif
@@ -367,7 +381,7 @@ static inline int16_t CPUReadHalfWordSigned(uint32_t address)
 static inline uint8_t CPUReadByte(uint32_t address)
 {
 #ifdef VBAM_ENABLE_DEBUGGER
-    memoryMap* m = &map[address >> 24];
+    memoryMap* m = &gbaCore.map[address >> 24];
     if (m->breakPoints && BreakReadCheck(m->breakPoints, address & m->mask)) {
         if (debuggerBreakOnRead(address, 0)) {
             // CPU_BREAK_LOOP_2;
@@ -375,55 +389,64 @@ static inline uint8_t CPUReadByte(uint32_t address)
     }
 #endif
 
+    if (const uint8_t* page = cpuReadPage(address))
+        return page[address & kPageMask];
+
     switch (address >> 24) {
     case 0:
-        if (reg[15].I >> 24) {
+        if (gbaCore.reg[15].I >> 24) {
             if (address < 0x4000) {
 #ifdef GBA_LOGGING
                 if (systemVerbose & VERBOSE_ILLEGAL_READ) {
                     log("Illegal byte read from bios: %08x at %08x\n",
                         address,
-                        armMode ? armNextPC - 4 : armNextPC - 2);
+                        gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
                 }
 #endif
-                return biosProtected[address & 3];
+                return gbaCore.biosProtected[address & 3];
             } else
                 goto unreadable;
         }
-        return g_bios[address & 0x3FFF];
+        return gbaCore.g_bios[address & 0x3FFF];
     case 2:
-        return g_workRAM[address & 0x3FFFF];
+        return gbaCore.g_workRAM[address & 0x3FFFF];
     case 3:
-        return g_internalRAM[address & 0x7fff];
+        return gbaCore.g_internalRAM[address & 0x7fff];
     case 4:
-        if ((address < 0x4000400) && ioReadable[address & 0x3ff])
-            return g_ioMem[address & 0x3ff];
-        else
+        if ((address < 0x4000400) && gbaCore.ioReadable[address & 0x3ff]) {
+            if (CPUIsSerialRegister(address))
+                gbaCore.idleLoopVolatileRead = true;
+            return gbaCore.g_ioMem[address & 0x3ff];
+        } else
             goto unreadable;
     case 5:
-        return g_paletteRAM[address & 0x3ff];
+        return gbaCore.g_paletteRAM[address & 0x3ff];
     case 6:
         address = (address & 0x1ffff);
-        if (((DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
+        if (((gbaCore.DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
             return 0;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
-        return g_vram[address];
+        return gbaCore.g_vram[address];
     case 7:
-        return g_oam[address & 0x3ff];
+        return gbaCore.g_oam[address & 0x3ff];
     case 8:
     case 9:
     case 10:
     case 11:
     case 12:
-        return g_rom[address & 0x1FFFFFF];
+        return gbaCore.g_rom[address & 0x1FFFFFF];
     case 13:
-        if (cpuEEPROMEnabled)
+        if (gbaCore.cpuEEPROMEnabled) {
+            gbaCore.idleLoopVolatileRead = true;
             return DowncastU8(eepromRead(address));
+        }
         goto unreadable;
     case 14:
     case 15:
-        if (cpuSramEnabled | cpuFlashEnabled)
+        // the save chips and the tilt sensor
+        gbaCore.idleLoopVolatileRead = true;
+        if (gbaCore.cpuSramEnabled | gbaCore.cpuFlashEnabled)
             return flashRead(address);
 
         switch (address & 0x00008f00) {
@@ -443,16 +466,16 @@ static inline uint8_t CPUReadByte(uint32_t address)
         if (systemVerbose & VERBOSE_ILLEGAL_READ) {
             log("Illegal byte read: %08x at %08x\n",
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
 #endif
-        if (cpuDmaRunning || ((reg[15].I - cpuDmaPC) == (armState ? 4u : 2u))) {
-            return cpuDmaLast & 0xFF;
+        if (gbaCore.cpuDmaRunning || ((gbaCore.reg[15].I - gbaCore.cpuDmaPC) == (gbaCore.armState ? 4u : 2u))) {
+            return gbaCore.cpuDmaLast & 0xFF;
         } else {
-            if (armState) {
-                return CPUReadByteQuick(reg[15].I + (address & 3));
+            if (gbaCore.armState) {
+                return CPUReadByteQuick(gbaCore.reg[15].I + (address & 3));
             } else {
-                return CPUReadByteQuick(reg[15].I + (address & 1));
+                return CPUReadByteQuick(gbaCore.reg[15].I + (address & 1));
             }
         }
     }
@@ -460,19 +483,21 @@ static inline uint8_t CPUReadByte(uint32_t address)
 
 static inline void CPUWriteMemory(uint32_t address, uint32_t value)
 {
+    cpuDecodeCacheInvalidate(address);
+
 #ifdef GBA_LOGGING
     if (address & 3) {
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
             log("Unaligned word write: %08x to %08x from %08x\n",
                 value,
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
     }
 #endif
 
 #ifdef VBAM_ENABLE_DEBUGGER
-    memoryMap* m = &map[address >> 24];
+    memoryMap* m = &gbaCore.map[address >> 24];
     if (m->breakPoints && BreakWriteCheck(m->breakPoints, address & m->mask)) {
         if (debuggerBreakOnWrite(address, value, 1)) {
             // CPU_BREAK_LOOP_2;
@@ -480,22 +505,27 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
     }
 #endif
 
+    if (uint8_t* page = cpuWritePage(address, 4)) {
+        WRITE32LE(((uint32_t*)&page[address & (kPageMask & ~3)]), value);
+        return;
+    }
+
     switch (address >> 24) {
     case 0x02:
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint32_t*)&freezeWorkRAM[address & 0x3FFFC]))
+        if (*((uint32_t*)&gbaCore.freezeWorkRAM[address & 0x3FFFC]))
             cheatsWriteMemory(address & 0x203FFFC, value);
         else
 #endif
-            WRITE32LE(((uint32_t*)&g_workRAM[address & 0x3FFFC]), value);
+            WRITE32LE(((uint32_t*)&gbaCore.g_workRAM[address & 0x3FFFC]), value);
         break;
     case 0x03:
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint32_t*)&freezeInternalRAM[address & 0x7ffc]))
+        if (*((uint32_t*)&gbaCore.freezeInternalRAM[address & 0x7ffc]))
             cheatsWriteMemory(address & 0x3007FFC, value);
         else
 #endif
-            WRITE32LE(((uint32_t*)&g_internalRAM[address & 0x7ffC]), value);
+            WRITE32LE(((uint32_t*)&gbaCore.g_internalRAM[address & 0x7ffC]), value);
         break;
     case 0x04:
         if (address < 0x4000400) {
@@ -505,46 +535,51 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
             goto unwritable;
         break;
     case 0x05:
+        gfxThreadsTouch(kGfxPalette, address & 0x3ff);
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint32_t*)&freezePRAM[address & 0x3fc]))
+        if (*((uint32_t*)&gbaCore.freezePRAM[address & 0x3fc]))
             cheatsWriteMemory(address & 0x70003FC, value);
         else
 #endif
-            WRITE32LE(((uint32_t*)&g_paletteRAM[address & 0x3FC]), value);
+            WRITE32LE(((uint32_t*)&gbaCore.g_paletteRAM[address & 0x3FC]), value);
         break;
     case 0x06:
         address = (address & 0x1fffc);
-        if (((DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
+        if (((gbaCore.DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
             return;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
+        gfxTileCacheInvalidate(address);
+        gfxThreadsTouch(kGfxVram, address);
 
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint32_t*)&freezeVRAM[address]))
+        if (*((uint32_t*)&gbaCore.freezeVRAM[address]))
             cheatsWriteMemory(address + 0x06000000, value);
         else
 #endif
 
-            WRITE32LE(((uint32_t*)&g_vram[address]), value);
+            WRITE32LE(((uint32_t*)&gbaCore.g_vram[address]), value);
         break;
     case 0x07:
+        gfxSpriteIndexInvalidate(address & ~3);
+        gfxThreadsTouch(kGfxOam, address & 0x3ff);
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint32_t*)&freezeOAM[address & 0x3fc]))
+        if (*((uint32_t*)&gbaCore.freezeOAM[address & 0x3fc]))
             cheatsWriteMemory(address & 0x70003FC, value);
         else
 #endif
-            WRITE32LE(((uint32_t*)&g_oam[address & 0x3fc]), value);
+            WRITE32LE(((uint32_t*)&gbaCore.g_oam[address & 0x3fc]), value);
         break;
     case 0x0D:
-        if (cpuEEPROMEnabled) {
+        if (gbaCore.cpuEEPROMEnabled) {
             eepromWrite(address, DowncastU8(value));
             break;
         }
         goto unwritable;
     case 0x0E:
     case 0x0F:
-        if ((!eepromInUse) | cpuSramEnabled | cpuFlashEnabled) {
-            (*cpuSaveGameFunc)(address, (uint8_t)value);
+        if ((!gbaCore.eepromInUse) | gbaCore.cpuSramEnabled | gbaCore.cpuFlashEnabled) {
+            (*gbaCore.cpuSaveGameFunc)(address, (uint8_t)value);
             break;
         }
         goto unwritable;
@@ -556,7 +591,7 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
             log("Illegal word write: %08x to %08x from %08x\n",
                 value,
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
 #endif
         break;
@@ -565,19 +600,21 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
 
 static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
 {
+    cpuDecodeCacheInvalidate(address);
+
 #ifdef GBA_LOGGING
     if (address & 1) {
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
             log("Unaligned halfword write: %04x to %08x from %08x\n",
                 value,
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
     }
 #endif
 
 #ifdef VBAM_ENABLE_DEBUGGER
-    memoryMap* m = &map[address >> 24];
+    memoryMap* m = &gbaCore.map[address >> 24];
     if (m->breakPoints && BreakWriteCheck(m->breakPoints, address & m->mask)) {
         if (debuggerBreakOnWrite(address, value, 1)) {
             // CPU_BREAK_LOOP_2;
@@ -585,22 +622,27 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
     }
 #endif
 
+    if (uint8_t* page = cpuWritePage(address, 2)) {
+        WRITE16LE(((uint16_t*)&page[address & (kPageMask & ~1)]), value);
+        return;
+    }
+
     switch (address >> 24) {
     case 2:
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint16_t*)&freezeWorkRAM[address & 0x3FFFE]))
+        if (*((uint16_t*)&gbaCore.freezeWorkRAM[address & 0x3FFFE]))
             cheatsWriteHalfWord(address & 0x203FFFE, value);
         else
 #endif
-            WRITE16LE(((uint16_t*)&g_workRAM[address & 0x3FFFE]), value);
+            WRITE16LE(((uint16_t*)&gbaCore.g_workRAM[address & 0x3FFFE]), value);
         break;
     case 3:
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint16_t*)&freezeInternalRAM[address & 0x7ffe]))
+        if (*((uint16_t*)&gbaCore.freezeInternalRAM[address & 0x7ffe]))
             cheatsWriteHalfWord(address & 0x3007ffe, value);
         else
 #endif
-            WRITE16LE(((uint16_t*)&g_internalRAM[address & 0x7ffe]), value);
+            WRITE16LE(((uint16_t*)&gbaCore.g_internalRAM[address & 0x7ffe]), value);
         break;
     case 4:
         if (address < 0x4000400)
@@ -609,33 +651,38 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
             goto unwritable;
         break;
     case 5:
+        gfxThreadsTouch(kGfxPalette, address & 0x3ff);
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint16_t*)&freezePRAM[address & 0x03fe]))
+        if (*((uint16_t*)&gbaCore.freezePRAM[address & 0x03fe]))
             cheatsWriteHalfWord(address & 0x70003fe, value);
         else
 #endif
-            WRITE16LE(((uint16_t*)&g_paletteRAM[address & 0x3fe]), value);
+            WRITE16LE(((uint16_t*)&gbaCore.g_paletteRAM[address & 0x3fe]), value);
         break;
     case 6:
         address = (address & 0x1fffe);
-        if (((DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
+        if (((gbaCore.DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
             return;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
+        gfxTileCacheInvalidate(address);
+        gfxThreadsTouch(kGfxVram, address);
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint16_t*)&freezeVRAM[address]))
+        if (*((uint16_t*)&gbaCore.freezeVRAM[address]))
             cheatsWriteHalfWord(address + 0x06000000, value);
         else
 #endif
-            WRITE16LE(((uint16_t*)&g_vram[address]), value);
+            WRITE16LE(((uint16_t*)&gbaCore.g_vram[address]), value);
         break;
     case 7:
+        gfxSpriteIndexInvalidate(address);
+        gfxThreadsTouch(kGfxOam, address & 0x3ff);
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (*((uint16_t*)&freezeOAM[address & 0x03fe]))
+        if (*((uint16_t*)&gbaCore.freezeOAM[address & 0x03fe]))
             cheatsWriteHalfWord(address & 0x70003fe, value);
         else
 #endif
-            WRITE16LE(((uint16_t*)&g_oam[address & 0x3fe]), value);
+            WRITE16LE(((uint16_t*)&gbaCore.g_oam[address & 0x3fe]), value);
         break;
     case 8:
     case 9:
@@ -646,15 +693,15 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
             goto unwritable;
         break;
     case 13:
-        if (cpuEEPROMEnabled) {
+        if (gbaCore.cpuEEPROMEnabled) {
             eepromWrite(address, (uint8_t)value);
             break;
         }
         goto unwritable;
     case 14:
     case 15:
-        if ((!eepromInUse) | cpuSramEnabled | cpuFlashEnabled) {
-            (*cpuSaveGameFunc)(address, (uint8_t)value);
+        if ((!gbaCore.eepromInUse) | gbaCore.cpuSramEnabled | gbaCore.cpuFlashEnabled) {
+            (*gbaCore.cpuSaveGameFunc)(address, (uint8_t)value);
             break;
         }
         /* fallthrough */
@@ -665,7 +712,7 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
             log("Illegal halfword write: %04x to %08x from %08x\n",
                 value,
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
 #endif
         break;
@@ -674,8 +721,10 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
 
 static inline void CPUWriteByte(uint32_t address, uint8_t b)
 {
+    cpuDecodeCacheInvalidate(address);
+
 #ifdef VBAM_ENABLE_DEBUGGER
-    memoryMap* m = &map[address >> 24];
+    memoryMap* m = &gbaCore.map[address >> 24];
     if (m->breakPoints && BreakWriteCheck(m->breakPoints, address & m->mask)) {
         if (debuggerBreakOnWrite(address, b, 1)) {
             // CPU_BREAK_LOOP_2;
@@ -683,22 +732,27 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
     }
 #endif
 
+    if (uint8_t* page = cpuWritePage(address, 1)) {
+        page[address & kPageMask] = b;
+        return;
+    }
+
     switch (address >> 24) {
     case 2:
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (freezeWorkRAM[address & 0x3FFFF])
+        if (gbaCore.freezeWorkRAM[address & 0x3FFFF])
             cheatsWriteByte(address & 0x203FFFF, b);
         else
 #endif
-            g_workRAM[address & 0x3FFFF] = b;
+            gbaCore.g_workRAM[address & 0x3FFFF] = b;
         break;
     case 3:
 #ifdef VBAM_ENABLE_DEBUGGER
-        if (freezeInternalRAM[address & 0x7fff])
+        if (gbaCore.freezeInternalRAM[address & 0x7fff])
             cheatsWriteByte(address & 0x3007fff, b);
         else
 #endif
-            g_internalRAM[address & 0x7fff] = b;
+            gbaCore.g_internalRAM[address & 0x7fff] = b;
         break;
     case 4:
         if (address < 0x4000400) {
@@ -747,19 +801,19 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
                 break;
             case 0x301: // HALTCNT, undocumented
                 if (b == 0x80)
-                    stopState = true;
-                holdState = 1;
-                holdType = -1;
-                cpuNextEvent = cpuTotalTicks;
+                    gbaCore.stopState = true;
+                gbaCore.holdState = 1;
+                gbaCore.holdType = -1;
+                gbaCore.cpuNextEvent = gbaCore.cpuTotalTicks;
                 break;
             default: // every other register
                 uint32_t lowerBits = address & 0x3fe;
                 if (address & 1) {
                     CPUUpdateRegister(lowerBits,
-                        (READ16LE(&g_ioMem[lowerBits]) & 0x00FF) | (b << 8));
+                        (READ16LE(&gbaCore.g_ioMem[lowerBits]) & 0x00FF) | (b << 8));
                 } else {
                     CPUUpdateRegister(lowerBits,
-                        (READ16LE(&g_ioMem[lowerBits]) & 0xFF00) | b);
+                        (READ16LE(&gbaCore.g_ioMem[lowerBits]) & 0xFF00) | b);
                 }
             }
             break;
@@ -767,25 +821,28 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
             goto unwritable;
         break;
     case 5:
+        gfxThreadsTouch(kGfxPalette, address & 0x3ff);
         // no need to switch
-        *((uint16_t*)&g_paletteRAM[address & 0x3FE]) = (b << 8) | b;
+        *((uint16_t*)&gbaCore.g_paletteRAM[address & 0x3FE]) = (b << 8) | b;
         break;
     case 6:
         address = (address & 0x1fffe);
-        if (((DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
+        if (((gbaCore.DISPCNT & 7) > 2) && ((address & 0x1C000) == 0x18000))
             return;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
 
         // no need to switch
         // byte writes to OBJ VRAM are ignored
-        if ((address) < objTilesAddress[((DISPCNT & 7) + 1) >> 2]) {
+        if ((address) < objTilesAddress[((gbaCore.DISPCNT & 7) + 1) >> 2]) {
+            gfxTileCacheInvalidate(address);
+            gfxThreadsTouch(kGfxVram, address);
 #ifdef VBAM_ENABLE_DEBUGGER
-            if (freezeVRAM[address])
+            if (gbaCore.freezeVRAM[address])
                 cheatsWriteByte(address + 0x06000000, b);
             else
 #endif
-                *((uint16_t*)&g_vram[address]) = (b << 8) | b;
+                *((uint16_t*)&gbaCore.g_vram[address]) = (b << 8) | b;
         }
         break;
     case 7:
@@ -794,17 +851,17 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
         //    *((uint16_t *)&g_oam[address & 0x3FE]) = (b << 8) | b;
         break;
     case 13:
-        if (cpuEEPROMEnabled) {
+        if (gbaCore.cpuEEPROMEnabled) {
             eepromWrite(address, b);
             break;
         }
         goto unwritable;
     case 14:
     case 15:
-        if ((coreOptions.saveType != 5) && ((!eepromInUse) | cpuSramEnabled | cpuFlashEnabled)) {
+        if ((coreOptions.saveType != 5) && ((!gbaCore.eepromInUse) | gbaCore.cpuSramEnabled | gbaCore.cpuFlashEnabled)) {
             // if(!cpuEEPROMEnabled && (cpuSramEnabled | cpuFlashEnabled)) {
 
-            (*cpuSaveGameFunc)(address, b);
+            (*gbaCore.cpuSaveGameFunc)(address, b);
             break;
         }
         goto unwritable;
@@ -816,7 +873,7 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
             log("Illegal byte write: %02x to %08x from %08x\n",
                 b,
                 address,
-                armMode ? armNextPC - 4 : armNextPC - 2);
+                gbaCore.armMode ? gbaCore.armNextPC - 4 : gbaCore.armNextPC - 2);
         }
 #endif
         break;
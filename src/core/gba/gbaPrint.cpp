@@ -4,23 +4,20 @@
 #include "core/gba/gbaGlobals.h"
 
 #define debuggerWriteHalfWord(addr, value) \
-    WRITE16LE((uint16_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask], (value))
+    WRITE16LE((uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask], (value))
 
 #define debuggerReadHalfWord(addr) \
-    READ16LE(((uint16_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
-
-static bool agbPrintEnabled = false;
-static bool agbPrintProtect = false;
+    READ16LE(((uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 bool agbPrintWrite(uint32_t address, uint16_t value)
 {
-    if (agbPrintEnabled) {
+    if (gbaCore.agbPrintEnabled) {
         if (address == 0x9fe2ffe) { // protect
-            agbPrintProtect = (value != 0);
+            gbaCore.agbPrintProtect = (value != 0);
             debuggerWriteHalfWord(address, value);
             return true;
         } else {
-            if (agbPrintProtect && ((address >= 0x9fe20f8 && address <= 0x9fe20ff) // control structure
+            if (gbaCore.agbPrintProtect && ((address >= 0x9fe20f8 && address <= 0x9fe20ff) // control structure
                                        || (address >= 0x8fd0000 && address <= 0x8fdffff)
                                        || (address >= 0x9fd0000 && address <= 0x9fdffff))) {
                 debuggerWriteHalfWord(address, value);
@@ -33,17 +30,17 @@ bool agbPrintWrite(uint32_t address, uint16_t value)
 
 void agbPrintReset()
 {
-    agbPrintProtect = false;
+    gbaCore.agbPrintProtect = false;
 }
 
 void agbPrintEnable(bool enable)
 {
-    agbPrintEnabled = enable;
+    gbaCore.agbPrintEnabled = enable;
 }
 
 bool agbPrintIsEnabled()
 {
-    return agbPrintEnabled;
+    return gbaCore.agbPrintEnabled;
 }
 
 void agbPrintFlush()
@@ -61,7 +58,7 @@ void agbPrintFlush()
         return;
     }
 
-    uint8_t* data = &g_rom[address];
+    uint8_t* data = &gbaCore.g_rom[address];
 
     while (get != put) {
         char c = data[get++];
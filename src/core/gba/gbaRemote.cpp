@@ -47,6 +47,9 @@
 #include "core/gba/gbaGlobals.h"
 #include "core/gba/gbaRemote.h"
 #include "core/gba/internal/gbaBreakpoint.h"
+#include "core/gba/internal/gbaDecodeCache.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
+#include "core/gba/internal/gbaTileCache.h"
 
 #if __STDC_WANT_SECURE_LIB__
 #define snprintf sprintf_s
@@ -76,22 +79,37 @@ void remoteSetSockets(SOCKET l, SOCKET r)
 #endif
 
 #define debuggerReadMemory(addr) \
-    (*(uint32_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask])
+    (*(uint32_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask])
 
 #define debuggerReadHalfWord(addr) \
-    (*(uint16_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask])
+    (*(uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask])
 
 #define debuggerReadByte(addr) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]
-
-#define debuggerWriteMemory(addr, value) \
-    *(uint32_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask] = (value)
-
-#define debuggerWriteHalfWord(addr, value) \
-    *(uint16_t*)&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask] = (value)
-
-#define debuggerWriteByte(addr, value) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask] = (value)
+    gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]
+
+#define debuggerWriteMemory(addr, value)                                                 \
+    do {                                                                                 \
+        cpuDecodeCacheFlush();                                                           \
+        gfxSpriteIndexFlush();                                                           \
+        gfxTileCacheFlush();                                                             \
+        *(uint32_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask] = (value); \
+    } while (0)
+
+#define debuggerWriteHalfWord(addr, value)                                               \
+    do {                                                                                 \
+        cpuDecodeCacheFlush();                                                           \
+        gfxSpriteIndexFlush();                                                           \
+        gfxTileCacheFlush();                                                             \
+        *(uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask] = (value); \
+    } while (0)
+
+#define debuggerWriteByte(addr, value)                                      \
+    do {                                                                    \
+        cpuDecodeCacheFlush();                                              \
+        gfxSpriteIndexFlush();                                              \
+        gfxTileCacheFlush();                                                \
+        gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask] = (value); \
+    } while (0)
 
 bool dontBreakNow = false;
 int debuggerNumOfDontBreak = 0;
@@ -165,7 +183,7 @@ void breakReg_check(int i)
             break;
         } else {
             if (brkR->flags != 0) {
-                uint32_t regVal = (i == 15 ? (armState ? reg[15].I - 4 : reg[15].I - 2) : reg[i].I);
+                uint32_t regVal = (i == 15 ? (gbaCore.armState ? gbaCore.reg[15].I - 4 : gbaCore.reg[15].I - 2) : gbaCore.reg[i].I);
                 if ((brkR->flags & 0x1) && (regVal == brkR->intVal)) {
                     debuggerBreakOnRegisterCondition(i, brkR->intVal, regVal, 1);
                     notFound = false;
@@ -579,14 +597,14 @@ bool debuggerBreakOnRegisterCondition(uint8_t registerName, uint32_t compareVal,
         snprintf(monbuf, sizeof(monbuf), "Breakpoint on R%02d : %08x is %s register content (%08x)\n", registerName, compareVal, typeName, regVal);
         monprintf(monbuf);
     }
-    if (debuggerInDB(armState ? reg[15].I - 4 : reg[15].I - 2)) {
+    if (debuggerInDB(gbaCore.armState ? gbaCore.reg[15].I - 4 : gbaCore.reg[15].I - 2)) {
         {
             snprintf(monbuf, sizeof(monbuf), "But this address is marked not to break, so skipped\n");
             monprintf(monbuf);
         }
         return false;
     }
-    debugger = true;
+    gbaCore.debugger = true;
     return true;
 }
 
@@ -632,7 +650,7 @@ void debuggerEditRegister(int n, char** args)
             }
             return;
         }
-        reg[r].I = val;
+        gbaCore.reg[r].I = val;
         {
             snprintf(monbuf, sizeof(monbuf), "R%02d=%08X\n", r, val);
             monprintf(monbuf);
@@ -775,22 +793,22 @@ unsigned int SearchResults;
 
 unsigned int AddressToGBA(uint8_t* mem)
 {
-    if (mem >= &g_bios[0] && mem <= &g_bios[0x3fff])
-        return 0x00000000 + (mem - &g_bios[0]);
-    else if (mem >= &g_workRAM[0] && mem <= &g_workRAM[0x3ffff])
-        return 0x02000000 + (mem - &g_workRAM[0]);
-    else if (mem >= &g_internalRAM[0] && mem <= &g_internalRAM[0x7fff])
-        return 0x03000000 + (mem - &g_internalRAM[0]);
-    else if (mem >= &g_ioMem[0] && mem <= &g_ioMem[0x3ff])
-        return 0x04000000 + (mem - &g_ioMem[0]);
-    else if (mem >= &g_paletteRAM[0] && mem <= &g_paletteRAM[0x3ff])
-        return 0x05000000 + (mem - &g_paletteRAM[0]);
-    else if (mem >= &g_vram[0] && mem <= &g_vram[0x1ffff])
-        return 0x06000000 + (mem - &g_vram[0]);
-    else if (mem >= &g_oam[0] && mem <= &g_oam[0x3ff])
-        return 0x07000000 + (mem - &g_oam[0]);
-    else if (mem >= &g_rom[0] && mem <= &g_rom[0x1ffffff])
-        return 0x08000000 + (mem - &g_rom[0]);
+    if (mem >= &gbaCore.g_bios[0] && mem <= &gbaCore.g_bios[0x3fff])
+        return 0x00000000 + (mem - &gbaCore.g_bios[0]);
+    else if (mem >= &gbaCore.g_workRAM[0] && mem <= &gbaCore.g_workRAM[0x3ffff])
+        return 0x02000000 + (mem - &gbaCore.g_workRAM[0]);
+    else if (mem >= &gbaCore.g_internalRAM[0] && mem <= &gbaCore.g_internalRAM[0x7fff])
+        return 0x03000000 + (mem - &gbaCore.g_internalRAM[0]);
+    else if (mem >= &gbaCore.g_ioMem[0] && mem <= &gbaCore.g_ioMem[0x3ff])
+        return 0x04000000 + (mem - &gbaCore.g_ioMem[0]);
+    else if (mem >= &gbaCore.g_paletteRAM[0] && mem <= &gbaCore.g_paletteRAM[0x3ff])
+        return 0x05000000 + (mem - &gbaCore.g_paletteRAM[0]);
+    else if (mem >= &gbaCore.g_vram[0] && mem <= &gbaCore.g_vram[0x1ffff])
+        return 0x06000000 + (mem - &gbaCore.g_vram[0]);
+    else if (mem >= &gbaCore.g_oam[0] && mem <= &gbaCore.g_oam[0x3ff])
+        return 0x07000000 + (mem - &gbaCore.g_oam[0]);
+    else if (mem >= &gbaCore.g_rom[0] && mem <= &gbaCore.g_rom[0x1ffffff])
+        return 0x08000000 + (mem - &gbaCore.g_rom[0]);
     else
         return 0xFFFFFFFF;
 };
@@ -810,8 +828,8 @@ void debuggerDoSearch()
                 SearchStart = 0x02000000;
                 continue;
             } else {
-                start = g_bios + (SearchStart & 0x3FFF);
-                end = g_bios + 0x3FFF;
+                start = gbaCore.g_bios + (SearchStart & 0x3FFF);
+                end = gbaCore.g_bios + 0x3FFF;
                 break;
             };
         case 2:
@@ -819,8 +837,8 @@ void debuggerDoSearch()
                 SearchStart = 0x03000000;
                 continue;
             } else {
-                start = g_workRAM + (SearchStart & 0x3FFFF);
-                end = g_workRAM + 0x3FFFF;
+                start = gbaCore.g_workRAM + (SearchStart & 0x3FFFF);
+                end = gbaCore.g_workRAM + 0x3FFFF;
                 break;
             };
         case 3:
@@ -828,8 +846,8 @@ void debuggerDoSearch()
                 SearchStart = 0x04000000;
                 continue;
             } else {
-                start = g_internalRAM + (SearchStart & 0x7FFF);
-                end = g_internalRAM + 0x7FFF;
+                start = gbaCore.g_internalRAM + (SearchStart & 0x7FFF);
+                end = gbaCore.g_internalRAM + 0x7FFF;
                 break;
             };
         case 4:
@@ -837,8 +855,8 @@ void debuggerDoSearch()
                 SearchStart = 0x05000000;
                 continue;
             } else {
-                start = g_ioMem + (SearchStart & 0x3FF);
-                end = g_ioMem + 0x3FF;
+                start = gbaCore.g_ioMem + (SearchStart & 0x3FF);
+                end = gbaCore.g_ioMem + 0x3FF;
                 break;
             };
         case 5:
@@ -846,8 +864,8 @@ void debuggerDoSearch()
                 SearchStart = 0x06000000;
                 continue;
             } else {
-                start = g_paletteRAM + (SearchStart & 0x3FF);
-                end = g_paletteRAM + 0x3FF;
+                start = gbaCore.g_paletteRAM + (SearchStart & 0x3FF);
+                end = gbaCore.g_paletteRAM + 0x3FF;
                 break;
             };
         case 6:
@@ -855,8 +873,8 @@ void debuggerDoSearch()
                 SearchStart = 0x07000000;
                 continue;
             } else {
-                start = g_vram + (SearchStart & 0x1FFFF);
-                end = g_vram + 0x1FFFF;
+                start = gbaCore.g_vram + (SearchStart & 0x1FFFF);
+                end = gbaCore.g_vram + 0x1FFFF;
                 break;
             };
         case 7:
@@ -864,8 +882,8 @@ void debuggerDoSearch()
                 SearchStart = 0x08000000;
                 continue;
             } else {
-                start = g_oam + (SearchStart & 0x3FF);
-                end = g_oam + 0x3FF;
+                start = gbaCore.g_oam + (SearchStart & 0x3FF);
+                end = gbaCore.g_oam + 0x3FF;
                 break;
             };
         case 8:
@@ -875,8 +893,8 @@ void debuggerDoSearch()
         case 12:
         case 13:
             if (final <= 0x09FFFFFF) {
-                start = g_rom + (SearchStart & 0x01FFFFFF);
-                end = g_rom + 0x01FFFFFF;
+                start = gbaCore.g_rom + (SearchStart & 0x01FFFFFF);
+                end = gbaCore.g_rom + 0x01FFFFFF;
                 break;
             };
         default: {
@@ -1175,71 +1193,71 @@ void debuggerCopyWord(int n, char** args)
 void debuggerIoVideo()
 {
     {
-        snprintf(monbuf, sizeof(monbuf), "DISPCNT  = %04x\n", DISPCNT);
+        snprintf(monbuf, sizeof(monbuf), "DISPCNT  = %04x\n", gbaCore.DISPCNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DISPSTAT = %04x\n", DISPSTAT);
+        snprintf(monbuf, sizeof(monbuf), "DISPSTAT = %04x\n", gbaCore.DISPSTAT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "VCOUNT   = %04x\n", VCOUNT);
+        snprintf(monbuf, sizeof(monbuf), "VCOUNT   = %04x\n", gbaCore.VCOUNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG0CNT   = %04x\n", BG0CNT);
+        snprintf(monbuf, sizeof(monbuf), "BG0CNT   = %04x\n", gbaCore.BG0CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG1CNT   = %04x\n", BG1CNT);
+        snprintf(monbuf, sizeof(monbuf), "BG1CNT   = %04x\n", gbaCore.BG1CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2CNT   = %04x\n", BG2CNT);
+        snprintf(monbuf, sizeof(monbuf), "BG2CNT   = %04x\n", gbaCore.BG2CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3CNT   = %04x\n", BG3CNT);
+        snprintf(monbuf, sizeof(monbuf), "BG3CNT   = %04x\n", gbaCore.BG3CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "WIN0H    = %04x\n", WIN0H);
+        snprintf(monbuf, sizeof(monbuf), "WIN0H    = %04x\n", gbaCore.WIN0H);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "WIN0V    = %04x\n", WIN0V);
+        snprintf(monbuf, sizeof(monbuf), "WIN0V    = %04x\n", gbaCore.WIN0V);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "WIN1H    = %04x\n", WIN1H);
+        snprintf(monbuf, sizeof(monbuf), "WIN1H    = %04x\n", gbaCore.WIN1H);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "WIN1V    = %04x\n", WIN1V);
+        snprintf(monbuf, sizeof(monbuf), "WIN1V    = %04x\n", gbaCore.WIN1V);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "WININ    = %04x\n", WININ);
+        snprintf(monbuf, sizeof(monbuf), "WININ    = %04x\n", gbaCore.WININ);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "WINOUT   = %04x\n", WINOUT);
+        snprintf(monbuf, sizeof(monbuf), "WINOUT   = %04x\n", gbaCore.WINOUT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "MOSAIC   = %04x\n", MOSAIC);
+        snprintf(monbuf, sizeof(monbuf), "MOSAIC   = %04x\n", gbaCore.MOSAIC);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BLDMOD   = %04x\n", BLDMOD);
+        snprintf(monbuf, sizeof(monbuf), "BLDMOD   = %04x\n", gbaCore.BLDMOD);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "COLEV    = %04x\n", COLEV);
+        snprintf(monbuf, sizeof(monbuf), "COLEV    = %04x\n", gbaCore.COLEV);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "COLY     = %04x\n", COLY);
+        snprintf(monbuf, sizeof(monbuf), "COLY     = %04x\n", gbaCore.COLY);
         monprintf(monbuf);
     }
 }
@@ -1247,83 +1265,83 @@ void debuggerIoVideo()
 void debuggerIoVideo2()
 {
     {
-        snprintf(monbuf, sizeof(monbuf), "BG0HOFS  = %04x\n", BG0HOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG0HOFS  = %04x\n", gbaCore.BG0HOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG0VOFS  = %04x\n", BG0VOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG0VOFS  = %04x\n", gbaCore.BG0VOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG1HOFS  = %04x\n", BG1HOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG1HOFS  = %04x\n", gbaCore.BG1HOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG1VOFS  = %04x\n", BG1VOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG1VOFS  = %04x\n", gbaCore.BG1VOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2HOFS  = %04x\n", BG2HOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG2HOFS  = %04x\n", gbaCore.BG2HOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2VOFS  = %04x\n", BG2VOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG2VOFS  = %04x\n", gbaCore.BG2VOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3HOFS  = %04x\n", BG3HOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG3HOFS  = %04x\n", gbaCore.BG3HOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3VOFS  = %04x\n", BG3VOFS);
+        snprintf(monbuf, sizeof(monbuf), "BG3VOFS  = %04x\n", gbaCore.BG3VOFS);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2PA    = %04x\n", BG2PA);
+        snprintf(monbuf, sizeof(monbuf), "BG2PA    = %04x\n", gbaCore.BG2PA);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2PB    = %04x\n", BG2PB);
+        snprintf(monbuf, sizeof(monbuf), "BG2PB    = %04x\n", gbaCore.BG2PB);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2PC    = %04x\n", BG2PC);
+        snprintf(monbuf, sizeof(monbuf), "BG2PC    = %04x\n", gbaCore.BG2PC);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2PD    = %04x\n", BG2PD);
+        snprintf(monbuf, sizeof(monbuf), "BG2PD    = %04x\n", gbaCore.BG2PD);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2X     = %08x\n", (BG2X_H << 16) | BG2X_L);
+        snprintf(monbuf, sizeof(monbuf), "BG2X     = %08x\n", (gbaCore.BG2X_H << 16) | gbaCore.BG2X_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG2Y     = %08x\n", (BG2Y_H << 16) | BG2Y_L);
+        snprintf(monbuf, sizeof(monbuf), "BG2Y     = %08x\n", (gbaCore.BG2Y_H << 16) | gbaCore.BG2Y_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3PA    = %04x\n", BG3PA);
+        snprintf(monbuf, sizeof(monbuf), "BG3PA    = %04x\n", gbaCore.BG3PA);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3PB    = %04x\n", BG3PB);
+        snprintf(monbuf, sizeof(monbuf), "BG3PB    = %04x\n", gbaCore.BG3PB);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3PC    = %04x\n", BG3PC);
+        snprintf(monbuf, sizeof(monbuf), "BG3PC    = %04x\n", gbaCore.BG3PC);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3PD    = %04x\n", BG3PD);
+        snprintf(monbuf, sizeof(monbuf), "BG3PD    = %04x\n", gbaCore.BG3PD);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3X     = %08x\n", (BG3X_H << 16) | BG3X_L);
+        snprintf(monbuf, sizeof(monbuf), "BG3X     = %08x\n", (gbaCore.BG3X_H << 16) | gbaCore.BG3X_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "BG3Y     = %08x\n", (BG3Y_H << 16) | BG3Y_L);
+        snprintf(monbuf, sizeof(monbuf), "BG3Y     = %08x\n", (gbaCore.BG3Y_H << 16) | gbaCore.BG3Y_L);
         monprintf(monbuf);
     }
 }
@@ -1331,51 +1349,51 @@ void debuggerIoVideo2()
 void debuggerIoDMA()
 {
     {
-        snprintf(monbuf, sizeof(monbuf), "DM0SAD   = %08x\n", (DM0SAD_H << 16) | DM0SAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM0SAD   = %08x\n", (gbaCore.DM0SAD_H << 16) | gbaCore.DM0SAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM0DAD   = %08x\n", (DM0DAD_H << 16) | DM0DAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM0DAD   = %08x\n", (gbaCore.DM0DAD_H << 16) | gbaCore.DM0DAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM0CNT   = %08x\n", (DM0CNT_H << 16) | DM0CNT_L);
+        snprintf(monbuf, sizeof(monbuf), "DM0CNT   = %08x\n", (gbaCore.DM0CNT_H << 16) | gbaCore.DM0CNT_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM1SAD   = %08x\n", (DM1SAD_H << 16) | DM1SAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM1SAD   = %08x\n", (gbaCore.DM1SAD_H << 16) | gbaCore.DM1SAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM1DAD   = %08x\n", (DM1DAD_H << 16) | DM1DAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM1DAD   = %08x\n", (gbaCore.DM1DAD_H << 16) | gbaCore.DM1DAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM1CNT   = %08x\n", (DM1CNT_H << 16) | DM1CNT_L);
+        snprintf(monbuf, sizeof(monbuf), "DM1CNT   = %08x\n", (gbaCore.DM1CNT_H << 16) | gbaCore.DM1CNT_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM2SAD   = %08x\n", (DM2SAD_H << 16) | DM2SAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM2SAD   = %08x\n", (gbaCore.DM2SAD_H << 16) | gbaCore.DM2SAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM2DAD   = %08x\n", (DM2DAD_H << 16) | DM2DAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM2DAD   = %08x\n", (gbaCore.DM2DAD_H << 16) | gbaCore.DM2DAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM2CNT   = %08x\n", (DM2CNT_H << 16) | DM2CNT_L);
+        snprintf(monbuf, sizeof(monbuf), "DM2CNT   = %08x\n", (gbaCore.DM2CNT_H << 16) | gbaCore.DM2CNT_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM3SAD   = %08x\n", (DM3SAD_H << 16) | DM3SAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM3SAD   = %08x\n", (gbaCore.DM3SAD_H << 16) | gbaCore.DM3SAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM3DAD   = %08x\n", (DM3DAD_H << 16) | DM3DAD_L);
+        snprintf(monbuf, sizeof(monbuf), "DM3DAD   = %08x\n", (gbaCore.DM3DAD_H << 16) | gbaCore.DM3DAD_L);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "DM3CNT   = %08x\n", (DM3CNT_H << 16) | DM3CNT_L);
+        snprintf(monbuf, sizeof(monbuf), "DM3CNT   = %08x\n", (gbaCore.DM3CNT_H << 16) | gbaCore.DM3CNT_L);
         monprintf(monbuf);
     }
 }
@@ -1383,35 +1401,35 @@ void debuggerIoDMA()
 void debuggerIoTimer()
 {
     {
-        snprintf(monbuf, sizeof(monbuf), "TM0D     = %04x\n", TM0D);
+        snprintf(monbuf, sizeof(monbuf), "TM0D     = %04x\n", gbaCore.TM0D);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM0CNT   = %04x\n", TM0CNT);
+        snprintf(monbuf, sizeof(monbuf), "TM0CNT   = %04x\n", gbaCore.TM0CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM1D     = %04x\n", TM1D);
+        snprintf(monbuf, sizeof(monbuf), "TM1D     = %04x\n", gbaCore.TM1D);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM1CNT   = %04x\n", TM1CNT);
+        snprintf(monbuf, sizeof(monbuf), "TM1CNT   = %04x\n", gbaCore.TM1CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM2D     = %04x\n", TM2D);
+        snprintf(monbuf, sizeof(monbuf), "TM2D     = %04x\n", gbaCore.TM2D);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM2CNT   = %04x\n", TM2CNT);
+        snprintf(monbuf, sizeof(monbuf), "TM2CNT   = %04x\n", gbaCore.TM2CNT);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM3D     = %04x\n", TM3D);
+        snprintf(monbuf, sizeof(monbuf), "TM3D     = %04x\n", gbaCore.TM3D);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "TM3CNT   = %04x\n", TM3CNT);
+        snprintf(monbuf, sizeof(monbuf), "TM3CNT   = %04x\n", gbaCore.TM3CNT);
         monprintf(monbuf);
     }
 }
@@ -1419,19 +1437,19 @@ void debuggerIoTimer()
 void debuggerIoMisc()
 {
     {
-        snprintf(monbuf, sizeof(monbuf), "P1       = %04x\n", P1);
+        snprintf(monbuf, sizeof(monbuf), "P1       = %04x\n", gbaCore.P1);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "IE       = %04x\n", IE);
+        snprintf(monbuf, sizeof(monbuf), "IE       = %04x\n", gbaCore.IE);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "IF       = %04x\n", IF);
+        snprintf(monbuf, sizeof(monbuf), "IF       = %04x\n", gbaCore.IF);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "IME      = %04x\n", IME);
+        snprintf(monbuf, sizeof(monbuf), "IME      = %04x\n", gbaCore.IME);
         monprintf(monbuf);
     }
 }
@@ -1746,32 +1764,32 @@ void debuggerStringRead(int n, char** args)
 void debuggerRegisters(int, char**)
 {
     {
-        snprintf(monbuf, sizeof(monbuf), "R00=%08x R04=%08x R08=%08x R12=%08x\n", reg[0].I, reg[4].I, reg[8].I, reg[12].I);
+        snprintf(monbuf, sizeof(monbuf), "R00=%08x R04=%08x R08=%08x R12=%08x\n", gbaCore.reg[0].I, gbaCore.reg[4].I, gbaCore.reg[8].I, gbaCore.reg[12].I);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "R01=%08x R05=%08x R09=%08x R13=%08x\n", reg[1].I, reg[5].I, reg[9].I, reg[13].I);
+        snprintf(monbuf, sizeof(monbuf), "R01=%08x R05=%08x R09=%08x R13=%08x\n", gbaCore.reg[1].I, gbaCore.reg[5].I, gbaCore.reg[9].I, gbaCore.reg[13].I);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "R02=%08x R06=%08x R10=%08x R14=%08x\n", reg[2].I, reg[6].I, reg[10].I, reg[14].I);
+        snprintf(monbuf, sizeof(monbuf), "R02=%08x R06=%08x R10=%08x R14=%08x\n", gbaCore.reg[2].I, gbaCore.reg[6].I, gbaCore.reg[10].I, gbaCore.reg[14].I);
         monprintf(monbuf);
     }
     {
-        snprintf(monbuf, sizeof(monbuf), "R03=%08x R07=%08x R11=%08x R15=%08x\n", reg[3].I, reg[7].I, reg[11].I, reg[15].I);
+        snprintf(monbuf, sizeof(monbuf), "R03=%08x R07=%08x R11=%08x R15=%08x\n", gbaCore.reg[3].I, gbaCore.reg[7].I, gbaCore.reg[11].I, gbaCore.reg[15].I);
         monprintf(monbuf);
     }
     {
         snprintf(monbuf, sizeof(monbuf), "CPSR=%08x (%c%c%c%c%c%c%c Mode: %02x)\n",
-            reg[16].I,
-            (N_FLAG ? 'N' : '.'),
-            (Z_FLAG ? 'Z' : '.'),
-            (C_FLAG ? 'C' : '.'),
-            (V_FLAG ? 'V' : '.'),
-            (armIrqEnable ? '.' : 'I'),
-            ((!(reg[16].I & 0x40)) ? '.' : 'F'),
-            (armState ? '.' : 'T'),
-            armMode);
+            gbaCore.reg[16].I,
+            (gbaCore.N_FLAG ? 'N' : '.'),
+            (gbaCore.Z_FLAG ? 'Z' : '.'),
+            (gbaCore.C_FLAG ? 'C' : '.'),
+            (gbaCore.V_FLAG ? 'V' : '.'),
+            (gbaCore.armIrqEnable ? '.' : 'I'),
+            ((!(gbaCore.reg[16].I & 0x40)) ? '.' : 'F'),
+            (gbaCore.armState ? '.' : 'T'),
+            gbaCore.armMode);
         monprintf(monbuf);
     }
 }
@@ -1794,7 +1812,7 @@ void debuggerExecuteCommands(int n, char** args)
                 while (fgets(buffer, 4096, toExec)) {
                     std::string buf(buffer);
                     dbgExecute(buf);
-                    if (!debugger || !emulating) {
+                    if (!gbaCore.debugger || !emulating) {
                         return;
                     }
                 }
@@ -1900,7 +1918,7 @@ void debuggerWhere(int n, char** args)
     (void)n; // unused params
     (void)args; // unused params
     void elfPrintCallChain(uint32_t);
-    elfPrintCallChain(armNextPC);
+    elfPrintCallChain(gbaCore.armNextPC);
 }
 
 void debuggerVar(int n, char** args)
@@ -1980,14 +1998,14 @@ bool debuggerBreakOnExecution(uint32_t address, uint8_t state)
         return false;
     if (debuggerInDB(address))
         return false;
-    if (!doesBreak(address, armState ? 0x44 : 0x88))
+    if (!doesBreak(address, gbaCore.armState ? 0x44 : 0x88))
         return false;
 
     {
-        snprintf(monbuf, sizeof(monbuf), "Breakpoint (on %s) address %08x\n", (armState ? "ARM" : "Thumb"), address);
+        snprintf(monbuf, sizeof(monbuf), "Breakpoint (on %s) address %08x\n", (gbaCore.armState ? "ARM" : "Thumb"), address);
         monprintf(monbuf);
     }
-    debugger = true;
+    gbaCore.debugger = true;
     return true;
 }
 
@@ -1996,7 +2014,7 @@ bool debuggerBreakOnRead(uint32_t address, int size)
     (void)size; // unused params
     if (dontBreakNow)
         return false;
-    if (debuggerInDB(armState ? reg[15].I - 4 : reg[15].I - 2))
+    if (debuggerInDB(gbaCore.armState ? gbaCore.reg[15].I - 4 : gbaCore.reg[15].I - 2))
         return false;
     if (!doesBreak(address, 0x22))
         return false;
@@ -2009,7 +2027,7 @@ bool debuggerBreakOnRead(uint32_t address, int size)
     //else
     //	monprintf("Breakpoint (on read) address %08x value:%02x\n",
     //	address, debuggerReadByte(address));
-    debugger = true;
+    gbaCore.debugger = true;
     return true;
 }
 
@@ -2019,7 +2037,7 @@ bool debuggerBreakOnWrite(uint32_t address, uint32_t value, int size)
     (void)size; // unused params
     if (dontBreakNow)
         return false;
-    if (debuggerInDB(armState ? reg[15].I - 4 : reg[15].I - 2))
+    if (debuggerInDB(gbaCore.armState ? gbaCore.reg[15].I - 4 : gbaCore.reg[15].I - 2))
         return false;
     if (!doesBreak(address, 0x11))
         return false;
@@ -2034,7 +2052,7 @@ bool debuggerBreakOnWrite(uint32_t address, uint32_t value, int size)
     //else
     //	monprintf("Breakpoint (on write) address %08x old:%02x new:%02x\n",
     //	address, (uint8_t)lastValue, (uint8_t)value);
-    debugger = true;
+    gbaCore.debugger = true;
     return true;
 }
 
@@ -3626,7 +3644,7 @@ void remoteSendStatus()
     char* s = buffer;
     s += 3;
     for (int i = 0; i < 15; i++) {
-        uint32_t v = reg[i].I;
+        uint32_t v = gbaCore.reg[i].I;
         snprintf(s, sizeof(buffer), "%02x:%02x%02x%02x%02x;", i,
             (v & 255),
             (v >> 8) & 255,
@@ -3634,14 +3652,14 @@ void remoteSendStatus()
             (v >> 24) & 255);
         s += 12;
     }
-    uint32_t v = armNextPC;
+    uint32_t v = gbaCore.armNextPC;
     snprintf(s, sizeof(buffer), "0f:%02x%02x%02x%02x;", (v & 255),
         (v >> 8) & 255,
         (v >> 16) & 255,
         (v >> 24) & 255);
     s += 12;
     CPUUpdateCPSR();
-    v = reg[16].I;
+    v = gbaCore.reg[16].I;
     snprintf(s, sizeof(buffer), "19:%02x%02x%02x%02x;", (v & 255),
         (v >> 8) & 255,
         (v >> 16) & 255,
@@ -3767,9 +3785,9 @@ void remoteStepOverRange(char* p)
     remoteResumed = true;
     do {
         CPULoop(1);
-        if (debugger)
+        if (gbaCore.debugger)
             break;
-    } while (armNextPC >= address && armNextPC < final);
+    } while (gbaCore.armNextPC >= address && gbaCore.armNextPC < final);
 
     remoteResumed = false;
 
@@ -3783,7 +3801,7 @@ void remoteSetBreakPoint(char* p)
     sscanf(p, ",%x,%x#", &address, &count);
 
     for (int n = 0; n < count; n += 4)
-        addConditionalBreak(address + n, armState ? 0x04 : 0x08);
+        addConditionalBreak(address + n, gbaCore.armState ? 0x04 : 0x08);
 
     // Out of bounds memory checks
     //if (address < 0x2000000 || address > 0x3007fff) {
@@ -3817,7 +3835,7 @@ void remoteClearBreakPoint(char* p)
     sscanf(p, ",%x,%x#", &address, &count);
 
     for (int n = 0; n < count; n += 4)
-        result = removeConditionalWithAddressAndFlag(address + n, armState ? 0x04 : 0x08, true);
+        result = removeConditionalWithAddressAndFlag(address + n, gbaCore.armState ? 0x04 : 0x08, true);
 
     if (result != -2)
         remotePutPacket("OK");
@@ -3971,9 +3989,9 @@ void remoteWriteWatch(char* p, bool active)
 #ifdef VBAM_ENABLE_DEBUGGER
     for (int i = 0; i < count; i++) {
         if ((address >> 24) == 2)
-            freezeWorkRAM[address & 0x3ffff] = active;
+            gbaCore.freezeWorkRAM[address & 0x3ffff] = active;
         else
-            freezeInternalRAM[address & 0x7fff] = active;
+            gbaCore.freezeInternalRAM[address & 0x7fff] = active;
         address++;
     }
 #endif
@@ -3992,7 +4010,7 @@ void remoteReadRegister(char* p)
     }
     char buffer[1024];
     char* s = buffer;
-    uint32_t v = reg[r].I;
+    uint32_t v = gbaCore.reg[r].I;
     snprintf(s, sizeof(buffer), "%02x%02x%02x%02x", v & 255, (v >> 8) & 255,
         (v >> 16) & 255, (v >> 24) & 255);
     remotePutPacket(buffer);
@@ -4007,13 +4025,13 @@ void remoteReadRegisters(char* p)
     int i;
     // regular registers
     for (i = 0; i < 15; i++) {
-        uint32_t v = reg[i].I;
+        uint32_t v = gbaCore.reg[i].I;
         snprintf(s, sizeof(buffer), "%02x%02x%02x%02x", v & 255, (v >> 8) & 255,
             (v >> 16) & 255, (v >> 24) & 255);
         s += 8;
     }
     // PC
-    uint32_t pc = armNextPC;
+    uint32_t pc = gbaCore.armNextPC;
     snprintf(s, sizeof(buffer) - 8, "%02x%02x%02x%02x", pc & 255, (pc >> 8) & 255,
         (pc >> 16) & 255, (pc >> 24) & 255);
     s += 8;
@@ -4029,7 +4047,7 @@ void remoteReadRegisters(char* p)
     s += 8;
     // CPSR
     CPUUpdateCPSR();
-    uint32_t v = reg[16].I;
+    uint32_t v = gbaCore.reg[16].I;
     snprintf(s, sizeof(buffer) - 48, "%02x%02x%02x%02x", v & 255, (v >> 8) & 255,
         (v >> 16) & 255, (v >> 24) & 255);
     s += 8;
@@ -4078,20 +4096,20 @@ void remoteWriteRegister(char* p)
     v = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
 
     //  monprintf("Write register %d=%08x\n", r, v);
-    reg[r].I = v;
+    gbaCore.reg[r].I = v;
     if (r == 15) {
-        armNextPC = v;
-        if (armState)
-            reg[15].I = v + 4;
+        gbaCore.armNextPC = v;
+        if (gbaCore.armState)
+            gbaCore.reg[15].I = v + 4;
         else
-            reg[15].I = v + 2;
+            gbaCore.reg[15].I = v + 2;
     }
     remotePutPacket("OK");
 }
 
 void remoteStubMain()
 {
-    if (!debugger)
+    if (!gbaCore.debugger)
         return;
 
     if (remoteResumed) {
@@ -4107,7 +4125,7 @@ void remoteStubMain()
 
         if (res == -1) {
             fprintf(stderr, "GDB connection lost\n");
-            debugger = false;
+            gbaCore.debugger = false;
             break;
         } else if (res == -2)
             break;
@@ -4148,23 +4166,23 @@ void remoteStubMain()
                         case 'D':
                             remotePutPacket("OK");
                             remoteResumed = true;
-                            debugger = false;
+                            gbaCore.debugger = false;
                             return;
                         case 'e':
                             remoteStepOverRange(p);
                             break;
                         case 'k':
                             remotePutPacket("OK");
-                            debugger = false;
+                            gbaCore.debugger = false;
                             emulating = false;
                             return;
                         case 'C':
                             remoteResumed = true;
-                            debugger = false;
+                            gbaCore.debugger = false;
                             return;
                         case 'c':
                             remoteResumed = true;
-                            debugger = false;
+                            gbaCore.debugger = false;
                             return;
                         case 's':
                             remoteResumed = true;
@@ -4263,7 +4281,7 @@ void remoteStubSignal(int sig, int number)
     remoteSignal = sig;
     remoteResumed = false;
     remoteSendStatus();
-    debugger = true;
+    gbaCore.debugger = true;
 }
 
 void remoteCleanUp()
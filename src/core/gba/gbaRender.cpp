@@ -0,0 +1,264 @@
+#include "core/gba/gbaGfx.h"
+
+#include "core/base/line_writer.h"
+#include "core/base/system.h"
+#include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaCompositor.h"
+
+namespace {
+
+// Background layers composited by each display mode, BG0 in bit 0.
+constexpr uint8_t kModeLayers[6] = { 0x0F, 0x07, 0x0C, 0x04, 0x04, 0x04 };
+
+template <int mode>
+inline void gfxDrawBackgrounds()
+{
+    if (mode == 0) {
+        if (gbaCore.gfxLayerEnable & 0x0100) {
+            gfxDrawTextScreen(gbaCore.BG0CNT, gbaCore.BG0HOFS, gbaCore.BG0VOFS, gbaCore.g_line0);
+        }
+
+        if (gbaCore.gfxLayerEnable & 0x0200) {
+            gfxDrawTextScreen(gbaCore.BG1CNT, gbaCore.BG1HOFS, gbaCore.BG1VOFS, gbaCore.g_line1);
+        }
+
+        if (gbaCore.gfxLayerEnable & 0x0400) {
+            gfxDrawTextScreen(gbaCore.BG2CNT, gbaCore.BG2HOFS, gbaCore.BG2VOFS, gbaCore.g_line2);
+        }
+
+        if (gbaCore.gfxLayerEnable & 0x0800) {
+            gfxDrawTextScreen(gbaCore.BG3CNT, gbaCore.BG3HOFS, gbaCore.BG3VOFS, gbaCore.g_line3);
+        }
+        return;
+    }
+
+    if (mode == 1) {
+        if (gbaCore.gfxLayerEnable & 0x0100) {
+            gfxDrawTextScreen(gbaCore.BG0CNT, gbaCore.BG0HOFS, gbaCore.BG0VOFS, gbaCore.g_line0);
+        }
+
+        if (gbaCore.gfxLayerEnable & 0x0200) {
+            gfxDrawTextScreen(gbaCore.BG1CNT, gbaCore.BG1HOFS, gbaCore.BG1VOFS, gbaCore.g_line1);
+        }
+    }
+
+    if (gbaCore.gfxLayerEnable & 0x0400) {
+        switch (mode) {
+        case 1:
+        case 2:
+            gfxDrawRotScreen(gbaCore.BG2CNT, gbaCore.BG2PA, gbaCore.BG2PB, gbaCore.BG2PC, gbaCore.BG2PD,
+                gbaCore.gfxBG2X, gbaCore.gfxBG2Y, gbaCore.g_line2);
+            break;
+        case 3:
+            gfxDrawRotScreen16Bit(gbaCore.BG2CNT, gbaCore.BG2X_L, gbaCore.BG2X_H, gbaCore.BG2Y_L, gbaCore.BG2Y_H,
+                gbaCore.BG2PA, gbaCore.BG2PB, gbaCore.BG2PC, gbaCore.BG2PD,
+                gbaCore.gfxBG2X, gbaCore.gfxBG2Y, gbaCore.g_line2);
+            break;
+        case 4:
+            gfxDrawRotScreen256(gbaCore.BG2CNT, gbaCore.BG2X_L, gbaCore.BG2X_H, gbaCore.BG2Y_L, gbaCore.BG2Y_H,
+                gbaCore.BG2PA, gbaCore.BG2PB, gbaCore.BG2PC, gbaCore.BG2PD,
+                gbaCore.gfxBG2X, gbaCore.gfxBG2Y, gbaCore.g_line2);
+            break;
+        case 5:
+            gfxDrawRotScreen16Bit160(gbaCore.BG2CNT, gbaCore.BG2X_L, gbaCore.BG2X_H, gbaCore.BG2Y_L, gbaCore.BG2Y_H,
+                gbaCore.BG2PA, gbaCore.BG2PB, gbaCore.BG2PC, gbaCore.BG2PD,
+                gbaCore.gfxBG2X, gbaCore.gfxBG2Y, gbaCore.g_line2);
+            break;
+        }
+    }
+
+    if (mode == 2 && (gbaCore.gfxLayerEnable & 0x0800)) {
+        gfxDrawRotScreen(gbaCore.BG3CNT, gbaCore.BG3PA, gbaCore.BG3PB, gbaCore.BG3PC, gbaCore.BG3PD,
+            gbaCore.gfxBG3X, gbaCore.gfxBG3Y, gbaCore.g_line3);
+    }
+}
+
+// Moves the affine BG reference points to the current line and returns
+// false during forced blank. This is all the state a line carries over to
+// the next one.
+template <int mode>
+inline bool gfxAdvanceLine()
+{
+    if (gbaCore.DISPCNT & 0x80) {
+        if (mode != 0)
+            gbaCore.gfxLastVCOUNT = gbaCore.VCOUNT;
+        return false;
+    }
+
+    if (mode == 0)
+        return true;
+
+    if (gbaCore.gfxLayerEnable & 0x0400) {
+        int changed = gbaCore.gfxBG2Changed;
+        if (gbaCore.gfxLastVCOUNT > gbaCore.VCOUNT)
+            changed = 3;
+
+        gfxUpdateRotReference(gbaCore.BG2X_L, gbaCore.BG2X_H, gbaCore.BG2Y_L, gbaCore.BG2Y_H, gbaCore.BG2PB, gbaCore.BG2PD,
+            changed, gbaCore.gfxBG2X, gbaCore.gfxBG2Y);
+    }
+
+    if (mode == 2 && (gbaCore.gfxLayerEnable & 0x0800)) {
+        int changed = gbaCore.gfxBG3Changed;
+        if (gbaCore.gfxLastVCOUNT > gbaCore.VCOUNT)
+            changed = 3;
+
+        gfxUpdateRotReference(gbaCore.BG3X_L, gbaCore.BG3X_H, gbaCore.BG3Y_L, gbaCore.BG3Y_H, gbaCore.BG3PB, gbaCore.BG3PD,
+            changed, gbaCore.gfxBG3X, gbaCore.gfxBG3Y);
+    }
+
+    gbaCore.gfxBG2Changed = 0;
+    if (mode == 2)
+        gbaCore.gfxBG3Changed = 0;
+    gbaCore.gfxLastVCOUNT = gbaCore.VCOUNT;
+    return true;
+}
+
+inline bool gfxInWindowV(uint16_t winV)
+{
+    uint8_t v0 = winV >> 8;
+    uint8_t v1 = winV & 255;
+    bool inWindow = ((v0 == v1) && (v0 >= 0xe8));
+    if (v1 >= v0)
+        inWindow |= (gbaCore.VCOUNT >= v0 && gbaCore.VCOUNT < v1);
+    else
+        inWindow |= (gbaCore.VCOUNT >= v0 || gbaCore.VCOUNT < v1);
+    return inWindow;
+}
+
+// Vector compositor for this CPU, if any.
+const GfxCompositeLineFunc gfxCompositeLineVector = gfxCompositeLineKernel();
+
+}  // namespace
+
+// One scanline of the given display mode. |fx| enables the BLDMOD colour
+// special effects, |window| WIN0/WIN1 and |objWindow| the OBJ window. Mosaic
+// is resolved per layer in the gfxDraw* functions.
+template <int mode, bool fx, bool window, bool objWindow>
+void gfxRenderLine()
+{
+    uint16_t* palette = (uint16_t*)gbaCore.g_paletteRAM;
+
+    if (!gfxAdvanceLine<mode>()) {
+        for (int x = 0; x < 240; x++) {
+            gbaCore.g_lineMix[x] = 0x7fff;
+        }
+        return;
+    }
+
+    bool inWindow0 = false;
+    bool inWindow1 = false;
+
+    if (window) {
+        if (gbaCore.gfxLayerEnable & 0x2000)
+            inWindow0 = gfxInWindowV(gbaCore.WIN0V);
+        if (gbaCore.gfxLayerEnable & 0x4000)
+            inWindow1 = gfxInWindowV(gbaCore.WIN1V);
+    }
+
+    gfxDrawBackgrounds<mode>();
+
+    gfxDrawSprites(gbaCore.g_lineOBJ);
+    if (objWindow)
+        gfxDrawOBJWin(gbaCore.g_lineOBJWin);
+
+    uint32_t backdrop;
+    if (gbaCore.customBackdropColor == -1) {
+        backdrop = (READ16LE(&palette[0]) | 0x30000000);
+    } else {
+        backdrop = ((gbaCore.customBackdropColor & 0x7FFF) | 0x30000000);
+    }
+
+    GfxCompositeState state;
+    state.layers = kModeLayers[mode];
+    state.fx = fx;
+    state.window = window;
+    state.objWindow = objWindow;
+    state.inWindow0 = inWindow0;
+    state.inWindow1 = inWindow1;
+    state.inWin0Mask = gbaCore.WININ & 0xFF;
+    state.inWin1Mask = gbaCore.WININ >> 8;
+    state.outMask = (window || objWindow) ? (gbaCore.WINOUT & 0xFF) : (fx ? 0x3F : 0x1F);
+    state.objWinMask = gbaCore.WINOUT >> 8;
+    state.backdrop = backdrop;
+    state.bldmod = gbaCore.BLDMOD;
+    state.effect = (gbaCore.BLDMOD >> 6) & 3;
+    state.ca = g_coeff[gbaCore.COLEV & 0x1F];
+    state.cb = g_coeff[(gbaCore.COLEV >> 8) & 0x1F];
+    state.cy = g_coeff[gbaCore.COLY & 0x1F];
+
+    if (gfxCompositeLineVector)
+        gfxCompositeLineVector(state);
+    else
+        gfxCompositeLineScalar<kModeLayers[mode], fx, window, objWindow>(state);
+}
+
+#define GFX_RENDER_LINES(mode)                                                      \
+    {                                                                               \
+        { { gfxRenderLine<mode, false, false, false>, gfxRenderLine<mode, false, false, true> }, \
+          { gfxRenderLine<mode, false, true, false>, gfxRenderLine<mode, false, true, true> } }, \
+        { { gfxRenderLine<mode, true, false, false>, gfxRenderLine<mode, true, false, true> },   \
+          { gfxRenderLine<mode, true, true, false>, gfxRenderLine<mode, true, true, true> } }    \
+    }
+
+static void (*const gfxRenderLines[6][2][2][2])() = {
+    GFX_RENDER_LINES(0),
+    GFX_RENDER_LINES(1),
+    GFX_RENDER_LINES(2),
+    GFX_RENDER_LINES(3),
+    GFX_RENDER_LINES(4),
+    GFX_RENDER_LINES(5),
+};
+
+#undef GFX_RENDER_LINES
+
+void (*gfxGetRenderLine(int mode, bool fx, bool window, bool objWindow))()
+{
+    return gfxRenderLines[mode][fx][window][objWindow];
+}
+
+template void gfxRenderLine<0, false, false, false>();
+
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+template <int mode>
+static void gfxSkipLine()
+{
+    gfxAdvanceLine<mode>();
+}
+
+static void (*const gfxSkipLines[6])() = {
+    gfxSkipLine<0>,
+    gfxSkipLine<1>,
+    gfxSkipLine<2>,
+    gfxSkipLine<3>,
+    gfxSkipLine<4>,
+    gfxSkipLine<5>,
+};
+
+void (*gfxGetSkipLine(int mode))()
+{
+    return gfxSkipLines[mode];
+}
+#endif
+
+void gfxWriteLine(uint8_t* pix, LineWriterHashes& hashes, int line)
+{
+    // Outside libretro the frame buffer starts with a blank line, and the
+    // lines have extra pixels for the filters that read past the screen.
+#ifdef __LIBRETRO__
+    const int pitch = 240;
+    const int top = line;
+#else
+    const int pitch = systemColorDepth == 24 ? 240 : systemColorDepth == 32 ? 241 : 242;
+    const int top = systemColorDepth == 24 ? line : line + 1;
+#endif
+    uint8_t* dest = pix + pitch * top * (systemColorDepth >> 3);
+    lineWriterConvert(gbaCore.g_lineMix, 240, dest);
+    lineWriterHash(hashes, top, dest, 240 * (systemColorDepth >> 3));
+
+#ifndef __LIBRETRO__
+    if (systemColorDepth == 8)
+        dest[240] = 0;
+    else if (systemColorDepth == 16)
+        ((uint16_t*)dest)[240] = 0;
+#endif
+}
@@ -9,50 +9,19 @@
 #include "core/gba/gba.h"
 #include "core/gba/gbaInline.h"
 
-
-enum RTCSTATE {
-    IDLE = 0,
-    COMMAND,
-    DATA,
-    READDATA
-};
-
-typedef struct
-{
-    uint8_t byte0;
-    uint8_t select;
-    uint8_t enable;
-    uint8_t command;
-    int dataLen;
-    int bits;
-    RTCSTATE state;
-    uint8_t data[12];
-    // reserved variables for future
-    uint8_t reserved[12];
-    bool reserved2;
-    uint32_t reserved3;
-} RTCCLOCKDATA;
-
-struct tm gba_time;
-static RTCCLOCKDATA rtcClockData;
-static bool rtcClockEnabled = true;
-static bool rtcRumbleEnabled = false;
-
-uint32_t countTicks = 0;
-
 void rtcEnable(bool e)
 {
-    rtcClockEnabled = e;
+    gbaCore.rtcClockEnabled = e;
 }
 
 bool rtcIsEnabled()
 {
-    return rtcClockEnabled;
+    return gbaCore.rtcClockEnabled;
 }
 
 void rtcEnableRumble(bool e)
 {
-    rtcRumbleEnabled = e;
+    gbaCore.rtcRumbleEnabled = e;
 }
 
 uint16_t rtcRead(uint32_t address)
@@ -61,42 +30,42 @@ uint16_t rtcRead(uint32_t address)
 
     switch (address) {
     case 0x80000c8:
-        return rtcClockData.enable;
+        return gbaCore.rtcClockData.enable;
         break;
 
     case 0x80000c6:
-        return rtcClockData.select;
+        return gbaCore.rtcClockData.select;
         break;
 
     case 0x80000c4:
-        if (!(rtcClockData.enable & 1)) {
+        if (!(gbaCore.rtcClockData.enable & 1)) {
             return 0;
         }
 
         // Boktai Solar Sensor
-        if (rtcClockData.select == 0x07) {
-            if (rtcClockData.reserved[11] >= systemGetSensorDarkness()) {
+        if (gbaCore.rtcClockData.select == 0x07) {
+            if (gbaCore.rtcClockData.reserved[11] >= systemGetSensorDarkness()) {
                 res |= 8;
             }
         }
 
         // WarioWare Twisted Tilt Sensor
-        if (rtcClockData.select == 0x0b) {
+        if (gbaCore.rtcClockData.select == 0x0b) {
             uint16_t v = DowncastU16(systemGetSensorZ());
             v = 0x6C0 + v;
-            res |= ((v >> rtcClockData.reserved[11]) & 1) << 2;
+            res |= ((v >> gbaCore.rtcClockData.reserved[11]) & 1) << 2;
         }
 
         // Real Time Clock
-        if (rtcClockEnabled && (rtcClockData.select & 0x04)) {
-            res |= rtcClockData.byte0;
+        if (gbaCore.rtcClockEnabled && (gbaCore.rtcClockData.select & 0x04)) {
+            res |= gbaCore.rtcClockData.byte0;
         }
 
         return res;
         break;
     }
 
-    return READ16LE((&g_rom[address & 0x1FFFFFE]));
+    return READ16LE((&gbaCore.g_rom[address & 0x1FFFFFE]));
 }
 
 static uint8_t toBCD(uint8_t value)
@@ -111,107 +80,112 @@ void SetGBATime()
 {
     time_t long_time;
     time(&long_time); /* Get time as long integer. */
-    gba_time = *localtime(&long_time); /* Convert to local time. */
+    gbaCore.gba_time = *localtime(&long_time); /* Convert to local time. */
 }
 
 void rtcUpdateTime(int ticks)
 {
-    countTicks += ticks;
+    gbaCore.countTicks += ticks;
 
-    if (countTicks > TICKS_PER_SECOND) {
-        countTicks -= TICKS_PER_SECOND;
-        gba_time.tm_sec++;
-        mktime(&gba_time);
+    if (gbaCore.countTicks > TICKS_PER_SECOND) {
+        gbaCore.countTicks -= TICKS_PER_SECOND;
+        gbaCore.gba_time.tm_sec++;
+        mktime(&gbaCore.gba_time);
     }
 }
 
+int rtcTicksToNextSecond()
+{
+    return TICKS_PER_SECOND + 1 - (int)gbaCore.countTicks;
+}
+
 bool rtcWrite(uint32_t address, uint16_t value)
 {
     if (address == 0x80000c8) {
-        rtcClockData.enable = (uint8_t)value; // bit 0 = enable reading from 0x80000c4 c6 and c8
+        gbaCore.rtcClockData.enable = (uint8_t)value; // bit 0 = enable reading from 0x80000c4 c6 and c8
     } else if (address == 0x80000c6) {
-        rtcClockData.select = (uint8_t)value; // 0=read/1=write (for each of 4 low bits)
+        gbaCore.rtcClockData.select = (uint8_t)value; // 0=read/1=write (for each of 4 low bits)
 
         // rumble is off when not writing to that pin
-        if (rtcRumbleEnabled && !(value & 8))
+        if (gbaCore.rtcRumbleEnabled && !(value & 8))
             systemCartridgeRumble(false);
     } else if (address == 0x80000c4) // 4 bits of I/O Port Data (upper bits not used)
     {
         // WarioWare Twisted rumble
-        if (rtcRumbleEnabled && (rtcClockData.select & 0x08)) {
+        if (gbaCore.rtcRumbleEnabled && (gbaCore.rtcClockData.select & 0x08)) {
             systemCartridgeRumble(value & 8);
         }
 
         // Boktai solar sensor
-        if (rtcClockData.select == 0x07) {
+        if (gbaCore.rtcClockData.select == 0x07) {
             if (value & 2) {
                 // reset counter to 0
-                rtcClockData.reserved[11] = 0;
+                gbaCore.rtcClockData.reserved[11] = 0;
             }
 
-            if ((value & 1) && !(rtcClockData.reserved[10] & 1)) {
+            if ((value & 1) && !(gbaCore.rtcClockData.reserved[10] & 1)) {
                 // increase counter, ready to do another read
-                if (rtcClockData.reserved[11] < 255) {
-                    rtcClockData.reserved[11]++;
+                if (gbaCore.rtcClockData.reserved[11] < 255) {
+                    gbaCore.rtcClockData.reserved[11]++;
                 } else {
-                    rtcClockData.reserved[11] = 0;
+                    gbaCore.rtcClockData.reserved[11] = 0;
                 }
             }
 
-            rtcClockData.reserved[10] = value & rtcClockData.select;
+            gbaCore.rtcClockData.reserved[10] = value & gbaCore.rtcClockData.select;
         }
 
         // WarioWare Twisted rotation sensor
-        if (rtcClockData.select == 0x0b) {
+        if (gbaCore.rtcClockData.select == 0x0b) {
             if (value & 2) {
                 // clock goes high in preperation for reading a bit
-                rtcClockData.reserved[11]--;
+                gbaCore.rtcClockData.reserved[11]--;
             }
 
             if (value & 1) {
                 // start ADC conversion
-                rtcClockData.reserved[11] = 15;
+                gbaCore.rtcClockData.reserved[11] = 15;
             }
 
-            rtcClockData.byte0 = value & rtcClockData.select;
+            gbaCore.rtcClockData.byte0 = value & gbaCore.rtcClockData.select;
         }
 
         // Real Time Clock
-        if (rtcClockData.select & 4) {
-            if (rtcClockData.state == IDLE && rtcClockData.byte0 == 1 && value == 5) {
-                rtcClockData.state = COMMAND;
-                rtcClockData.bits = 0;
-                rtcClockData.command = 0;
-            } else if (!(rtcClockData.byte0 & 1) && (value & 1)) // bit transfer
+        if (gbaCore.rtcClockData.select & 4) {
+            if (gbaCore.rtcClockData.state == RTC_IDLE && gbaCore.rtcClockData.byte0 == 1 && value == 5) {
+                gbaCore.rtcClockData.state = RTC_COMMAND;
+                gbaCore.rtcClockData.bits = 0;
+                gbaCore.rtcClockData.command = 0;
+            } else if (!(gbaCore.rtcClockData.byte0 & 1) && (value & 1)) // bit transfer
             {
-                rtcClockData.byte0 = (uint8_t)value;
+                gbaCore.rtcClockData.byte0 = (uint8_t)value;
 
-                switch (rtcClockData.state) {
-                case COMMAND:
-                    rtcClockData.command |= ((value & 2) >> 1) << (7 - rtcClockData.bits);
-                    rtcClockData.bits++;
+                switch (gbaCore.rtcClockData.state) {
+                case RTC_COMMAND:
+                    gbaCore.rtcClockData.command |= ((value & 2) >> 1) << (7 - gbaCore.rtcClockData.bits);
+                    gbaCore.rtcClockData.bits++;
 
-                    if (rtcClockData.bits == 8) {
-                        rtcClockData.bits = 0;
+                    if (gbaCore.rtcClockData.bits == 8) {
+                        gbaCore.rtcClockData.bits = 0;
 
-                        switch (rtcClockData.command) {
+                        switch (gbaCore.rtcClockData.command) {
                         case 0x60:
                             // not sure what this command does but it doesn't take parameters
                             // maybe it is a reset or stop
-                            rtcClockData.state = IDLE;
-                            rtcClockData.bits = 0;
+                            gbaCore.rtcClockData.state = RTC_IDLE;
+                            gbaCore.rtcClockData.bits = 0;
                             break;
 
                         case 0x62:
                             // this sets the control state but not sure what those values are
-                            rtcClockData.state = READDATA;
-                            rtcClockData.dataLen = 1;
+                            gbaCore.rtcClockData.state = RTC_READDATA;
+                            gbaCore.rtcClockData.dataLen = 1;
                             break;
 
                         case 0x63:
-                            rtcClockData.dataLen = 1;
-                            rtcClockData.data[0] = 0x40;
-                            rtcClockData.state = DATA;
+                            gbaCore.rtcClockData.dataLen = 1;
+                            gbaCore.rtcClockData.data[0] = 0x40;
+                            gbaCore.rtcClockData.state = RTC_DATA;
                             break;
 
                         case 0x64:
@@ -221,62 +195,62 @@ bool rtcWrite(uint32_t address, uint16_t value)
                             if (coreOptions.rtcEnabled)
                                 SetGBATime();
 
-                            rtcClockData.dataLen = 7;
-                            rtcClockData.data[0] = toBCD(DowncastU8(gba_time.tm_year));
-                            rtcClockData.data[1] = toBCD(DowncastU8(gba_time.tm_mon + 1));
-                            rtcClockData.data[2] = toBCD(DowncastU8(gba_time.tm_mday));
-                            rtcClockData.data[3] = toBCD(DowncastU8(gba_time.tm_wday));
-                            rtcClockData.data[4] = toBCD(DowncastU8(gba_time.tm_hour));
-                            rtcClockData.data[5] = toBCD(DowncastU8(gba_time.tm_min));
-                            rtcClockData.data[6] = toBCD(DowncastU8(gba_time.tm_sec));
-                            rtcClockData.state = DATA;
+                            gbaCore.rtcClockData.dataLen = 7;
+                            gbaCore.rtcClockData.data[0] = toBCD(DowncastU8(gbaCore.gba_time.tm_year));
+                            gbaCore.rtcClockData.data[1] = toBCD(DowncastU8(gbaCore.gba_time.tm_mon + 1));
+                            gbaCore.rtcClockData.data[2] = toBCD(DowncastU8(gbaCore.gba_time.tm_mday));
+                            gbaCore.rtcClockData.data[3] = toBCD(DowncastU8(gbaCore.gba_time.tm_wday));
+                            gbaCore.rtcClockData.data[4] = toBCD(DowncastU8(gbaCore.gba_time.tm_hour));
+                            gbaCore.rtcClockData.data[5] = toBCD(DowncastU8(gbaCore.gba_time.tm_min));
+                            gbaCore.rtcClockData.data[6] = toBCD(DowncastU8(gbaCore.gba_time.tm_sec));
+                            gbaCore.rtcClockData.state = RTC_DATA;
                         } break;
 
                         case 0x67: {
                             if (coreOptions.rtcEnabled)
                                 SetGBATime();
 
-                            rtcClockData.dataLen = 3;
-                            rtcClockData.data[0] = toBCD(DowncastU8(gba_time.tm_hour));
-                            rtcClockData.data[1] = toBCD(DowncastU8(gba_time.tm_min));
-                            rtcClockData.data[2] = toBCD(DowncastU8(gba_time.tm_sec));
-                            rtcClockData.state = DATA;
+                            gbaCore.rtcClockData.dataLen = 3;
+                            gbaCore.rtcClockData.data[0] = toBCD(DowncastU8(gbaCore.gba_time.tm_hour));
+                            gbaCore.rtcClockData.data[1] = toBCD(DowncastU8(gbaCore.gba_time.tm_min));
+                            gbaCore.rtcClockData.data[2] = toBCD(DowncastU8(gbaCore.gba_time.tm_sec));
+                            gbaCore.rtcClockData.state = RTC_DATA;
                         } break;
 
                         default:
 #ifdef GBA_LOGGING
-                            log(N_("Unknown RTC command %02x"), rtcClockData.command);
+                            log(N_("Unknown RTC command %02x"), gbaCore.rtcClockData.command);
 #endif
-                            rtcClockData.state = IDLE;
+                            gbaCore.rtcClockData.state = RTC_IDLE;
                             break;
                         }
                     }
 
                     break;
 
-                case DATA:
-                    if (rtcClockData.select & 2) {
-                    } else if (rtcClockData.select & 4) {
-                        rtcClockData.byte0 = (rtcClockData.byte0 & ~2) | ((rtcClockData.data[rtcClockData.bits >> 3] >> (rtcClockData.bits & 7)) & 1) * 2;
-                        rtcClockData.bits++;
+                case RTC_DATA:
+                    if (gbaCore.rtcClockData.select & 2) {
+                    } else if (gbaCore.rtcClockData.select & 4) {
+                        gbaCore.rtcClockData.byte0 = (gbaCore.rtcClockData.byte0 & ~2) | ((gbaCore.rtcClockData.data[gbaCore.rtcClockData.bits >> 3] >> (gbaCore.rtcClockData.bits & 7)) & 1) * 2;
+                        gbaCore.rtcClockData.bits++;
 
-                        if (rtcClockData.bits == 8 * rtcClockData.dataLen) {
-                            rtcClockData.bits = 0;
-                            rtcClockData.state = IDLE;
+                        if (gbaCore.rtcClockData.bits == 8 * gbaCore.rtcClockData.dataLen) {
+                            gbaCore.rtcClockData.bits = 0;
+                            gbaCore.rtcClockData.state = RTC_IDLE;
                         }
                     }
 
                     break;
 
-                case READDATA:
-                    if (!(rtcClockData.select & 2)) {
+                case RTC_READDATA:
+                    if (!(gbaCore.rtcClockData.select & 2)) {
                     } else {
-                        rtcClockData.data[rtcClockData.bits >> 3] = (rtcClockData.data[rtcClockData.bits >> 3] >> 1) | ((value << 6) & 128);
-                        rtcClockData.bits++;
+                        gbaCore.rtcClockData.data[gbaCore.rtcClockData.bits >> 3] = (gbaCore.rtcClockData.data[gbaCore.rtcClockData.bits >> 3] >> 1) | ((value << 6) & 128);
+                        gbaCore.rtcClockData.bits++;
 
-                        if (rtcClockData.bits == 8 * rtcClockData.dataLen) {
-                            rtcClockData.bits = 0;
-                            rtcClockData.state = IDLE;
+                        if (gbaCore.rtcClockData.bits == 8 * gbaCore.rtcClockData.dataLen) {
+                            gbaCore.rtcClockData.bits = 0;
+                            gbaCore.rtcClockData.state = RTC_IDLE;
                         }
                     }
 
@@ -286,7 +260,7 @@ bool rtcWrite(uint32_t address, uint16_t value)
                     break;
                 }
             } else
-                rtcClockData.byte0 = (uint8_t)value;
+                gbaCore.rtcClockData.byte0 = (uint8_t)value;
         }
     }
 
@@ -295,36 +269,36 @@ bool rtcWrite(uint32_t address, uint16_t value)
 
 void rtcReset()
 {
-    memset(&rtcClockData, 0, sizeof(rtcClockData));
-    rtcClockData.byte0 = 0;
-    rtcClockData.select = 0;
-    rtcClockData.enable = 0;
-    rtcClockData.command = 0;
-    rtcClockData.dataLen = 0;
-    rtcClockData.bits = 0;
-    rtcClockData.state = IDLE;
-    rtcClockData.reserved[11] = 0;
+    memset(&gbaCore.rtcClockData, 0, sizeof(gbaCore.rtcClockData));
+    gbaCore.rtcClockData.byte0 = 0;
+    gbaCore.rtcClockData.select = 0;
+    gbaCore.rtcClockData.enable = 0;
+    gbaCore.rtcClockData.command = 0;
+    gbaCore.rtcClockData.dataLen = 0;
+    gbaCore.rtcClockData.bits = 0;
+    gbaCore.rtcClockData.state = RTC_IDLE;
+    gbaCore.rtcClockData.reserved[11] = 0;
     SetGBATime();
 }
 
 #ifdef __LIBRETRO__
 void rtcSaveGame(uint8_t*& data)
 {
-    utilWriteMem(data, &rtcClockData, sizeof(rtcClockData));
+    utilWriteMem(data, &gbaCore.rtcClockData, sizeof(gbaCore.rtcClockData));
 }
 
 void rtcReadGame(const uint8_t*& data)
 {
-    utilReadMem(&rtcClockData, data, sizeof(rtcClockData));
+    utilReadMem(&gbaCore.rtcClockData, data, sizeof(gbaCore.rtcClockData));
 }
 #else
 void rtcSaveGame(gzFile gzFile)
 {
-    utilGzWrite(gzFile, &rtcClockData, sizeof(rtcClockData));
+    utilGzWrite(gzFile, &gbaCore.rtcClockData, sizeof(gbaCore.rtcClockData));
 }
 
 void rtcReadGame(gzFile gzFile)
 {
-    utilGzRead(gzFile, &rtcClockData, sizeof(rtcClockData));
+    utilGzRead(gzFile, &gbaCore.rtcClockData, sizeof(gbaCore.rtcClockData));
 }
 #endif
@@ -7,8 +7,33 @@
 #include <zlib.h>
 #endif  // defined(__LIBRETRO__)
 
+enum RTCSTATE {
+    RTC_IDLE = 0,
+    RTC_COMMAND,
+    RTC_DATA,
+    RTC_READDATA
+};
+
+typedef struct
+{
+    uint8_t byte0;
+    uint8_t select;
+    uint8_t enable;
+    uint8_t command;
+    int dataLen;
+    int bits;
+    RTCSTATE state;
+    uint8_t data[12];
+    // reserved variables for future
+    uint8_t reserved[12];
+    bool reserved2;
+    uint32_t reserved3;
+} RTCCLOCKDATA;
+
 uint16_t rtcRead(uint32_t address);
 void rtcUpdateTime(int ticks);
+// Cycles until the next rtcUpdateTime() call would move the clock.
+int rtcTicksToNextSecond();
 bool rtcWrite(uint32_t address, uint16_t value);
 void rtcEnable(bool);
 void rtcEnableRumble(bool e);
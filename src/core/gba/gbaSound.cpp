@@ -1,15 +1,19 @@
 #include "core/gba/gbaSound.h"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <vector>
 
 #include "core/apu/Gb_Apu.h"
 #include "core/apu/Multi_Buffer.h"
 #include "core/base/file_util.h"
 #include "core/base/port.h"
+#include "core/base/resampler.h"
 #include "core/base/sound_driver.h"
 #include "core/gba/gba.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaSoundPcm.h"
 
 
 #define NR10 0x60
@@ -34,101 +38,46 @@
 #define NR51 0x81
 #define NR52 0x84
 
-std::unique_ptr<SoundDriver> soundDriver;
-
-extern bool stopState; // TODO: silence sound when true
-
-int const SOUND_CLOCK_TICKS_ = 280896; // ~1074 samples per frame
-
-static uint16_t soundFinalWave[1600];
-long soundSampleRate = 44100;
-bool g_gbaSoundInterpolation = true;
-bool soundPaused = true;
-float soundFiltering = 0.5f;
 int SOUND_CLOCK_TICKS = SOUND_CLOCK_TICKS_;
-int soundTicks = SOUND_CLOCK_TICKS_;
-
-static float soundVolume = 1.0f;
-static int soundEnableFlag = 0x3ff; // emulator channels enabled
-static float soundFiltering_ = -1.0f;
-static float soundVolume_ = -1.0f;
 
 void interp_rate() { /* empty for now */}
 
-class Gba_Pcm {
-public:
-    void init();
-    void apply_control(int idx);
-    void update(int dac);
-    void end_frame(blip_time_t);
-
-private:
-    Blip_Buffer* output;
-    blip_time_t last_time;
-    int last_amp;
-    int shift;
-};
-
-class Gba_Pcm_Fifo {
-public:
-    int which;
-    Gba_Pcm pcm;
-
-    void write_control(int data);
-    void write_fifo(int data);
-    void timer_overflowed(int which_timer);
-
-    // public only so save state routines can access it
-    int readIndex;
-    int count;
-    int writeIndex;
-    uint8_t fifo[32];
-    int dac;
-
-private:
-    int timer;
-    bool enabled;
-};
-
-static Gba_Pcm_Fifo pcm[2];
-static Gb_Apu* gb_apu;
-static Stereo_Buffer* stereo_buffer;
-
-static Blip_Synth<blip_best_quality, 1> pcm_synth[3]; // 32 kHz, 16 kHz, 8 kHz
-
 void Gba_Pcm::init()
 {
     output = 0;
     last_time = 0;
     last_amp = 0;
     shift = 0;
+    pending_count = 0;
 }
 
 void Gba_Pcm::apply_control(int idx)
 {
-    shift = ~g_ioMem[SGCNT0_H] >> (2 + idx) & 1;
+    flush();
+
+    shift = ~gbaCore.g_ioMem[SGCNT0_H] >> (2 + idx) & 1;
 
     int ch = 0;
-    if ((soundEnableFlag >> idx & 0x100) && (g_ioMem[NR52] & 0x80))
-        ch = g_ioMem[SGCNT0_H + 1] >> (idx * 4) & 3;
+    if (!gbaCore.soundSilent_ && (gbaCore.soundEnableFlag >> idx & 0x100) && (gbaCore.g_ioMem[NR52] & 0x80))
+        ch = gbaCore.g_ioMem[SGCNT0_H + 1] >> (idx * 4) & 3;
 
     Blip_Buffer* out = 0;
     switch (ch) {
     case 1:
-        out = stereo_buffer->right();
+        out = gbaCore.stereo_buffer->right();
         break;
     case 2:
-        out = stereo_buffer->left();
+        out = gbaCore.stereo_buffer->left();
         break;
     case 3:
-        out = stereo_buffer->center();
+        out = gbaCore.stereo_buffer->center();
         break;
     }
 
     if (output != out) {
         if (output) {
             output->set_modified();
-            pcm_synth[0].offset(soundTicks, -last_amp, output);
+            gbaCore.pcm_synth[0].offset(gbaCore.soundTicks, -last_amp, output);
         }
         last_amp = 0;
         output = out;
@@ -137,6 +86,8 @@ void Gba_Pcm::apply_control(int idx)
 
 void Gba_Pcm::end_frame(blip_time_t time)
 {
+    flush();
+
     last_time -= time;
     if (last_time < -2048)
         last_time = -2048;
@@ -148,15 +99,29 @@ void Gba_Pcm::end_frame(blip_time_t time)
 void Gba_Pcm::update(int dac)
 {
     if (output) {
-        blip_time_t time = soundTicks;
+        if (pending_count == pending_max)
+            flush();
+
+        pending[pending_count].time = gbaCore.soundTicks;
+        pending[pending_count].dac = dac;
+        pending_count++;
+    }
+}
 
-        dac = (int8_t)dac >> shift;
+void Gba_Pcm::flush()
+{
+    bool const interpolation = gbaCore.g_gbaSoundInterpolation;
+
+    for (int i = 0; i < pending_count; i++) {
+        blip_time_t time = pending[i].time;
+
+        int dac = (int8_t)pending[i].dac >> shift;
         int delta = dac - last_amp;
         if (delta) {
             last_amp = dac;
 
             int filter = 0;
-            if (g_gbaSoundInterpolation) {
+            if (interpolation) {
                 // base filtering on how long since last sample was output
                 int period = time - last_time;
 
@@ -168,10 +133,11 @@ void Gba_Pcm::update(int dac)
                 filter = filters[idx];
             }
 
-            pcm_synth[filter].offset(time, delta, output);
+            gbaCore.pcm_synth[filter].offset(time, delta, output);
         }
         last_time = time;
     }
+    pending_count = 0;
 }
 
 void Gba_Pcm_Fifo::timer_overflowed(int which_timer)
@@ -230,8 +196,8 @@ void Gba_Pcm_Fifo::write_fifo(int data)
 
 static void apply_control()
 {
-    pcm[0].pcm.apply_control(0);
-    pcm[1].pcm.apply_control(1);
+    gbaCore.pcm[0].pcm.apply_control(0);
+    gbaCore.pcm[1].pcm.apply_control(1);
 }
 
 static int gba_to_gb_sound(int addr)
@@ -255,8 +221,8 @@ void soundEvent8(uint32_t address, uint8_t data)
 {
     int gb_addr = gba_to_gb_sound(address);
     if (gb_addr) {
-        g_ioMem[address] = data;
-        gb_apu->write_register(soundTicks, gb_addr, data);
+        gbaCore.g_ioMem[address] = data;
+        gbaCore.gb_apu->write_register(gbaCore.soundTicks, gb_addr, data);
 
         if (address == NR52)
             apply_control();
@@ -268,26 +234,26 @@ void soundEvent8(uint32_t address, uint8_t data)
 static void apply_volume(bool apu_only = false)
 {
     if (!apu_only)
-        soundVolume_ = soundVolume;
+        gbaCore.soundVolume_ = gbaCore.soundVolume;
 
-    if (gb_apu) {
+    if (gbaCore.gb_apu) {
         static float const apu_vols[4] = { 0.25f, 0.5f, 1.0f, 0.25f };
-        gb_apu->volume(soundVolume_ * apu_vols[g_ioMem[SGCNT0_H] & 3]);
+        gbaCore.gb_apu->volume(gbaCore.soundVolume_ * apu_vols[gbaCore.g_ioMem[SGCNT0_H] & 3]);
     }
 
     if (!apu_only) {
-        double synth_vol = 0.66 / 256.0 * soundVolume_;
-        pcm_synth[0].volume(synth_vol);
-        pcm_synth[1].volume(synth_vol);
-        pcm_synth[2].volume(synth_vol);
+        double synth_vol = 0.66 / 256.0 * gbaCore.soundVolume_;
+        gbaCore.pcm_synth[0].volume(synth_vol);
+        gbaCore.pcm_synth[1].volume(synth_vol);
+        gbaCore.pcm_synth[2].volume(synth_vol);
     }
 }
 
 static void write_SGCNT0_H(int data)
 {
-    WRITE16LE(&g_ioMem[SGCNT0_H], data & 0x770F);
-    pcm[0].write_control(data);
-    pcm[1].write_control(data >> 4);
+    WRITE16LE(&gbaCore.g_ioMem[SGCNT0_H], data & 0x770F);
+    gbaCore.pcm[0].write_control(data);
+    gbaCore.pcm[1].write_control(data >> 4);
     apply_volume(true);
 }
 
@@ -300,19 +266,19 @@ void soundEvent16(uint32_t address, uint16_t data)
 
     case FIFOA_L:
     case FIFOA_H:
-        pcm[0].write_fifo(data);
-        WRITE16LE(&g_ioMem[address], data);
+        gbaCore.pcm[0].write_fifo(data);
+        WRITE16LE(&gbaCore.g_ioMem[address], data);
         break;
 
     case FIFOB_L:
     case FIFOB_H:
-        pcm[1].write_fifo(data);
-        WRITE16LE(&g_ioMem[address], data);
+        gbaCore.pcm[1].write_fifo(data);
+        WRITE16LE(&gbaCore.g_ioMem[address], data);
         break;
 
     case SOUNDBIAS:
         data &= 0xC3FF;
-        WRITE16LE(&g_ioMem[address], data);
+        WRITE16LE(&gbaCore.g_ioMem[address], data);
         break;
 
     default:
@@ -324,142 +290,262 @@ void soundEvent16(uint32_t address, uint16_t data)
 
 void soundTimerOverflow(int timer)
 {
-    pcm[0].timer_overflowed(timer);
-    pcm[1].timer_overflowed(timer);
+    gbaCore.pcm[0].timer_overflowed(timer);
+    gbaCore.pcm[1].timer_overflowed(timer);
+}
+
+void soundWriteFifo(uint32_t address, const uint32_t* data, int count)
+{
+    Gba_Pcm_Fifo& fifo = gbaCore.pcm[address == FIFOA_L ? 0 : 1];
+    for (int i = 0; i < count; i++) {
+        fifo.write_fifo((uint16_t)data[i]);
+        fifo.write_fifo((uint16_t)(data[i] >> 16));
+    }
+    if (count)
+        WRITE32LE(&gbaCore.g_ioMem[address], data[count - 1]);
 }
 
 static void end_frame(blip_time_t time)
 {
-    pcm[0].pcm.end_frame(time);
-    pcm[1].pcm.end_frame(time);
+    gbaCore.pcm[0].pcm.end_frame(time);
+    gbaCore.pcm[1].pcm.end_frame(time);
 
-    gb_apu->end_frame(time);
-    stereo_buffer->end_frame(time);
+    gbaCore.gb_apu->end_frame(time);
+    gbaCore.stereo_buffer->end_frame(time);
 }
 
 #ifdef __LIBRETRO__
 void flush_samples(Multi_Buffer* buffer)
 {
-    int numSamples = buffer->read_samples((blip_sample_t*)soundFinalWave, buffer->samples_avail());
-    soundDriver->write(soundFinalWave, numSamples);
-    systemOnWriteDataToSoundBuffer(soundFinalWave, numSamples);
+    int numSamples = buffer->read_samples((blip_sample_t*)gbaCore.soundFinalWave, buffer->samples_avail());
+    gbaCore.soundDriver->write(gbaCore.soundFinalWave, numSamples);
+    systemOnWriteDataToSoundBuffer(gbaCore.soundFinalWave, numSamples);
+}
+
+void flush_silence(Multi_Buffer* buffer)
+{
+    int numSamples = buffer->skip_samples(buffer->samples_avail());
+    memset(gbaCore.soundFinalWave, 0, numSamples * sizeof *gbaCore.soundFinalWave);
+    gbaCore.soundDriver->write(gbaCore.soundFinalWave, numSamples);
+    systemOnWriteDataToSoundBuffer(gbaCore.soundFinalWave, numSamples);
 }
 #else
+// Dynamic rate control: the most the output rate strays from the emulated one
+// in proportion to the buffer level, and through the slow correction that
+// takes up a steady difference between the emulation and the device, like the
+// one of an emulation that follows the vertical sync.
+static const double kDynamicRateMaxDelta = 0.005;
+static const double kDynamicRateMaxCorrection = 0.005;
+static const double kDynamicRateCorrectionGain = 0.0001;
+// The level jumps by a whole callback or write at a time, it is averaged over
+// about ten frames.
+static const double kDynamicRateSmoothing = 0.1;
+
+// Picks the rate of the next write so that the driver's buffer is half full on
+// average between the writes: a fuller buffer slows the output down, an
+// emptier one speeds it up.
+static void update_rate(double before, double after)
+{
+    gbaCore.soundRateLevel += ((before + after) / 2.0 - gbaCore.soundRateLevel) * kDynamicRateSmoothing;
+    const double error = 1.0 - 2.0 * gbaCore.soundRateLevel;
+    gbaCore.soundRateCorrection = std::clamp(gbaCore.soundRateCorrection + kDynamicRateCorrectionGain * error,
+                                     -kDynamicRateMaxCorrection, kDynamicRateMaxCorrection);
+    gbaCore.soundRate = 1.0 + kDynamicRateMaxDelta * error + gbaCore.soundRateCorrection;
+}
+
+// Writes everything available, resampled to the rate control's rate. The
+// recorders still get the samples as emulated.
+static void flush_resampled(Multi_Buffer* buffer, double level)
+{
+    gbaCore.soundResampler.setRatio(gbaCore.soundRate);
+
+    gbaCore.soundResampled.clear();
+    const long out_buf_size = sizeof gbaCore.soundFinalWave / sizeof *gbaCore.soundFinalWave;
+    while (long samples = buffer->read_samples((blip_sample_t*)gbaCore.soundFinalWave, out_buf_size)) {
+        gbaCore.soundResampler.process((const int16_t*)gbaCore.soundFinalWave, (int)samples, gbaCore.soundResampled);
+        systemOnWriteDataToSoundBuffer(gbaCore.soundFinalWave, (int)(samples * sizeof *gbaCore.soundFinalWave));
+    }
+
+    if (gbaCore.soundResampled.empty())
+        return;
+    if (gbaCore.soundPaused)
+        soundResume();
+    gbaCore.soundDriver->write((uint16_t*)gbaCore.soundResampled.data(), (int)(gbaCore.soundResampled.size() * sizeof *gbaCore.soundFinalWave));
+    update_rate(level, gbaCore.soundDriver->bufferLevel());
+}
+
 void flush_samples(Multi_Buffer* buffer)
 {
+    // The drivers that report their buffer level never wait for their
+    // device, rate control keeps them from running dry or overflowing. The
+    // others keep getting frame sized writes.
+    const double level = gbaCore.soundDriver->bufferLevel();
+    if (level >= 0) {
+        flush_resampled(buffer, level);
+        return;
+    }
+
     // We want to write the data frame by frame to support legacy audio drivers
     // that don't use the length parameter of the write method.
     // TODO: Update the Win32 audio drivers (DS, OAL, XA2), and flush all the
     // samples at once to help reducing the audio delay on all platforms.
-    int soundBufferLen = (soundSampleRate / 60) * 4;
+    int soundBufferLen = (gbaCore.soundSampleRate / 60) * 4;
 
     // soundBufferLen should have a whole number of sample pairs
-    assert(soundBufferLen % (2 * sizeof *soundFinalWave) == 0);
+    assert(soundBufferLen % (2 * sizeof *gbaCore.soundFinalWave) == 0);
 
     // number of samples in output buffer
-    int const out_buf_size = soundBufferLen / sizeof *soundFinalWave;
+    int const out_buf_size = soundBufferLen / sizeof *gbaCore.soundFinalWave;
 
     // Keep filling and writing soundFinalWave until it can't be fully filled
     while (buffer->samples_avail() >= out_buf_size) {
-        buffer->read_samples((blip_sample_t*)soundFinalWave, out_buf_size);
-        if (soundPaused)
+        buffer->read_samples((blip_sample_t*)gbaCore.soundFinalWave, out_buf_size);
+        if (gbaCore.soundPaused)
             soundResume();
 
-        soundDriver->write(soundFinalWave, soundBufferLen);
-        systemOnWriteDataToSoundBuffer(soundFinalWave, soundBufferLen);
+        gbaCore.soundDriver->write(gbaCore.soundFinalWave, soundBufferLen);
+        systemOnWriteDataToSoundBuffer(gbaCore.soundFinalWave, soundBufferLen);
+    }
+}
+
+void flush_silence(Multi_Buffer* buffer)
+{
+    // Same frame sized writes as flush_samples(), so that the drivers keep
+    // pacing the emulation.
+    int soundBufferLen = (gbaCore.soundSampleRate / 60) * 4;
+    int const out_buf_size = soundBufferLen / sizeof *gbaCore.soundFinalWave;
+
+    memset(gbaCore.soundFinalWave, 0, soundBufferLen);
+    while (buffer->samples_avail() >= out_buf_size) {
+        buffer->skip_samples(out_buf_size);
+        if (gbaCore.soundPaused)
+            soundResume();
+
+        gbaCore.soundDriver->write(gbaCore.soundFinalWave, soundBufferLen);
+        systemOnWriteDataToSoundBuffer(gbaCore.soundFinalWave, soundBufferLen);
     }
 }
 #endif // ! __LIBRETRO__
 
 static void apply_filtering()
 {
-    soundFiltering_ = soundFiltering;
+    gbaCore.soundFiltering_ = gbaCore.soundFiltering;
 
-    int const base_freq = (int)(32768 - soundFiltering_ * 16384);
-    int const nyquist = stereo_buffer->sample_rate() / 2;
+    int const base_freq = (int)(32768 - gbaCore.soundFiltering_ * 16384);
+    int const nyquist = gbaCore.stereo_buffer->sample_rate() / 2;
 
     for (int i = 0; i < 3; i++) {
         int cutoff = base_freq >> i;
         if (cutoff > nyquist)
             cutoff = nyquist;
-        pcm_synth[i].treble_eq(blip_eq_t(0, 0, stereo_buffer->sample_rate(), cutoff));
+        gbaCore.pcm_synth[i].treble_eq(blip_eq_t(0, 0, gbaCore.stereo_buffer->sample_rate(), cutoff));
     }
 }
 
+static void apply_muting();
+
+static void apply_silence()
+{
+    gbaCore.soundSilent_ = gbaCore.soundSilent;
+    apply_muting();
+
+    // Nothing gets into the buffers while silent, so that they can be skipped
+    // over cheaply, and the sound comes back from silence.
+    gbaCore.stereo_buffer->clear();
+    gbaCore.gb_apu->clear_amps();
+    gbaCore.soundResampler.reset();
+}
+
 void psoundTickfn()
 {
-    if (gb_apu && stereo_buffer) {
+    if (gbaCore.gb_apu && gbaCore.stereo_buffer) {
         // Run sound hardware to present
-        end_frame(soundTicks);
+        end_frame(gbaCore.soundTicks);
 
-        flush_samples(stereo_buffer);
+        if (gbaCore.soundSilent_)
+            flush_silence(gbaCore.stereo_buffer);
+        else
+            flush_samples(gbaCore.stereo_buffer);
 
-        if (soundFiltering_ != soundFiltering)
+        if (gbaCore.soundSilent_ != gbaCore.soundSilent)
+            apply_silence();
+
+        if (gbaCore.soundFiltering_ != gbaCore.soundFiltering)
             apply_filtering();
 
-        if (soundVolume_ != soundVolume)
+        if (gbaCore.soundVolume_ != gbaCore.soundVolume)
             apply_volume();
     }
 
-    soundTicks = 0;
+    gbaCore.soundTicks = 0;
 }
 
 static void apply_muting()
 {
-    if (!stereo_buffer || !g_ioMem)
+    if (!gbaCore.stereo_buffer || !gbaCore.g_ioMem)
         return;
 
     // PCM
     apply_control();
 
-    if (gb_apu) {
+    if (gbaCore.gb_apu) {
         // APU
         for (int i = 0; i < 4; i++) {
-            if (soundEnableFlag >> i & 1)
-                gb_apu->set_output(stereo_buffer->center(),
-                    stereo_buffer->left(), stereo_buffer->right(), i);
+            if (!gbaCore.soundSilent_ && (gbaCore.soundEnableFlag >> i & 1))
+                gbaCore.gb_apu->set_output(gbaCore.stereo_buffer->center(),
+                    gbaCore.stereo_buffer->left(), gbaCore.stereo_buffer->right(), i);
             else
-                gb_apu->set_output(0, 0, 0, i);
+                gbaCore.gb_apu->set_output(0, 0, 0, i);
         }
     }
 }
 
 static void reset_apu()
 {
-    gb_apu->reset(gb_apu->mode_agb, true);
+    gbaCore.pcm[0].pcm.flush();
+    gbaCore.pcm[1].pcm.flush();
+
+    gbaCore.gb_apu->reset(gbaCore.gb_apu->mode_agb, true);
 
-    if (stereo_buffer)
-        stereo_buffer->clear();
+    if (gbaCore.stereo_buffer)
+        gbaCore.stereo_buffer->clear();
 
-    soundTicks = 0;
+    gbaCore.soundTicks = 0;
 }
 
 static void remake_stereo_buffer()
 {
-    if (!g_ioMem)
+    if (!gbaCore.g_ioMem)
         return;
 
+    gbaCore.soundResampler.reset();
+#ifndef __LIBRETRO__
+    gbaCore.soundRateLevel = 0.5;
+    gbaCore.soundRateCorrection = 0.0;
+    gbaCore.soundRate = 1.0;
+#endif
+
     // Clears pointers kept to old stereo_buffer
-    pcm[0].pcm.init();
-    pcm[1].pcm.init();
+    gbaCore.pcm[0].pcm.init();
+    gbaCore.pcm[1].pcm.init();
 
     // APU
-    if (!gb_apu) {
-        gb_apu = new Gb_Apu; // TODO: handle out of memory
+    if (!gbaCore.gb_apu) {
+        gbaCore.gb_apu = new Gb_Apu; // TODO: handle out of memory
         reset_apu();
     }
 
     // Stereo_Buffer
-    delete stereo_buffer;
-    stereo_buffer = 0;
+    delete gbaCore.stereo_buffer;
+    gbaCore.stereo_buffer = 0;
 
-    stereo_buffer = new Stereo_Buffer; // TODO: handle out of memory
-    stereo_buffer->set_sample_rate(soundSampleRate); // TODO: handle out of memory
-    stereo_buffer->clock_rate(gb_apu->clock_rate);
+    gbaCore.stereo_buffer = new Stereo_Buffer; // TODO: handle out of memory
+    gbaCore.stereo_buffer->set_sample_rate(gbaCore.soundSampleRate); // TODO: handle out of memory
+    gbaCore.stereo_buffer->clock_rate(gbaCore.gb_apu->clock_rate);
 
     // PCM
-    pcm[0].which = 0;
-    pcm[1].which = 1;
+    gbaCore.pcm[0].which = 0;
+    gbaCore.pcm[1].which = 1;
     apply_filtering();
 
     // Volume Level
@@ -469,279 +555,296 @@ static void remake_stereo_buffer()
 
 void soundShutdown()
 {
-    soundDriver.reset();
+    gbaCore.soundDriver.reset();
 
     systemOnSoundShutdown();
 
-    delete stereo_buffer;
-    stereo_buffer = 0;
+    delete gbaCore.stereo_buffer;
+    gbaCore.stereo_buffer = 0;
 
-    delete gb_apu;
-    gb_apu = 0;
+    delete gbaCore.gb_apu;
+    gbaCore.gb_apu = 0;
 }
 
 void soundPause()
 {
-    soundPaused = true;
-    if (soundDriver)
-        soundDriver->pause();
+    gbaCore.soundPaused = true;
+    if (gbaCore.soundDriver)
+        gbaCore.soundDriver->pause();
 }
 
 void soundResume()
 {
-    soundPaused = false;
-    if (soundDriver)
-        soundDriver->resume();
+    gbaCore.soundPaused = false;
+    if (gbaCore.soundDriver)
+        gbaCore.soundDriver->resume();
 }
 
 void soundSetVolume(float volume)
 {
-    soundVolume = volume;
+    gbaCore.soundVolume = volume;
 }
 
 float soundGetVolume()
 {
-    return soundVolume;
+    return gbaCore.soundVolume;
 }
 
 void soundSetEnable(int channels)
 {
-    soundEnableFlag = channels;
+    gbaCore.soundEnableFlag = channels;
     apply_muting();
 }
 
 int soundGetEnable()
 {
-    return (soundEnableFlag & 0x30f);
+    return (gbaCore.soundEnableFlag & 0x30f);
+}
+
+void soundSetSilent(bool silent)
+{
+    gbaCore.soundSilent = silent;
+}
+
+bool soundGetSilent()
+{
+    return gbaCore.soundSilent;
 }
 
 void soundReset()
 {
-    if (!soundDriver)
+    if (!gbaCore.soundDriver)
         return;
 
-    soundDriver->reset();
+    gbaCore.soundDriver->reset();
 
     remake_stereo_buffer();
     reset_apu();
 
-    soundPaused = true;
-    soundTicks = 0;
+    gbaCore.soundPaused = true;
+    gbaCore.soundTicks = 0;
 
     soundEvent8(NR52, (uint8_t)0x80);
 }
 
 bool soundInit()
 {
-    soundDriver = systemSoundInit();
-    if (!soundDriver)
+    gbaCore.soundThrottle = static_cast<unsigned short>(coreOptions.throttle);
+
+    gbaCore.soundDriver = systemSoundInit();
+    if (!gbaCore.soundDriver)
         return false;
 
-    if (!soundDriver->init(soundSampleRate))
+    if (!gbaCore.soundDriver->init(gbaCore.soundSampleRate))
         return false;
 
-    if (!stereo_buffer) {
+    if (!gbaCore.stereo_buffer) {
         remake_stereo_buffer();
     }
 
-    soundPaused = true;
+    gbaCore.soundPaused = true;
     return true;
 }
 
 void soundSetThrottle(unsigned short _throttle)
 {
-    if (!soundDriver)
+    gbaCore.soundThrottle = _throttle;
+    if (!gbaCore.soundDriver)
         return;
-    soundDriver->setThrottle(_throttle);
+    gbaCore.soundDriver->setThrottle(_throttle);
+}
+
+unsigned short soundGetThrottle()
+{
+    return gbaCore.soundThrottle;
 }
 
 long soundGetSampleRate()
 {
-    return soundSampleRate;
+    return gbaCore.soundSampleRate;
 }
 
 void soundSetSampleRate(long sampleRate)
 {
-    if (soundSampleRate != sampleRate) {
+    if (gbaCore.soundSampleRate != sampleRate) {
         if (systemCanChangeSoundQuality()) {
             soundShutdown();
-            soundSampleRate = sampleRate;
+            gbaCore.soundSampleRate = sampleRate;
             soundInit();
         } else {
-            soundSampleRate = sampleRate;
+            gbaCore.soundSampleRate = sampleRate;
         }
 
         remake_stereo_buffer();
     }
 }
 
-static int dummy_state[16];
-
-#define SKIP(type, name)          \
-    {                             \
-        dummy_state, sizeof(type) \
+#define SKIP(type, name)                      \
+    {                                         \
+        gbaCore.soundDummyState, sizeof(type) \
     }
 
-#define LOAD(type, name)    \
-    {                       \
-        &name, sizeof(type) \
+#define LOAD(type, name)            \
+    {                               \
+        &gbaCore.name, sizeof(type) \
     }
 
-static struct {
-    gb_apu_state_t apu;
-
-    // old state
-    uint8_t soundDSAValue;
-    int soundDSBValue;
-} state;
-
 #ifndef __LIBRETRO__
 // Old GBA sound state format
-static variable_desc old_gba_state[] = {
-    SKIP(int, soundPaused),
-    SKIP(int, soundPlay),
-    SKIP(int, soundTicks),
-    SKIP(int, SOUND_CLOCK_TICKS),
-    SKIP(int, soundLevel1),
-    SKIP(int, soundLevel2),
-    SKIP(int, soundBalance),
-    SKIP(int, soundMasterOn),
-    SKIP(int, soundIndex),
-    SKIP(int, sound1On),
-    SKIP(int, sound1ATL),
-    SKIP(int, sound1Skip),
-    SKIP(int, sound1Index),
-    SKIP(int, sound1Continue),
-    SKIP(int, sound1EnvelopeVolume),
-    SKIP(int, sound1EnvelopeATL),
-    SKIP(int, sound1EnvelopeATLReload),
-    SKIP(int, sound1EnvelopeUpDown),
-    SKIP(int, sound1SweepATL),
-    SKIP(int, sound1SweepATLReload),
-    SKIP(int, sound1SweepSteps),
-    SKIP(int, sound1SweepUpDown),
-    SKIP(int, sound1SweepStep),
-    SKIP(int, sound2On),
-    SKIP(int, sound2ATL),
-    SKIP(int, sound2Skip),
-    SKIP(int, sound2Index),
-    SKIP(int, sound2Continue),
-    SKIP(int, sound2EnvelopeVolume),
-    SKIP(int, sound2EnvelopeATL),
-    SKIP(int, sound2EnvelopeATLReload),
-    SKIP(int, sound2EnvelopeUpDown),
-    SKIP(int, sound3On),
-    SKIP(int, sound3ATL),
-    SKIP(int, sound3Skip),
-    SKIP(int, sound3Index),
-    SKIP(int, sound3Continue),
-    SKIP(int, sound3OutputLevel),
-    SKIP(int, sound4On),
-    SKIP(int, sound4ATL),
-    SKIP(int, sound4Skip),
-    SKIP(int, sound4Index),
-    SKIP(int, sound4Clock),
-    SKIP(int, sound4ShiftRight),
-    SKIP(int, sound4ShiftSkip),
-    SKIP(int, sound4ShiftIndex),
-    SKIP(int, sound4NSteps),
-    SKIP(int, sound4CountDown),
-    SKIP(int, sound4Continue),
-    SKIP(int, sound4EnvelopeVolume),
-    SKIP(int, sound4EnvelopeATL),
-    SKIP(int, sound4EnvelopeATLReload),
-    SKIP(int, sound4EnvelopeUpDown),
-    LOAD(int, soundEnableFlag),
-    SKIP(int, soundControl),
-    LOAD(int, pcm[0].readIndex),
-    LOAD(int, pcm[0].count),
-    LOAD(int, pcm[0].writeIndex),
-    SKIP(uint8_t, soundDSAEnabled), // was bool, which was one byte on MS compiler
-    SKIP(int, soundDSATimer),
-    LOAD(uint8_t[32], pcm[0].fifo),
-    LOAD(uint8_t, state.soundDSAValue),
-    LOAD(int, pcm[1].readIndex),
-    LOAD(int, pcm[1].count),
-    LOAD(int, pcm[1].writeIndex),
-    SKIP(int, soundDSBEnabled),
-    SKIP(int, soundDSBTimer),
-    LOAD(uint8_t[32], pcm[1].fifo),
-    LOAD(int, state.soundDSBValue),
-
-    // skipped manually
-    //LOAD( int, soundBuffer[0][0], 6*735 },
-    //LOAD( int, soundFinalWave[0], 2*735 },
-    { NULL, 0 }
-};
-
-variable_desc old_gba_state2[] = {
-    LOAD(uint8_t[0x20], state.apu.regs[0x20]),
-    SKIP(int, sound3Bank),
-    SKIP(int, sound3DataSize),
-    SKIP(int, sound3ForcedOutput),
-    { NULL, 0 }
-};
+static std::vector<variable_desc> old_gba_state()
+{
+    return {
+        SKIP(int, soundPaused),
+        SKIP(int, soundPlay),
+        SKIP(int, soundTicks),
+        SKIP(int, SOUND_CLOCK_TICKS),
+        SKIP(int, soundLevel1),
+        SKIP(int, soundLevel2),
+        SKIP(int, soundBalance),
+        SKIP(int, soundMasterOn),
+        SKIP(int, soundIndex),
+        SKIP(int, sound1On),
+        SKIP(int, sound1ATL),
+        SKIP(int, sound1Skip),
+        SKIP(int, sound1Index),
+        SKIP(int, sound1Continue),
+        SKIP(int, sound1EnvelopeVolume),
+        SKIP(int, sound1EnvelopeATL),
+        SKIP(int, sound1EnvelopeATLReload),
+        SKIP(int, sound1EnvelopeUpDown),
+        SKIP(int, sound1SweepATL),
+        SKIP(int, sound1SweepATLReload),
+        SKIP(int, sound1SweepSteps),
+        SKIP(int, sound1SweepUpDown),
+        SKIP(int, sound1SweepStep),
+        SKIP(int, sound2On),
+        SKIP(int, sound2ATL),
+        SKIP(int, sound2Skip),
+        SKIP(int, sound2Index),
+        SKIP(int, sound2Continue),
+        SKIP(int, sound2EnvelopeVolume),
+        SKIP(int, sound2EnvelopeATL),
+        SKIP(int, sound2EnvelopeATLReload),
+        SKIP(int, sound2EnvelopeUpDown),
+        SKIP(int, sound3On),
+        SKIP(int, sound3ATL),
+        SKIP(int, sound3Skip),
+        SKIP(int, sound3Index),
+        SKIP(int, sound3Continue),
+        SKIP(int, sound3OutputLevel),
+        SKIP(int, sound4On),
+        SKIP(int, sound4ATL),
+        SKIP(int, sound4Skip),
+        SKIP(int, sound4Index),
+        SKIP(int, sound4Clock),
+        SKIP(int, sound4ShiftRight),
+        SKIP(int, sound4ShiftSkip),
+        SKIP(int, sound4ShiftIndex),
+        SKIP(int, sound4NSteps),
+        SKIP(int, sound4CountDown),
+        SKIP(int, sound4Continue),
+        SKIP(int, sound4EnvelopeVolume),
+        SKIP(int, sound4EnvelopeATL),
+        SKIP(int, sound4EnvelopeATLReload),
+        SKIP(int, sound4EnvelopeUpDown),
+        LOAD(int, soundEnableFlag),
+        SKIP(int, soundControl),
+        LOAD(int, pcm[0].readIndex),
+        LOAD(int, pcm[0].count),
+        LOAD(int, pcm[0].writeIndex),
+        SKIP(uint8_t, soundDSAEnabled), // was bool, which was one byte on MS compiler
+        SKIP(int, soundDSATimer),
+        LOAD(uint8_t[32], pcm[0].fifo),
+        LOAD(uint8_t, soundState.soundDSAValue),
+        LOAD(int, pcm[1].readIndex),
+        LOAD(int, pcm[1].count),
+        LOAD(int, pcm[1].writeIndex),
+        SKIP(int, soundDSBEnabled),
+        SKIP(int, soundDSBTimer),
+        LOAD(uint8_t[32], pcm[1].fifo),
+        LOAD(int, soundState.soundDSBValue),
+
+        // skipped manually
+        //LOAD( int, soundBuffer[0][0], 6*735 },
+        //LOAD( int, soundFinalWave[0], 2*735 },
+        { NULL, 0 }
+    };
+}
+
+static std::vector<variable_desc> old_gba_state2()
+{
+    return {
+        LOAD(uint8_t[0x20], soundState.apu.regs[0x20]),
+        SKIP(int, sound3Bank),
+        SKIP(int, sound3DataSize),
+        SKIP(int, sound3ForcedOutput),
+        { NULL, 0 }
+    };
+}
 #endif
 
 // New state format
-static variable_desc gba_state[] = {
-    // PCM
-    LOAD(int, pcm[0].readIndex),
-    LOAD(int, pcm[0].count),
-    LOAD(int, pcm[0].writeIndex),
-    LOAD(uint8_t[32], pcm[0].fifo),
-    LOAD(int, pcm[0].dac),
-
-    SKIP(int[4], room_for_expansion),
-
-    LOAD(int, pcm[1].readIndex),
-    LOAD(int, pcm[1].count),
-    LOAD(int, pcm[1].writeIndex),
-    LOAD(uint8_t[32], pcm[1].fifo),
-    LOAD(int, pcm[1].dac),
-
-    SKIP(int[4], room_for_expansion),
-
-    // APU
-    LOAD(uint8_t[0x40], state.apu.regs), // last values written to registers and wave RAM (both banks)
-    LOAD(int, state.apu.frame_time), // clocks until next frame sequencer action
-    LOAD(int, state.apu.frame_phase), // next step frame sequencer will run
-
-    LOAD(int, state.apu.sweep_freq), // sweep's internal frequency register
-    LOAD(int, state.apu.sweep_delay), // clocks until next sweep action
-    LOAD(int, state.apu.sweep_enabled),
-    LOAD(int, state.apu.sweep_neg), // obscure internal flag
-    LOAD(int, state.apu.noise_divider),
-    LOAD(int, state.apu.wave_buf), // last read byte of wave RAM
-
-    LOAD(int[4], state.apu.delay), // clocks until next channel action
-    LOAD(int[4], state.apu.length_ctr),
-    LOAD(int[4], state.apu.phase), // square/wave phase, noise LFSR
-    LOAD(int[4], state.apu.enabled), // internal enabled flag
+static std::vector<variable_desc> gba_state()
+{
+    return {
+        // PCM
+        LOAD(int, pcm[0].readIndex),
+        LOAD(int, pcm[0].count),
+        LOAD(int, pcm[0].writeIndex),
+        LOAD(uint8_t[32], pcm[0].fifo),
+        LOAD(int, pcm[0].dac),
 
-    LOAD(int[3], state.apu.env_delay), // clocks until next envelope action
-    LOAD(int[3], state.apu.env_volume),
-    LOAD(int[3], state.apu.env_enabled),
+        SKIP(int[4], room_for_expansion),
 
-    SKIP(int[13], room_for_expansion),
+        LOAD(int, pcm[1].readIndex),
+        LOAD(int, pcm[1].count),
+        LOAD(int, pcm[1].writeIndex),
+        LOAD(uint8_t[32], pcm[1].fifo),
+        LOAD(int, pcm[1].dac),
 
-    // Emulator
-    LOAD(int, soundEnableFlag),
-    LOAD(int, soundTicks),
-    SKIP(int[14], room_for_expansion),
+        SKIP(int[4], room_for_expansion),
 
-    { NULL, 0 }
-};
+        // APU
+        LOAD(uint8_t[0x40], soundState.apu.regs), // last values written to registers and wave RAM (both banks)
+        LOAD(int, soundState.apu.frame_time), // clocks until next frame sequencer action
+        LOAD(int, soundState.apu.frame_phase), // next step frame sequencer will run
+
+        LOAD(int, soundState.apu.sweep_freq), // sweep's internal frequency register
+        LOAD(int, soundState.apu.sweep_delay), // clocks until next sweep action
+        LOAD(int, soundState.apu.sweep_enabled),
+        LOAD(int, soundState.apu.sweep_neg), // obscure internal flag
+        LOAD(int, soundState.apu.noise_divider),
+        LOAD(int, soundState.apu.wave_buf), // last read byte of wave RAM
+
+        LOAD(int[4], soundState.apu.delay), // clocks until next channel action
+        LOAD(int[4], soundState.apu.length_ctr),
+        LOAD(int[4], soundState.apu.phase), // square/wave phase, noise LFSR
+        LOAD(int[4], soundState.apu.enabled), // internal enabled flag
+
+        LOAD(int[3], soundState.apu.env_delay), // clocks until next envelope action
+        LOAD(int[3], soundState.apu.env_volume),
+        LOAD(int[3], soundState.apu.env_enabled),
+
+        SKIP(int[13], room_for_expansion),
+
+        // Emulator
+        LOAD(int, soundEnableFlag),
+        LOAD(int, soundTicks),
+        SKIP(int[14], room_for_expansion),
+
+        { NULL, 0 }
+    };
+}
 
 #ifndef __LIBRETRO__
 void soundSaveGame(gzFile out)
 {
-    gb_apu->save_state(&state.apu);
+    gbaCore.gb_apu->save_state(&gbaCore.soundState.apu);
 
     // Be sure areas for expansion get written as zero
-    memset(dummy_state, 0, sizeof dummy_state);
+    memset(gbaCore.soundDummyState, 0, sizeof gbaCore.soundDummyState);
 
-    utilWriteData(out, gba_state);
+    utilWriteData(out, gba_state().data());
 }
 
 // Reads and discards count bytes from in
@@ -762,7 +865,7 @@ static void skip_read(gzFile in, int count)
 static void soundReadGameOld(gzFile in, int version)
 {
     // Read main data
-    utilReadData(in, old_gba_state);
+    utilReadData(in, old_gba_state().data());
     skip_read(in, 6 * 735 + 2 * 735);
 
     // Copy APU regs
@@ -774,26 +877,26 @@ static void soundReadGameOld(gzFile in, int version)
         NR50, NR51, NR52,
     };
 
-    g_ioMem[NR52] |= 0x80; // old sound played even when this wasn't set (power on)
+    gbaCore.g_ioMem[NR52] |= 0x80; // old sound played even when this wasn't set (power on)
 
     for (const int gba_reg: regs_to_copy) {
         const int gb_reg = gba_to_gb_sound(gba_reg);
         if (gb_reg >= 0xFF10) {
-            state.apu.regs[gb_reg - 0xFF10] = g_ioMem[gba_reg];
+            gbaCore.soundState.apu.regs[gb_reg - 0xFF10] = gbaCore.g_ioMem[gba_reg];
         }
     }
 
     // Copy wave RAM to both banks
-    memcpy(&state.apu.regs[0x20], &g_ioMem[0x90], 0x10);
-    memcpy(&state.apu.regs[0x30], &g_ioMem[0x90], 0x10);
+    memcpy(&gbaCore.soundState.apu.regs[0x20], &gbaCore.g_ioMem[0x90], 0x10);
+    memcpy(&gbaCore.soundState.apu.regs[0x30], &gbaCore.g_ioMem[0x90], 0x10);
 
     // Read both banks of wave RAM if available
     if (version >= SAVE_GAME_VERSION_3)
-        utilReadData(in, old_gba_state2);
+        utilReadData(in, old_gba_state2().data());
 
     // Restore PCM
-    pcm[0].dac = state.soundDSAValue;
-    pcm[1].dac = state.soundDSBValue;
+    gbaCore.pcm[0].dac = gbaCore.soundState.soundDSAValue;
+    gbaCore.pcm[1].dac = gbaCore.soundState.soundDSBValue;
 
     (void)utilReadInt(in); // ignore quality
 }
@@ -804,15 +907,15 @@ void soundReadGame(gzFile in, int version)
 {
     // Prepare APU and default state
     reset_apu();
-    gb_apu->save_state(&state.apu);
+    gbaCore.gb_apu->save_state(&gbaCore.soundState.apu);
 
     if (version > SAVE_GAME_VERSION_9)
-        utilReadData(in, gba_state);
+        utilReadData(in, gba_state().data());
     else
         soundReadGameOld(in, version);
 
-    gb_apu->load_state(state.apu);
-    write_SGCNT0_H(READ16LE(&g_ioMem[SGCNT0_H]) & 0x770F);
+    gbaCore.gb_apu->load_state(gbaCore.soundState.apu);
+    write_SGCNT0_H(READ16LE(&gbaCore.g_ioMem[SGCNT0_H]) & 0x770F);
 
     apply_muting();
 }
@@ -821,24 +924,24 @@ void soundReadGame(gzFile in, int version)
 #ifdef __LIBRETRO__
 void soundSaveGame(uint8_t*& out)
 {
-    gb_apu->save_state(&state.apu);
+    gbaCore.gb_apu->save_state(&gbaCore.soundState.apu);
 
     // Be sure areas for expansion get written as zero
-    memset(dummy_state, 0, sizeof dummy_state);
+    memset(gbaCore.soundDummyState, 0, sizeof gbaCore.soundDummyState);
 
-    utilWriteDataMem(out, gba_state);
+    utilWriteDataMem(out, gba_state().data());
 }
 
 void soundReadGame(const uint8_t*& in)
 {
     // Prepare APU and default state
     reset_apu();
-    gb_apu->save_state(&state.apu);
+    gbaCore.gb_apu->save_state(&gbaCore.soundState.apu);
 
-    utilReadDataMem(in, gba_state);
+    utilReadDataMem(in, gba_state().data());
 
-    gb_apu->load_state(state.apu);
-    write_SGCNT0_H(READ16LE(&g_ioMem[SGCNT0_H]) & 0x770F);
+    gbaCore.gb_apu->load_state(gbaCore.soundState.apu);
+    write_SGCNT0_H(READ16LE(&gbaCore.g_ioMem[SGCNT0_H]) & 0x770F);
 
     apply_muting();
 }
@@ -7,6 +7,8 @@
 #include <zlib.h>
 #endif  // !defined(__LIBRETRO__)
 
+#include "core/base/system.h"
+
 // Sound emulation setup/options and GBA sound emulation
 
 //// Setup/options (these affect GBA and GB sound)
@@ -17,6 +19,9 @@ bool soundInit();
 
 // sets the Sound throttle
 void soundSetThrottle(unsigned short throttle);
+// gets the Sound throttle, in percent of the native speed, 0 for none. It
+// starts out as coreOptions.throttle at soundInit().
+unsigned short soundGetThrottle();
 
 // Manages sound volume, where 1.0 is normal
 void soundSetVolume(float);
@@ -32,10 +37,16 @@ float soundGetVolume();
 void soundSetEnable(int mask);
 int soundGetEnable();
 
+// Manages silent mode, for fast-forwarding and for runs that don't need the
+// sound: nothing is synthesized or mixed and the output is silence, while the
+// sound hardware, FIFOs included, keeps being emulated exactly. Changes take
+// effect at the next frame.
+void soundSetSilent(bool silent);
+bool soundGetSilent();
+
 // Pauses/resumes system sound output
 void soundPause();
 void soundResume();
-extern bool soundPaused; // current paused state
 
 // Cleans up sound. Afterwards, soundInit() can be called again.
 void soundShutdown();
@@ -46,8 +57,9 @@ long soundGetSampleRate();
 void soundSetSampleRate(long sampleRate);
 
 // Sound settings
-extern bool g_gbaSoundInterpolation; // 1 if PCM should have low-pass filtering
-extern float soundFiltering; // 0.0 = none, 1.0 = max
+// Lets a frontend with the vertical sync on be paced by it rather than by its
+// frame limiter. The drivers that report their buffer level always get rate
+// control, which makes up for the display running faster or slower.
 
 //// GBA sound emulation
 
@@ -69,6 +81,9 @@ void soundEvent16(uint32_t addr, uint16_t data); // TODO: error-prone to overloa
 // Notifies emulator that a timer has overflowed
 void soundTimerOverflow(int which);
 
+// Emulates a DMA transfer of count words to FIFOA_L or FIFOB_L
+void soundWriteFifo(uint32_t addr, const uint32_t* data, int count);
+
 // Notifies emulator that PCM rate may have changed
 void interp_rate();
 
@@ -77,7 +92,6 @@ void psoundTickfn();
 extern int SOUND_CLOCK_TICKS; // Number of 16.8 MHz clocks between calls to soundTick()
 
 // 2018-12-10 - counts up from 0 since last psoundTickfn() was called
-extern int soundTicks;
 
 // Saves/loads emulator state
 #ifdef __LIBRETRO__
@@ -91,5 +105,7 @@ void soundReadGame(gzFile, int version);
 class Multi_Buffer;
 
 void flush_samples(Multi_Buffer* buffer);
+// Writes silence in place of the samples in `buffer`, skipping them.
+void flush_silence(Multi_Buffer* buffer);
 
 #endif  // VBAM_CORE_GBA_GBASOUND_H_
@@ -0,0 +1,171 @@
+#include "core/gba/internal/gbaAffine.h"
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/base/cpu_features.h"
+
+namespace {
+
+class GbaAffineTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        // Same sizes as the real VRAM and palette, the AVX2 gathers rely on
+        // them.
+        vram_.resize(0x20000);
+        palette_.resize(0x400);
+        for (uint8_t& byte : vram_)
+            byte = Random(0xFF);
+        for (uint8_t& byte : palette_)
+            byte = Random(0xFF);
+
+        // Leave some colour 0 pixels to check transparency.
+        for (int i = 0; i < 0x20000; i += 7)
+            vram_[i] = 0;
+    }
+
+    GfxAffineState RandomLine()
+    {
+        GfxAffineState state;
+        state.format = (GfxAffineFormat)Random(2);
+        state.wrap = false;
+        state.mapShift = 0;
+        state.charBase = nullptr;
+        state.palette = palette_.data();
+        state.prio = (Random(3) << 25) + 0x1000000;
+
+        switch (state.format) {
+        case kGfxAffineTiled: {
+            const int size = Random(3);
+            state.width = state.height = 128 << size;
+            state.mapShift = size + 4;
+            state.wrap = Random(1);
+            state.screenBase = &vram_[Random(31) * 0x800];
+            state.charBase = &vram_[Random(3) * 0x4000];
+            break;
+        }
+        case kGfxAffineBitmap8:
+            state.width = 240;
+            state.height = 160;
+            state.screenBase = &vram_[Random(1) * 0xA000];
+            break;
+        case kGfxAffineBitmap16:
+            if (Random(1)) {
+                state.width = 240;
+                state.height = 160;
+                state.screenBase = &vram_[0];
+            } else {
+                state.width = 160;
+                state.height = 128;
+                state.screenBase = &vram_[Random(1) * 0xA000];
+            }
+            break;
+        }
+
+        // Mostly lines crossing the background, sometimes anywhere in the
+        // 28-bit reference point range and with any step.
+        if (Random(3)) {
+            state.x = (int)Random(state.width * 2 * 256) - state.width * 256 / 2;
+            state.y = (int)Random(state.height * 2 * 256) - state.height * 256 / 2;
+            state.dx = (int)Random(0x400) - 0x200;
+            state.dy = (int)Random(0x400) - 0x200;
+        } else {
+            state.x = (int)(Random(0x0FFFFFFF) | (Random(1) ? 0xF8000000 : 0));
+            state.y = (int)(Random(0x0FFFFFFF) | (Random(1) ? 0xF8000000 : 0));
+            state.dx = (int16_t)Random(0xFFFF);
+            state.dy = (int16_t)Random(0xFFFF);
+        }
+        return state;
+    }
+
+    void ExpectMatchesScalar(GfxAffineLineFunc kernel)
+    {
+        for (int i = 0; i < 20000; i++) {
+            const GfxAffineState state = RandomLine();
+
+            uint32_t expected[240];
+            gfxDrawAffineLineScalar(state, expected);
+
+            uint32_t line[240] = {};
+            kernel(state, line);
+
+            for (int x = 0; x < 240; x++) {
+                ASSERT_EQ(line[x], expected[x]) << "line " << i << " format " << state.format << " pixel " << x;
+            }
+        }
+    }
+
+private:
+    uint32_t Random(uint32_t max)
+    {
+        return std::uniform_int_distribution<uint32_t>(0, max)(rng_);
+    }
+
+    std::mt19937 rng_{ 160 };
+    std::vector<uint8_t> vram_;
+    std::vector<uint8_t> palette_;
+};
+
+TEST_F(GbaAffineTest, ScalarWrapsAndClips)
+{
+    std::vector<uint8_t> vram(0x20000);
+    std::vector<uint8_t> palette(0x400);
+    palette[2] = 0x34;
+    palette[3] = 0x12;
+
+    // Tile 0 is colour 1 everywhere, the map is all tile 0.
+    for (int i = 0; i < 64; i++)
+        vram[0x4000 + i] = 1;
+
+    GfxAffineState state = {};
+    state.format = kGfxAffineTiled;
+    state.x = -8 * 256;
+    state.dx = 256;
+    state.width = state.height = 128;
+    state.mapShift = 4;
+    state.screenBase = &vram[0];
+    state.charBase = &vram[0x4000];
+    state.palette = palette.data();
+    state.prio = 0x1000000;
+
+    uint32_t line[240];
+    gfxDrawAffineLineScalar(state, line);
+    EXPECT_EQ(line[7], 0x80000000u);
+    EXPECT_EQ(line[8], 0x1001234u);
+    EXPECT_EQ(line[135], 0x1001234u);
+    EXPECT_EQ(line[136], 0x80000000u);
+
+    state.wrap = true;
+    gfxDrawAffineLineScalar(state, line);
+    EXPECT_EQ(line[0], 0x1001234u);
+    EXPECT_EQ(line[239], 0x1001234u);
+}
+
+#if defined(VBAM_GFX_AFFINE_SSE2)
+TEST_F(GbaAffineTest, Sse2MatchesScalar)
+{
+    ExpectMatchesScalar(gfxDrawAffineLineSse2);
+}
+#endif
+
+#if defined(VBAM_GFX_AFFINE_AVX2)
+TEST_F(GbaAffineTest, Avx2MatchesScalar)
+{
+    if (!cpuHasAvx2()) {
+        GTEST_SKIP() << "AVX2 is not supported by this CPU";
+    }
+    ExpectMatchesScalar(gfxDrawAffineLineAvx2);
+}
+#endif
+
+#if defined(VBAM_GFX_AFFINE_NEON)
+TEST_F(GbaAffineTest, NeonMatchesScalar)
+{
+    ExpectMatchesScalar(gfxDrawAffineLineNeon);
+}
+#endif
+
+}  // namespace
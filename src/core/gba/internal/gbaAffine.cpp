@@ -0,0 +1,216 @@
+#include "core/gba/internal/gbaAffine.h"
+
+#include "core/base/cpu_features.h"
+
+#if defined(VBAM_GFX_AFFINE_SSE2)
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif  // defined(VBAM_GFX_AFFINE_SSE2)
+
+#if defined(VBAM_GFX_AFFINE_NEON)
+#include <arm_neon.h>
+#endif  // defined(VBAM_GFX_AFFINE_NEON)
+
+#if defined(VBAM_GFX_AFFINE_SSE2)
+
+namespace sse2 {
+namespace {
+
+struct V {
+    typedef __m128i T;
+    static constexpr int kLanes = 4;
+
+    static inline T load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static inline void store(uint32_t* p, T a) { _mm_storeu_si128((__m128i*)p, a); }
+    static inline T set1(uint32_t v) { return _mm_set1_epi32((int)v); }
+    static inline T and_(T a, T b) { return _mm_and_si128(a, b); }
+    static inline T or_(T a, T b) { return _mm_or_si128(a, b); }
+    static inline T add(T a, T b) { return _mm_add_epi32(a, b); }
+    static inline T mul(T a, T b) { return _mm_mullo_epi16(a, b); }
+    template <int n>
+    static inline T srai(T a) { return _mm_srai_epi32(a, n); }
+    template <int n>
+    static inline T srl(T a) { return _mm_srli_epi32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return _mm_slli_epi32(a, n); }
+    static inline T shl(T a, int n) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+    static inline T cmpGt(T a, T b) { return _mm_cmpgt_epi32(a, b); }
+    static inline T cmpEq(T a, T b) { return _mm_cmpeq_epi32(a, b); }
+    static inline T select(T m, T a, T b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static inline bool any(T m) { return _mm_movemask_epi8(m) != 0; }
+    static inline T gather8(const uint8_t* base, T index)
+    {
+        uint32_t i[kLanes];
+        store(i, index);
+        return _mm_setr_epi32(base[i[0]], base[i[1]], base[i[2]], base[i[3]]);
+    }
+    static inline T gather16(const uint8_t* base, T index)
+    {
+        uint32_t i[kLanes];
+        store(i, index);
+        return _mm_setr_epi32(READ16LE(&base[i[0]]), READ16LE(&base[i[1]]), READ16LE(&base[i[2]]),
+            READ16LE(&base[i[3]]));
+    }
+};
+
+#include "core/gba/internal/gbaAffineKernel.h"
+
+}  // namespace
+}  // namespace sse2
+
+void gfxDrawAffineLineSse2(const GfxAffineState& state, uint32_t* line)
+{
+    sse2::drawAffineLine(state, line);
+}
+
+#endif  // defined(VBAM_GFX_AFFINE_SSE2)
+
+#if defined(VBAM_GFX_AFFINE_AVX2)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+namespace {
+
+// The hardware gathers load 4 bytes per lane and keep the low ones, so they
+// may read up to 3 bytes past the last VRAM or palette entry used. Both are
+// allocated larger than the renderers ever index.
+struct V {
+    typedef __m256i T;
+    static constexpr int kLanes = 8;
+
+    static inline T load(const uint32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static inline void store(uint32_t* p, T a) { _mm256_storeu_si256((__m256i*)p, a); }
+    static inline T set1(uint32_t v) { return _mm256_set1_epi32((int)v); }
+    static inline T and_(T a, T b) { return _mm256_and_si256(a, b); }
+    static inline T or_(T a, T b) { return _mm256_or_si256(a, b); }
+    static inline T add(T a, T b) { return _mm256_add_epi32(a, b); }
+    static inline T mul(T a, T b) { return _mm256_mullo_epi16(a, b); }
+    template <int n>
+    static inline T srai(T a) { return _mm256_srai_epi32(a, n); }
+    template <int n>
+    static inline T srl(T a) { return _mm256_srli_epi32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return _mm256_slli_epi32(a, n); }
+    static inline T shl(T a, int n) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+    static inline T cmpGt(T a, T b) { return _mm256_cmpgt_epi32(a, b); }
+    static inline T cmpEq(T a, T b) { return _mm256_cmpeq_epi32(a, b); }
+    static inline T select(T m, T a, T b) { return _mm256_blendv_epi8(b, a, m); }
+    static inline bool any(T m) { return !_mm256_testz_si256(m, m); }
+    static inline T gather8(const uint8_t* base, T index)
+    {
+        return _mm256_and_si256(_mm256_i32gather_epi32((const int*)base, index, 1), set1(0xFF));
+    }
+    static inline T gather16(const uint8_t* base, T index)
+    {
+        return _mm256_and_si256(_mm256_i32gather_epi32((const int*)base, index, 1), set1(0xFFFF));
+    }
+};
+
+#include "core/gba/internal/gbaAffineKernel.h"
+
+}  // namespace
+}  // namespace avx2
+
+void gfxDrawAffineLineAvx2(const GfxAffineState& state, uint32_t* line)
+{
+    avx2::drawAffineLine(state, line);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif  // defined(VBAM_GFX_AFFINE_AVX2)
+
+#if defined(VBAM_GFX_AFFINE_NEON)
+
+namespace neon {
+namespace {
+
+struct V {
+    typedef uint32x4_t T;
+    static constexpr int kLanes = 4;
+
+    static inline T load(const uint32_t* p) { return vld1q_u32(p); }
+    static inline void store(uint32_t* p, T a) { vst1q_u32(p, a); }
+    static inline T set1(uint32_t v) { return vdupq_n_u32(v); }
+    static inline T and_(T a, T b) { return vandq_u32(a, b); }
+    static inline T or_(T a, T b) { return vorrq_u32(a, b); }
+    static inline T add(T a, T b) { return vaddq_u32(a, b); }
+    static inline T mul(T a, T b) { return vmulq_u32(a, b); }
+    template <int n>
+    static inline T srai(T a) { return vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(a), n)); }
+    template <int n>
+    static inline T srl(T a) { return vshrq_n_u32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return vshlq_n_u32(a, n); }
+    static inline T shl(T a, int n) { return vshlq_u32(a, vdupq_n_s32(n)); }
+    static inline T cmpGt(T a, T b) { return vcgtq_s32(vreinterpretq_s32_u32(a), vreinterpretq_s32_u32(b)); }
+    static inline T cmpEq(T a, T b) { return vceqq_u32(a, b); }
+    static inline T select(T m, T a, T b) { return vbslq_u32(m, a, b); }
+    static inline bool any(T m) { return vmaxvq_u32(m) != 0; }
+    static inline T gather8(const uint8_t* base, T index)
+    {
+        uint32_t i[kLanes];
+        store(i, index);
+        const uint32_t v[kLanes] = { base[i[0]], base[i[1]], base[i[2]], base[i[3]] };
+        return load(v);
+    }
+    static inline T gather16(const uint8_t* base, T index)
+    {
+        uint32_t i[kLanes];
+        store(i, index);
+        const uint32_t v[kLanes] = { READ16LE(&base[i[0]]), READ16LE(&base[i[1]]), READ16LE(&base[i[2]]),
+            READ16LE(&base[i[3]]) };
+        return load(v);
+    }
+};
+
+#include "core/gba/internal/gbaAffineKernel.h"
+
+}  // namespace
+}  // namespace neon
+
+void gfxDrawAffineLineNeon(const GfxAffineState& state, uint32_t* line)
+{
+    neon::drawAffineLine(state, line);
+}
+
+#endif  // defined(VBAM_GFX_AFFINE_NEON)
+
+GfxAffineLineFunc gfxAffineLineKernel()
+{
+#if defined(VBAM_GFX_AFFINE_AVX2)
+    if (cpuHasAvx2())
+        return gfxDrawAffineLineAvx2;
+#endif
+#if defined(VBAM_GFX_AFFINE_SSE2)
+    return gfxDrawAffineLineSse2;
+#elif defined(VBAM_GFX_AFFINE_NEON)
+    return gfxDrawAffineLineNeon;
+#else
+    return nullptr;
+#endif
+}
+
+namespace {
+
+const GfxAffineLineFunc gfxAffineLineVector = gfxAffineLineKernel();
+
+}  // namespace
+
+void gfxDrawAffineLine(const GfxAffineState& state, uint32_t* line)
+{
+    if (gfxAffineLineVector)
+        gfxAffineLineVector(state, line);
+    else
+        gfxDrawAffineLineScalar(state, line);
+}
@@ -0,0 +1,115 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBAAFFINE_H_
+#define VBAM_CORE_GBA_INTERNAL_GBAAFFINE_H_
+
+#include <cstdint>
+
+#include "core/base/port.h"
+
+// Pixel fetch for the affine (rotation/scaling) backgrounds of modes 1 to 5.
+//
+// The gfxDrawRotScreen*() functions in gbaGfx.h work out where the line
+// starts in the background and how far each pixel moves, then hand the
+// actual sampling to gfxDrawAffineLine(). The vector kernels in gbaAffine.cpp
+// step several pixels at once, and gather the map, tile and palette entries
+// for all of them. gfxDrawAffineLineScalar() is the reference implementation,
+// the kernels must give bit-identical results. Mosaic is applied by the
+// callers, before (vertical) and after (horizontal) the fetch.
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VBAM_GFX_AFFINE_SSE2
+#define VBAM_GFX_AFFINE_AVX2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VBAM_GFX_AFFINE_NEON
+#endif
+
+enum GfxAffineFormat {
+    // 256-colour tiles through a square map, modes 1 and 2.
+    kGfxAffineTiled,
+    // 8-bit paletted bitmap, mode 4.
+    kGfxAffineBitmap8,
+    // 15-bit direct colour bitmap, modes 3 and 5.
+    kGfxAffineBitmap16,
+};
+
+struct GfxAffineState {
+    GfxAffineFormat format;
+    // Position of the first pixel and the step to the next one, in 20.8
+    // fixed point.
+    int x;
+    int y;
+    int dx;
+    int dy;
+    // Size of the background in pixels. Pixels outside are transparent,
+    // unless `wrap` is set, which only tiled backgrounds support.
+    int width;
+    int height;
+    bool wrap;
+    // Map width in tiles, as a power of two.
+    int mapShift;
+    // The map for tiled backgrounds, the bitmap otherwise.
+    const uint8_t* screenBase;
+    const uint8_t* charBase;
+    const uint8_t* palette;
+    uint32_t prio;
+};
+
+typedef void (*GfxAffineLineFunc)(const GfxAffineState& state, uint32_t* line);
+
+// Fetches the 240 pixels of the line with the fastest kernel available.
+void gfxDrawAffineLine(const GfxAffineState& state, uint32_t* line);
+
+// Tiled backgrounds are a power of two wide and high, wrapping is a mask.
+static inline void gfxDrawAffineLineScalar(const GfxAffineState& state, uint32_t* line)
+{
+    int realX = state.x;
+    int realY = state.y;
+
+    for (int x = 0; x < 240; x++) {
+        int xxx = realX >> 8;
+        int yyy = realY >> 8;
+        realX += state.dx;
+        realY += state.dy;
+
+        if (state.wrap) {
+            xxx &= state.width - 1;
+            yyy &= state.height - 1;
+        } else if (xxx < 0 || yyy < 0 || xxx >= state.width || yyy >= state.height) {
+            line[x] = 0x80000000;
+            continue;
+        }
+
+        uint8_t color;
+        switch (state.format) {
+        case kGfxAffineTiled: {
+            int tile = state.screenBase[(xxx >> 3) + ((yyy >> 3) << state.mapShift)];
+            color = state.charBase[(tile << 6) + ((yyy & 7) << 3) + (xxx & 7)];
+            break;
+        }
+        case kGfxAffineBitmap8:
+            color = state.screenBase[yyy * state.width + xxx];
+            break;
+        default:
+            line[x] = READ16LE(&state.screenBase[(yyy * state.width + xxx) * 2]) | state.prio;
+            continue;
+        }
+
+        line[x] = color ? (READ16LE(&state.palette[color * 2]) | state.prio) : 0x80000000;
+    }
+}
+
+// Returns the fastest vector kernel supported by the host CPU, or null if
+// there is none.
+GfxAffineLineFunc gfxAffineLineKernel();
+
+#if defined(VBAM_GFX_AFFINE_SSE2)
+void gfxDrawAffineLineSse2(const GfxAffineState& state, uint32_t* line);
+#endif
+#if defined(VBAM_GFX_AFFINE_AVX2)
+void gfxDrawAffineLineAvx2(const GfxAffineState& state, uint32_t* line);
+#endif
+#if defined(VBAM_GFX_AFFINE_NEON)
+void gfxDrawAffineLineNeon(const GfxAffineState& state, uint32_t* line);
+#endif
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBAAFFINE_H_
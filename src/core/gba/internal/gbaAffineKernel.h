@@ -0,0 +1,81 @@
+// Vector affine background fetch, see gbaAffine.h for what it computes.
+//
+// This file has no include guard: gbaAffine.cpp includes it once per
+// instruction set, inside a namespace defining the vector type `V`, so that
+// every copy is compiled for its own target. `V` works on 32-bit lanes and
+// provides the operations used below. `V::mul()` is only required to be
+// exact for products below 0x10000, and the gathers return the byte or
+// little-endian halfword at `base` plus each lane.
+
+void drawAffineLine(const GfxAffineState& state, uint32_t* line)
+{
+    // Lane i starts i pixels into the line. The positions wrap around like
+    // the scalar loop does when they overflow.
+    uint32_t startX[V::kLanes];
+    uint32_t startY[V::kLanes];
+    for (int i = 0; i < V::kLanes; i++) {
+        startX[i] = (uint32_t)state.x + (uint32_t)state.dx * i;
+        startY[i] = (uint32_t)state.y + (uint32_t)state.dy * i;
+    }
+
+    V::T realX = V::load(startX);
+    V::T realY = V::load(startY);
+    const V::T stepX = V::set1((uint32_t)state.dx * V::kLanes);
+    const V::T stepY = V::set1((uint32_t)state.dy * V::kLanes);
+
+    const V::T zero = V::set1(0);
+    const V::T minusOne = V::set1(0xFFFFFFFF);
+    const V::T seven = V::set1(7);
+    const V::T transparent = V::set1(0x80000000);
+    const V::T prio = V::set1(state.prio);
+    const V::T width = V::set1(state.width);
+    const V::T height = V::set1(state.height);
+    const V::T widthMask = V::set1(state.width - 1);
+    const V::T heightMask = V::set1(state.height - 1);
+
+    for (int x = 0; x < 240; x += V::kLanes) {
+        V::T xxx = V::srai<8>(realX);
+        V::T yyy = V::srai<8>(realY);
+        realX = V::add(realX, stepX);
+        realY = V::add(realY, stepY);
+
+        V::T inside = minusOne;
+        if (state.wrap) {
+            xxx = V::and_(xxx, widthMask);
+            yyy = V::and_(yyy, heightMask);
+        } else {
+            inside = V::and_(V::cmpGt(xxx, minusOne), V::cmpGt(width, xxx));
+            inside = V::and_(inside, V::and_(V::cmpGt(yyy, minusOne), V::cmpGt(height, yyy)));
+            if (!V::any(inside)) {
+                V::store(line + x, transparent);
+                continue;
+            }
+
+            // Pixels outside fetch the first one instead, keeping the
+            // gathers in bounds.
+            xxx = V::and_(xxx, inside);
+            yyy = V::and_(yyy, inside);
+        }
+
+        V::T pixel;
+        if (state.format == kGfxAffineBitmap16) {
+            V::T offset = V::add(V::mul(yyy, width), xxx);
+            pixel = V::or_(V::gather16(state.screenBase, V::sll<1>(offset)), prio);
+        } else {
+            V::T color;
+            if (state.format == kGfxAffineTiled) {
+                V::T map = V::add(V::srl<3>(xxx), V::shl(V::srl<3>(yyy), state.mapShift));
+                V::T tile = V::gather8(state.screenBase, map);
+                V::T offset = V::add(V::sll<3>(V::and_(yyy, seven)), V::and_(xxx, seven));
+                color = V::gather8(state.charBase, V::add(V::sll<6>(tile), offset));
+            } else {
+                color = V::gather8(state.screenBase, V::add(V::mul(yyy, width), xxx));
+            }
+
+            pixel = V::or_(V::gather16(state.palette, V::sll<1>(color)), prio);
+            pixel = V::select(V::cmpEq(color, zero), transparent, pixel);
+        }
+
+        V::store(line + x, V::select(inside, pixel, transparent));
+    }
+}
@@ -7,6 +7,9 @@
 #include "core/gba/gba.h"
 #include "core/gba/gbaGlobals.h"
 #include "core/gba/gbaInline.h"
+#include "core/gba/internal/gbaDecodeCache.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
+#include "core/gba/internal/gbaTileCache.h"
 
 int16_t sineTable[256] = {
     (int16_t)0x0000u, (int16_t)0x0192u, (int16_t)0x0323u, (int16_t)0x04B5u, (int16_t)0x0645u, (int16_t)0x07D5u, (int16_t)0x0964u, (int16_t)0x0AF1u,
@@ -53,12 +56,12 @@ void BIOS_ArcTan()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("ArcTan: %08x (VCOUNT=%2d)\n",
-            reg[0].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    int32_t i = reg[0].I;
+    int32_t i = gbaCore.reg[0].I;
     int32_t a = -((i * i) >> 14);
     int32_t b = ((0xA9 * a) >> 14) + 0x390;
     b = ((b * a) >> 14) + 0x91C;
@@ -67,14 +70,14 @@ void BIOS_ArcTan()
     b = ((b * a) >> 14) + 0x2081;
     b = ((b * a) >> 14) + 0x3651;
     b = ((b * a) >> 14) + 0xA2F9;
-    reg[0].I = (i * b) >> 16;
-    reg[1].I = a;
-    reg[3].I = b;
+    gbaCore.reg[0].I = (i * b) >> 16;
+    gbaCore.reg[1].I = a;
+    gbaCore.reg[3].I = b;
 
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("ArcTan: return=%08x\n",
-            reg[0].I);
+            gbaCore.reg[0].I);
     }
 #endif
 }
@@ -84,14 +87,14 @@ void BIOS_ArcTan2()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("ArcTan2: %08x,%08x (VCOUNT=%2d)\n",
-            reg[0].I,
-            reg[1].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    int32_t x = reg[0].I;
-    int32_t y = reg[1].I;
+    int32_t x = gbaCore.reg[0].I;
+    int32_t y = gbaCore.reg[1].I;
     int32_t res = 0;
     if (y == 0) {
         res = ((x >> 16) & 0x8000);
@@ -100,29 +103,29 @@ void BIOS_ArcTan2()
             res = ((y >> 16) & 0x8000) + 0x4000;
         } else {
             if ((abs(x) > abs(y)) || ((abs(x) == abs(y)) && (!((x < 0) && (y < 0))))) {
-                reg[1].I = x;
-                reg[0].I = y << 14;
+                gbaCore.reg[1].I = x;
+                gbaCore.reg[0].I = y << 14;
                 BIOS_Div();
                 BIOS_ArcTan();
                 if (x < 0)
-                    res = 0x8000 + reg[0].I;
+                    res = 0x8000 + gbaCore.reg[0].I;
                 else
-                    res = (((y >> 16) & 0x8000) << 1) + reg[0].I;
+                    res = (((y >> 16) & 0x8000) << 1) + gbaCore.reg[0].I;
             } else {
-                reg[0].I = x << 14;
+                gbaCore.reg[0].I = x << 14;
                 BIOS_Div();
                 BIOS_ArcTan();
-                res = (0x4000 + ((y >> 16) & 0x8000)) - reg[0].I;
+                res = (0x4000 + ((y >> 16) & 0x8000)) - gbaCore.reg[0].I;
             }
         }
     }
-    reg[0].I = res;
-    reg[3].I = 0x170;
+    gbaCore.reg[0].I = res;
+    gbaCore.reg[3].I = 0x170;
 
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("ArcTan2: return=%08x\n",
-            reg[0].I);
+            gbaCore.reg[0].I);
     }
 #endif
 }
@@ -132,16 +135,16 @@ void BIOS_BitUnPack()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("BitUnPack: %08x,%08x,%08x (VCOUNT=%2d)\n",
-            reg[0].I,
-            reg[1].I,
-            reg[2].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.reg[2].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
-    uint32_t header = reg[2].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
+    uint32_t header = gbaCore.reg[2].I;
 
     int len = CPUReadHalfWord(header);
     // check address
@@ -190,7 +193,7 @@ void BIOS_BitUnPack()
 
 void BIOS_GetBiosChecksum()
 {
-    reg[0].I = 0xBAAE187F;
+    gbaCore.reg[0].I = 0xBAAE187F;
 }
 
 void BIOS_BgAffineSet()
@@ -198,16 +201,16 @@ void BIOS_BgAffineSet()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("BgAffineSet: %08x,%08x,%08x (VCOUNT=%2d)\n",
-            reg[0].I,
-            reg[1].I,
-            reg[2].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.reg[2].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t src = reg[0].I;
-    uint32_t dest = reg[1].I;
-    int num = reg[2].I;
+    uint32_t src = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
+    int num = gbaCore.reg[2].I;
 
     for (int i = 0; i < num; i++) {
         int32_t cx = CPUReadMemory(src);
@@ -255,14 +258,14 @@ void BIOS_CpuSet()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("CpuSet: 0x%08x,0x%08x,0x%08x (VCOUNT=%d)\n", reg[0].I, reg[1].I,
-            reg[2].I, VCOUNT);
+        log("CpuSet: 0x%08x,0x%08x,0x%08x (VCOUNT=%d)\n", gbaCore.reg[0].I, gbaCore.reg[1].I,
+            gbaCore.reg[2].I, gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
-    uint32_t cnt = reg[2].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
+    uint32_t cnt = gbaCore.reg[2].I;
 
     if (((source & 0xe000000) == 0) || ((source + (((cnt << 11) >> 9) & 0x1fffff)) & 0xe000000) == 0)
         return;
@@ -316,14 +319,14 @@ void BIOS_CpuFastSet()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("CpuFastSet: 0x%08x,0x%08x,0x%08x (VCOUNT=%d)\n", reg[0].I, reg[1].I,
-            reg[2].I, VCOUNT);
+        log("CpuFastSet: 0x%08x,0x%08x,0x%08x (VCOUNT=%d)\n", gbaCore.reg[0].I, gbaCore.reg[1].I,
+            gbaCore.reg[2].I, gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
-    uint32_t cnt = reg[2].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
+    uint32_t cnt = gbaCore.reg[2].I;
 
     if (((source & 0xe000000) == 0) || ((source + (((cnt << 11) >> 9) & 0x1fffff)) & 0xe000000) == 0)
         return;
@@ -363,13 +366,13 @@ void BIOS_Diff8bitUnFilterWram()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("Diff8bitUnFilterWram: 0x%08x,0x%08x (VCOUNT=%d)\n", reg[0].I,
-            reg[1].I, VCOUNT);
+        log("Diff8bitUnFilterWram: 0x%08x,0x%08x (VCOUNT=%d)\n", gbaCore.reg[0].I,
+            gbaCore.reg[1].I, gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source);
     source += 4;
@@ -395,13 +398,13 @@ void BIOS_Diff8bitUnFilterVram()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("Diff8bitUnFilterVram: 0x%08x,0x%08x (VCOUNT=%d)\n", reg[0].I,
-            reg[1].I, VCOUNT);
+        log("Diff8bitUnFilterVram: 0x%08x,0x%08x (VCOUNT=%d)\n", gbaCore.reg[0].I,
+            gbaCore.reg[1].I, gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source);
     source += 4;
@@ -437,13 +440,13 @@ void BIOS_Diff16bitUnFilter()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("Diff16bitUnFilter: 0x%08x,0x%08x (VCOUNT=%d)\n", reg[0].I,
-            reg[1].I, VCOUNT);
+        log("Diff16bitUnFilter: 0x%08x,0x%08x (VCOUNT=%d)\n", gbaCore.reg[0].I,
+            gbaCore.reg[1].I, gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source);
     source += 4;
@@ -474,27 +477,27 @@ void BIOS_Div()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("Div: 0x%08x,0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            reg[1].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    int number = reg[0].I;
-    int denom = reg[1].I;
+    int number = gbaCore.reg[0].I;
+    int denom = gbaCore.reg[1].I;
 
     if (denom != 0) {
-        reg[0].I = number / denom;
-        reg[1].I = number % denom;
-        int32_t temp = (int32_t)reg[0].I;
-        reg[3].I = temp < 0 ? (uint32_t)-temp : (uint32_t)temp;
+        gbaCore.reg[0].I = number / denom;
+        gbaCore.reg[1].I = number % denom;
+        int32_t temp = (int32_t)gbaCore.reg[0].I;
+        gbaCore.reg[3].I = temp < 0 ? (uint32_t)-temp : (uint32_t)temp;
     }
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("Div: return=0x%08x,0x%08x,0x%08x\n",
-            reg[0].I,
-            reg[1].I,
-            reg[3].I);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.reg[3].I);
     }
 #endif
 }
@@ -504,14 +507,14 @@ void BIOS_DivARM()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("DivARM: 0x%08x, (VCOUNT=%d)\n",
-            reg[0].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t temp = reg[0].I;
-    reg[0].I = reg[1].I;
-    reg[1].I = temp;
+    uint32_t temp = gbaCore.reg[0].I;
+    gbaCore.reg[0].I = gbaCore.reg[1].I;
+    gbaCore.reg[1].I = temp;
     BIOS_Div();
 }
 
@@ -520,14 +523,14 @@ void BIOS_HuffUnComp()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("HuffUnComp: 0x%08x,0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            reg[1].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source);
     source += 4;
@@ -665,14 +668,14 @@ void BIOS_LZ77UnCompVram()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("LZ77UnCompVram: 0x%08x,0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            reg[1].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source);
     source += 4;
@@ -734,22 +737,22 @@ void BIOS_LZ77UnCompVram()
         }
     }
 
-    reg[0].I = source;
-    reg[1].I = dest;
-    reg[3].I = 0;
+    gbaCore.reg[0].I = source;
+    gbaCore.reg[1].I = dest;
+    gbaCore.reg[3].I = 0;
 }
 
 void BIOS_LZ77UnCompWram()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("LZ77UnCompWram: 0x%08x,0x%08x (VCOUNT=%d)\n", reg[0].I, reg[1].I,
-            VCOUNT);
+        log("LZ77UnCompWram: 0x%08x,0x%08x (VCOUNT=%d)\n", gbaCore.reg[0].I, gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source);
     source += 4;
@@ -788,9 +791,9 @@ void BIOS_LZ77UnCompWram()
         }
     }
 
-    reg[0].I = source;
-    reg[1].I = dest;
-    reg[3].I = 0;
+    gbaCore.reg[0].I = source;
+    gbaCore.reg[1].I = dest;
+    gbaCore.reg[3].I = 0;
 }
 
 void BIOS_ObjAffineSet()
@@ -798,18 +801,18 @@ void BIOS_ObjAffineSet()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("ObjAffineSet: 0x%08x,0x%08x,0x%08x,0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            reg[1].I,
-            reg[2].I,
-            reg[3].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.reg[2].I,
+            gbaCore.reg[3].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t src = reg[0].I;
-    uint32_t dest = reg[1].I;
-    int num = reg[2].I;
-    int offset = reg[3].I;
+    uint32_t src = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
+    int num = gbaCore.reg[2].I;
+    int offset = gbaCore.reg[3].I;
 
     for (int i = 0; i < num; i++) {
         int16_t rx = CPUReadHalfWordSigned(src);
@@ -844,27 +847,30 @@ void BIOS_RegisterRamReset(uint32_t flags)
     // to emulate bios initialization
 
     CPUUpdateRegister(0x0, 0x80);
+    cpuDecodeCacheFlush();
 
     if (flags) {
         if (flags & 0x01) {
             // clear work RAM
-            memset(g_workRAM, 0, SIZE_WRAM);
+            memset(gbaCore.g_workRAM, 0, SIZE_WRAM);
         }
         if (flags & 0x02) {
             // clear internal RAM
-            memset(g_internalRAM, 0, 0x7e00); // don't clear 0x7e00-0x7fff
+            memset(gbaCore.g_internalRAM, 0, 0x7e00); // don't clear 0x7e00-0x7fff
         }
         if (flags & 0x04) {
             // clear palette RAM
-            memset(g_paletteRAM, 0, 0x400);
+            memset(gbaCore.g_paletteRAM, 0, 0x400);
         }
         if (flags & 0x08) {
             // clear VRAM
-            memset(g_vram, 0, 0x18000);
+            memset(gbaCore.g_vram, 0, 0x18000);
+            gfxTileCacheFlush();
         }
         if (flags & 0x10) {
             // clean OAM
-            memset(g_oam, 0, 0x400);
+            memset(gbaCore.g_oam, 0, 0x400);
+            gfxSpriteIndexFlush();
         }
 
         if (flags & 0x80) {
@@ -919,12 +925,12 @@ void BIOS_RegisterRamReset()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("RegisterRamReset: 0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    BIOS_RegisterRamReset(reg[0].I);
+    BIOS_RegisterRamReset(gbaCore.reg[0].I);
 }
 
 void BIOS_RLUnCompVram()
@@ -932,14 +938,14 @@ void BIOS_RLUnCompVram()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("RLUnCompVram: 0x%08x,0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            reg[1].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source & 0xFFFFFFFC);
     source += 4;
@@ -1000,14 +1006,14 @@ void BIOS_RLUnCompWram()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("RLUnCompWram: 0x%08x,0x%08x (VCOUNT=%d)\n",
-            reg[0].I,
-            reg[1].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.VCOUNT);
     }
 #endif
 
-    uint32_t source = reg[0].I;
-    uint32_t dest = reg[1].I;
+    uint32_t source = gbaCore.reg[0].I;
+    uint32_t dest = gbaCore.reg[1].I;
 
     uint32_t header = CPUReadMemory(source & 0xFFFFFFFC);
     source += 4;
@@ -1045,33 +1051,34 @@ void BIOS_SoftReset()
 {
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
-        log("SoftReset: (VCOUNT=%d)\n", VCOUNT);
+        log("SoftReset: (VCOUNT=%d)\n", gbaCore.VCOUNT);
     }
 #endif
 
-    armState = true;
-    armMode = 0x1F;
-    armIrqEnable = false;
-    C_FLAG = V_FLAG = N_FLAG = Z_FLAG = false;
-    reg[13].I = 0x03007F00;
-    reg[14].I = 0x00000000;
-    reg[16].I = 0x00000000;
-    reg[R13_IRQ].I = 0x03007FA0;
-    reg[R14_IRQ].I = 0x00000000;
-    reg[SPSR_IRQ].I = 0x00000000;
-    reg[R13_SVC].I = 0x03007FE0;
-    reg[R14_SVC].I = 0x00000000;
-    reg[SPSR_SVC].I = 0x00000000;
-    uint8_t b = g_internalRAM[0x7ffa];
-
-    memset(&g_internalRAM[0x7e00], 0, 0x200);
+    gbaCore.armState = true;
+    gbaCore.armMode = 0x1F;
+    gbaCore.armIrqEnable = false;
+    gbaCore.C_FLAG = gbaCore.V_FLAG = gbaCore.N_FLAG = gbaCore.Z_FLAG = false;
+    gbaCore.reg[13].I = 0x03007F00;
+    gbaCore.reg[14].I = 0x00000000;
+    gbaCore.reg[16].I = 0x00000000;
+    gbaCore.reg[R13_IRQ].I = 0x03007FA0;
+    gbaCore.reg[R14_IRQ].I = 0x00000000;
+    gbaCore.reg[SPSR_IRQ].I = 0x00000000;
+    gbaCore.reg[R13_SVC].I = 0x03007FE0;
+    gbaCore.reg[R14_SVC].I = 0x00000000;
+    gbaCore.reg[SPSR_SVC].I = 0x00000000;
+    uint8_t b = gbaCore.g_internalRAM[0x7ffa];
+
+    memset(&gbaCore.g_internalRAM[0x7e00], 0, 0x200);
+    cpuDecodeCacheFlush();
 
     if (b) {
-        armNextPC = 0x02000000;
-        reg[15].I = 0x02000004;
+        gbaCore.armNextPC = 0x02000000;
+        gbaCore.reg[15].I = 0x02000004;
     } else {
-        armNextPC = 0x08000000;
-        reg[15].I = 0x08000004;
+        gbaCore.armNextPC = 0x08000000;
+        gbaCore.reg[15].I = 0x08000004;
     }
 }
 
@@ -1080,15 +1087,15 @@ void BIOS_Sqrt()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("Sqrt: %08x (VCOUNT=%2d)\n",
-            reg[0].I,
-            VCOUNT);
+            gbaCore.reg[0].I,
+            gbaCore.VCOUNT);
     }
 #endif
-    reg[0].I = (uint32_t)sqrt((double)reg[0].I);
+    gbaCore.reg[0].I = (uint32_t)sqrt((double)gbaCore.reg[0].I);
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("Sqrt: return=%08x\n",
-            reg[0].I);
+            gbaCore.reg[0].I);
     }
 #endif
 }
@@ -1284,15 +1291,15 @@ void BIOS_SndDriverInit() // 0x166a
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("SndDriverInit: WaveData=%08x mk=%08x fp=%08x\n",
-            reg[0].I,
-            reg[1].I,
-            reg[2].I);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.reg[2].I);
     }
 #endif
 
     // 7FC0 + 0x30
     uint32_t const puser1 = 0x3007FF0;
-    uint32_t const user1 = reg[0].I;
+    uint32_t const user1 = gbaCore.reg[0].I;
 
     uint32_t base3 = 0x040000BC;
     //uint32_t base4 = 0x03007FF0;
@@ -1313,7 +1320,7 @@ void BIOS_SndDriverInit() // 0x166a
     CPUWriteMemory(puser1, user1);
 
     uint32_t const r2 = 0x050003EC;
-    uint32_t const sp = reg[13].I; // 0x03003c98;
+    uint32_t const sp = gbaCore.reg[13].I; // 0x03003c98;
     CPUWriteMemory(sp, 0);
     BIOS_SndDriver_b4c(sp, user1, r2);
 
@@ -1334,7 +1341,7 @@ void BIOS_SndDriverInit() // 0x166a
 
 void BIOS_SndDriverMode() //0x179c
 {
-    uint32_t input = reg[0].I;
+    uint32_t input = gbaCore.reg[0].I;
     uint32_t const puser1 = CPUReadMemory(0x3007FF0); // 7FC0 + 0x30
     uint32_t user1 = CPUReadMemory(puser1);
 
@@ -1609,7 +1616,7 @@ void BIOS_SndDriverMain() // 0x1dc4 -> 0x08004024 phantasy star
                 } else {
                     r2 = user0; //0x2054
                     if (r2) {
-                        r3 = CPUReadMemory(reg[13].I + 0xC); // @todo stack pull 0x205c
+                        r3 = CPUReadMemory(gbaCore.reg[13].I + 0xC); // @todo stack pull 0x205c
                     } else {
                         CPUWriteByte(r4, DowncastU8(r2));
                         goto lbl_20e4;
@@ -1686,7 +1693,7 @@ void BIOS_SndDriverVSyncOff() // 0x1878
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("SndDriverVSyncOff: (VCOUNT = %2d)\n",
-            VCOUNT);
+            gbaCore.VCOUNT);
     }
 #endif
 
@@ -1702,7 +1709,7 @@ void BIOS_SndDriverVSyncOff() // 0x1878
 
         uint32_t r1 = puser1 + 0x350;
         uint32_t r2 = 0x05000318;
-        uint32_t sp = reg[13].I; //0x03003c94;
+        uint32_t sp = gbaCore.reg[13].I; //0x03003c94;
 
         CPUWriteMemory(sp, 0);
         BIOS_SndDriver_b4c(sp, r1, r2);
@@ -1718,7 +1725,7 @@ void BIOS_SndDriverVSyncOn()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("SndDriverVSyncOn: (VCOUNT = %2d)\n",
-            VCOUNT);
+            gbaCore.VCOUNT);
     }
 #endif
 
@@ -1745,28 +1752,28 @@ void BIOS_SndChannelClear() //0x1824
             puser2 += 0x40;
         }
 
-        reg[4].I = CPUReadMemory(puser1 + 0x1c); //r5 -> some user thing
-        if (reg[4].I != 0) {
-            reg[3].I = 1; // r4 -> channel counter?
+        gbaCore.reg[4].I = CPUReadMemory(puser1 + 0x1c); //r5 -> some user thing
+        if (gbaCore.reg[4].I != 0) {
+            gbaCore.reg[3].I = 1; // r4 -> channel counter?
             int puser4 = puser1 + 0x2c;
             //reg[0].I = reg[3].I = 1; // r0 & r4 => 1
 
-            while (reg[3].I <= 4) {
+            while (gbaCore.reg[3].I <= 4) {
                 // @todo does user func modify these?
-                reg[0].I = reg[3].I << 24;
-                reg[0].I >>= 24;
+                gbaCore.reg[0].I = gbaCore.reg[3].I << 24;
+                gbaCore.reg[0].I >>= 24;
 
                 // Get ptr to user func
-                reg[1].I = CPUReadMemory(puser4);
+                gbaCore.reg[1].I = CPUReadMemory(puser4);
 
                 // @todo here we jump where r1 points; user func?
                 // @todo might modify r6 also?
 
                 // After call routines
-                reg[3].I += 1; // r4 -> channel counter?
-                reg[4].I += 0x40; // r5 -> some user thing
+                gbaCore.reg[3].I += 1; // r4 -> channel counter?
+                gbaCore.reg[4].I += 0x40; // r5 -> some user thing
             }
-            CPUWriteByte(reg[4].I, 0); // terminating record?
+            CPUWriteByte(gbaCore.reg[4].I, 0); // terminating record?
         }
         CPUWriteMemory(puser1, 0x68736D53);
     }
@@ -1777,21 +1784,21 @@ void BIOS_MidiKey2Freq()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("MidiKey2Freq: WaveData=%08x mk=%08x fp=%08x\n",
-            reg[0].I,
-            reg[1].I,
-            reg[2].I);
+            gbaCore.reg[0].I,
+            gbaCore.reg[1].I,
+            gbaCore.reg[2].I);
     }
 #endif
-    int freq = CPUReadMemory(reg[0].I + 4);
+    int freq = CPUReadMemory(gbaCore.reg[0].I + 4);
     double tmp;
-    tmp = ((double)(180 - reg[1].I)) - ((double)reg[2].I / 256.f);
+    tmp = ((double)(180 - gbaCore.reg[1].I)) - ((double)gbaCore.reg[2].I / 256.f);
     tmp = pow((double)2.f, tmp / 12.f);
-    reg[0].I = (int)((double)freq / tmp);
+    gbaCore.reg[0].I = (int)((double)freq / tmp);
 
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("MidiKey2Freq: return %08x\n",
-            reg[0].I);
+            gbaCore.reg[0].I);
     }
 #endif
 }
@@ -1801,11 +1808,11 @@ void BIOS_SndDriverJmpTableCopy()
 #ifdef GBA_LOGGING
     if (systemVerbose & VERBOSE_SWI) {
         log("SndDriverJmpTableCopy: dest=%08x\n",
-            reg[0].I);
+            gbaCore.reg[0].I);
     }
 #endif
     for (int i = 0; i < 0x24; i++) {
-        CPUWriteMemory(reg[0].I, 0x9c);
-        reg[0].I += 4;
+        CPUWriteMemory(gbaCore.reg[0].I, 0x9c);
+        gbaCore.reg[0].I += 4;
     }
 }
@@ -106,6 +106,7 @@ sw, sword, int32_t, int                 --> signed word
 #include <cstring>
 
 #include "core/gba/gba.h"
+#include "core/gba/gbaCore.h"
 #include "core/gba/gbaRemote.h"
 
 #if (defined __WIN32__ || defined _WIN32)
@@ -160,7 +161,7 @@ struct ConditionalBreak* addConditionalBreak(uint32_t address, uint8_t flag)
 {
     uint8_t condIndex = address >> 24;
     struct ConditionalBreak* cond = NULL;
-    BreakSet((&map[condIndex])->breakPoints, address & (&map[condIndex])->mask, ((flag & 0xf) | (flag >> 4)));
+    BreakSet((&gbaCore.map[condIndex])->breakPoints, address & (&gbaCore.map[condIndex])->mask, ((flag & 0xf) | (flag >> 4)));
     if (flag & 0xf0) {
         struct ConditionalBreak* base = conditionals[condIndex];
         struct ConditionalBreak* prev = conditionals[condIndex];
@@ -409,15 +410,15 @@ void recountFlagsForAddress(uint32_t address)
             if (base->break_address == address) {
                 flags |= base->type_flags;
             } else {
-                BreakClear((&map[address >> 24])->breakPoints, address & (&map[address >> 24])->mask, 0xff);
-                BreakSet((&map[address >> 24])->breakPoints, address & (&map[address >> 24])->mask, ((flags >> 4) | (flags & 0x8)));
+                BreakClear((&gbaCore.map[address >> 24])->breakPoints, address & (&gbaCore.map[address >> 24])->mask, 0xff);
+                BreakSet((&gbaCore.map[address >> 24])->breakPoints, address & (&gbaCore.map[address >> 24])->mask, ((flags >> 4) | (flags & 0x8)));
                 return;
             }
             base = base->next;
         }
     }
-    BreakClear((&map[address >> 24])->breakPoints, address & (&map[address >> 24])->mask, 0xff);
-    BreakSet((&map[address >> 24])->breakPoints, address & (&map[address >> 24])->mask, ((flags >> 4) | (flags & 0x8)));
+    BreakClear((&gbaCore.map[address >> 24])->breakPoints, address & (&gbaCore.map[address >> 24])->mask, 0xff);
+    BreakSet((&gbaCore.map[address >> 24])->breakPoints, address & (&gbaCore.map[address >> 24])->mask, ((flags >> 4) | (flags & 0x8)));
 }
 
 //Removers
@@ -529,7 +530,7 @@ int removeConditionalWithAddress(uint32_t address)
                 curr = curr->next;
             }
         }
-        BreakClear((&map[address >> 24])->breakPoints, address & (&map[address >> 24])->mask, ((flags & 0xf) | (flags >> 4)));
+        BreakClear((&gbaCore.map[address >> 24])->breakPoints, address & (&gbaCore.map[address >> 24])->mask, ((flags & 0xf) | (flags >> 4)));
         return count;
     }
     return -2;
@@ -545,7 +546,7 @@ int removeConditionalWithFlag(uint8_t flag, bool orMode)
             while (curr) {
                 if (((curr->type_flags & flag) == curr->type_flags) || (orMode && (curr->type_flags & flag))) {
                     curr->type_flags &= ~flag;
-                    BreakClear((&map[addrNo])->breakPoints, curr->break_address & (&map[addrNo])->mask, ((flag & 0xf) | (flag >> 4)));
+                    BreakClear((&gbaCore.map[addrNo])->breakPoints, curr->break_address & (&gbaCore.map[addrNo])->mask, ((flag & 0xf) | (flag >> 4)));
                     if (curr->type_flags == 0) {
                         if (base == conditionals[addrNo]) {
                             conditionals[addrNo] = curr->next;
@@ -582,7 +583,7 @@ int removeConditionalWithAddressAndFlag(uint32_t address, uint8_t flag, bool orM
         while (curr && address >= curr->break_address) {
             if ((curr->break_address == address) && (((curr->type_flags & flag) == curr->type_flags) || (orMode && (curr->type_flags & flag)))) {
                 curr->type_flags &= ~flag;
-                BreakClear((&map[address >> 24])->breakPoints, curr->break_address & (&map[address >> 24])->mask, ((flag & 0xf) | (flag >> 4)));
+                BreakClear((&gbaCore.map[address >> 24])->breakPoints, curr->break_address & (&gbaCore.map[address >> 24])->mask, ((flag & 0xf) | (flag >> 4)));
                 if (curr->type_flags == 0) {
                     if (curr == conditionals[addrNo]) {
                         conditionals[addrNo] = curr->next;
@@ -8,12 +8,12 @@
 #include <cstdint>
 
 #define readWord(addr) \
-    ((map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]) + ((map[(addr + 1) >> 24].address[(addr + 1) & map[(addr + 1) >> 24].mask]) << 8) + ((map[(addr + 2) >> 24].address[(addr + 2) & map[(addr + 2) >> 24].mask]) << 16) + ((map[(addr + 3) >> 24].address[(addr + 3) & map[(addr + 3) >> 24].mask]) << 24))
+    ((gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]) + ((gbaCore.map[(addr + 1) >> 24].address[(addr + 1) & gbaCore.map[(addr + 1) >> 24].mask]) << 8) + ((gbaCore.map[(addr + 2) >> 24].address[(addr + 2) & gbaCore.map[(addr + 2) >> 24].mask]) << 16) + ((gbaCore.map[(addr + 3) >> 24].address[(addr + 3) & gbaCore.map[(addr + 3) >> 24].mask]) << 24))
 
 #define readHalfWord(addr) \
-    ((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]) + ((&map[(addr + 1) >> 24].address[(addr + 1) & map[(addr + 1) >> 24].mask]) << 8))
+    ((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]) + ((&gbaCore.map[(addr + 1) >> 24].address[(addr + 1) & gbaCore.map[(addr + 1) >> 24].mask]) << 8))
 
-#define readByte(addr) map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]
+#define readByte(addr) gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]
 
 struct ConditionalBreakNode {
     char* address;
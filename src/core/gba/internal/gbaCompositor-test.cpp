@@ -0,0 +1,152 @@
+#include "core/gba/internal/gbaCompositor.h"
+
+#include <cstring>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "core/base/cpu_features.h"
+
+namespace {
+
+constexpr uint8_t kModeLayers[] = { 0x0F, 0x07, 0x0C, 0x04 };
+
+template <uint8_t layers>
+void compositeScalar(const GfxCompositeState& state)
+{
+    static constexpr GfxCompositeLineFunc kFuncs[8] = {
+        gfxCompositeLineScalar<layers, false, false, false>,
+        gfxCompositeLineScalar<layers, false, false, true>,
+        gfxCompositeLineScalar<layers, false, true, false>,
+        gfxCompositeLineScalar<layers, false, true, true>,
+        gfxCompositeLineScalar<layers, true, false, false>,
+        gfxCompositeLineScalar<layers, true, false, true>,
+        gfxCompositeLineScalar<layers, true, true, false>,
+        gfxCompositeLineScalar<layers, true, true, true>,
+    };
+    kFuncs[state.fx * 4 + state.window * 2 + state.objWindow](state);
+}
+
+void compositeScalar(const GfxCompositeState& state)
+{
+    switch (state.layers) {
+    case 0x0F:
+        compositeScalar<0x0F>(state);
+        break;
+    case 0x07:
+        compositeScalar<0x07>(state);
+        break;
+    case 0x0C:
+        compositeScalar<0x0C>(state);
+        break;
+    case 0x04:
+        compositeScalar<0x04>(state);
+        break;
+    }
+}
+
+class GbaCompositorTest : public ::testing::Test {
+protected:
+    // Background pixels never have the semi-transparency bit, OBJ pixels may
+    // have it, and both use 0x80 in the priority byte when transparent.
+    uint32_t RandomPixel(bool obj)
+    {
+        static constexpr uint8_t kBgPriorities[] = { 0x01, 0x03, 0x05, 0x07, 0x80 };
+        static constexpr uint8_t kObjPriorities[] = { 0x00, 0x02, 0x04, 0x06, 0x80 };
+
+        uint32_t pixel = Random(0xFFFF);
+        if (obj) {
+            pixel |= (uint32_t)kObjPriorities[Random(4)] << 24;
+            pixel |= Random(3) << 16;
+        } else {
+            pixel |= (uint32_t)kBgPriorities[Random(4)] << 24;
+        }
+        return pixel;
+    }
+
+    GfxCompositeState RandomLine()
+    {
+        for (int x = 0; x < 240; x++) {
+            gbaCore.g_line0[x] = RandomPixel(false);
+            gbaCore.g_line1[x] = RandomPixel(false);
+            gbaCore.g_line2[x] = RandomPixel(false);
+            gbaCore.g_line3[x] = RandomPixel(false);
+            gbaCore.g_lineOBJ[x] = RandomPixel(true);
+            gbaCore.g_lineOBJWin[x] = Random(1) ? 0x80000000 : 0;
+            gbaCore.gfxInWin0[x] = Random(1);
+            gbaCore.gfxInWin1[x] = Random(1);
+        }
+        memset(gbaCore.g_lineMix, 0, sizeof(gbaCore.g_lineMix));
+
+        GfxCompositeState state;
+        state.layers = kModeLayers[Random(3)];
+        state.fx = Random(1);
+        state.window = Random(1);
+        state.objWindow = Random(1);
+        state.inWindow0 = Random(1);
+        state.inWindow1 = Random(1);
+        state.inWin0Mask = Random(0x3F);
+        state.inWin1Mask = Random(0x3F);
+        state.outMask = Random(0x3F);
+        state.objWinMask = Random(0x3F);
+        state.backdrop = 0x30000000 | Random(0xFFFF);
+        state.bldmod = Random(0xFFFF);
+        state.effect = Random(3);
+        state.ca = Random(16);
+        state.cb = Random(16);
+        state.cy = Random(16);
+        return state;
+    }
+
+    void ExpectMatchesScalar(GfxCompositeLineFunc kernel)
+    {
+        for (int i = 0; i < 20000; i++) {
+            const GfxCompositeState state = RandomLine();
+
+            compositeScalar(state);
+            uint32_t expected[240];
+            memcpy(expected, gbaCore.g_lineMix, sizeof(expected));
+
+            memset(gbaCore.g_lineMix, 0, sizeof(gbaCore.g_lineMix));
+            kernel(state);
+
+            for (int x = 0; x < 240; x++) {
+                ASSERT_EQ(gbaCore.g_lineMix[x], expected[x]) << "line " << i << " pixel " << x;
+            }
+        }
+    }
+
+private:
+    uint32_t Random(uint32_t max)
+    {
+        return std::uniform_int_distribution<uint32_t>(0, max)(rng_);
+    }
+
+    std::mt19937 rng_{ 240 };
+};
+
+#if defined(VBAM_GFX_COMPOSITOR_SSE2)
+TEST_F(GbaCompositorTest, Sse2MatchesScalar)
+{
+    ExpectMatchesScalar(gfxCompositeLineSse2);
+}
+#endif
+
+#if defined(VBAM_GFX_COMPOSITOR_AVX2)
+TEST_F(GbaCompositorTest, Avx2MatchesScalar)
+{
+    if (!cpuHasAvx2()) {
+        GTEST_SKIP() << "AVX2 is not supported by this CPU";
+    }
+    ExpectMatchesScalar(gfxCompositeLineAvx2);
+}
+#endif
+
+#if defined(VBAM_GFX_COMPOSITOR_NEON)
+TEST_F(GbaCompositorTest, NeonMatchesScalar)
+{
+    ExpectMatchesScalar(gfxCompositeLineNeon);
+}
+#endif
+
+}  // namespace
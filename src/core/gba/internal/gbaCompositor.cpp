@@ -0,0 +1,177 @@
+#include "core/gba/internal/gbaCompositor.h"
+
+#include <cstring>
+
+#include "core/base/cpu_features.h"
+
+#if defined(VBAM_GFX_COMPOSITOR_SSE2)
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif  // defined(VBAM_GFX_COMPOSITOR_SSE2)
+
+#if defined(VBAM_GFX_COMPOSITOR_NEON)
+#include <arm_neon.h>
+#endif  // defined(VBAM_GFX_COMPOSITOR_NEON)
+
+#if defined(VBAM_GFX_COMPOSITOR_SSE2)
+
+namespace sse2 {
+
+struct V {
+    typedef __m128i T;
+    static constexpr int kLanes = 4;
+
+    static inline T load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static inline void store(uint32_t* p, T a) { _mm_storeu_si128((__m128i*)p, a); }
+    static inline T set1(uint32_t v) { return _mm_set1_epi32((int)v); }
+    static inline T loadFlags(const bool* p)
+    {
+        int flags;
+        memcpy(&flags, p, sizeof(flags));
+        const __m128i zero = _mm_setzero_si128();
+        __m128i a = _mm_unpacklo_epi8(_mm_cvtsi32_si128(flags), zero);
+        return _mm_cmpgt_epi32(_mm_unpacklo_epi16(a, zero), zero);
+    }
+    static inline T and_(T a, T b) { return _mm_and_si128(a, b); }
+    static inline T or_(T a, T b) { return _mm_or_si128(a, b); }
+    static inline T andNot(T a, T b) { return _mm_andnot_si128(b, a); }
+    static inline T add(T a, T b) { return _mm_add_epi32(a, b); }
+    static inline T sub(T a, T b) { return _mm_sub_epi32(a, b); }
+    static inline T mul(T a, T b) { return _mm_mullo_epi16(a, b); }
+    template <int n>
+    static inline T srl(T a) { return _mm_srli_epi32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return _mm_slli_epi32(a, n); }
+    static inline T cmpGt(T a, T b) { return _mm_cmpgt_epi32(a, b); }
+    static inline T cmpEq(T a, T b) { return _mm_cmpeq_epi32(a, b); }
+    static inline T select(T m, T a, T b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static inline bool any(T m) { return _mm_movemask_epi8(m) != 0; }
+};
+
+#include "core/gba/internal/gbaCompositorKernel.h"
+
+}  // namespace sse2
+
+void gfxCompositeLineSse2(const GfxCompositeState& state)
+{
+    sse2::compositeLine(state);
+}
+
+#endif  // defined(VBAM_GFX_COMPOSITOR_SSE2)
+
+#if defined(VBAM_GFX_COMPOSITOR_AVX2)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+
+struct V {
+    typedef __m256i T;
+    static constexpr int kLanes = 8;
+
+    static inline T load(const uint32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static inline void store(uint32_t* p, T a) { _mm256_storeu_si256((__m256i*)p, a); }
+    static inline T set1(uint32_t v) { return _mm256_set1_epi32((int)v); }
+    static inline T loadFlags(const bool* p)
+    {
+        __m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p));
+        return _mm256_cmpgt_epi32(a, _mm256_setzero_si256());
+    }
+    static inline T and_(T a, T b) { return _mm256_and_si256(a, b); }
+    static inline T or_(T a, T b) { return _mm256_or_si256(a, b); }
+    static inline T andNot(T a, T b) { return _mm256_andnot_si256(b, a); }
+    static inline T add(T a, T b) { return _mm256_add_epi32(a, b); }
+    static inline T sub(T a, T b) { return _mm256_sub_epi32(a, b); }
+    static inline T mul(T a, T b) { return _mm256_mullo_epi16(a, b); }
+    template <int n>
+    static inline T srl(T a) { return _mm256_srli_epi32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return _mm256_slli_epi32(a, n); }
+    static inline T cmpGt(T a, T b) { return _mm256_cmpgt_epi32(a, b); }
+    static inline T cmpEq(T a, T b) { return _mm256_cmpeq_epi32(a, b); }
+    static inline T select(T m, T a, T b) { return _mm256_blendv_epi8(b, a, m); }
+    static inline bool any(T m) { return !_mm256_testz_si256(m, m); }
+};
+
+#include "core/gba/internal/gbaCompositorKernel.h"
+
+}  // namespace avx2
+
+void gfxCompositeLineAvx2(const GfxCompositeState& state)
+{
+    avx2::compositeLine(state);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif  // defined(VBAM_GFX_COMPOSITOR_AVX2)
+
+#if defined(VBAM_GFX_COMPOSITOR_NEON)
+
+namespace neon {
+
+struct V {
+    typedef uint32x4_t T;
+    static constexpr int kLanes = 4;
+
+    static inline T load(const uint32_t* p) { return vld1q_u32(p); }
+    static inline void store(uint32_t* p, T a) { vst1q_u32(p, a); }
+    static inline T set1(uint32_t v) { return vdupq_n_u32(v); }
+    static inline T loadFlags(const bool* p)
+    {
+        uint32_t flags;
+        memcpy(&flags, p, sizeof(flags));
+        uint16x8_t a = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(flags)));
+        uint32x4_t b = vmovl_u16(vget_low_u16(a));
+        return vtstq_u32(b, b);
+    }
+    static inline T and_(T a, T b) { return vandq_u32(a, b); }
+    static inline T or_(T a, T b) { return vorrq_u32(a, b); }
+    static inline T andNot(T a, T b) { return vbicq_u32(a, b); }
+    static inline T add(T a, T b) { return vaddq_u32(a, b); }
+    static inline T sub(T a, T b) { return vsubq_u32(a, b); }
+    static inline T mul(T a, T b) { return vmulq_u32(a, b); }
+    template <int n>
+    static inline T srl(T a) { return vshrq_n_u32(a, n); }
+    template <int n>
+    static inline T sll(T a) { return vshlq_n_u32(a, n); }
+    static inline T cmpGt(T a, T b) { return vcgtq_s32(vreinterpretq_s32_u32(a), vreinterpretq_s32_u32(b)); }
+    static inline T cmpEq(T a, T b) { return vceqq_u32(a, b); }
+    static inline T select(T m, T a, T b) { return vbslq_u32(m, a, b); }
+    static inline bool any(T m) { return vmaxvq_u32(m) != 0; }
+};
+
+#include "core/gba/internal/gbaCompositorKernel.h"
+
+}  // namespace neon
+
+void gfxCompositeLineNeon(const GfxCompositeState& state)
+{
+    neon::compositeLine(state);
+}
+
+#endif  // defined(VBAM_GFX_COMPOSITOR_NEON)
+
+GfxCompositeLineFunc gfxCompositeLineKernel()
+{
+#if defined(VBAM_GFX_COMPOSITOR_AVX2)
+    if (cpuHasAvx2())
+        return gfxCompositeLineAvx2;
+#endif
+#if defined(VBAM_GFX_COMPOSITOR_SSE2)
+    return gfxCompositeLineSse2;
+#elif defined(VBAM_GFX_COMPOSITOR_NEON)
+    return gfxCompositeLineNeon;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,218 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBACOMPOSITOR_H_
+#define VBAM_CORE_GBA_INTERNAL_GBACOMPOSITOR_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaGfx.h"
+
+// Layer compositor for the GBA scanline renderers.
+//
+// Once the background and OBJ layers of a line are drawn in g_line0-3 and
+// g_lineOBJ, every pixel picks the visible layer with the lowest priority
+// byte, applies the window masks and the colour special effects and writes
+// the result to g_lineMix.
+//
+// gfxCompositeLineScalar() is the reference implementation. The vector
+// kernels in gbaCompositor.cpp process several pixels at once and must give
+// bit-identical results, including the unused upper bits of g_lineMix.
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VBAM_GFX_COMPOSITOR_SSE2
+#define VBAM_GFX_COMPOSITOR_AVX2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VBAM_GFX_COMPOSITOR_NEON
+#endif
+
+struct GfxCompositeState {
+    // BG layers shown by the display mode, BG0 in bit 0.
+    uint8_t layers;
+    // BLDMOD colour special effects, WIN0/WIN1 and OBJ window in use.
+    bool fx;
+    bool window;
+    bool objWindow;
+    // The current line is inside the vertical range of WIN0/WIN1.
+    bool inWindow0;
+    bool inWindow1;
+    // Layer and effect enable masks, in the WININ/WINOUT format.
+    uint8_t inWin0Mask;
+    uint8_t inWin1Mask;
+    uint8_t outMask;
+    uint8_t objWinMask;
+    uint32_t backdrop;
+    uint16_t bldmod;
+    int effect;
+    int ca;
+    int cb;
+    int cy;
+};
+
+typedef void (*GfxCompositeLineFunc)(const GfxCompositeState& state);
+
+// Returns the fastest vector kernel supported by the host CPU, or null if
+// there is none and the scalar compositor must be used.
+GfxCompositeLineFunc gfxCompositeLineKernel();
+
+#if defined(VBAM_GFX_COMPOSITOR_SSE2)
+void gfxCompositeLineSse2(const GfxCompositeState& state);
+#endif
+#if defined(VBAM_GFX_COMPOSITOR_AVX2)
+void gfxCompositeLineAvx2(const GfxCompositeState& state);
+#endif
+#if defined(VBAM_GFX_COMPOSITOR_NEON)
+void gfxCompositeLineNeon(const GfxCompositeState& state);
+#endif
+
+// Only the priority byte takes part in the comparisons below, the colour and
+// the semi-transparency bit of the current winner are ignored.
+static inline bool gfxAbove(uint32_t pixel, uint32_t color)
+{
+    return (uint8_t)(pixel >> 24) < (uint8_t)(color >> 24);
+}
+
+// Without any window every layer is shown, and semi-transparent OBJs are
+// always blended as the hardware ignores the window and effect settings for
+// them.
+template <uint8_t layers, bool fx, bool window, bool objWindow>
+void gfxCompositeLineScalar(const GfxCompositeState& state)
+{
+    const uint32_t backdrop = state.backdrop;
+    const uint16_t bldmod = state.bldmod;
+
+    for (int x = 0; x < 240; x++) {
+        uint32_t color = backdrop;
+        uint8_t top = 0x20;
+        uint8_t mask = state.outMask;
+
+        if (objWindow) {
+            if (!(gbaCore.g_lineOBJWin[x] & 0x80000000))
+                mask = state.objWinMask;
+        }
+
+        if (window) {
+            if (state.inWindow1 && gbaCore.gfxInWin1[x])
+                mask = state.inWin1Mask;
+
+            if (state.inWindow0 && gbaCore.gfxInWin0[x])
+                mask = state.inWin0Mask;
+        }
+
+        if ((layers & 1) && (mask & 1) && gfxAbove(gbaCore.g_line0[x], color)) {
+            color = gbaCore.g_line0[x];
+            top = 0x01;
+        }
+
+        if ((layers & 2) && (mask & 2) && gfxAbove(gbaCore.g_line1[x], color)) {
+            color = gbaCore.g_line1[x];
+            top = 0x02;
+        }
+
+        if ((layers & 4) && (mask & 4) && gfxAbove(gbaCore.g_line2[x], color)) {
+            color = gbaCore.g_line2[x];
+            top = 0x04;
+        }
+
+        if ((layers & 8) && (mask & 8) && gfxAbove(gbaCore.g_line3[x], color)) {
+            color = gbaCore.g_line3[x];
+            top = 0x08;
+        }
+
+        if ((mask & 16) && gfxAbove(gbaCore.g_lineOBJ[x], color)) {
+            color = gbaCore.g_lineOBJ[x];
+            top = 0x10;
+        }
+
+        if (color & 0x00010000) {
+            // semi-transparent OBJ
+            uint32_t back = backdrop;
+            uint8_t top2 = 0x20;
+
+            if ((layers & 1) && (mask & 1) && gfxAbove(gbaCore.g_line0[x], back)) {
+                back = gbaCore.g_line0[x];
+                top2 = 0x01;
+            }
+
+            if ((layers & 2) && (mask & 2) && gfxAbove(gbaCore.g_line1[x], back)) {
+                back = gbaCore.g_line1[x];
+                top2 = 0x02;
+            }
+
+            if ((layers & 4) && (mask & 4) && gfxAbove(gbaCore.g_line2[x], back)) {
+                back = gbaCore.g_line2[x];
+                top2 = 0x04;
+            }
+
+            if ((layers & 8) && (mask & 8) && gfxAbove(gbaCore.g_line3[x], back)) {
+                back = gbaCore.g_line3[x];
+                top2 = 0x08;
+            }
+
+            if (top2 & (bldmod >> 8))
+                color = gfxAlphaBlend(color, back, state.ca, state.cb);
+            else {
+                switch (state.effect) {
+                case 2:
+                    if (bldmod & top)
+                        color = gfxIncreaseBrightness(color, state.cy);
+                    break;
+                case 3:
+                    if (bldmod & top)
+                        color = gfxDecreaseBrightness(color, state.cy);
+                    break;
+                }
+            }
+        } else if (fx && (mask & 32)) {
+            // special FX on in the window
+            switch (state.effect) {
+            case 0:
+                break;
+            case 1: {
+                if (top & bldmod) {
+                    uint32_t back = backdrop;
+                    uint8_t top2 = 0x20;
+
+                    if ((layers & 1) && (mask & 1) && top != 0x01 && gfxAbove(gbaCore.g_line0[x], back)) {
+                        back = gbaCore.g_line0[x];
+                        top2 = 0x01;
+                    }
+
+                    if ((layers & 2) && (mask & 2) && top != 0x02 && gfxAbove(gbaCore.g_line1[x], back)) {
+                        back = gbaCore.g_line1[x];
+                        top2 = 0x02;
+                    }
+
+                    if ((layers & 4) && (mask & 4) && top != 0x04 && gfxAbove(gbaCore.g_line2[x], back)) {
+                        back = gbaCore.g_line2[x];
+                        top2 = 0x04;
+                    }
+
+                    if ((layers & 8) && (mask & 8) && top != 0x08 && gfxAbove(gbaCore.g_line3[x], back)) {
+                        back = gbaCore.g_line3[x];
+                        top2 = 0x08;
+                    }
+
+                    if ((mask & 16) && top != 0x10 && gfxAbove(gbaCore.g_lineOBJ[x], back)) {
+                        back = gbaCore.g_lineOBJ[x];
+                        top2 = 0x10;
+                    }
+
+                    if (top2 & (bldmod >> 8))
+                        color = gfxAlphaBlend(color, back, state.ca, state.cb);
+                }
+            } break;
+            case 2:
+                if (bldmod & top)
+                    color = gfxIncreaseBrightness(color, state.cy);
+                break;
+            case 3:
+                if (bldmod & top)
+                    color = gfxDecreaseBrightness(color, state.cy);
+                break;
+            }
+        }
+
+        gbaCore.g_lineMix[x] = color;
+    }
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBACOMPOSITOR_H_
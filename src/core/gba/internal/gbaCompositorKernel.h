@@ -0,0 +1,211 @@
+// Vector layer compositor, see gbaCompositor.h for what it computes.
+//
+// This file has no include guard: gbaCompositor.cpp includes it once per
+// instruction set, inside a namespace defining the vector type `V`, so that
+// every copy is compiled for its own target. `V` works on 32-bit lanes and
+// provides the operations used below. `V::mul()` is only required to be
+// exact for products below 0x10000.
+
+// Packs 5-bit channels in the layout returned by gfxAlphaBlend() and
+// gfxIncrease/DecreaseBrightness(), which repeat green in bits 21-25.
+inline V::T pack(V::T r, V::T g, V::T b)
+{
+    return V::or_(V::or_(r, V::sll<5>(g)), V::or_(V::sll<10>(b), V::sll<21>(g)));
+}
+
+inline V::T saturate(V::T channel, V::T max)
+{
+    return V::select(V::cmpGt(channel, max), max, channel);
+}
+
+// Pixels of one layer, their priority byte and the lanes where the window
+// shows the layer.
+struct Layer {
+    V::T pixel;
+    V::T prio;
+    V::T shown;
+};
+
+inline Layer loadLayer(const uint32_t* line, V::T mask, V::T bit)
+{
+    Layer layer;
+    layer.pixel = V::load(line);
+    layer.prio = V::srl<24>(layer.pixel);
+    layer.shown = V::cmpEq(V::and_(mask, bit), bit);
+    return layer;
+}
+
+// Moves `layer` on top where it is shown and above the current top pixel.
+inline void pickTop(const Layer& layer, V::T bit, V::T& color, V::T& prio, V::T& top)
+{
+    V::T above = V::and_(layer.shown, V::cmpGt(prio, layer.prio));
+    color = V::select(above, layer.pixel, color);
+    prio = V::select(above, layer.prio, prio);
+    top = V::select(above, bit, top);
+}
+
+// Same for the second layer, skipping the lanes where `layer` is on top.
+inline void pickBack(const Layer& layer, V::T bit, V::T top, V::T& back, V::T& prio, V::T& top2)
+{
+    V::T below = V::andNot(layer.shown, V::cmpEq(top, bit));
+    below = V::and_(below, V::cmpGt(prio, layer.prio));
+    back = V::select(below, layer.pixel, back);
+    prio = V::select(below, layer.prio, prio);
+    top2 = V::select(below, bit, top2);
+}
+
+void compositeLine(const GfxCompositeState& state)
+{
+    const uint32_t* line0 = gbaCore.g_line0;
+    const uint32_t* line1 = gbaCore.g_line1;
+    const uint32_t* line2 = gbaCore.g_line2;
+    const uint32_t* line3 = gbaCore.g_line3;
+    const uint32_t* lineOBJ = gbaCore.g_lineOBJ;
+    const uint32_t* lineOBJWin = gbaCore.g_lineOBJWin;
+    const bool* inWin0 = gbaCore.gfxInWin0;
+    const bool* inWin1 = gbaCore.gfxInWin1;
+    uint32_t* lineMix = gbaCore.g_lineMix;
+
+    const int layers = state.layers;
+    const bool useWin0 = state.window && state.inWindow0;
+    const bool useWin1 = state.window && state.inWindow1;
+    const bool useFx = state.fx && state.effect != 0;
+
+    const V::T zero = V::set1(0);
+    const V::T channelMax = V::set1(0x1F);
+    const V::T opaqueLimit = V::set1(0x80);
+    const V::T semiBit = V::set1(0x00010000);
+    const V::T transparentBit = V::set1(0x80000000);
+    const V::T bit0 = V::set1(0x01);
+    const V::T bit1 = V::set1(0x02);
+    const V::T bit2 = V::set1(0x04);
+    const V::T bit3 = V::set1(0x08);
+    const V::T bitOBJ = V::set1(0x10);
+    const V::T bitFx = V::set1(0x20);
+    const V::T backdrop = V::set1(state.backdrop);
+    const V::T backdropPrio = V::set1(state.backdrop >> 24);
+    const V::T outMask = V::set1(state.outMask);
+    const V::T objWinMask = V::set1(state.objWinMask);
+    const V::T inWin0Mask = V::set1(state.inWin0Mask);
+    const V::T inWin1Mask = V::set1(state.inWin1Mask);
+    const V::T target1 = V::set1(state.bldmod & 0x3F);
+    const V::T target2 = V::set1((state.bldmod >> 8) & 0x3F);
+    const V::T ca = V::set1(state.ca);
+    const V::T cb = V::set1(state.cb);
+    const V::T cy = V::set1(state.cy);
+
+    for (int x = 0; x < 240; x += V::kLanes) {
+        V::T mask = outMask;
+
+        if (state.objWindow) {
+            V::T inObjWin = V::cmpEq(V::and_(V::load(lineOBJWin + x), transparentBit), zero);
+            mask = V::select(inObjWin, objWinMask, mask);
+        }
+
+        if (useWin1)
+            mask = V::select(V::loadFlags(inWin1 + x), inWin1Mask, mask);
+
+        if (useWin0)
+            mask = V::select(V::loadFlags(inWin0 + x), inWin0Mask, mask);
+
+        Layer bg0, bg1, bg2, bg3;
+        V::T color = backdrop;
+        V::T colorPrio = backdropPrio;
+        V::T top = bitFx;
+
+        if (layers & 1) {
+            bg0 = loadLayer(line0 + x, mask, bit0);
+            pickTop(bg0, bit0, color, colorPrio, top);
+        }
+
+        if (layers & 2) {
+            bg1 = loadLayer(line1 + x, mask, bit1);
+            pickTop(bg1, bit1, color, colorPrio, top);
+        }
+
+        if (layers & 4) {
+            bg2 = loadLayer(line2 + x, mask, bit2);
+            pickTop(bg2, bit2, color, colorPrio, top);
+        }
+
+        if (layers & 8) {
+            bg3 = loadLayer(line3 + x, mask, bit3);
+            pickTop(bg3, bit3, color, colorPrio, top);
+        }
+
+        Layer obj = loadLayer(lineOBJ + x, mask, bitOBJ);
+        pickTop(obj, bitOBJ, color, colorPrio, top);
+
+        // Semi-transparent OBJs always blend, other pixels only with the
+        // effect enabled in their window.
+        V::T semi = V::cmpEq(V::and_(color, semiBit), semiBit);
+        V::T fxPixels = zero;
+        if (useFx)
+            fxPixels = V::andNot(V::cmpEq(V::and_(mask, bitFx), bitFx), semi);
+
+        if (!V::any(V::or_(semi, fxPixels))) {
+            V::store(lineMix + x, color);
+            continue;
+        }
+
+        // The layer right below the top one. Semi-transparent pixels always
+        // have the OBJ layer on top, so this only looks at the backgrounds
+        // for them.
+        V::T back = backdrop;
+        V::T backPrio = backdropPrio;
+        V::T top2 = bitFx;
+
+        if (layers & 1)
+            pickBack(bg0, bit0, top, back, backPrio, top2);
+        if (layers & 2)
+            pickBack(bg1, bit1, top, back, backPrio, top2);
+        if (layers & 4)
+            pickBack(bg2, bit2, top, back, backPrio, top2);
+        if (layers & 8)
+            pickBack(bg3, bit3, top, back, backPrio, top2);
+        pickBack(obj, bitOBJ, top, back, backPrio, top2);
+
+        V::T topMiss = V::cmpEq(V::and_(top, target1), zero);
+        V::T top2Miss = V::cmpEq(V::and_(top2, target2), zero);
+
+        V::T blend = V::andNot(semi, top2Miss);
+        if (state.effect == 1)
+            blend = V::or_(blend, V::andNot(V::andNot(fxPixels, topMiss), top2Miss));
+        blend = V::and_(blend, V::cmpGt(opaqueLimit, colorPrio));
+
+        V::T brightness = zero;
+        if (state.effect >= 2)
+            brightness = V::andNot(V::or_(V::and_(semi, top2Miss), fxPixels), topMiss);
+
+        V::T r = V::and_(color, channelMax);
+        V::T g = V::and_(V::srl<5>(color), channelMax);
+        V::T b = V::and_(V::srl<10>(color), channelMax);
+        V::T result = color;
+
+        if (V::any(blend)) {
+            V::T r2 = V::and_(back, channelMax);
+            V::T g2 = V::and_(V::srl<5>(back), channelMax);
+            V::T b2 = V::and_(V::srl<10>(back), channelMax);
+
+            V::T br = saturate(V::srl<4>(V::add(V::mul(r, ca), V::mul(r2, cb))), channelMax);
+            V::T bg = saturate(V::srl<4>(V::add(V::mul(g, ca), V::mul(g2, cb))), channelMax);
+            V::T bb = saturate(V::srl<4>(V::add(V::mul(b, ca), V::mul(b2, cb))), channelMax);
+            result = V::select(blend, pack(br, bg, bb), result);
+        }
+
+        if (V::any(brightness)) {
+            if (state.effect == 2) {
+                r = V::add(r, V::srl<4>(V::mul(V::sub(channelMax, r), cy)));
+                g = V::add(g, V::srl<4>(V::mul(V::sub(channelMax, g), cy)));
+                b = V::add(b, V::srl<4>(V::mul(V::sub(channelMax, b), cy)));
+            } else {
+                r = V::sub(r, V::srl<4>(V::mul(r, cy)));
+                g = V::sub(g, V::srl<4>(V::mul(g, cy)));
+                b = V::sub(b, V::srl<4>(V::mul(b, cy)));
+            }
+            result = V::select(brightness, pack(r, g, b), result);
+        }
+
+        V::store(lineMix + x, result);
+    }
+}
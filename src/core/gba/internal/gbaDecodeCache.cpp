@@ -0,0 +1,9 @@
+#include "core/gba/internal/gbaDecodeCache.h"
+
+#include <cstring>
+
+void cpuDecodeCacheFlush()
+{
+    memset(gbaCore.armDecodeCache, 0xFF, sizeof(gbaCore.armDecodeCache));
+    memset(gbaCore.thumbDecodeCache, 0xFF, sizeof(gbaCore.thumbDecodeCache));
+}
@@ -0,0 +1,93 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBADECODECACHE_H_
+#define VBAM_CORE_GBA_INTERNAL_GBADECODECACHE_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaCpu.h"
+
+// Pre-decoded instruction cache for the ARM and THUMB interpreters.
+//
+// Each entry remembers the opcode found at a given PC together with the
+// handler it decodes to, so that the execution loops can skip both the
+// prefetch memory access and the instruction table lookup for code that was
+// already seen. Only BIOS, ROM and work RAM are cached. The RAM entries are
+// invalidated by CPU writes, and anything that rewrites memory behind the
+// CPU's back (save states, BIOS HLE, cheats, the debugger...) must call
+// cpuDecodeCacheFlush().
+
+#if defined(VBAM_ENABLE_DECODE_CACHE)
+
+// Odd addresses are never fetched, so they mark an empty entry.
+static constexpr uint32_t kDecodeCacheInvalid = 0xFFFFFFFF;
+
+void cpuDecodeCacheFlush();
+
+// Returns true if code fetched from `address` can be kept in the cache.
+// Mirrored RAM addresses are left out so that a write only ever has to
+// invalidate one canonical address.
+inline bool cpuDecodeCacheable(uint32_t address)
+{
+    switch (address >> 24) {
+    case 0x00:
+        return address < 0x4000;
+    case 0x02:
+        return (address & 0x00FC0000) == 0;
+    case 0x03:
+        return (address & 0x00FF8000) == 0;
+    case 0x08:
+    case 0x09:
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline DecodedInsn& armDecodeCacheEntry(uint32_t address)
+{
+    return gbaCore.armDecodeCache[(address >> 2) & (kDecodeCacheSize - 1)];
+}
+
+inline DecodedInsn& thumbDecodeCacheEntry(uint32_t address)
+{
+    return gbaCore.thumbDecodeCache[(address >> 1) & (kDecodeCacheSize - 1)];
+}
+
+// Called on every CPU write, drops the entries covering the written word.
+inline void cpuDecodeCacheInvalidate(uint32_t address)
+{
+    switch (address >> 24) {
+    case 0x02:
+        address &= 0x0203FFFC;
+        break;
+    case 0x03:
+        address &= 0x03007FFC;
+        break;
+    default:
+        return;
+    }
+
+    DecodedInsn& arm = armDecodeCacheEntry(address);
+    if (arm.address == address)
+        arm.address = kDecodeCacheInvalid;
+
+    DecodedInsn& thumbLow = thumbDecodeCacheEntry(address);
+    if (thumbLow.address == address)
+        thumbLow.address = kDecodeCacheInvalid;
+
+    DecodedInsn& thumbHigh = thumbDecodeCacheEntry(address + 2);
+    if (thumbHigh.address == address + 2)
+        thumbHigh.address = kDecodeCacheInvalid;
+}
+
+#else  // !defined(VBAM_ENABLE_DECODE_CACHE)
+
+inline void cpuDecodeCacheFlush() {}
+inline void cpuDecodeCacheInvalidate(uint32_t) {}
+
+#endif  // defined(VBAM_ENABLE_DECODE_CACHE)
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBADECODECACHE_H_
@@ -8,61 +8,14 @@
 #include "core/gba/gba.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaDecodeCache.h"
 
 char US_Ereader[19] = "CARDE READERPSAE01";
 char JAP_Ereader[19] = "CARDE READERPEAJ01";
 char JAP_Ereader_plus[19] = "CARDEREADER+PSAJ01";
-char rom_info[19];
 
 char Signature[0x29] = "E-Reader Dotcode -Created- by CaitSith2";
 
-unsigned char ShortDotCodeHeader[0x30] = {
-    0x00, 0x30, 0x01, 0x01,
-    0x00, 0x01, 0x05, 0x10,
-    0x00, 0x00, 0x10, 0x12, //Constant data
-
-    0x00, 0x00, //Header First 2 bytes
-
-    0x02, 0x00, //Constant data
-
-    0x00, 0x00, //Header Second 2 bytes
-
-    0x10, 0x47, 0xEF, //Global Checksum 1
-
-    0x19, 0x00, 0x00, 0x00, 0x08, 0x4E, 0x49,
-    0x4E, 0x54, 0x45, 0x4E, 0x44, 0x4F, 0x00, 0x22,
-    0x00, 0x09, //Constant data
-
-    0x00, 0x00, //Header, last 8 bytes
-    0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00,
-    0x00, //Header Checksum
-    0x57 //Global Checksum 2
-};
-
-unsigned char LongDotCodeHeader[0x30] = {
-    0x00, 0x30, 0x01, 0x02,
-    0x00, 0x01, 0x08, 0x10,
-    0x00, 0x00, 0x10, 0x12, //Constant Data
-
-    0x00, 0x00, //Header, first 2 bytes
-
-    0x01, 0x00, //Constant data
-
-    0x00, 0x00, //Header, second 2 bytes
-    0x10, 0x9A, 0x99, //Global Checksum 1
-
-    0x19, 0x00, 0x00, 0x00, 0x08, 0x4E, 0x49,
-    0x4E, 0x54, 0x45, 0x4E, 0x44, 0x4F, 0x00, 0x22,
-    0x00, 0x09, //Constant data
-
-    0x00, 0x00, //Header, last 8 bytes
-    0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00,
-    0x00, //Header Checksum
-    0x57 //Global Checksum 2
-};
-
 unsigned char shortheader[0x18] = {
     0x00, 0x02, 0x00, 0x01, 0x40, 0x10, 0x00, 0x1C,
     0x10, 0x6F, 0x40, 0xDA, 0x39, 0x25, 0x8E, 0xE0,
@@ -74,20 +27,6 @@ unsigned char longheader[0x18] = {
     0x43, 0xEE, 0x03, 0xC6, 0xC6, 0x2B, 0x2C, 0x93
 };
 
-unsigned char dotcodeheader[0x48];
-unsigned char dotcodedata[0xB38];
-unsigned char dotcodetemp[0xB00];
-int dotcodepointer;
-int dotcodeinterleave;
-int decodestate;
-
-uint32_t GFpow;
-
-unsigned char* DotCodeData;
-char filebuffer[2048];
-
-int dotcodesize;
-
 #if (defined __WIN32__ || defined _WIN32)
 #define strcasecmp _stricmp
 #endif
@@ -96,14 +35,14 @@ int CheckEReaderRegion(void) //US = 1, JAP = 2, JAP+ = 3
 {
     int i;
     for (i = 0; i < 18; i++)
-        rom_info[i] = g_rom[0xA0 + i];
-    rom_info[i] = 0;
+        gbaCore.rom_info[i] = gbaCore.g_rom[0xA0 + i];
+    gbaCore.rom_info[i] = 0;
 
-    if (!strcasecmp(rom_info, US_Ereader))
+    if (!strcasecmp(gbaCore.rom_info, US_Ereader))
         return 1;
-    if (!strcasecmp(rom_info, JAP_Ereader))
+    if (!strcasecmp(gbaCore.rom_info, JAP_Ereader))
         return 2;
-    if (!strcasecmp(rom_info, JAP_Ereader_plus))
+    if (!strcasecmp(gbaCore.rom_info, JAP_Ereader_plus))
         return 3;
 
     return 0;
@@ -199,15 +138,17 @@ int LoadDotCodeData(int size, uint32_t* DCdata, unsigned long MEM1, unsigned lon
 
 void EReaderWriteMemory(uint32_t address, uint32_t value)
 {
+    cpuDecodeCacheFlush();
+
     switch (address >> 24) {
     case 2:
-        WRITE32LE(((uint32_t*)&g_workRAM[address & 0x3FFFF]), value);
+        WRITE32LE(((uint32_t*)&gbaCore.g_workRAM[address & 0x3FFFF]), value);
         break;
     case 3:
-        WRITE32LE(((uint32_t*)&g_internalRAM[address & 0x7FFF]), value);
+        WRITE32LE(((uint32_t*)&gbaCore.g_internalRAM[address & 0x7FFF]), value);
         break;
     default:
-        WRITE32LE(((uint32_t*)&g_rom[address & 0x1FFFFFF]), value);
+        WRITE32LE(((uint32_t*)&gbaCore.g_rom[address & 0x1FFFFFF]), value);
         //rom[address & 0x1FFFFFF] = data;
         break;
     }
@@ -227,21 +168,21 @@ void BIOS_EReader_ScanCard(int swi_num)
     //Open dotcode bin/raw
 
     if (swi_num == 0xE0) {
-        dotcodepointer = 0;
-        dotcodeinterleave = 0;
-        decodestate = 0;
+        gbaCore.dotcodepointer = 0;
+        gbaCore.dotcodeinterleave = 0;
+        gbaCore.decodestate = 0;
 
         const char* loadDotCodeFile = GetLoadDotCodeFile();
 
         if (!*loadDotCodeFile) {
-            reg[0].I = 0x301;
+            gbaCore.reg[0].I = 0x301;
             return;
         }
         f = utilOpenFile(loadDotCodeFile, "rb");
         //f=utilOpenFile(filebuffer,"rb");
         //f=utilOpenFile("dotcode4.raw","rb");
         if (f == NULL) {
-            reg[0].I = 0x303;
+            gbaCore.reg[0].I = 0x303;
             return;
         }
         fseek(f, 0, SEEK_END);
@@ -253,58 +194,58 @@ void BIOS_EReader_ScanCard(int swi_num)
             dotcodetype = 1;
         } else {
             fclose(f);
-            reg[0].I = 0x303;
+            gbaCore.reg[0].I = 0x303;
             return;
         }
-        DotCodeData = (unsigned char*)malloc(i);
-        if (DotCodeData == NULL) {
-            reg[0].I = 0x303;
+        gbaCore.DotCodeData = (unsigned char*)malloc(i);
+        if (gbaCore.DotCodeData == NULL) {
+            gbaCore.reg[0].I = 0x303;
             return;
         }
-        FREAD_UNCHECKED(DotCodeData, 1, i, f);
+        FREAD_UNCHECKED(gbaCore.DotCodeData, 1, i, f);
         fclose(f);
 
         if (dotcodetype == 0) {
 
             switch (CheckEReaderRegion()) {
             case 1: //US
-                LoadDotCodeData(i, (uint32_t*)DotCodeData, 0x2032D14, 0x2028B28, 1);
+                LoadDotCodeData(i, (uint32_t*)gbaCore.DotCodeData, 0x2032D14, 0x2028B28, 1);
                 EReaderWriteMemory(0x80091BA, 0x46C0DFE2);
                 break;
             case 2:
-                LoadDotCodeData(i, (uint32_t*)DotCodeData, 0x2006EC4, 0x2002478, 1);
+                LoadDotCodeData(i, (uint32_t*)gbaCore.DotCodeData, 0x2006EC4, 0x2002478, 1);
                 EReaderWriteMemory(0x8008B12, 0x46C0DFE2);
                 break;
             case 3:
-                LoadDotCodeData(i, (uint32_t*)DotCodeData, 0x202F8A4, 0x2031034, 1);
+                LoadDotCodeData(i, (uint32_t*)gbaCore.DotCodeData, 0x202F8A4, 0x2031034, 1);
                 EReaderWriteMemory(0x800922E, 0x46C0DFE2);
                 break;
             }
-            reg[0].I = 0;
-            free(DotCodeData);
+            gbaCore.reg[0].I = 0;
+            free(gbaCore.DotCodeData);
         } else {
             //dotcodesize = i;
             if (i == 0x81C)
-                dotcodesize = 0xB60;
+                gbaCore.dotcodesize = 0xB60;
             else
-                dotcodesize = 0x750;
+                gbaCore.dotcodesize = 0x750;
 
             switch (CheckEReaderRegion()) {
             case 1: //US
-                LoadDotCodeData(dotcodesize, (uint32_t*)NULL, 0x2032D14, 0x2028B28, 0);
+                LoadDotCodeData(gbaCore.dotcodesize, (uint32_t*)NULL, 0x2032D14, 0x2028B28, 0);
                 EReaderWriteMemory(0x80091BA, 0x46C0DFE1);
                 break;
             case 2:
-                LoadDotCodeData(dotcodesize, (uint32_t*)NULL, 0x2006EC4, 0x2002478, 0);
+                LoadDotCodeData(gbaCore.dotcodesize, (uint32_t*)NULL, 0x2006EC4, 0x2002478, 0);
                 EReaderWriteMemory(0x8008B12, 0x46C0DFE1);
                 break;
             case 3:
-                LoadDotCodeData(dotcodesize, (uint32_t*)NULL, 0x202F8A4, 0x2031034, 0);
+                LoadDotCodeData(gbaCore.dotcodesize, (uint32_t*)NULL, 0x202F8A4, 0x2031034, 0);
                 EReaderWriteMemory(0x800922E, 0x46C0DFE1);
                 break;
             }
-            reg[0].I = 0;
-            dotcodesize = i;
+            gbaCore.reg[0].I = 0;
+            gbaCore.dotcodesize = i;
         }
     } else if (swi_num == 0xE1) {
 
@@ -314,120 +255,120 @@ void BIOS_EReader_ScanCard(int swi_num)
             EReaderWriteMemory(0x3002F7C, 0xEFE40000); //Beginning of Reed-Solomon decoder
             EReaderWriteMemory(0x3003144, 0xCA00002F); //Fix required to Correct 16 "Erasures"
             EReaderWriteMemory(0x300338C, 0xEFE50000); //End of Reed-Solomon decoder
-            GFpow = 0x3000A6C;
+            gbaCore.GFpow = 0x3000A6C;
             break;
         case 2:
             EReaderWriteMemory(0x8008B12, 0xFB0BF035);
             EReaderWriteMemory(0x3002F88, 0xEFE40000);
             EReaderWriteMemory(0x3003150, 0xCA00002F);
             EReaderWriteMemory(0x3003398, 0xEFE50000);
-            GFpow = 0x3000A78;
+            gbaCore.GFpow = 0x3000A78;
             break;
         case 3:
             EReaderWriteMemory(0x800922E, 0xF94BF04B);
             EReaderWriteMemory(0x3002F7C, 0xEFE40000);
             EReaderWriteMemory(0x3003144, 0xCA00002F);
             EReaderWriteMemory(0x300338C, 0xEFE50000);
-            GFpow = 0x3000A6C;
+            gbaCore.GFpow = 0x3000A6C;
             break;
         }
 
-        armNextPC -= 2;
-        reg[15].I -= 2;
-        if (armState)
+        gbaCore.armNextPC -= 2;
+        gbaCore.reg[15].I -= 2;
+        if (gbaCore.armState)
             ARM_PREFETCH
         else
             THUMB_PREFETCH
 
         for (i = 0, j = 0; i < 12; i++)
-            j ^= DotCodeData[i];
-        if (dotcodesize == 0x81C) {
-            LongDotCodeHeader[0x2E] = j;
-            LongDotCodeHeader[0x0D] = DotCodeData[0];
-            LongDotCodeHeader[0x0C] = DotCodeData[1];
-            LongDotCodeHeader[0x11] = DotCodeData[2];
-            LongDotCodeHeader[0x10] = DotCodeData[3];
-
-            LongDotCodeHeader[0x26] = DotCodeData[4];
-            LongDotCodeHeader[0x27] = DotCodeData[5];
-            LongDotCodeHeader[0x28] = DotCodeData[6];
-            LongDotCodeHeader[0x29] = DotCodeData[7];
-            LongDotCodeHeader[0x2A] = DotCodeData[8];
-            LongDotCodeHeader[0x2B] = DotCodeData[9];
-            LongDotCodeHeader[0x2C] = DotCodeData[10];
-            LongDotCodeHeader[0x2D] = DotCodeData[11];
-
-            LongDotCodeHeader[0x12] = 0x10; //calculate Global Checksum 1
-            LongDotCodeHeader[0x02] = 1; //Do not calculate Global Checksum 2
+            j ^= gbaCore.DotCodeData[i];
+        if (gbaCore.dotcodesize == 0x81C) {
+            gbaCore.LongDotCodeHeader[0x2E] = j;
+            gbaCore.LongDotCodeHeader[0x0D] = gbaCore.DotCodeData[0];
+            gbaCore.LongDotCodeHeader[0x0C] = gbaCore.DotCodeData[1];
+            gbaCore.LongDotCodeHeader[0x11] = gbaCore.DotCodeData[2];
+            gbaCore.LongDotCodeHeader[0x10] = gbaCore.DotCodeData[3];
+
+            gbaCore.LongDotCodeHeader[0x26] = gbaCore.DotCodeData[4];
+            gbaCore.LongDotCodeHeader[0x27] = gbaCore.DotCodeData[5];
+            gbaCore.LongDotCodeHeader[0x28] = gbaCore.DotCodeData[6];
+            gbaCore.LongDotCodeHeader[0x29] = gbaCore.DotCodeData[7];
+            gbaCore.LongDotCodeHeader[0x2A] = gbaCore.DotCodeData[8];
+            gbaCore.LongDotCodeHeader[0x2B] = gbaCore.DotCodeData[9];
+            gbaCore.LongDotCodeHeader[0x2C] = gbaCore.DotCodeData[10];
+            gbaCore.LongDotCodeHeader[0x2D] = gbaCore.DotCodeData[11];
+
+            gbaCore.LongDotCodeHeader[0x12] = 0x10; //calculate Global Checksum 1
+            gbaCore.LongDotCodeHeader[0x02] = 1; //Do not calculate Global Checksum 2
 
             for (i = 0x0C, j = 0; i < 0x81C; i++) {
                 if (i & 1)
-                    j += DotCodeData[i];
+                    j += gbaCore.DotCodeData[i];
                 else
-                    j += (DotCodeData[i] << 8);
+                    j += (gbaCore.DotCodeData[i] << 8);
             }
             j &= 0xFFFF;
             j ^= 0xFFFF;
-            LongDotCodeHeader[0x13] = (j & 0xFF00) >> 8;
-            LongDotCodeHeader[0x14] = (j & 0x00FF);
+            gbaCore.LongDotCodeHeader[0x13] = (j & 0xFF00) >> 8;
+            gbaCore.LongDotCodeHeader[0x14] = (j & 0x00FF);
 
             for (i = 0, j = 0; i < 0x2F; i++)
-                j += LongDotCodeHeader[i];
+                j += gbaCore.LongDotCodeHeader[i];
             j &= 0xFF;
             for (i = 1, global2 = 0; i < 0x2C; i++) {
                 for (k = 0, global1 = 0; k < 0x30; k++) {
-                    global1 ^= DotCodeData[((i - 1) * 0x30) + k + 0x0C];
+                    global1 ^= gbaCore.DotCodeData[((i - 1) * 0x30) + k + 0x0C];
                 }
                 global2 += global1;
             }
             global2 += j;
             global2 &= 0xFF;
             global2 ^= 0xFF;
-            LongDotCodeHeader[0x2F] = global2;
+            gbaCore.LongDotCodeHeader[0x2F] = global2;
 
         } else {
-            ShortDotCodeHeader[0x2E] = j;
-            ShortDotCodeHeader[0x0D] = DotCodeData[0];
-            ShortDotCodeHeader[0x0C] = DotCodeData[1];
-            ShortDotCodeHeader[0x11] = DotCodeData[2];
-            ShortDotCodeHeader[0x10] = DotCodeData[3];
-
-            ShortDotCodeHeader[0x26] = DotCodeData[4];
-            ShortDotCodeHeader[0x27] = DotCodeData[5];
-            ShortDotCodeHeader[0x28] = DotCodeData[6];
-            ShortDotCodeHeader[0x29] = DotCodeData[7];
-            ShortDotCodeHeader[0x2A] = DotCodeData[8];
-            ShortDotCodeHeader[0x2B] = DotCodeData[9];
-            ShortDotCodeHeader[0x2C] = DotCodeData[10];
-            ShortDotCodeHeader[0x2D] = DotCodeData[11];
-
-            ShortDotCodeHeader[0x12] = 0x10; //calculate Global Checksum 1
-            ShortDotCodeHeader[0x02] = 1; //Do not calculate Global Checksum 2
+            gbaCore.ShortDotCodeHeader[0x2E] = j;
+            gbaCore.ShortDotCodeHeader[0x0D] = gbaCore.DotCodeData[0];
+            gbaCore.ShortDotCodeHeader[0x0C] = gbaCore.DotCodeData[1];
+            gbaCore.ShortDotCodeHeader[0x11] = gbaCore.DotCodeData[2];
+            gbaCore.ShortDotCodeHeader[0x10] = gbaCore.DotCodeData[3];
+
+            gbaCore.ShortDotCodeHeader[0x26] = gbaCore.DotCodeData[4];
+            gbaCore.ShortDotCodeHeader[0x27] = gbaCore.DotCodeData[5];
+            gbaCore.ShortDotCodeHeader[0x28] = gbaCore.DotCodeData[6];
+            gbaCore.ShortDotCodeHeader[0x29] = gbaCore.DotCodeData[7];
+            gbaCore.ShortDotCodeHeader[0x2A] = gbaCore.DotCodeData[8];
+            gbaCore.ShortDotCodeHeader[0x2B] = gbaCore.DotCodeData[9];
+            gbaCore.ShortDotCodeHeader[0x2C] = gbaCore.DotCodeData[10];
+            gbaCore.ShortDotCodeHeader[0x2D] = gbaCore.DotCodeData[11];
+
+            gbaCore.ShortDotCodeHeader[0x12] = 0x10; //calculate Global Checksum 1
+            gbaCore.ShortDotCodeHeader[0x02] = 1; //Do not calculate Global Checksum 2
 
             for (i = 0x0C, j = 0; i < 0x51C; i++) {
                 if (i & 1)
-                    j += DotCodeData[i];
+                    j += gbaCore.DotCodeData[i];
                 else
-                    j += (DotCodeData[i] << 8);
+                    j += (gbaCore.DotCodeData[i] << 8);
             }
             j &= 0xFFFF;
             j ^= 0xFFFF;
-            ShortDotCodeHeader[0x13] = (j & 0xFF00) >> 8;
-            ShortDotCodeHeader[0x14] = (j & 0x00FF);
+            gbaCore.ShortDotCodeHeader[0x13] = (j & 0xFF00) >> 8;
+            gbaCore.ShortDotCodeHeader[0x14] = (j & 0x00FF);
 
             for (i = 0, j = 0; i < 0x2F; i++)
-                j += ShortDotCodeHeader[i];
+                j += gbaCore.ShortDotCodeHeader[i];
             j &= 0xFF;
             for (i = 1, global2 = 0; i < 0x1C; i++) {
                 for (k = 0, global1 = 0; k < 0x30; k++) {
-                    global1 ^= DotCodeData[((i - 1) * 0x30) + k + 0x0C];
+                    global1 ^= gbaCore.DotCodeData[((i - 1) * 0x30) + k + 0x0C];
                 }
                 global2 += global1;
             }
             global2 += j;
             global2 &= 0xFF;
             global2 ^= 0xFF;
-            ShortDotCodeHeader[0x2F] = global2;
+            gbaCore.ShortDotCodeHeader[0x2F] = global2;
         }
 
     } else if (swi_num == 0xE2) //Header
@@ -436,56 +377,56 @@ void BIOS_EReader_ScanCard(int swi_num)
         case 1: //US
             EReaderWriteMemory(0x80091BA, 0xF8A5F03B);
             EReaderWriteMemory(0x300338C, 0xEFE30000);
-            GFpow = 0x3000A6C;
+            gbaCore.GFpow = 0x3000A6C;
             break;
         case 2:
             EReaderWriteMemory(0x8008B12, 0xFB0BF035);
             EReaderWriteMemory(0x3003398, 0xEFE30000);
-            GFpow = 0x3000A78;
+            gbaCore.GFpow = 0x3000A78;
             break;
         case 3:
             EReaderWriteMemory(0x800922E, 0xF94BF04B);
             EReaderWriteMemory(0x300338C, 0xEFE30000);
-            GFpow = 0x3000A6C;
+            gbaCore.GFpow = 0x3000A6C;
             break;
         }
-        armNextPC -= 2;
-        reg[15].I -= 2;
-        if (armState)
+        gbaCore.armNextPC -= 2;
+        gbaCore.reg[15].I -= 2;
+        if (gbaCore.armState)
             ARM_PREFETCH
         else
             THUMB_PREFETCH
     } else if ((swi_num == 0xE3) || (swi_num == 0xE5)) //Dotcode data
     {
-        if (((int)reg[0].I >= 0) && (reg[0].I <= 0x10)) {
-            if (decodestate == 0) {
+        if (((int)gbaCore.reg[0].I >= 0) && (gbaCore.reg[0].I <= 0x10)) {
+            if (gbaCore.decodestate == 0) {
                 for (i = 0x17; i >= 0; i--) {
                     if ((0x17 - i) < 8)
-                        j = CPUReadByte(GFpow + CPUReadByte(GFpow + 0x200 + i));
+                        j = CPUReadByte(gbaCore.GFpow + CPUReadByte(gbaCore.GFpow + 0x200 + i));
                     else
-                        j = CPUReadByte(GFpow + CPUReadByte(GFpow + 0x200 + i)) ^ 0xFF;
+                        j = CPUReadByte(gbaCore.GFpow + CPUReadByte(gbaCore.GFpow + 0x200 + i)) ^ 0xFF;
 
-                    dotcodeheader[(0x17 - i)] = j;
-                    dotcodeheader[(0x17 - i) + 0x18] = j;
-                    dotcodeheader[(0x17 - i) + 0x30] = j;
+                    gbaCore.dotcodeheader[(0x17 - i)] = j;
+                    gbaCore.dotcodeheader[(0x17 - i) + 0x18] = j;
+                    gbaCore.dotcodeheader[(0x17 - i) + 0x30] = j;
                 }
                 for (i = 0; i < 28; i++)
                     for (j = 0; j < 2; j++)
-                        dotcodedata[(i * 0x68) + j] = dotcodeheader[(i * 2) + j];
-                dotcodeinterleave = dotcodeheader[7];
-                decodestate = 1;
+                        gbaCore.dotcodedata[(i * 0x68) + j] = gbaCore.dotcodeheader[(i * 2) + j];
+                gbaCore.dotcodeinterleave = gbaCore.dotcodeheader[7];
+                gbaCore.decodestate = 1;
             } else {
                 for (i = 0x3F; i >= 0; i--) {
                     if ((0x3F - i) < 0x30)
-                        j = CPUReadByte(GFpow + CPUReadByte(GFpow + 0x200 + i));
+                        j = CPUReadByte(gbaCore.GFpow + CPUReadByte(gbaCore.GFpow + 0x200 + i));
                     else
-                        j = CPUReadByte(GFpow + CPUReadByte(GFpow + 0x200 + i)) ^ 0xFF;
-                    dotcodetemp[((0x3F - i) * dotcodeinterleave) + dotcodepointer] = j;
+                        j = CPUReadByte(gbaCore.GFpow + CPUReadByte(gbaCore.GFpow + 0x200 + i)) ^ 0xFF;
+                    gbaCore.dotcodetemp[((0x3F - i) * gbaCore.dotcodeinterleave) + gbaCore.dotcodepointer] = j;
                 }
-                dotcodepointer++;
+                gbaCore.dotcodepointer++;
 
-                if (dotcodepointer == dotcodeinterleave) {
-                    switch (dotcodeinterleave) {
+                if (gbaCore.dotcodepointer == gbaCore.dotcodeinterleave) {
+                    switch (gbaCore.dotcodeinterleave) {
                     case 0x1C:
                         j = 0x724;
                         k = 0x750 - j;
@@ -495,17 +436,17 @@ void BIOS_EReader_ScanCard(int swi_num)
                         k = 0xB60 - j;
                         break;
                     }
-                    dotcodepointer = 0;
+                    gbaCore.dotcodepointer = 0;
                     for (i = 2; i < j; i++) {
                         if ((i % 0x68) == 0)
                             i += 2;
-                        dotcodedata[i] = dotcodetemp[dotcodepointer++];
+                        gbaCore.dotcodedata[i] = gbaCore.dotcodetemp[gbaCore.dotcodepointer++];
                     }
                     if (swi_num == 0xE3) {
                         const char* loadDotCodeFile = GetLoadDotCodeFile();
                         f = utilOpenFile(loadDotCodeFile, "rb+");
                         if (f != NULL) {
-                            fwrite(dotcodedata, 1, j, f);
+                            fwrite(gbaCore.dotcodedata, 1, j, f);
                             fclose(f);
                         }
                     } else {
@@ -513,7 +454,7 @@ void BIOS_EReader_ScanCard(int swi_num)
                         if (saveDotCodeFile) {
                             f = utilOpenFile(saveDotCodeFile, "wb");
                             if (f != NULL) {
-                                fwrite(dotcodedata, 1, j, f);
+                                fwrite(gbaCore.dotcodedata, 1, j, f);
                                 fwrite(Signature, 1, 0x28, f);
                                 if (j == 0x724) {
                                     fputc(0x65, f);
@@ -524,63 +465,63 @@ void BIOS_EReader_ScanCard(int swi_num)
                                 fclose(f);
                             }
                         }
-                        free(DotCodeData);
+                        free(gbaCore.DotCodeData);
                     }
                 }
             }
         }
 
         int base = 14;
-        armState = reg[base].I & 1 ? false : true;
-        if (armState) {
-            reg[15].I = reg[base].I & 0xFFFFFFFC;
-            armNextPC = reg[15].I;
-            reg[15].I += 4;
+        gbaCore.armState = gbaCore.reg[base].I & 1 ? false : true;
+        if (gbaCore.armState) {
+            gbaCore.reg[15].I = gbaCore.reg[base].I & 0xFFFFFFFC;
+            gbaCore.armNextPC = gbaCore.reg[15].I;
+            gbaCore.reg[15].I += 4;
             ARM_PREFETCH
         } else {
-            reg[15].I = reg[base].I & 0xFFFFFFFE;
-            armNextPC = reg[15].I;
-            reg[15].I += 2;
+            gbaCore.reg[15].I = gbaCore.reg[base].I & 0xFFFFFFFE;
+            gbaCore.armNextPC = gbaCore.reg[15].I;
+            gbaCore.reg[15].I += 2;
             THUMB_PREFETCH
         }
     } else if (swi_num == 0xE4) {
-        reg[12].I = reg[13].I;
-        if (decodestate == 0) {
+        gbaCore.reg[12].I = gbaCore.reg[13].I;
+        if (gbaCore.decodestate == 0) {
             for (i = 0; i < 0x18; i++) {
-                if (dotcodesize == 0x81C)
+                if (gbaCore.dotcodesize == 0x81C)
                     j = longheader[i];
                 else
                     j = shortheader[i];
 
                 if (i < 8)
-                    j = CPUReadByte(GFpow + 0x100 + j);
+                    j = CPUReadByte(gbaCore.GFpow + 0x100 + j);
                 else
-                    j = CPUReadByte(GFpow + 0x100 + (j ^ 0xFF));
+                    j = CPUReadByte(gbaCore.GFpow + 0x100 + (j ^ 0xFF));
 
-                CPUWriteByte(GFpow + 0x200 + (0x17 - i), j);
+                CPUWriteByte(gbaCore.GFpow + 0x200 + (0x17 - i), j);
             }
         } else {
-            if (dotcodepointer == 0) {
+            if (gbaCore.dotcodepointer == 0) {
                 for (i = 0; i < 0x30; i++) {
-                    if (dotcodesize == 0x81C)
-                        j = LongDotCodeHeader[i];
+                    if (gbaCore.dotcodesize == 0x81C)
+                        j = gbaCore.LongDotCodeHeader[i];
                     else
-                        j = ShortDotCodeHeader[i];
+                        j = gbaCore.ShortDotCodeHeader[i];
 
-                    j = CPUReadByte(GFpow + 0x100 + j);
-                    CPUWriteByte(GFpow + 0x200 + (0x3F - i), j);
+                    j = CPUReadByte(gbaCore.GFpow + 0x100 + j);
+                    CPUWriteByte(gbaCore.GFpow + 0x200 + (0x3F - i), j);
                 }
 
             } else {
                 for (i = 0; i < 0x30; i++) {
 
-                    j = DotCodeData[((dotcodepointer - 1) * 0x30) + 0x0C + i];
-                    j = CPUReadByte(GFpow + 0x100 + j);
-                    CPUWriteByte(GFpow + 0x200 + (0x3F - i), j);
+                    j = gbaCore.DotCodeData[((gbaCore.dotcodepointer - 1) * 0x30) + 0x0C + i];
+                    j = CPUReadByte(gbaCore.GFpow + 0x100 + j);
+                    CPUWriteByte(gbaCore.GFpow + 0x200 + (0x3F - i), j);
                 }
             }
             for (i = 0; i < 16; i++)
-                CPUWriteByte(GFpow + 0x258 + i, 1); //16 Erasures on the parity bytes, to have them calculated.
+                CPUWriteByte(gbaCore.GFpow + 0x258 + i, 1); //16 Erasures on the parity bytes, to have them calculated.
         }
     }
 }
@@ -3,9 +3,7 @@
 
 #include <cstdint>
 
-extern unsigned char* DotCodeData;
-extern char filebuffer[];
-
+#include "core/base/system.h"
 
 int OpenDotCodeFile(void);
 int CheckEReaderRegion(void);
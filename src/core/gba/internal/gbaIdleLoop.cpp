@@ -0,0 +1,180 @@
+#include "core/gba/internal/gbaIdleLoop.h"
+
+#include <cstring>
+
+#include "core/gba/gba.h"
+#include "core/gba/gbaCpu.h"
+#include "core/gba/gbaGlobals.h"
+#include "core/gba/gbaInline.h"
+
+namespace {
+
+// Longest loop body, in instructions, that is considered for skipping.
+constexpr uint32_t kIdleLoopMaxLength = 16;
+
+bool idleLoopIsCode(uint32_t address)
+{
+    switch (address >> 24) {
+    case 0x00:
+    case 0x02:
+    case 0x03:
+    case 0x08:
+    case 0x09:
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+        return gbaCore.map[address >> 24].address != nullptr;
+    default:
+        return false;
+    }
+}
+
+bool idleLoopThumbInsn(uint32_t address, uint32_t target, uint32_t branch)
+{
+    const uint16_t opcode = CPUReadHalfWordQuick(address);
+
+    if (opcode < 0x4400)
+        return true; // shifts, immediates and ALU operations
+    if (opcode < 0x4700) {
+        // hi register operations, CMP does not write Rd
+        if ((opcode & 0xFF00) == 0x4500)
+            return true;
+        return ((opcode & 7) | ((opcode >> 4) & 8)) != 15;
+    }
+    if (opcode < 0x4800)
+        return false; // BX
+    if (opcode < 0x5000)
+        return true; // LDR Rd, [PC, #imm]
+    if (opcode < 0x6000)
+        return opcode >= 0x5600; // register offset loads
+    if (opcode < 0xA000)
+        return (opcode & 0x0800) != 0; // immediate and SP relative loads
+    if (opcode < 0xB000)
+        return true; // ADD Rd, PC/SP, #imm
+    if (opcode < 0xB100)
+        return true; // ADD SP, #imm
+    if (opcode >= 0xD000 && opcode < 0xDE00) {
+        const uint32_t dest = address + 4 + ((uint32_t)(int8_t)(opcode & 0xFF) << 1);
+        return dest >= target && dest <= branch;
+    }
+    if (opcode >= 0xE000 && opcode < 0xE800) {
+        int offset = (opcode & 0x3FF) << 1;
+        if (opcode & 0x0400)
+            offset |= 0xFFFFF800;
+        const uint32_t dest = address + 4 + offset;
+        return dest >= target && dest <= branch;
+    }
+    return false;
+}
+
+bool idleLoopArmInsn(uint32_t address, uint32_t target, uint32_t branch)
+{
+    const uint32_t opcode = CPUReadMemoryQuick(address);
+    const uint32_t rd = (opcode >> 12) & 15;
+
+    if ((opcode >> 28) == 0x0F)
+        return false;
+
+    switch ((opcode >> 25) & 7) {
+    case 0:
+        if ((opcode & 0x90) == 0x90) {
+            // LDRH, LDRSB and LDRSH, no multiplies, swaps or stores
+            return (opcode & 0x00100000) && (opcode & 0x60) && rd != 15;
+        }
+        if ((opcode & 0x01900000) == 0x01000000)
+            return false; // MRS, MSR, BX
+        return rd != 15;
+    case 1:
+        if ((opcode & 0x01900000) == 0x01000000)
+            return false; // MSR
+        return rd != 15;
+    case 2:
+    case 3:
+        if ((opcode & 0x02000010) == 0x02000010)
+            return false; // undefined
+        return (opcode & 0x00100000) && rd != 15; // LDR, LDRB
+    case 5:
+        if (!(opcode & 0x01000000)) {
+            const int32_t offset = ((int32_t)(opcode & 0x00FFFFFF) << 8) >> 6;
+            const uint32_t dest = address + 8 + offset;
+            return dest >= target && dest <= branch;
+        }
+        return false; // BL
+    default:
+        return false;
+    }
+}
+
+// Returns true if the loop [target, branch] cannot write anything but
+// registers and never leaves the loop other than by falling through.
+bool idleLoopAnalyse(uint32_t branch, uint32_t target)
+{
+    const uint32_t size = gbaCore.armState ? 4 : 2;
+
+    if (!idleLoopIsCode(target) || (target >> 24) != (branch >> 24))
+        return false;
+    if ((branch - target) / size >= kIdleLoopMaxLength)
+        return false;
+
+    for (uint32_t address = target; address < branch; address += size) {
+        if (gbaCore.armState ? !idleLoopArmInsn(address, target, branch)
+                     : !idleLoopThumbInsn(address, target, branch))
+            return false;
+    }
+    return true;
+}
+
+void idleLoopSnapshot()
+{
+    for (int i = 0; i < 15; i++)
+        gbaCore.idleLoopRegs[i] = gbaCore.reg[i].I;
+    gbaCore.idleLoopFlags[0] = gbaCore.N_FLAG;
+    gbaCore.idleLoopFlags[1] = gbaCore.Z_FLAG;
+    gbaCore.idleLoopFlags[2] = gbaCore.C_FLAG;
+    gbaCore.idleLoopFlags[3] = gbaCore.V_FLAG;
+    gbaCore.idleLoopVolatileRead = false;
+}
+
+bool idleLoopSameState()
+{
+    for (int i = 0; i < 15; i++) {
+        if (gbaCore.idleLoopRegs[i] != gbaCore.reg[i].I)
+            return false;
+    }
+    return gbaCore.idleLoopFlags[0] == gbaCore.N_FLAG && gbaCore.idleLoopFlags[1] == gbaCore.Z_FLAG &&
+           gbaCore.idleLoopFlags[2] == gbaCore.C_FLAG && gbaCore.idleLoopFlags[3] == gbaCore.V_FLAG;
+}
+
+}  // namespace
+
+void cpuIdleLoopCheck(uint32_t branch, uint32_t target)
+{
+    // the master code handler writes to memory at an arbitrary address
+    if (coreOptions.cheatsEnabled && gbaCore.mastercode)
+        return;
+
+    if (branch == gbaCore.idleLoopBranch && target == gbaCore.idleLoopTarget) {
+        if (!gbaCore.idleLoopVolatileRead && idleLoopSameState()) {
+            if (gbaCore.cpuTotalTicks < gbaCore.cpuNextEvent)
+                gbaCore.cpuTotalTicks = gbaCore.cpuNextEvent;
+            return;
+        }
+        idleLoopSnapshot();
+        return;
+    }
+
+    if (branch == gbaCore.idleLoopRejectedBranch && target == gbaCore.idleLoopRejectedTarget)
+        return;
+
+    if (!idleLoopAnalyse(branch, target)) {
+        gbaCore.idleLoopRejectedBranch = branch;
+        gbaCore.idleLoopRejectedTarget = target;
+        cpuIdleLoopReset();
+        return;
+    }
+
+    gbaCore.idleLoopBranch = branch;
+    gbaCore.idleLoopTarget = target;
+    idleLoopSnapshot();
+}
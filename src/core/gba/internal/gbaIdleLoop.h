@@ -0,0 +1,47 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBAIDLELOOP_H_
+#define VBAM_CORE_GBA_INTERNAL_GBAIDLELOOP_H_
+
+#include <cstdint>
+
+#include "core/base/system.h"
+#include "core/gba/gbaCore.h"
+
+// Idle loop detection for the GBA CPU cores.
+//
+// Games commonly wait for an interrupt or for a hardware register to change by
+// spinning in a tight loop instead of calling Halt(). When enabled with
+// `coreOptions.skipIdleLoops`, every taken backward branch over a short loop
+// is checked: if the loop body only reads memory and computes on registers,
+// and two consecutive iterations leave the CPU in the exact same state, then
+// nothing can change until the next scheduled event and the CPU jumps
+// straight to it.
+//
+// Reads that return a value depending on the current cycle (running timers),
+// that have side effects or return external input (save chips, RTC, tilt
+// sensor, serial registers) set `idleLoopVolatileRead` and keep the loop from
+// being skipped. The tracker is reset whenever the loop is left and at every
+// event, so memory written by DMA or interrupt handlers is always seen again
+// before skipping.
+
+// Called on a taken backward branch from `branch` to `target`.
+void cpuIdleLoopCheck(uint32_t branch, uint32_t target);
+
+static inline void cpuIdleLoopReset()
+{
+    gbaCore.idleLoopBranch = kIdleLoopNone;
+}
+
+static inline void cpuIdleLoopTaken(uint32_t branch, uint32_t target)
+{
+    if (coreOptions.skipIdleLoops)
+        cpuIdleLoopCheck(branch, target);
+}
+
+// Called when the conditional branch at `branch` falls through.
+static inline void cpuIdleLoopNotTaken(uint32_t branch)
+{
+    if (branch == gbaCore.idleLoopBranch)
+        cpuIdleLoopReset();
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBAIDLELOOP_H_
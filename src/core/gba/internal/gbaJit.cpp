@@ -0,0 +1,693 @@
+#include "core/gba/internal/gbaJit.h"
+
+#if !defined(__x86_64__) && !defined(_M_X64)
+#error "The JIT only supports x86-64 hosts."
+#endif
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif  // defined(_WIN32)
+
+#include <cstdint>
+#include <cstring>
+
+#include "core/base/system.h"
+#include "core/gba/gba.h"
+#include "core/gba/gbaCpu.h"
+#include "core/gba/gbaGlobals.h"
+#include "core/gba/gbaInline.h"
+
+#if defined(VBAM_ENABLE_DEBUGGER)
+#include "core/gba/gbaRemote.h"
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+
+namespace {
+
+// Blocks shorter than this are cheaper to interpret.
+constexpr int kJitMinInsns = 2;
+// Number of visits before a block is translated.
+constexpr uint16_t kJitHotThreshold = 16;
+// Marks a block start that cannot be translated.
+constexpr uint16_t kJitNeverHot = 0xFFFF;
+
+constexpr size_t kJitCodeSize = 4 * 1024 * 1024;
+// Upper bounds for the generated code, used to check for space up front.
+constexpr size_t kJitMaxInsnBytes = 64;
+constexpr size_t kJitMaxFrameBytes = 128;
+
+// Host registers. Only caller-saved registers are used so the generated
+// code needs no stack frame on either the SysV or the Windows ABI.
+enum X64Reg {
+    EAX = 0,
+    ECX = 1,
+    EDX = 2,
+};
+
+// The ARM flags live in r8b-r11b while a block runs.
+enum JitFlag {
+    FLAG_N = 0,
+    FLAG_Z = 1,
+    FLAG_C = 2,
+    FLAG_V = 3,
+};
+
+// Flags of the current core, which the blocks translated for it access.
+bool* jitFlagAddress(JitFlag flag)
+{
+#if defined(VBAM_ENABLE_LAZY_FLAGS)
+    // N and Z have no storage of their own with lazy flags, so blocks work on
+    // copies that are synced around each call.
+    bool* const flags[4] = { &gbaCore.jitNFlag, &gbaCore.jitZFlag, &gbaCore.C_FLAG, &gbaCore.V_FLAG };
+#else
+    bool* const flags[4] = { &gbaCore.N_FLAG, &gbaCore.Z_FLAG, &gbaCore.C_FLAG, &gbaCore.V_FLAG };
+#endif  // defined(VBAM_ENABLE_LAZY_FLAGS)
+    return flags[flag];
+}
+
+// x86 condition codes for SETcc.
+enum X64Cond {
+    CC_O = 0x0,
+    CC_C = 0x2,
+    CC_NC = 0x3,
+    CC_Z = 0x4,
+    CC_S = 0x8,
+};
+
+// x86 ALU opcodes in their "op r/m32, r32" form.
+enum X64Alu {
+    ALU_ADD = 0x01,
+    ALU_OR = 0x09,
+    ALU_ADC = 0x11,
+    ALU_SBB = 0x19,
+    ALU_AND = 0x21,
+    ALU_SUB = 0x29,
+    ALU_XOR = 0x31,
+    ALU_TEST = 0x85,
+};
+
+class X64Emitter {
+public:
+    explicit X64Emitter(uint8_t* out)
+        : out_(out)
+    {
+    }
+
+    uint8_t* pos() const { return out_; }
+    unsigned flagsWritten() const { return flagsWritten_; }
+
+    // mov r32, [rcx + 4 * n]
+    void loadReg(X64Reg dst, int n)
+    {
+        emit8(0x8B);
+        emit8(0x41 | (dst << 3));
+        emit8(n * sizeof(reg_pair));
+    }
+
+    // mov [rcx + 4 * n], r32
+    void storeReg(int n, X64Reg src)
+    {
+        emit8(0x89);
+        emit8(0x41 | (src << 3));
+        emit8(n * sizeof(reg_pair));
+    }
+
+    // mov r32, imm32
+    void movImm(X64Reg dst, uint32_t imm)
+    {
+        emit8(0xB8 + dst);
+        emit32(imm);
+    }
+
+    // mov r64, imm64
+    void movPtr(X64Reg dst, const void* ptr)
+    {
+        emit8(0x48);
+        emit8(0xB8 + dst);
+        emit64((uint64_t)(uintptr_t)ptr);
+    }
+
+    // <op> dst, src
+    void alu(X64Alu op, X64Reg dst, X64Reg src)
+    {
+        emit8(op);
+        emit8(0xC0 | (src << 3) | dst);
+    }
+
+    // not r32
+    void notReg(X64Reg reg)
+    {
+        emit8(0xF7);
+        emit8(0xD0 | reg);
+    }
+
+    // shl/shr/sar eax, imm8
+    void shl(int n) { shift(0xE0, n); }
+    void shr(int n) { shift(0xE8, n); }
+    void sar(int n) { shift(0xF8, n); }
+
+    // bt eax, 31
+    void testSign()
+    {
+        emit8(0x0F);
+        emit8(0xBA);
+        emit8(0xE0);
+        emit8(31);
+    }
+
+    // Loads the host carry with the ARM carry (ADC) or its inverse (SBC).
+    void loadCarry(bool inverted)
+    {
+        if (inverted) {
+            // cmp r10b, 1
+            emit8(0x41);
+            emit8(0x80);
+            emit8(0xF8 | FLAG_C);
+            emit8(0x01);
+        } else {
+            // bt r10d, 0
+            emit8(0x41);
+            emit8(0x0F);
+            emit8(0xBA);
+            emit8(0xE0 | FLAG_C);
+            emit8(0x00);
+        }
+    }
+
+    // setcc r8b + flag
+    void setFlag(JitFlag flag, X64Cond cond)
+    {
+        emit8(0x41);
+        emit8(0x0F);
+        emit8(0x90 | cond);
+        emit8(0xC0 | flag);
+        flagsWritten_ |= 1 << flag;
+    }
+
+    // movzx r8d + flag, byte [rax]
+    void loadFlag(JitFlag flag)
+    {
+        movPtr(EAX, jitFlagAddress(flag));
+        emit8(0x44);
+        emit8(0x0F);
+        emit8(0xB6);
+        emit8(flag << 3);
+    }
+
+    // mov byte [rax], r8b + flag
+    void storeFlag(JitFlag flag)
+    {
+        movPtr(EAX, jitFlagAddress(flag));
+        emit8(0x44);
+        emit8(0x88);
+        emit8(flag << 3);
+    }
+
+    void ret() { emit8(0xC3); }
+
+    // N and Z from the value in eax.
+    void logicalFlags()
+    {
+        alu(ALU_TEST, EAX, EAX);
+        setFlag(FLAG_N, CC_S);
+        setFlag(FLAG_Z, CC_Z);
+    }
+
+    // N, Z, C and V after an addition.
+    void addFlags()
+    {
+        setFlag(FLAG_N, CC_S);
+        setFlag(FLAG_Z, CC_Z);
+        setFlag(FLAG_C, CC_C);
+        setFlag(FLAG_V, CC_O);
+    }
+
+    // N, Z, C and V after a subtraction. ARM sets C when there is no borrow.
+    void subFlags()
+    {
+        setFlag(FLAG_N, CC_S);
+        setFlag(FLAG_Z, CC_Z);
+        setFlag(FLAG_C, CC_NC);
+        setFlag(FLAG_V, CC_O);
+    }
+
+private:
+    void shift(uint8_t modrm, int n)
+    {
+        emit8(0xC1);
+        emit8(modrm);
+        emit8(n);
+    }
+
+    void emit8(uint8_t value) { *out_++ = value; }
+
+    void emit32(uint32_t value)
+    {
+        memcpy(out_, &value, sizeof(value));
+        out_ += sizeof(value);
+    }
+
+    void emit64(uint64_t value)
+    {
+        memcpy(out_, &value, sizeof(value));
+        out_ += sizeof(value);
+    }
+
+    uint8_t* out_;
+    unsigned flagsWritten_ = 0;
+};
+
+// Code outside ROM and IWRAM is left to the interpreter.
+bool thumbJitCacheable(uint32_t address)
+{
+    switch (address >> 24) {
+    case 0x03:
+    case 0x08:
+    case 0x09:
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Instructions that only touch registers and flags and take a single
+// sequential cycle. Anything involving PC is left out.
+bool thumbJitSupported(uint32_t opcode)
+{
+#if defined(VBAM_ENABLE_DEBUGGER)
+    // AND R0, R0 is used for debugger console output.
+    if (opcode == 0x4000)
+        return false;
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+
+    if (opcode < 0x4000) {
+        // Shift by immediate, 3-operand ADD/SUB, MOV/CMP/ADD/SUB immediate.
+        return true;
+    }
+
+    if (opcode < 0x4400) {
+        switch ((opcode >> 6) & 15) {
+        case 0x2: // LSL Rd, Rs
+        case 0x3: // LSR Rd, Rs
+        case 0x4: // ASR Rd, Rs
+        case 0x7: // ROR Rd, Rs
+        case 0xD: // MUL Rd, Rs
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    if (opcode < 0x4700) {
+        const int dest = (opcode & 7) | ((opcode >> 4) & 8);
+        const int source = (opcode >> 3) & 15;
+        if (dest == 15 || source == 15)
+            return false;
+        // ADD with two low registers is undefined.
+        return (opcode & 0xFFC0) != 0x4400;
+    }
+
+    return false;
+}
+
+bool thumbJitReadsCarry(uint32_t opcode)
+{
+    // ADC Rd, Rs and SBC Rd, Rs
+    return (opcode & 0xFFC0) == 0x4140 || (opcode & 0xFFC0) == 0x4180;
+}
+
+// Emits the code for one instruction accepted by thumbJitSupported(). The
+// flags are computed the same way as the interpreter macros in
+// gbaCpuThumb.cpp.
+void thumbJitEmit(X64Emitter& e, uint32_t opcode)
+{
+    if (opcode < 0x1800) {
+        // LSL/LSR/ASR Rd, Rs, #Imm5
+        const int shift = (opcode >> 6) & 31;
+        e.loadReg(EAX, (opcode >> 3) & 7);
+        switch (opcode >> 11) {
+        case 0:
+            if (shift) {
+                e.shl(shift);
+                e.setFlag(FLAG_C, CC_C);
+            }
+            break;
+        case 1:
+            if (shift) {
+                e.shr(shift);
+                e.setFlag(FLAG_C, CC_C);
+            } else {
+                // LSR #32
+                e.testSign();
+                e.setFlag(FLAG_C, CC_C);
+                e.alu(ALU_XOR, EAX, EAX);
+            }
+            break;
+        case 2:
+            if (shift) {
+                e.sar(shift);
+                e.setFlag(FLAG_C, CC_C);
+            } else {
+                // ASR #32
+                e.testSign();
+                e.setFlag(FLAG_C, CC_C);
+                e.sar(31);
+            }
+            break;
+        }
+        e.storeReg(opcode & 7, EAX);
+        e.logicalFlags();
+        return;
+    }
+
+    if (opcode < 0x2000) {
+        // ADD/SUB Rd, Rs, Rn and ADD/SUB Rd, Rs, #Imm3
+        const int operand = (opcode >> 6) & 7;
+        e.loadReg(EAX, (opcode >> 3) & 7);
+        if (opcode & 0x0400)
+            e.movImm(EDX, operand);
+        else
+            e.loadReg(EDX, operand);
+        if (opcode & 0x0200) {
+            e.alu(ALU_SUB, EAX, EDX);
+            e.subFlags();
+        } else {
+            e.alu(ALU_ADD, EAX, EDX);
+            e.addFlags();
+        }
+        e.storeReg(opcode & 7, EAX);
+        return;
+    }
+
+    if (opcode < 0x4000) {
+        // MOV/CMP/ADD/SUB Rd, #Imm8
+        const int dest = (opcode >> 8) & 7;
+        const uint32_t imm = opcode & 255;
+        switch ((opcode >> 11) & 3) {
+        case 0:
+            e.movImm(EAX, imm);
+            e.storeReg(dest, EAX);
+            e.logicalFlags();
+            break;
+        case 1:
+            e.loadReg(EAX, dest);
+            e.movImm(EDX, imm);
+            e.alu(ALU_SUB, EAX, EDX);
+            e.subFlags();
+            break;
+        case 2:
+            e.loadReg(EAX, dest);
+            e.movImm(EDX, imm);
+            e.alu(ALU_ADD, EAX, EDX);
+            e.addFlags();
+            e.storeReg(dest, EAX);
+            break;
+        case 3:
+            e.loadReg(EAX, dest);
+            e.movImm(EDX, imm);
+            e.alu(ALU_SUB, EAX, EDX);
+            e.subFlags();
+            e.storeReg(dest, EAX);
+            break;
+        }
+        return;
+    }
+
+    if (opcode < 0x4400) {
+        // ALU operations
+        const int dest = opcode & 7;
+        e.loadReg(EAX, dest);
+        e.loadReg(EDX, (opcode >> 3) & 7);
+        switch ((opcode >> 6) & 15) {
+        case 0x0: // AND
+            e.alu(ALU_AND, EAX, EDX);
+            e.storeReg(dest, EAX);
+            e.logicalFlags();
+            break;
+        case 0x1: // EOR
+            e.alu(ALU_XOR, EAX, EDX);
+            e.storeReg(dest, EAX);
+            e.logicalFlags();
+            break;
+        case 0x5: // ADC
+            e.loadCarry(false);
+            e.alu(ALU_ADC, EAX, EDX);
+            e.addFlags();
+            e.storeReg(dest, EAX);
+            break;
+        case 0x6: // SBC
+            e.loadCarry(true);
+            e.alu(ALU_SBB, EAX, EDX);
+            e.subFlags();
+            e.storeReg(dest, EAX);
+            break;
+        case 0x8: // TST
+            e.alu(ALU_AND, EAX, EDX);
+            e.logicalFlags();
+            break;
+        case 0x9: // NEG
+            e.alu(ALU_XOR, EAX, EAX);
+            e.alu(ALU_SUB, EAX, EDX);
+            e.subFlags();
+            e.storeReg(dest, EAX);
+            break;
+        case 0xA: // CMP
+            e.alu(ALU_SUB, EAX, EDX);
+            e.subFlags();
+            break;
+        case 0xB: // CMN
+            e.alu(ALU_ADD, EAX, EDX);
+            e.addFlags();
+            break;
+        case 0xC: // ORR
+            e.alu(ALU_OR, EAX, EDX);
+            e.storeReg(dest, EAX);
+            e.logicalFlags();
+            break;
+        case 0xE: // BIC
+            e.notReg(EDX);
+            e.alu(ALU_AND, EAX, EDX);
+            e.storeReg(dest, EAX);
+            e.logicalFlags();
+            break;
+        case 0xF: // MVN
+            e.notReg(EDX);
+            e.storeReg(dest, EDX);
+            e.alu(ALU_TEST, EDX, EDX);
+            e.setFlag(FLAG_N, CC_S);
+            e.setFlag(FLAG_Z, CC_Z);
+            break;
+        }
+        return;
+    }
+
+    // High register ADD/CMP/MOV
+    int dest = (opcode & 7) | ((opcode >> 4) & 8);
+    int source = (opcode >> 3) & 15;
+    switch ((opcode >> 8) & 3) {
+    case 0:
+        e.loadReg(EAX, dest);
+        e.loadReg(EDX, source);
+        e.alu(ALU_ADD, EAX, EDX);
+        e.storeReg(dest, EAX);
+        break;
+    case 1:
+        // The interpreter swaps the operands of CMP with two low registers.
+        if ((opcode & 0xC0) == 0) {
+            dest = (opcode >> 3) & 7;
+            source = opcode & 7;
+        }
+        e.loadReg(EAX, dest);
+        e.loadReg(EDX, source);
+        e.alu(ALU_SUB, EAX, EDX);
+        e.subFlags();
+        break;
+    case 2:
+        e.loadReg(EAX, source);
+        e.storeReg(dest, EAX);
+        break;
+    }
+}
+
+void thumbJitReset()
+{
+    memset(gbaCore.jitBlocks, 0, sizeof(gbaCore.jitBlocks));
+    gbaCore.jitCodeUsed = 0;
+}
+
+bool thumbJitAllocate()
+{
+#if defined(_WIN32)
+    gbaCore.jitCode = (uint8_t*)VirtualAlloc(nullptr, kJitCodeSize, MEM_COMMIT | MEM_RESERVE,
+                                     PAGE_EXECUTE_READWRITE);
+#else
+    void* code = mmap(nullptr, kJitCodeSize, PROT_READ | PROT_WRITE | PROT_EXEC,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    gbaCore.jitCode = code == MAP_FAILED ? nullptr : (uint8_t*)code;
+#endif  // defined(_WIN32)
+
+    if (!gbaCore.jitCode) {
+        gbaCore.jitUnavailable = true;
+        return false;
+    }
+
+    thumbJitReset();
+    return true;
+}
+
+// Returns the opcode at `address`, as the interpreter would see it when
+// entering a block at armNextPC.
+uint32_t thumbJitOpcode(uint32_t start, int index)
+{
+    if (index < 2)
+        return gbaCore.cpuPrefetch[index];
+    return CPUReadHalfWordQuick(start + index * 2);
+}
+
+bool thumbJitTranslate(JitBlock& block)
+{
+    const uint32_t start = block.address;
+    uint16_t opcodes[kJitMaxInsns];
+    int length = 0;
+    bool readsCarry = false;
+
+    while (length < kJitMaxInsns) {
+        // Stay within one memory region so that the wait states do not
+        // change in the middle of a block.
+        if (((start + length * 2 + 2) >> 24) != (start >> 24))
+            break;
+        const uint32_t opcode = thumbJitOpcode(start, length);
+        if (!thumbJitSupported(opcode))
+            break;
+        readsCarry |= thumbJitReadsCarry(opcode);
+        opcodes[length++] = opcode;
+    }
+
+    if (length < kJitMinInsns)
+        return false;
+
+    if (!gbaCore.jitCode && !thumbJitAllocate())
+        return false;
+
+    if (gbaCore.jitCodeUsed + length * kJitMaxInsnBytes + kJitMaxFrameBytes > kJitCodeSize) {
+        thumbJitReset();
+        block.address = start;
+    }
+
+    X64Emitter e(gbaCore.jitCode + gbaCore.jitCodeUsed);
+    e.movPtr(ECX, gbaCore.reg);
+    if (readsCarry)
+        e.loadFlag(FLAG_C);
+    for (int i = 0; i < length; i++)
+        thumbJitEmit(e, opcodes[i]);
+    for (int flag = FLAG_N; flag <= FLAG_V; flag++) {
+        if (e.flagsWritten() & (1 << flag))
+            e.storeFlag((JitFlag)flag);
+    }
+    e.ret();
+
+    block.code = (JitCode)(gbaCore.jitCode + gbaCore.jitCodeUsed);
+    block.length = length;
+    memcpy(block.opcodes, opcodes, sizeof(opcodes));
+    gbaCore.jitCodeUsed = e.pos() - gbaCore.jitCode;
+    return true;
+}
+
+}  // namespace
+
+bool thumbJitExecute()
+{
+    const uint32_t start = gbaCore.armNextPC;
+
+    if (gbaCore.jitUnavailable || !thumbJitCacheable(start))
+        return false;
+    if (coreOptions.cheatsEnabled && gbaCore.mastercode)
+        return false;
+#if defined(VBAM_ENABLE_DEBUGGER)
+    if (enableRegBreak)
+        return false;
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+
+    JitBlock& block = gbaCore.jitBlocks[(start >> 1) & (kJitTableSize - 1)];
+    if (block.address != start) {
+        block.address = start;
+        block.hits = 0;
+        block.code = nullptr;
+        return false;
+    }
+
+    if (!block.code) {
+        if (block.hits == kJitNeverHot || ++block.hits < kJitHotThreshold)
+            return false;
+        if (!thumbJitTranslate(block)) {
+            block.hits = kJitNeverHot;
+            return false;
+        }
+    }
+
+    for (int i = 0; i < block.length; i++) {
+        if (thumbJitOpcode(start, i) != block.opcodes[i]) {
+            // The code was modified, translate it again once it gets hot.
+            block.hits = 0;
+            block.code = nullptr;
+            return false;
+        }
+    }
+
+    // Account for the cycles the same way thumbExecute() does, and give up
+    // if the block would run past the next event.
+    const uint32_t prefetchCount = gbaCore.busPrefetchCount;
+    int ticks = 0;
+    for (int i = 0; i < block.length; i++) {
+#if defined(VBAM_ENABLE_DEBUGGER)
+        const memoryMap& m = gbaCore.map[start >> 24];
+        if (m.breakPoints && BreakThumbCheck(m.breakPoints, (start + i * 2 + 2) & m.mask)) {
+            gbaCore.busPrefetchCount = prefetchCount;
+            return false;
+        }
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+        if (gbaCore.busPrefetchCount & 0xFFFFFF00)
+            gbaCore.busPrefetchCount = 0x100 | (gbaCore.busPrefetchCount & 0xFF);
+        ticks += codeTicksAccessSeq16(start) + 1;
+    }
+    if (gbaCore.cpuTotalTicks + ticks >= gbaCore.cpuNextEvent) {
+        gbaCore.busPrefetchCount = prefetchCount;
+        return false;
+    }
+
+#if defined(VBAM_ENABLE_LAZY_FLAGS)
+    gbaCore.jitNFlag = gbaCore.N_FLAG;
+    gbaCore.jitZFlag = gbaCore.Z_FLAG;
+    block.code();
+    gbaCore.N_FLAG = gbaCore.jitNFlag;
+    gbaCore.Z_FLAG = gbaCore.jitZFlag;
+#else
+    block.code();
+#endif  // defined(VBAM_ENABLE_LAZY_FLAGS)
+
+    gbaCore.armNextPC = start + block.length * 2;
+    gbaCore.reg[15].I = gbaCore.armNextPC + 2;
+    gbaCore.cpuPrefetch[0] = CPUReadHalfWordQuick(gbaCore.armNextPC);
+    gbaCore.cpuPrefetch[1] = CPUReadHalfWordQuick(gbaCore.armNextPC + 2);
+    gbaCore.busPrefetch = false;
+    gbaCore.cpuTotalTicks += ticks;
+    return true;
+}
+
+void thumbJitRelease()
+{
+    if (!gbaCore.jitCode)
+        return;
+
+#if defined(_WIN32)
+    VirtualFree(gbaCore.jitCode, 0, MEM_RELEASE);
+#else
+    munmap(gbaCore.jitCode, kJitCodeSize);
+#endif  // defined(_WIN32)
+    gbaCore.jitCode = nullptr;
+}
@@ -0,0 +1,49 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBAJIT_H_
+#define VBAM_CORE_GBA_INTERNAL_GBAJIT_H_
+
+#if !defined(VBAM_ENABLE_JIT)
+#error "This file should only be included when VBAM_ENABLE_JIT is defined."
+#endif  // !defined(VBAM_ENABLE_JIT)
+
+#include <cstdint>
+
+// x86-64 recompiler for hot THUMB code.
+//
+// Straight runs of THUMB data processing instructions executed from ROM or
+// IWRAM are translated to host code once they become hot. Everything else
+// (loads, stores, branches, multiplies, register shifts...) is left to the
+// interpreter, which also handles any block that would cross the next
+// scheduled event. The translated code only touches registers and flags, so
+// the cycle count of a block is computed with the same wait state helpers as
+// the interpreter and stays exact.
+//
+// Blocks check their opcodes against memory before running, so self-modifying
+// code, patched ROMs and loaded save states simply fall back to the
+// interpreter until the block is translated again.
+//
+// Each core translates its blocks to its own code buffer, with the addresses
+// of its registers built in.
+
+typedef void (*JitCode)();
+
+// Number of block entries. Must be a power of two.
+static constexpr uint32_t kJitTableSize = 4096;
+// Longest block, in instructions.
+static constexpr int kJitMaxInsns = 32;
+
+struct JitBlock {
+    uint32_t address;
+    uint16_t hits;
+    uint16_t length;
+    JitCode code;
+    uint16_t opcodes[kJitMaxInsns];
+};
+
+// Runs the translated block starting at armNextPC, if there is one.
+// Returns false when the interpreter must execute the next instruction.
+bool thumbJitExecute();
+
+// Frees the code buffer of the current core.
+void thumbJitRelease();
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBAJIT_H_
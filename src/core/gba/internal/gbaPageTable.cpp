@@ -0,0 +1,90 @@
+#include "core/gba/internal/gbaPageTable.h"
+
+#include <cstring>
+
+#include "core/gba/gba.h"
+#include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaTileCache.h"
+
+namespace {
+
+void setPage(MemoryPage& page, uint8_t* memory, uint8_t* freeze, bool byteWrites)
+{
+    page.read = memory;
+    page.write = memory;
+    page.writeByte = byteWrites ? memory : nullptr;
+#if defined(VBAM_ENABLE_DEBUGGER)
+    page.freeze = freeze;
+#else
+    (void)freeze;
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+}
+
+}  // namespace
+
+void cpuUpdatePageTable()
+{
+    memset(gbaCore.cpuPageTable, 0, sizeof(gbaCore.cpuPageTable));
+
+    for (uint32_t index = 0; index < kPageCount; index++) {
+        const uint32_t address = index << kPageShift;
+        MemoryPage& page = gbaCore.cpuPageTable[index];
+        uint8_t* freeze = nullptr;
+
+        switch (address >> 24) {
+        case 2: {
+            const uint32_t offset = address & 0x3FFFF;
+            if (!gbaCore.g_workRAM)
+                break;
+#if defined(VBAM_ENABLE_DEBUGGER)
+            freeze = &gbaCore.freezeWorkRAM[offset];
+#endif
+            setPage(page, &gbaCore.g_workRAM[offset], freeze, true);
+            break;
+        }
+        case 3: {
+            const uint32_t offset = address & 0x7FFF;
+            if (!gbaCore.g_internalRAM)
+                break;
+#if defined(VBAM_ENABLE_DEBUGGER)
+            freeze = &gbaCore.freezeInternalRAM[offset];
+#endif
+            setPage(page, &gbaCore.g_internalRAM[offset], freeze, true);
+            break;
+        }
+        case 6: {
+            uint32_t offset = address & 0x1FFFF;
+            // unmapped in the bitmap modes, depends on DISPCNT
+            if (!gbaCore.g_vram || (offset & 0x1C000) == 0x18000)
+                break;
+            if ((offset & 0x18000) == 0x18000)
+                offset &= 0x17FFF;
+#if defined(VBAM_ENABLE_DEBUGGER)
+            freeze = &gbaCore.freezeVRAM[offset];
+#endif
+            // byte stores are widened to halfwords, or ignored for OBJ tiles
+            setPage(page, &gbaCore.g_vram[offset], freeze, false);
+            // stores to the BG tiles must invalidate the tile cache
+            if (offset < kTileCacheSize)
+                page.write = nullptr;
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+            // and every store must be seen by the threaded renderer
+            page.write = nullptr;
+#endif
+            break;
+        }
+        case 8:
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+            // the first page holds the GPIO registers
+            if (!gbaCore.g_rom || address == 0x08000000)
+                break;
+            page.read = &gbaCore.g_rom[address & 0x1FFFFFF];
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBAPAGETABLE_H_
+#define VBAM_CORE_GBA_INTERNAL_GBAPAGETABLE_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaCore.h"
+
+// Page table for the CPU memory accessors.
+//
+// The first 256 MiB of the GBA address space, which hold everything the bus
+// decodes, are split in 16 KiB pages. Each page points directly at the host
+// memory behind it, mirrors already resolved, so that plain RAM and ROM
+// accesses take a single lookup. Pages with side effects or with contents
+// that depend on the hardware state (BIOS, I/O, palette, OAM, the bitmap
+// mode VRAM hole, the ROM GPIO registers, save chips...) are left empty and
+// go through the regular switch in gbaInline.h. The BG VRAM is only mapped
+// for loads, stores to it have to keep the tile cache up to date.
+//
+// The table must be rebuilt with cpuUpdatePageTable() whenever one of the
+// memory buffers is reallocated.
+
+void cpuUpdatePageTable();
+
+// Returns the host memory of the page holding `address`, or null if loads
+// from it need the slow path.
+static inline const uint8_t* cpuReadPage(uint32_t address)
+{
+    if (address >= kPageTableEnd)
+        return nullptr;
+    return gbaCore.cpuPageTable[address >> kPageShift].read;
+}
+
+// Returns the host memory of the page holding `address`, or null if a store
+// of `size` bytes to it needs the slow path.
+static inline uint8_t* cpuWritePage(uint32_t address, uint32_t size)
+{
+    if (address >= kPageTableEnd)
+        return nullptr;
+    const MemoryPage& page = gbaCore.cpuPageTable[address >> kPageShift];
+    uint8_t* memory = size == 1 ? page.writeByte : page.write;
+#if defined(VBAM_ENABLE_DEBUGGER)
+    // frozen cheat locations are written by the cheat engine instead
+    if (memory) {
+        const uint8_t* freeze = &page.freeze[address & kPageMask & ~(size - 1)];
+        if ((size == 4 && *((const uint32_t*)freeze)) ||
+            (size == 2 && *((const uint16_t*)freeze)) ||
+            (size == 1 && *freeze))
+            return nullptr;
+    }
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+    return memory;
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBAPAGETABLE_H_
@@ -0,0 +1,384 @@
+#include "core/gba/internal/gbaRenderThreads.h"
+
+#if !defined(VBAM_ENABLE_REENTRANT_CORE)
+#error "The threaded renderer needs VBAM_ENABLE_REENTRANT_CORE."
+#endif  // !defined(VBAM_ENABLE_REENTRANT_CORE)
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/gba/gba.h"
+#include "core/gba/gbaGfx.h"
+#include "core/gba/gbaGlobals.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
+#include "core/gba/internal/gbaTileCache.h"
+
+namespace {
+
+// PPU registers read by the renderers. WIN0H and WIN1H are handled apart,
+// the renderers use the gfxInWin0/gfxInWin1 masks derived from them.
+#define GFX_LINE_REGISTERS(X)                        \
+    X(DISPCNT) X(VCOUNT)                             \
+    X(BG0CNT) X(BG1CNT) X(BG2CNT) X(BG3CNT)          \
+    X(BG0HOFS) X(BG0VOFS) X(BG1HOFS) X(BG1VOFS)      \
+    X(BG2HOFS) X(BG2VOFS) X(BG3HOFS) X(BG3VOFS)      \
+    X(BG2PA) X(BG2PB) X(BG2PC) X(BG2PD)              \
+    X(BG2X_L) X(BG2X_H) X(BG2Y_L) X(BG2Y_H)          \
+    X(BG3PA) X(BG3PB) X(BG3PC) X(BG3PD)              \
+    X(BG3X_L) X(BG3X_H) X(BG3Y_L) X(BG3Y_H)          \
+    X(WIN0V) X(WIN1V) X(WININ) X(WINOUT)             \
+    X(MOSAIC) X(BLDMOD) X(COLEV) X(COLY)
+
+// At most one line per VCOUNT is queued before the frame is finished.
+constexpr int kQueuedLines = 160;
+
+// Room for the pages copied in a frame: the full copy it starts with and
+// about 200 VRAM pages of changes.
+constexpr size_t kArenaSize = 0x80000;
+constexpr int kMaxPatches = kArenaSize >> 7;
+
+constexpr int kRegionPages[kGfxRegions] = { 1, 0x18000 >> 11, SIZE_OAM >> 7 };
+
+static_assert(kRegionPages[kGfxPalette] << kGfxPageShift[kGfxPalette] == SIZE_PRAM, "palette pages");
+static_assert(kRegionPages[kGfxOam] << kGfxPageShift[kGfxOam] == SIZE_OAM, "OAM pages");
+static_assert(kRegionPages[kGfxVram] <= 64, "VRAM pages");
+
+// Pages of `region` stored to, the bits past its last page are ignored.
+uint64_t gfxDirtyPages(int region)
+{
+    const uint64_t pages = kRegionPages[region] == 64 ? ~uint64_t(0) : (uint64_t(1) << kRegionPages[region]) - 1;
+    return gbaCore.gfxThreadsDirty[region] & pages;
+}
+
+// A page copied when a line was queued.
+struct GfxPatch {
+    uint8_t region;
+    uint8_t page;
+    const uint8_t* memory;
+};
+
+struct GfxLine {
+#define GFX_DECLARE_REGISTER(name) uint16_t name;
+    GFX_LINE_REGISTERS(GFX_DECLARE_REGISTER)
+#undef GFX_DECLARE_REGISTER
+    uint16_t win0h;
+    uint16_t win1h;
+    int layerEnable;
+    int customBackdropColor;
+    int bg2Changed;
+    int bg3Changed;
+    int bg2X;
+    int bg2Y;
+    int bg3X;
+    int bg3Y;
+    int lastVCOUNT;
+    void (*render)();
+    uint8_t* pix;
+    LineWriterHashes* hashes;
+    // The patches up to this one bring the video memory to this line.
+    int patchesEnd;
+};
+
+}  // namespace
+
+struct GfxPool {
+    std::mutex mutex;
+    // Signalled when lines are queued or the pool shuts down.
+    std::condition_variable work;
+    // Signalled when the last queued line is drawn.
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+    bool quit = false;
+
+    GfxLine lines[kQueuedLines];
+    // Only the emulation thread changes `queued`, lines below it and their
+    // patches are complete and never modified until the frame is finished.
+    int queued = 0;
+    int claimed = 0;
+    int drawn = 0;
+    // Changes with every finished frame, tells the workers to start over
+    // with the patches.
+    uint32_t frame = 0;
+
+    GfxPatch patches[kMaxPatches];
+    int patchCount = 0;
+    std::unique_ptr<uint8_t[]> arena{ new uint8_t[kArenaSize] };
+    size_t arenaUsed = 0;
+    // Set when the arena ran out, the rest of the frame is drawn inline.
+    bool drawInline = false;
+
+    ~GfxPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        work.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+};
+
+void GfxPoolDeleter::operator()(GfxPool* pool) const
+{
+    delete pool;
+}
+
+namespace {
+
+uint8_t* gfxRegionMemory(int region)
+{
+    switch (region) {
+    case kGfxPalette:
+        return gbaCore.g_paletteRAM;
+    case kGfxVram:
+        return gbaCore.g_vram;
+    default:
+        return gbaCore.g_oam;
+    }
+}
+
+// Copies the dirty pages for the next queued line, unless they don't fit.
+bool gfxCopyDirtyPages(GfxPool& pool)
+{
+    size_t bytes = 0;
+    int patches = 0;
+    for (int region = 0; region < kGfxRegions; region++) {
+        for (uint64_t dirty = gfxDirtyPages(region); dirty; dirty &= dirty - 1) {
+            bytes += size_t(1) << kGfxPageShift[region];
+            patches++;
+        }
+    }
+    if (pool.arenaUsed + bytes > kArenaSize || pool.patchCount + patches > kMaxPatches)
+        return false;
+
+    for (int region = 0; region < kGfxRegions; region++) {
+        const uint8_t* source = gfxRegionMemory(region);
+        const size_t size = size_t(1) << kGfxPageShift[region];
+        const uint64_t dirty = gfxDirtyPages(region);
+        for (int page = 0; page < kRegionPages[region]; page++) {
+            if (!(dirty & (uint64_t(1) << page)))
+                continue;
+
+            uint8_t* memory = &pool.arena[pool.arenaUsed];
+            memcpy(memory, source + page * size, size);
+            pool.arenaUsed += size;
+            pool.patches[pool.patchCount++] = { uint8_t(region), uint8_t(page), memory };
+        }
+        gbaCore.gfxThreadsDirty[region] = 0;
+    }
+    return true;
+}
+
+// Runs on the worker, brings its copy of the video memory to the line
+// ending at `end` and invalidates what its caches hold of the pages.
+void gfxApplyPatches(const GfxPool& pool, int& applied, int end)
+{
+    for (; applied < end; applied++) {
+        const GfxPatch& patch = pool.patches[applied];
+        const uint32_t size = 1u << kGfxPageShift[patch.region];
+        const uint32_t offset = patch.page * size;
+        memcpy(gfxRegionMemory(patch.region) + offset, patch.memory, size);
+
+        if (patch.region == kGfxVram) {
+            for (uint32_t tile = offset; tile < offset + size; tile += 32)
+                gfxTileCacheInvalidate(tile);
+        } else if (patch.region == kGfxOam) {
+            for (uint32_t entry = offset; entry < offset + size; entry += 8)
+                gfxSpriteIndexInvalidate(entry);
+        }
+    }
+}
+
+// The renderers skip the disabled backgrounds, whose line buffers
+// CPUUpdateRenderBuffers() clears on the emulation thread. The workers have
+// to do the same with their own buffers. `cleared` has a bit per background
+// whose buffer is known to be clear.
+void gfxClearDisabledLayers(int layerEnable, int& cleared)
+{
+    uint32_t* const lines[4] = { gbaCore.g_line0, gbaCore.g_line1, gbaCore.g_line2, gbaCore.g_line3 };
+
+    for (int i = 0; i < 4; i++) {
+        const int bit = 1 << i;
+        if (layerEnable & (0x0100 << i)) {
+            cleared &= ~bit;
+        } else if (!(cleared & bit)) {
+            for (int x = 0; x < 240; x++)
+                lines[i][x] = 0x80000000;
+            cleared |= bit;
+        }
+    }
+}
+
+// Runs on the worker, whose core holds all the state below.
+void gfxDrawQueuedLine(const GfxLine& line, int& cleared)
+{
+#define GFX_RESTORE_REGISTER(name) gbaCore.name = line.name;
+    GFX_LINE_REGISTERS(GFX_RESTORE_REGISTER)
+#undef GFX_RESTORE_REGISTER
+
+    if (gbaCore.WIN0H != line.win0h) {
+        gbaCore.WIN0H = line.win0h;
+        CPUUpdateWindow0();
+    }
+    if (gbaCore.WIN1H != line.win1h) {
+        gbaCore.WIN1H = line.win1h;
+        CPUUpdateWindow1();
+    }
+
+    gbaCore.gfxLayerEnable = line.layerEnable;
+    gfxClearDisabledLayers(line.layerEnable, cleared);
+    gbaCore.customBackdropColor = line.customBackdropColor;
+    gbaCore.gfxBG2Changed = line.bg2Changed;
+    gbaCore.gfxBG3Changed = line.bg3Changed;
+    gbaCore.gfxBG2X = line.bg2X;
+    gbaCore.gfxBG2Y = line.bg2Y;
+    gbaCore.gfxBG3X = line.bg3X;
+    gbaCore.gfxBG3Y = line.bg3Y;
+    gbaCore.gfxLastVCOUNT = line.lastVCOUNT;
+
+    (*line.render)();
+    gfxWriteLine(line.pix, *line.hashes, line.VCOUNT);
+}
+
+void gfxWorkerLoop(GfxPool* pool)
+{
+    // Everything but the mirrored part of VRAM is patched, the renderers may
+    // still read past it and find zeroes there.
+    std::unique_ptr<uint8_t[]> paletteRAM(new uint8_t[SIZE_PRAM]());
+    std::unique_ptr<uint8_t[]> vram(new uint8_t[SIZE_VRAM]());
+    std::unique_ptr<uint8_t[]> oam(new uint8_t[SIZE_OAM]());
+    gbaCore.g_paletteRAM = paletteRAM.get();
+    gbaCore.g_vram = vram.get();
+    gbaCore.g_oam = oam.get();
+    gfxTileCacheFlush();
+    gfxSpriteIndexFlush();
+
+    // Frame and patches the worker's copy of the video memory is at.
+    uint32_t frame = 0;
+    int applied = 0;
+    int cleared = 0;
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    for (;;) {
+        pool->work.wait(lock, [pool] { return pool->quit || pool->claimed < pool->queued; });
+        if (pool->quit)
+            return;
+
+        const GfxLine& line = pool->lines[pool->claimed++];
+        if (frame != pool->frame) {
+            frame = pool->frame;
+            applied = 0;
+        }
+        lock.unlock();
+        gfxApplyPatches(*pool, applied, line.patchesEnd);
+        gfxDrawQueuedLine(line, cleared);
+        lock.lock();
+
+        if (++pool->drawn == pool->queued)
+            pool->done.notify_all();
+    }
+}
+
+void gfxWorker(GfxPool* pool)
+{
+    // The worker draws with a core of its own, of which only the renderer
+    // state is used.
+    GbaCore* core = gbaCoreCreate();
+    GbaCore* previous = gbaCoreSwitch(core);
+    gfxWorkerLoop(pool);
+    gbaCoreSwitch(previous);
+    gbaCoreDestroy(core);
+}
+
+GfxPool& gfxGetPool()
+{
+    if (!gbaCore.gfxPool) {
+        gbaCore.gfxPool.reset(new GfxPool());
+
+        // Leave a core to the emulation thread, a few workers are enough to
+        // keep up with it.
+        const unsigned cores = std::thread::hardware_concurrency();
+        const unsigned workers = std::min(std::max(cores, 2u) - 1, 4u);
+        for (unsigned i = 0; i < workers; i++)
+            gbaCore.gfxPool->workers.emplace_back(gfxWorker, gbaCore.gfxPool.get());
+    }
+    return *gbaCore.gfxPool;
+}
+
+}  // namespace
+
+void gfxThreadsQueueLine(void (*render)(), void (*skip)())
+{
+    GfxPool& pool = gfxGetPool();
+    if (pool.queued == kQueuedLines)
+        gfxThreadsFinish();
+
+    if (!pool.drawInline && !gfxCopyDirtyPages(pool)) {
+        gfxThreadsFinish();
+        pool.drawInline = true;
+    }
+    if (pool.drawInline) {
+        gbaCore.gfxLayerEnable = coreOptions.layerEnable;
+        (*render)();
+        gfxWriteLine(gbaCore.g_pix, gbaCore.g_lineWriterHashes, gbaCore.VCOUNT);
+        return;
+    }
+
+    GfxLine& line = pool.lines[pool.queued];
+#define GFX_SAVE_REGISTER(name) line.name = gbaCore.name;
+    GFX_LINE_REGISTERS(GFX_SAVE_REGISTER)
+#undef GFX_SAVE_REGISTER
+    line.win0h = gbaCore.WIN0H;
+    line.win1h = gbaCore.WIN1H;
+    line.layerEnable = coreOptions.layerEnable;
+    line.customBackdropColor = gbaCore.customBackdropColor;
+    line.bg2Changed = gbaCore.gfxBG2Changed;
+    line.bg3Changed = gbaCore.gfxBG3Changed;
+    line.bg2X = gbaCore.gfxBG2X;
+    line.bg2Y = gbaCore.gfxBG2Y;
+    line.bg3X = gbaCore.gfxBG3X;
+    line.bg3Y = gbaCore.gfxBG3Y;
+    line.lastVCOUNT = gbaCore.gfxLastVCOUNT;
+    line.render = render;
+    line.pix = gbaCore.g_pix;
+    line.hashes = &gbaCore.g_lineWriterHashes;
+    line.patchesEnd = pool.patchCount;
+
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.queued++;
+    }
+    pool.work.notify_one();
+
+    gbaCore.gfxLayerEnable = coreOptions.layerEnable;
+    (*skip)();
+}
+
+void gfxThreadsFinish()
+{
+    if (!gbaCore.gfxPool)
+        return;
+
+    GfxPool& pool = *gbaCore.gfxPool;
+    pool.drawInline = false;
+    if (pool.queued == 0)
+        return;
+
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.done.wait(lock, [&pool] { return pool.drawn == pool.queued; });
+    pool.queued = 0;
+    pool.claimed = 0;
+    pool.drawn = 0;
+    pool.frame++;
+
+    pool.patchCount = 0;
+    pool.arenaUsed = 0;
+    for (int region = 0; region < kGfxRegions; region++)
+        gbaCore.gfxThreadsDirty[region] = ~uint64_t(0);
+}
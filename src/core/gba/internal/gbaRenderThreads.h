@@ -0,0 +1,66 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBARENDERTHREADS_H_
+#define VBAM_CORE_GBA_INTERNAL_GBARENDERTHREADS_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaCore.h"
+
+// Scanline rendering on worker threads.
+//
+// With ENABLE_THREADED_RENDERER, CPULoop() no longer draws the visible lines
+// itself. For every line it records the PPU registers and the renderer
+// state carried over from the previous line, along with copies of the video
+// memory it changed, and queues the line for a pool of worker threads.
+// The workers draw the lines and store them in g_pix while the CPU goes on
+// with the next ones. gfxThreadsFinish() waits for them when entering VBlank,
+// before the frame is handed to the frontend, and when CPULoop() returns.
+//
+// Only the pages the CPU stored to since the previous line are copied, which
+// the stores report with gfxThreadsTouch(). Each line carries these pages as
+// patches, and every worker keeps its own copy of the palette, VRAM and OAM
+// that it brings up to date by applying the patches of all the lines queued
+// before the one it draws, invalidating only the cached tiles and sprites of
+// the pages they replace. Every frame starts with a full copy, so changes
+// made behind the CPU's back (save states, the debugger...) show up on the
+// next frame.
+//
+// The pages are copied to a fixed arena. A frame that writes so much to the
+// video memory that it runs out of room waits for the queued lines and draws
+// its remaining lines on the emulation thread, like without the workers.
+//
+// Each worker draws with a GbaCore of its own, whose renderer state (line
+// buffers, tile cache, sprite index...) is separate from the emulated one,
+// which is why the option requires ENABLE_REENTRANT_CORE. The pool belongs to
+// the core that queues the lines, and its workers are joined when that core
+// is destroyed.
+
+// log2 of the size of the pages the stores to each region are tracked by.
+static constexpr int kGfxPageShift[kGfxRegions] = { 10, 11, 7 };
+
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+// Queues the current line for `render`, then carries the renderer state over
+// to the next line with `skip`.
+void gfxThreadsQueueLine(void (*render)(), void (*skip)());
+
+// Waits until all the queued lines are in g_pix.
+void gfxThreadsFinish();
+
+// Calls gfxThreadsFinish() when leaving the scope.
+struct GfxThreadsScope {
+    ~GfxThreadsScope() { gfxThreadsFinish(); }
+};
+#endif  // VBAM_ENABLE_THREADED_RENDERER
+
+// Called on every CPU store to the palette, VRAM or OAM, `offset` is the
+// offset of the store in the region with mirrors already resolved.
+inline void gfxThreadsTouch(int region, uint32_t offset)
+{
+#ifdef VBAM_ENABLE_THREADED_RENDERER
+    gbaCore.gfxThreadsDirty[region] |= uint64_t(1) << (offset >> kGfxPageShift[region]);
+#else
+    (void)region;
+    (void)offset;
+#endif
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBARENDERTHREADS_H_
@@ -0,0 +1,118 @@
+#include "core/gba/internal/gbaScheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class GbaSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override { gbaSchedulerReset(); }
+    void TearDown() override { gbaSchedulerReset(); }
+};
+
+TEST_F(GbaSchedulerTest, NextEventIsTheEarliestDeadline)
+{
+    gbaSchedulerSchedule(kGbaEventLcd, 1008);
+    gbaSchedulerSchedule(kGbaEventTimer2, 300);
+    gbaSchedulerSchedule(kGbaEventTimer0, 500);
+    gbaSchedulerSchedule(kGbaEventIrq, 7);
+
+    EXPECT_EQ(gbaSchedulerNextEvent(), 7);
+    gbaSchedulerAdvance(7);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventIrq));
+    EXPECT_FALSE(gbaSchedulerPending(kGbaEventIrq));
+
+    EXPECT_EQ(gbaSchedulerNextEvent(), 293);
+    gbaSchedulerAdvance(293);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventTimer2));
+    EXPECT_EQ(gbaSchedulerNextEvent(), 200);
+}
+
+TEST_F(GbaSchedulerTest, TakesEveryLateEvent)
+{
+    gbaSchedulerSchedule(kGbaEventLcd, 224);
+    gbaSchedulerSchedule(kGbaEventTimer1, 100);
+    gbaSchedulerSchedule(kGbaEventTimer3, 1000);
+
+    gbaSchedulerAdvance(300);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventLcd) | gbaEventBit(kGbaEventTimer1));
+    EXPECT_EQ(gbaSchedulerTicksLeft(kGbaEventLcd), -76);
+    EXPECT_EQ(gbaSchedulerTicksLeft(kGbaEventTimer1), -200);
+    EXPECT_EQ(gbaSchedulerTakeDue(), 0u);
+}
+
+TEST_F(GbaSchedulerTest, RescheduleKeepsThePreviousDeadline)
+{
+    gbaSchedulerSchedule(kGbaEventLcd, 224);
+    gbaSchedulerSchedule(kGbaEventTimer0, 2000);
+
+    gbaSchedulerAdvance(230);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventLcd));
+    gbaSchedulerReschedule(kGbaEventLcd, 1008);
+    EXPECT_TRUE(gbaSchedulerPending(kGbaEventLcd));
+    EXPECT_EQ(gbaSchedulerNextEvent(), 1002);
+
+    // Postponing a pending event moves it behind the others.
+    gbaSchedulerReschedule(kGbaEventLcd, 1000);
+    EXPECT_EQ(gbaSchedulerNextEvent(), 1770);
+
+    // An event that is still late after the reload stays due.
+    gbaSchedulerSchedule(kGbaEventTimer1, 10);
+    gbaSchedulerAdvance(50);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventTimer1));
+    gbaSchedulerReschedule(kGbaEventTimer1, 16);
+    EXPECT_EQ(gbaSchedulerNextEvent(), -24);
+}
+
+TEST_F(GbaSchedulerTest, CancelRemovesTheEvent)
+{
+    gbaSchedulerSchedule(kGbaEventLcd, 1008);
+    gbaSchedulerSchedule(kGbaEventTimer0, 10);
+    gbaSchedulerSchedule(kGbaEventTimer1, 20);
+
+    gbaSchedulerCancel(kGbaEventTimer0);
+    EXPECT_FALSE(gbaSchedulerPending(kGbaEventTimer0));
+    EXPECT_EQ(gbaSchedulerNextEvent(), 20);
+
+    // Cancelling an event that is not scheduled does nothing.
+    gbaSchedulerCancel(kGbaEventTimer0);
+    gbaSchedulerCancel(kGbaEventIrq);
+    EXPECT_EQ(gbaSchedulerNextEvent(), 20);
+
+    gbaSchedulerAdvance(1008);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventLcd) | gbaEventBit(kGbaEventTimer1));
+}
+
+TEST_F(GbaSchedulerTest, DeferredEventsDoNotBoundTheSlice)
+{
+    gbaSchedulerSchedule(kGbaEventLcd, 1008);
+    gbaSchedulerSchedule(kGbaEventRtc, 100);
+
+    EXPECT_TRUE(gbaSchedulerPending(kGbaEventRtc));
+    EXPECT_EQ(gbaSchedulerNextEvent(), 1008);
+
+    gbaSchedulerAdvance(50);
+    EXPECT_EQ(gbaSchedulerTakeDue(), 0u);
+
+    // Only seen at the next boundary.
+    gbaSchedulerAdvance(958);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventLcd) | gbaEventBit(kGbaEventRtc));
+    EXPECT_FALSE(gbaSchedulerPending(kGbaEventRtc));
+}
+
+TEST_F(GbaSchedulerTest, DeadlinesSurviveClockWrap)
+{
+    gbaSchedulerAdvance(-100);
+    EXPECT_EQ(gbaSchedulerNow(), 0xFFFFFF9Cu);
+
+    gbaSchedulerSchedule(kGbaEventLcd, 1008);
+    gbaSchedulerSchedule(kGbaEventTimer0, 50);
+
+    EXPECT_EQ(gbaSchedulerNextEvent(), 50);
+    gbaSchedulerAdvance(200);
+    EXPECT_EQ(gbaSchedulerNow(), 100u);
+    EXPECT_EQ(gbaSchedulerTakeDue(), gbaEventBit(kGbaEventTimer0));
+    EXPECT_EQ(gbaSchedulerNextEvent(), 808);
+}
+
+}  // namespace
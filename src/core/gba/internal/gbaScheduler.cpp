@@ -0,0 +1,133 @@
+#include "core/gba/internal/gbaScheduler.h"
+
+namespace {
+
+constexpr uint32_t kGbaEventBoundaryMask = (1u << kGbaEventBoundaryCount) - 1;
+
+bool isBoundary(GbaEvent event)
+{
+    return (gbaEventBit(event) & kGbaEventBoundaryMask) != 0;
+}
+
+bool heapBefore(uint32_t a, uint32_t b)
+{
+    return gbaSchedulerTicksLeft((GbaEvent)gbaCore.gbaSchedulerHeap[a]) < gbaSchedulerTicksLeft((GbaEvent)gbaCore.gbaSchedulerHeap[b]);
+}
+
+void heapSwap(uint32_t a, uint32_t b)
+{
+    uint8_t event = gbaCore.gbaSchedulerHeap[a];
+    gbaCore.gbaSchedulerHeap[a] = gbaCore.gbaSchedulerHeap[b];
+    gbaCore.gbaSchedulerHeap[b] = event;
+    gbaCore.gbaSchedulerHeapSlot[gbaCore.gbaSchedulerHeap[a]] = a;
+    gbaCore.gbaSchedulerHeapSlot[gbaCore.gbaSchedulerHeap[b]] = b;
+}
+
+void heapSiftUp(uint32_t slot)
+{
+    while (slot > 0) {
+        uint32_t parent = (slot - 1) / 2;
+        if (!heapBefore(slot, parent))
+            break;
+        heapSwap(slot, parent);
+        slot = parent;
+    }
+}
+
+void heapSiftDown(uint32_t slot)
+{
+    for (;;) {
+        uint32_t first = slot;
+        uint32_t left = slot * 2 + 1;
+        uint32_t right = left + 1;
+        if (left < gbaCore.gbaSchedulerHeapSize && heapBefore(left, first))
+            first = left;
+        if (right < gbaCore.gbaSchedulerHeapSize && heapBefore(right, first))
+            first = right;
+        if (first == slot)
+            break;
+        heapSwap(slot, first);
+        slot = first;
+    }
+}
+
+void heapRemove(uint32_t slot)
+{
+    gbaCore.gbaSchedulerHeapSize--;
+    if (slot == gbaCore.gbaSchedulerHeapSize)
+        return;
+    gbaCore.gbaSchedulerHeap[slot] = gbaCore.gbaSchedulerHeap[gbaCore.gbaSchedulerHeapSize];
+    gbaCore.gbaSchedulerHeapSlot[gbaCore.gbaSchedulerHeap[slot]] = slot;
+    heapSiftDown(slot);
+    heapSiftUp(slot);
+}
+
+// Puts `event` at its current deadline.
+void schedulerInsert(GbaEvent event)
+{
+    if (!isBoundary(event)) {
+        gbaCore.gbaSchedulerPendingMask |= gbaEventBit(event);
+        return;
+    }
+
+    if (gbaSchedulerPending(event)) {
+        heapSiftDown(gbaCore.gbaSchedulerHeapSlot[event]);
+        heapSiftUp(gbaCore.gbaSchedulerHeapSlot[event]);
+        return;
+    }
+
+    gbaCore.gbaSchedulerPendingMask |= gbaEventBit(event);
+    gbaCore.gbaSchedulerHeap[gbaCore.gbaSchedulerHeapSize] = event;
+    gbaCore.gbaSchedulerHeapSlot[event] = gbaCore.gbaSchedulerHeapSize;
+    gbaCore.gbaSchedulerHeapSize++;
+    heapSiftUp(gbaCore.gbaSchedulerHeapSize - 1);
+}
+
+}  // namespace
+
+void gbaSchedulerReset()
+{
+    gbaCore.gbaSchedulerTime = 0;
+    gbaCore.gbaSchedulerPendingMask = 0;
+    gbaCore.gbaSchedulerHeapSize = 0;
+}
+
+void gbaSchedulerSchedule(GbaEvent event, int ticks)
+{
+    gbaCore.gbaSchedulerDeadline[event] = gbaCore.gbaSchedulerTime + (uint32_t)ticks;
+    schedulerInsert(event);
+}
+
+void gbaSchedulerReschedule(GbaEvent event, int ticks)
+{
+    gbaCore.gbaSchedulerDeadline[event] += (uint32_t)ticks;
+    schedulerInsert(event);
+}
+
+void gbaSchedulerCancel(GbaEvent event)
+{
+    if (!gbaSchedulerPending(event))
+        return;
+
+    gbaCore.gbaSchedulerPendingMask &= ~gbaEventBit(event);
+    if (isBoundary(event))
+        heapRemove(gbaCore.gbaSchedulerHeapSlot[event]);
+}
+
+uint32_t gbaSchedulerTakeDue()
+{
+    uint32_t due = 0;
+
+    while (gbaCore.gbaSchedulerHeapSize > 0 && gbaSchedulerNextEvent() <= 0) {
+        due |= gbaEventBit((GbaEvent)gbaCore.gbaSchedulerHeap[0]);
+        heapRemove(0);
+    }
+
+    for (uint32_t event = kGbaEventBoundaryCount; event < kGbaEventCount; event++) {
+        if (gbaSchedulerPending((GbaEvent)event) && gbaSchedulerTicksLeft((GbaEvent)event) <= 0)
+            due |= gbaEventBit((GbaEvent)event);
+    }
+
+    gbaCore.gbaSchedulerPendingMask &= ~due;
+    return due;
+}
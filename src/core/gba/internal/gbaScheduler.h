@@ -0,0 +1,69 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBASCHEDULER_H_
+#define VBAM_CORE_GBA_INTERNAL_GBASCHEDULER_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaCore.h"
+
+// Hardware event scheduler for the GBA CPU loop.
+//
+// Every event has an absolute deadline on a free running 32-bit cycle clock.
+// The clock only moves when the CPU loop reaches an event boundary, so between
+// two boundaries `gbaSchedulerTicksLeft()` is the same countdown the hardware
+// registers are derived from. Deadlines are compared with wrapping signed
+// differences and may be in the past: an event that is already late is simply
+// due at the next boundary.
+//
+// Boundary events live in a binary min-heap and bound the CPU slices through
+// `gbaSchedulerNextEvent()`. Deferred events are only checked when a boundary
+// is reached, so they never add slices of their own.
+
+static constexpr uint32_t gbaEventBit(GbaEvent event)
+{
+    return 1u << event;
+}
+
+// Cancels all events and restarts the clock at 0.
+void gbaSchedulerReset();
+
+// Schedules `event` `ticks` cycles from now, replacing any pending deadline.
+void gbaSchedulerSchedule(GbaEvent event, int ticks);
+
+// Schedules `event` `ticks` cycles after its previous deadline, whether it is
+// still pending or was just returned by `gbaSchedulerTakeDue()`.
+void gbaSchedulerReschedule(GbaEvent event, int ticks);
+
+void gbaSchedulerCancel(GbaEvent event);
+
+// Removes every event whose deadline has been reached and returns them as a
+// mask of `gbaEventBit()`s.
+uint32_t gbaSchedulerTakeDue();
+
+static inline bool gbaSchedulerPending(GbaEvent event)
+{
+    return (gbaCore.gbaSchedulerPendingMask & gbaEventBit(event)) != 0;
+}
+
+// Cycles from now to the deadline of `event`, negative when it is late.
+static inline int gbaSchedulerTicksLeft(GbaEvent event)
+{
+    return (int32_t)(gbaCore.gbaSchedulerDeadline[event] - gbaCore.gbaSchedulerTime);
+}
+
+// Cycles from now to the earliest boundary event. There must be one.
+static inline int gbaSchedulerNextEvent()
+{
+    return gbaSchedulerTicksLeft((GbaEvent)gbaCore.gbaSchedulerHeap[0]);
+}
+
+static inline uint32_t gbaSchedulerNow()
+{
+    return gbaCore.gbaSchedulerTime;
+}
+
+static inline void gbaSchedulerAdvance(int ticks)
+{
+    gbaCore.gbaSchedulerTime += (uint32_t)ticks;
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBASCHEDULER_H_
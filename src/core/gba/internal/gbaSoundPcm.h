@@ -0,0 +1,66 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBASOUNDPCM_H_
+#define VBAM_CORE_GBA_INTERNAL_GBASOUNDPCM_H_
+
+#include <cstdint>
+
+#include "core/apu/Blip_Buffer.h"
+#include "core/apu/Gb_Apu.h"
+
+// Direct sound channels of the GBA APU, only exposed for the GbaCore members.
+
+int const SOUND_CLOCK_TICKS_ = 280896; // ~1074 samples per frame
+
+class Gba_Pcm {
+public:
+    void init();
+    void apply_control(int idx);
+    void update(int dac);
+    void flush();
+    void end_frame(blip_time_t);
+
+private:
+    Blip_Buffer* output;
+    blip_time_t last_time;
+    int last_amp;
+    int shift;
+
+    // Samples played since the last flush(), synthesized together
+    enum { pending_max = 256 };
+    struct {
+        blip_time_t time;
+        int dac;
+    } pending[pending_max];
+    int pending_count;
+};
+
+class Gba_Pcm_Fifo {
+public:
+    int which;
+    Gba_Pcm pcm;
+
+    void write_control(int data);
+    void write_fifo(int data);
+    void timer_overflowed(int which_timer);
+
+    // public only so save state routines can access it
+    int readIndex;
+    int count;
+    int writeIndex;
+    uint8_t fifo[32];
+    int dac;
+
+private:
+    int timer;
+    bool enabled;
+};
+
+// Sound state that is only transferred through save states.
+struct Gba_Sound_State {
+    gb_apu_state_t apu;
+
+    // old state
+    uint8_t soundDSAValue;
+    int soundDSBValue;
+};
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBASOUNDPCM_H_
@@ -0,0 +1,111 @@
+#include "core/gba/internal/gbaSpriteIndex.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "core/base/port.h"
+#include "core/gba/gbaGlobals.h"
+
+namespace {
+
+class GbaSpriteIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        gbaCore.g_oam = (uint8_t*)calloc(1, 0x400);
+        // Hide everything below the screen, like games do.
+        for (int i = 0; i < kSpriteCount; i++)
+            SetAttribute(i, 0, 160);
+        gfxSpriteIndexFlush();
+    }
+
+    void TearDown() override
+    {
+        free(gbaCore.g_oam);
+        gbaCore.g_oam = nullptr;
+        gfxSpriteIndexFlush();
+    }
+
+    void SetAttribute(int sprite, int attribute, uint16_t value)
+    {
+        const uint32_t address = 0x07000000 + sprite * 8 + attribute * 2;
+        gfxSpriteIndexInvalidate(address);
+        WRITE16LE(&((uint16_t*)gbaCore.g_oam)[(address & 0x3FF) >> 1], value);
+    }
+
+    bool Covers(int sprite, int line)
+    {
+        const uint32_t* mask = gfxSpriteLine(line);
+        return (mask[sprite >> 5] >> (sprite & 31)) & 1;
+    }
+};
+
+TEST_F(GbaSpriteIndexTest, CoversSpriteLines)
+{
+    // 16x32 sprite at line 40.
+    SetAttribute(5, 0, 0x8000 | 40);
+    SetAttribute(5, 1, 0x8000);
+
+    EXPECT_FALSE(Covers(5, 39));
+    EXPECT_TRUE(Covers(5, 40));
+    EXPECT_TRUE(Covers(5, 71));
+    EXPECT_FALSE(Covers(5, 72));
+    EXPECT_EQ(gbaCore.gfxSprites[5].sizeX, 16);
+    EXPECT_EQ(gbaCore.gfxSprites[5].sizeY, 32);
+}
+
+TEST_F(GbaSpriteIndexTest, WrapsAroundLine256)
+{
+    // 64x64 sprite starting 16 lines above the screen.
+    SetAttribute(0, 0, 240);
+    SetAttribute(0, 1, 0xC000);
+
+    EXPECT_TRUE(Covers(0, 0));
+    EXPECT_TRUE(Covers(0, 47));
+    EXPECT_FALSE(Covers(0, 48));
+}
+
+TEST_F(GbaSpriteIndexTest, DoubleSizeAffineSprites)
+{
+    SetAttribute(1, 0, 0x0300 | 100);
+
+    EXPECT_TRUE(Covers(1, 115));
+    EXPECT_FALSE(Covers(1, 116));
+}
+
+TEST_F(GbaSpriteIndexTest, SkipsDisabledSprites)
+{
+    SetAttribute(2, 0, 0x0200 | 10);
+    EXPECT_FALSE(Covers(2, 10));
+
+    // Disabled OBJ window sprites still use up OBJ cycles.
+    SetAttribute(2, 0, 0x0A00 | 10);
+    EXPECT_TRUE(Covers(2, 10));
+}
+
+TEST_F(GbaSpriteIndexTest, TracksOamWrites)
+{
+    SetAttribute(127, 0, 20);
+    EXPECT_TRUE(Covers(127, 20));
+
+    SetAttribute(127, 0, 30);
+    EXPECT_FALSE(Covers(127, 20));
+    EXPECT_TRUE(Covers(127, 30));
+
+    // Writes behind the CPU's back need a flush.
+    WRITE16LE((uint16_t*)&gbaCore.g_oam[127 * 8], 50);
+    gfxSpriteIndexFlush();
+    EXPECT_FALSE(Covers(127, 30));
+    EXPECT_TRUE(Covers(127, 50));
+}
+
+TEST_F(GbaSpriteIndexTest, VisitsEverySpriteOffScreen)
+{
+    EXPECT_TRUE(Covers(3, 200));
+    EXPECT_EQ(gfxSpriteFind(gfxSpriteLine(200), 0), 0);
+    EXPECT_EQ(gfxSpriteFind(gfxSpriteLine(100), 0), kSpriteCount);
+}
+
+}  // namespace
@@ -0,0 +1,99 @@
+#include "core/gba/internal/gbaSpriteIndex.h"
+
+#include "core/base/port.h"
+#include "core/gba/gbaGlobals.h"
+
+namespace {
+
+void gfxSpriteDecode(int index, GfxSprite& sprite)
+{
+    const uint16_t* attributes = &((const uint16_t*)gbaCore.g_oam)[index << 2];
+    uint16_t a0 = READ16LE(&attributes[0]);
+    uint16_t a1 = READ16LE(&attributes[1]);
+
+    if ((a0 & 0x0c00) == 0x0c00)
+        a0 &= 0xF3FF;
+
+    if ((a0 >> 14) == 3) {
+        a0 &= 0x3FFF;
+        a1 &= 0x3FFF;
+    }
+
+    int sizeX = 8 << (a1 >> 14);
+    int sizeY = sizeX;
+
+    if ((a0 >> 14) & 1) {
+        if (sizeX < 32)
+            sizeX <<= 1;
+        if (sizeY > 8)
+            sizeY >>= 1;
+    } else if ((a0 >> 14) & 2) {
+        if (sizeX > 8)
+            sizeX >>= 1;
+        if (sizeY < 32)
+            sizeY <<= 1;
+    }
+
+    sprite.a0 = a0;
+    sprite.a1 = a1;
+    sprite.a2 = READ16LE(&attributes[2]);
+    sprite.sizeX = (uint8_t)sizeX;
+    sprite.sizeY = (uint8_t)sizeY;
+    sprite.top = 0;
+    sprite.bottom = 0;
+
+    // Disabled entries are never drawn, but OBJ window entries still use up
+    // OBJ cycles when their disable bit is set.
+    if ((a0 & 0x0300) == 0x0200 && (a0 & 0x0c00) != 0x0800)
+        return;
+
+    // Same extent and wrap around as in the renderers, double size affine
+    // entries cover twice as many lines.
+    int height = sizeY;
+    if ((a0 & 0x0300) == 0x0300)
+        height <<= 1;
+    int sy = a0 & 255;
+    if ((sy + height) > 256)
+        sy -= 256;
+
+    int top = sy < 0 ? 0 : sy;
+    int bottom = sy + height > kSpriteLines ? kSpriteLines : sy + height;
+    if (top < bottom) {
+        sprite.top = (uint8_t)top;
+        sprite.bottom = (uint8_t)bottom;
+    }
+}
+
+}  // namespace
+
+void gfxSpriteIndexFlush()
+{
+    for (int i = 0; i < kSpriteCount / 32; i++)
+        gbaCore.gfxSpriteDirty[i] = ~0u;
+    gbaCore.gfxSpriteIndexDirty = true;
+}
+
+void gfxSpriteIndexUpdate()
+{
+    for (int word = 0; word < kSpriteCount / 32; word++) {
+        uint32_t dirty = gbaCore.gfxSpriteDirty[word];
+        gbaCore.gfxSpriteDirty[word] = 0;
+
+        while (dirty) {
+            const int bit = gfxSpriteNext(dirty);
+            dirty &= dirty - 1;
+
+            const uint32_t mask = 1u << bit;
+            GfxSprite& sprite = gbaCore.gfxSprites[(word << 5) + bit];
+
+            for (int line = sprite.top; line < sprite.bottom; line++)
+                gbaCore.gfxSpriteLines[line][word] &= ~mask;
+
+            gfxSpriteDecode((word << 5) + bit, sprite);
+
+            for (int line = sprite.top; line < sprite.bottom; line++)
+                gbaCore.gfxSpriteLines[line][word] |= mask;
+        }
+    }
+    gbaCore.gfxSpriteIndexDirty = false;
+}
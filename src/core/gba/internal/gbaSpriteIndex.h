@@ -0,0 +1,82 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBASPRITEINDEX_H_
+#define VBAM_CORE_GBA_INTERNAL_GBASPRITEINDEX_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaCore.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif  // defined(_MSC_VER)
+
+// Per-scanline index of the OAM entries for the OBJ renderers.
+//
+// gfxDrawSprites() and gfxDrawOBJWin() used to decode all 128 OAM entries
+// on every line only to reject most of them. The index keeps the decoded
+// attributes of every entry and, for each visible line, a bit mask of the
+// entries whose vertical extent covers it, so that the renderers only visit
+// those, still in OAM order.
+//
+// Only OAM attributes 0-2 decide which lines an entry covers. DISPCNT,
+// MOSAIC and the layer settings are still applied by the renderers, so
+// writes to them don't touch the index. CPU writes to OAM mark the written
+// entry dirty, and anything that rewrites OAM behind the CPU's back (save
+// states, BIOS HLE, the debugger...) must call gfxSpriteIndexFlush(). Dirty
+// entries are re-indexed before the next line is drawn.
+
+void gfxSpriteIndexFlush();
+void gfxSpriteIndexUpdate();
+
+// Called on every CPU write to OAM, marks the entry holding `address` dirty.
+inline void gfxSpriteIndexInvalidate(uint32_t address)
+{
+    // attribute 3 only holds the rotation/scaling parameters, which are read
+    // straight from OAM
+    if ((address & 6) == 6)
+        return;
+
+    const uint32_t entry = (address & 0x3FF) >> 3;
+    gbaCore.gfxSpriteDirty[entry >> 5] |= 1u << (entry & 31);
+    gbaCore.gfxSpriteIndexDirty = true;
+}
+
+// Returns the mask of the OAM entries to visit on `line`, entry 0 in bit 0
+// of the first word.
+inline const uint32_t* gfxSpriteLine(int line)
+{
+    static const uint32_t kAllSprites[kSpriteCount / 32] = { ~0u, ~0u, ~0u, ~0u };
+
+    if (gbaCore.gfxSpriteIndexDirty)
+        gfxSpriteIndexUpdate();
+    if (line < 0 || line >= kSpriteLines)
+        return kAllSprites;
+    return gbaCore.gfxSpriteLines[line];
+}
+
+// Index of the lowest set bit of a non-zero mask.
+inline int gfxSpriteNext(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Returns the first entry from `from` on set in the mask returned by
+// gfxSpriteLine(), or kSpriteCount if there is none.
+inline int gfxSpriteFind(const uint32_t* line, int from)
+{
+    for (int word = from >> 5; word < kSpriteCount / 32; word++) {
+        uint32_t bits = line[word];
+        if (word == from >> 5)
+            bits &= ~0u << (from & 31);
+        if (bits)
+            return (word << 5) + gfxSpriteNext(bits);
+    }
+    return kSpriteCount;
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBASPRITEINDEX_H_
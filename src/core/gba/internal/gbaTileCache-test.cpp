@@ -0,0 +1,63 @@
+#include "core/gba/internal/gbaTileCache.h"
+
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include "core/gba/gbaGlobals.h"
+
+namespace {
+
+class GbaTileCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        gbaCore.g_vram = (uint8_t*)calloc(1, 0x20000);
+        gfxTileCacheFlush();
+    }
+
+    void TearDown() override
+    {
+        free(gbaCore.g_vram);
+        gbaCore.g_vram = nullptr;
+        gfxTileCacheFlush();
+    }
+
+    void Write(uint32_t offset, uint8_t value)
+    {
+        gfxTileCacheInvalidate(offset);
+        gbaCore.g_vram[offset] = value;
+    }
+};
+
+TEST_F(GbaTileCacheTest, DecodesLowNibbleFirst)
+{
+    Write(0x4020 + 9, 0x5A);
+
+    const uint8_t* row = gfxTileRow4(0x4020, 2);
+    EXPECT_EQ(row[2], 0x0A);
+    EXPECT_EQ(row[3], 0x05);
+    EXPECT_EQ(row[0], 0);
+}
+
+TEST_F(GbaTileCacheTest, TracksVramWrites)
+{
+    EXPECT_EQ(gfxTileRow4(0x20, 0)[0], 0);
+
+    Write(0x20, 0x03);
+    EXPECT_EQ(gfxTileRow4(0x20, 0)[0], 3);
+
+    // Writes behind the CPU's back need a flush.
+    gbaCore.g_vram[0x20] = 0x07;
+    gfxTileCacheFlush();
+    EXPECT_EQ(gfxTileRow4(0x20, 0)[0], 7);
+}
+
+TEST_F(GbaTileCacheTest, IgnoresObjVram)
+{
+    gfxTileRow4(0, 0);
+    Write(0x10000, 0x11);
+    EXPECT_EQ(gbaCore.gfxTileDirty[0] & 1u, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,23 @@
+#include "core/gba/internal/gbaTileCache.h"
+
+#include "core/gba/gbaGlobals.h"
+
+void gfxTileCacheFlush()
+{
+    for (int i = 0; i < kTileCacheTiles / 32; i++)
+        gbaCore.gfxTileDirty[i] = ~0u;
+}
+
+void gfxTileCacheDecode(int tile)
+{
+    const uint8_t* source = &gbaCore.g_vram[tile << 5];
+    uint8_t* pixels = gbaCore.gfxTileCache[tile];
+
+    // low nibble first
+    for (int i = 0; i < 32; i++) {
+        pixels[i * 2] = source[i] & 0x0F;
+        pixels[i * 2 + 1] = source[i] >> 4;
+    }
+
+    gbaCore.gfxTileDirty[tile >> 5] &= ~(1u << (tile & 31));
+}
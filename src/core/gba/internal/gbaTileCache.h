@@ -0,0 +1,45 @@
+#ifndef VBAM_CORE_GBA_INTERNAL_GBATILECACHE_H_
+#define VBAM_CORE_GBA_INTERNAL_GBATILECACHE_H_
+
+#include <cstdint>
+
+#include "core/gba/gbaCore.h"
+
+// Decoded 4bpp tiles for the text background renderer.
+//
+// Every 32-byte 4bpp tile of the BG VRAM is expanded to one byte per pixel
+// the first time it is drawn, so that gfxDrawTextScreen() can render a whole
+// tile row without extracting nibbles. 8bpp tiles already use one byte per
+// pixel and are read straight from VRAM. Flipped tiles are drawn by
+// reversing the row or the pixel index, so no flipped copies are kept.
+//
+// CPU writes to the BG VRAM mark the written tile dirty, which is why those
+// pages are left out of the page table for stores. Anything that rewrites
+// VRAM behind the CPU's back (save states, BIOS HLE, the debugger...) must
+// call gfxTileCacheFlush().
+
+void gfxTileCacheFlush();
+void gfxTileCacheDecode(int tile);
+
+// Called on every CPU write to VRAM, `offset` is the VRAM offset of the
+// store with mirrors already resolved.
+inline void gfxTileCacheInvalidate(uint32_t offset)
+{
+    if (offset >= kTileCacheSize)
+        return;
+
+    const uint32_t tile = offset >> 5;
+    gbaCore.gfxTileDirty[tile >> 5] |= 1u << (tile & 31);
+}
+
+// Returns the 8 pixels of `row` of the 4bpp tile at VRAM `offset`, which
+// must be below kTileCacheSize.
+inline const uint8_t* gfxTileRow4(uint32_t offset, int row)
+{
+    const uint32_t tile = offset >> 5;
+    if (gbaCore.gfxTileDirty[tile >> 5] & (1u << (tile & 31)))
+        gfxTileCacheDecode(tile);
+    return &gbaCore.gfxTileCache[tile][row << 3];
+}
+
+#endif  // VBAM_CORE_GBA_INTERNAL_GBATILECACHE_H_
@@ -93,3 +93,5 @@ int systemSaveUpdateCounter;
 int systemSpeed;
 
 int emulating = 0;
+
+struct CoreOptions coreOptions;
@@ -14,6 +14,7 @@
 #include "core/base/check.h"
 #include "core/base/system.h"
 #include "core/base/file_util.h"
+#include "core/base/line_writer.h"
 #include "core/base/sizes.h"
 #include "core/gb/gb.h"
 #include "core/gb/gbCheats.h"
@@ -319,15 +320,15 @@ void* retro_get_memory_data(unsigned id)
         switch (id) {
         case RETRO_MEMORY_SAVE_RAM:
             if ((coreOptions.saveType == GBA_SAVE_EEPROM) | (coreOptions.saveType == GBA_SAVE_EEPROM_SENSOR))
-                data =  eepromData;
+                data =  gbaCore.eepromData;
             else if ((coreOptions.saveType == GBA_SAVE_SRAM) | (coreOptions.saveType == GBA_SAVE_FLASH))
-                data = flashSaveMemory;
+                data = gbaCore.flashSaveMemory;
             break;
         case RETRO_MEMORY_SYSTEM_RAM:
-            data = g_workRAM;
+            data = gbaCore.g_workRAM;
             break;
         case RETRO_MEMORY_VIDEO_RAM:
-            data = g_vram;
+            data = gbaCore.g_vram;
             break;
         }
         break;
@@ -365,9 +366,9 @@ size_t retro_get_memory_size(unsigned id)
         switch (id) {
         case RETRO_MEMORY_SAVE_RAM:
             if ((coreOptions.saveType == GBA_SAVE_EEPROM) | (coreOptions.saveType == GBA_SAVE_EEPROM_SENSOR))
-                size = eepromSize;
+                size = gbaCore.eepromSize;
             else if (coreOptions.saveType == GBA_SAVE_FLASH)
-                size = g_flashSize;
+                size = gbaCore.g_flashSize;
             else if (coreOptions.saveType == GBA_SAVE_SRAM)
                 size = SIZE_SRAM;
             break;
@@ -803,11 +804,11 @@ static void load_image_preferences(void)
     bool hasRumble = false;
     char buffer[12 + 1];
     unsigned i = 0, found_no = 0;
-    unsigned long romCrc32 = crc32(0, g_rom, romSize);
+    unsigned long romCrc32 = crc32(0, gbaCore.g_rom, romSize);
 
     coreOptions.cpuSaveType = GBA_SAVE_AUTO;
-    g_flashSize = SIZE_FLASH512;
-    eepromSize = SIZE_EEPROM_512;
+    gbaCore.g_flashSize = SIZE_FLASH512;
+    gbaCore.eepromSize = SIZE_EEPROM_512;
     coreOptions.rtcEnabled = false;
     coreOptions.mirroringEnable = false;
 
@@ -815,18 +816,18 @@ static void load_image_preferences(void)
 
     buffer[0] = 0;
     for (i = 0; i < 12; i++) {
-        if (g_rom[0xa0 + i] == 0)
+        if (gbaCore.g_rom[0xa0 + i] == 0)
             break;
-        buffer[i] = g_rom[0xa0 + i];
+        buffer[i] = gbaCore.g_rom[0xa0 + i];
     }
 
     buffer[i] = 0;
     log("Game Title      : %s\n", buffer);
 
-    buffer[0] = g_rom[0xac];
-    buffer[1] = g_rom[0xad];
-    buffer[2] = g_rom[0xae];
-    buffer[3] = g_rom[0xaf];
+    buffer[0] = gbaCore.g_rom[0xac];
+    buffer[1] = gbaCore.g_rom[0xad];
+    buffer[2] = gbaCore.g_rom[0xae];
+    buffer[3] = gbaCore.g_rom[0xaf];
     buffer[4] = 0;
     log("Game Code       : %s\n", buffer);
 
@@ -846,11 +847,11 @@ static void load_image_preferences(void)
 
         unsigned size = gbaover[found_no].saveSize;
         if (coreOptions.cpuSaveType == GBA_SAVE_SRAM)
-            g_flashSize = SIZE_SRAM;
+            gbaCore.g_flashSize = SIZE_SRAM;
         else if (coreOptions.cpuSaveType == GBA_SAVE_FLASH)
-            g_flashSize = (size == SIZE_FLASH1M) ? SIZE_FLASH1M : SIZE_FLASH512;
+            gbaCore.g_flashSize = (size == SIZE_FLASH1M) ? SIZE_FLASH1M : SIZE_FLASH512;
         else if ((coreOptions.cpuSaveType == GBA_SAVE_EEPROM) || (coreOptions.cpuSaveType == GBA_SAVE_EEPROM_SENSOR))
-            eepromSize = (size == SIZE_EEPROM_8K) ? SIZE_EEPROM_8K : SIZE_EEPROM_512;
+            gbaCore.eepromSize = (size == SIZE_EEPROM_8K) ? SIZE_EEPROM_8K : SIZE_EEPROM_512;
     }
 
     // gameID that starts with 'F' are classic/famicom games
@@ -861,8 +862,8 @@ static void load_image_preferences(void)
 
     coreOptions.saveType = coreOptions.cpuSaveType;
 
-    if (g_flashSize == SIZE_FLASH512 || g_flashSize == SIZE_FLASH1M)
-        flashSetSize(g_flashSize);
+    if (gbaCore.g_flashSize == SIZE_FLASH512 || gbaCore.g_flashSize == SIZE_FLASH1M)
+        flashSetSize(gbaCore.g_flashSize);
 
     if (option_forceRTCenable)
         coreOptions.rtcEnabled = true;
@@ -881,9 +882,9 @@ static void load_image_preferences(void)
     log("has RTC         : %s.\n", coreOptions.rtcEnabled ? "Yes" : "No");
     log("cpuSaveType     : %s.\n", savetype[coreOptions.cpuSaveType]);
     if (coreOptions.cpuSaveType == 3)
-        log("g_flashSize       : %d.\n", g_flashSize);
+        log("g_flashSize       : %d.\n", gbaCore.g_flashSize);
     else if (coreOptions.cpuSaveType == 1)
-        log("eepromSize      : %d.\n", eepromSize);
+        log("eepromSize      : %d.\n", gbaCore.eepromSize);
     log("mirroringEnable : %s.\n", coreOptions.mirroringEnable ? "Yes" : "No");
 }
 
@@ -1030,7 +1031,7 @@ static void update_variables(bool startup)
     }
 
     coreOptions.layerSettings = 0xFF00 ^ disabled_layers;
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 
     strcpy(key, "vbam_sound_x");
@@ -1069,8 +1070,8 @@ static void update_variables(bool startup)
     }
 
     if (sound_changed) {
-        g_gbaSoundInterpolation = option_sndInterpolation;
-        soundFiltering          = option_sndFiltering;
+        gbaCore.g_gbaSoundInterpolation = option_sndInterpolation;
+        gbaCore.soundFiltering          = option_sndFiltering;
     }
 
     var.key = "vbam_usebios";
@@ -1628,22 +1629,22 @@ bool retro_load_game(const struct retro_game_info *game)
       struct retro_memory_descriptor desc[11];
       memset(desc, 0, sizeof(desc));
 
-      desc[0].start=0x03000000; desc[0].select=0xFF000000; desc[0].len=0x8000;    desc[0].ptr=g_internalRAM;//fast WRAM
-      desc[1].start=0x02000000; desc[1].select=0xFF000000; desc[1].len=0x40000;   desc[1].ptr=g_workRAM;//slow WRAM
+      desc[0].start=0x03000000; desc[0].select=0xFF000000; desc[0].len=0x8000;    desc[0].ptr=gbaCore.g_internalRAM;//fast WRAM
+      desc[1].start=0x02000000; desc[1].select=0xFF000000; desc[1].len=0x40000;   desc[1].ptr=gbaCore.g_workRAM;//slow WRAM
       /* TODO: if SRAM is flash, use start=0 addrspace="S" instead */
-      desc[2].start=0x0E000000; desc[2].select=0;          desc[2].len=g_flashSize; desc[2].ptr=flashSaveMemory;//SRAM
-      desc[3].start=0x08000000; desc[3].select=0;          desc[3].len=romSize;   desc[3].ptr=g_rom;//ROM
+      desc[2].start=0x0E000000; desc[2].select=0;          desc[2].len=gbaCore.g_flashSize; desc[2].ptr=gbaCore.flashSaveMemory;//SRAM
+      desc[3].start=0x08000000; desc[3].select=0;          desc[3].len=romSize;   desc[3].ptr=gbaCore.g_rom;//ROM
       desc[3].flags=RETRO_MEMDESC_CONST;
-      desc[4].start=0x0A000000; desc[4].select=0;          desc[4].len=romSize;   desc[4].ptr=g_rom;//ROM mirror 1
+      desc[4].start=0x0A000000; desc[4].select=0;          desc[4].len=romSize;   desc[4].ptr=gbaCore.g_rom;//ROM mirror 1
       desc[4].flags=RETRO_MEMDESC_CONST;
-      desc[5].start=0x0C000000; desc[5].select=0;          desc[5].len=romSize;   desc[5].ptr=g_rom;//ROM mirror 2
+      desc[5].start=0x0C000000; desc[5].select=0;          desc[5].len=romSize;   desc[5].ptr=gbaCore.g_rom;//ROM mirror 2
       desc[5].flags=RETRO_MEMDESC_CONST;
-      desc[6].start=0x00000000; desc[6].select=0;          desc[6].len=0x4000;    desc[6].ptr=g_bios;//BIOS
+      desc[6].start=0x00000000; desc[6].select=0;          desc[6].len=0x4000;    desc[6].ptr=gbaCore.g_bios;//BIOS
       desc[6].flags=RETRO_MEMDESC_CONST;
-      desc[7].start=0x06000000; desc[7].select=0xFF000000; desc[7].len=0x18000;   desc[7].ptr=g_vram;//VRAM
-      desc[8].start=0x05000000; desc[8].select=0xFF000000; desc[8].len=0x400;     desc[8].ptr=g_paletteRAM;//palettes
-      desc[9].start=0x07000000; desc[9].select=0xFF000000; desc[9].len=0x400;     desc[9].ptr=g_oam;//OAM
-      desc[10].start=0x04000000;desc[10].select=0;         desc[10].len=0x400;    desc[10].ptr=g_ioMem;//bunch of registers
+      desc[7].start=0x06000000; desc[7].select=0xFF000000; desc[7].len=0x18000;   desc[7].ptr=gbaCore.g_vram;//VRAM
+      desc[8].start=0x05000000; desc[8].select=0xFF000000; desc[8].len=0x400;     desc[8].ptr=gbaCore.g_paletteRAM;//palettes
+      desc[9].start=0x07000000; desc[9].select=0xFF000000; desc[9].len=0x400;     desc[9].ptr=gbaCore.g_oam;//OAM
+      desc[10].start=0x04000000;desc[10].select=0;         desc[10].len=0x400;    desc[10].ptr=gbaCore.g_ioMem;//bunch of registers
 
       struct retro_memory_map retromap = {
           desc,
@@ -1773,9 +1774,16 @@ bool systemCanChangeSoundQuality(void)
 void systemDrawScreen(void)
 {
     unsigned pitch = systemWidth * (systemColorDepth >> 3);
+    // Unchanged frames are duped by the frontend, unless the interframe
+    // blending still has to run on them.
+    const bool dirty = lineWriterTakeDirtyLines(gbaCore.g_lineWriterHashes, NULL);
+    if (!dirty && can_dupe && !ifb_filter_func) {
+        video_cb(NULL, systemWidth, systemHeight, pitch);
+        return;
+    }
     if (ifb_filter_func)
-        ifb_filter_func(g_pix, pitch, systemWidth, systemHeight);
-    video_cb(g_pix, systemWidth, systemHeight, pitch);
+        ifb_filter_func(gbaCore.g_pix, pitch, systemWidth, systemHeight);
+    video_cb(gbaCore.g_pix, systemWidth, systemHeight, pitch);
 }
 
 void systemSendScreen(void)
@@ -49,6 +49,7 @@
 #include "core/gb/gbGlobals.h"
 #include "core/gb/gbSound.h"
 #include "core/gba/gba.h"
+#include "core/gba/gbaCore.h"
 #include "core/gba/gbaFlash.h"
 #include "core/gba/gbaPrint.h"
 #include "core/gba/gbaRemote.h"
@@ -348,10 +349,11 @@ void LoadConfig()
 	showSpeed = ReadPref("showSpeed", 0);
 	showSpeedTransparent = ReadPref("showSpeedTransparent", 1);
 	coreOptions.skipBios = ReadPref("skipBios", 0);
+	coreOptions.skipIdleLoops = ReadPref("skipIdleLoops", 0);
 	coreOptions.skipSaveGameBattery = ReadPref("skipSaveGameBattery", 1);
 	coreOptions.skipSaveGameCheats = ReadPref("skipSaveGameCheats", 0);
-	soundFiltering = (float)ReadPref("gbaSoundFiltering", 50) / 100.0f;
-	g_gbaSoundInterpolation = ReadPref("gbaSoundInterpolation", 1);
+	gbaCore.soundFiltering = (float)ReadPref("gbaSoundFiltering", 50) / 100.0f;
+	gbaCore.g_gbaSoundInterpolation = ReadPref("gbaSoundInterpolation", 1);
 	coreOptions.throttle = ReadPref("throttle", 100);
 	coreOptions.speedup_throttle = ReadPref("speedupThrottle", 100);
 	coreOptions.speedup_frame_skip = ReadPref("speedupFrameSkip", 9);
@@ -697,7 +699,7 @@ int ReadOpts(int argc, char ** argv)
 		}
 		break;
 		case 'd':
-			debugger = true;
+			gbaCore.debugger = true;
 			break;
 		case 'h':
 			optPrintUsage = 1;
@@ -721,7 +723,7 @@ int ReadOpts(int argc, char ** argv)
 			dbgMain = remoteStubMain;
 			dbgSignal = remoteStubSignal;
 			dbgOutput = remoteOutput;
-			debugger = true;
+			gbaCore.debugger = true;
 			if (optarg) {
 				char *s = optarg;
 				if (strncmp(s, "tcp:", 4) == 0) {
@@ -891,7 +893,7 @@ int ReadOpts(int argc, char ** argv)
 		case OPT_SOUND_FILTERING:
 			// --sound-filtering
 			if (optarg) {
-				soundFiltering = (float)(atoi(optarg));
+				gbaCore.soundFiltering = (float)(atoi(optarg));
 			}
 			break;
 
@@ -113,6 +113,8 @@
 #include "components/filters_agb/filters_agb.h"
 #include "components/user_config/user_config.h"
 #include "core/base/file_util.h"
+#include "core/base/frame_limiter.h"
+#include "core/base/line_writer.h"
 #include "core/base/message.h"
 #include "core/base/patch.h"
 #include "core/base/version.h"
@@ -264,7 +266,7 @@ enum VIDEO_SIZE {
 
 #define _stricmp strcasecmp
 
-uint32_t throttleLastTime = 0;
+static FrameLimiter frameLimiter;
 
 bool paused = false;
 bool wasPaused = false;
@@ -609,10 +611,10 @@ static void sdlApplyPerImagePreferences()
 
     char buffer[7];
     buffer[0] = '[';
-    buffer[1] = g_rom[0xac];
-    buffer[2] = g_rom[0xad];
-    buffer[3] = g_rom[0xae];
-    buffer[4] = g_rom[0xaf];
+    buffer[1] = gbaCore.g_rom[0xac];
+    buffer[2] = gbaCore.g_rom[0xad];
+    buffer[3] = gbaCore.g_rom[0xae];
+    buffer[4] = gbaCore.g_rom[0xaf];
     buffer[5] = ']';
     buffer[6] = 0;
 
@@ -950,6 +952,9 @@ static void sdlResizeVideo()
         SDL_Quit();
         exit(-1);
     }
+
+    // The new surface has to be filled in.
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
 }
 
 void sdlInitVideo()
@@ -1585,14 +1590,14 @@ void sdlPollEvents()
                 }
                 break;
             case SDLK_F11:
-                if (armState) {
-                    armNextPC -= 4;
-                    reg[15].I -= 4;
+                if (gbaCore.armState) {
+                    gbaCore.armNextPC -= 4;
+                    gbaCore.reg[15].I -= 4;
                 } else {
-                    armNextPC -= 2;
-                    reg[15].I -= 2;
+                    gbaCore.armNextPC -= 2;
+                    gbaCore.reg[15].I -= 2;
                 }
-                debugger = true;
+                gbaCore.debugger = true;
                 break;
             case SDLK_F1:
             case SDLK_F2:
@@ -1693,7 +1698,7 @@ void sdlPollEvents()
                     int mask = 0x0100 << (event.key.keysym.sym - SDLK_1);
 #endif
                     coreOptions.layerSettings ^= mask;
-                    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+                    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
                     CPUUpdateRenderBuffers(false);
                 }
                 break;
@@ -1709,7 +1714,7 @@ void sdlPollEvents()
                     int mask = 0x0100 << (event.key.key - SDLK_1);
 #endif
                     coreOptions.layerSettings ^= mask;
-                    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+                    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
                 }
                 break;
 #ifndef ENABLE_SDL3
@@ -2067,7 +2072,7 @@ int main(int argc, char** argv)
         exit(-1);
     }
 
-    if (!debugger) {
+    if (!gbaCore.debugger) {
         if (optind >= argc) {
             systemMessage(0, "Missing image name");
             usage(argv[0]);
@@ -2160,7 +2165,7 @@ int main(int argc, char** argv)
                 int patchnum;
                 for (patchnum = 0; patchnum < patchNum; patchnum++) {
                     fprintf(stdout, "Trying patch %s%s\n", patchNames[patchnum],
-                        applyPatch(patchNames[patchnum], &g_rom, &size) ? " [success]" : "");
+                        applyPatch(patchNames[patchnum], &gbaCore.g_rom, &size) ? " [success]" : "");
                 }
                 CPUReset();
             }
@@ -2174,15 +2179,15 @@ int main(int argc, char** argv)
         soundInit();
         cartridgeType = 0;
         strcpy(filename, "gnu_stub");
-        g_rom = (uint8_t*)malloc(0x2000000);
-        g_workRAM = (uint8_t*)calloc(1, 0x40000);
-        g_bios = (uint8_t*)calloc(1, 0x4000);
-        g_internalRAM = (uint8_t*)calloc(1, 0x8000);
-        g_paletteRAM = (uint8_t*)calloc(1, 0x400);
-        g_vram = (uint8_t*)calloc(1, 0x20000);
-        g_oam = (uint8_t*)calloc(1, 0x400);
-        g_pix = (uint8_t*)calloc(1, 4 * 241 * 162);
-        g_ioMem = (uint8_t*)calloc(1, 0x400);
+        gbaCore.g_rom = (uint8_t*)malloc(0x2000000);
+        gbaCore.g_workRAM = (uint8_t*)calloc(1, 0x40000);
+        gbaCore.g_bios = (uint8_t*)calloc(1, 0x4000);
+        gbaCore.g_internalRAM = (uint8_t*)calloc(1, 0x8000);
+        gbaCore.g_paletteRAM = (uint8_t*)calloc(1, 0x400);
+        gbaCore.g_vram = (uint8_t*)calloc(1, 0x20000);
+        gbaCore.g_oam = (uint8_t*)calloc(1, 0x400);
+        gbaCore.g_pix = (uint8_t*)calloc(1, 4 * 241 * 162);
+        gbaCore.g_ioMem = (uint8_t*)calloc(1, 0x400);
 
         emulator = GBASystem;
 
@@ -2192,7 +2197,7 @@ int main(int argc, char** argv)
 
     sdlReadBattery();
 
-    if (debugger)
+    if (gbaCore.debugger)
         remoteInit();
 
     int flags = SDL_INIT_VIDEO;
@@ -2285,7 +2290,8 @@ int main(int argc, char** argv)
     emulating = 1;
     renderedFrames = 0;
 
-    autoFrameSkipLastTime = throttleLastTime = systemGetClock();
+    autoFrameSkipLastTime = systemGetClock();
+    frameLimiter.reset();
 
     // now we can enable cheats?
     {
@@ -2312,7 +2318,7 @@ int main(int argc, char** argv)
 
     while (emulating) {
         if (!paused) {
-            if (debugger && emulator.emuHasDebugger)
+            if (gbaCore.debugger && emulator.emuHasDebugger)
                 remoteStubMain();
             else {
                 emulator.emuMain(emulator.emuCount);
@@ -2355,7 +2361,7 @@ int main(int argc, char** argv)
     }
 #endif
 
-    if (gbRom != NULL || g_rom != NULL) {
+    if (gbRom != NULL || gbaCore.g_rom != NULL) {
         sdlWriteBattery();
         emulator.emuCleanUp();
     }
@@ -2441,13 +2447,24 @@ void systemDrawScreen()
     }
 #endif
 
-    if (ifbFunction)
-        ifbFunction(g_pix + srcPitch, srcPitch, sizeX, sizeY);
+    // The screen still holds the last filtered frame. When the emulated one
+    // did not change, and no text was drawn over it, it is presented as is.
+    static FilterFunc lastFilterFunction = 0;
+    static bool lastOverlay = false;
+    const bool overlay = screenMessage || (showSpeed && fullScreen);
+    const bool dirty = lineWriterTakeDirtyLines(gbaCore.g_lineWriterHashes, NULL);
+    const bool refilter = dirty || ifbFunction || overlay || lastOverlay || filterFunction != lastFilterFunction;
+    lastFilterFunction = filterFunction;
+    lastOverlay = overlay;
+
+    if (refilter && ifbFunction)
+        ifbFunction(gbaCore.g_pix + srcPitch, srcPitch, sizeX, sizeY);
 
-    filterFunction(g_pix + srcPitch, srcPitch, delta, screen, destPitch, sizeX, sizeY);
+    if (refilter)
+        filterFunction(gbaCore.g_pix + srcPitch, srcPitch, delta, screen, destPitch, sizeX, sizeY);
 
 #if !defined(CONFIG_IDF_TARGET) && !defined(NO_OPENGL)
-    if (openGL) {
+    if (openGL && refilter) {
         int bytes = (systemColorDepth >> 3);
         for (int i = 0; i < destWidth; i++)
             for (int j = 0; j < destHeight; j++) {
@@ -2561,6 +2578,12 @@ void systemShowSpeed(int speed)
 
 void systemFrame()
 {
+    // The sound drivers do not wait for the audio device, the emulation is
+    // paced here instead.
+    if (coreOptions.speedup || gbaCore.gba_joybus_active)
+        frameLimiter.reset();
+    else
+        frameLimiter.wait(soundGetThrottle());
 }
 
 void system10Frames()
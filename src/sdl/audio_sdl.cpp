@@ -29,8 +29,8 @@
 
 extern int emulating;
 
-// Hold up to 100 ms of data in the ring buffer
-const double SoundSDL::buftime = 0.100;
+// Hold up to 50 ms of data in the ring buffer
+const double SoundSDL::buftime = kSoundDriverBufferSeconds;
 
 SoundSDL::SoundSDL():
     samples_buf(0),
@@ -57,58 +57,35 @@ void SoundSDL::soundCallback(void* data, SDL_AudioStream *stream, int additional
 }
 #endif
 
-bool SoundSDL::should_wait() {
-    return emulating && !coreOptions.speedup && current_rate && !gba_joybus_active;
-}
-
-std::size_t SoundSDL::buffer_size() {
-    SDL_LockMutex(mutex);
-    std::size_t size = samples_buf.used();
-    SDL_UnlockMutex(mutex);
-
-    return size;
-}
-
+// Called from the audio thread, never waits for the emulator: whatever is
+// missing is played as silence.
 void SoundSDL::read(uint16_t* stream, int length) {
     if (length <= 0)
         return;
 
-    SDL_memset(stream, 0, length);
-
-    // if not initialzed, paused or shutting down, do nothing
-    if (!initialized || !emulating)
-        return;
-
-    if (!buffer_size()) {
-        if (should_wait())
-#ifndef ENABLE_SDL3
-            SDL_SemWait(data_available);
-#else
-            SDL_WaitSemaphore(data_available);
-#endif
-        else
-            return;
-    }
+    std::size_t values = length / 2;
+    std::size_t read = 0;
 
-    SDL_LockMutex(mutex);
+    // The emulator does not wait for room in the buffer, so playback only
+    // starts, or starts again after running dry, once it is half full. This
+    // leaves some slack for the frame timing of the emulator.
+    if (!primed)
+        primed = samples_buf.used() >= samples_buf.size() / 2;
 
-    samples_buf.read(stream, std::min((std::size_t)(length / 2), samples_buf.used()));
+    // if not initialzed, paused or shutting down, play silence
+    if (initialized && emulating && primed)
+        read = samples_buf.read(stream, values);
 
-    SDL_UnlockMutex(mutex);
+    if (read < values)
+        primed = false;
 
-#ifndef ENABLE_SDL3
-    SDL_SemPost(data_read);
-#else
-    SDL_SignalSemaphore(data_read);
-#endif
+    SDL_memset(stream + read, 0, (values - read) * 2);
 }
 
 void SoundSDL::write(uint16_t * finalWave, int length) {
     if (!initialized)
         return;
 
-    SDL_LockMutex(mutex);
-
 #ifndef ENABLE_SDL3
     if (SDL_GetAudioDeviceStatus(sound_device) != SDL_AUDIO_PLAYING)
 	SDL_PauseAudioDevice(sound_device, 0);
@@ -120,39 +97,18 @@ void SoundSDL::write(uint16_t * finalWave, int length) {
     }
 #endif
 
-    std::size_t samples = length / 4;
-    std::size_t avail;
-
-    while ((avail = samples_buf.avail() / 2) < samples) {
-	samples_buf.write(finalWave, avail * 2);
-
-	finalWave += avail * 2;
-	samples -= avail;
-
-	SDL_UnlockMutex(mutex);
-
-#ifndef ENABLE_SDL3
-	SDL_SemPost(data_available);
-#else
-	SDL_SignalSemaphore(data_available);
-#endif
-
-	if (should_wait())
-#ifndef ENABLE_SDL3
-            SDL_SemWait(data_read);
-#else
-            SDL_WaitSemaphore(data_read);
-#endif
-	else
-	    // Drop the remainder of the audio data
-	    return;
-
-	SDL_LockMutex(mutex);
-    }
+    // Whole stereo samples only, so that the channels stay in order. What
+    // does not fit is dropped: the emulator never waits for the callback, it
+    // is paced by the frame limiter.
+    const std::size_t values = (length / 4) * 2;
+    samples_buf.write(finalWave, std::min(values, samples_buf.avail() & ~(std::size_t)1));
+}
 
-    samples_buf.write(finalWave, samples * 2);
+double SoundSDL::bufferLevel() {
+    if (!initialized || !samples_buf.size())
+        return -1.0;
 
-    SDL_UnlockMutex(mutex);
+    return static_cast<double>(samples_buf.used()) / samples_buf.size();
 }
 
 
@@ -174,7 +130,9 @@ bool SoundSDL::init(long sampleRate) {
     audio.channels = 2;
 
 #ifndef ENABLE_SDL3
-    audio.samples  = 2048;
+    // A short callback period keeps the buffer level steady, so that it can
+    // be kept half full.
+    audio.samples  = 512;
     audio.callback = soundCallback;
     audio.userdata = this;
 
@@ -215,11 +173,8 @@ bool SoundSDL::init(long sampleRate) {
         return false;
     }
 
-    samples_buf.reset(static_cast<size_t>(std::ceil(buftime * sampleRate * 2)));
-
-    mutex          = SDL_CreateMutex();
-    data_available = SDL_CreateSemaphore(0);
-    data_read      = SDL_CreateSemaphore(1);
+    // An even size keeps the stereo samples whole.
+    samples_buf.reset(static_cast<size_t>(std::ceil(buftime * sampleRate)) * 2);
 
     // turn off audio events because we are not processing them
 #if SDL_VERSION_ATLEAST(3, 2, 0)
@@ -239,31 +194,8 @@ void SoundSDL::deinit() {
 
     initialized = false;
 
-    SDL_LockMutex(mutex);
-    int is_emulating = emulating;
-    emulating = 0;
-#ifndef ENABLE_SDL3
-    SDL_SemPost(data_available);
-    SDL_SemPost(data_read);
-#else
-    SDL_SignalSemaphore(data_available);
-    SDL_SignalSemaphore(data_read);
-#endif
-    SDL_UnlockMutex(mutex);
-
-    SDL_Delay(100);
-
-    SDL_DestroySemaphore(data_available);
-    data_available = nullptr;
-    SDL_DestroySemaphore(data_read);
-    data_read      = nullptr;
-
-    SDL_DestroyMutex(mutex);
-    mutex = nullptr;
-
+    // Waits for the callback to return.
     SDL_CloseAudioDevice(sound_device);
-
-    emulating = is_emulating;
 }
 
 SoundSDL::~SoundSDL() {
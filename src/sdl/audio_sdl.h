@@ -39,8 +39,6 @@ private:
         static void soundCallback(void* data, uint8_t* stream, int len);
 #endif
 
-        bool should_wait();
-        std::size_t buffer_size();
         void deinit();
         void read(uint16_t* stream, int length);
 
@@ -51,20 +49,17 @@ private:
         void resume() override;
         void write(uint16_t *finalWave, int length) override;
         void setThrottle(unsigned short throttle_) override;
+        double bufferLevel() override;
 
-        RingBuffer<uint16_t> samples_buf;
+        // Filled by the emulator, drained by the audio callback.
+        SpscRingBuffer<uint16_t> samples_buf;
+        // Whether the callback plays from the buffer, owned by the callback.
+        bool primed = false;
 
         SDL_AudioDeviceID sound_device = 0;
 
 #ifdef ENABLE_SDL3
         SDL_AudioStream *sound_stream = NULL;
-        SDL_Mutex* mutex;
-        SDL_Semaphore* data_available;
-        SDL_Semaphore* data_read;
-#else
-        SDL_mutex* mutex;
-        SDL_semaphore* data_available;
-        SDL_semaphore* data_read;
 #endif
 
         SDL_AudioSpec audio_spec;
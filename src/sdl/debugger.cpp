@@ -28,13 +28,15 @@
 #include "core/gba/gbaCpuArmDis.h"
 #include "core/gba/gbaElf.h"
 #include "core/gba/gbaSound.h"
+#include "core/gba/internal/gbaDecodeCache.h"
+#include "core/gba/internal/gbaSpriteIndex.h"
+#include "core/gba/internal/gbaTileCache.h"
 #include "sdl/exprNode.h"
 
 #if __STDC_WANT_SECURE_LIB__
 #define snprintf sprintf_s
 #endif
 
-extern bool debugger;
 extern int emulating;
 extern void sdlWriteState(int num);
 extern void sdlReadState(int num);
@@ -42,22 +44,37 @@ extern void sdlReadState(int num);
 extern struct EmulatedSystem emulator;
 
 #define debuggerReadMemory(addr) \
-    READ32LE((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ32LE((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define debuggerReadHalfWord(addr) \
-    READ16LE((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ16LE((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 #define debuggerReadByte(addr) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]
-
-#define debuggerWriteMemory(addr, value) \
-    WRITE32LE(&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask], value)
-
-#define debuggerWriteHalfWord(addr, value) \
-    WRITE16LE(&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask], value)
-
-#define debuggerWriteByte(addr, value) \
-    map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask] = (value)
+    gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]
+
+#define debuggerWriteMemory(addr, value)                                             \
+    do {                                                                             \
+        cpuDecodeCacheFlush();                                                       \
+        gfxSpriteIndexFlush();                                                       \
+        gfxTileCacheFlush();                                                         \
+        WRITE32LE(&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask], value); \
+    } while (0)
+
+#define debuggerWriteHalfWord(addr, value)                                           \
+    do {                                                                             \
+        cpuDecodeCacheFlush();                                                       \
+        gfxSpriteIndexFlush();                                                       \
+        gfxTileCacheFlush();                                                         \
+        WRITE16LE(&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask], value); \
+    } while (0)
+
+#define debuggerWriteByte(addr, value)                                      \
+    do {                                                                    \
+        cpuDecodeCacheFlush();                                              \
+        gfxSpriteIndexFlush();                                              \
+        gfxTileCacheFlush();                                                \
+        gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask] = (value); \
+    } while (0)
 
 struct breakpointInfo {
     uint32_t address;
@@ -203,23 +220,21 @@ bool debuggerAtBreakpoint = false;
 int debuggerBreakpointNumber = 0;
 int debuggerRadix = 0;
 
-extern uint32_t cpuPrefetch[2];
-
 #define ARM_PREFETCH                                        \
     {                                                       \
-        cpuPrefetch[0] = debuggerReadMemory(armNextPC);     \
-        cpuPrefetch[1] = debuggerReadMemory(armNextPC + 4); \
+        gbaCore.cpuPrefetch[0] = debuggerReadMemory(gbaCore.armNextPC);     \
+        gbaCore.cpuPrefetch[1] = debuggerReadMemory(gbaCore.armNextPC + 4); \
     }
 
 #define THUMB_PREFETCH                                        \
     {                                                         \
-        cpuPrefetch[0] = debuggerReadHalfWord(armNextPC);     \
-        cpuPrefetch[1] = debuggerReadHalfWord(armNextPC + 2); \
+        gbaCore.cpuPrefetch[0] = debuggerReadHalfWord(gbaCore.armNextPC);     \
+        gbaCore.cpuPrefetch[1] = debuggerReadHalfWord(gbaCore.armNextPC + 2); \
     }
 
 static void debuggerPrefetch()
 {
-    if (armState) {
+    if (gbaCore.armState) {
         ARM_PREFETCH;
     } else {
         THUMB_PREFETCH;
@@ -250,7 +265,7 @@ static void debuggerDisableBreakpoints()
 static void debuggerEnableBreakpoints(bool skipPC)
 {
     for (int i = 0; i < debuggerNumOfBreakpoints; i++) {
-        if (debuggerBreakpointList[i].address == armNextPC && skipPC)
+        if (debuggerBreakpointList[i].address == gbaCore.armNextPC && skipPC)
             continue;
 
         debuggerApplyBreakpoint(debuggerBreakpointList[i].address,
@@ -297,7 +312,7 @@ static void debuggerPrintBaseType(Type* t, uint32_t value, uint32_t location,
         if (type == LOCATION_memory) {
             value = debuggerReadMemory(location) | ((uint64_t)debuggerReadMemory(location + 4) << 32);
         } else if (type == LOCATION_register) {
-            value = reg[location].I | ((uint64_t)reg[location + 1].I << 32);
+            value = gbaCore.reg[location].I | ((uint64_t)gbaCore.reg[location + 1].I << 32);
         }
         switch (t->encoding) {
         case DW_ATE_signed:
@@ -402,7 +417,7 @@ static uint32_t debuggerGetValue(uint32_t location, LocationType type)
     case LOCATION_memory:
         return debuggerReadMemory(location);
     case LOCATION_register:
-        return reg[location].I;
+        return gbaCore.reg[location].I;
     case LOCATION_value:
         return location;
     }
@@ -678,7 +693,7 @@ static void debuggerPrint(int argc, char** argv)
     if (argc != 2 && argc != 3) {
         debuggerUsage(argv[0]);
     } else {
-        uint32_t pc = armNextPC;
+        uint32_t pc = gbaCore.armNextPC;
         Function* f = NULL;
         CompileUnit* u = NULL;
 
@@ -785,14 +800,14 @@ static void debuggerVerbose(int n, char** args)
 static void debuggerWhere(int n, char** args)
 {
     void elfPrintCallChain(uint32_t);
-    elfPrintCallChain(armNextPC);
+    elfPrintCallChain(gbaCore.armNextPC);
 }
 
 static void debuggerLocals(int n, char** args)
 {
     Function* f = NULL;
     CompileUnit* u = NULL;
-    uint32_t pc = armNextPC;
+    uint32_t pc = gbaCore.armNextPC;
     if (elfGetCurrentFunction(pc,
             &f, &u)) {
         Object* o = f->parameters;
@@ -836,7 +851,7 @@ static void debuggerNext(int n, char** args)
     debuggerDisableBreakpoints();
     Function* f = NULL;
     CompileUnit* u = NULL;
-    uint32_t a = armNextPC;
+    uint32_t a = gbaCore.armNextPC;
     if (elfGetCurrentFunction(a, &f, &u)) {
         const char* file;
         int line = elfFindLine(u, f, a, &file);
@@ -852,7 +867,7 @@ static void debuggerContinue(int n, char** args)
     if (debuggerAtBreakpoint)
         debuggerContinueAfterBreakpoint();
     debuggerEnableBreakpoints(false);
-    debugger = false;
+    gbaCore.debugger = false;
     debuggerPrefetch();
 }
 
@@ -860,14 +875,14 @@ static void debuggerContinue(int n, char** args)
 {
     switch (sig) {
     case 4: {
-        printf("Illegal instruction at %08x\n", armNextPC);
-        debugger = true;
+        printf("Illegal instruction at %08x\n", gbaCore.armNextPC);
+        gbaCore.debugger = true;
     } break;
     case 5: {
         bool cond = debuggerCondEvaluate(number & 255);
         if (cond) {
             printf("Breakpoint %d reached\n", number);
-            debugger = true;
+            gbaCore.debugger = true;
         } else {
             debuggerDisableBreakpoints();
             debuggerPrefetch();
@@ -882,9 +897,9 @@ static void debuggerContinue(int n, char** args)
         Function* f = NULL;
         CompileUnit* u = NULL;
 
-        if (elfGetCurrentFunction(armNextPC, &f, &u)) {
+        if (elfGetCurrentFunction(gbaCore.armNextPC, &f, &u)) {
             const char* file;
-            int line = elfFindLine(u, f, armNextPC, &file);
+            int line = elfFindLine(u, f, gbaCore.armNextPC, &file);
             printf("File %s, function %s, line %d\n", file, f->name,
                 line);
         }
@@ -969,7 +984,7 @@ static void debuggerBreak(int n, char** args)
             CompileUnit* u;
             uint32_t addr;
 
-            if (elfGetCurrentFunction(armNextPC, &f, &u)) {
+            if (elfGetCurrentFunction(gbaCore.armNextPC, &f, &u)) {
                 if (elfFindLineInUnit(&addr, u, line)) {
                     if (elfGetCurrentFunction(addr, &f, &u)) {
                         uint32_t addr2;
@@ -1069,8 +1084,8 @@ static void debuggerBreakWriteClear(int n, char** args)
             address &= 0x3ffff;
             final &= 0x3ffff;
             for (uint32_t i = address; i < final; i++)
-                if (freezeWorkRAM[i] == 1)
-                    freezeWorkRAM[i] = 0;
+                if (gbaCore.freezeWorkRAM[i] == 1)
+                    gbaCore.freezeWorkRAM[i] = 0;
             printf("Cleared break on write from %08x to %08x\n",
                 0x2000000 + address, 0x2000000 + final);
         } break;
@@ -1078,8 +1093,8 @@ static void debuggerBreakWriteClear(int n, char** args)
             address &= 0x7fff;
             final &= 0x7fff;
             for (uint32_t i = address; i < final; i++)
-                if (freezeInternalRAM[i] == 1)
-                    freezeInternalRAM[i] = 0;
+                if (gbaCore.freezeInternalRAM[i] == 1)
+                    gbaCore.freezeInternalRAM[i] = 0;
             printf("Cleared break on write from %08x to %08x\n",
                 0x3000000 + address, 0x3000000 + final);
         } break;
@@ -1087,8 +1102,8 @@ static void debuggerBreakWriteClear(int n, char** args)
             address &= 0x3ff;
             final &= 0x3ff;
             for (uint32_t i = address; i < final; i++)
-                if (freezePRAM[i] == 1)
-                    freezePRAM[i] = 0;
+                if (gbaCore.freezePRAM[i] == 1)
+                    gbaCore.freezePRAM[i] = 0;
             printf("Cleared break on write from %08x to %08x\n",
                 0x5000000 + address, 0x5000000 + final);
         } break;
@@ -1102,8 +1117,8 @@ static void debuggerBreakWriteClear(int n, char** args)
             }
 
             for (uint32_t i = address; i < final; i++)
-                if (freezeVRAM[i] == 1)
-                    freezeVRAM[i] = 0;
+                if (gbaCore.freezeVRAM[i] == 1)
+                    gbaCore.freezeVRAM[i] = 0;
             printf("Cleared break on write from %08x to %08x\n",
                 0x06000000 + address, 0x06000000 + final);
         } break;
@@ -1111,8 +1126,8 @@ static void debuggerBreakWriteClear(int n, char** args)
             address &= 0x3ff;
             final &= 0x3ff;
             for (uint32_t i = address; i < final; i++)
-                if (freezeOAM[i] == 1)
-                    freezeOAM[i] = 0;
+                if (gbaCore.freezeOAM[i] == 1)
+                    gbaCore.freezeOAM[i] = 0;
             printf("Cleared break on write from %08x to %08x\n",
                 0x7000000 + address, 0x7000000 + final);
         } break;
@@ -1120,20 +1135,20 @@ static void debuggerBreakWriteClear(int n, char** args)
     } else if (n == 1) {
         int i;
         for (i = 0; i < 0x40000; i++)
-            if (freezeWorkRAM[i] == 1)
-                freezeWorkRAM[i] = 0;
+            if (gbaCore.freezeWorkRAM[i] == 1)
+                gbaCore.freezeWorkRAM[i] = 0;
         for (i = 0; i < 0x8000; i++)
-            if (freezeInternalRAM[i] == 1)
-                freezeInternalRAM[i] = 0;
+            if (gbaCore.freezeInternalRAM[i] == 1)
+                gbaCore.freezeInternalRAM[i] = 0;
         for (i = 0; i < 0x400; i++)
-            if (freezePRAM[i] == 1)
-                freezePRAM[i] = 0;
+            if (gbaCore.freezePRAM[i] == 1)
+                gbaCore.freezePRAM[i] = 0;
         for (i = 0; i < 0x18000; i++)
-            if (freezeVRAM[i] == 1)
-                freezeVRAM[i] = 0;
+            if (gbaCore.freezeVRAM[i] == 1)
+                gbaCore.freezeVRAM[i] = 0;
         for (i = 0; i < 0x400; i++)
-            if (freezeOAM[i] == 1)
-                freezeOAM[i] = 0;
+            if (gbaCore.freezeOAM[i] == 1)
+                gbaCore.freezeOAM[i] = 0;
 
         printf("Cleared all break on write\n");
     } else
@@ -1143,7 +1158,7 @@ static void debuggerBreakWriteClear(int n, char** args)
 static void debuggerBreakWrite(int n, char** args)
 {
     if (n == 3) {
-        if (cheatsNumber != 0) {
+        if (gbaCore.cheatsNumber != 0) {
             printf("Cheats are enabled. Cannot continue.\n");
             return;
         }
@@ -1181,24 +1196,24 @@ static void debuggerBreakWrite(int n, char** args)
         switch (address >> 24) {
         case 2:
             for (int i = 0; i < n; i++)
-                freezeWorkRAM[(address + i) & 0x3ffff] = 1;
+                gbaCore.freezeWorkRAM[(address + i) & 0x3ffff] = 1;
             break;
         case 3:
             for (int i = 0; i < n; i++)
-                freezeInternalRAM[(address + i) & 0x7fff] = 1;
+                gbaCore.freezeInternalRAM[(address + i) & 0x7fff] = 1;
             break;
         case 5:
             for (int i = 0; i < n; i++)
-                freezePRAM[(address + i) & 0x3ff] = 1;
+                gbaCore.freezePRAM[(address + i) & 0x3ff] = 1;
             break;
         case 6:
             // address/range must be valid, so we can use a lazy mask
             for (int i = 0; i < n; i++)
-                freezeVRAM[(address + i) & 0x1ffff] = 1;
+                gbaCore.freezeVRAM[(address + i) & 0x1ffff] = 1;
             break;
         case 7:
             for (int i = 0; i < n; i++)
-                freezeOAM[(address + i) & 0x3ff] = 1;
+                gbaCore.freezeOAM[(address + i) & 0x3ff] = 1;
             break;
         }
 
@@ -1225,8 +1240,8 @@ static void debuggerBreakChangeClear(int n, char** args)
             address &= 0x3ffff;
             final &= 0x3ffff;
             for (uint32_t i = address; i < final; i++)
-                if (freezeWorkRAM[i] == 2)
-                    freezeWorkRAM[i] = 0;
+                if (gbaCore.freezeWorkRAM[i] == 2)
+                    gbaCore.freezeWorkRAM[i] = 0;
             printf("Cleared break on change from %08x to %08x\n",
                 0x2000000 + address, 0x2000000 + final);
         } break;
@@ -1234,8 +1249,8 @@ static void debuggerBreakChangeClear(int n, char** args)
             address &= 0x7fff;
             final &= 0x7fff;
             for (uint32_t i = address; i < final; i++)
-                if (freezeInternalRAM[i] == 2)
-                    freezeInternalRAM[i] = 0;
+                if (gbaCore.freezeInternalRAM[i] == 2)
+                    gbaCore.freezeInternalRAM[i] = 0;
             printf("Cleared break on change from %08x to %08x\n",
                 0x3000000 + address, 0x3000000 + final);
         } break;
@@ -1243,8 +1258,8 @@ static void debuggerBreakChangeClear(int n, char** args)
             address &= 0x3ff;
             final &= 0x3ff;
             for (uint32_t i = address; i < final; i++)
-                if (freezePRAM[i] == 2)
-                    freezePRAM[i] = 0;
+                if (gbaCore.freezePRAM[i] == 2)
+                    gbaCore.freezePRAM[i] = 0;
             printf("Cleared break on change from %08x to %08x\n",
                 0x5000000 + address, 0x5000000 + final);
         } break;
@@ -1257,8 +1272,8 @@ static void debuggerBreakChangeClear(int n, char** args)
                 final &= 0xffff;
             }
             for (uint32_t i = address; i < final; i++)
-                if (freezeVRAM[i] == 2)
-                    freezeVRAM[i] = 0;
+                if (gbaCore.freezeVRAM[i] == 2)
+                    gbaCore.freezeVRAM[i] = 0;
             printf("Cleared break on change from %08x to %08x\n",
                 0x3000000 + address, 0x3000000 + final);
         } break;
@@ -1266,8 +1281,8 @@ static void debuggerBreakChangeClear(int n, char** args)
             address &= 0x3ff;
             final &= 0x3ff;
             for (uint32_t i = address; i < final; i++)
-                if (freezeOAM[i] == 2)
-                    freezeOAM[i] = 0;
+                if (gbaCore.freezeOAM[i] == 2)
+                    gbaCore.freezeOAM[i] = 0;
             printf("Cleared break on change from %08x to %08x\n",
                 0x7000000 + address, 0x7000000 + final);
         } break;
@@ -1275,20 +1290,20 @@ static void debuggerBreakChangeClear(int n, char** args)
     } else if (n == 1) {
         int i;
         for (i = 0; i < 0x40000; i++)
-            if (freezeWorkRAM[i] == 2)
-                freezeWorkRAM[i] = 0;
+            if (gbaCore.freezeWorkRAM[i] == 2)
+                gbaCore.freezeWorkRAM[i] = 0;
         for (i = 0; i < 0x8000; i++)
-            if (freezeInternalRAM[i] == 2)
-                freezeInternalRAM[i] = 0;
+            if (gbaCore.freezeInternalRAM[i] == 2)
+                gbaCore.freezeInternalRAM[i] = 0;
         for (i = 0; i < 0x400; i++)
-            if (freezePRAM[i] == 2)
-                freezePRAM[i] = 0;
+            if (gbaCore.freezePRAM[i] == 2)
+                gbaCore.freezePRAM[i] = 0;
         for (i = 0; i < 0x18000; i++)
-            if (freezeVRAM[i] == 2)
-                freezeVRAM[i] = 0;
+            if (gbaCore.freezeVRAM[i] == 2)
+                gbaCore.freezeVRAM[i] = 0;
         for (i = 0; i < 0x400; i++)
-            if (freezeOAM[i] == 2)
-                freezeOAM[i] = 0;
+            if (gbaCore.freezeOAM[i] == 2)
+                gbaCore.freezeOAM[i] = 0;
 
         printf("Cleared all break on change\n");
     } else
@@ -1298,7 +1313,7 @@ static void debuggerBreakChangeClear(int n, char** args)
 static void debuggerBreakChange(int n, char** args)
 {
     if (n == 3) {
-        if (cheatsNumber != 0) {
+        if (gbaCore.cheatsNumber != 0) {
             printf("Cheats are enabled. Cannot continue.\n");
             return;
         }
@@ -1332,24 +1347,24 @@ static void debuggerBreakChange(int n, char** args)
         switch (address >> 24) {
         case 2:
             for (int i = 0; i < n; i++)
-                freezeWorkRAM[(address + i) & 0x3ffff] = 2;
+                gbaCore.freezeWorkRAM[(address + i) & 0x3ffff] = 2;
             break;
         case 3:
             for (int i = 0; i < n; i++)
-                freezeInternalRAM[(address + i) & 0x7fff] = 2;
+                gbaCore.freezeInternalRAM[(address + i) & 0x7fff] = 2;
             break;
         case 5:
             for (int i = 0; i < n; i++)
-                freezePRAM[(address + i) & 0x3ff] = 2;
+                gbaCore.freezePRAM[(address + i) & 0x3ff] = 2;
             break;
         case 6:
             // address/range must be valid, so we can use a lazy mask
             for (int i = 0; i < n; i++)
-                freezeVRAM[(address + i) & 0x1ffff] = 2;
+                gbaCore.freezeVRAM[(address + i) & 0x1ffff] = 2;
             break;
         case 7:
             for (int i = 0; i < n; i++)
-                freezeOAM[(address + i) & 0x3ff] = 2;
+                gbaCore.freezeOAM[(address + i) & 0x3ff] = 2;
             break;
         }
 
@@ -1398,7 +1413,7 @@ static void debuggerDisassembleThumb(FILE* f, uint32_t pc, int count)
 
 static void debuggerDisassembleArm(int n, char** args)
 {
-    uint32_t pc = reg[15].I;
+    uint32_t pc = gbaCore.reg[15].I;
     pc -= 4;
     int count = 20;
     if (n >= 2) {
@@ -1416,7 +1431,7 @@ static void debuggerDisassembleArm(int n, char** args)
 
 static void debuggerDisassembleThumb(int n, char** args)
 {
-    uint32_t pc = reg[15].I;
+    uint32_t pc = gbaCore.reg[15].I;
     pc -= 2;
     int count = 20;
     if (n >= 2) {
@@ -1434,7 +1449,7 @@ static void debuggerDisassembleThumb(int n, char** args)
 
 static void debuggerDisassemble(int n, char** args)
 {
-    if (armState)
+    if (gbaCore.armState)
         debuggerDisassembleArm(n, args);
     else
         debuggerDisassembleThumb(n, args);
@@ -1442,7 +1457,7 @@ static void debuggerDisassemble(int n, char** args)
 
 static void debuggerFileDisassembleArm(int n, char** args)
 {
-    uint32_t pc = reg[15].I;
+    uint32_t pc = gbaCore.reg[15].I;
     pc -= 4;
     int count = 20;
     if (n < 2) {
@@ -1470,7 +1485,7 @@ static void debuggerFileDisassembleArm(int n, char** args)
 
 static void debuggerFileDisassembleThumb(int n, char** args)
 {
-    uint32_t pc = reg[15].I;
+    uint32_t pc = gbaCore.reg[15].I;
     pc -= 2;
     int count = 20;
     if (n < 2) {
@@ -1594,8 +1609,8 @@ void debuggerDoSearch()
                 SearchStart = 0x02000000;
                 continue;
             } else {
-                start = g_bios + (SearchStart & 0x3FFF);
-                end = g_bios + 0x3FFF;
+                start = gbaCore.g_bios + (SearchStart & 0x3FFF);
+                end = gbaCore.g_bios + 0x3FFF;
                 break;
             };
         case 2:
@@ -1603,8 +1618,8 @@ void debuggerDoSearch()
                 SearchStart = 0x03000000;
                 continue;
             } else {
-                start = g_workRAM + (SearchStart & 0x3FFFF);
-                end = g_workRAM + 0x3FFFF;
+                start = gbaCore.g_workRAM + (SearchStart & 0x3FFFF);
+                end = gbaCore.g_workRAM + 0x3FFFF;
                 break;
             };
         case 3:
@@ -1612,8 +1627,8 @@ void debuggerDoSearch()
                 SearchStart = 0x04000000;
                 continue;
             } else {
-                start = g_internalRAM + (SearchStart & 0x7FFF);
-                end = g_internalRAM + 0x7FFF;
+                start = gbaCore.g_internalRAM + (SearchStart & 0x7FFF);
+                end = gbaCore.g_internalRAM + 0x7FFF;
                 break;
             };
         case 4:
@@ -1621,8 +1636,8 @@ void debuggerDoSearch()
                 SearchStart = 0x05000000;
                 continue;
             } else {
-                start = g_ioMem + (SearchStart & 0x3FF);
-                end = g_ioMem + 0x3FF;
+                start = gbaCore.g_ioMem + (SearchStart & 0x3FF);
+                end = gbaCore.g_ioMem + 0x3FF;
                 break;
             };
         case 5:
@@ -1630,8 +1645,8 @@ void debuggerDoSearch()
                 SearchStart = 0x06000000;
                 continue;
             } else {
-                start = g_paletteRAM + (SearchStart & 0x3FF);
-                end = g_paletteRAM + 0x3FF;
+                start = gbaCore.g_paletteRAM + (SearchStart & 0x3FF);
+                end = gbaCore.g_paletteRAM + 0x3FF;
                 break;
             };
         case 6:
@@ -1639,8 +1654,8 @@ void debuggerDoSearch()
                 SearchStart = 0x07000000;
                 continue;
             } else {
-                start = g_vram + (SearchStart & 0x1FFFF);
-                end = g_vram + 0x1FFFF;
+                start = gbaCore.g_vram + (SearchStart & 0x1FFFF);
+                end = gbaCore.g_vram + 0x1FFFF;
                 break;
             };
         case 7:
@@ -1648,8 +1663,8 @@ void debuggerDoSearch()
                 SearchStart = 0x08000000;
                 continue;
             } else {
-                start = g_oam + (SearchStart & 0x3FF);
-                end = g_oam + 0x3FF;
+                start = gbaCore.g_oam + (SearchStart & 0x3FF);
+                end = gbaCore.g_oam + 0x3FF;
                 break;
             };
         case 8:
@@ -1659,8 +1674,8 @@ void debuggerDoSearch()
         case 12:
         case 13:
             if (final <= 0x09FFFFFF) {
-                start = g_rom + (SearchStart & 0x01FFFFFF);
-                end = g_rom + 0x01FFFFFF;
+                start = gbaCore.g_rom + (SearchStart & 0x01FFFFFF);
+                end = gbaCore.g_rom + 0x01FFFFFF;
                 break;
             };
         default:
@@ -1702,22 +1717,22 @@ void debuggerDoSearch()
 
 unsigned int AddressToGBA(uint8_t* mem)
 {
-    if (mem >= &g_bios[0] && mem <= &g_bios[0x3fff])
-        return 0x00000000 + (mem - &g_bios[0]);
-    else if (mem >= &g_workRAM[0] && mem <= &g_workRAM[0x3ffff])
-        return 0x02000000 + (mem - &g_workRAM[0]);
-    else if (mem >= &g_internalRAM[0] && mem <= &g_internalRAM[0x7fff])
-        return 0x03000000 + (mem - &g_internalRAM[0]);
-    else if (mem >= &g_ioMem[0] && mem <= &g_ioMem[0x3ff])
-        return 0x04000000 + (mem - &g_ioMem[0]);
-    else if (mem >= &g_paletteRAM[0] && mem <= &g_paletteRAM[0x3ff])
-        return 0x05000000 + (mem - &g_paletteRAM[0]);
-    else if (mem >= &g_vram[0] && mem <= &g_vram[0x1ffff])
-        return 0x06000000 + (mem - &g_vram[0]);
-    else if (mem >= &g_oam[0] && mem <= &g_oam[0x3ff])
-        return 0x07000000 + (mem - &g_oam[0]);
-    else if (mem >= &g_rom[0] && mem <= &g_rom[0x1ffffff])
-        return 0x08000000 + (mem - &g_rom[0]);
+    if (mem >= &gbaCore.g_bios[0] && mem <= &gbaCore.g_bios[0x3fff])
+        return 0x00000000 + (mem - &gbaCore.g_bios[0]);
+    else if (mem >= &gbaCore.g_workRAM[0] && mem <= &gbaCore.g_workRAM[0x3ffff])
+        return 0x02000000 + (mem - &gbaCore.g_workRAM[0]);
+    else if (mem >= &gbaCore.g_internalRAM[0] && mem <= &gbaCore.g_internalRAM[0x7fff])
+        return 0x03000000 + (mem - &gbaCore.g_internalRAM[0]);
+    else if (mem >= &gbaCore.g_ioMem[0] && mem <= &gbaCore.g_ioMem[0x3ff])
+        return 0x04000000 + (mem - &gbaCore.g_ioMem[0]);
+    else if (mem >= &gbaCore.g_paletteRAM[0] && mem <= &gbaCore.g_paletteRAM[0x3ff])
+        return 0x05000000 + (mem - &gbaCore.g_paletteRAM[0]);
+    else if (mem >= &gbaCore.g_vram[0] && mem <= &gbaCore.g_vram[0x1ffff])
+        return 0x06000000 + (mem - &gbaCore.g_vram[0]);
+    else if (mem >= &gbaCore.g_oam[0] && mem <= &gbaCore.g_oam[0x3ff])
+        return 0x07000000 + (mem - &gbaCore.g_oam[0]);
+    else if (mem >= &gbaCore.g_rom[0] && mem <= &gbaCore.g_rom[0x1ffffff])
+        return 0x08000000 + (mem - &gbaCore.g_rom[0]);
     else
         return 0xFFFFFFFF;
 };
@@ -1727,7 +1742,7 @@ static void debuggerFileDisassemble(int n, char** args)
     if (n < 2) {
         debuggerUsage("fd");
     } else {
-        if (armState)
+        if (gbaCore.armState)
             debuggerFileDisassembleArm(n, args);
         else
             debuggerFileDisassembleThumb(n, args);
@@ -1752,123 +1767,123 @@ static void debuggerRegisters(int, char**)
     char buffer[10];
 
 #ifdef VBAM_ENABLE_DEBUGGER
-    if (debugger_last) {
+    if (gbaCore.debugger_last) {
         printf("R00=%08x R04=%08x R08=%08x R12=%08x\n",
-            oldreg[0], oldreg[4], oldreg[8], oldreg[12]);
+            gbaCore.oldreg[0], gbaCore.oldreg[4], gbaCore.oldreg[8], gbaCore.oldreg[12]);
         printf("R01=%08x R05=%08x R09=%08x R13=%08x\n",
-            oldreg[1], oldreg[5], oldreg[9], oldreg[13]);
+            gbaCore.oldreg[1], gbaCore.oldreg[5], gbaCore.oldreg[9], gbaCore.oldreg[13]);
         printf("R02=%08x R06=%08x R10=%08x R14=%08x\n",
-            oldreg[2], oldreg[6], oldreg[10], oldreg[14]);
+            gbaCore.oldreg[2], gbaCore.oldreg[6], gbaCore.oldreg[10], gbaCore.oldreg[14]);
         printf("R03=%08x R07=%08x R11=%08x R15=%08x\n",
-            oldreg[3], oldreg[7], oldreg[11], oldreg[15]);
-        command[1] = oldbuffer;
+            gbaCore.oldreg[3], gbaCore.oldreg[7], gbaCore.oldreg[11], gbaCore.oldreg[15]);
+        command[1] = gbaCore.oldbuffer;
         debuggerDisassemble(3, command);
         printf("\n");
     }
 #endif
 
     printf("R00=%08x R04=%08x R08=%08x R12=%08x\n",
-        reg[0].I, reg[4].I, reg[8].I, reg[12].I);
+        gbaCore.reg[0].I, gbaCore.reg[4].I, gbaCore.reg[8].I, gbaCore.reg[12].I);
     printf("R01=%08x R05=%08x R09=%08x R13=%08x\n",
-        reg[1].I, reg[5].I, reg[9].I, reg[13].I);
+        gbaCore.reg[1].I, gbaCore.reg[5].I, gbaCore.reg[9].I, gbaCore.reg[13].I);
     printf("R02=%08x R06=%08x R10=%08x R14=%08x\n",
-        reg[2].I, reg[6].I, reg[10].I, reg[14].I);
+        gbaCore.reg[2].I, gbaCore.reg[6].I, gbaCore.reg[10].I, gbaCore.reg[14].I);
     printf("R03=%08x R07=%08x R11=%08x R15=%08x\n",
-        reg[3].I, reg[7].I, reg[11].I, reg[15].I);
+        gbaCore.reg[3].I, gbaCore.reg[7].I, gbaCore.reg[11].I, gbaCore.reg[15].I);
     printf("CPSR=%08x (%c%c%c%c%c%c%c Mode: %02x)\n",
-        reg[16].I,
-        (N_FLAG ? 'N' : '.'),
-        (Z_FLAG ? 'Z' : '.'),
-        (C_FLAG ? 'C' : '.'),
-        (V_FLAG ? 'V' : '.'),
-        (armIrqEnable ? '.' : 'I'),
-        ((!(reg[16].I & 0x40)) ? '.' : 'F'),
-        (armState ? '.' : 'T'),
-        armMode);
-    snprintf(buffer, sizeof(buffer), "%08x", armState ? reg[15].I - 4 : reg[15].I - 2);
+        gbaCore.reg[16].I,
+        (gbaCore.N_FLAG ? 'N' : '.'),
+        (gbaCore.Z_FLAG ? 'Z' : '.'),
+        (gbaCore.C_FLAG ? 'C' : '.'),
+        (gbaCore.V_FLAG ? 'V' : '.'),
+        (gbaCore.armIrqEnable ? '.' : 'I'),
+        ((!(gbaCore.reg[16].I & 0x40)) ? '.' : 'F'),
+        (gbaCore.armState ? '.' : 'T'),
+        gbaCore.armMode);
+    snprintf(buffer, sizeof(buffer), "%08x", gbaCore.armState ? gbaCore.reg[15].I - 4 : gbaCore.reg[15].I - 2);
     command[1] = buffer;
     debuggerDisassemble(3, command);
 }
 
 static void debuggerIoVideo()
 {
-    printf("DISPCNT  = %04x\n", DISPCNT);
-    printf("DISPSTAT = %04x\n", DISPSTAT);
-    printf("VCOUNT   = %04x\n", VCOUNT);
-    printf("BG0CNT   = %04x\n", BG0CNT);
-    printf("BG1CNT   = %04x\n", BG1CNT);
-    printf("BG2CNT   = %04x\n", BG2CNT);
-    printf("BG3CNT   = %04x\n", BG3CNT);
-    printf("WIN0H    = %04x\n", WIN0H);
-    printf("WIN0V    = %04x\n", WIN0V);
-    printf("WIN1H    = %04x\n", WIN1H);
-    printf("WIN1V    = %04x\n", WIN1V);
-    printf("WININ    = %04x\n", WININ);
-    printf("WINOUT   = %04x\n", WINOUT);
-    printf("MOSAIC   = %04x\n", MOSAIC);
-    printf("BLDMOD   = %04x\n", BLDMOD);
-    printf("COLEV    = %04x\n", COLEV);
-    printf("COLY     = %04x\n", COLY);
+    printf("DISPCNT  = %04x\n", gbaCore.DISPCNT);
+    printf("DISPSTAT = %04x\n", gbaCore.DISPSTAT);
+    printf("VCOUNT   = %04x\n", gbaCore.VCOUNT);
+    printf("BG0CNT   = %04x\n", gbaCore.BG0CNT);
+    printf("BG1CNT   = %04x\n", gbaCore.BG1CNT);
+    printf("BG2CNT   = %04x\n", gbaCore.BG2CNT);
+    printf("BG3CNT   = %04x\n", gbaCore.BG3CNT);
+    printf("WIN0H    = %04x\n", gbaCore.WIN0H);
+    printf("WIN0V    = %04x\n", gbaCore.WIN0V);
+    printf("WIN1H    = %04x\n", gbaCore.WIN1H);
+    printf("WIN1V    = %04x\n", gbaCore.WIN1V);
+    printf("WININ    = %04x\n", gbaCore.WININ);
+    printf("WINOUT   = %04x\n", gbaCore.WINOUT);
+    printf("MOSAIC   = %04x\n", gbaCore.MOSAIC);
+    printf("BLDMOD   = %04x\n", gbaCore.BLDMOD);
+    printf("COLEV    = %04x\n", gbaCore.COLEV);
+    printf("COLY     = %04x\n", gbaCore.COLY);
 }
 
 static void debuggerIoVideo2()
 {
-    printf("BG0HOFS  = %04x\n", BG0HOFS);
-    printf("BG0VOFS  = %04x\n", BG0VOFS);
-    printf("BG1HOFS  = %04x\n", BG1HOFS);
-    printf("BG1VOFS  = %04x\n", BG1VOFS);
-    printf("BG2HOFS  = %04x\n", BG2HOFS);
-    printf("BG2VOFS  = %04x\n", BG2VOFS);
-    printf("BG3HOFS  = %04x\n", BG3HOFS);
-    printf("BG3VOFS  = %04x\n", BG3VOFS);
-    printf("BG2PA    = %04x\n", BG2PA);
-    printf("BG2PB    = %04x\n", BG2PB);
-    printf("BG2PC    = %04x\n", BG2PC);
-    printf("BG2PD    = %04x\n", BG2PD);
-    printf("BG2X     = %08x\n", (BG2X_H << 16) | BG2X_L);
-    printf("BG2Y     = %08x\n", (BG2Y_H << 16) | BG2Y_L);
-    printf("BG3PA    = %04x\n", BG3PA);
-    printf("BG3PB    = %04x\n", BG3PB);
-    printf("BG3PC    = %04x\n", BG3PC);
-    printf("BG3PD    = %04x\n", BG3PD);
-    printf("BG3X     = %08x\n", (BG3X_H << 16) | BG3X_L);
-    printf("BG3Y     = %08x\n", (BG3Y_H << 16) | BG3Y_L);
+    printf("BG0HOFS  = %04x\n", gbaCore.BG0HOFS);
+    printf("BG0VOFS  = %04x\n", gbaCore.BG0VOFS);
+    printf("BG1HOFS  = %04x\n", gbaCore.BG1HOFS);
+    printf("BG1VOFS  = %04x\n", gbaCore.BG1VOFS);
+    printf("BG2HOFS  = %04x\n", gbaCore.BG2HOFS);
+    printf("BG2VOFS  = %04x\n", gbaCore.BG2VOFS);
+    printf("BG3HOFS  = %04x\n", gbaCore.BG3HOFS);
+    printf("BG3VOFS  = %04x\n", gbaCore.BG3VOFS);
+    printf("BG2PA    = %04x\n", gbaCore.BG2PA);
+    printf("BG2PB    = %04x\n", gbaCore.BG2PB);
+    printf("BG2PC    = %04x\n", gbaCore.BG2PC);
+    printf("BG2PD    = %04x\n", gbaCore.BG2PD);
+    printf("BG2X     = %08x\n", (gbaCore.BG2X_H << 16) | gbaCore.BG2X_L);
+    printf("BG2Y     = %08x\n", (gbaCore.BG2Y_H << 16) | gbaCore.BG2Y_L);
+    printf("BG3PA    = %04x\n", gbaCore.BG3PA);
+    printf("BG3PB    = %04x\n", gbaCore.BG3PB);
+    printf("BG3PC    = %04x\n", gbaCore.BG3PC);
+    printf("BG3PD    = %04x\n", gbaCore.BG3PD);
+    printf("BG3X     = %08x\n", (gbaCore.BG3X_H << 16) | gbaCore.BG3X_L);
+    printf("BG3Y     = %08x\n", (gbaCore.BG3Y_H << 16) | gbaCore.BG3Y_L);
 }
 
 static void debuggerIoDMA()
 {
-    printf("DM0SAD   = %08x\n", (DM0SAD_H << 16) | DM0SAD_L);
-    printf("DM0DAD   = %08x\n", (DM0DAD_H << 16) | DM0DAD_L);
-    printf("DM0CNT   = %08x\n", (DM0CNT_H << 16) | DM0CNT_L);
-    printf("DM1SAD   = %08x\n", (DM1SAD_H << 16) | DM1SAD_L);
-    printf("DM1DAD   = %08x\n", (DM1DAD_H << 16) | DM1DAD_L);
-    printf("DM1CNT   = %08x\n", (DM1CNT_H << 16) | DM1CNT_L);
-    printf("DM2SAD   = %08x\n", (DM2SAD_H << 16) | DM2SAD_L);
-    printf("DM2DAD   = %08x\n", (DM2DAD_H << 16) | DM2DAD_L);
-    printf("DM2CNT   = %08x\n", (DM2CNT_H << 16) | DM2CNT_L);
-    printf("DM3SAD   = %08x\n", (DM3SAD_H << 16) | DM3SAD_L);
-    printf("DM3DAD   = %08x\n", (DM3DAD_H << 16) | DM3DAD_L);
-    printf("DM3CNT   = %08x\n", (DM3CNT_H << 16) | DM3CNT_L);
+    printf("DM0SAD   = %08x\n", (gbaCore.DM0SAD_H << 16) | gbaCore.DM0SAD_L);
+    printf("DM0DAD   = %08x\n", (gbaCore.DM0DAD_H << 16) | gbaCore.DM0DAD_L);
+    printf("DM0CNT   = %08x\n", (gbaCore.DM0CNT_H << 16) | gbaCore.DM0CNT_L);
+    printf("DM1SAD   = %08x\n", (gbaCore.DM1SAD_H << 16) | gbaCore.DM1SAD_L);
+    printf("DM1DAD   = %08x\n", (gbaCore.DM1DAD_H << 16) | gbaCore.DM1DAD_L);
+    printf("DM1CNT   = %08x\n", (gbaCore.DM1CNT_H << 16) | gbaCore.DM1CNT_L);
+    printf("DM2SAD   = %08x\n", (gbaCore.DM2SAD_H << 16) | gbaCore.DM2SAD_L);
+    printf("DM2DAD   = %08x\n", (gbaCore.DM2DAD_H << 16) | gbaCore.DM2DAD_L);
+    printf("DM2CNT   = %08x\n", (gbaCore.DM2CNT_H << 16) | gbaCore.DM2CNT_L);
+    printf("DM3SAD   = %08x\n", (gbaCore.DM3SAD_H << 16) | gbaCore.DM3SAD_L);
+    printf("DM3DAD   = %08x\n", (gbaCore.DM3DAD_H << 16) | gbaCore.DM3DAD_L);
+    printf("DM3CNT   = %08x\n", (gbaCore.DM3CNT_H << 16) | gbaCore.DM3CNT_L);
 }
 
 static void debuggerIoTimer()
 {
-    printf("TM0D     = %04x\n", TM0D);
-    printf("TM0CNT   = %04x\n", TM0CNT);
-    printf("TM1D     = %04x\n", TM1D);
-    printf("TM1CNT   = %04x\n", TM1CNT);
-    printf("TM2D     = %04x\n", TM2D);
-    printf("TM2CNT   = %04x\n", TM2CNT);
-    printf("TM3D     = %04x\n", TM3D);
-    printf("TM3CNT   = %04x\n", TM3CNT);
+    printf("TM0D     = %04x\n", gbaCore.TM0D);
+    printf("TM0CNT   = %04x\n", gbaCore.TM0CNT);
+    printf("TM1D     = %04x\n", gbaCore.TM1D);
+    printf("TM1CNT   = %04x\n", gbaCore.TM1CNT);
+    printf("TM2D     = %04x\n", gbaCore.TM2D);
+    printf("TM2CNT   = %04x\n", gbaCore.TM2CNT);
+    printf("TM3D     = %04x\n", gbaCore.TM3D);
+    printf("TM3CNT   = %04x\n", gbaCore.TM3CNT);
 }
 
 static void debuggerIoMisc()
 {
-    printf("P1       = %04x\n", P1);
-    printf("IE       = %04x\n", IE);
-    printf("IF       = %04x\n", IF);
-    printf("IME      = %04x\n", IME);
+    printf("P1       = %04x\n", gbaCore.P1);
+    printf("IE       = %04x\n", gbaCore.IE);
+    printf("IF       = %04x\n", gbaCore.IF);
+    printf("IME      = %04x\n", gbaCore.IME);
 }
 
 static void debuggerIo(int n, char** args)
@@ -1931,7 +1946,7 @@ static void debuggerEditRegister(int n, char** args)
             return;
         }
         sscanf(args[2], "%x", &val);
-        reg[r].I = val;
+        gbaCore.reg[r].I = val;
         printf("Register changed.\n");
     } else
         debuggerUsage("er");
@@ -2073,7 +2088,7 @@ static void debuggerQuit(int, char**)
         return;
 
     if (buffer[0] == 'y' || buffer[0] == 'Y') {
-        debugger = false;
+        gbaCore.debugger = false;
         emulating = false;
     }
 }
@@ -2465,7 +2480,7 @@ static bool debuggerCondEvaluate(int num)
     uint32_t value2 = 0;
 
     if (address < 17)
-        value1 = reg[address].I;
+        value1 = gbaCore.reg[address].I;
     else {
         switch (size) {
         case 1:
@@ -2483,7 +2498,7 @@ static bool debuggerCondEvaluate(int num)
     //value2
     if (debuggerBreakpointList[num].ia2) { //is address or register
         if (value < 17)
-            value2 = reg[address].I;
+            value2 = gbaCore.reg[address].I;
         else {
             switch (size) {
             case 'b':
@@ -2599,7 +2614,7 @@ char* strqtok(char* string, const char* ctrl)
         emulator.emuUpdateCPSR();
     debuggerRegisters(0, NULL);
 
-    while (debugger) {
+    while (gbaCore.debugger) {
         soundPause();
         debuggerDisableBreakpoints();
         printf("debugger> ");
@@ -2631,8 +2646,8 @@ char* strqtok(char* string, const char* ctrl)
 
 void debuggerLast(int n, char** args)
 {
-    debugger_last = !debugger_last;
-    if (debugger_last == true)
+    gbaCore.debugger_last = !gbaCore.debugger_last;
+    if (gbaCore.debugger_last == true)
         printf("Last registers will be shown\n");
     else
         printf("Last registers wont be shown\n");
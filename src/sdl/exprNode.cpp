@@ -34,7 +34,7 @@
 extern char* yytext;
 
 #define debuggerReadMemory(addr) \
-    READ32LE((&map[(addr) >> 24].address[(addr)&map[(addr) >> 24].mask]))
+    READ32LE((&gbaCore.map[(addr) >> 24].address[(addr)&gbaCore.map[(addr) >> 24].mask]))
 
 const void* exprNodeCleanUpList[100];
 int exprNodeCleanUpCount = 0;
@@ -130,7 +130,7 @@ bool exprNodeStarResolve(Node* n, Function* f, CompileUnit* u)
             if (n->expression->locType == LOCATION_memory) {
                 n->location = debuggerReadMemory(n->location);
             } else if (n->expression->locType == LOCATION_register) {
-                n->location = reg[n->expression->location].I;
+                n->location = gbaCore.reg[n->expression->location].I;
             } else {
                 n->location = n->expression->location;
             }
@@ -397,7 +397,7 @@ bool exprNodeArrayResolve(Node* n, Function* f, CompileUnit* u)
             Type* t = n->expression->type->pointer;
             uint32_t loc = n->expression->location;
             if (n->expression->locType == LOCATION_register)
-                loc = reg[loc].I;
+                loc = gbaCore.reg[loc].I;
             else
                 loc = debuggerReadMemory(loc);
             n->type = t;
@@ -269,11 +269,11 @@ void DirectSound::write(uint16_t* finalWave, int) {
     LPVOID lpvPtr2;
     DWORD dwBytes2 = 0;
 
-    if (!coreOptions.speedup && coreOptions.throttle && !gba_joybus_active) {
+    if (!coreOptions.speedup && coreOptions.throttle && !gbaCore.gba_joybus_active) {
         hr = dsbSecondary->GetStatus(&status);
 
         if (status & DSBSTATUS_PLAYING) {
-            if (!soundPaused) {
+            if (!gbaCore.soundPaused) {
                 while (true) {
                     dsbSecondary->GetCurrentPosition(&play, NULL);
                     int BufferLeft = ((soundNextPosition <= play)
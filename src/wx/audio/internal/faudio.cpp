@@ -390,7 +390,7 @@ void FAudio_Output::write(uint16_t* finalWave, int) {
             break;
         } else {
             // the maximum number of buffers is currently queued
-            if (!coreOptions.speedup && coreOptions.throttle && !gba_joybus_active) {
+            if (!coreOptions.speedup && coreOptions.throttle && !gbaCore.gba_joybus_active) {
                 // wait for one buffer to finish playing
                 if (!notify.WaitForSignal()) {
                     device_changed = true;
@@ -30,12 +30,21 @@ typedef ALCboolean(ALC_APIENTRY* LPALCISEXTENSIONPRESENT)(ALCdevice* device,
 typedef const ALCchar*(ALC_APIENTRY* LPALCGETSTRING)(ALCdevice* device, ALCenum param);
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <wx/arrstr.h>
 #include <wx/log.h>
 #include <wx/translation.h>
 #include <wx/utils.h>
 
 #include "core/base/check.h"
+#include "core/base/ringbuffer.h"
+#include "core/base/sound_driver.h"
 #include "core/gba/gbaGlobals.h"
 #include "core/gba/gbaSound.h"
 #include "wx/config/option-proxy.h"
@@ -74,8 +83,14 @@ public:
     void resume() override;  // play/resume the secondary sound buffer
     void write(uint16_t* finalWave,
                int length) override;  // write the emulated sound to a sound buffer
+    double bufferLevel() override;
 
 private:
+    // Runs on the feeder thread: refills the buffers OpenAL is done with from
+    // samples_buf, and keeps the source playing.
+    void feed(int buffer_count);
+    void stopFeeding();
+
     bool initialized;
     bool buffersLoaded;
     ALCdevice* device;
@@ -86,6 +101,15 @@ private:
     int freq;
     int soundBufferLen;
 
+    // Filled by write(), drained by the feeder thread. The emulation thread
+    // never makes an OpenAL call while emulating.
+    SpscRingBuffer<uint16_t> samples_buf;
+    std::thread feeder;
+    std::atomic<bool> feeding;
+    std::atomic<bool> paused;
+    // Serializes the OpenAL calls of the feeder and of the control functions.
+    std::mutex al_mutex;
+
 #ifdef LOGALL
     void debugState();
 #endif
@@ -100,12 +124,16 @@ OpenAL::OpenAL() {
     memset(buffer, 0, OPTION(kSoundBuffers) * sizeof(ALuint));
     tempBuffer = 0;
     source = 0;
+    feeding = false;
+    paused = false;
 }
 
 OpenAL::~OpenAL() {
     if (!initialized)
         return;
 
+    stopFeeding();
+
     alSourceStop(source);
     ASSERT_SUCCESS;
     alSourcei(source, AL_BUFFER, 0);
@@ -133,7 +161,7 @@ void OpenAL::debugState() {
     ALint value = 0;
     alGetSourcei(source, AL_SOURCE_STATE, &value);
     ASSERT_SUCCESS;
-    winlog(" soundPaused = %i\n", soundPaused);
+    winlog(" soundPaused = %i\n", gbaCore.soundPaused);
     winlog(" Source:\n");
     winlog("  State: ");
 
@@ -201,10 +229,94 @@ bool OpenAL::init(long sampleRate) {
     // calculate the number of samples per frame first
     // then multiply it with the size of a sample frame (16 bit * stereo)
     soundBufferLen = (freq / 60) * 4;
+
+    // Start with silence in every buffer, played once the first samples come.
+    std::vector<uint16_t> silence(soundBufferLen / 2, 0);
+    for (int i = 0; i < OPTION(kSoundBuffers); i++) {
+        alBufferData(buffer[i], AL_FORMAT_STEREO16, silence.data(), soundBufferLen, freq);
+        ASSERT_SUCCESS;
+    }
+    alSourceQueueBuffers(source, OPTION(kSoundBuffers), buffer);
+    ASSERT_SUCCESS;
+    buffersLoaded = true;
+
+    // Samples wait in the ring until a buffer is free. The emulator does not
+    // wait for the feeder, the ring is kept half full instead. It has room
+    // for about three buffers, and an even size keeps the stereo samples
+    // whole.
+    samples_buf.reset(static_cast<size_t>(std::ceil(kSoundDriverBufferSeconds * freq)) * 2);
+
     initialized = true;
+    feeding = true;
+    feeder = std::thread(&OpenAL::feed, this, OPTION(kSoundBuffers));
     return true;
 }
 
+void OpenAL::stopFeeding() {
+    feeding = false;
+    if (feeder.joinable())
+        feeder.join();
+}
+
+void OpenAL::feed(int buffer_count) {
+    std::vector<uint16_t> samples(soundBufferLen / 2);
+    // about half the time one buffer needs to finish
+    // unoptimized: ( sourceBufferLen * 1000 ) / ( freq * 2 * 2 ) * 1/2
+    const std::chrono::milliseconds wait(soundBufferLen / (freq >> 7));
+
+    while (feeding) {
+        {
+            std::lock_guard<std::mutex> lock(al_mutex);
+
+            ALint nBuffersProcessed = 0;
+            alGetSourcei(source, AL_BUFFERS_PROCESSED, &nBuffersProcessed);
+            ASSERT_SUCCESS;
+
+            if (nBuffersProcessed == buffer_count) {
+                // we only want to know about it when we are emulating at full speed or faster:
+                if ((coreOptions.throttle >= 100) || (coreOptions.throttle == 0)) {
+                    if (systemVerbose & VERBOSE_SOUNDOUTPUT) {
+                        static unsigned int i = 0;
+                        log("OpenAL: Buffers were not refilled fast enough (i=%i)\n", i++);
+                    }
+                }
+            }
+
+            while (nBuffersProcessed > 0 && samples_buf.used() >= samples.size()) {
+                samples_buf.read(samples.data(), samples.size());
+
+                // unqueue buffer
+                tempBuffer = 0;
+                alSourceUnqueueBuffers(source, 1, &tempBuffer);
+                ASSERT_SUCCESS;
+                // refill buffer
+                alBufferData(tempBuffer, AL_FORMAT_STEREO16, samples.data(), soundBufferLen, freq);
+                ASSERT_SUCCESS;
+                // requeue buffer
+                alSourceQueueBuffers(source, 1, &tempBuffer);
+                ASSERT_SUCCESS;
+
+                nBuffersProcessed--;
+            }
+
+            // start playing the source if necessary, once there is something
+            // to play after the queued buffers
+            if (!paused && samples_buf.used() > 0) {
+                ALint sourceState = 0;
+                alGetSourcei(source, AL_SOURCE_STATE, &sourceState);
+                ASSERT_SUCCESS;
+
+                if (sourceState != AL_PLAYING) {
+                    alSourcePlay(source);
+                    ASSERT_SUCCESS;
+                }
+            }
+        }
+
+        std::this_thread::sleep_for(wait);
+    }
+}
+
 void OpenAL::setThrottle(unsigned short throttle_) {
     if (!initialized)
         return;
@@ -212,6 +324,7 @@ void OpenAL::setThrottle(unsigned short throttle_) {
     if (!throttle_)
         throttle_ = 100;
 
+    std::lock_guard<std::mutex> lock(al_mutex);
     alSourcef(source, AL_PITCH, throttle_ / 100.0);
     ASSERT_SUCCESS;
 }
@@ -222,9 +335,11 @@ void OpenAL::resume() {
 
     winlog("OpenAL::resume\n");
 
+    paused = false;
     if (!buffersLoaded)
         return;
 
+    std::lock_guard<std::mutex> lock(al_mutex);
     debugState();
     ALint sourceState = 0;
     alGetSourcei(source, AL_SOURCE_STATE, &sourceState);
@@ -244,9 +359,11 @@ void OpenAL::pause() {
 
     winlog("OpenAL::pause\n");
 
+    paused = true;
     if (!buffersLoaded)
         return;
 
+    std::lock_guard<std::mutex> lock(al_mutex);
     debugState();
     ALint sourceState = 0;
     alGetSourcei(source, AL_SOURCE_STATE, &sourceState);
@@ -269,6 +386,7 @@ void OpenAL::reset() {
     if (!buffersLoaded)
         return;
 
+    std::lock_guard<std::mutex> lock(al_mutex);
     debugState();
     ALint sourceState = 0;
     alGetSourcei(source, AL_SOURCE_STATE, &sourceState);
@@ -283,82 +401,23 @@ void OpenAL::reset() {
 }
 
 void OpenAL::write(uint16_t* finalWave, int length) {
-    (void)length;  // unused param
     if (!initialized)
         return;
 
     winlog("OpenAL::write\n");
-    debugState();
-    ALint sourceState = 0;
-    ALint nBuffersProcessed = 0;
-
-    if (!buffersLoaded) {
-        // ==initial buffer filling==
-        winlog(" initial buffer filling\n");
-
-        for (int i = 0; i < OPTION(kSoundBuffers); i++) {
-            // Filling the buffers explicitly with silence would be cleaner,
-            // but the very first sample is usually silence anyway.
-            alBufferData(buffer[i], AL_FORMAT_STEREO16, finalWave, soundBufferLen, freq);
-            ASSERT_SUCCESS;
-        }
-
-        alSourceQueueBuffers(source, OPTION(kSoundBuffers), buffer);
-        ASSERT_SUCCESS;
-        buffersLoaded = true;
-    } else {
-        // ==normal buffer refreshing==
-        nBuffersProcessed = 0;
-        alGetSourcei(source, AL_BUFFERS_PROCESSED, &nBuffersProcessed);
-        ASSERT_SUCCESS;
-
-        if (nBuffersProcessed == OPTION(kSoundBuffers)) {
-            // we only want to know about it when we are emulating at full speed or faster:
-            if ((coreOptions.throttle >= 100) || (coreOptions.throttle == 0)) {
-                if (systemVerbose & VERBOSE_SOUNDOUTPUT) {
-                    static unsigned int i = 0;
-                    log("OpenAL: Buffers were not refilled fast enough (i=%i)\n", i++);
-                }
-            }
-        }
-
-        if (!coreOptions.speedup && coreOptions.throttle && !gba_joybus_active) {
-            // wait until at least one buffer has finished
-            while (nBuffersProcessed == 0) {
-                winlog(" waiting...\n");
-                // wait for about half the time one buffer needs to finish
-                // unoptimized: ( sourceBufferLen * 1000 ) / ( freq * 2 * 2 ) * 1/2
-                wxMilliSleep(soundBufferLen / (freq >> 7));
-                alGetSourcei(source, AL_BUFFERS_PROCESSED, &nBuffersProcessed);
-                ASSERT_SUCCESS;
-            }
-        } else {
-            if (nBuffersProcessed == 0)
-                return;
-        }
-
-        VBAM_CHECK(nBuffersProcessed > 0);
 
-        // unqueue buffer
-        tempBuffer = 0;
-        alSourceUnqueueBuffers(source, 1, &tempBuffer);
-        ASSERT_SUCCESS;
-        // refill buffer
-        alBufferData(tempBuffer, AL_FORMAT_STEREO16, finalWave, soundBufferLen, freq);
-        ASSERT_SUCCESS;
-        // requeue buffer
-        alSourceQueueBuffers(source, 1, &tempBuffer);
-        ASSERT_SUCCESS;
-    }
+    // Whole stereo samples only, so that the channels stay in order. What
+    // does not fit is dropped: the emulator never waits for the feeder, it is
+    // paced by the frame limiter.
+    const size_t values = (length / 4) * 2;
+    samples_buf.write(finalWave, std::min(values, samples_buf.avail() & ~(size_t)1));
+}
 
-    // start playing the source if necessary
-    alGetSourcei(source, AL_SOURCE_STATE, &sourceState);
-    ASSERT_SUCCESS;
+double OpenAL::bufferLevel() {
+    if (!initialized || !samples_buf.size())
+        return -1.0;
 
-    if (!soundPaused && (sourceState != AL_PLAYING)) {
-        alSourcePlay(source);
-        ASSERT_SUCCESS;
-    }
+    return static_cast<double>(samples_buf.used()) / samples_buf.size();
 }
 
 }  // namespace
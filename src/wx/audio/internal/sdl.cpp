@@ -20,13 +20,16 @@
 #include <SDL.h>
 #endif
 
+#include <cmath>
+
 #include <wx/arrstr.h>
 #include <wx/log.h>
 #include <wx/translation.h>
 #include <wx/utils.h>
 
-#include "core/base/sound_driver.h"
 #include "core/base/check.h"
+#include "core/base/ringbuffer.h"
+#include "core/base/sound_driver.h"
 #include "core/gba/gbaGlobals.h"
 #include "core/gba/gbaSound.h"
 #include "wx/config/option-proxy.h"
@@ -62,16 +65,26 @@ public:
     void reset() override;   // stop and reset the secondary sound buffer
     void resume() override;  // play/resume the secondary sound buffer
     void write(uint16_t* finalWave, int length) override;  // write the emulated sound to a sound buffer
+    double bufferLevel() override;
 
 private:
+#ifdef ENABLE_SDL3
+    static void soundCallback(void* data, SDL_AudioStream* stream, int additional_length, int length);
+#else
+    static void soundCallback(void* data, uint8_t* stream, int len);
+#endif
+    void read(uint16_t* stream, int length);
+
     SDL_AudioDeviceID sound_device = 0;
     SDL_AudioSpec audio;
 
+    // Filled by the emulator, drained by the audio callback.
+    SpscRingBuffer<uint16_t> samples_buf;
+    // Whether the callback plays from the buffer, owned by the callback.
+    bool primed = false;
+
 #ifdef ENABLE_SDL3
     SDL_AudioStream *sound_stream = NULL;
-    SDL_Mutex* mutex;
-#else
-    SDL_mutex* mutex;
 #endif
 
 #ifdef ENABLE_SDL3
@@ -97,18 +110,51 @@ void SDLAudio::deinit() {
         return;
     
     initialized = false;
-    
-    SDL_LockMutex(mutex);
-    int is_emulating = emulating;
-    emulating = 0;
-    SDL_UnlockMutex(mutex);
-    
-    SDL_DestroyMutex(mutex);
-    mutex = nullptr;
-    
+
+    // Waits for the callback to return.
     SDL_CloseAudioDevice(sound_device);
+}
 
-    emulating = is_emulating;
+#ifdef ENABLE_SDL3
+void SDLAudio::soundCallback(void* data, SDL_AudioStream* stream, int additional_length, int length) {
+    uint16_t streamdata[4096];
+    (void)length;
+
+    while (additional_length > 0) {
+        const int chunk = std::min(additional_length, static_cast<int>(sizeof(streamdata)));
+        reinterpret_cast<SDLAudio*>(data)->read(streamdata, chunk);
+        SDL_PutAudioStreamData(stream, streamdata, chunk);
+        additional_length -= chunk;
+    }
+}
+#else
+void SDLAudio::soundCallback(void* data, uint8_t* stream, int len) {
+    reinterpret_cast<SDLAudio*>(data)->read(reinterpret_cast<uint16_t*>(stream), len);
+}
+#endif
+
+// Called from the audio thread, never waits for the emulator: whatever is
+// missing is played as silence.
+void SDLAudio::read(uint16_t* stream, int length) {
+    if (length <= 0)
+        return;
+
+    const size_t values = length / 2;
+    size_t read = 0;
+
+    // The emulator does not wait for room in the buffer, so playback only
+    // starts, or starts again after running dry, once it is half full. This
+    // leaves some slack for the frame timing of the emulator.
+    if (!primed)
+        primed = samples_buf.used() >= samples_buf.size() / 2;
+
+    if (initialized && emulating && primed)
+        read = samples_buf.read(stream, values);
+
+    if (read < values)
+        primed = false;
+
+    SDL_memset(stream + read, 0, (values - read) * 2);
 }
 
 SDLAudio::~SDLAudio() {
@@ -146,9 +192,11 @@ bool SDLAudio::init(long sampleRate) {
 #ifdef ENABLE_SDL3
     if (SDL_InitSubSystem(SDL_INIT_AUDIO) == false) {
 #else
-    audio.samples  = 2048;
-    audio.callback = NULL;
-    audio.userdata = NULL;
+    // A short callback period keeps the buffer level steady, so that it can
+    // be kept half full.
+    audio.samples  = 512;
+    audio.callback = soundCallback;
+    audio.userdata = this;
 
     if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
 #endif
@@ -165,7 +213,7 @@ bool SDLAudio::init(long sampleRate) {
     
 #ifdef ENABLE_SDL3
 #ifdef ONLY_DEFAULT_AUDIO_DEVICE
-    sound_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio, NULL, NULL);
+    sound_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio, soundCallback, this);
 #else
     for (int i = 0; i < sdl_devices_count; i++) {
         devs = SDL_GetAudioDeviceName(sdl_devices[i]);
@@ -179,9 +227,9 @@ bool SDLAudio::init(long sampleRate) {
     }
 
     if (OPTION(kSoundAudioDevice) == _("Default device")) {
-        sound_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio, NULL, NULL);
+        sound_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio, soundCallback, this);
     } else {
-        sound_stream = SDL_OpenAudioDeviceStream(sdl_devices[current_device], &audio, NULL, NULL);
+        sound_stream = SDL_OpenAudioDeviceStream(sdl_devices[current_device], &audio, soundCallback, this);
     }
 
     if(sound_stream == NULL) {
@@ -208,8 +256,9 @@ bool SDLAudio::init(long sampleRate) {
         return false;
     }
     
-    mutex = SDL_CreateMutex();
-    
+    // An even size keeps the stereo samples whole.
+    samples_buf.reset(static_cast<size_t>(std::ceil(kSoundDriverBufferSeconds * sampleRate)) * 2);
+
     // turn off audio events because we are not processing them
 #ifdef ENABLE_SDL3
     SDL_SetEventEnabled(SDL_EVENT_AUDIO_DEVICE_ADDED, false);
@@ -284,12 +333,8 @@ void SDLAudio::reset() {
 }
 
 void SDLAudio::write(uint16_t* finalWave, int length) {
-    int res = 0;
-
     if (!initialized)
         return;
-    
-    SDL_LockMutex(mutex);
 
 #ifdef ENABLE_SDL3
     if (SDL_AudioDevicePaused(sound_device) == true) {
@@ -302,23 +347,18 @@ void SDLAudio::write(uint16_t* finalWave, int length) {
     }
 #endif
 
-#ifdef ENABLE_SDL3
-    res = (int)SDL_PutAudioStreamData(sound_stream, finalWave, length) == true;
-
-    while (res && SDL_GetAudioStreamQueued(sound_stream) > (2048 * audio.channels * sizeof(uint16_t))) {
-        SDL_Delay(1);
-    }
-#else
-    res = SDL_QueueAudio(sound_device, finalWave, length) == 0;
-
-    while (res && SDL_GetQueuedAudioSize(sound_device) > (audio.samples * audio.channels * sizeof(uint16_t))) {
-        SDL_Delay(1);
-    }
-#endif
+    // Whole stereo samples only, so that the channels stay in order. What
+    // does not fit is dropped: the emulator never waits for the callback, it
+    // is paced by the frame limiter.
+    const size_t values = (length / 4) * 2;
+    samples_buf.write(finalWave, std::min(values, samples_buf.avail() & ~(size_t)1));
+}
 
-    winlog("SDL audio queue result: %d\n", res);
+double SDLAudio::bufferLevel() {
+    if (!initialized || !samples_buf.size())
+        return -1.0;
 
-    SDL_UnlockMutex(mutex);
+    return static_cast<double>(samples_buf.used()) / samples_buf.size();
 }
 
 }  // namespace
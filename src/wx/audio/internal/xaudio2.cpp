@@ -480,7 +480,7 @@ void XAudio2_Output::write(uint16_t* finalWave, int) {
             break;
         } else {
             // the maximum number of buffers is currently queued
-            if (!coreOptions.speedup && coreOptions.throttle && !gba_joybus_active) {
+            if (!coreOptions.speedup && coreOptions.throttle && !gbaCore.gba_joybus_active) {
                 // wait for one buffer to finish playing
                 if (WaitForSingleObject(notify.hBufferEndEvent, 10000) == WAIT_TIMEOUT) {
                     device_changed = true;
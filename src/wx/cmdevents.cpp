@@ -319,29 +319,29 @@ EVT_HANDLER_MASK(RomInformation, "ROM information...", CMDEN_GB | CMDEN_GBA)
         wxString rom_crc32;
         rom_crc32.Printf(wxT("%08X"), panel->rom_crc32);
         SetDialogLabel(dlg, wxT("Title"), panel->rom_name, 30);
-        setlabs("IntTitle", g_rom[0xa0], 12);
+        setlabs("IntTitle", gbaCore.g_rom[0xa0], 12);
         SetDialogLabel(dlg, wxT("Scene"), panel->rom_scene_rls_name, 30);
         SetDialogLabel(dlg, wxT("Release"), panel->rom_scene_rls, 4);
         SetDialogLabel(dlg, wxT("CRC32"), rom_crc32, 8);
-        setlabs("GameCode", g_rom[0xac], 4);
-        setlabs("MakerCode", g_rom[0xb0], 2);
+        setlabs("GameCode", gbaCore.g_rom[0xac], 4);
+        setlabs("MakerCode", gbaCore.g_rom[0xb0], 2);
         s = dialogs::GetGameMakerName(s.ToStdString());
         setlab("MakerName");
-        setblab("UnitCode", g_rom[0xb3]);
-        s.Printf(wxT("%02x"), (unsigned int)g_rom[0xb4]);
+        setblab("UnitCode", gbaCore.g_rom[0xb3]);
+        s.Printf(wxT("%02x"), (unsigned int)gbaCore.g_rom[0xb4]);
 
-        if (g_rom[0xb4] & 0x80)
+        if (gbaCore.g_rom[0xb4] & 0x80)
             s.append(wxT(" (DACS)"));
 
         setlab("DeviceType");
-        setblab("Version", g_rom[0xbc]);
+        setblab("Version", gbaCore.g_rom[0xbc]);
         uint8_t crc = 0x19;
 
         for (int i = 0xa0; i < 0xbd; i++)
-            crc += g_rom[i];
+            crc += gbaCore.g_rom[i];
 
         crc = -crc;
-        s.Printf(wxT("%02x (%02x)"), crc, g_rom[0xbd]);
+        s.Printf(wxT("%02x (%02x)"), crc, gbaCore.g_rom[0xbd]);
         setlab("CRC");
         dlg->Fit();
         ShowModal(dlg);
@@ -619,7 +619,7 @@ EVT_HANDLER_MASK(ExportBatteryFile, "Export battery file...", CMDEN_GB | CMDEN_G
 
 EVT_HANDLER_MASK(ExportGamesharkSnapshot, "Export GameShark snapshot...", CMDEN_GBA)
 {
-    if (eepromInUse) {
+    if (gbaCore.eepromInUse) {
         wxLogError(_("EEPROM saves cannot be exported"));
         return;
     }
@@ -639,7 +639,7 @@ EVT_HANDLER_MASK(ExportGamesharkSnapshot, "Export GameShark snapshot...", CMDEN_
     wxTextCtrl *tit = XRCCTRL(*infodlg, "Title", wxTextCtrl),
                *dsc = XRCCTRL(*infodlg, "Description", wxTextCtrl),
                *n = XRCCTRL(*infodlg, "Notes", wxTextCtrl);
-    tit->SetValue(wxString((const char*)&g_rom[0xa0], wxConvLibc, 12));
+    tit->SetValue(wxString((const char*)&gbaCore.g_rom[0xa0], wxConvLibc, 12));
     dsc->SetValue(wxDateTime::Now().Format(wxT("%c")));
     n->SetValue(_("Exported from Visual Boy Advance-M"));
 
@@ -1482,7 +1482,7 @@ EVT_HANDLER_MASK(VideoLayersBG0, "Video layer BG0 (toggle)", CMDEN_GB | CMDEN_GB
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 8));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 8));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1494,7 +1494,7 @@ EVT_HANDLER_MASK(VideoLayersBG1, "Video layer BG1 (toggle)", CMDEN_GB | CMDEN_GB
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 9));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 9));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1506,7 +1506,7 @@ EVT_HANDLER_MASK(VideoLayersBG2, "Video layer BG2 (toggle)", CMDEN_GB | CMDEN_GB
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 10));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 10));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1518,7 +1518,7 @@ EVT_HANDLER_MASK(VideoLayersBG3, "Video layer BG3 (toggle)", CMDEN_GB | CMDEN_GB
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 11));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 11));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1530,7 +1530,7 @@ EVT_HANDLER_MASK(VideoLayersOBJ, "Video layer OBJ (toggle)", CMDEN_GB | CMDEN_GB
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 12));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 12));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1542,7 +1542,7 @@ EVT_HANDLER_MASK(VideoLayersWIN0, "Video layer WIN0 (toggle)", CMDEN_GB | CMDEN_
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 13));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 13));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1554,7 +1554,7 @@ EVT_HANDLER_MASK(VideoLayersWIN1, "Video layer WIN1 (toggle)", CMDEN_GB | CMDEN_
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 14));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 14));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1566,7 +1566,7 @@ EVT_HANDLER_MASK(VideoLayersOBJWIN, "Video layer OBJWIN (toggle)", CMDEN_GB | CM
     toggleBitVar(&menuPress, &coreOptions.layerSettings, (1 << 15));
     SetMenuOption(keyName, menuPress ? 1 : 0);
     GetMenuOptionInt(keyName, &coreOptions.layerSettings, (1 << 15));
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     CPUUpdateRenderBuffers(false);
 }
 
@@ -1582,7 +1582,7 @@ EVT_HANDLER_MASK(VideoLayersReset, "Show all video layers", CMDEN_GB | CMDEN_GBA
             }                                         \
     } while (0)
     coreOptions.layerSettings = 0x7f00;
-    coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
+    coreOptions.layerEnable = gbaCore.DISPCNT & coreOptions.layerSettings;
     set_vl("VideoLayersBG0");
     set_vl("VideoLayersBG1");
     set_vl("VideoLayersBG2");
@@ -1851,20 +1851,20 @@ void MainFrame::GDBBreak()
                 cmd_enable &= ~(CMDEN_NGDB_ANY | CMDEN_NGDB_GBA);
                 cmd_enable |= CMDEN_GDB;
                 enable_menus();
-                debugger = true;
+                gbaCore.debugger = true;
             } else {
                 remoteCleanUp();
             }
         } else {
-            if (armState) {
-                armNextPC -= 4;
-                reg[15].I -= 4;
+            if (gbaCore.armState) {
+                gbaCore.armNextPC -= 4;
+                gbaCore.reg[15].I -= 4;
             } else {
-                armNextPC -= 2;
-                reg[15].I -= 2;
+                gbaCore.armNextPC -= 2;
+                gbaCore.reg[15].I -= 2;
             }
 
-            debugger = true;
+            gbaCore.debugger = true;
         }
     }
 }
@@ -1880,7 +1880,7 @@ EVT_HANDLER_MASK(DebugGDBBreak, "Break into GDB", CMDEN_NGDB_GBA | CMDEN_GDB)
 EVT_HANDLER_MASK(DebugGDBDisconnect, "Disconnect GDB", CMDEN_GDB)
 {
 #if defined(VBAM_ENABLE_DEBUGGER)
-    debugger = false;
+    gbaCore.debugger = false;
     dbgMain = NULL;
     dbgSignal = NULL;
     dbgOutput = NULL;
@@ -1986,10 +1986,10 @@ EVT_HANDLER(GameBoyAdvanceConfigure, "Game Boy Advance options...")
              *ovmir = XRCCTRL(*dlg, "OvMirroring", wxChoice);
 
     if (panel->game_type() == IMAGE_GBA) {
-        wxString s = wxString((const char*)&g_rom[0xac], wxConvLibc, 4);
+        wxString s = wxString((const char*)&gbaCore.g_rom[0xac], wxConvLibc, 4);
         XRCCTRL(*dlg, "GameCode", wxControl)
             ->SetLabel(s);
-        cmt = wxString((const char*)&g_rom[0xa0], wxConvLibc, 12);
+        cmt = wxString((const char*)&gbaCore.g_rom[0xa0], wxConvLibc, 12);
         wxFileConfig* cfg = wxGetApp().overrides_.get();
 
         if (cfg->HasGroup(s)) {
@@ -2023,7 +2023,7 @@ EVT_HANDLER(GameBoyAdvanceConfigure, "Game Boy Advance options...")
 
     if (panel->game_type() == IMAGE_GBA) {
         agbPrintEnable(OPTION(kPrefAgbPrint));
-        wxString s = wxString((const char*)&g_rom[0xac], wxConvLibc, 4);
+        wxString s = wxString((const char*)&gbaCore.g_rom[0xac], wxConvLibc, 4);
         wxFileConfig* cfg = wxGetApp().overrides_.get();
         bool chg;
 
@@ -2163,7 +2163,7 @@ EVT_HANDLER_MASK(SoundConfigure, "Sound options...", CMDEN_NREC_ANY)
     // No point in observing these since they can only be set in this dialog.
     gb_effects_config.echo = (float)OPTION(kSoundGBEcho) / 100.0;
     gb_effects_config.stereo = (float)OPTION(kSoundGBStereo) / 100.0;
-    soundFiltering = (float)OPTION(kSoundGBAFiltering) / 100.0f;
+    gbaCore.soundFiltering = (float)OPTION(kSoundGBAFiltering) / 100.0f;
 }
 
 EVT_HANDLER(EmulatorDirectories, "Directories...")
@@ -2324,6 +2324,11 @@ EVT_HANDLER(PrintSnap, "Automatically save printouts as screen captures with -pr
     GetMenuOptionConfig("PrintSnap", config::OptionID::kGBPrintScreenCap);
 }
 
+EVT_HANDLER(SoundDynamicRate, "Sound dynamic rate control")
+{
+    GetMenuOptionConfig("SoundDynamicRate", config::OptionID::kSoundDynamicRate);
+}
+
 EVT_HANDLER(GBASoundInterpolation, "GBA sound interpolation")
 {
     GetMenuOptionConfig("GBASoundInterpolation", config::OptionID::kSoundGBAInterpolation);
@@ -14,6 +14,7 @@
 #include "core/base/check.h"
 #include "core/base/system.h"
 #include "core/gb/gbGlobals.h"
+#include "core/gba/gbaCore.h"
 #include "core/gba/gbaSound.h"
 #include "wx/opts.h"
 
@@ -370,9 +371,10 @@ std::array<Option, kNbOptions>& Option::All() {
         Option(OptionID::kSoundAudioAPI, &g_owned_opts.audio_api),
         Option(OptionID::kSoundAudioDevice, &g_owned_opts.audio_dev),
         Option(OptionID::kSoundBuffers, &g_owned_opts.audio_buffers, 2, 10),
+        Option(OptionID::kSoundDynamicRate, &gbaCore.g_soundDynamicRate),
         Option(OptionID::kSoundEnable, &gopts.sound_en, 0, 0x30f),
         Option(OptionID::kSoundGBAFiltering, &g_owned_opts.gba_sound_filtering, 0, 100),
-        Option(OptionID::kSoundGBAInterpolation, &g_gbaSoundInterpolation),
+        Option(OptionID::kSoundGBAInterpolation, &gbaCore.g_gbaSoundInterpolation),
         Option(OptionID::kSoundGBDeclicking, &g_owned_opts.gb_declicking),
         Option(OptionID::kSoundGBEcho, &g_owned_opts.gb_echo, 0, 100),
         Option(OptionID::kSoundGBEnableEffects, &g_owned_opts.gb_effects_config_enabled),
@@ -578,6 +580,8 @@ const std::array<OptionData, kNbOptions + 1> kAllOptionsData = {
     OptionData{"Sound/AudioAPI", "", _("Sound API; if unsupported, default API will be used")},
     OptionData{"Sound/AudioDevice", "", _("Device ID of chosen audio device for chosen driver")},
     OptionData{"Sound/Buffers", "", _("Number of sound buffers")},
+    OptionData{"Sound/DynamicRate", "SoundDynamicRate",
+               _("Let the vertical sync set the speed, adjusting the sound rate slightly to follow it")},
     OptionData{"Sound/Enable", "", _("Bit mask of sound channels to enable")},
     OptionData{"Sound/GBAFiltering", "", _("Game Boy Advance sound filtering (%)")},
     OptionData{"Sound/GBAInterpolation", "GBASoundInterpolation",
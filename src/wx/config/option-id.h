@@ -125,6 +125,7 @@ enum class OptionID {
     kSoundAudioAPI,
     kSoundAudioDevice,
     kSoundBuffers,
+    kSoundDynamicRate,
     kSoundEnable,
     kSoundGBAFiltering,
     kSoundGBAInterpolation,
@@ -129,6 +129,7 @@ static constexpr std::array<Option::Type, kNbOptions> kOptionsTypes = {
     /*kSoundAudioAPI*/ Option::Type::kAudioApi,
     /*kSoundAudioDevice*/ Option::Type::kString,
     /*kSoundBuffers*/ Option::Type::kInt,
+    /*kSoundDynamicRate*/ Option::Type::kBool,
     /*kSoundEnable*/ Option::Type::kInt,
     /*kSoundGBAFiltering*/ Option::Type::kInt,
     /*kSoundGBAInterpolation*/ Option::Type::kBool,
@@ -22,7 +22,7 @@ void utilReadScreenPixels(uint8_t* dest, int w, int h) {
     int sizeY = h;
     switch (systemColorDepth) {
         case 8: {
-            uint8_t* p = (uint8_t*)(g_pix + (w + 2));  // skip first black line
+            uint8_t* p = (uint8_t*)(gbaCore.g_pix + (w + 2));  // skip first black line
             for (int y = 0; y < sizeY; y++) {
                 for (int x = 0; x < sizeX; x++) {
                     uint8_t v = *p++;
@@ -43,7 +43,7 @@ void utilReadScreenPixels(uint8_t* dest, int w, int h) {
             }
         } break;
         case 16: {
-            uint16_t* p = (uint16_t*)(g_pix + (w + 2) * 2);  // skip first black line
+            uint16_t* p = (uint16_t*)(gbaCore.g_pix + (w + 2) * 2);  // skip first black line
             for (int y = 0; y < sizeY; y++) {
                 for (int x = 0; x < sizeX; x++) {
                     uint16_t v = *p++;
@@ -57,7 +57,7 @@ void utilReadScreenPixels(uint8_t* dest, int w, int h) {
             }
         } break;
         case 24: {
-            uint8_t* pixU8 = (uint8_t*)g_pix;
+            uint8_t* pixU8 = (uint8_t*)gbaCore.g_pix;
             for (int y = 0; y < sizeY; y++) {
                 for (int x = 0; x < sizeX; x++) {
                     if (systemRedShift < systemBlueShift) {
@@ -77,7 +77,7 @@ void utilReadScreenPixels(uint8_t* dest, int w, int h) {
             }
         } break;
         case 32: {
-            uint32_t* pixU32 = (uint32_t*)(g_pix + 4 * (w + 1));
+            uint32_t* pixU32 = (uint32_t*)(gbaCore.g_pix + 4 * (w + 1));
             for (int y = 0; y < sizeY; y++) {
                 for (int x = 0; x < sizeX; x++) {
                     uint32_t v = *pixU32++;
@@ -143,23 +143,23 @@ public:
     }
     void Update()
     {
-        mode = DISPCNT & 7;
+        mode = gbaCore.DISPCNT & 7;
 
         switch (bg) {
         case 0:
-            control = BG0CNT;
+            control = gbaCore.BG0CNT;
             break;
 
         case 1:
-            control = BG1CNT;
+            control = gbaCore.BG1CNT;
             break;
 
         case 2:
-            control = BG2CNT;
+            control = gbaCore.BG2CNT;
             break;
 
         case 3:
-            control = BG3CNT;
+            control = gbaCore.BG3CNT;
             break;
         }
 
@@ -178,7 +178,7 @@ public:
 
             if (bg == 3) {
                 bg = 0;
-                control = BG0CNT;
+                control = gbaCore.BG0CNT;
                 bg0->SetValue(true);
             }
 
@@ -195,7 +195,7 @@ public:
 
             if (bg < 2) {
                 bg = 2;
-                control = BG2CNT;
+                control = gbaCore.BG2CNT;
                 bg2->SetValue(true);
             }
 
@@ -316,7 +316,7 @@ public:
             addr_->SetLabel(s);
 
             if ((!mode || (mode < 3 || mode > 5)) && bg < 2) {
-                uint16_t value = *((uint16_t*)&g_vram[address - 0x6000000]);
+                uint16_t value = *((uint16_t*)&gbaCore.g_vram[address - 0x6000000]);
                 s.Printf(wxT("%d"), value & 1023);
                 tile_->SetLabel(s);
                 s = value & 1024 ? wxT('H') : wxT('-');
@@ -353,9 +353,9 @@ protected:
 
     void renderTextScreen()
     {
-        uint16_t* palette = (uint16_t*)g_paletteRAM;
-        uint8_t* charBase = &g_vram[((control >> 2) & 0x03) * 0x4000];
-        uint16_t* screenBase = (uint16_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+        uint16_t* palette = (uint16_t*)gbaCore.g_paletteRAM;
+        uint8_t* charBase = &gbaCore.g_vram[((control >> 2) & 0x03) * 0x4000];
+        uint16_t* screenBase = (uint16_t*)&gbaCore.g_vram[((control >> 8) & 0x1f) * 0x800];
         uint8_t* bmp = image.GetData();
         int sizeX = 256;
         int sizeY = 256;
@@ -483,7 +483,7 @@ protected:
 		switch (bg)
 		{
 		case 0:
-			renderView(BG0HOFS << 8, BG0VOFS << 8,
+			renderView(gbaCore.BG0HOFS << 8, gbaCore.BG0VOFS << 8,
 			           0x100, 0x000,
 			           0x000, 0x100,
 			           (sizeX - 1) << 8,
@@ -492,7 +492,7 @@ protected:
 			break;
 
 		case 1:
-			renderView(BG1HOFS << 8, BG1VOFS << 8,
+			renderView(gbaCore.BG1HOFS << 8, gbaCore.BG1VOFS << 8,
 			           0x100, 0x000,
 			           0x000, 0x100,
 			           (sizeX - 1) << 8,
@@ -501,7 +501,7 @@ protected:
 			break;
 
 		case 2:
-			renderView(BG2HOFS << 8, BG2VOFS << 8,
+			renderView(gbaCore.BG2HOFS << 8, gbaCore.BG2VOFS << 8,
 			           0x100, 0x000,
 			           0x000, 0x100,
 			           (sizeX - 1) << 8,
@@ -510,7 +510,7 @@ protected:
 			break;
 
 		case 3:
-			renderView(BG3HOFS << 8, BG3VOFS << 8,
+			renderView(gbaCore.BG3HOFS << 8, gbaCore.BG3VOFS << 8,
 			           0x100, 0x000,
 			           0x000, 0x100,
 			           (sizeX - 1) << 8,
@@ -524,9 +524,9 @@ protected:
 
     void renderRotScreen()
     {
-        uint16_t* palette = (uint16_t*)g_paletteRAM;
-        uint8_t* charBase = &g_vram[((control >> 2) & 0x03) * 0x4000];
-        uint8_t* screenBase = (uint8_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+        uint16_t* palette = (uint16_t*)gbaCore.g_paletteRAM;
+        uint8_t* charBase = &gbaCore.g_vram[((control >> 2) & 0x03) * 0x4000];
+        uint8_t* screenBase = (uint8_t*)&gbaCore.g_vram[((control >> 8) & 0x1f) * 0x800];
         uint8_t* bmp = image.GetData();
         int sizeX = 128;
         int sizeY = 128;
@@ -586,7 +586,7 @@ protected:
     void renderMode3()
     {
         uint8_t* bmp = image.GetData();
-        uint16_t* src = (uint16_t*)&g_vram[0];
+        uint16_t* src = (uint16_t*)&gbaCore.g_vram[0];
         BMPSize(240, 160);
 
         for (int y = 0; y < 160; y++) {
@@ -604,8 +604,8 @@ protected:
     void renderMode4()
     {
         uint8_t* bmp = image.GetData();
-        uint8_t* src = frame ? &g_vram[0xa000] : &g_vram[0];
-        uint16_t* pal = (uint16_t*)&g_paletteRAM[0];
+        uint8_t* src = frame ? &gbaCore.g_vram[0xa000] : &gbaCore.g_vram[0];
+        uint16_t* pal = (uint16_t*)&gbaCore.g_paletteRAM[0];
         BMPSize(240, 160);
 
         for (int y = 0; y < 160; y++) {
@@ -624,7 +624,7 @@ protected:
     void renderMode5()
     {
         uint8_t* bmp = image.GetData();
-        uint16_t* src = (uint16_t*)(frame ? &g_vram[0xa000] : &g_vram[0]);
+        uint16_t* src = (uint16_t*)(frame ? &gbaCore.g_vram[0xa000] : &gbaCore.g_vram[0]);
         BMPSize(160, 128);
 
         for (int y = 0; y < 128; y++) {
@@ -864,9 +864,9 @@ public:
         systemBlueShift = 19;
 
         for (int sprite_no = 0; sprite_no < 128; sprite_no++) {
-            uint16_t* sparms = &((uint16_t*)g_oam)[4 * sprite_no];
+            uint16_t* sparms = &((uint16_t*)gbaCore.g_oam)[4 * sprite_no];
             uint16_t a0 = sparms[0], a1 = sparms[1], a2 = sparms[2];
-            uint16_t* pal = &((uint16_t*)g_paletteRAM)[0x100];
+            uint16_t* pal = &((uint16_t*)gbaCore.g_paletteRAM)[0x100];
             int sizeX = 8, sizeY = 8;
 
             // following is almost verbatim from OamView.cpp
@@ -946,14 +946,14 @@ public:
                 //    return;
                 int inc = 32;
 
-                if (DISPCNT & 0x40)
+                if (gbaCore.DISPCNT & 0x40)
                     inc = sizeX >> 2;
                 else
                     c &= 0x3FE;
 
                 for (int y = 0; y < sizeY; y++) {
                     for (int x = 0; x < sizeX; x++) {
-                        uint32_t color = g_vram[0x10000 + (((c + (((y >> 3) * inc) << 5) + ((y & 7) << 4) + ((x >> 3) << 6) + (x & 7))) & 0x7FFF)];
+                        uint32_t color = gbaCore.g_vram[0x10000 + (((c + (((y >> 3) * inc) << 5) + ((y & 7) << 4) + ((x >> 3) << 6) + (x & 7))) & 0x7FFF)];
                         color = pal[color];
 
                         *bmp++ = (color & 0x1f) << 3;
@@ -969,14 +969,14 @@ public:
                 //    return;
                 int inc = 32;
 
-                if (DISPCNT & 0x40)
+                if (gbaCore.DISPCNT & 0x40)
                     inc = sizeX >> 3;
 
                 int palette = (a2 >> 8) & 0xF0;
 
                 for (int y = 0; y < sizeY; y++) {
                     for (int x = 0; x < sizeX; x++) {
-                        uint32_t color = g_vram[0x10000 + ((((((c + (((y >> 3) * inc) << 5)) + ((y & 7) << 2)) + ((x >> 3) << 5)) + ((x & 7) >> 1))) & 0x7FFF)];
+                        uint32_t color = gbaCore.g_vram[0x10000 + ((((((c + (((y >> 3) * inc) << 5)) + ((y & 7) << 2)) + ((x >> 3) << 5)) + ((x & 7) >> 1))) & 0x7FFF)];
 
                         if (x & 1)
                             color >>= 4;
@@ -1311,8 +1311,8 @@ public:
     }
     void Update()
     {
-        if (g_paletteRAM) {
-            uint16_t* pp = (uint16_t*)g_paletteRAM;
+        if (gbaCore.g_paletteRAM) {
+            uint16_t* pp = (uint16_t*)gbaCore.g_paletteRAM;
             uint8_t* bmp = colbmp;
 
             for (int i = 0; i < 512; i++, pp++) {
@@ -1395,10 +1395,10 @@ public:
             *cd = dlg.GetColourData();
             wxColour c = cd->GetColour();
             //Binary or the upper 5 bits of each color choice
-            customBackdropColor = ((c.Red() >> 3) != 0) || (((c.Green() >> 3) << 5) != 0) || (((c.Blue() >> 3) << 10) != 0);
+            gbaCore.customBackdropColor = ((c.Red() >> 3) != 0) || (((c.Green() >> 3) << 5) != 0) || (((c.Blue() >> 3) << 10) != 0);
         } else
             // kind of an unintuitive way to turn it off...
-            customBackdropColor = -1;
+            gbaCore.customBackdropColor = -1;
     }
 
 protected:
@@ -1555,8 +1555,8 @@ public:
     void Update()
     {
         // Following copied almost verbatim from TileView.cpp
-        uint16_t* palette = (uint16_t*)g_paletteRAM;
-        uint8_t* charBase = &g_vram[charbase_];
+        uint16_t* palette = (uint16_t*)gbaCore.g_paletteRAM;
+        uint8_t* charBase = &gbaCore.g_vram[charbase_];
         int maxY;
 
         if (is256_) {
@@ -232,14 +232,14 @@ public:
                 list->Check(i, gbCheatList[i].enabled);
             }
         } else {
-            for (int i = start; i < cheatsNumber; i++) {
+            for (int i = start; i < gbaCore.cheatsNumber; i++) {
                 item0.SetId(i);
-                item0.SetText(wxString(cheatsList[i].codestring, wxConvLibc));
+                item0.SetText(wxString(gbaCore.cheatsList[i].codestring, wxConvLibc));
                 list->InsertItem(item0);
                 item1.SetId(i);
-                item1.SetText(wxString(cheatsList[i].desc, wxConvUTF8));
+                item1.SetText(wxString(gbaCore.cheatsList[i].desc, wxConvUTF8));
                 list->SetItem(item1);
-                list->Check(i, cheatsList[i].enabled);
+                list->Check(i, gbaCore.cheatsList[i].enabled);
             }
         }
 
@@ -326,7 +326,7 @@ public:
         } break;
 
         case wxID_ADD: {
-            int ncheats = isgb ? gbCheatNumber : cheatsNumber;
+            int ncheats = isgb ? gbCheatNumber : gbaCore.cheatsNumber;
             ce_codes = wxEmptyString;
             wxDialog* subdlg = GetXRCDialog("CheatEdit");
             dlg->SetWindowStyle(wxCAPTION | wxRESIZE_BORDER);
@@ -366,7 +366,7 @@ public:
                     gbCheatRemoveAll();
                 }
             } else {
-                if (cheatsNumber) {
+                if (gbaCore.cheatsNumber) {
                     bool restore = wxMessageBox(_("Restore old values?"),
                                        _("Removing cheats"),
                                        wxYES_NO | wxICON_QUESTION)
@@ -404,17 +404,17 @@ public:
             } else {
                 int i;
 
-                for (i = 0; i < cheatsNumber; i++)
-                    if (!cheatsList[i].enabled)
+                for (i = 0; i < gbaCore.cheatsNumber; i++)
+                    if (!gbaCore.cheatsList[i].enabled)
                         break;
 
-                if (i < cheatsNumber)
-                    for (; i < cheatsNumber; i++) {
+                if (i < gbaCore.cheatsNumber)
+                    for (; i < gbaCore.cheatsNumber; i++) {
                         cheatsEnable(i);
                         list->Check(i, true);
                     }
                 else
-                    for (i = 0; i < cheatsNumber; i++) {
+                    for (i = 0; i < gbaCore.cheatsNumber; i++) {
                         cheatsDisable(i);
                         list->Check(i, false);
                     }
@@ -434,7 +434,7 @@ public:
                 *dirty = true;
             }
         } else {
-            if (!cheatsList[ch].enabled) {
+            if (!gbaCore.cheatsList[ch].enabled) {
                 cheatsEnable(ev.GetIndex());
                 *dirty = true;
             }
@@ -451,7 +451,7 @@ public:
                 *dirty = true;
             }
         } else {
-            if (cheatsList[ch].enabled) {
+            if (gbaCore.cheatsList[ch].enabled) {
                 cheatsDisable(ev.GetIndex());
                 *dirty = true;
             }
@@ -534,9 +534,9 @@ public:
             else
                 otype = ce_type = 1;
         } else {
-            ochecked = cheatsList[id].enabled;
-            ce_codes = ocode = wxString(cheatsList[id].codestring, wxConvLibc);
-            ce_desc = odesc = wxString(cheatsList[id].desc, wxConvUTF8);
+            ochecked = gbaCore.cheatsList[id].enabled;
+            ce_codes = ocode = wxString(gbaCore.cheatsList[id].codestring, wxConvLibc);
+            ce_desc = odesc = wxString(gbaCore.cheatsList[id].desc, wxConvUTF8);
 
             if (ce_codes.find(wxT(':')) != wxString::npos)
                 otype = ce_type = 0;
@@ -562,7 +562,7 @@ public:
             // edited codes to the rear on gb codes.
             // It might be safest to only support desc edits, and force the
             // user to re-enter codes to change them
-            int ncodes = isgb ? gbCheatNumber : cheatsNumber;
+            int ncodes = isgb ? gbCheatNumber : gbaCore.cheatsNumber;
 
             if (ncodes > id + 1) {
                 wxString codes[MAX_CHEATS];
@@ -571,12 +571,12 @@ public:
                 bool v3[MAX_CHEATS];
 
                 for (int i = id + 1; i < ncodes; i++) {
-                    codes[i - id - 1] = wxString(isgb ? gbCheatList[i].cheatCode : cheatsList[i].codestring,
+                    codes[i - id - 1] = wxString(isgb ? gbCheatList[i].cheatCode : gbaCore.cheatsList[i].codestring,
                         wxConvLibc);
-                    descs[i - id - 1] = wxString(isgb ? gbCheatList[i].cheatDesc : cheatsList[i].desc,
+                    descs[i - id - 1] = wxString(isgb ? gbCheatList[i].cheatDesc : gbaCore.cheatsList[i].desc,
                         wxConvUTF8);
-                    checked[i - id - 1] = isgb ? gbCheatList[i].enabled : cheatsList[i].enabled;
-                    v3[i - id - 1] = isgb ? false : cheatsList[i].code == 257;
+                    checked[i - id - 1] = isgb ? gbCheatList[i].enabled : gbaCore.cheatsList[i].enabled;
+                    v3[i - id - 1] = isgb ? false : gbaCore.cheatsList[i].code == 257;
                 }
 
                 for (int i = ncodes - 1; i >= id; i--) {
@@ -585,7 +585,7 @@ public:
                     if (isgb)
                         gbCheatRemove(i);
                     else
-                        cheatsDelete(i, cheatsList[i].enabled);
+                        cheatsDelete(i, gbaCore.cheatsList[i].enabled);
                 }
 
                 AddCheat();
@@ -634,7 +634,7 @@ public:
                 if (isgb)
                     gbCheatRemove(id);
                 else
-                    cheatsDelete(id, cheatsList[id].enabled);
+                    cheatsDelete(id, gbaCore.cheatsList[id].enabled);
 
                 AddCheat();
 
@@ -649,9 +649,9 @@ public:
             Reload(id);
         } else if (ce_desc != odesc) {
             *dirty = true;
-            char* p = isgb ? gbCheatList[id].cheatDesc : cheatsList[id].desc;
-            strncpy(p, ce_desc.utf8_str(), sizeof(cheatsList[0].desc));
-            p[sizeof(cheatsList[0].desc) - 1] = 0;
+            char* p = isgb ? gbCheatList[id].cheatDesc : gbaCore.cheatsList[id].desc;
+            strncpy(p, ce_desc.utf8_str(), sizeof(gbaCore.cheatsList[0].desc));
+            p[sizeof(gbaCore.cheatsList[0].desc) - 1] = 0;
             item1.SetId(id);
             item1.SetText(wxString(p, wxConvUTF8));
             list->SetItem(item1);
@@ -822,7 +822,7 @@ public:
     ~CheatFind_t()
     {
         // not that it matters to anyone but mem leak detectors..
-        cheatSearchCleanup(&cheatSearchData);
+        cheatSearchCleanup(&gbaCore.cheatSearchData);
     }
 
     void Search(wxCommandEvent& ev)
@@ -834,13 +834,13 @@ public:
             return;
         }
 
-        if (!cheatSearchData.count)
+        if (!gbaCore.cheatSearchData.count)
             ResetSearch(ev);
 
         if (valsrc)
-            cheatSearch(&cheatSearchData, op, size, fmt == CFVFMT_SD);
+            cheatSearch(&gbaCore.cheatSearchData, op, size, fmt == CFVFMT_SD);
         else
-            cheatSearchValue(&cheatSearchData, op, size, fmt == CFVFMT_SD,
+            cheatSearchValue(&gbaCore.cheatSearchData, op, size, fmt == CFVFMT_SD,
                 SignedValue());
 
         Deselect();
@@ -848,8 +848,8 @@ public:
         list->count8 = list->count16 = list->count32 = 0;
         list->cap_size = size;
 
-        for (int i = 0; i < cheatSearchData.count; i++) {
-            CheatSearchBlock* block = &cheatSearchData.blocks[i];
+        for (int i = 0; i < gbaCore.cheatSearchData.count; i++) {
+            CheatSearchBlock* block = &gbaCore.cheatSearchData.blocks[i];
 
             for (int j = 0; j < block->size; j += (1 << size)) {
                 if (IS_BIT_SET(block->bits, j)) {
@@ -919,8 +919,8 @@ public:
     void UpdateVals(wxCommandEvent& ev)
     {
         (void)ev; // unused params
-        if (cheatSearchData.count) {
-            cheatSearchUpdateValues(&cheatSearchData);
+        if (gbaCore.cheatSearchData.count) {
+            cheatSearchUpdateValues(&gbaCore.cheatSearchData);
 
             if (list->count8)
                 list->Refresh();
@@ -932,8 +932,8 @@ public:
     void ResetSearch(wxCommandEvent& ev)
     {
         (void)ev; // unused params
-        if (!cheatSearchData.count) {
-            CheatSearchBlock* block = cheatSearchData.blocks;
+        if (!gbaCore.cheatSearchData.count) {
+            CheatSearchBlock* block = gbaCore.cheatSearchData.blocks;
 
             if (isgb) {
                 block->offset = 0xa000;
@@ -972,20 +972,20 @@ public:
                 block->size = 0x40000;
                 block->offset = 0x2000000;
                 block->bits = (uint8_t*)malloc(0x40000 >> 3);
-                block->data = g_workRAM;
+                block->data = gbaCore.g_workRAM;
                 block->saved = (uint8_t*)malloc(0x40000);
                 block++;
                 block->size = 0x8000;
                 block->offset = 0x3000000;
                 block->bits = (uint8_t*)malloc(0x8000 >> 3);
-                block->data = g_internalRAM;
+                block->data = gbaCore.g_internalRAM;
                 block->saved = (uint8_t*)malloc(0x8000);
             }
 
-            cheatSearchData.count = (int)((block + 1) - cheatSearchData.blocks);
+            gbaCore.cheatSearchData.count = (int)((block + 1) - gbaCore.cheatSearchData.blocks);
         }
 
-        cheatSearchStart(&cheatSearchData);
+        cheatSearchStart(&gbaCore.cheatSearchData);
 
         if (list->count8) {
             Deselect();
@@ -1301,7 +1301,7 @@ void MainFrame::ResetCheatSearch()
     cfh.list->count8 = cfh.list->count16 = cfh.list->count32 = 0;
     cfh.list->addrs.clear();
     cfh.ca_desc = wxEmptyString;
-    cheatSearchCleanup(&cheatSearchData);
+    cheatSearchCleanup(&gbaCore.cheatSearchData);
 }
 
 // onshow handler for above, in the form of an overzealous validator
@@ -1357,7 +1357,7 @@ wxString CheatListCtrl::OnGetItemText(long item, long column) const
         }
     }
 
-    CheatSearchBlock* block = &cheatSearchData.blocks[addrs[item] >> 28];
+    CheatSearchBlock* block = &gbaCore.cheatSearchData.blocks[addrs[item] >> 28];
     off += addrs[item] & 0xfffffff;
 
     switch (column) {
@@ -1435,7 +1435,7 @@ public:
         type->SetSelection(coreOptions.saveType);
 
         if (coreOptions.saveType == GBA_SAVE_FLASH) {
-            size->SetSelection(g_flashSize == 0x20000 ? 1 : 0);
+            size->SetSelection(gbaCore.g_flashSize == 0x20000 ? 1 : 0);
             size->Enable();
         } else {
             size->Disable();
@@ -2169,7 +2169,7 @@ bool MainFrame::BindControls()
             ch = GetValidatedChild<wxChoice, wxGenericValidator>(d, "Type", wxGenericValidator(&cheat_list_handler.ce_type));
             cheat_list_handler.ce_type_ch = ch;
             gettc("Desc", cheat_list_handler.ce_desc);
-            tc->SetMaxLength(sizeof(cheatsList[0].desc) - 1);
+            tc->SetMaxLength(sizeof(gbaCore.cheatsList[0].desc) - 1);
             gettc("Codes", cheat_list_handler.ce_codes);
             cheat_list_handler.ce_codes_tc = tc;
             d->Fit();
@@ -2249,7 +2249,7 @@ bool MainFrame::BindControls()
         {
             // d->Reparent(cheat_find_handler.dlg); // broken
             gettc("Desc", cheat_find_handler.ca_desc);
-            tc->SetMaxLength(sizeof(cheatsList[0].desc) - 1);
+            tc->SetMaxLength(sizeof(gbaCore.cheatsList[0].desc) - 1);
             gettc("Value", cheat_find_handler.ca_val);
             cheat_find_handler.ca_val_tc = tc;
             // MFC interface used this for cheat list's generic code adder as well,
@@ -1,7 +1,7 @@
 // this is essentially a copy of ../win32/IOViewRegisters.h using translatable
 // strings and more consts
 struct IOData {
-    uint16_t* address;
+    uint16_t GbaCore::*address;
     uint16_t offset;
     const wxString name;
     uint16_t write;
@@ -10,7 +10,7 @@ struct IOData {
 
 /* const */ IOData ioregs[] = // not const so tranlation can be done once
     {
-      { &DISPCNT,
+      { &GbaCore::DISPCNT,
           0,
           wxTRANSLATE("0x4000000-DISPCNT"),
           0xFFF7,
@@ -30,7 +30,7 @@ struct IOData {
               wxTRANSLATE("WIN0"),
               wxTRANSLATE("WIN1"),
               wxTRANSLATE("OBJWIN") } },
-      { &DISPSTAT,
+      { &GbaCore::DISPSTAT,
           4,
           wxTRANSLATE("0x4000004-DISPSTAT"),
           0xFF38,
@@ -50,7 +50,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("VCOUNT setting (8 bits)") } },
-      { &VCOUNT,
+      { &GbaCore::VCOUNT,
           6,
           wxTRANSLATE("0x4000006-VCOUNT"),
           0x0000,
@@ -70,7 +70,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG0CNT,
+      { &GbaCore::BG0CNT,
           8,
           wxTRANSLATE("0x4000008-BG0CNT"),
           0xDFCF,
@@ -90,7 +90,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("Size (2 bits)") } },
-      { &BG1CNT,
+      { &GbaCore::BG1CNT,
           0xA,
           wxTRANSLATE("0x400000A-BG1CNT"),
           0xDFCF,
@@ -110,7 +110,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("Size (2 bits)") } },
-      { &BG2CNT,
+      { &GbaCore::BG2CNT,
           0xC,
           wxTRANSLATE("0x400000C-BG2CNT"),
           0xFFCF,
@@ -130,7 +130,7 @@ struct IOData {
               wxTRANSLATE("Area Overflow"),
               wxT(""),
               wxTRANSLATE("Size (2 bits)") } },
-      { &BG3CNT,
+      { &GbaCore::BG3CNT,
           0xE,
           wxTRANSLATE("0x400000E-BG3CNT"),
           0xFFCF,
@@ -150,7 +150,7 @@ struct IOData {
               wxTRANSLATE("Area Overflow"),
               wxT(""),
               wxTRANSLATE("Size (2 bits)") } },
-      { &BG0HOFS,
+      { &GbaCore::BG0HOFS,
           0x10,
           wxTRANSLATE("0x4000010-BG0HOFS"),
           0x01FF,
@@ -170,7 +170,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG0VOFS,
+      { &GbaCore::BG0VOFS,
           0x12,
           wxTRANSLATE("0x4000012-BG0VOFS"),
           0x01FF,
@@ -190,7 +190,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG1HOFS,
+      { &GbaCore::BG1HOFS,
           0x14,
           wxTRANSLATE("0x4000014-BG1HOFS"),
           0x01FF,
@@ -210,7 +210,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG1VOFS,
+      { &GbaCore::BG1VOFS,
           0x16,
           wxTRANSLATE("0x4000016-BG1VOFS"),
           0x01FF,
@@ -230,7 +230,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG2HOFS,
+      { &GbaCore::BG2HOFS,
           0x18,
           wxTRANSLATE("0x4000018-BG2HOFS"),
           0x01FF,
@@ -250,7 +250,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG2VOFS,
+      { &GbaCore::BG2VOFS,
           0x1A,
           wxTRANSLATE("0x400001A-BG2VOFS"),
           0x01FF,
@@ -270,7 +270,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG3HOFS,
+      { &GbaCore::BG3HOFS,
           0x1C,
           wxTRANSLATE("0x400001C-BG3HOFS"),
           0x01FF,
@@ -290,7 +290,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG3VOFS,
+      { &GbaCore::BG3VOFS,
           0x1E,
           wxTRANSLATE("0x400001E-BG3VOFS"),
           0x01FF,
@@ -310,7 +310,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxT("") } },
-      { &BG2PA,
+      { &GbaCore::BG2PA,
           0x20,
           wxTRANSLATE("0x4000020-BG2PA"),
           0xFFFF,
@@ -330,7 +330,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dx (16 bits,W)") } },
-      { &BG2PB,
+      { &GbaCore::BG2PB,
           0x22,
           wxTRANSLATE("0x4000022-BG2PB"),
           0xFFFF,
@@ -350,7 +350,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dmx (16 bits,W)") } },
-      { &BG2PC,
+      { &GbaCore::BG2PC,
           0x24,
           wxTRANSLATE("0x4000024-BG2PC"),
           0xFFFF,
@@ -370,7 +370,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dy (16 bits,W)") } },
-      { &BG2PD,
+      { &GbaCore::BG2PD,
           0x26,
           wxTRANSLATE("0x4000026-BG2PD"),
           0xFFFF,
@@ -390,7 +390,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dmy (16 bits,W)") } },
-      { &BG2X_L,
+      { &GbaCore::BG2X_L,
           0x28,
           wxTRANSLATE("0x4000028-BG2X_L"),
           0xFFFF,
@@ -410,7 +410,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("X low bits (16 bits,W)") } },
-      { &BG2X_H,
+      { &GbaCore::BG2X_H,
           0x2A,
           wxTRANSLATE("0x400002A-BG2X_H"),
           0x0FFF,
@@ -432,7 +432,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &BG2Y_L,
+      { &GbaCore::BG2Y_L,
           0x2C,
           wxTRANSLATE("0x400002C-BG2Y_L"),
           0xFFFF,
@@ -452,7 +452,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("Y low bits (16 bits,W)") } },
-      { &BG2Y_H,
+      { &GbaCore::BG2Y_H,
           0x2E,
           wxTRANSLATE("0x400002E-BG2Y_H"),
           0x0FFF,
@@ -474,7 +474,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &BG3PA,
+      { &GbaCore::BG3PA,
           0x30,
           wxTRANSLATE("0x4000030-BG3PA"),
           0xFFFF,
@@ -494,7 +494,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dx (16 bits,W)") } },
-      { &BG3PB,
+      { &GbaCore::BG3PB,
           0x32,
           wxTRANSLATE("0x4000032-BG3PB"),
           0xFFFF,
@@ -514,7 +514,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dmx (16 bits,W)") } },
-      { &BG3PC,
+      { &GbaCore::BG3PC,
           0x34,
           wxTRANSLATE("0x4000034-BG3PC"),
           0xFFFF,
@@ -534,7 +534,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dy (16 bits,W)") } },
-      { &BG3PD,
+      { &GbaCore::BG3PD,
           0x36,
           wxTRANSLATE("0x4000036-BG3PD"),
           0xFFFF,
@@ -554,7 +554,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("dmy (16 bits,W)") } },
-      { &BG3X_L,
+      { &GbaCore::BG3X_L,
           0x38,
           wxTRANSLATE("0x4000038-BG3X_L"),
           0xFFFF,
@@ -574,7 +574,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("X low bits (16 bits,W)") } },
-      { &BG3X_H,
+      { &GbaCore::BG3X_H,
           0x3A,
           wxTRANSLATE("0x400003A-BG3X_H"),
           0x0FFF,
@@ -596,7 +596,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &BG3Y_L,
+      { &GbaCore::BG3Y_L,
           0x3C,
           wxTRANSLATE("0x400003C-BG3Y_L"),
           0xFFFF,
@@ -616,7 +616,7 @@ struct IOData {
               wxT(""),
               wxT(""),
               wxTRANSLATE("Y low bits (16 bits,W)") } },
-      { &BG3Y_H,
+      { &GbaCore::BG3Y_H,
           0x3E,
           wxTRANSLATE("0x400003E-BG3Y_H"),
           0x0FFF,
@@ -638,7 +638,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &WIN0H,
+      { &GbaCore::WIN0H,
           0x40,
           wxTRANSLATE("0x4000040-WIN0H"),
           0xFFFF,
@@ -660,7 +660,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Win 0 upper-left X (8 bits,W)"),
           } },
-      { &WIN1H,
+      { &GbaCore::WIN1H,
           0x42,
           wxTRANSLATE("0x4000042-WIN1H"),
           0xFFFF,
@@ -682,7 +682,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Win 1 upper-left (8 bits,W)"),
           } },
-      { &WIN0V,
+      { &GbaCore::WIN0V,
           0x44,
           wxTRANSLATE("0x4000044-WIN0V"),
           0xFFFF,
@@ -704,7 +704,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Win 0 upper-left Y (8 bits,W)"),
           } },
-      { &WIN1V,
+      { &GbaCore::WIN1V,
           0x46,
           wxTRANSLATE("0x4000046-WIN1V"),
           0xFFFF,
@@ -726,7 +726,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Win 1 upper-left Y (8 bits,W)"),
           } },
-      { &WININ,
+      { &GbaCore::WININ,
           0x48,
           wxTRANSLATE("0x4000048-WININ"),
           0x3F3F,
@@ -748,7 +748,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &WINOUT,
+      { &GbaCore::WINOUT,
           0x4A,
           wxTRANSLATE("0x400004A-WINOUT"),
           0x3F3F,
@@ -770,7 +770,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &MOSAIC,
+      { &GbaCore::MOSAIC,
           0x4C,
           wxTRANSLATE("0x400004C-MOSAIC"),
           0xFFFF,
@@ -792,7 +792,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("OBJ V Size (4 bits,W)"),
           } },
-      { &BLDMOD,
+      { &GbaCore::BLDMOD,
           0x50,
           wxTRANSLATE("0x4000050-BLDMOD"),
           0x3FFF,
@@ -814,7 +814,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &COLEV,
+      { &GbaCore::COLEV,
           0x52,
           wxTRANSLATE("0x4000052-COLEV"),
           0x1F1F,
@@ -836,7 +836,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &COLY,
+      { &GbaCore::COLY,
           0x54,
           wxTRANSLATE("0x4000054-COLEY"),
           0x001F,
@@ -1254,7 +1254,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Data 3 (8 bits)"),
           } },
-      { &DM0SAD_L,
+      { &GbaCore::DM0SAD_L,
           0xB0,
           wxTRANSLATE("0x40000B0-DM0SAD_L"),
           0xFFFF,
@@ -1276,7 +1276,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Source Address (lower 16 bits)"),
           } },
-      { &DM0SAD_H,
+      { &GbaCore::DM0SAD_H,
           0xB2,
           wxTRANSLATE("0x40000B2-DM0SAD_H"),
           0x07FF,
@@ -1298,7 +1298,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM0DAD_L,
+      { &GbaCore::DM0DAD_L,
           0xB4,
           wxTRANSLATE("0x40000B4-DM0DAD_L"),
           0xFFFF,
@@ -1320,7 +1320,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Destination Address (lower 16 bits)"),
           } },
-      { &DM0DAD_H,
+      { &GbaCore::DM0DAD_H,
           0xB6,
           wxTRANSLATE("0x40000B6-DM0DAD_H"),
           0x07FF,
@@ -1342,7 +1342,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM0CNT_L,
+      { &GbaCore::DM0CNT_L,
           0xB8,
           wxTRANSLATE("0x40000B8-DM0CNT_L"),
           0x3FFF,
@@ -1364,7 +1364,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM0CNT_H,
+      { &GbaCore::DM0CNT_H,
           0xBA,
           wxTRANSLATE("0x40000BA-DM0CNT_H"),
           0xF7E0,
@@ -1386,7 +1386,7 @@ struct IOData {
               wxTRANSLATE("Interrupt Request"),
               wxTRANSLATE("Enable"),
           } },
-      { &DM1SAD_L,
+      { &GbaCore::DM1SAD_L,
           0xBC,
           wxTRANSLATE("0x40000BC-DM1SAD_L"),
           0xFFFF,
@@ -1408,7 +1408,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Source Address (lower 16 bits)"),
           } },
-      { &DM1SAD_H,
+      { &GbaCore::DM1SAD_H,
           0xBE,
           wxTRANSLATE("0x40000BE-DM1SAD_H"),
           0x0FFF,
@@ -1430,7 +1430,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM1DAD_L,
+      { &GbaCore::DM1DAD_L,
           0xC0,
           wxTRANSLATE("0x40000C0-DM1DAD_L"),
           0xFFFF,
@@ -1452,7 +1452,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Destination Address (lower 16 bits)"),
           } },
-      { &DM1DAD_H,
+      { &GbaCore::DM1DAD_H,
           0xC2,
           wxTRANSLATE("0x40000C2-DM1DAD_H"),
           0x07FF,
@@ -1474,7 +1474,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM1CNT_L,
+      { &GbaCore::DM1CNT_L,
           0xC4,
           wxTRANSLATE("0x40000C4-DM1CNT_L"),
           0x3FFF,
@@ -1496,7 +1496,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM1CNT_H,
+      { &GbaCore::DM1CNT_H,
           0xC6,
           wxTRANSLATE("0x40000C6-DM1CNT_H"),
           0xF7E0,
@@ -1518,7 +1518,7 @@ struct IOData {
               wxTRANSLATE("Interrupt Request"),
               wxTRANSLATE("Enable"),
           } },
-      { &DM2SAD_L,
+      { &GbaCore::DM2SAD_L,
           0xC8,
           wxTRANSLATE("0x40000C8-DM2SAD_L"),
           0xFFFF,
@@ -1540,7 +1540,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Source Address (lower 16 bits)"),
           } },
-      { &DM2SAD_H,
+      { &GbaCore::DM2SAD_H,
           0xCA,
           wxTRANSLATE("0x40000CA-DM2SAD_H"),
           0x0FFF,
@@ -1562,7 +1562,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM2DAD_L,
+      { &GbaCore::DM2DAD_L,
           0xCC,
           wxTRANSLATE("0x40000CC-DM2DAD_L"),
           0xFFFF,
@@ -1584,7 +1584,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Destination Address (lower 16 bits)"),
           } },
-      { &DM2DAD_H,
+      { &GbaCore::DM2DAD_H,
           0xCE,
           wxTRANSLATE("0x40000CE-DM2DAD_H"),
           0x07FF,
@@ -1606,7 +1606,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM2CNT_L,
+      { &GbaCore::DM2CNT_L,
           0xD0,
           wxTRANSLATE("0x40000D0-DM2CNT_L"),
           0x3FFF,
@@ -1628,7 +1628,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM2CNT_H,
+      { &GbaCore::DM2CNT_H,
           0xD2,
           wxTRANSLATE("0x40000D2-DM2CNT_H"),
           0xF7E0,
@@ -1650,7 +1650,7 @@ struct IOData {
               wxTRANSLATE("Interrupt Request"),
               wxTRANSLATE("Enable"),
           } },
-      { &DM3SAD_L,
+      { &GbaCore::DM3SAD_L,
           0xD4,
           wxTRANSLATE("0x40000D4-DM3SAD_L"),
           0xFFFF,
@@ -1672,7 +1672,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Source Address (lower 16 bits)"),
           } },
-      { &DM3SAD_H,
+      { &GbaCore::DM3SAD_H,
           0xD6,
           wxTRANSLATE("0x40000D6-DM3SAD_H"),
           0x0FFF,
@@ -1694,7 +1694,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM3DAD_L,
+      { &GbaCore::DM3DAD_L,
           0xD8,
           wxTRANSLATE("0x40000D8-DM3DAD_L"),
           0xFFFF,
@@ -1716,7 +1716,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Destination Address (lower 16 bits)"),
           } },
-      { &DM3DAD_H,
+      { &GbaCore::DM3DAD_H,
           0xDA,
           wxTRANSLATE("0x40000DA-DM3DAD_H"),
           0x0FFF,
@@ -1738,7 +1738,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &DM3CNT_L,
+      { &GbaCore::DM3CNT_L,
           0xDC,
           wxTRANSLATE("0x40000DC-DM3CNT_L"),
           0xFFFF,
@@ -1760,7 +1760,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Count (16 bits)"),
           } },
-      { &DM3CNT_H,
+      { &GbaCore::DM3CNT_H,
           0xDE,
           wxTRANSLATE("0x40000DE-DM3CNT_H"),
           0xFFE0,
@@ -1782,7 +1782,7 @@ struct IOData {
               wxTRANSLATE("Interrupt Request"),
               wxTRANSLATE("Enable"),
           } },
-      { &TM0D,
+      { &GbaCore::TM0D,
           0x100,
           wxTRANSLATE("0x4000100-TM0D"),
           0xFFFF,
@@ -1804,7 +1804,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Timer Counter (16 bits)"),
           } },
-      { &TM0CNT,
+      { &GbaCore::TM0CNT,
           0x102,
           wxTRANSLATE("0x4000102-TM0CNT"),
           0x00C7,
@@ -1826,7 +1826,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &TM1D,
+      { &GbaCore::TM1D,
           0x104,
           wxTRANSLATE("0x4000104-TM1D"),
           0xFFFF,
@@ -1848,7 +1848,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Timer Counter (16 bits)"),
           } },
-      { &TM1CNT,
+      { &GbaCore::TM1CNT,
           0x106,
           wxTRANSLATE("0x4000106-TM1CNT"),
           0x00C7,
@@ -1870,7 +1870,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &TM2D,
+      { &GbaCore::TM2D,
           0x108,
           wxTRANSLATE("0x4000108-TM2D"),
           0xFFFF,
@@ -1892,7 +1892,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Timer Counter (16 bits)"),
           } },
-      { &TM2CNT,
+      { &GbaCore::TM2CNT,
           0x10A,
           wxTRANSLATE("0x400010A-TM2CNT"),
           0x00C7,
@@ -1914,7 +1914,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &TM3D,
+      { &GbaCore::TM3D,
           0x10C,
           wxTRANSLATE("0x400010C-TM3D"),
           0xFFFF,
@@ -1936,7 +1936,7 @@ struct IOData {
               wxT(""),
               wxTRANSLATE("Timer Counter (16 bits)"),
           } },
-      { &TM3CNT,
+      { &GbaCore::TM3CNT,
           0x10E,
           wxTRANSLATE("0x400010E-TM3CNT"),
           0x00C7,
@@ -1958,7 +1958,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &P1,
+      { &GbaCore::P1,
           0x130,
           wxTRANSLATE("0x4000130-P1"),
           0x03FF,
@@ -2002,7 +2002,7 @@ struct IOData {
               wxTRANSLATE("Interrupt Request"),
               wxTRANSLATE("Interrupt Condition"),
           } },
-      { &IE,
+      { &GbaCore::IE,
           0x200,
           wxTRANSLATE("0x4000200-IE"),
           0x3FFF,
@@ -2024,7 +2024,7 @@ struct IOData {
               wxT(""),
               wxT(""),
           } },
-      { &IF,
+      { &GbaCore::IF,
           0x202,
           wxTRANSLATE("0x4000202-IF"),
           0x0000,
@@ -2068,7 +2068,7 @@ struct IOData {
               wxTRANSLATE("Game Pak Prefetch Buffer"),
               wxTRANSLATE("Game Pak Type Flag"),
           } },
-      { &IME,
+      { &GbaCore::IME,
           0x208,
           wxTRANSLATE("0x4000208-IME"),
           0x0001,
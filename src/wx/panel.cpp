@@ -39,6 +39,7 @@
 #include "core/base/check.h"
 #include "core/base/file_util.h"
 #include "core/base/image_util.h"
+#include "core/base/line_writer.h"
 #include "core/base/patch.h"
 #include "core/base/system.h"
 #include "core/base/version.h"
@@ -376,20 +377,20 @@ void GameArea::LoadGame(const wxString& name)
             return;
         }
 
-        rom_crc32 = crc32(0L, g_rom, rom_size);
+        rom_crc32 = crc32(0L, gbaCore.g_rom, rom_size);
 
         if (loadpatch) {
             // don't use real rom size or it might try to resize rom[]
             // instead, use known size of rom[]
             int size = 0x2000000 < rom_size ? 0x2000000 : rom_size;
-            applyPatch(UTF8(pfn.GetFullPath()), &g_rom, &size);
+            applyPatch(UTF8(pfn.GetFullPath()), &gbaCore.g_rom, &size);
             // that means we no longer really know rom_size either <sigh>
 
             gbaUpdateRomSize(size);
         }
 
         wxFileConfig* cfg = wxGetApp().overrides_.get();
-        wxString id = wxString((const char*)&g_rom[0xac], wxConvLibc, 4);
+        wxString id = wxString((const char*)&gbaCore.g_rom[0xac], wxConvLibc, 4);
 
         if (cfg->HasGroup(id)) {
             cfg->SetPath(id);
@@ -439,7 +440,7 @@ void GameArea::LoadGame(const wxString& name)
         soundSetSampleRate(GetSampleRate());
         // this **MUST** be called **AFTER** setting sample rate because the core calls soundInit()
         soundSetThrottle(coreOptions.throttle);
-        soundFiltering = (float)OPTION(kSoundGBAFiltering) / 100.0f;
+        gbaCore.soundFiltering = (float)OPTION(kSoundGBAFiltering) / 100.0f;
 
         rtcEnableRumble(true);
 
@@ -563,7 +564,7 @@ void GameArea::LoadGame(const wxString& name)
     // do a reset or load from state file when # rewinds == 0
     do_rewind = gopts.rewind_interval > 0;
     // FIXME: backup battery file (useful if game name conflict)
-    cheats_dirty = (did_autoload && !coreOptions.skipSaveGameCheats) || (loaded == IMAGE_GB ? gbCheatNumber > 0 : cheatsNumber > 0);
+    cheats_dirty = (did_autoload && !coreOptions.skipSaveGameCheats) || (loaded == IMAGE_GB ? gbCheatNumber > 0 : gbaCore.cheatsNumber > 0);
 
     if (OPTION(kPrefAutoSaveLoadCheatList) && (!did_autoload || coreOptions.skipSaveGameCheats)) {
         wxFileName cfn = loaded_game;
@@ -668,7 +669,7 @@ void GameArea::UnloadGame(bool destruct)
             else
                 gbCheatsSaveCheatList(UTF8(cfn.GetFullPath()));
         } else {
-            if (!cheatsNumber)
+            if (!gbaCore.cheatsNumber)
                 wxRemoveFile(cfn.GetFullPath());
             else
                 cheatsSaveCheatList(UTF8(cfn.GetFullPath()));
@@ -690,7 +691,7 @@ void GameArea::UnloadGame(bool destruct)
     systemStopGamePlayback();
 
 #if defined(VBAM_ENABLE_DEBUGGER)
-    debugger = false;
+    gbaCore.debugger = false;
     remoteCleanUp();
     mf->cmd_enable |= CMDEN_NGDB_ANY;
 #endif  // VBAM_ENABLE_DEBUGGER
@@ -1148,7 +1149,7 @@ void GameArea::OnIdle(wxIdleEvent& event)
             mf->GDBBreak();
         }
 
-        if (debugger && loaded != IMAGE_GBA) {
+        if (gbaCore.debugger && loaded != IMAGE_GBA) {
             wxLogError(_("Not a valid Game Boy Advance cartridge"));
             UnloadGame();
         }
@@ -1311,7 +1312,7 @@ void GameArea::OnIdle(wxIdleEvent& event)
         event.RequestMore();
 
 #if defined(VBAM_ENABLE_DEBUGGER)
-        if (debugger) {
+        if (gbaCore.debugger) {
             was_paused = true;
             dbgMain();
 
@@ -1461,6 +1462,8 @@ DrawingPanelBase::DrawingPanelBase(int _width, int _height)
       nthreads(0),
       rpi_(nullptr) {
     memset(delta, 0xff, sizeof(delta));
+    // The first frame has to be drawn.
+    lineWriterInvalidate(gbaCore.g_lineWriterHashes);
 
     if (OPTION(kDispFilter) == config::Filter::kPlugin) {
         rpi_ = widgets::MaybeLoadFilterPlugin(OPTION(kDispFilterPlugin),
@@ -11,7 +11,9 @@
 #include <SDL.h>
 #endif
 
+#include "core/base/frame_limiter.h"
 #include "core/base/image_util.h"
+#include "core/base/line_writer.h"
 #include "core/gb/gbGlobals.h"
 #include "core/gba/gbaGlobals.h"
 #include "core/gba/gbaSound.h"
@@ -92,7 +94,7 @@ void systemSendScreen()
 {
 #ifndef NO_FFMPEG
     GameArea* ga = wxGetApp().frame->GetPanel();
-    if (ga) ga->AddFrame(g_pix);
+    if (ga) ga->AddFrame(gbaCore.g_pix);
 #endif
 }
 
@@ -108,12 +110,22 @@ void systemDrawScreen()
 #ifndef NO_FFMPEG
 
     if (ga)
-        ga->AddFrame(g_pix);
+        ga->AddFrame(gbaCore.g_pix);
 
 #endif
 
-    if (ga && ga->panel)
-        ga->panel->DrawArea(&g_pix);
+    // Unchanged frames are not filtered and drawn again, the panel keeps
+    // showing the last one. The interframe blending and the OSD text change
+    // the output by themselves, and with vsync the swaps pace the emulation.
+    static bool last_osd = false;
+    const bool osd = ga && (!ga->osdstat.empty() || !ga->osdtext.empty());
+    const bool dirty = lineWriterTakeDirtyLines(gbaCore.g_lineWriterHashes, NULL);
+    const bool redraw = dirty || osd || last_osd || OPTION(kPrefVsync) ||
+                        OPTION(kDispIFB) != config::Interframe::kNone;
+    last_osd = osd;
+
+    if (ga && ga->panel && redraw)
+        ga->panel->DrawArea(&gbaCore.g_pix);
 }
 
 // record a game "movie"
@@ -549,6 +561,16 @@ void system10Frames() {
 
 void systemFrame()
 {
+    // The sound drivers do not wait for the audio device, the emulation is
+    // paced here instead. With vsync and dynamic rate control, the buffer
+    // swaps pace it and the sound rate follows them.
+    static FrameLimiter frame_limiter;
+    if (coreOptions.speedup || gbaCore.gba_joybus_active ||
+        (OPTION(kPrefVsync) && OPTION(kSoundDynamicRate)))
+        frame_limiter.reset();
+    else
+        frame_limiter.wait(soundGetThrottle());
+
     if (game_recording || game_playback)
         game_frame++;
 }
@@ -116,15 +116,15 @@ public:
 #if 0
 
         // this is what the win32 interface used
-        if (armState)
-            dis->SetSel(armNextPC - 16);
+        if (gbaCore.armState)
+            dis->SetSel(gbaCore.armNextPC - 16);
         else
-            dis->SetSel(armNextPC - 8);
+            dis->SetSel(gbaCore.armNextPC - 8);
 
         // doesn't make sense, though.  Maybe it's just trying to keep the
         // sel 4 instructions below top...
 #endif
-        dis->SetSel(armNextPC);
+        dis->SetSel(gbaCore.armNextPC);
         UpdateDis();
     }
     void RefreshCmd(wxCommandEvent& ev)
@@ -134,19 +134,19 @@ public:
     }
     void UpdateDis()
     {
-        N->SetValue(reg[16].I & 0x80000000);
-        Z->SetValue(reg[16].I & 0x40000000);
-        C->SetValue(reg[16].I & 0x20000000);
-        V->SetValue(reg[16].I & 0x10000000);
-        I->SetValue(reg[16].I & 0x00000080);
-        F->SetValue(reg[16].I & 0x00000040);
-        T->SetValue(reg[16].I & 0x00000020);
+        N->SetValue(gbaCore.reg[16].I & 0x80000000);
+        Z->SetValue(gbaCore.reg[16].I & 0x40000000);
+        C->SetValue(gbaCore.reg[16].I & 0x20000000);
+        V->SetValue(gbaCore.reg[16].I & 0x10000000);
+        I->SetValue(gbaCore.reg[16].I & 0x00000080);
+        F->SetValue(gbaCore.reg[16].I & 0x00000040);
+        T->SetValue(gbaCore.reg[16].I & 0x00000020);
         wxString s;
-        s.Printf(wxT("%02X"), reg[16].I & 0x1f);
+        s.Printf(wxT("%02X"), gbaCore.reg[16].I & 0x1f);
         Modev->SetLabel(s);
 
         for (int i = 0; i < 17; i++) {
-            s.Printf(wxT("%08X"), reg[i].I);
+            s.Printf(wxT("%08X"), gbaCore.reg[i].I);
             regv[i]->SetLabel(s);
         }
     }
@@ -162,7 +162,7 @@ public:
         dis->addrs.clear();
         uint32_t addr = dis->topaddr;
         const bool arm_mode = disassembly_mode_ == DisassemblyMode::Arm ||
-                              (armState && disassembly_mode_ == DisassemblyMode::Automatic);
+                              (gbaCore.armState && disassembly_mode_ == DisassemblyMode::Automatic);
         dis->back_size = arm_mode ? 4 : 2;
 
         for (int i = 0; i < dis->nlines; i++) {
@@ -458,7 +458,7 @@ public:
 
     void Update(int sel)
     {
-        uint16_t* addr = ioregs[sel].address ? ioregs[sel].address : (uint16_t*)&g_ioMem[ioregs[sel].offset];
+        uint16_t* addr = ioregs[sel].address ? &(gbaCore.*ioregs[sel].address) : (uint16_t*)&gbaCore.g_ioMem[ioregs[sel].offset];
         uint16_t mask, reg = *addr;
         int i;
 
@@ -502,7 +502,7 @@ public:
     {
 	(void)ev; // unused params
         int sel = addr_->GetSelection();
-        uint16_t* addr = ioregs[sel].address ? ioregs[sel].address : (uint16_t*)&g_ioMem[ioregs[sel].offset];
+        uint16_t* addr = ioregs[sel].address ? &(gbaCore.*ioregs[sel].address) : (uint16_t*)&gbaCore.g_ioMem[ioregs[sel].offset];
         uint16_t mask, reg = *addr;
         reg &= ~ioregs[sel].write;
         int i;
@@ -618,11 +618,11 @@ END_EVENT_TABLE()
 // These are what mfc interface used.  Maybe it would be safer
 // to avoid the Quick() routines in favor of the long ones...
 #define CPUWriteByteQuick(addr, b) \
-    ::map[(addr) >> 24].address[(addr) & ::map[(addr) >> 24].mask] = (b)
+    gbaCore.map[(addr) >> 24].address[(addr) & gbaCore.map[(addr) >> 24].mask] = (b)
 #define CPUWriteHalfWordQuick(addr, b) \
-    WRITE16LE((uint16_t*)&::map[(addr) >> 24].address[(addr) & ::map[(addr) >> 24].mask], b)
+    WRITE16LE((uint16_t*)&gbaCore.map[(addr) >> 24].address[(addr) & gbaCore.map[(addr) >> 24].mask], b)
 #define CPUWriteMemoryQuick(addr, b) \
-    WRITE32LE((uint32_t*)&::map[(addr) >> 24].address[(addr) & ::map[(addr) >> 24].mask], b)
+    WRITE32LE((uint32_t*)&gbaCore.map[(addr) >> 24].address[(addr) & gbaCore.map[(addr) >> 24].mask], b)
 #define GBWriteByteQuick(addr, b) \
     *((uint8_t*)&gbMemoryMap[(addr) >> 12][(addr)&0xfff]) = (b)
 #define GBWriteHalfWordQuick(addr, b) \
@@ -901,7 +901,7 @@ public:
 
         // this does the equivalent of the CPUWriteMemoryQuick()
         while (len > 0) {
-            memoryMap m = map[addr >> 24];
+            memoryMap m = gbaCore.map[addr >> 24];
             uint32_t off = addr & m.mask;
             int wlen = (off + len) > m.mask ? m.mask + 1 - off : len;
             wlen = f.Read(m.address + off, wlen);
@@ -923,7 +923,7 @@ public:
 
         // this does the equivalent of the CPUReadMemoryQuick()
         while (len > 0) {
-            memoryMap m = map[addr >> 24];
+            memoryMap m = gbaCore.map[addr >> 24];
             uint32_t off = addr & m.mask;
             int wlen = (off + len) > m.mask ? m.mask + 1 - off : len;
             wlen = f.Write(m.address + off, wlen);
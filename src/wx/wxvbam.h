@@ -646,7 +646,6 @@ private:
 #include "wx/opts.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
-extern bool debugger;
 extern void (*dbgMain)();
 extern void (*dbgSignal)(int, int);
 extern void (*dbgOutput)(const char*, uint32_t);